@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较逐条插入和批量插入的速度：每次插入一批随机键值的记录，写入记录文件和一个B+树索引。
+// 批量插入时记录按页面成批写入，索引键值排序后插入。每秒插入的行数看 items_per_second
+//
+
+#include <random>
+#include <string.h>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index_meta.h"
+#include "storage/record/record_manager.h"
+
+using namespace std;
+using namespace benchmark;
+
+const int RECORD_SIZE = 64;
+
+/// 键值在记录中的位置，前面是隐藏的null标记字段
+const int KEY_OFFSET = sizeof(int32_t);
+
+const char *const MODE_NAMES[] = {"single", "batch"};
+
+static IndexMeta make_index_meta()
+{
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("value", INTS, KEY_OFFSET, sizeof(int32_t), true /*visible*/, false /*nullable*/, 1);
+
+  IndexMeta index_meta;
+  index_meta.init("batch_insert_index", fields, false /*unique*/);
+  return index_meta;
+}
+
+/**
+ * 参数：一批的行数，插入方式(0 逐条插入，1 批量插入)
+ */
+static void BM_BatchInsert(State &state)
+{
+  const int batch_size = static_cast<int>(state.range(0));
+  const int mode       = static_cast<int>(state.range(1));
+  state.SetLabel(MODE_NAMES[mode]);
+
+  const string name       = string("batch_insert_benchmark_") + MODE_NAMES[mode];
+  const string data_file  = name + ".bp";
+  const string fsm_file   = name + ".fsm";
+  const string index_file = name + ".btree";
+  ::remove(data_file.c_str());
+  ::remove(fsm_file.c_str());
+  ::remove(index_file.c_str());
+
+  BufferPoolManager bpm{64 * 1024 * 1024};
+  BufferPoolManager::set_instance(&bpm);
+
+  DiskBufferPool   *bp     = nullptr;
+  DiskBufferPool   *fsm_bp = nullptr;
+  RecordFileHandler file_handler;
+  BplusTreeHandler  index_handler;
+  if (bpm.create_file(data_file.c_str()) != RC::SUCCESS || bpm.open_file(data_file.c_str(), bp) != RC::SUCCESS ||
+      bpm.create_file(fsm_file.c_str()) != RC::SUCCESS || bpm.open_file(fsm_file.c_str(), fsm_bp) != RC::SUCCESS ||
+      file_handler.init(bp, fsm_bp) != RC::SUCCESS ||
+      index_handler.create(index_file.c_str(), nullptr /*table*/, make_index_meta()) != RC::SUCCESS) {
+    state.SkipWithError("failed to prepare files");
+    BufferPoolManager::set_instance(nullptr);
+    return;
+  }
+
+  mt19937                     random(1);
+  vector<vector<char>>        records(batch_size, vector<char>(RECORD_SIZE));
+  vector<const char *>        datas(batch_size);
+  vector<char>                keys(batch_size * RECORD_SIZE);
+  vector<RID>                 rids(batch_size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (int i = 0; i < batch_size; i++) {
+      const int32_t value = static_cast<int32_t>(random());
+      memcpy(records[i].data() + KEY_OFFSET, &value, sizeof(value));
+      datas[i] = records[i].data();
+    }
+    state.ResumeTiming();
+
+    RC rc = RC::SUCCESS;
+    if (mode == 0) {
+      for (int i = 0; i < batch_size && OB_SUCC(rc); i++) {
+        rc = file_handler.insert_record(datas[i], RECORD_SIZE, &rids[i]);
+        if (OB_SUCC(rc)) {
+          rc = index_handler.insert_entry(datas[i], &rids[i]);
+        }
+      }
+    } else {
+      rc = file_handler.insert_records(datas, RECORD_SIZE, rids);
+      if (OB_SUCC(rc)) {
+        // 索引键值就是记录的前8个字节，这里连续存放
+        for (int i = 0; i < batch_size; i++) {
+          memcpy(keys.data() + i * KEY_OFFSET * 2, datas[i], KEY_OFFSET * 2);
+        }
+        rc = index_handler.insert_entries(keys.data(), rids.data(), batch_size);
+      }
+    }
+
+    if (OB_FAIL(rc)) {
+      state.SkipWithError("failed to insert");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.counters["data_pages"] = bp->page_num() - 1;
+
+  index_handler.close();
+  file_handler.close();
+  bpm.close_file(data_file.c_str());
+  bpm.close_file(fsm_file.c_str());
+  BufferPoolManager::set_instance(nullptr);
+  ::remove(data_file.c_str());
+  ::remove(fsm_file.c_str());
+  ::remove(index_file.c_str());
+}
+
+BENCHMARK(BM_BatchInsert)
+    ->ArgsProduct({{100, 1000, 10000}, {0, 1}})
+    ->ArgNames({"batch", "mode"})
+    ->Unit(kMillisecond);
+
+BENCHMARK_MAIN();
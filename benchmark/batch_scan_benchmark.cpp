@@ -0,0 +1,162 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较逐条扫描(RecordFileScanner::next)和按页面批量扫描(RecordFileScanner::next_batch)的速度。
+// 所有页面都在缓冲池中，扫描时使用 mvcc 事务检查可见性，其中十分之一的记录是其它事务插入但还没有提交的
+//
+
+#include <memory>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+#include "storage/view/view.h"
+
+using namespace std;
+using namespace benchmark;
+
+const int RECORD_NUM = 200000;
+
+/// 缓冲池能放下整个文件
+const int MEMORY_SIZE = 128 * 1024 * 1024;
+
+/// 扫描数据的事务
+const int32_t SCAN_TRX_ID = 100;
+
+const StorageFormat FORMATS[] = {StorageFormat::FIXED_FORMAT, StorageFormat::SLOTTED_FORMAT};
+const char *const FORMAT_NAMES[] = {"fixed", "slotted"};
+const char *const MODE_NAMES[] = {"record", "batch"};
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+/**
+ * 每种格式只在第一次使用时生成数据
+ */
+static Table *prepare_table(int format_index)
+{
+  static unique_ptr<Table> tables[2];
+  if (tables[format_index]) {
+    return tables[format_index].get();
+  }
+
+  const string name = string("batch_scan_benchmark_") + FORMAT_NAMES[format_index];
+  for (const char *suffix : {".table", ".data", ".fsm", ".zone", ".text"}) {
+    ::unlink((name + suffix).c_str());
+  }
+
+  AttrInfoSqlNode attrs[3];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{CHARS, "name", 32, false};
+  attrs[2] = AttrInfoSqlNode{CHARS, "email", 64, false};
+
+  auto table = make_unique<Table>();
+  if (table->create(format_index + 1, (name + ".table").c_str(), name.c_str(), ".", 3, attrs,
+          FORMATS[format_index]) != RC::SUCCESS) {
+    return nullptr;
+  }
+
+  const TableMeta &meta = table->table_meta();
+  const auto trx_fields = meta.trx_fields();
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+  vector<char> data(meta.record_size());
+  for (int i = 0; i < RECORD_NUM; i++) {
+    memset(data.data(), 0, data.size());
+    // 每十条记录中有一条是其它事务插入还没有提交的，对扫描的事务不可见
+    const int32_t begin_xid = (i % 10 == 0) ? -(SCAN_TRX_ID + 1) : 1;
+    const int32_t end_xid = numeric_limits<int32_t>::max();
+    memcpy(data.data() + begin_offset, &begin_xid, sizeof(begin_xid));
+    memcpy(data.data() + end_offset, &end_xid, sizeof(end_xid));
+    memcpy(data.data() + meta.field("id")->offset(), &i, sizeof(i));
+    memset(data.data() + meta.field("name")->offset(), 'n', 8 + i % 16);
+    memset(data.data() + meta.field("email")->offset(), 'e', 16 + i % 32);
+
+    Record record;
+    record.set_data(data.data(), data.size());
+    if (table->insert_record(record) != RC::SUCCESS) {
+      return nullptr;
+    }
+  }
+
+  tables[format_index] = std::move(table);
+  return tables[format_index].get();
+}
+
+/**
+ * 参数：记录格式的下标，扫描方式(0 逐条扫描，1 批量扫描)
+ */
+static void BM_BatchScan(State &state)
+{
+  const int format_index = static_cast<int>(state.range(0));
+  const int mode = static_cast<int>(state.range(1));
+  Table *table = prepare_table(format_index);
+  if (table == nullptr) {
+    state.SkipWithError("failed to prepare table");
+    return;
+  }
+  state.SetLabel(string(FORMAT_NAMES[format_index]) + "/" + MODE_NAMES[mode]);
+
+  static Trx *trx = TrxKit::instance()->create_trx(SCAN_TRX_ID);
+  const int id_offset = table->table_meta().field("id")->offset();
+  int64_t records = 0;
+  for (auto _ : state) {
+    RecordFileScanner scanner;
+    if (table->get_record_scanner(scanner, trx, true /*readonly*/) != RC::SUCCESS) {
+      state.SkipWithError("failed to open scanner");
+      break;
+    }
+
+    int64_t id_sum = 0;
+    if (mode == 0) {
+      Record record;
+      while (scanner.has_next()) {
+        if (scanner.next(record) != RC::SUCCESS) {
+          break;
+        }
+        id_sum += *(const int32_t *)(record.data() + id_offset);
+        records++;
+      }
+    } else {
+      RecordBatch batch;
+      while (scanner.next_batch(batch) == RC::SUCCESS) {
+        for (int i = batch.next_visible(0); i >= 0; i = batch.next_visible(i + 1)) {
+          id_sum += *(const int32_t *)(batch.data(i) + id_offset);
+          records++;
+        }
+      }
+    }
+    DoNotOptimize(id_sum);
+    scanner.close_scan();
+  }
+
+  state.SetItemsProcessed(records);
+}
+
+BENCHMARK(BM_BatchScan)->ArgsProduct({{0, 1}, {0, 1}})->ArgNames({"format", "mode"})->Unit(kMillisecond);
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+  TrxKit::init_global("mvcc");
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
@@ -0,0 +1,162 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较创建索引的两种方式：按照表中的顺序(随机键值)逐条调用 insert_entry，或者排序之后自底向上批量构建。
+// 除了构建时间，还输出构建出来的树的大小：pages 总页面数，leaf_pages 叶子节点个数，height 树高，
+// leaf_fill 叶子节点的平均填充比例。sort_memory_kb 是批量构建时排序使用的内存，小于数据量时会写临时文件。
+// 可以通过环境变量 BULK_LOAD_ROWS 修改键值个数，默认二十万。
+//
+
+#include <algorithm>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index_meta.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 缓冲池能放下整棵树
+const int MEMORY_SIZE = 512 * 1024 * 1024;
+
+const char *const MODE_NAMES[] = {"insert", "bulk"};
+
+static int key_num()
+{
+  const char *rows = getenv("BULK_LOAD_ROWS");
+  return rows != nullptr ? atoi(rows) : 200 * 1000;
+}
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+static IndexMeta make_index_meta()
+{
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("value", INTS, sizeof(int32_t), sizeof(int32_t), true /*visible*/, false /*nullable*/, 1);
+
+  IndexMeta index_meta;
+  index_meta.init("bulk_load_index", fields, false /*unique*/);
+  return index_meta;
+}
+
+/**
+ * 键值是 [0, key_num) 的一个随机排列，模拟表中记录的顺序
+ */
+static const vector<int32_t> &keys()
+{
+  static vector<int32_t> values = []() {
+    vector<int32_t> result(key_num());
+    for (size_t i = 0; i < result.size(); i++) {
+      result[i] = static_cast<int32_t>(i);
+    }
+    shuffle(result.begin(), result.end(), mt19937(0));
+    return result;
+  }();
+  return values;
+}
+
+/**
+ * 参数：构建方式(0 逐条插入，1 批量构建)，填充比例(百分比，逐条插入时没有用)，排序内存(KB)
+ */
+static void BM_BuildIndex(State &state)
+{
+  const int  mode        = static_cast<int>(state.range(0));
+  const int  fill_factor = static_cast<int>(state.range(1));
+  const long sort_memory = state.range(2) * 1024;
+  state.SetLabel(MODE_NAMES[mode]);
+
+  const string file = string("bplus_tree_bulk_load_benchmark_") + MODE_NAMES[mode] + ".btree";
+  const vector<int32_t> &values = keys();
+  BplusTreeStat stat;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ::unlink(file.c_str());
+    BplusTreeHandler handler;
+    RC rc = handler.create(file.c_str(), nullptr /*table*/, make_index_meta(), -1, -1, false /*prefix_compression*/);
+    if (rc != RC::SUCCESS) {
+      state.SkipWithError("failed to create btree");
+      break;
+    }
+    state.ResumeTiming();
+
+    int32_t key[2] = {0, 0};
+    if (mode == 0) {
+      for (size_t i = 0; OB_SUCC(rc) && i < values.size(); i++) {
+        key[1] = values[i];
+        RID rid(1, static_cast<SlotNum>(i));
+        rc = handler.insert_entry(reinterpret_cast<const char *>(key), &rid);
+      }
+    } else {
+      rc = handler.bulk_load_begin(fill_factor, sort_memory);
+      for (size_t i = 0; OB_SUCC(rc) && i < values.size(); i++) {
+        key[1] = values[i];
+        RID rid(1, static_cast<SlotNum>(i));
+        rc = handler.bulk_load_add(reinterpret_cast<const char *>(key), &rid);
+      }
+      if (OB_SUCC(rc)) {
+        rc = handler.bulk_load_finish();
+      }
+    }
+
+    state.PauseTiming();
+    if (OB_SUCC(rc)) {
+      rc = handler.stat(stat);
+    }
+    handler.close();
+    ::unlink(file.c_str());
+    state.ResumeTiming();
+
+    if (OB_FAIL(rc)) {
+      state.SkipWithError("failed to build btree");
+      break;
+    }
+  }
+
+  // 叶子节点不压缩，每一项是键值(null标记、value、RID)加上RID
+  const int leaf_capacity = (BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / (2 * sizeof(int32_t) + 2 * sizeof(RID));
+  const double leaf_fill =
+      stat.leaf_pages == 0 ? 0 : static_cast<double>(stat.entries) / stat.leaf_pages / leaf_capacity;
+  state.counters["pages"]      = stat.total_pages();
+  state.counters["leaf_pages"] = stat.leaf_pages;
+  state.counters["height"]     = stat.height;
+  state.counters["leaf_fill"]  = leaf_fill;
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(BM_BuildIndex)
+    ->Args({0, 100, 0})
+    ->Args({1, 100, 64 * 1024})
+    ->Args({1, 90, 64 * 1024})
+    ->Args({1, 70, 64 * 1024})
+    ->Args({1, 90, 256})
+    ->ArgNames({"mode", "fill_factor", "sort_memory_kb"})
+    ->Unit(kMillisecond);
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 #include <benchmark/benchmark.h>
 
 #include "storage/index/bplus_tree.h"
+#include "storage/index/index_meta.h"
+#include "storage/field/field_meta.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "common/log/log.h"
 #include "integer_generator.h"
@@ -24,6 +26,9 @@ using namespace std;
 using namespace common;
 using namespace benchmark;
 
+/// 线程数从1开始每次翻倍，直到这个值，用来观察吞吐量随线程数的变化
+const int MAX_BENCHMARK_THREADS = 64;
+
 once_flag         init_bpm_flag;
 BufferPoolManager bpm{512};
 
@@ -41,8 +46,37 @@ struct Stat
   int64_t scan_open_failed_count = 0;
   int64_t mismatch_count         = 0;
   int64_t scan_other_count       = 0;
+
+  int64_t get_success_count  = 0;
+  int64_t get_not_found_count = 0;
+  int64_t get_other_count    = 0;
+};
+
+/**
+ * @brief 索引的键值
+ * @details 索引键值的第一个字段是隐藏的null标记字段，后面才是用户的字段
+ */
+struct IndexKey
+{
+  int32_t  null_flags = 0;
+  uint32_t value      = 0;
+
+  explicit IndexKey(uint32_t v) : value(v) {}
+
+  const char *data() const { return reinterpret_cast<const char *>(this); }
 };
 
+IndexMeta make_index_meta()
+{
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("value", INTS, sizeof(int32_t), sizeof(uint32_t), true /*visible*/, false /*nullable*/, 1);
+
+  IndexMeta index_meta;
+  index_meta.init("bench_index", fields, false /*unique*/);
+  return index_meta;
+}
+
 class BenchmarkBase : public Fixture
 {
 public:
@@ -71,7 +105,7 @@ public:
 
     const char *filename = btree_filename.c_str();
 
-    RC rc = handler_.create(filename, INTS, sizeof(int32_t) /*attr_len*/, internal_max_size, leaf_max_size);
+    RC rc = handler_.create(filename, nullptr /*table*/, make_index_meta(), internal_max_size, leaf_max_size);
     if (rc != RC::SUCCESS) {
       throw runtime_error("failed to create btree handler");
     }
@@ -95,14 +129,26 @@ public:
   void FillUp(uint32_t min, uint32_t max)
   {
     for (uint32_t value = min; value < max; ++value) {
-      const char *key = reinterpret_cast<const char *>(&value);
-      RID         rid(value, value);
+      IndexKey key(value);
+      RID      rid(value, value);
 
-      [[maybe_unused]] RC rc = handler_.insert_entry(key, &rid);
+      [[maybe_unused]] RC rc = handler_.insert_entry(key.data(), &rid);
       ASSERT(rc == RC::SUCCESS, "failed to insert entry into btree. key=%" PRIu32, value);
     }
   }
 
+  /// 第二个参数表示只读的查找是否使用乐观读
+  void SetOptimisticRead(const State &state) { handler_.set_optimistic_read(state.range(1) != 0); }
+
+  /// 只在一个线程中统计乐观读的重试次数，避免各个线程重复计算
+  void ReportRestarts(State &state, long restarts_before)
+  {
+    if (0 == state.thread_index()) {
+      state.counters["restarts"] =
+          Counter(BplusTreeHandler::optimistic_read_restarts() - restarts_before, Counter::kIsRate);
+    }
+  }
+
   uint32_t GetRangeMax(const State &state) const
   {
     uint32_t max = static_cast<uint32_t>(state.range(0) * 3);
@@ -114,10 +160,10 @@ public:
 
   void Insert(uint32_t value, Stat &stat)
   {
-    const char *key = reinterpret_cast<const char *>(&value);
-    RID         rid(value, value);
+    IndexKey key(value);
+    RID      rid(value, value);
 
-    RC rc = handler_.insert_entry(key, &rid);
+    RC rc = handler_.insert_entry(key.data(), &rid);
     switch (rc) {
       case RC::SUCCESS: {
         stat.insert_success_count++;
@@ -133,10 +179,10 @@ public:
 
   void Delete(uint32_t value, Stat &stat)
   {
-    const char *key = reinterpret_cast<const char *>(&value);
-    RID         rid(value, value);
+    IndexKey key(value);
+    RID      rid(value, value);
 
-    RC rc = handler_.delete_entry(key, &rid);
+    RC rc = handler_.delete_entry(key.data(), &rid);
     switch (rc) {
       case RC::SUCCESS: {
         stat.delete_success_count++;
@@ -152,13 +198,13 @@ public:
 
   void Scan(uint32_t begin, uint32_t end, Stat &stat)
   {
-    const char *begin_key = reinterpret_cast<const char *>(&begin);
-    const char *end_key   = reinterpret_cast<const char *>(&end);
+    IndexKey begin_key(begin);
+    IndexKey end_key(end);
 
     BplusTreeScanner scanner(handler_);
 
-    RC rc =
-        scanner.open(begin_key, sizeof(begin_key), true /*inclusive*/, end_key, sizeof(end_key), true /*inclusive*/);
+    RC rc = scanner.open(
+        begin_key.data(), sizeof(begin_key), true /*inclusive*/, end_key.data(), sizeof(end_key), true /*inclusive*/);
     if (rc != RC::SUCCESS) {
       stat.scan_open_failed_count++;
     } else {
@@ -180,6 +226,21 @@ public:
     }
   }
 
+  void Get(uint32_t value, Stat &stat)
+  {
+    IndexKey  key(value);
+    list<RID> rids;
+
+    RC rc = handler_.get_entry(key.data(), sizeof(key), rids);
+    if (rc != RC::SUCCESS) {
+      stat.get_other_count++;
+    } else if (rids.empty()) {
+      stat.get_not_found_count++;
+    } else {
+      stat.get_success_count++;
+    }
+  }
+
 protected:
   BplusTreeHandler handler_;
 };
@@ -206,7 +267,7 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]     = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, MAX_BENCHMARK_THREADS)->UseRealTime();
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -245,7 +306,7 @@ BENCHMARK_DEFINE_F(DeletionBenchmark, Deletion)(State &state)
   state.counters["other"]     = Counter(stat.delete_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->ThreadRange(1, MAX_BENCHMARK_THREADS)->UseRealTime()->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -265,6 +326,7 @@ public:
     uint32_t max = static_cast<uint32_t>(state.range(0)) * 3;
     ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
     FillUp(0, max);
+    SetOptimisticRead(state);
   }
 };
 
@@ -275,6 +337,7 @@ BENCHMARK_DEFINE_F(ScanBenchmark, Scan)(State &state)
   IntegerGenerator begin_generator(1, max - max_range_size);
   IntegerGenerator range_generator(1, max_range_size);
   Stat             stat;
+  const long       restarts = BplusTreeHandler::optimistic_read_restarts();
 
   for (auto _ : state) {
     uint32_t begin = static_cast<uint32_t>(begin_generator.next());
@@ -286,15 +349,75 @@ BENCHMARK_DEFINE_F(ScanBenchmark, Scan)(State &state)
   state.counters["open_failed_count"]     = Counter(stat.scan_open_failed_count, Counter::kIsRate);
   state.counters["mismatch_number_count"] = Counter(stat.mismatch_count, Counter::kIsRate);
   state.counters["other"]                 = Counter(stat.scan_other_count, Counter::kIsRate);
+  ReportRestarts(state, restarts);
 }
 
-BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(ScanBenchmark, Scan)
+    ->ThreadRange(1, MAX_BENCHMARK_THREADS)
+    ->UseRealTime()
+    ->ArgNames({"keys", "optimistic"})
+    ->ArgsProduct({{4 * 10000}, {0, 1}});
+
+////////////////////////////////////////////////////////////////////////////////
+
+class PointLookupBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "point_lookup"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = GetRangeMax(state);
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    FillUp(0, max);
+    SetOptimisticRead(state);
+  }
+};
+
+BENCHMARK_DEFINE_F(PointLookupBenchmark, PointLookup)(State &state)
+{
+  IntegerGenerator generator(0, GetRangeMax(state));
+  Stat             stat;
+  const long       restarts = BplusTreeHandler::optimistic_read_restarts();
+
+  for (auto _ : state) {
+    uint32_t value = static_cast<uint32_t>(generator.next());
+    Get(value, stat);
+  }
+
+  state.counters["success"]   = Counter(stat.get_success_count, Counter::kIsRate);
+  state.counters["not_found"] = Counter(stat.get_not_found_count, Counter::kIsRate);
+  state.counters["other"]     = Counter(stat.get_other_count, Counter::kIsRate);
+  ReportRestarts(state, restarts);
+}
+
+BENCHMARK_REGISTER_F(PointLookupBenchmark, PointLookup)
+    ->ThreadRange(1, MAX_BENCHMARK_THREADS)
+    ->UseRealTime()
+    ->ArgNames({"keys", "optimistic"})
+    ->ArgsProduct({{4 * 10000}, {0, 1}});
 
 ////////////////////////////////////////////////////////////////////////////////
 
 struct MixtureBenchmark : public BenchmarkBase
 {
   string Name() const override { return "mixture"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+    SetOptimisticRead(state);
+  }
 };
 
 BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
@@ -306,7 +429,8 @@ BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
   IntegerGenerator scan_range_generator(scan_range.first, scan_range.second);
   IntegerGenerator operation_generator(0, 2);
 
-  Stat stat;
+  Stat       stat;
+  const long restarts = BplusTreeHandler::optimistic_read_restarts();
 
   for (auto _ : state) {
     int64_t operation_type = operation_generator.next();
@@ -340,9 +464,14 @@ BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
       {"scan_other", Counter(stat.scan_other_count, Counter::kIsRate)},
       {"scan_mismatch", Counter(stat.mismatch_count, Counter::kIsRate)},
       {"scan_open_failed", Counter(stat.scan_open_failed_count, Counter::kIsRate)}});
+  ReportRestarts(state, restarts);
 }
 
-BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)
+    ->ThreadRange(1, MAX_BENCHMARK_THREADS)
+    ->UseRealTime()
+    ->ArgNames({"keys", "optimistic"})
+    ->ArgsProduct({{4 * 10000}, {0, 1}});
 
 ////////////////////////////////////////////////////////////////////////////////
 
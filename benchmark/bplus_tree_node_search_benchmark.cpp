@@ -0,0 +1,170 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 单个 B+ 树节点内查找键值的速度，比较 KeyComparator 的通用查找和按照类型展开的无分支查找(IndexKeySearcher)。
+// 节点是满的，按照页面中的格式存放：叶子节点每一项是键值加 RID，内部节点每一项是键值加页面号，
+// 前缀压缩的叶子节点中 null 标记是公共前缀，每一项只有后面的 12 个字节。
+// 每次迭代查找一个随机的键值，一半在节点中，一半不在。
+//
+
+#include <random>
+#include <string.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "common/lang/lower_bound.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index_key_searcher.h"
+#include "storage/index/index_meta.h"
+
+using namespace std;
+using namespace benchmark;
+
+const int KEY_LENGTH = IndexKeySearcher::KEY_LENGTH;
+
+/// 查找的键值个数，循环使用
+const int PROBE_NUM = 4096;
+
+enum NodeKind {
+  LEAF,
+  INTERNAL,
+  PREFIX_LEAF,
+};
+
+const char *const NODE_NAMES[]   = {"leaf", "internal", "prefix_leaf"};
+const char *const METHOD_NAMES[] = {"generic", "specialized"};
+const char *const TYPE_NAMES[]   = {"int", "float"};
+
+static IndexMeta make_index_meta(AttrType type)
+{
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("value", type, sizeof(int32_t), sizeof(int32_t), true /*visible*/, false /*nullable*/, 1);
+
+  IndexMeta index_meta;
+  index_meta.init("node_search_index", fields, false /*unique*/);
+  return index_meta;
+}
+
+static void make_key(AttrType type, int value, const RID &rid, char *key)
+{
+  memset(key, 0, sizeof(int32_t));
+  if (type == FLOATS) {
+    const float float_value = static_cast<float>(value) / 4;
+    memcpy(key + sizeof(int32_t), &float_value, sizeof(float_value));
+  } else {
+    memcpy(key + sizeof(int32_t), &value, sizeof(value));
+  }
+  memcpy(key + 2 * sizeof(int32_t), &rid, sizeof(rid));
+}
+
+/**
+ * 参数：节点类型，查找方式(0 通用，1 展开)，键值类型(0 INT，1 FLOAT)
+ */
+static void BM_NodeSearch(State &state)
+{
+  const NodeKind kind    = static_cast<NodeKind>(state.range(0));
+  const bool specialized = state.range(1) != 0;
+  const AttrType type    = state.range(2) == 0 ? INTS : FLOATS;
+  state.SetLabel(string(NODE_NAMES[kind]) + "/" + METHOD_NAMES[specialized] + "/" + TYPE_NAMES[state.range(2)]);
+
+  KeyComparator comparator;
+  comparator.init(nullptr /*table*/, make_index_meta(type));
+  const IndexKeySearcher &searcher = comparator.key_searcher();
+
+  // 与页面中的格式相同
+  int prefix_len = 0;
+  int stride     = 0;
+  int count      = 0;
+  switch (kind) {
+  case LEAF: {
+    stride = KEY_LENGTH + sizeof(RID);
+    count  = (BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / stride;
+  } break;
+  case INTERNAL: {
+    stride = KEY_LENGTH + sizeof(PageNum);
+    count  = (BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / stride;
+  } break;
+  case PREFIX_LEAF: {
+    prefix_len = sizeof(int32_t);
+    stride     = KEY_LENGTH - prefix_len;
+    count = (BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - LeafIndexNode::PREFIX_HEADER_SIZE - prefix_len) /
+            stride;
+  } break;
+  }
+
+  // 键值是 0, 2, 4, ...，查找的键值一半是奇数，不在节点中
+  vector<char> node(prefix_len + static_cast<size_t>(count) * stride);
+  char key[KEY_LENGTH];
+  for (int i = 0; i < count; i++) {
+    make_key(type, i * 2, RID(1, i), key);
+    memcpy(node.data(), key, prefix_len);
+    memcpy(node.data() + prefix_len + static_cast<size_t>(i) * stride, key + prefix_len, KEY_LENGTH - prefix_len);
+  }
+  vector<char> probes(static_cast<size_t>(PROBE_NUM) * KEY_LENGTH);
+  mt19937 random(0);
+  for (int i = 0; i < PROBE_NUM; i++) {
+    const int value = random() % (count * 2);
+    make_key(type, value, RID(1, value / 2), probes.data() + static_cast<size_t>(i) * KEY_LENGTH);
+  }
+
+  const char *items = node.data() + prefix_len;
+  common::BinaryIterator<char> iter_begin(stride, const_cast<char *>(items));
+  common::BinaryIterator<char> iter_end(stride, const_cast<char *>(items) + static_cast<size_t>(count) * stride);
+  // 与前缀压缩的叶子节点相同，拼接出完整的键值再比较
+  char full_key[KEY_LENGTH];
+  memcpy(full_key, node.data(), prefix_len);
+  auto suffix_comparator = [&comparator, &full_key, prefix_len](const char *suffix, const char *key) {
+    memcpy(full_key + prefix_len, suffix, KEY_LENGTH - prefix_len);
+    return comparator(full_key, key);
+  };
+
+  long found_count = 0;
+  int probe = 0;
+  for (auto _ : state) {
+    const char *search_key = probes.data() + static_cast<size_t>(probe) * KEY_LENGTH;
+    probe = (probe + 1) % PROBE_NUM;
+
+    bool found = false;
+    int index = 0;
+    if (specialized) {
+      index = searcher.lower_bound(items, stride, count, prefix_len > 0 ? node.data() : nullptr, prefix_len,
+                                   search_key, &found);
+    } else if (prefix_len > 0) {
+      index = common::lower_bound(iter_begin, iter_end, search_key, suffix_comparator, &found) - iter_begin;
+    } else {
+      index = common::lower_bound(iter_begin, iter_end, search_key, comparator, &found) - iter_begin;
+    }
+    DoNotOptimize(index);
+    found_count += found;
+  }
+
+  state.counters["node_keys"] = count;
+  state.counters["found"]     = static_cast<double>(found_count) / max<long>(state.iterations(), 1);
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void node_search_args(internal::Benchmark *b)
+{
+  for (int kind : {LEAF, INTERNAL, PREFIX_LEAF}) {
+    for (int type : {0, 1}) {
+      for (int method : {0, 1}) {
+        b->Args({kind, method, type});
+      }
+    }
+  }
+  b->ArgNames({"node", "specialized", "type"});
+}
+
+BENCHMARK(BM_NodeSearch)->Apply(node_search_args);
+
+BENCHMARK_MAIN();
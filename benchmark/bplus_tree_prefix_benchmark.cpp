@@ -0,0 +1,195 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较字符串键值上普通的叶子节点和前缀压缩的叶子节点。
+// 键值是 char(32)，内容类似 "customer_account_000123456"，有很长的公共前缀。
+// BM_BuildIndex 按照随机顺序逐条插入，输出树的大小：pages 总页面数，leaf_pages 叶子节点个数，height 树高。
+// BM_Lookup 在建好的树上随机查找单个键值，每次迭代是一次 get_entry。
+// 可以通过环境变量 PREFIX_ROWS 修改键值个数，默认二十万。
+//
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index_meta.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 缓冲池能放下整棵树
+const int MEMORY_SIZE = 512 * 1024 * 1024;
+
+const int NAME_LENGTH = 32;
+const int KEY_LENGTH  = sizeof(int32_t) + NAME_LENGTH;
+
+const char *const MODE_NAMES[] = {"plain", "prefix"};
+
+static int key_num()
+{
+  const char *rows = getenv("PREFIX_ROWS");
+  return rows != nullptr ? atoi(rows) : 200 * 1000;
+}
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+static IndexMeta make_index_meta()
+{
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("name", CHARS, sizeof(int32_t), NAME_LENGTH, true /*visible*/, false /*nullable*/, 1);
+
+  IndexMeta index_meta;
+  index_meta.init("prefix_index", fields, false /*unique*/);
+  return index_meta;
+}
+
+static void make_key(int value, char *key)
+{
+  memset(key, 0, KEY_LENGTH);
+  snprintf(key + sizeof(int32_t), NAME_LENGTH, "customer_account_%09d", value);
+}
+
+/**
+ * 键值是 [0, key_num) 的一个随机排列，模拟表中记录的顺序
+ */
+static const vector<int32_t> &keys()
+{
+  static vector<int32_t> values = []() {
+    vector<int32_t> result(key_num());
+    for (size_t i = 0; i < result.size(); i++) {
+      result[i] = static_cast<int32_t>(i);
+    }
+    shuffle(result.begin(), result.end(), mt19937(0));
+    return result;
+  }();
+  return values;
+}
+
+static RC build(BplusTreeHandler &handler, const string &file, bool prefix_compression)
+{
+  ::unlink(file.c_str());
+  RC rc = handler.create(file.c_str(), nullptr /*table*/, make_index_meta(), -1, -1, prefix_compression);
+  const vector<int32_t> &values = keys();
+  char key[KEY_LENGTH];
+  for (size_t i = 0; OB_SUCC(rc) && i < values.size(); i++) {
+    make_key(values[i], key);
+    RID rid(1, static_cast<SlotNum>(i));
+    rc = handler.insert_entry(key, &rid);
+  }
+  return rc;
+}
+
+static void set_counters(State &state, const BplusTreeStat &stat)
+{
+  state.counters["pages"]      = stat.total_pages();
+  state.counters["leaf_pages"] = stat.leaf_pages;
+  state.counters["height"]     = stat.height;
+}
+
+/**
+ * 参数：叶子节点的格式(0 普通，1 前缀压缩)
+ */
+static void BM_BuildIndex(State &state)
+{
+  const int mode = static_cast<int>(state.range(0));
+  state.SetLabel(MODE_NAMES[mode]);
+
+  const string file = string("bplus_tree_prefix_benchmark_build_") + MODE_NAMES[mode] + ".btree";
+  BplusTreeStat stat;
+  for (auto _ : state) {
+    BplusTreeHandler handler;
+    RC rc = build(handler, file, mode == 1);
+
+    state.PauseTiming();
+    if (OB_SUCC(rc)) {
+      rc = handler.stat(stat);
+    }
+    handler.close();
+    ::unlink(file.c_str());
+    state.ResumeTiming();
+
+    if (OB_FAIL(rc)) {
+      state.SkipWithError("failed to build btree");
+      break;
+    }
+  }
+
+  set_counters(state, stat);
+  state.SetItemsProcessed(state.iterations() * keys().size());
+}
+
+/**
+ * 参数：叶子节点的格式(0 普通，1 前缀压缩)
+ */
+static void BM_Lookup(State &state)
+{
+  const int mode = static_cast<int>(state.range(0));
+  state.SetLabel(MODE_NAMES[mode]);
+
+  const string file = string("bplus_tree_prefix_benchmark_lookup_") + MODE_NAMES[mode] + ".btree";
+  BplusTreeHandler handler;
+  BplusTreeStat stat;
+  RC rc = build(handler, file, mode == 1);
+  if (OB_SUCC(rc)) {
+    rc = handler.stat(stat);
+  }
+  if (OB_FAIL(rc)) {
+    state.SkipWithError("failed to build btree");
+    handler.close();
+    ::unlink(file.c_str());
+    return;
+  }
+
+  const vector<int32_t> &values = keys();
+  mt19937 random(1);
+  uniform_int_distribution<size_t> distribution(0, values.size() - 1);
+  char key[KEY_LENGTH];
+  for (auto _ : state) {
+    make_key(values[distribution(random)], key);
+    list<RID> rids;
+    rc = handler.get_entry(key, KEY_LENGTH, rids);
+    if (OB_FAIL(rc) || rids.size() != 1) {
+      state.SkipWithError("failed to find key");
+      break;
+    }
+  }
+
+  handler.close();
+  ::unlink(file.c_str());
+  set_counters(state, stat);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_BuildIndex)->Arg(0)->Arg(1)->ArgName("mode")->Unit(kMillisecond);
+BENCHMARK(BM_Lookup)->Arg(0)->Arg(1)->ArgName("mode");
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
@@ -0,0 +1,183 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 冷缓存下的全表扫描，比较不同预读窗口、不同页面读写方式以及是否使用 O_DIRECT 时的扫描速度
+// 每次迭代都重新打开文件，并且尽量让操作系统丢弃文件的缓存。
+// 扫描之后统计文件在操作系统页面缓存中占用的内存(os_cache_mb)，与缓冲池的内存(buffer_pool_mb)对比
+//
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/record/record_manager.h"
+
+using namespace std;
+using namespace benchmark;
+
+const char *const FILE_NAME = "cold_scan_benchmark.bp";
+const char *const FSM_FILE_NAME = "cold_scan_benchmark.fsm";
+
+/// 表的大小，远大于扫描时使用的内存
+const int RECORD_NUM = 200000;
+const int RECORD_SIZE = 200;
+
+/// 扫描时使用的内存池个数，每个内存池 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+const int POOL_NUM = 4;
+
+const char *const IO_BACKENDS[] = {"sync", "io_uring"};
+
+/**
+ * 只在第一次使用时生成数据文件
+ */
+static bool prepare_file()
+{
+  static bool prepared = [] {
+    ::remove(FILE_NAME);
+    ::remove(FSM_FILE_NAME);
+
+    BufferPoolManager bpm;
+    DiskBufferPool *bp = nullptr;
+    DiskBufferPool *fsm_bp = nullptr;
+    if (bpm.create_file(FILE_NAME) != RC::SUCCESS || bpm.open_file(FILE_NAME, bp) != RC::SUCCESS ||
+        bpm.create_file(FSM_FILE_NAME) != RC::SUCCESS || bpm.open_file(FSM_FILE_NAME, fsm_bp) != RC::SUCCESS) {
+      return false;
+    }
+
+    RecordFileHandler file_handler;
+    if (file_handler.init(bp, fsm_bp) != RC::SUCCESS) {
+      return false;
+    }
+
+    char record[RECORD_SIZE];
+    for (int i = 0; i < RECORD_NUM; i++) {
+      memset(record, i % 128, sizeof(record));
+      RID rid;
+      if (file_handler.insert_record(record, sizeof(record), &rid) != RC::SUCCESS) {
+        return false;
+      }
+    }
+    file_handler.close();
+    return bpm.close_file(FILE_NAME) == RC::SUCCESS && bpm.close_file(FSM_FILE_NAME) == RC::SUCCESS;
+  }();
+  return prepared;
+}
+
+static void drop_os_cache()
+{
+  int fd = ::open(FILE_NAME, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  ::fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+  ::close(fd);
+}
+
+/**
+ * 文件有多少内存在操作系统的页面缓存中
+ */
+static double os_cache_mb()
+{
+  int fd = ::open(FILE_NAME, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+
+  struct stat st;
+  double result = 0;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED) {
+      const long os_page_size = sysconf(_SC_PAGESIZE);
+      vector<unsigned char> residents((st.st_size + os_page_size - 1) / os_page_size);
+      if (mincore(addr, st.st_size, residents.data()) == 0) {
+        long cached = 0;
+        for (unsigned char resident : residents) {
+          cached += resident & 1;
+        }
+        result = static_cast<double>(cached) * os_page_size / (1024 * 1024);
+      }
+      munmap(addr, st.st_size);
+    }
+  }
+  ::close(fd);
+  return result;
+}
+
+/**
+ * 参数：最大预读页面数(0表示不预读)，页面读写方式的下标，是否使用 O_DIRECT
+ */
+static void BM_ColdScan(State &state)
+{
+  if (!prepare_file()) {
+    state.SkipWithError("failed to prepare data file");
+    return;
+  }
+
+  const char *io_backend = IO_BACKENDS[state.range(1)];
+  const bool direct_io = state.range(2) != 0;
+  state.SetLabel(string(io_backend) + (direct_io ? "/direct_io" : ""));
+
+  int64_t records = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    drop_os_cache();
+    BufferPoolManager bpm(POOL_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE, 0 /*frame_shard_num*/,
+                          nullptr /*replacer*/, io_backend);
+    bpm.set_read_ahead_max_pages(static_cast<int>(state.range(0)));
+    bpm.set_direct_io_databases(direct_io ? "*" : "");
+    DiskBufferPool *bp = nullptr;
+    if (bpm.open_file(FILE_NAME, bp) != RC::SUCCESS) {
+      state.SkipWithError("failed to open data file");
+      break;
+    }
+    state.ResumeTiming();
+
+    RecordFileScanner scanner;
+    if (scanner.open_scan(nullptr /*table*/, *bp, nullptr /*trx*/, true /*readonly*/) != RC::SUCCESS) {
+      state.SkipWithError("failed to open scanner");
+      break;
+    }
+
+    Record record;
+    while (scanner.has_next()) {
+      if (scanner.next(record) != RC::SUCCESS) {
+        break;
+      }
+      records++;
+    }
+    scanner.close_scan();
+
+    state.PauseTiming();
+    state.counters["os_cache_mb"] = os_cache_mb();
+    bpm.close_file(FILE_NAME);
+    state.ResumeTiming();
+  }
+
+  state.counters["buffer_pool_mb"] = static_cast<double>(POOL_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE) / (1024 * 1024);
+  state.SetItemsProcessed(records);
+  state.SetBytesProcessed(records * RECORD_SIZE);
+}
+
+BENCHMARK(BM_ColdScan)
+    ->ArgsProduct({{0, 8, 32, 128}, {0, 1}, {0, 1}})
+    ->ArgNames({"read_ahead", "io_backend", "direct_io"})
+    ->Unit(kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较不同页面读写方式下，把一个文件的所有脏页刷到磁盘(flush_all_pages)的速度
+//
+
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+using namespace benchmark;
+
+const char *const FILE_NAME = "flush_all_benchmark.bp";
+
+const char *const IO_BACKENDS[] = {"sync", "io_uring"};
+
+/// 页帧的个数需要能放下所有页面
+const int POOL_NUM = 64;
+
+/**
+ * 参数：页面读写方式的下标，脏页的间隔(1表示所有页面都是脏页，2表示每隔一个页面有一个脏页)
+ */
+static void BM_FlushAll(State &state)
+{
+  const char *io_backend = IO_BACKENDS[state.range(0)];
+  const int stride = static_cast<int>(state.range(1));
+  state.SetLabel(io_backend);
+
+  ::remove(FILE_NAME);
+  BufferPoolManager bpm(POOL_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE, 0 /*frame_shard_num*/,
+                        nullptr /*replacer*/, io_backend);
+  DiskBufferPool *bp = nullptr;
+  if (bpm.create_file(FILE_NAME) != RC::SUCCESS || bpm.open_file(FILE_NAME, bp) != RC::SUCCESS) {
+    state.SkipWithError("failed to open file");
+    return;
+  }
+
+  const int page_num = POOL_NUM * DEFAULT_ITEM_NUM_PER_POOL / 2;
+  vector<Frame *> frames;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    if (bp->allocate_page(&frame) != RC::SUCCESS) {
+      state.SkipWithError("failed to allocate page");
+      return;
+    }
+    frames.push_back(frame);
+  }
+
+  int64_t flushed = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (int i = 0; i < page_num; i += stride) {
+      frames[i]->mark_dirty();
+      flushed++;
+    }
+    state.ResumeTiming();
+
+    if (bp->flush_all_pages() != RC::SUCCESS) {
+      state.SkipWithError("failed to flush all pages");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(flushed);
+  state.SetBytesProcessed(flushed * BP_PAGE_SIZE);
+
+  for (Frame *frame : frames) {
+    bp->unpin_page(frame);
+  }
+  bpm.close_file(FILE_NAME);
+  ::remove(FILE_NAME);
+}
+
+BENCHMARK(BM_FlushAll)
+    ->ArgsProduct({{0, 1}, {1, 2}})
+    ->ArgNames({"io_backend", "stride"})
+    ->Unit(kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较页面内存使用普通页和大页时，随机点查询访问页面的延迟
+// 所有页面都已经在缓冲池中，每次访问读取页面中一个随机的键值，模拟B+树查找时对页面的访问，
+// 缓冲池比TLB能覆盖的范围大得多时，延迟主要来自TLB miss
+//
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 每次查询访问的页面个数，类似于B+树的高度
+const int PAGES_PER_LOOKUP = 4;
+
+/**
+ * 参数：缓冲池的大小(MB)，是否使用大页
+ */
+static void BM_PointLookup(State &state)
+{
+  const int memory_mb = static_cast<int>(state.range(0));
+  PageArenaOptions options;
+  options.huge_page = state.range(1) != 0;
+
+  BPFrameManager frame_manager("PageArenaBenchmark");
+  const int pool_num = memory_mb * 1024 * 1024 / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL;
+  if (frame_manager.init(pool_num, 1 /*shard_num*/, nullptr /*replacer*/, options) != RC::SUCCESS) {
+    state.SkipWithError("failed to init frame manager");
+    return;
+  }
+  state.SetLabel(frame_manager.memory_mode());
+
+  const int file_desc = 0;
+  const PageNum page_count = static_cast<PageNum>(frame_manager.total_frame_num());
+  for (PageNum page_num = 0; page_num < page_count; page_num++) {
+    Frame *frame = frame_manager.alloc(file_desc, page_num);
+    memset(frame->data(), page_num & 0xFF, BP_PAGE_DATA_SIZE);
+    frame->unpin();
+  }
+
+  mt19937 random(2023);
+  uniform_int_distribution<PageNum> page_distribution(0, page_count - 1);
+  uniform_int_distribution<int> offset_distribution(0, BP_PAGE_DATA_SIZE / sizeof(int) - 1);
+
+  // 提前生成随机的访问位置，不把生成随机数的时间算进去
+  const int positions_num = 1 << 16;
+  vector<pair<PageNum, int>> positions;
+  positions.reserve(positions_num * PAGES_PER_LOOKUP);
+  for (int i = 0; i < positions_num * PAGES_PER_LOOKUP; i++) {
+    positions.emplace_back(page_distribution(random), offset_distribution(random));
+  }
+
+  size_t index = 0;
+  int64_t sum = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < PAGES_PER_LOOKUP; i++) {
+      const auto &[page_num, offset] = positions[index];
+      index = (index + 1) % positions.size();
+
+      Frame *frame = frame_manager.get(file_desc, page_num);
+      sum += reinterpret_cast<const int *>(frame->data())[offset];
+      frame->unpin();
+    }
+  }
+  DoNotOptimize(sum);
+
+  for (Frame *frame : frame_manager.find_list(file_desc)) {
+    frame->unpin();
+    frame_manager.free(file_desc, frame->page_num(), frame);
+  }
+  frame_manager.cleanup();
+}
+
+BENCHMARK(BM_PointLookup)->ArgsProduct({{64, 1024}, {0, 1}})->ArgNames({"memory_mb", "huge_page"});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 用访问轨迹回放的方式比较各个页面置换策略的命中率和每次访问的耗时
+//
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 页帧管理器使用的内存池个数，每个内存池 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+const int POOL_NUM = 8;
+const int CAPACITY = POOL_NUM * DEFAULT_ITEM_NUM_PER_POOL;
+
+const int TRACE_LENGTH = 1 << 20;
+
+const char *const REPLACERS[] = {"lru", "clock", "2q", "lru-k"};
+
+/**
+ * 点查询：90%的访问落在一个比内存小的热点集合上，其余的访问均匀分布在一个大得多的范围上
+ */
+vector<PageNum> make_point_lookup_trace() {
+  mt19937 random(2023);
+  uniform_int_distribution<PageNum> hot_distribution(0, CAPACITY / 2 - 1);
+  uniform_int_distribution<PageNum> cold_distribution(CAPACITY / 2, CAPACITY * 16);
+  uniform_int_distribution<int> ratio(0, 99);
+
+  vector<PageNum> trace;
+  trace.reserve(TRACE_LENGTH);
+  for (int i = 0; i < TRACE_LENGTH; i++) {
+    trace.push_back(ratio(random) < 90 ? hot_distribution(random) : cold_distribution(random));
+  }
+  return trace;
+}
+
+/**
+ * 扫描为主：点查询与一个比内存大得多的循环顺序扫描交替进行，
+ * 热点集合与两次访问同一个热点页面之间扫描过的页面加起来超过了内存大小
+ */
+vector<PageNum> make_scan_heavy_trace() {
+  mt19937 random(2023);
+  uniform_int_distribution<PageNum> hot_distribution(0, CAPACITY * 5 / 8 - 1);
+
+  const int batch = 64;
+  const PageNum scan_begin = CAPACITY;
+  const PageNum scan_end = CAPACITY * 9;
+
+  vector<PageNum> trace;
+  trace.reserve(TRACE_LENGTH);
+  PageNum scan_page = scan_begin;
+  while (static_cast<int>(trace.size()) < TRACE_LENGTH) {
+    for (int i = 0; i < batch; i++) {
+      trace.push_back(hot_distribution(random));
+    }
+    for (int i = 0; i < batch; i++) {
+      trace.push_back(scan_page++);
+      if (scan_page == scan_end) {
+        scan_page = scan_begin;
+      }
+    }
+  }
+  trace.resize(TRACE_LENGTH);
+  return trace;
+}
+
+const vector<PageNum> &trace_of(int64_t index) {
+  static const vector<PageNum> point_lookup_trace = make_point_lookup_trace();
+  static const vector<PageNum> scan_heavy_trace = make_scan_heavy_trace();
+  return index == 0 ? point_lookup_trace : scan_heavy_trace;
+}
+
+/**
+ * 参数：置换策略的下标，轨迹的下标(0 点查询，1 扫描为主)
+ * 每次迭代回放一次页面访问，不命中时淘汰一个页面后再分配
+ */
+static void BM_TraceReplay(State &state) {
+  const char *replacer = REPLACERS[state.range(0)];
+  const vector<PageNum> &trace = trace_of(state.range(1));
+  state.SetLabel(string(replacer) + (state.range(1) == 0 ? "/point_lookup" : "/scan_heavy"));
+
+  BPFrameManager frame_manager("ReplacementBenchmark");
+  if (frame_manager.init(POOL_NUM, 1, replacer) != RC::SUCCESS) {
+    state.SkipWithError("failed to init frame manager");
+    return;
+  }
+
+  const int file_desc = 0;
+  auto purger = [](Frame *) { return RC::SUCCESS; };
+
+  int64_t hit_count = 0;
+  int64_t access_count = 0;
+  size_t position = 0;
+  for (auto _ : state) {
+    const PageNum page_num = trace[position];
+    position = (position + 1) % trace.size();
+
+    Frame *frame = frame_manager.get(file_desc, page_num);
+    if (frame != nullptr) {
+      hit_count++;
+    } else {
+      frame = frame_manager.alloc(file_desc, page_num);
+      while (frame == nullptr) {
+        frame_manager.purge_frames(1, purger);
+        frame = frame_manager.alloc(file_desc, page_num);
+      }
+    }
+    frame->unpin();
+    access_count++;
+  }
+
+  state.counters["hit_ratio"] = access_count == 0 ? 0 : static_cast<double>(hit_count) / access_count;
+
+  for (Frame *frame : frame_manager.find_list(file_desc)) {
+    frame_manager.free(file_desc, frame->page_num(), frame);
+  }
+  frame_manager.cleanup();
+}
+
+BENCHMARK(BM_TraceReplay)
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 1}})
+    ->ArgNames({"replacer", "trace"})
+    ->Iterations(TRACE_LENGTH);
+
+BENCHMARK_MAIN();
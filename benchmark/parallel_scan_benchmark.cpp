@@ -0,0 +1,181 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 并行全表扫描：select count(*) from t where v < ?，过滤条件下推到扫描算子中，大约十分之一的记录满足条件。
+// 并行度为1时直接使用 TableScanPhysicalOperator，大于1时使用 GatherPhysicalOperator 汇总多个线程的结果。
+// 所有页面都在缓冲池中。需要开启 CONCURRENCY 编译，否则多个线程同时访问缓冲池是不安全的。
+// 可以通过环境变量 PARALLEL_SCAN_ROWS 修改记录数，默认一千万行。
+// 记录要尽量短，一个文件最多只能有 DiskFileHeader::MAX_PAGE_NUM 个页面
+//
+
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "sql/expr/expression.h"
+#include "sql/operator/gather_physical_operator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+#include "storage/view/view.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 缓冲池能放下整个文件
+const int MEMORY_SIZE = 1024 * 1024 * 1024;
+
+/// 扫描数据的事务
+const int32_t SCAN_TRX_ID = 100;
+
+/// v 的取值范围，过滤条件 v < VALUE_RANGE / 10
+const int VALUE_RANGE = 1000;
+
+static int record_num()
+{
+  const char *rows = getenv("PARALLEL_SCAN_ROWS");
+  return rows != nullptr ? atoi(rows) : 10 * 1000 * 1000;
+}
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+/**
+ * 数据只在第一次使用时生成
+ */
+static Table *prepare_table()
+{
+  static unique_ptr<Table> table;
+  if (table) {
+    return table.get();
+  }
+
+  const string name = "parallel_scan_benchmark";
+  for (const char *suffix : {".table", ".data", ".fsm", ".zone", ".text"}) {
+    ::unlink((name + suffix).c_str());
+  }
+
+  AttrInfoSqlNode attrs[2];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+
+  auto new_table = make_unique<Table>();
+  if (new_table->create(1, (name + ".table").c_str(), name.c_str(), ".", 2, attrs, StorageFormat::FIXED_FORMAT) !=
+      RC::SUCCESS) {
+    return nullptr;
+  }
+
+  const TableMeta &meta = new_table->table_meta();
+  const auto trx_fields = meta.trx_fields();
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+  const int rows = record_num();
+  vector<char> data(meta.record_size());
+  for (int i = 0; i < rows; i++) {
+    memset(data.data(), 0, data.size());
+    const int32_t begin_xid = 1;
+    const int32_t end_xid = numeric_limits<int32_t>::max();
+    const int32_t value = static_cast<int32_t>((i * 7919LL) % VALUE_RANGE);
+    memcpy(data.data() + begin_offset, &begin_xid, sizeof(begin_xid));
+    memcpy(data.data() + end_offset, &end_xid, sizeof(end_xid));
+    memcpy(data.data() + meta.field("id")->offset(), &i, sizeof(i));
+    memcpy(data.data() + meta.field("v")->offset(), &value, sizeof(value));
+
+    Record record;
+    record.set_data(data.data(), data.size());
+    if (new_table->insert_record(record) != RC::SUCCESS) {
+      return nullptr;
+    }
+  }
+
+  table = std::move(new_table);
+  return table.get();
+}
+
+/**
+ * 与 SQL 优化后的计划相同：过滤条件下推到表扫描算子中，并行度大于1时在上面加一个汇总算子
+ */
+static unique_ptr<PhysicalOperator> create_scan(Table *table, int parallel_degree)
+{
+  const FieldMeta *value_field = table->table_meta().field("v");
+  vector<unique_ptr<Expression>> predicates;
+  predicates.emplace_back(new ComparisonExpr(
+      LESS_THAN, make_unique<FieldExpr>(table, value_field), make_unique<ValueExpr>(Value(VALUE_RANGE / 10))));
+
+  auto scan = make_unique<TableScanPhysicalOperator>(table, true /*readonly*/);
+  scan->set_predicates(std::move(predicates));
+  if (parallel_degree <= 1) {
+    return scan;
+  }
+
+  vector<unique_ptr<TableScanPhysicalOperator>> workers;
+  for (int i = 1; i < parallel_degree; i++) {
+    workers.push_back(scan->fork());
+  }
+  workers.push_back(std::move(scan));
+  return make_unique<GatherPhysicalOperator>(table, std::move(workers));
+}
+
+/**
+ * 参数：并行度
+ */
+static void BM_ParallelScan(State &state)
+{
+  const int parallel_degree = static_cast<int>(state.range(0));
+  Table *table = prepare_table();
+  if (table == nullptr) {
+    state.SkipWithError("failed to prepare table");
+    return;
+  }
+
+  static Trx *trx = TrxKit::instance()->create_trx(SCAN_TRX_ID);
+  unique_ptr<PhysicalOperator> oper = create_scan(table, parallel_degree);
+  int64_t count = 0;
+  for (auto _ : state) {
+    if (oper->open(trx) != RC::SUCCESS) {
+      state.SkipWithError("failed to open operator");
+      break;
+    }
+
+    count = 0;
+    RC rc = RC::SUCCESS;
+    while (OB_SUCC(rc = oper->next(nullptr))) {
+      count++;
+    }
+    oper->close();
+    if (rc != RC::RECORD_EOF) {
+      state.SkipWithError("failed to scan");
+      break;
+    }
+  }
+
+  state.counters["count"] = static_cast<double>(count);
+  state.SetItemsProcessed(state.iterations() * record_num());
+}
+
+BENCHMARK(BM_ParallelScan)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->ArgName("degree")->Unit(kMillisecond)->UseRealTime();
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+  TrxKit::init_global("mvcc");
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 分析型查询的场景：一张比较宽的表，查询只对其中一列求和。
+// 比较定长记录和 PAX 格式批量扫描的速度，PAX 格式分别测试读取所有列和只读取需要的列(以及事务字段)。
+// 所有页面都在缓冲池中，扫描时使用 mvcc 事务检查可见性
+//
+
+#include <memory>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+#include "storage/view/view.h"
+
+using namespace std;
+using namespace benchmark;
+
+const int RECORD_NUM = 200000;
+
+/// 除了 id 之外的整数列个数
+const int VALUE_FIELD_NUM = 12;
+
+/// 缓冲池能放下整个文件
+const int MEMORY_SIZE = 256 * 1024 * 1024;
+
+/// 扫描数据的事务
+const int32_t SCAN_TRX_ID = 100;
+
+const StorageFormat FORMATS[] = {StorageFormat::FIXED_FORMAT, StorageFormat::PAX_FORMAT};
+const char *const FORMAT_NAMES[] = {"fixed", "pax"};
+const char *const MODE_NAMES[] = {"all_columns", "projected"};
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+/**
+ * 每种格式只在第一次使用时生成数据
+ */
+static Table *prepare_table(int format_index)
+{
+  static unique_ptr<Table> tables[2];
+  if (tables[format_index]) {
+    return tables[format_index].get();
+  }
+
+  const string name = string("pax_scan_benchmark_") + FORMAT_NAMES[format_index];
+  for (const char *suffix : {".table", ".data", ".fsm", ".zone", ".text"}) {
+    ::unlink((name + suffix).c_str());
+  }
+
+  vector<AttrInfoSqlNode> attrs;
+  attrs.push_back(AttrInfoSqlNode{INTS, "id", 4, false});
+  for (int i = 0; i < VALUE_FIELD_NUM; i++) {
+    attrs.push_back(AttrInfoSqlNode{INTS, "v" + to_string(i), 4, false});
+  }
+  attrs.push_back(AttrInfoSqlNode{CHARS, "name", 32, false});
+  attrs.push_back(AttrInfoSqlNode{CHARS, "comment", 128, false});
+
+  auto table = make_unique<Table>();
+  if (table->create(format_index + 1, (name + ".table").c_str(), name.c_str(), ".", static_cast<int>(attrs.size()),
+          attrs.data(), FORMATS[format_index]) != RC::SUCCESS) {
+    return nullptr;
+  }
+
+  const TableMeta &meta = table->table_meta();
+  const auto trx_fields = meta.trx_fields();
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+  vector<char> data(meta.record_size());
+  for (int i = 0; i < RECORD_NUM; i++) {
+    memset(data.data(), 0, data.size());
+    const int32_t begin_xid = 1;
+    const int32_t end_xid = numeric_limits<int32_t>::max();
+    memcpy(data.data() + begin_offset, &begin_xid, sizeof(begin_xid));
+    memcpy(data.data() + end_offset, &end_xid, sizeof(end_xid));
+    memcpy(data.data() + meta.field("id")->offset(), &i, sizeof(i));
+    for (int j = 0; j < VALUE_FIELD_NUM; j++) {
+      const int32_t value = i * j;
+      memcpy(data.data() + meta.field(attrs[j + 1].name.c_str())->offset(), &value, sizeof(value));
+    }
+    memset(data.data() + meta.field("name")->offset(), 'n', 8 + i % 16);
+    memset(data.data() + meta.field("comment")->offset(), 'c', 32 + i % 64);
+
+    Record record;
+    record.set_data(data.data(), data.size());
+    if (table->insert_record(record) != RC::SUCCESS) {
+      return nullptr;
+    }
+  }
+
+  tables[format_index] = std::move(table);
+  return tables[format_index].get();
+}
+
+/**
+ * 参数：记录格式的下标，是否只读取需要的列(0 所有列，1 只读取 v0 和事务字段)
+ */
+static void BM_PaxScan(State &state)
+{
+  const int format_index = static_cast<int>(state.range(0));
+  const int mode = static_cast<int>(state.range(1));
+  Table *table = prepare_table(format_index);
+  if (table == nullptr) {
+    state.SkipWithError("failed to prepare table");
+    return;
+  }
+  state.SetLabel(string(FORMAT_NAMES[format_index]) + "/" + MODE_NAMES[mode]);
+
+  const TableMeta &meta = table->table_meta();
+  const FieldMeta *value_field = meta.field("v0");
+  vector<int> projection;
+  if (mode == 1) {
+    const auto trx_fields = meta.trx_fields();
+    for (int i = 0; i < trx_fields.second; i++) {
+      projection.push_back(trx_fields.first[i].index());
+    }
+    projection.push_back(value_field->index());
+  }
+
+  static Trx *trx = TrxKit::instance()->create_trx(SCAN_TRX_ID);
+  int64_t records = 0;
+  for (auto _ : state) {
+    RecordFileScanner scanner;
+    if (table->get_record_scanner(scanner, trx, true /*readonly*/) != RC::SUCCESS) {
+      state.SkipWithError("failed to open scanner");
+      break;
+    }
+
+    RecordBatch batch;
+    batch.set_projection(projection);
+    int64_t value_sum = 0;
+    while (scanner.next_batch(batch) == RC::SUCCESS) {
+      for (int i = batch.next_visible(0); i >= 0; i = batch.next_visible(i + 1)) {
+        value_sum += *(const int32_t *)(batch.data(i) + value_field->offset());
+        records++;
+      }
+    }
+    DoNotOptimize(value_sum);
+    scanner.close_scan();
+  }
+
+  state.SetItemsProcessed(records);
+}
+
+BENCHMARK(BM_PaxScan)->Args({0, 0})->Args({1, 0})->Args({1, 1})->ArgNames({"format", "mode"})->Unit(kMillisecond);
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+  TrxKit::init_global("mvcc");
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
@@ -0,0 +1,146 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较定长记录和变长记录(slotted page)两种格式：表里有两个 char(255) 字段，但是大部分字符串都很短。
+// 统计每一百万行占用的页面数(pages_per_million_rows)，以及所有页面都在缓冲池中时全表扫描的速度
+//
+
+#include <memory>
+#include <random>
+#include <string.h>
+#include <benchmark/benchmark.h>
+
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table_meta.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace benchmark;
+
+const int RECORD_NUM = 100000;
+
+/// 缓冲池能放下整个文件
+const int MEMORY_SIZE = 128 * 1024 * 1024;
+
+const StorageFormat FORMATS[] = {StorageFormat::FIXED_FORMAT, StorageFormat::SLOTTED_FORMAT};
+const char *const FORMAT_NAMES[] = {"fixed", "slotted"};
+
+struct RecordFile
+{
+  BufferPoolManager bpm{MEMORY_SIZE};
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  TableMeta table_meta;
+  RecordFileHandler file_handler;
+};
+
+/**
+ * 每种格式只在第一次使用时生成数据文件
+ */
+static RecordFile *prepare_file(int format_index)
+{
+  static unique_ptr<RecordFile> files[2];
+  if (files[format_index]) {
+    return files[format_index].get();
+  }
+
+  const string file_name = string("record_format_benchmark_") + FORMAT_NAMES[format_index] + ".bp";
+  const string fsm_file_name = string("record_format_benchmark_") + FORMAT_NAMES[format_index] + ".fsm";
+  ::remove(file_name.c_str());
+  ::remove(fsm_file_name.c_str());
+
+  auto file = make_unique<RecordFile>();
+  AttrInfoSqlNode attrs[3];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{CHARS, "name", 255, false};
+  attrs[2] = AttrInfoSqlNode{CHARS, "email", 255, false};
+  if (file->table_meta.init(1, "t", 3, attrs, FORMATS[format_index]) != RC::SUCCESS ||
+      file->bpm.create_file(file_name.c_str()) != RC::SUCCESS ||
+      file->bpm.open_file(file_name.c_str(), file->bp) != RC::SUCCESS ||
+      file->bpm.create_file(fsm_file_name.c_str()) != RC::SUCCESS ||
+      file->bpm.open_file(fsm_file_name.c_str(), file->fsm_bp) != RC::SUCCESS ||
+      file->file_handler.init(file->bp, file->fsm_bp, &file->table_meta) != RC::SUCCESS) {
+    return nullptr;
+  }
+
+  const TableMeta &meta = file->table_meta;
+  mt19937 random(1);
+  uniform_int_distribution<int> name_len(4, 24);
+  uniform_int_distribution<int> email_len(10, 40);
+  vector<char> record(meta.record_size());
+  for (int i = 0; i < RECORD_NUM; i++) {
+    memset(record.data(), 0, record.size());
+    memcpy(record.data() + meta.field("id")->offset(), &i, sizeof(i));
+    memset(record.data() + meta.field("name")->offset(), 'n', name_len(random));
+    memset(record.data() + meta.field("email")->offset(), 'e', email_len(random));
+    RID rid;
+    if (file->file_handler.insert_record(record.data(), record.size(), &rid) != RC::SUCCESS) {
+      return nullptr;
+    }
+  }
+
+  files[format_index] = std::move(file);
+  return files[format_index].get();
+}
+
+/**
+ * 参数：记录格式的下标
+ */
+static void BM_RecordFormatScan(State &state)
+{
+  const int format_index = static_cast<int>(state.range(0));
+  RecordFile *file = prepare_file(format_index);
+  if (file == nullptr) {
+    state.SkipWithError("failed to prepare data file");
+    return;
+  }
+  state.SetLabel(FORMAT_NAMES[format_index]);
+
+  const int id_offset = file->table_meta.field("id")->offset();
+  int64_t records = 0;
+  for (auto _ : state) {
+    RecordFileScanner scanner;
+    if (scanner.open_scan(nullptr /*table*/, *file->bp, nullptr /*trx*/, true /*readonly*/) != RC::SUCCESS) {
+      state.SkipWithError("failed to open scanner");
+      break;
+    }
+
+    Record record;
+    int32_t id_sum = 0;
+    while (scanner.has_next()) {
+      if (scanner.next(record) != RC::SUCCESS) {
+        break;
+      }
+      id_sum += *(int32_t *)(record.data() + id_offset);
+      records++;
+    }
+    DoNotOptimize(id_sum);
+    scanner.close_scan();
+  }
+
+  // 第一个页面是 buffer pool 的文件头
+  state.counters["pages_per_million_rows"] = static_cast<double>(file->bp->page_num() - 1) * 1000000 / RECORD_NUM;
+  state.SetItemsProcessed(records);
+}
+
+BENCHMARK(BM_RecordFormatScan)->Arg(0)->Arg(1)->ArgName("format")->Unit(kMillisecond);
+
+int main(int argc, char **argv)
+{
+  // 表元数据中的事务字段由 TrxKit 决定，与 observer 使用 mvcc 时的记录格式保持一致
+  TrxKit::init_global("mvcc");
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
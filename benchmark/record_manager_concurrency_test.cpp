@@ -27,6 +27,9 @@ using namespace std;
 using namespace common;
 using namespace benchmark;
 
+/// 线程数从1开始每次翻倍，直到这个值，用来观察吞吐量随线程数的变化
+const int MAX_BENCHMARK_THREADS = 64;
+
 once_flag         init_bpm_flag;
 BufferPoolManager bpm{512};
 
@@ -43,6 +46,10 @@ struct Stat
   int64_t scan_open_failed_count = 0;
   int64_t mismatch_count         = 0;
   int64_t scan_other_count       = 0;
+
+  int64_t visit_success_count   = 0;
+  int64_t visit_not_exist_count = 0;
+  int64_t visit_other_count     = 0;
 };
 
 struct TestRecord
@@ -60,6 +67,7 @@ public:
   virtual string Name() const = 0;
 
   string record_filename() const { return this->Name() + ".record"; }
+  string fsm_filename() const { return this->Name() + ".fsm"; }
 
   virtual void SetUp(const State &state)
   {
@@ -73,7 +81,9 @@ public:
 
     std::call_once(init_bpm_flag, []() { BufferPoolManager::set_instance(&bpm); });
 
+    string fsm_filename = this->fsm_filename();
     ::remove(record_filename.c_str());
+    ::remove(fsm_filename.c_str());
 
     RC rc = bpm.create_file(record_filename.c_str());
     if (rc != RC::SUCCESS) {
@@ -87,7 +97,19 @@ public:
       throw runtime_error("failed to open record file");
     }
 
-    rc = handler_.init(buffer_pool_);
+    rc = bpm.create_file(fsm_filename.c_str());
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create fsm buffer pool file. filename=%s, rc=%s", fsm_filename.c_str(), strrc(rc));
+      throw runtime_error("failed to create fsm buffer pool file.");
+    }
+
+    rc = bpm.open_file(fsm_filename.c_str(), fsm_buffer_pool_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to open fsm file. filename=%s, rc=%s", fsm_filename.c_str(), strrc(rc));
+      throw runtime_error("failed to open fsm file");
+    }
+
+    rc = handler_.init(buffer_pool_, fsm_buffer_pool_);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to init record file handler. rc=%s", strrc(rc));
       throw runtime_error("failed to init record file handler");
@@ -104,7 +126,9 @@ public:
 
     handler_.close();
     bpm.close_file(this->record_filename().c_str());
+    bpm.close_file(this->fsm_filename().c_str());
     buffer_pool_ = nullptr;
+    fsm_buffer_pool_ = nullptr;
     LOG_INFO("test %s teardown done. threads=%d, thread index=%d",
         this->Name().c_str(),
         state.threads(),
@@ -205,8 +229,30 @@ public:
     }
   }
 
+  void Visit(const RID &rid, Stat &stat)
+  {
+    int32_t value   = 0;
+    auto    visitor = [&value](Record &record) {
+      value = reinterpret_cast<const TestRecord *>(record.data())->int_fields[0];
+    };
+
+    RC rc = handler_.visit_record(rid, true /*readonly*/, visitor);
+    switch (rc) {
+      case RC::SUCCESS: {
+        stat.visit_success_count++;
+      } break;
+      case RC::RECORD_NOT_EXIST: {
+        stat.visit_not_exist_count++;
+      } break;
+      default: {
+        stat.visit_other_count++;
+      } break;
+    }
+  }
+
 protected:
   DiskBufferPool   *buffer_pool_ = nullptr;
+  DiskBufferPool   *fsm_buffer_pool_ = nullptr;
   RecordFileHandler handler_;
 };
 
@@ -231,7 +277,7 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]   = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, MAX_BENCHMARK_THREADS)->UseRealTime();
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -273,7 +319,7 @@ BENCHMARK_DEFINE_F(DeletionBenchmark, Deletion)(State &state)
   state.counters["other"]     = Counter(stat.delete_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->ThreadRange(1, MAX_BENCHMARK_THREADS)->UseRealTime()->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -317,7 +363,50 @@ BENCHMARK_DEFINE_F(ScanBenchmark, Scan)(State &state)
   state.counters["other"]                 = Counter(stat.scan_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->ThreadRange(1, MAX_BENCHMARK_THREADS)->UseRealTime()->Arg(4 * 10000);
+
+////////////////////////////////////////////////////////////////////////////////
+
+class PointSelectBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "point_select"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = GetRangeMax(state);
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    FillUp(0, max, rids_);
+  }
+
+protected:
+  vector<RID> rids_;
+};
+
+BENCHMARK_DEFINE_F(PointSelectBenchmark, PointSelect)(State &state)
+{
+  IntegerGenerator generator(0, static_cast<int>(rids_.size()) - 1);
+  Stat             stat;
+
+  for (auto _ : state) {
+    Visit(rids_[generator.next()], stat);
+  }
+
+  state.counters["success"]   = Counter(stat.visit_success_count, Counter::kIsRate);
+  state.counters["not_exist"] = Counter(stat.visit_not_exist_count, Counter::kIsRate);
+  state.counters["other"]     = Counter(stat.visit_other_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(PointSelectBenchmark, PointSelect)
+    ->ThreadRange(1, MAX_BENCHMARK_THREADS)
+    ->UseRealTime()
+    ->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -380,7 +469,7 @@ BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
       {"scan_open_failed", Counter(stat.scan_open_failed_count, Counter::kIsRate)}});
 }
 
-BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->ThreadRange(1, MAX_BENCHMARK_THREADS)->UseRealTime()->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,186 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 带 TEXT 字段的表扫描：取出每一行的所有字段(与连接、排序等算子缓存整行数据时相同)，只计算 sum(v)。
+// 对比两张表，一张是 (id int, v int)，另一张多一个 TEXT 字段，每个 TEXT 值大约一个页面。
+// TEXT 值延迟读取时，不访问 TEXT 字段的查询与没有 TEXT 字段的表一样快；read_text=1 时每一行都读取 TEXT 的内容，作为对比。
+// 所有页面都在缓冲池中。可以通过环境变量 TEXT_SCAN_ROWS 修改记录数，默认两万行。
+//
+
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+#include "storage/view/view.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 缓冲池能放下整个文件
+const int MEMORY_SIZE = 512 * 1024 * 1024;
+
+/// 扫描数据的事务
+const int32_t SCAN_TRX_ID = 100;
+
+/// 每个 TEXT 值的长度
+const int TEXT_LENGTH = 6000;
+
+static int record_num()
+{
+  const char *rows = getenv("TEXT_SCAN_ROWS");
+  return rows != nullptr ? atoi(rows) : 20 * 1000;
+}
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+/**
+ * 数据只在第一次使用时生成
+ */
+static Table *prepare_table(bool with_text)
+{
+  static unique_ptr<Table> tables[2];
+  unique_ptr<Table> &table = tables[with_text ? 1 : 0];
+  if (table) {
+    return table.get();
+  }
+
+  const string name = with_text ? "text_scan_benchmark_text" : "text_scan_benchmark";
+  for (const char *suffix : {".table", ".data", ".fsm", ".zone", ".text"}) {
+    ::unlink((name + suffix).c_str());
+  }
+
+  AttrInfoSqlNode attrs[3];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+  attrs[2] = AttrInfoSqlNode{TEXTS, "t", 4, false};
+  const int attr_num = with_text ? 3 : 2;
+
+  auto new_table = make_unique<Table>();
+  if (new_table->create(1, (name + ".table").c_str(), name.c_str(), ".", attr_num, attrs) != RC::SUCCESS) {
+    return nullptr;
+  }
+
+  const TableMeta &meta = new_table->table_meta();
+  const auto trx_fields = meta.trx_fields();
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+  const int rows = record_num();
+  string text(TEXT_LENGTH, 'x');
+  vector<char> data(meta.record_size());
+  for (int i = 0; i < rows; i++) {
+    memset(data.data(), 0, data.size());
+    const int32_t begin_xid = 1;
+    const int32_t end_xid = numeric_limits<int32_t>::max();
+    const int32_t value = i % 1000;
+    memcpy(data.data() + begin_offset, &begin_xid, sizeof(begin_xid));
+    memcpy(data.data() + end_offset, &end_xid, sizeof(end_xid));
+    memcpy(data.data() + meta.field("id")->offset(), &i, sizeof(i));
+    memcpy(data.data() + meta.field("v")->offset(), &value, sizeof(value));
+    if (with_text) {
+      int text_id = 0;
+      text[0] = 'a' + i % 26;
+      if (new_table->add_text(text.c_str(), text_id) != RC::SUCCESS) {
+        return nullptr;
+      }
+      memcpy(data.data() + meta.field("t")->offset(), &text_id, sizeof(text_id));
+    }
+
+    Record record;
+    record.set_data(data.data(), data.size());
+    if (new_table->insert_record(record) != RC::SUCCESS) {
+      return nullptr;
+    }
+  }
+
+  table = std::move(new_table);
+  return table.get();
+}
+
+/**
+ * 参数：表中是否有 TEXT 字段，是否读取 TEXT 的内容
+ */
+static void BM_TextScan(State &state)
+{
+  const bool with_text = state.range(0) != 0;
+  const bool read_text = state.range(1) != 0;
+  Table *table = prepare_table(with_text);
+  if (table == nullptr) {
+    state.SkipWithError("failed to prepare table");
+    return;
+  }
+
+  static Trx *trx = TrxKit::instance()->create_trx(SCAN_TRX_ID);
+  TableScanPhysicalOperator scan(table, true /*readonly*/);
+  const int value_index = table->table_meta().field("v")->index();
+  const FieldMeta *text_field = table->table_meta().field("t");
+  int64_t sum = 0;
+  int64_t text_bytes = 0;
+  for (auto _ : state) {
+    if (scan.open(trx) != RC::SUCCESS) {
+      state.SkipWithError("failed to open operator");
+      break;
+    }
+
+    sum = 0;
+    text_bytes = 0;
+    RC rc = RC::SUCCESS;
+    vector<Value> cells;
+    while (OB_SUCC(rc = scan.next(nullptr))) {
+      Tuple *tuple = scan.current_tuple();
+      cells.resize(tuple->cell_num());
+      for (int i = 0; i < tuple->cell_num(); i++) {
+        tuple->cell_at(i, cells[i]);
+      }
+      sum += cells[value_index].get_int();
+      if (read_text && text_field != nullptr) {
+        text_bytes += cells[text_field->index()].length();
+      }
+    }
+    scan.close();
+    if (rc != RC::RECORD_EOF) {
+      state.SkipWithError("failed to scan");
+      break;
+    }
+  }
+
+  state.counters["sum"] = static_cast<double>(sum);
+  state.counters["text_bytes"] = static_cast<double>(text_bytes);
+  state.SetItemsProcessed(state.iterations() * record_num());
+}
+
+BENCHMARK(BM_TextScan)
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->ArgNames({"with_text", "read_text"})
+    ->Unit(kMillisecond);
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+  TrxKit::init_global("mvcc");
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
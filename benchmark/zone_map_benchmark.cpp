@@ -0,0 +1,176 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 区域映射跳过页面：select count(*) from t where id < ?，id 按插入顺序递增，每个页面上的 id 都在一个小范围内。
+// 过滤条件下推到表扫描算子时使用区域映射，不满足条件的页面不会读取；
+// 作为对比，过滤条件放在表扫描上面的 PredicatePhysicalOperator 中，需要扫描所有的页面。
+// 所有页面都在缓冲池中，节省的是访问页面、检查可见性和计算过滤条件的时间。
+// 可以通过环境变量 ZONE_MAP_ROWS 修改记录数，默认一百万行。
+//
+
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "sql/expr/expression.h"
+#include "sql/operator/predicate_physical_operator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+#include "storage/view/view.h"
+
+using namespace std;
+using namespace benchmark;
+
+/// 缓冲池能放下整个文件
+const int MEMORY_SIZE = 512 * 1024 * 1024;
+
+/// 扫描数据的事务
+const int32_t SCAN_TRX_ID = 100;
+
+static int record_num()
+{
+  const char *rows = getenv("ZONE_MAP_ROWS");
+  return rows != nullptr ? atoi(rows) : 1000 * 1000;
+}
+
+static BufferPoolManager &buffer_pool_manager()
+{
+  static BufferPoolManager bpm{MEMORY_SIZE};
+  return bpm;
+}
+
+/**
+ * 数据只在第一次使用时生成
+ */
+static Table *prepare_table()
+{
+  static unique_ptr<Table> table;
+  if (table) {
+    return table.get();
+  }
+
+  const string name = "zone_map_benchmark";
+  for (const char *suffix : {".table", ".data", ".fsm", ".zone", ".text"}) {
+    ::unlink((name + suffix).c_str());
+  }
+
+  AttrInfoSqlNode attrs[2];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+
+  auto new_table = make_unique<Table>();
+  if (new_table->create(1, (name + ".table").c_str(), name.c_str(), ".", 2, attrs, StorageFormat::FIXED_FORMAT) !=
+      RC::SUCCESS) {
+    return nullptr;
+  }
+
+  const TableMeta &meta = new_table->table_meta();
+  const auto trx_fields = meta.trx_fields();
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+  const int rows = record_num();
+  vector<char> data(meta.record_size());
+  for (int i = 0; i < rows; i++) {
+    memset(data.data(), 0, data.size());
+    const int32_t begin_xid = 1;
+    const int32_t end_xid = numeric_limits<int32_t>::max();
+    const int32_t value = static_cast<int32_t>((i * 7919LL) % 1000);
+    memcpy(data.data() + begin_offset, &begin_xid, sizeof(begin_xid));
+    memcpy(data.data() + end_offset, &end_xid, sizeof(end_xid));
+    memcpy(data.data() + meta.field("id")->offset(), &i, sizeof(i));
+    memcpy(data.data() + meta.field("v")->offset(), &value, sizeof(value));
+
+    Record record;
+    record.set_data(data.data(), data.size());
+    if (new_table->insert_record(record) != RC::SUCCESS) {
+      return nullptr;
+    }
+  }
+
+  table = std::move(new_table);
+  return table.get();
+}
+
+static unique_ptr<Expression> create_predicate(Table *table, int limit)
+{
+  const FieldMeta *id_field = table->table_meta().field("id");
+  return make_unique<ComparisonExpr>(LESS_THAN, make_unique<FieldExpr>(table, id_field), make_unique<ValueExpr>(Value(limit)));
+}
+
+/**
+ * 参数：是否使用区域映射，满足条件的记录的百分比
+ */
+static void BM_ZoneMapScan(State &state)
+{
+  const bool use_zone_map = state.range(0) != 0;
+  const int percent = static_cast<int>(state.range(1));
+  Table *table = prepare_table();
+  if (table == nullptr) {
+    state.SkipWithError("failed to prepare table");
+    return;
+  }
+
+  const int limit = static_cast<int>(static_cast<int64_t>(record_num()) * percent / 100);
+  auto scan = make_unique<TableScanPhysicalOperator>(table, true /*readonly*/);
+  unique_ptr<PhysicalOperator> oper;
+  if (use_zone_map) {
+    vector<unique_ptr<Expression>> predicates;
+    predicates.push_back(create_predicate(table, limit));
+    scan->set_predicates(std::move(predicates));
+    oper = std::move(scan);
+  } else {
+    oper = make_unique<PredicatePhysicalOperator>(create_predicate(table, limit));
+    oper->add_child(std::move(scan));
+  }
+
+  static Trx *trx = TrxKit::instance()->create_trx(SCAN_TRX_ID);
+  int64_t count = 0;
+  for (auto _ : state) {
+    if (oper->open(trx) != RC::SUCCESS) {
+      state.SkipWithError("failed to open operator");
+      break;
+    }
+
+    count = 0;
+    RC rc = RC::SUCCESS;
+    while (OB_SUCC(rc = oper->next(nullptr))) {
+      count++;
+    }
+    oper->close();
+    if (rc != RC::RECORD_EOF) {
+      state.SkipWithError("failed to scan");
+      break;
+    }
+  }
+
+  state.counters["count"] = static_cast<double>(count);
+  state.SetItemsProcessed(state.iterations() * record_num());
+}
+
+BENCHMARK(BM_ZoneMapScan)
+    ->ArgsProduct({{0, 1}, {1, 10, 50, 100}})
+    ->ArgNames({"zone_map", "percent"})
+    ->Unit(kMillisecond);
+
+int main(int argc, char **argv)
+{
+  BufferPoolManager::set_instance(&buffer_pool_manager());
+  TrxKit::init_global("mvcc");
+
+  Initialize(&argc, argv);
+  RunSpecifiedBenchmarks();
+  Shutdown();
+  return 0;
+}
@@ -12,33 +12,30 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2021/5/7.
 //
 
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
 #include "common/lang/bitmap.h"
 
 namespace common {
 
-int find_first_zero(char byte, int start)
-{
-  for (int i = start; i < 8; i++) {
-    if ((byte & (1 << i)) == 0) {
-      return i;
-    }
-  }
-  return -1;
-}
-
-int find_first_setted(char byte, int start)
+int bytes(int size)
 {
-  for (int i = start; i < 8; i++) {
-    if ((byte & (1 << i)) != 0) {
-      return i;
-    }
-  }
-  return -1;
+  return size % 8 == 0 ? size / 8 : size / 8 + 1;
 }
 
-int bytes(int size)
+/**
+ * @brief 读取从第 bit_index 位开始的64位
+ * @details 按小端字节序拼接，第 i 位就是返回值的第 (i - bit_index) 位。超出位图的部分补0
+ * @param bit_index 必须是64的倍数
+ */
+static uint64_t load_word(const char *bitmap, int size, int bit_index)
 {
-  return size % 8 == 0 ? size / 8 : size / 8 + 1;
+  uint64_t word = 0;
+  const int byte_index = bit_index / 8;
+  memcpy(&word, bitmap + byte_index, std::min(static_cast<int>(sizeof(word)), bytes(size) - byte_index));
+  return word;
 }
 
 Bitmap::Bitmap() : bitmap_(nullptr), size_(0)
@@ -72,48 +69,33 @@ void Bitmap::clear_bit(int index)
 
 int Bitmap::next_unsetted_bit(int start)
 {
-  int ret = -1;
-  int start_in_byte = start % 8;
-  for (int iter = start / 8, end = bytes(size_); iter < end; iter++) {
-    char byte = bitmap_[iter];
-    if (byte != -1) {
-      int index_in_byte = find_first_zero(byte, start_in_byte);
-      if (index_in_byte >= 0) {
-        ret = iter * 8 + index_in_byte;
-        break;
-      }
-
-      start_in_byte = 0;
+  // 每次检查64位，用 ctz 直接定位到字中第一个为0的位
+  for (int word_start = start / 64 * 64; word_start < size_; word_start += 64) {
+    uint64_t word = ~load_word(bitmap_, size_, word_start);
+    if (word_start < start) {
+      word &= ~0ULL << (start - word_start);
+    }
+    if (word != 0) {
+      const int ret = word_start + __builtin_ctzll(word);
+      return ret < size_ ? ret : -1;
     }
   }
-
-  if (ret >= size_) {
-    ret = -1;
-  }
-  return ret;
+  return -1;
 }
 
 int Bitmap::next_setted_bit(int start)
 {
-  int ret = -1;
-  int start_in_byte = start % 8;
-  for (int iter = start / 8, end = bytes(size_); iter < end; iter++) {
-    char byte = bitmap_[iter];
-    if (byte != 0x00) {
-      int index_in_byte = find_first_setted(byte, start_in_byte);
-      if (index_in_byte >= 0) {
-        ret = iter * 8 + index_in_byte;
-        break;
-      }
-
-      start_in_byte = 0;
+  for (int word_start = start / 64 * 64; word_start < size_; word_start += 64) {
+    uint64_t word = load_word(bitmap_, size_, word_start);
+    if (word_start < start) {
+      word &= ~0ULL << (start - word_start);
+    }
+    if (word != 0) {
+      const int ret = word_start + __builtin_ctzll(word);
+      return ret < size_ ? ret : -1;
     }
   }
-
-  if (ret >= size_) {
-    ret = -1;
-  }
-  return ret;
+  return -1;
 }
 
 }  // namespace common
@@ -61,6 +61,44 @@ void Meter::snapshot()
   ((SnapshotBasic<double> *)snapshot_value_)->setValue(temp_value);
 }
 
+Counter::Counter()
+{
+  value_.store(0l);
+}
+
+Counter::~Counter()
+{
+  if (snapshot_value_ != NULL) {
+    delete snapshot_value_;
+    snapshot_value_ = NULL;
+  }
+}
+
+void Counter::inc(long increase)
+{
+  value_.fetch_add(increase);
+}
+
+void Counter::inc()
+{
+  inc(1l);
+}
+
+long Counter::value() const
+{
+  return value_.load();
+}
+
+void Counter::snapshot()
+{
+  long value = value_.load();
+
+  if (snapshot_value_ == NULL) {
+    snapshot_value_ = new SnapshotBasic<long>();
+  }
+  ((SnapshotBasic<long> *)snapshot_value_)->setValue(value);
+}
+
 SimpleTimer::~SimpleTimer()
 {
   if (snapshot_value_ != NULL) {
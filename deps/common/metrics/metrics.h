@@ -33,11 +33,20 @@ public:
   }
 };
 
+// Counter is a monotonically increasing value, snapshot reports the total
 class Counter : public Metric {
-  void set_snapshot(SnapshotBasic<long> *value)
-  {
-    snapshot_value_ = value;
-  }
+public:
+  Counter();
+  virtual ~Counter();
+
+  void inc(long increase);
+  void inc();
+  long value() const;
+
+  void snapshot();
+
+protected:
+  std::atomic<long> value_;
 };
 
 class Meter : public Metric {
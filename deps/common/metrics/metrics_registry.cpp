@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/metrics/metrics_registry.h"
 #include "common/log/log.h"
+#include "common/metrics/metrics.h"
 
 namespace common {
 
@@ -24,6 +25,13 @@ MetricsRegistry &get_metrics_registry()
   return instance;
 }
 
+Counter &register_counter(const std::string &tag)
+{
+  Counter *counter = new Counter();
+  get_metrics_registry().register_metric(tag, counter);
+  return *counter;
+}
+
 void MetricsRegistry::register_metric(const std::string &tag, Metric *metric)
 {
   std::map<std::string, Metric *>::iterator it = metrics.find(tag);
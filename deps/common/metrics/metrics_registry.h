@@ -24,6 +24,8 @@ See the Mulan PSL v2 for more details. */
 
 namespace common {
 
+class Counter;
+
 class MetricsRegistry {
 public:
   MetricsRegistry(){};
@@ -47,5 +49,9 @@ protected:
 };
 
 MetricsRegistry &get_metrics_registry();
+
+// Create a process-wide counter and register it in the global registry.
+// The counter is never freed, callers usually keep it in a function-local static.
+Counter &register_counter(const std::string &tag);
 }  // namespace common
 #endif  //__COMMON_METRICS_METRICS_REGISTRY_H__
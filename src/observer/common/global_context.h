@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 class BufferPoolManager;
 class DefaultHandler;
 class TrxKit;
+class Vacuum;
 
 /**
  * @brief 放一些全局对象
@@ -24,6 +25,7 @@ struct GlobalContext {
   BufferPoolManager *buffer_pool_manager_ = nullptr;
   DefaultHandler *handler_ = nullptr;
   TrxKit *trx_kit_ = nullptr;
+  Vacuum *vacuum_ = nullptr; ///< 只有使用 MVCC 事务时才有
 
   static GlobalContext &instance();
 };
@@ -23,3 +23,29 @@ See the Mulan PSL v2 for more details. */
 #define SOCKET_BUFFER_SIZE 8192
 
 #define SESSION_STAGE_NAME "SessionStage"
+
+#define BUFFER_POOL_SECTION "BUFFER_POOL"
+#define FRAME_SHARD_NUM "FRAME_SHARD_NUM"
+#define FRAME_SHARD_NUM_DEFAULT 0
+#define REPLACEMENT_POLICY "REPLACEMENT_POLICY"
+#define REPLACEMENT_POLICY_DEFAULT "lru"
+#define PAGE_CLEANER_INTERVAL_MS "PAGE_CLEANER_INTERVAL_MS"
+#define PAGE_CLEANER_TAIL_RATIO "PAGE_CLEANER_TAIL_RATIO"
+#define PAGE_CLEANER_LOW_WATER_MARK "PAGE_CLEANER_LOW_WATER_MARK"
+#define PAGE_CLEANER_HIGH_WATER_MARK "PAGE_CLEANER_HIGH_WATER_MARK"
+#define PAGE_CLEANER_MAX_PAGES_PER_SECOND "PAGE_CLEANER_MAX_PAGES_PER_SECOND"
+#define READ_AHEAD_MAX_PAGES "READ_AHEAD_MAX_PAGES"
+#define IO_BACKEND "IO_BACKEND"
+#define IO_BACKEND_DEFAULT "sync"
+#define DIRECT_IO_DATABASES "DIRECT_IO_DATABASES"
+#define HUGE_PAGE "HUGE_PAGE"
+#define LOCK_MEMORY "LOCK_MEMORY"
+#define SCAN_RING_PAGES "SCAN_RING_PAGES"
+#define SCAN_RING_THRESHOLD "SCAN_RING_THRESHOLD"
+#define WARMUP_DUMP_FILE "WARMUP_DUMP_FILE"
+#define WARMUP_DUMP_INTERVAL_S "WARMUP_DUMP_INTERVAL_S"
+#define WARMUP_LOAD_THREADS "WARMUP_LOAD_THREADS"
+
+#define VACUUM_SECTION "VACUUM"
+#define VACUUM_INTERVAL_MS "VACUUM_INTERVAL_MS"
+#define VACUUM_MAX_PAGES_PER_SECOND "VACUUM_MAX_PAGES_PER_SECOND"
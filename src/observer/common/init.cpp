@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/init.h"
 
+#include <strings.h>
+
 #include "common/conf/ini.h"
 #include "common/ini_setting.h"
 #include "common/lang/string.h"
@@ -33,7 +35,9 @@ See the Mulan PSL v2 for more details. */
 #include "sql/query_cache/query_cache_stage.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/default/default_handler.h"
+#include "storage/trx/mvcc_trx.h"
 #include "storage/trx/trx.h"
+#include "storage/trx/vacuum.h"
 
 using namespace common;
 
@@ -141,15 +145,90 @@ int prepare_init_seda() {
 }
 
 int init_global_objects(ProcessParam *process_param, Ini &properties) {
-  GCTX.buffer_pool_manager_ = new BufferPoolManager();
+  int frame_shard_num = FRAME_SHARD_NUM_DEFAULT;
+  std::string frame_shard_num_str = properties.get(FRAME_SHARD_NUM, "", BUFFER_POOL_SECTION);
+  if (!frame_shard_num_str.empty()) {
+    str_to_val(frame_shard_num_str, frame_shard_num);
+  }
+
+  std::string replacer_name = properties.get(REPLACEMENT_POLICY, REPLACEMENT_POLICY_DEFAULT, BUFFER_POOL_SECTION);
+  std::unique_ptr<PageReplacer> replacer(PageReplacer::create(replacer_name.c_str(), 0));
+  if (replacer == nullptr) {
+    LOG_ERROR("unknown page replacement policy: %s", replacer_name.c_str());
+    return -1;
+  }
+
+  std::string io_backend = properties.get(IO_BACKEND, IO_BACKEND_DEFAULT, BUFFER_POOL_SECTION);
+  std::unique_ptr<PageIo> page_io(PageIo::create(io_backend.c_str()));
+  if (page_io == nullptr) {
+    LOG_ERROR("unknown page io backend: %s", io_backend.c_str());
+    return -1;
+  }
+  page_io.reset();
+
+  PageArenaOptions arena_options;
+  arena_options.huge_page = 0 == strcasecmp(properties.get(HUGE_PAGE, "false", BUFFER_POOL_SECTION).c_str(), "true");
+  arena_options.lock_memory = 0 == strcasecmp(properties.get(LOCK_MEMORY, "false", BUFFER_POOL_SECTION).c_str(), "true");
+
+  GCTX.buffer_pool_manager_ = new BufferPoolManager(process_param->buffer_pool_memory_size(), frame_shard_num,
+      replacer_name.c_str(), io_backend.c_str(), arena_options);
   BufferPoolManager::set_instance(GCTX.buffer_pool_manager_);
 
+  PageCleanerOptions cleaner_options;
+  std::string cleaner_value = properties.get(PAGE_CLEANER_INTERVAL_MS, "", BUFFER_POOL_SECTION);
+  if (!cleaner_value.empty()) {
+    str_to_val(cleaner_value, cleaner_options.interval_ms);
+  }
+  cleaner_value = properties.get(PAGE_CLEANER_TAIL_RATIO, "", BUFFER_POOL_SECTION);
+  if (!cleaner_value.empty()) {
+    str_to_val(cleaner_value, cleaner_options.tail_ratio);
+  }
+  cleaner_value = properties.get(PAGE_CLEANER_LOW_WATER_MARK, "", BUFFER_POOL_SECTION);
+  if (!cleaner_value.empty()) {
+    str_to_val(cleaner_value, cleaner_options.low_water_mark);
+  }
+  cleaner_value = properties.get(PAGE_CLEANER_HIGH_WATER_MARK, "", BUFFER_POOL_SECTION);
+  if (!cleaner_value.empty()) {
+    str_to_val(cleaner_value, cleaner_options.high_water_mark);
+  }
+  cleaner_value = properties.get(PAGE_CLEANER_MAX_PAGES_PER_SECOND, "", BUFFER_POOL_SECTION);
+  if (!cleaner_value.empty()) {
+    str_to_val(cleaner_value, cleaner_options.max_pages_per_second);
+  }
+
+  RC rc = GCTX.buffer_pool_manager_->start_page_cleaner(cleaner_options);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to start page cleaner. rc=%s", strrc(rc));
+    return -1;
+  }
+
+  GCTX.buffer_pool_manager_->set_direct_io_databases(properties.get(DIRECT_IO_DATABASES, "", BUFFER_POOL_SECTION));
+
+  std::string read_ahead_value = properties.get(READ_AHEAD_MAX_PAGES, "", BUFFER_POOL_SECTION);
+  if (!read_ahead_value.empty()) {
+    int read_ahead_max_pages = BufferPoolManager::DEFAULT_READ_AHEAD_MAX_PAGES;
+    str_to_val(read_ahead_value, read_ahead_max_pages);
+    GCTX.buffer_pool_manager_->set_read_ahead_max_pages(read_ahead_max_pages);
+  }
+
+  int scan_ring_pages = ScanRing::DEFAULT_SIZE;
+  double scan_ring_threshold = ScanRing::DEFAULT_THRESHOLD;
+  std::string scan_ring_value = properties.get(SCAN_RING_PAGES, "", BUFFER_POOL_SECTION);
+  if (!scan_ring_value.empty()) {
+    str_to_val(scan_ring_value, scan_ring_pages);
+  }
+  scan_ring_value = properties.get(SCAN_RING_THRESHOLD, "", BUFFER_POOL_SECTION);
+  if (!scan_ring_value.empty()) {
+    str_to_val(scan_ring_value, scan_ring_threshold);
+  }
+  GCTX.buffer_pool_manager_->set_scan_ring(scan_ring_pages, scan_ring_threshold);
+
   GCTX.handler_ = new DefaultHandler();
 
   DefaultHandler::set_default(GCTX.handler_);
 
   int ret = 0;
-  RC rc = TrxKit::init_global(process_param->trx_kit_name().c_str());
+  rc = TrxKit::init_global(process_param->trx_kit_name().c_str());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to init trx kit. rc=%s", strrc(rc));
     ret = -1;
@@ -161,10 +240,65 @@ int init_global_objects(ProcessParam *process_param, Ini &properties) {
     LOG_ERROR("failed to init handler. rc=%s", strrc(rc));
     return -1;
   }
+
+  // 只有 MVCC 事务会留下旧版本，恢复完成之后再开始清理
+  MvccTrxKit *mvcc_trx_kit = dynamic_cast<MvccTrxKit *>(GCTX.trx_kit_);
+  if (mvcc_trx_kit != nullptr) {
+    GCTX.vacuum_ = new Vacuum(*mvcc_trx_kit);
+    std::vector<Db *> dbs;
+    GCTX.handler_->all_dbs(dbs);
+    for (Db *db : dbs) {
+      GCTX.vacuum_->add_db(db);
+    }
+
+    VacuumOptions vacuum_options;
+    std::string vacuum_value = properties.get(VACUUM_INTERVAL_MS, "", VACUUM_SECTION);
+    if (!vacuum_value.empty()) {
+      str_to_val(vacuum_value, vacuum_options.interval_ms);
+    }
+    vacuum_value = properties.get(VACUUM_MAX_PAGES_PER_SECOND, "", VACUUM_SECTION);
+    if (!vacuum_value.empty()) {
+      str_to_val(vacuum_value, vacuum_options.max_pages_per_second);
+    }
+    rc = GCTX.vacuum_->start(vacuum_options);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to start vacuum. rc=%s", strrc(rc));
+      return -1;
+    }
+  }
+
+  // 所有的表都打开之后才能加载上次保存的页面
+  BufferPoolWarmerOptions warmer_options;
+  warmer_options.dump_file = properties.get(WARMUP_DUMP_FILE, "", BUFFER_POOL_SECTION);
+  std::string warmer_value = properties.get(WARMUP_DUMP_INTERVAL_S, "", BUFFER_POOL_SECTION);
+  if (!warmer_value.empty()) {
+    str_to_val(warmer_value, warmer_options.dump_interval_s);
+  }
+  warmer_value = properties.get(WARMUP_LOAD_THREADS, "", BUFFER_POOL_SECTION);
+  if (!warmer_value.empty()) {
+    str_to_val(warmer_value, warmer_options.load_threads);
+  }
+  rc = GCTX.buffer_pool_manager_->start_warmer(warmer_options);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to start buffer pool warmer. rc=%s", strrc(rc));
+    return -1;
+  }
   return ret;
 }
 
 int uninit_global_objects() {
+  // 要在关闭数据库之前停止
+  if (GCTX.vacuum_ != nullptr) {
+    delete GCTX.vacuum_;
+    GCTX.vacuum_ = nullptr;
+  }
+
+  // 关闭表的时候会释放所有的页帧，要在这之前保存页面列表
+  if (GCTX.buffer_pool_manager_ != nullptr) {
+    GCTX.buffer_pool_manager_->warmer().stop();
+    GCTX.buffer_pool_manager_->warmer().dump();
+  }
+
   // TODO use global context
   DefaultHandler *default_handler = &DefaultHandler::get_default();
   if (default_handler != nullptr) {
@@ -21,3 +21,11 @@ using SlotNum = int32_t;
 
 /// LSN for log sequence number
 using LSN = int32_t;
+
+/// 表记录在数据页面上的存放格式，创建表时通过 storage_format 选项指定
+enum class StorageFormat {
+  UNKNOWN_FORMAT = 0,
+  FIXED_FORMAT,   ///< 定长记录，每条记录占用一个 record_size 大小的槽位
+  SLOTTED_FORMAT, ///< 变长记录，页面上有一个槽位目录(slot directory)，记录从页尾向前存放
+  PAX_FORMAT,     ///< 按列存放(PAX)，页面内每一列的值连续存放在一个 minipage 中，适合只读取少数几列的分析查询
+};
@@ -21,7 +21,7 @@ Session &Session::default_session() {
   return session;
 }
 
-Session::Session(const Session &other) : db_(other.db_) {}
+Session::Session(const Session &other) : db_(other.db_), parallel_degree_(other.parallel_degree_) {}
 
 Session::~Session() {
   if (nullptr != trx_) {
@@ -76,6 +76,18 @@ public:
   void set_sql_debug(bool sql_debug) { sql_debug_ = sql_debug; }
   bool sql_debug_on() const { return sql_debug_; }
 
+  /**
+   * @brief 只读的全表扫描使用几个线程并行执行，1 表示不并行
+   */
+  void set_parallel_degree(int parallel_degree) { parallel_degree_ = parallel_degree; }
+  int parallel_degree() const { return parallel_degree_; }
+
+  /**
+   * @brief 创建索引时B+树节点填充到最大容量的百分比
+   */
+  void set_index_fill_factor(int index_fill_factor) { index_fill_factor_ = index_fill_factor; }
+  int index_fill_factor() const { return index_fill_factor_; }
+
   /**
    * @brief 将指定会话设置到线程变量中
    * 
@@ -94,4 +106,6 @@ private:
   SessionEvent *current_request_ = nullptr; ///< 当前正在处理的请求
   bool trx_multi_operation_mode_ = false; ///< 当前事务的模式，是否多语句模式. 单语句模式自动提交
   bool sql_debug_ = true;                ///< 是否输出SQL调试信息
+  int parallel_degree_ = 1;              ///< 全表扫描的并行度
+  int index_fill_factor_ = 90;           ///< 创建索引时节点的填充比例
 };
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "session/session.h"
 #include "sql/stmt/create_index_stmt.h"
 #include "storage/table/table.h"
+#include "storage/trx/trx.h"
 
 RC CreateIndexExecutor::execute(SQLStageEvent *sql_event) {
   Stmt *stmt = sql_event->stmt();
@@ -25,8 +26,28 @@ RC CreateIndexExecutor::execute(SQLStageEvent *sql_event) {
 
   CreateIndexStmt *create_index_stmt = static_cast<CreateIndexStmt *>(stmt);
 
+  // 扫描已有的记录需要一个开始了的事务，否则看不到最近提交的记录
   Trx *trx = session->current_trx();
+  RC rc = trx->start_if_need();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to start trx. rc=%s", strrc(rc));
+    return rc;
+  }
+
   Table *table = create_index_stmt->table();
-  return table->create_index(trx, create_index_stmt->field_metas(), create_index_stmt->index_name().c_str(),
-                             create_index_stmt->unique());
+  rc = table->create_index(trx, create_index_stmt->field_metas(), create_index_stmt->index_name().c_str(),
+                           create_index_stmt->unique(), session->index_fill_factor(),
+                           create_index_stmt->include_metas());
+
+  if (!session->is_trx_multi_operation_mode()) {
+    if (rc == RC::SUCCESS) {
+      rc = trx->commit();
+    } else {
+      RC rc2 = trx->rollback();
+      if (rc2 != RC::SUCCESS) {
+        LOG_PANIC("rollback failed. rc=%s", strrc(rc2));
+      }
+    }
+  }
+  return rc;
 }
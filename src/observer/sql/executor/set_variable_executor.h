@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/executor/sql_result.h"
 #include "sql/operator/string_list_physical_operator.h"
 #include "sql/stmt/set_variable_stmt.h"
+#include "storage/buffer/disk_buffer_pool.h"
 
 /**
  * @brief SetVariable语句执行器
@@ -26,6 +27,9 @@ See the Mulan PSL v2 for more details. */
  */
 class SetVariableExecutor {
 public:
+  static constexpr int MAX_PARALLEL_DEGREE = 64;
+  static constexpr int MIN_INDEX_FILL_FACTOR = 10;
+
   SetVariableExecutor() = default;
   virtual ~SetVariableExecutor() = default;
 
@@ -45,11 +49,37 @@ public:
 
       session->set_sql_debug(bool_value);
       LOG_TRACE("set sql_debug to %d", bool_value);
+    } else if (strcasecmp(var_name, "buffer_pool_size_mb") == 0) {
+      // 在线调整缓冲池的大小，单位是MB
+      if (var_value.attr_type() != AttrType::INTS || var_value.get_int() <= 0) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      rc = BufferPoolManager::instance().resize(static_cast<size_t>(var_value.get_int()) * 1024 * 1024);
+      LOG_INFO("set buffer_pool_size_mb to %d. rc=%s", var_value.get_int(), strrc(rc));
+    } else if (strcasecmp(var_name, "parallel_degree") == 0) {
+      // 只读全表扫描使用的线程数
+      if (var_value.attr_type() != AttrType::INTS || var_value.get_int() <= 0 ||
+          var_value.get_int() > MAX_PARALLEL_DEGREE) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_parallel_degree(var_value.get_int());
+      LOG_TRACE("set parallel_degree to %d", var_value.get_int());
+    } else if (strcasecmp(var_name, "index_fill_factor") == 0) {
+      // 创建索引时B+树节点的填充比例，百分比
+      if (var_value.attr_type() != AttrType::INTS || var_value.get_int() < MIN_INDEX_FILL_FACTOR ||
+          var_value.get_int() > 100) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_index_fill_factor(var_value.get_int());
+      LOG_TRACE("set index_fill_factor to %d", var_value.get_int());
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
 
-    return RC::SUCCESS;
+    return rc;
   }
 
 private:
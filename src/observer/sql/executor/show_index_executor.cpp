@@ -31,7 +31,8 @@ RC ShowIndexExecutor::execute(SQLStageEvent *sql_event) {
     const auto &index_meta = table_meta.index(i);
     auto &fields = index_meta->fields();
     int index = 1;
-    for (int i = 0; i < fields.size(); i++) {
+    // INCLUDE 的字段不是索引的键值，不显示
+    for (int i = 0; i < index_meta->key_field_num(); i++) {
       if (!fields[i].visible())
         continue;
       oper->append({
@@ -25,6 +25,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse_defs.h"
 #include "sql/parser/value.h"
 #include "storage/record/record.h"
+#include "storage/record/text_file.h"
 
 class Table;
 
@@ -159,11 +160,9 @@ public:
     if (null_flag & (1 << field_meta->index())) {
       cell.set_null();
     } else if (field_meta->type() == TEXTS) {
-      int offset = *(int *)(this->record_->data() + field_meta->offset());
-      RC rc = const_cast<Table *>(table_)->get_text(offset, cell);
-      if (rc != RC::SUCCESS) {
-        return rc;
-      }
+      // 只记下编号，表达式真正用到字符串时才去 TEXT 文件中读取
+      int text_id = *(int *)(this->record_->data() + field_meta->offset());
+      cell.set_text_ref(table_->text_handler(), text_id);
     } else {
       cell.set_type(field_meta->type());
       cell.set_data(this->record_->data() + field_meta->offset(), field_meta->len());
@@ -11,6 +11,7 @@ public:
   const TupleSchema *schema() const { return schema_.get(); }
   const std::string &table_name() const { return table_name_; }
   const std::vector<AttrInfoSqlNode> &attr_infos() const { return attr_infos_; }
+  StorageFormat storage_format() const { return storage_format_; }
 
   friend class LogicalPlanGenerator;
   friend class PhysicalPlanGenerator;
@@ -19,6 +20,7 @@ private:
   std::shared_ptr<TupleSchema> schema_;
   std::string table_name_;
   std::vector<AttrInfoSqlNode> attr_infos_;
+  StorageFormat storage_format_ = StorageFormat::FIXED_FORMAT;
   Db *db_;
   std::vector<FieldInfo> types_;
 };
@@ -9,7 +9,7 @@
 RC CreateTablePhysicalOperator::open(Trx *trx) {
   RC rc = RC::SUCCESS;
   if (children_.empty()) {
-    return db_->create_table(table_name_.c_str(), attr_infos_.size(), attr_infos_.data());
+    return db_->create_table(table_name_.c_str(), attr_infos_.size(), attr_infos_.data(), storage_format_);
   }
   if (children_.size() > 1) {
     LOG_WARN("create table has more than one children");
@@ -72,7 +72,7 @@ RC CreateTablePhysicalOperator::open(Trx *trx) {
       attr_infos_[i].length = attr_type_to_size(attr_infos_[i].type);
     }
   }
-  rc = db_->create_table(table_name_.c_str(), attr_infos_.size(), attr_infos_.data());
+  rc = db_->create_table(table_name_.c_str(), attr_infos_.size(), attr_infos_.data(), storage_format_);
   if (rc != RC::SUCCESS)
     return rc;
   Table *table = db_->find_table(table_name_.c_str());
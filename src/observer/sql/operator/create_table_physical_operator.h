@@ -21,5 +21,6 @@ private:
   std::shared_ptr<TupleSchema> schema_;
   std::string table_name_;
   std::vector<AttrInfoSqlNode> attr_infos_;
+  StorageFormat storage_format_ = StorageFormat::FIXED_FORMAT;
   std::vector<FieldInfo> types_;
 };
@@ -0,0 +1,206 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/operator/gather_physical_operator.h"
+#include "common/log/log.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+GatherPhysicalOperator::GatherPhysicalOperator(Table *table, vector<unique_ptr<TableScanPhysicalOperator>> workers)
+    : table_(table) {
+  for (unique_ptr<TableScanPhysicalOperator> &worker : workers) {
+    worker->set_morsels(&morsels_);
+    add_child(std::move(worker));
+  }
+}
+
+GatherPhysicalOperator::~GatherPhysicalOperator() { close(); }
+
+string GatherPhysicalOperator::param() const { return "workers=" + to_string(children_.size()); }
+
+RC GatherPhysicalOperator::open(Trx *trx) {
+  // 所有的扫描算子都在当前线程中打开，打开时如果出错不需要再通知其它线程
+  morsels_.reset();
+  RC rc = RC::SUCCESS;
+  size_t opened = 0;
+  for (; opened < children_.size(); opened++) {
+    rc = children_[opened]->open(trx);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open table scan of gather. table=%s, rc=%s", table_->name(), strrc(rc));
+      break;
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    for (size_t i = 0; i < opened; i++) {
+      children_[i]->close();
+    }
+    return rc;
+  }
+
+  tuple_.set_schema(table_, table_->table_meta().field_metas());
+  current_chunk_.reset();
+  chunk_index_ = -1;
+  chunks_.clear();
+  max_chunks_ = children_.size() * 2;
+  running_workers_ = static_cast<int>(children_.size());
+  stopped_ = false;
+  worker_rc_ = RC::SUCCESS;
+
+  for (unique_ptr<PhysicalOperator> &child : children_) {
+    threads_.emplace_back(&GatherPhysicalOperator::run_worker, this, static_cast<TableScanPhysicalOperator *>(child.get()));
+  }
+  return RC::SUCCESS;
+}
+
+void GatherPhysicalOperator::run_worker(TableScanPhysicalOperator *worker) {
+  RC rc = RC::SUCCESS;
+  auto chunk = make_unique<Chunk>();
+  while (OB_SUCC(rc = worker->next(nullptr))) {
+    const Record &record = worker->current_record();
+    chunk->offsets.push_back(static_cast<int>(chunk->data.size()));
+    chunk->data.insert(chunk->data.end(), record.data(), record.data() + record.len());
+    chunk->rids.push_back(record.rid());
+    if (chunk->size() < CHUNK_RECORDS) {
+      continue;
+    }
+
+    chunk->offsets.push_back(static_cast<int>(chunk->data.size()));
+    if (!push_chunk(std::move(chunk))) {
+      break;
+    }
+    chunk = make_unique<Chunk>();
+  }
+
+  if (rc == RC::RECORD_EOF) {
+    rc = RC::SUCCESS;
+    if (chunk && chunk->size() > 0) {
+      chunk->offsets.push_back(static_cast<int>(chunk->data.size()));
+      push_chunk(std::move(chunk));
+    }
+  }
+
+  RC close_rc = worker->close();
+  if (OB_SUCC(rc)) {
+    rc = close_rc;
+  }
+
+  lock_guard<mutex> guard(lock_);
+  if (OB_FAIL(rc) && OB_SUCC(worker_rc_)) {
+    LOG_WARN("table scan worker of gather failed. table=%s, rc=%s", table_->name(), strrc(rc));
+    worker_rc_ = rc;
+  }
+  running_workers_--;
+  not_empty_.notify_all();
+}
+
+bool GatherPhysicalOperator::push_chunk(unique_ptr<Chunk> chunk) {
+  unique_lock<mutex> guard(lock_);
+  not_full_.wait(guard, [this]() { return stopped_ || chunks_.size() < max_chunks_; });
+  if (stopped_) {
+    return false;
+  }
+
+  chunks_.push_back(std::move(chunk));
+  not_empty_.notify_one();
+  return true;
+}
+
+RC GatherPhysicalOperator::next(Tuple *env_tuple) {
+  while (true) {
+    if (current_chunk_ && ++chunk_index_ < current_chunk_->size()) {
+      const int offset = current_chunk_->offsets[chunk_index_];
+      current_record_.set_data(
+          current_chunk_->data.data() + offset, current_chunk_->offsets[chunk_index_ + 1] - offset);
+      current_record_.set_rid(current_chunk_->rids[chunk_index_]);
+      return RC::SUCCESS;
+    }
+
+    unique_lock<mutex> guard(lock_);
+    not_empty_.wait(guard, [this]() { return !chunks_.empty() || running_workers_ == 0 || OB_FAIL(worker_rc_); });
+    if (OB_FAIL(worker_rc_)) {
+      return worker_rc_;
+    }
+    if (chunks_.empty()) {
+      current_chunk_.reset();
+      return RC::RECORD_EOF;
+    }
+
+    current_chunk_ = std::move(chunks_.front());
+    chunks_.pop_front();
+    chunk_index_ = -1;
+    not_full_.notify_one();
+  }
+}
+
+RC GatherPhysicalOperator::close() {
+  {
+    lock_guard<mutex> guard(lock_);
+    stopped_ = true;
+    not_full_.notify_all();
+  }
+
+  for (thread &t : threads_) {
+    t.join();
+  }
+  threads_.clear();
+  chunks_.clear();
+  current_chunk_.reset();
+  return RC::SUCCESS;
+}
+
+Tuple *GatherPhysicalOperator::current_tuple() {
+  tuple_.set_record(&current_record_);
+  return &tuple_;
+}
+
+bool GatherPhysicalOperator::can_parallelize(vector<unique_ptr<Expression>> &predicates) {
+  for (unique_ptr<Expression> &expr : predicates) {
+    if (!can_parallelize(expr.get())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GatherPhysicalOperator::can_parallelize(Expression *expr) {
+  if (expr == nullptr) {
+    return true;
+  }
+
+  switch (expr->type()) {
+  case ExprType::FIELD:
+  case ExprType::VALUE: {
+    return true;
+  } break;
+  case ExprType::CAST: {
+    return can_parallelize(static_cast<CastExpr *>(expr)->child().get());
+  } break;
+  case ExprType::COMPARISON: {
+    auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+    return can_parallelize(comparison_expr->left().get()) && can_parallelize(comparison_expr->right().get());
+  } break;
+  case ExprType::CONJUNCTION: {
+    auto conjunction_expr = static_cast<ConjunctionExpr *>(expr);
+    return can_parallelize(conjunction_expr->left().get()) && can_parallelize(conjunction_expr->right().get());
+  } break;
+  case ExprType::ARITHMETIC: {
+    auto arithmetic_expr = static_cast<ArithmeticExpr *>(expr);
+    return can_parallelize(arithmetic_expr->left().get()) && can_parallelize(arithmetic_expr->right().get());
+  } break;
+  default: {
+    return false;
+  }
+  }
+}
@@ -0,0 +1,105 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/record/record_manager.h"
+
+class Table;
+class TableScanPhysicalOperator;
+
+/**
+ * @brief 并行表扫描的汇总算子
+ * @ingroup PhysicalOperator
+ * @details 子算子是扫描同一张表的多个 TableScanPhysicalOperator，每个子算子在一个单独的线程中运行，
+ * 从同一个 MorselDispenser 中领取页面，并在线程中执行下推的过滤条件。
+ * 通过过滤的记录拷贝出来，攒够一批后放到队列中，由调用 next 的线程逐条返回。
+ * 返回记录的顺序与串行扫描不同。只能用于只读扫描
+ */
+class GatherPhysicalOperator : public PhysicalOperator {
+public:
+  /// 一批最多拷贝多少条记录
+  static constexpr int CHUNK_RECORDS = 1024;
+
+  /**
+   * @param table   扫描的表
+   * @param workers 扫描同一张表的算子，每个算子使用一个线程
+   */
+  GatherPhysicalOperator(Table *table, std::vector<std::unique_ptr<TableScanPhysicalOperator>> workers);
+
+  virtual ~GatherPhysicalOperator();
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::GATHER; }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next(Tuple *env_tuple) override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  /**
+   * @brief 过滤条件是否可以在多个线程中同时执行
+   * @details 只接受字段、常量以及它们的比较、运算和类型转换，子查询等表达式在计算时会修改自身的状态
+   */
+  static bool can_parallelize(std::vector<std::unique_ptr<Expression>> &predicates);
+  static bool can_parallelize(Expression *expr);
+
+private:
+  /**
+   * @brief 一个线程拷贝出来的一批记录
+   */
+  struct Chunk
+  {
+    std::vector<char> data;
+    std::vector<int>  offsets;  ///< 每条记录在 data 中的起始位置，最后一个元素是 data 的长度
+    std::vector<RID>  rids;
+
+    int size() const { return static_cast<int>(rids.size()); }
+  };
+
+  void run_worker(TableScanPhysicalOperator *worker);
+
+  /**
+   * @brief 把一批记录放到队列中，队列满时等待
+   * @return 算子已经关闭时返回 false
+   */
+  bool push_chunk(std::unique_ptr<Chunk> chunk);
+
+private:
+  Table *table_ = nullptr;
+  MorselDispenser morsels_;
+  std::vector<std::thread> threads_;
+
+  std::mutex                          lock_;
+  std::condition_variable             not_empty_;
+  std::condition_variable             not_full_;
+  std::deque<std::unique_ptr<Chunk>>  chunks_;
+  size_t                              max_chunks_ = 0;
+  int                                 running_workers_ = 0;
+  bool                                stopped_ = false;
+  RC                                  worker_rc_ = RC::SUCCESS;  ///< 第一个出错的线程的错误码
+
+  std::unique_ptr<Chunk> current_chunk_;
+  int                    chunk_index_ = -1;
+  Record                 current_record_;
+  RowTuple               tuple_;
+};
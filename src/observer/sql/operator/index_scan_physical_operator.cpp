@@ -18,28 +18,32 @@ See the Mulan PSL v2 for more details. */
 #include <cstring>
 
 RC IndexScanPhysicalOperator::make_data(const std::vector<Value> &values, std::vector<FieldMeta> &meta, Table *table,
-                                        std::vector<char> &out) {
+                                        std::vector<char> &out, int &len, std::vector<int> &text_ids) {
   std::vector<char> ret;
   int size = 0;
   for (auto &field : meta) {
     size += field.len();
   }
   ret.resize(size);
-  char *beg = ret.data();
-  for (int i = 0; i < values.size() && i < meta.size(); i++) {
-    Value &value = const_cast<Value &>(values[i]);
-    if (value.attr_type() == TEXTS) {
-      int offset;
-      RC rc = table->add_text(value.get_string().c_str(), offset);
+  // 第一个字段是 NULL 标记，边界中的值都不是 NULL
+  char *beg = ret.data() + meta[0].len();
+  for (int i = 0; i < values.size() && i + 1 < meta.size(); i++) {
+    Value value = values[i];
+    const FieldMeta &field = meta[i + 1];
+    if (field.type() == TEXTS && value.attr_type() != NULLS) {
+      int text_id;
+      RC rc = table->add_text(value.get_string().c_str(), text_id);
       if (rc != RC::SUCCESS)
         return rc;
-      value.set_int(offset);
+      text_ids.push_back(text_id);
+      value.set_int(text_id);
     } else {
-      Value::convert(value.attr_type(), meta[i].type(), value);
+      Value::convert(value.attr_type(), field.type(), value);
     }
-    memcpy(beg, value.data(), meta[i].len());
-    beg += meta[i].len();
+    memcpy(beg, value.data(), std::min(value.length(), field.len()));
+    beg += field.len();
   }
+  len = static_cast<int>(beg - ret.data());
   out.swap(ret);
   return RC::SUCCESS;
 }
@@ -50,21 +54,24 @@ IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index,
     : table_(table), index_(index), readonly_(readonly), left_inclusive_(left_inclusive),
       right_inclusive_(right_inclusive) {
   std::vector<FieldMeta> fields = index_->index_meta().fields();
-  size_ = 0;
-  for (auto &field : fields) {
-    size_ += field.len();
-  }
-  auto &table_meta = table_->table_meta();
-  left_value_.resize(size_);
-  right_value_.resize(size_);
   RC rc = RC::SUCCESS;
-  rc = make_data(left_value, fields, table, left_value_);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("fail to make data");
+  if (!left_value.empty()) {
+    rc = make_data(left_value, fields, table, left_value_, left_len_, text_ids_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("fail to make data");
+    }
   }
-  rc = make_data(right_value, fields, table, right_value_);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("fail to make data");
+  if (!right_value.empty()) {
+    rc = make_data(right_value, fields, table, right_value_, right_len_, text_ids_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("fail to make data");
+    }
+  }
+}
+
+IndexScanPhysicalOperator::~IndexScanPhysicalOperator() {
+  for (int text_id : text_ids_) {
+    table_->delete_text(text_id);
   }
 }
 
@@ -73,9 +80,11 @@ RC IndexScanPhysicalOperator::open(Trx *trx) {
     return RC::INTERNAL;
   }
 
-  // TODO(zhaoyiping): 这里要改
+  // 边界只给出了部分字段时，按照最左前缀扫描
+  const char *left_key = left_value_.empty() ? nullptr : left_value_.data();
+  const char *right_key = right_value_.empty() ? nullptr : right_value_.data();
   IndexScanner *index_scanner =
-      index_->create_scanner(left_value_.data(), size_, left_inclusive_, right_value_.data(), size_, right_inclusive_);
+      index_->create_scanner(left_key, left_len_, left_inclusive_, right_key, right_len_, right_inclusive_);
   if (nullptr == index_scanner) {
     LOG_WARN("failed to create index scanner");
     return RC::INTERNAL;
@@ -91,6 +100,12 @@ RC IndexScanPhysicalOperator::open(Trx *trx) {
 
   tuple_.set_schema(table_, table_->table_meta().field_metas());
 
+  if (index_only_) {
+    key_record_data_.assign(table_->table_meta().record_size(), 0);
+    key_record_.set_data(key_record_data_.data(), static_cast<int>(key_record_data_.size()));
+  }
+  tuple_record_ = &current_record_;
+
   trx_ = trx;
   return RC::SUCCESS;
 }
@@ -99,10 +114,22 @@ RC IndexScanPhysicalOperator::next(Tuple *env_tuple) {
   RID rid;
   RC rc = RC::SUCCESS;
 
-  record_page_handler_.cleanup();
-
   bool filter_result = false;
   while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
+    if (index_only_ && trx_->visible_without_record(table_, rid, readonly_)) {
+      make_record_from_key(rid);
+      tuple_record_ = &key_record_;
+      tuple_.set_record(&key_record_);
+      rc = filter(tuple_, filter_result);
+      if (rc != RC::SUCCESS || filter_result) {
+        return rc;
+      }
+      continue;
+    }
+
+    // 上一条记录的页面可能还没有释放：跳过的记录、上一次 next 返回的记录
+    record_page_handler_.cleanup();
+    tuple_record_ = &current_record_;
     rc = record_handler_->get_record(record_page_handler_, &rid, readonly_, &current_record_);
     if (rc != RC::SUCCESS) {
       return rc;
@@ -130,16 +157,28 @@ RC IndexScanPhysicalOperator::next(Tuple *env_tuple) {
 }
 
 RC IndexScanPhysicalOperator::close() {
+  record_page_handler_.cleanup();
   index_scanner_->destroy();
   index_scanner_ = nullptr;
   return RC::SUCCESS;
 }
 
 Tuple *IndexScanPhysicalOperator::current_tuple() {
-  tuple_.set_record(&current_record_);
+  tuple_.set_record(tuple_record_);
   return &tuple_;
 }
 
+void IndexScanPhysicalOperator::make_record_from_key(const RID &rid) {
+  // 键值就是索引中各个字段依次拼接起来的，包括 NULL 标记字段和 INCLUDE 的字段
+  const char *key = index_scanner_->current_key();
+  char *data = key_record_data_.data();
+  for (const FieldMeta &field : index_->index_meta().fields()) {
+    memcpy(data + field.offset(), key, field.len());
+    key += field.len();
+  }
+  key_record_.set_rid(rid);
+}
+
 void IndexScanPhysicalOperator::set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs) {
   predicates_ = std::move(exprs);
 }
@@ -165,5 +204,9 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result) {
 }
 
 std::string IndexScanPhysicalOperator::param() const {
-  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+  std::string result = std::string(index_->index_meta().name()) + " ON " + table_->name();
+  if (index_only_) {
+    result += " INDEX ONLY";
+  }
+  return result;
 }
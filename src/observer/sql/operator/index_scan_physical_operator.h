@@ -23,10 +23,14 @@ See the Mulan PSL v2 for more details. */
  */
 class IndexScanPhysicalOperator : public PhysicalOperator {
 public:
+  /**
+   * @param left_value 左边界上索引前几个字段的值，不包括 NULL 标记字段。空表示没有左边界
+   * @param right_value 右边界上索引前几个字段的值，空表示没有右边界
+   */
   IndexScanPhysicalOperator(Table *table, Index *index, bool readonly, const std::vector<Value> &left_value,
                             bool left_inclusive, const std::vector<Value> &right_value, bool right_inclusive);
 
-  virtual ~IndexScanPhysicalOperator() = default;
+  virtual ~IndexScanPhysicalOperator();
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_SCAN; }
 
@@ -40,10 +44,19 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 用到的字段都在索引中时，直接用索引中的键值构造记录
+   * @details 记录所在的页面对所有事务都可见时就不再读取数据页面，否则还是读取记录检查可见性
+   */
+  void set_index_only(bool index_only) { index_only_ = index_only; }
+
 private:
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
+  /// 把索引当前键值中各个字段的值复制到 key_record_ 中对应的位置
+  void make_record_from_key(const RID &rid);
+
 private:
   Trx *trx_ = nullptr;
   Table *table_ = nullptr;
@@ -56,16 +69,24 @@ private:
   Record current_record_;
   RowTuple tuple_;
 
+  bool index_only_ = false;
+  std::vector<char> key_record_data_; ///< 只扫描索引时用键值构造的记录
+  Record key_record_;
+  Record *tuple_record_ = &current_record_; ///< 当前的记录，current_record_ 或者 key_record_
+
   std::vector<char> left_value_;
   std::vector<char> right_value_;
+  int left_len_ = 0;  ///< 左边界中有效的长度，小于完整键值长度时是前缀
+  int right_len_ = 0; ///< 右边界中有效的长度
 
   bool left_inclusive_ = false;
   bool right_inclusive_ = false;
 
   std::vector<std::unique_ptr<Expression>> predicates_;
 
-  int size_ = 0;
+  /// 键值中的 TEXT 也要写到 TEXT 文件中才能和索引中的键值比较，算子销毁时释放
+  std::vector<int> text_ids_;
 
   static RC make_data(const std::vector<Value> &values, std::vector<FieldMeta> &meta, Table *table,
-                      std::vector<char> &out);
+                      std::vector<char> &out, int &len, std::vector<int> &text_ids);
 };
@@ -30,22 +30,21 @@ RC InsertPhysicalOperator::open(Trx *trx) {
 }
 
 RC InsertPhysicalOperator::insert_all(Trx *trx, vector<Record> &inserted) {
-  inserted.reserve(values_.size());
-  for (auto &value : values_) {
-    Record record;
-    RC rc = table_->make_record(static_cast<int>(value.size()), value.data(), record);
+  inserted.resize(values_.size());
+  for (size_t i = 0; i < values_.size(); i++) {
+    vector<Value> &value = values_[i];
+    RC rc = table_->make_record(static_cast<int>(value.size()), value.data(), inserted[i]);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to make record. rc=%s", strrc(rc));
       return rc;
     }
+  }
 
-    rc = trx->insert_record(table_, record);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record by transaction. rc=%s", strrc(rc));
-      return rc;
-    }
-
-    inserted.push_back(record);
+  // 多行数据一起插入，表数据按页面成批写入，索引按键值顺序插入，只记录一条日志
+  RC rc = trx->insert_records(table_, inserted);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records by transaction. rc=%s", strrc(rc));
+    return rc;
   }
   return RC::SUCCESS;
 }
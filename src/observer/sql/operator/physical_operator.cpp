@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 std::string physical_operator_type_name(PhysicalOperatorType type) {
   switch (type) {
   case PhysicalOperatorType::TABLE_SCAN: return "TABLE_SCAN";
+  case PhysicalOperatorType::GATHER: return "GATHER";
   case PhysicalOperatorType::INDEX_SCAN: return "INDEX_SCAN";
   case PhysicalOperatorType::NESTED_LOOP_JOIN: return "NESTED_LOOP_JOIN";
   case PhysicalOperatorType::EXPLAIN: return "EXPLAIN";
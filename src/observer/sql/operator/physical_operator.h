@@ -34,6 +34,7 @@ class Trx;
  */
 enum class PhysicalOperatorType {
   TABLE_SCAN,
+  GATHER,
   INDEX_SCAN,
   VIEW_GET,
   NESTED_LOOP_JOIN,
@@ -27,6 +27,7 @@ public:
 
   Table *table() const { return table_; }
   bool readonly() const { return readonly_; }
+  const std::vector<Field> &fields() const { return fields_; }
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
   void add_predicate(std::unique_ptr<Expression> &&expr);
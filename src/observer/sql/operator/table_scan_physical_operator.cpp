@@ -12,20 +12,28 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/table_scan_physical_operator.h"
 #include "common/rc.h"
 #include "event/sql_debug.h"
+#include "sql/expr/expression.h"
 #include "storage/table/table.h"
 
 using namespace std;
 
 RC TableScanPhysicalOperator::open(Trx *trx) {
-  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_);
+  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_, morsels_, zone_filter_.get());
   if (rc == RC::SUCCESS) {
     tuple_.set_schema(table_, table_->table_meta().field_metas());
   }
   trx_ = trx;
+  record_batch_.reset(BP_INVALID_PAGE_NUM, 0);
+  record_batch_.set_projection(projection_);
+  batch_index_ = -1;
   return rc;
 }
 
 RC TableScanPhysicalOperator::next(Tuple *env_tuple) {
+  if (readonly_) {
+    return next_in_batch();
+  }
+
   RC rc = RC::SUCCESS;
 
   if (!record_scanner_.has_next()) {
@@ -61,6 +69,32 @@ RC TableScanPhysicalOperator::next(Tuple *env_tuple) {
   return rc;
 }
 
+RC TableScanPhysicalOperator::next_in_batch() {
+  RC rc = RC::SUCCESS;
+  bool filter_result = false;
+  while (true) {
+    batch_index_ = record_batch_.next_visible(batch_index_ + 1);
+    if (batch_index_ < 0) {
+      rc = record_scanner_.next_batch(record_batch_);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      continue;
+    }
+
+    record_batch_.get_record(batch_index_, current_record_);
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    if (filter_result) {
+      return rc;
+    }
+  }
+}
+
 RC TableScanPhysicalOperator::close() { return record_scanner_.close_scan(); }
 
 Tuple *TableScanPhysicalOperator::current_tuple() {
@@ -68,16 +102,120 @@ Tuple *TableScanPhysicalOperator::current_tuple() {
   return &tuple_;
 }
 
-string TableScanPhysicalOperator::param() const { return table_->name(); }
+string TableScanPhysicalOperator::param() const {
+  if (!zone_filter_) {
+    return table_->name();
+  }
+
+  // EXPLAIN 时还没有扫描，按照当前的区域映射统计会跳过多少个页面。第0个页面是文件头
+  const int page_count = table_->record_handler()->page_count();
+  int skipped = 0;
+  for (PageNum page_num = 1; page_num < page_count; page_num++) {
+    if (!zone_filter_->may_match(page_num)) {
+      skipped++;
+    }
+  }
+  return string(table_->name()) + ", zone map skips " + to_string(skipped) + "/" + to_string(max(page_count - 1, 0)) +
+         " pages";
+}
 
 void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs) {
-  predicates_ = std::move(exprs);
+  predicates_ = make_shared<vector<unique_ptr<Expression>>>(std::move(exprs));
+
+  zone_filter_.reset();
+  RecordFileHandler *record_handler = table_->record_handler();
+  ZoneMap *zone_map = record_handler != nullptr ? record_handler->zone_map() : nullptr;
+  if (zone_map == nullptr) {
+    return;
+  }
+
+  vector<ZoneCondition> conditions;
+  for (unique_ptr<Expression> &expr : *predicates_) {
+    collect_zone_conditions(table_, expr.get(), conditions);
+  }
+  if (!conditions.empty()) {
+    zone_filter_ = make_shared<ZoneFilter>(zone_map, std::move(conditions));
+  }
+}
+
+void TableScanPhysicalOperator::set_projection(const vector<int> &field_indexes) {
+  // 事务字段用来判断记录是否可见，NULL 标记用来判断字段是否为 NULL，都在表元数据的最前面
+  projection_.clear();
+  for (int i = 0; i < table_->table_meta().sys_field_num(); i++) {
+    projection_.push_back(i);
+  }
+  projection_.insert(projection_.end(), field_indexes.begin(), field_indexes.end());
+}
+
+void TableScanPhysicalOperator::collect_zone_conditions(
+    Table *table, Expression *expr, vector<ZoneCondition> &conditions) {
+  RecordFileHandler *record_handler = table->record_handler();
+  ZoneMap *zone_map = record_handler != nullptr ? record_handler->zone_map() : nullptr;
+  if (zone_map == nullptr || expr == nullptr) {
+    return;
+  }
+
+  if (expr->type() == ExprType::CONJUNCTION) {
+    auto conjunction_expr = static_cast<ConjunctionExpr *>(expr);
+    if (conjunction_expr->conjunction_type() == ConjunctionType::AND) {
+      collect_zone_conditions(table, conjunction_expr->left().get(), conditions);
+      collect_zone_conditions(table, conjunction_expr->right().get(), conditions);
+    } else if (conjunction_expr->conjunction_type() == ConjunctionType::SINGLE) {
+      collect_zone_conditions(table, conjunction_expr->left().get(), conditions);
+    }
+    return;
+  }
+
+  if (expr->type() != ExprType::COMPARISON) {
+    return;
+  }
+
+  auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+  Expression *left = comparison_expr->left().get();
+  Expression *right = comparison_expr->right().get();
+  if (left == nullptr || right == nullptr) {
+    return;
+  }
+
+  const bool value_left = right->type() == ExprType::FIELD;
+  Expression *field_side = value_left ? right : left;
+  Expression *value_side = value_left ? left : right;
+  if (field_side->type() != ExprType::FIELD ||
+      (value_side->type() != ExprType::VALUE && value_side->type() != ExprType::CAST)) {
+    return;
+  }
+
+  const Field &field = static_cast<FieldExpr *>(field_side)->field();
+  if (field.table() != table) {
+    return;
+  }
+
+  const int column = zone_map->column_index(field.meta()->index());
+  Value value;
+  if (column < 0 || OB_FAIL(value_side->try_get_value(value))) {
+    return;
+  }
+
+  conditions.push_back(ZoneCondition{column, comparison_expr->comp(), value, value_left});
+}
+
+unique_ptr<TableScanPhysicalOperator> TableScanPhysicalOperator::fork() const {
+  auto oper = make_unique<TableScanPhysicalOperator>(table_, readonly_);
+  oper->predicates_ = predicates_;
+  oper->zone_filter_ = zone_filter_;
+  oper->projection_ = projection_;
+  return oper;
 }
 
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result) {
   RC rc = RC::SUCCESS;
+  if (!predicates_) {
+    result = true;
+    return rc;
+  }
+
   Value value;
-  for (unique_ptr<Expression> &expr : predicates_) {
+  for (const unique_ptr<Expression> &expr : *predicates_) {
     rc = expr->get_value(tuple, value);
     if (rc != RC::SUCCESS) {
       return rc;
@@ -39,15 +39,60 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 设置查询用到的字段，使用字段在表元数据中的下标(FieldMeta::index)
+   * @details 只读扫描 PAX 格式的表时只解码这些字段，事务字段和 NULL 标记总是会读取。
+   * 没有设置时读取所有字段
+   */
+  void set_projection(const std::vector<int> &field_indexes);
+
+  /**
+   * @brief 并行扫描时，从这里领取需要扫描的页面
+   */
+  void set_morsels(MorselDispenser *morsels) { morsels_ = morsels; }
+
+  /**
+   * @brief 创建一个扫描同一张表的算子，与当前算子共用过滤条件
+   * @details 并行扫描时每个线程使用一个扫描算子，过滤条件只会被读取，可以在多个线程间共用
+   */
+  std::unique_ptr<TableScanPhysicalOperator> fork() const;
+
+  /**
+   * @brief 当前通过过滤条件的记录，只读扫描时记录的数据在页面上，下次调用 next 之前有效
+   */
+  const Record &current_record() const { return current_record_; }
+
+  /**
+   * @brief 只读扫描时当前页面上的记录
+   */
+  const RecordBatch &record_batch() const { return record_batch_; }
+
+  /**
+   * @brief 从过滤条件中找出可以用区域映射判断的比较条件
+   * @details 只使用 AND 连接的 字段 比较 常量，字段要在区域映射中有统计
+   */
+  static void collect_zone_conditions(Table *table, Expression *expr, std::vector<ZoneCondition> &conditions);
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
+  /**
+   * @brief 只读扫描时按页面批量获取记录，记录不做拷贝
+   */
+  RC next_in_batch();
+
 private:
   Table *table_ = nullptr;
   Trx *trx_ = nullptr;
   bool readonly_ = false;
   RecordFileScanner record_scanner_;
+  RecordBatch record_batch_;   ///< 只读扫描时当前页面上的记录
+  int batch_index_ = -1;       ///< 当前记录在 record_batch_ 中的下标
+  MorselDispenser *morsels_ = nullptr; ///< 并行扫描时从这里领取页面
+  std::vector<int> projection_; ///< 需要读取的字段，包含系统字段，为空表示所有字段
   Record current_record_;
   RowTuple tuple_;
-  std::vector<std::unique_ptr<Expression>> predicates_; // TODO chang predicate to table tuple filter
+  // TODO chang predicate to table tuple filter
+  std::shared_ptr<std::vector<std::unique_ptr<Expression>>> predicates_;
+  std::shared_ptr<ZoneFilter> zone_filter_; ///< 用过滤条件生成，与 predicates_ 一起在并行扫描的算子间共用
 };
@@ -6,6 +6,7 @@
 #include "sql/expr/tuple.h"
 #include "sql/parser/value.h"
 #include "storage/default/default_handler.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -33,6 +34,23 @@ RC UpdatePhysicalOperator::open(Trx *trx) {
     }
   }
   trx_ = trx;
+
+  // 没有被更新的 TEXT 字段需要给新记录复制一份，每个 TEXT 只属于一条记录，旧记录删除时会释放它的 TEXT
+  vector<const FieldMeta *> kept_texts;
+  text_fields_.clear();
+  for (const FieldMeta &field : *table_->table_meta().field_metas()) {
+    if (field.type() != TEXTS) {
+      continue;
+    }
+    text_fields_.push_back(&field);
+    auto iter = std::find_if(units_.begin(), units_.end(),
+        [&field](const UpdateUnit &unit) { return 0 == strcmp(unit.field.meta()->name(), field.name()); });
+    if (iter == units_.end()) {
+      kept_texts.push_back(&field);
+    }
+  }
+
+  vector<vector<char>> new_records;
   while ((rc = children_[0]->next(nullptr)) == RC::SUCCESS) {
     // FIXME(zhaoyiping): 这里之后要统一改成接口
     Record *record;
@@ -42,17 +60,6 @@ RC UpdatePhysicalOperator::open(Trx *trx) {
       line_sql_debug("rc=%s", strrc(rc));
       return rc;
     }
-    vector<char> r(table_->table_meta().record_size());
-    memcpy(r.data(), record->data(), r.size());
-    rc = trx->delete_record(table_, *record);
-    if (rc != RC::SUCCESS) {
-      if (rc == RC::RECORD_DELETED)
-        continue;
-      rollback();
-      line_sql_debug("rc=%s", strrc(rc));
-      return rc;
-    }
-    deleted_records_.push_back(r);
     vector<Value> values;
     for (auto &unit : units_) {
       Value value;
@@ -62,8 +69,42 @@ RC UpdatePhysicalOperator::open(Trx *trx) {
         rollback();
         return rc;
       }
+      if (value.attr_type() == TEXTS) {
+        // 值可能引用了这条记录的 TEXT，记录删除之后就读不到了
+        value.set_text(value.get_string().c_str());
+      }
       values.push_back(value);
     }
+    vector<char> r(table_->table_meta().record_size());
+    memcpy(r.data(), record->data(), r.size());
+    vector<char> n = r;
+    rc = copy_texts(kept_texts, n);
+    if (rc != RC::SUCCESS) {
+      rollback();
+      line_sql_debug("rc=%s", strrc(rc));
+      return rc;
+    }
+    // 回滚时重新插入的旧记录也要有自己的 TEXT：删除之后旧记录的 TEXT 可能已经被释放并被新写入的 TEXT 复用，
+    // MVCC 下旧版本的 TEXT 会在清理时释放
+    rc = copy_texts(text_fields_, r);
+    if (rc != RC::SUCCESS) {
+      delete_texts(kept_texts, n);
+      rollback();
+      line_sql_debug("rc=%s", strrc(rc));
+      return rc;
+    }
+    rc = trx->delete_record(table_, *record);
+    if (rc != RC::SUCCESS) {
+      delete_texts(kept_texts, n);
+      delete_texts(text_fields_, r);
+      if (rc == RC::RECORD_DELETED)
+        continue;
+      rollback();
+      line_sql_debug("rc=%s", strrc(rc));
+      return rc;
+    }
+    deleted_records_.push_back(r);
+    new_records.push_back(std::move(n));
     value_list.push_back(values);
   }
   children_[0]->close();
@@ -73,7 +114,7 @@ RC UpdatePhysicalOperator::open(Trx *trx) {
   }
   for (int i = 0; i < deleted_records_.size(); i++) {
     RID rid;
-    rc = update(deleted_records_[i], value_list[i], rid);
+    rc = update(new_records[i], value_list[i], rid);
     if (rc != RC::SUCCESS) {
       line_sql_debug("rc=%s", strrc(rc));
       rollback();
@@ -81,6 +122,12 @@ RC UpdatePhysicalOperator::open(Trx *trx) {
     }
     inserted_records_.push_back(rid);
   }
+
+  // 更新成功，不会再回滚了
+  for (const vector<char> &r : deleted_records_) {
+    delete_texts(text_fields_, r);
+  }
+  deleted_records_.clear();
   return RC::SUCCESS;
 }
 
@@ -91,6 +138,7 @@ RC UpdatePhysicalOperator::insert_all(vector<vector<char>> &v) {
     RC rc = insert(x, rid);
     if (rc != RC::SUCCESS) {
       LOG_ERROR("fail to insert all");
+      delete_texts(text_fields_, x);
       if (rc_ret == RC::SUCCESS) {
         rc_ret = rc;
       }
@@ -143,21 +191,22 @@ RC UpdatePhysicalOperator::update(vector<char> v, vector<Value> &values, RID &ri
       return RC::INVALID_ARGUMENT;
     }
     const auto *meta = unit.field.meta();
-    if (value.attr_type() != meta->type()) {
+    if (meta->type() == TEXTS && value.attr_type() != NULLS) {
+      // 即使值来自另一个 TEXT 字段，也要写入一个新的 TEXT
+      int text_id;
+      rc = table_->add_text(value.get_string().c_str(), text_id);
+      if (rc != RC::SUCCESS) {
+        line_sql_debug("rc=%s", strrc(rc));
+        return rc;
+      }
+      value.set_int(text_id);
+    } else if (value.attr_type() != meta->type()) {
       if (value.attr_type() == NULLS) {
         if (!meta->nullable()) {
           line_sql_debug("rc=%s", strrc(RC::INVALID_ARGUMENT));
           LOG_WARN("field %s should not be null", meta->name());
           return RC::INVALID_ARGUMENT;
         }
-      } else if (meta->type() == TEXTS) {
-        int page_of;
-        rc = table_->add_text(value.get_string().c_str(), page_of);
-        if (rc != RC::SUCCESS) {
-          line_sql_debug("rc=%s", strrc(rc));
-          return rc;
-        }
-        value.set_int(page_of);
       } else if (!Value::convert(value.attr_type(), meta->type(), value)) {
         line_sql_debug("rc=%s", strrc(RC::INVALID_ARGUMENT));
         LOG_WARN("failed to convert update value");
@@ -184,7 +233,34 @@ RC UpdatePhysicalOperator::update(vector<char> v, vector<Value> &values, RID &ri
   return insert(v, rid);
 }
 
+RC UpdatePhysicalOperator::copy_texts(const vector<const FieldMeta *> &fields, vector<char> &v) {
+  const int null_value = *(int *)(v.data() + table_->table_meta().null_field_meta()->offset());
+  for (const FieldMeta *field : fields) {
+    if (null_value & (1 << field->index())) {
+      continue;
+    }
+    int &text_id = *(int *)(v.data() + field->offset());
+    RC rc = table_->copy_text(text_id, text_id);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to copy text. field=%s, rc=%s", field->name(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void UpdatePhysicalOperator::delete_texts(const vector<const FieldMeta *> &fields, const vector<char> &v) {
+  const int null_value = *(int *)(v.data() + table_->table_meta().null_field_meta()->offset());
+  for (const FieldMeta *field : fields) {
+    if (!(null_value & (1 << field->index()))) {
+      table_->delete_text(*(int *)(v.data() + field->offset()));
+    }
+  }
+}
+
 void UpdatePhysicalOperator::rollback() {
   remove_all(inserted_records_);
   insert_all(deleted_records_);
+  inserted_records_.clear();
+  deleted_records_.clear();
 }
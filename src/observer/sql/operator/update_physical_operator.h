@@ -18,6 +18,8 @@ private:
   RC insert_all(vector<vector<char>> &v);
   RC remove_all(const vector<RID> &rids);
   RC update(vector<char> v, vector<Value> &values, RID &rid);
+  RC copy_texts(const vector<const FieldMeta *> &fields, vector<char> &v);
+  void delete_texts(const vector<const FieldMeta *> &fields, const vector<char> &v);
 
   void rollback();
 
@@ -26,5 +28,6 @@ private:
   Table *table_;
   std::vector<std::vector<char>> deleted_records_;
   std::vector<RID> inserted_records_;
+  std::vector<const FieldMeta *> text_fields_;  ///< 表中所有的 TEXT 字段
   Trx *trx_;
 };
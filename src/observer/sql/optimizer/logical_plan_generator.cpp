@@ -347,6 +347,7 @@ RC LogicalPlanGenerator::create_plan(CreateTableStmt *create_table_stmt,
   }
   oper->table_name_ = create_table_stmt->table_name();
   oper->attr_infos_ = create_table_stmt->attr_infos();
+  oper->storage_format_ = create_table_stmt->storage_format();
   oper->db_ = create_table_stmt->db_;
   logical_operator.reset(oper);
   return rc;
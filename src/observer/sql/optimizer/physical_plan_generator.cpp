@@ -10,7 +10,10 @@ See the Mulan PSL v2 for more details. */
 
 
 #include <cstring>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -29,6 +32,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/delete_physical_operator.h"
 #include "sql/operator/explain_logical_operator.h"
 #include "sql/operator/explain_physical_operator.h"
+#include "sql/operator/gather_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/insert_physical_operator.h"
@@ -52,6 +56,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/view_get_logical_operator.h"
 #include "sql/optimizer/physical_plan_generator.h"
 #include "sql/parser/parse_defs.h"
+#include "session/session.h"
 #include "storage/index/index.h"
 
 using namespace std;
@@ -127,89 +132,331 @@ RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<P
   return rc;
 }
 
-RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper) {
-  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
-  // 看看是否有可以用于索引查找的表达式
-  Table *table = table_get_oper.table();
+int PhysicalPlanGenerator::table_parallel_degree(TableGetLogicalOperator &table_get_oper) {
+  Session *session = Session::current_session();
+  if (session == nullptr || session->parallel_degree() <= 1 || !table_get_oper.readonly()) {
+    return 1;
+  }
 
-  Index *index = nullptr;
-  std::vector<std::pair<Field, Value>> field_values;
-  for (auto &expr : predicates) {
-    if (expr->type() == ExprType::COMPARISON) {
-      ValueExpr *value_expr = nullptr;
-      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-      // 简单处理，就找等值查询
-      if (comparison_expr->comp() != EQUAL_TO) {
-        continue;
-      }
+  if (!GatherPhysicalOperator::can_parallelize(table_get_oper.predicates())) {
+    LOG_TRACE("predicates cannot be evaluated in parallel, use serial table scan");
+    return 1;
+  }
 
-      unique_ptr<Expression> &left_expr = comparison_expr->left();
-      unique_ptr<Expression> &right_expr = comparison_expr->right();
-      // 左右比较的一边最少是一个值
-      if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-        continue;
-      }
+#ifndef CONCURRENCY
+  // 没有开启并发编译选项时，缓冲池和页帧的锁什么都不做，不能在多个线程中同时扫描
+  LOG_WARN("parallel table scan requires CONCURRENCY, use serial table scan");
+  return 1;
+#endif
 
-      FieldExpr *field_expr = nullptr;
-      if (left_expr->type() == ExprType::FIELD) {
-        ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-        field_expr = static_cast<FieldExpr *>(left_expr.get());
-        value_expr = static_cast<ValueExpr *>(right_expr.get());
-      } else if (right_expr->type() == ExprType::FIELD) {
-        ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-        field_expr = static_cast<FieldExpr *>(right_expr.get());
-        value_expr = static_cast<ValueExpr *>(left_expr.get());
-      }
+  return session->parallel_degree();
+}
+
+bool PhysicalPlanGenerator::can_push_to_table_scan(TableGetLogicalOperator &table_get_oper, Expression &expr) {
+  // 只引用了这张表的字段，并且可以在多个线程中同时计算
+  for (const Field &field : expr.reference_fields()) {
+    if (field.table() != table_get_oper.table()) {
+      return false;
+    }
+  }
+  if (!GatherPhysicalOperator::can_parallelize(&expr)) {
+    return false;
+  }
+
+  if (table_parallel_degree(table_get_oper) > 1) {
+    return true;
+  }
+
+  map<string, IndexFieldRange> ranges;
+  collect_index_ranges(table_get_oper.table(), &expr, ranges);
+  IndexScanRange scan_range;
+  if (choose_index(table_get_oper.table(), ranges, scan_range) != nullptr) {
+    return true;
+  }
+
+  vector<ZoneCondition> zone_conditions;
+  TableScanPhysicalOperator::collect_zone_conditions(table_get_oper.table(), &expr, zone_conditions);
+  return !zone_conditions.empty();
+}
+
+void IndexFieldRange::add(CompOp op, const Value &value) {
+  switch (op) {
+  case EQUAL_TO: {
+    // 同一个字段上有两个不同的等值条件时结果为空，由过滤条件判断，这里只用第一个
+    if (!has_equal) {
+      has_equal = true;
+      equal = value;
+    }
+  } break;
+  case GREAT_EQUAL:
+  case GREAT_THAN: {
+    const bool inclusive = op == GREAT_EQUAL;
+    const int cmp = has_lower ? value.compare(lower) : 1;
+    if (cmp > 0 || (cmp == 0 && !inclusive)) {
+      has_lower = true;
+      lower = value;
+      lower_inclusive = inclusive;
+    }
+  } break;
+  case LESS_EQUAL:
+  case LESS_THAN: {
+    const bool inclusive = op == LESS_EQUAL;
+    const int cmp = has_upper ? value.compare(upper) : -1;
+    if (cmp < 0 || (cmp == 0 && !inclusive)) {
+      has_upper = true;
+      upper = value;
+      upper_inclusive = inclusive;
+    }
+  } break;
+  default: break;
+  }
+}
+
+bool IndexFieldRange::has_range() const {
+  if (!has_lower && !has_upper) {
+    return false;
+  }
+  if (has_lower && has_upper) {
+    // 空的范围不能打开索引扫描，交给过滤条件处理
+    const int cmp = lower.compare(upper);
+    return cmp < 0 || (cmp == 0 && lower_inclusive && upper_inclusive);
+  }
+  return true;
+}
+
+/**
+ * @brief 常量转换成字段类型之后，与字段的大小关系是否保持不变
+ */
+static bool index_value_of(const FieldMeta &field, const Value &value, Value &result) {
+  if (value.is_null()) {
+    return false;
+  }
+
+  result = value;
+  const AttrType from = value.attr_type();
+  const AttrType to = field.type();
+  if (from == to) {
+    // 超长的字符串截断之后会改变大小关系
+    return from != CHARS || value.length() <= field.len();
+  }
+  if ((from == INTS && to == FLOATS) || (from == CHARS && to == DATES)) {
+    return Value::convert(from, to, result);
+  }
+  // TEXT 字段的边界在索引扫描算子中写入 TEXT 文件
+  return from == CHARS && to == TEXTS;
+}
+
+void PhysicalPlanGenerator::collect_index_ranges(
+    Table *table, Expression *expr, map<string, IndexFieldRange> &ranges) {
+  if (expr == nullptr) {
+    return;
+  }
+
+  if (expr->type() == ExprType::CONJUNCTION) {
+    auto conjunction_expr = static_cast<ConjunctionExpr *>(expr);
+    if (conjunction_expr->conjunction_type() == ConjunctionType::AND) {
+      collect_index_ranges(table, conjunction_expr->left().get(), ranges);
+      collect_index_ranges(table, conjunction_expr->right().get(), ranges);
+    } else if (conjunction_expr->conjunction_type() == ConjunctionType::SINGLE) {
+      collect_index_ranges(table, conjunction_expr->left().get(), ranges);
+    }
+    return;
+  }
+
+  if (expr->type() != ExprType::COMPARISON) {
+    return;
+  }
+
+  auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+  Expression *left = comparison_expr->left().get();
+  Expression *right = comparison_expr->right().get();
+  if (left == nullptr || right == nullptr) {
+    return;
+  }
+
+  const bool value_left = right->type() == ExprType::FIELD;
+  Expression *field_side = value_left ? right : left;
+  Expression *value_side = value_left ? left : right;
+  if (field_side->type() != ExprType::FIELD ||
+      (value_side->type() != ExprType::VALUE && value_side->type() != ExprType::CAST)) {
+    return;
+  }
+
+  const Field &field = static_cast<FieldExpr *>(field_side)->field();
+  if (field.table() != table) {
+    return;
+  }
 
-      if (field_expr == nullptr) {
+  Value value;
+  Value index_value;
+  if (OB_FAIL(value_side->try_get_value(value)) || !index_value_of(*field.meta(), value, index_value)) {
+    return;
+  }
+
+  // 常量在左边时交换比较符两边，都转换成 字段 op 常量
+  CompOp op = comparison_expr->comp();
+  if (value_left) {
+    switch (op) {
+    case LESS_THAN: op = GREAT_THAN; break;
+    case LESS_EQUAL: op = GREAT_EQUAL; break;
+    case GREAT_THAN: op = LESS_THAN; break;
+    case GREAT_EQUAL: op = LESS_EQUAL; break;
+    default: break;
+    }
+  }
+  ranges[field.field_name()].add(op, index_value);
+}
+
+Index *PhysicalPlanGenerator::choose_index(
+    Table *table, const map<string, IndexFieldRange> &ranges, IndexScanRange &scan_range) {
+  if (ranges.empty()) {
+    return nullptr;
+  }
+
+  const TableMeta &table_meta = table->table_meta();
+  const IndexMeta *best_index = nullptr;
+  int best_equal_num = 0;
+  const IndexFieldRange *best_range = nullptr;
+  for (int i = 0; i < table_meta.index_num(); i++) {
+    const IndexMeta *index_meta = table_meta.index(i);
+    const vector<FieldMeta> &fields = index_meta->fields();
+
+    // 索引的第一个字段是 NULL 标记，从第二个字段开始匹配最左前缀
+    int equal_num = 0;
+    const IndexFieldRange *range = nullptr;
+    for (size_t j = 1; j < fields.size(); j++) {
+      auto iter = ranges.find(fields[j].name());
+      if (iter == ranges.end()) {
+        break;
+      }
+      if (iter->second.has_equal) {
+        equal_num++;
         continue;
       }
+      if (iter->second.has_range()) {
+        range = &iter->second;
+      }
+      break;
+    }
 
-      const Field &field = field_expr->field();
-      Value value;
-      ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
-      if (value_expr->try_get_value(value) != RC::SUCCESS)
-        continue;
-      field_values.push_back({field, value});
+    if (equal_num == 0 && range == nullptr) {
+      continue;
+    }
+    if (best_index == nullptr || equal_num > best_equal_num ||
+        (equal_num == best_equal_num && range != nullptr && best_range == nullptr)) {
+      best_index = index_meta;
+      best_equal_num = equal_num;
+      best_range = range;
     }
   }
-  // TODO(zhaoyiping)
-  // 这里要研究一下怎么确定用哪个索引
 
-  std::vector<const char *> fields;
-  for (auto &[f, value] : field_values) {
-    fields.push_back(f.field_name());
+  if (best_index == nullptr) {
+    return nullptr;
   }
-  index = table->find_index_by_fields(fields);
 
-  if (index != nullptr) {
-    // 构建value
-    std::vector<Value> values;
-    auto &index_meta = index->index_meta();
-    for (auto &field : index_meta.fields()) {
-      bool found = false;
-      for (auto &[f, value] : field_values) {
-        if (strcmp(f.field_name(), field.name()) == 0) {
-          found = true;
-          values.push_back(value);
-          break;
-        }
+  const vector<FieldMeta> &fields = best_index->fields();
+  for (int i = 1; i <= best_equal_num; i++) {
+    const Value &value = ranges.at(fields[i].name()).equal;
+    scan_range.left_values.push_back(value);
+    scan_range.right_values.push_back(value);
+  }
+  scan_range.left_inclusive = true;
+  scan_range.right_inclusive = true;
+  if (best_range != nullptr) {
+    if (best_range->has_lower) {
+      scan_range.left_values.push_back(best_range->lower);
+      scan_range.left_inclusive = best_range->lower_inclusive;
+    }
+    if (best_range->has_upper) {
+      scan_range.right_values.push_back(best_range->upper);
+      scan_range.right_inclusive = best_range->upper_inclusive;
+    }
+  }
+  return table->find_index(best_index->name());
+}
+
+/**
+ * @brief 查询用到的字段和过滤条件中的字段是否都在索引中，都在时可以只扫描索引
+ */
+static bool index_covers(const Index *index, TableGetLogicalOperator &table_get_oper) {
+  const IndexMeta &index_meta = index->index_meta();
+  for (const Field &field : table_get_oper.fields()) {
+    if (!index_meta.contains(field.field_name())) {
+      return false;
+    }
+  }
+  for (const unique_ptr<Expression> &expr : table_get_oper.predicates()) {
+    for (const Field &field : expr->reference_fields()) {
+      if (field.table() != table_get_oper.table() || !index_meta.contains(field.field_name())) {
+        return false;
       }
-      if (!found) {
-        break;
+    }
+  }
+  return true;
+}
+
+/**
+ * 查询中用到的这张表的字段：投影、过滤、分组、排序、聚合函数的参数等，以及下推到扫描算子的过滤条件
+ */
+static vector<int> used_field_indexes(TableGetLogicalOperator &table_get_oper) {
+  set<int> indexes;
+  for (const Field &field : table_get_oper.fields()) {
+    if (field.table() == table_get_oper.table()) {
+      indexes.insert(field.meta()->index());
+    }
+  }
+  for (const unique_ptr<Expression> &expr : table_get_oper.predicates()) {
+    for (const Field &field : expr->reference_fields()) {
+      if (field.table() == table_get_oper.table()) {
+        indexes.insert(field.meta()->index());
       }
     }
-    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(
-        table, index, table_get_oper.readonly(), values, true /*left_inclusive*/, values, true /*right_inclusive*/);
+  }
+  return vector<int>(indexes.begin(), indexes.end());
+}
+
+RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper) {
+  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
+  // 看看是否有可以用于索引查找的表达式，等值或者范围条件都可以
+  Table *table = table_get_oper.table();
+
+  map<string, IndexFieldRange> ranges;
+  for (auto &expr : predicates) {
+    collect_index_ranges(table, expr.get(), ranges);
+  }
+
+  IndexScanRange scan_range;
+  Index *index = choose_index(table, ranges, scan_range);
+
+  if (index != nullptr) {
+    // 所有的过滤条件都保留在索引扫描算子中，没有用到索引的条件在扫描时过滤
+    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table, index, table_get_oper.readonly(),
+        scan_range.left_values, scan_range.left_inclusive, scan_range.right_values, scan_range.right_inclusive);
+    // 修改数据时需要读取记录加锁，只有只读的查询才能只扫描索引
+    if (table_get_oper.readonly() && index_covers(index, table_get_oper)) {
+      index_scan_oper->set_index_only(true);
+    }
 
     index_scan_oper->set_predicates(std::move(predicates));
     oper = unique_ptr<PhysicalOperator>(index_scan_oper);
     LOG_TRACE("use index scan");
   } else {
+    const int parallel_degree = table_parallel_degree(table_get_oper);
     auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.readonly());
+    table_scan_oper->set_projection(used_field_indexes(table_get_oper));
     table_scan_oper->set_predicates(std::move(predicates));
     oper = unique_ptr<PhysicalOperator>(table_scan_oper);
-    LOG_TRACE("use table scan");
+    if (parallel_degree > 1) {
+      vector<unique_ptr<TableScanPhysicalOperator>> workers;
+      for (int i = 1; i < parallel_degree; i++) {
+        workers.push_back(table_scan_oper->fork());
+      }
+      workers.emplace_back(static_cast<TableScanPhysicalOperator *>(oper.release()));
+      oper = make_unique<GatherPhysicalOperator>(table, std::move(workers));
+      LOG_TRACE("use parallel table scan. parallel degree=%d", parallel_degree);
+    } else {
+      LOG_TRACE("use table scan");
+    }
   }
 
   return RC::SUCCESS;
@@ -221,6 +468,16 @@ RC PhysicalPlanGenerator::create_plan(PredicateLogicalOperator &pred_oper, uniqu
 
   LogicalOperator &child_oper = *children_opers.front();
 
+  vector<unique_ptr<Expression>> &expressions = pred_oper.expressions();
+  ASSERT(expressions.size() == 1, "predicate logical operator's children should be 1");
+
+  // 把过滤条件下推到表扫描中，并行扫描时由每个扫描线程自己过滤，也可以用区域映射跳过页面
+  if (child_oper.type() == LogicalOperatorType::TABLE_GET &&
+      can_push_to_table_scan(static_cast<TableGetLogicalOperator &>(child_oper), *expressions.front())) {
+    static_cast<TableGetLogicalOperator &>(child_oper).add_predicate(std::move(expressions.front()));
+    return create(child_oper, oper);
+  }
+
   unique_ptr<PhysicalOperator> child_phy_oper;
   RC rc = create(child_oper, child_phy_oper);
   if (rc != RC::SUCCESS) {
@@ -228,9 +485,6 @@ RC PhysicalPlanGenerator::create_plan(PredicateLogicalOperator &pred_oper, uniqu
     return rc;
   }
 
-  vector<unique_ptr<Expression>> &expressions = pred_oper.expressions();
-  ASSERT(expressions.size() == 1, "predicate logical operator's children should be 1");
-
   unique_ptr<Expression> expression = std::move(expressions.front());
   oper = unique_ptr<PhysicalOperator>(new PredicatePhysicalOperator(std::move(expression)));
   oper->add_child(std::move(child_phy_oper));
@@ -464,6 +718,7 @@ RC PhysicalPlanGenerator::create_plan(CreateTableLogicalOperator &logical_oper,
   op->schema_ = logical_oper.schema_;
   op->table_name_ = logical_oper.table_name_;
   op->attr_infos_ = logical_oper.attr_infos_;
+  op->storage_format_ = logical_oper.storage_format_;
   op->types_ = logical_oper.types_;
   return RC::SUCCESS;
 }
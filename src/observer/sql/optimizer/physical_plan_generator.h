@@ -12,12 +12,16 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "common/rc.h"
 #include "sql/operator/logical_operator.h"
 #include "sql/operator/physical_operator.h"
 
+class Expression;
 class TableGetLogicalOperator;
 class ViewGetLogicalOperator;
 class PredicateLogicalOperator;
@@ -34,6 +38,43 @@ class SubQueryLogicalOperator;
 class CachedLogicalOperator;
 class CreateTableLogicalOperator;
 class RenameLogicalOperator;
+class Table;
+class Index;
+class FieldMeta;
+
+/**
+ * @brief 一个字段上可以用于索引扫描的范围，由这个字段上的多个比较条件合并而成
+ * @ingroup PhysicalOperator
+ */
+struct IndexFieldRange {
+  bool has_equal = false;
+  Value equal;
+
+  bool has_lower = false;
+  Value lower;
+  bool lower_inclusive = false;
+
+  bool has_upper = false;
+  Value upper;
+  bool upper_inclusive = false;
+
+  void add(CompOp op, const Value &value);
+
+  /// 上下边界至少有一个，并且不是空的范围
+  bool has_range() const;
+};
+
+/**
+ * @brief 索引扫描的左右边界
+ * @ingroup PhysicalOperator
+ * @details 边界是索引前几个字段的值，字段比索引少时按照最左前缀扫描。空表示没有这一侧的边界
+ */
+struct IndexScanRange {
+  std::vector<Value> left_values;
+  bool left_inclusive = true;
+  std::vector<Value> right_values;
+  bool right_inclusive = true;
+};
 
 /**
  * @brief 物理计划生成器
@@ -65,4 +106,30 @@ private:
   RC create_plan(UpdateLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(CreateTableLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(RenameLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+
+  /**
+   * @brief 全表扫描使用几个线程，由会话变量 parallel_degree 决定
+   * @details 只有只读扫描，并且过滤条件可以在多个线程中同时计算时才会并行
+   */
+  int table_parallel_degree(TableGetLogicalOperator &logical_oper);
+
+  /**
+   * @brief 过滤条件是否可以下推到表扫描中执行
+   * @details 当前没有开启谓词下推的改写规则，只在使用并行扫描、可以用索引扫描，或者可以用区域映射跳过页面时才下推
+   */
+  bool can_push_to_table_scan(TableGetLogicalOperator &logical_oper, Expression &expr);
+
+  /**
+   * @brief 从 AND 连接的比较条件中收集每个字段上的范围
+   * @details 只收集 字段 op 常量 的比较条件，常量可以转换成字段类型并且不会改变大小关系
+   */
+  void collect_index_ranges(Table *table, Expression *expr, std::map<std::string, IndexFieldRange> &ranges);
+
+  /**
+   * @brief 选择一个可以用过滤条件扫描的索引
+   * @details 索引的前几个字段是等值条件，下一个字段是范围条件时可以使用。等值字段多的优先，
+   * 其次是有范围条件的。过滤条件都保留在索引扫描算子中，边界只用来缩小扫描的范围
+   * @return 没有可以使用的索引时返回 nullptr
+   */
+  Index *choose_index(Table *table, const std::map<std::string, IndexFieldRange> &ranges, IndexScanRange &scan_range);
 };
@@ -442,6 +442,7 @@ struct AttrInfoSqlNode {
 struct CreateTableSqlNode {
   std::string relation_name;               ///< Relation name
   std::vector<AttrInfoSqlNode> attr_infos; ///< attributes
+  std::string storage_format;              ///< 表选项 storage_format = fixed|slotted，为空时使用定长格式
   ParsedSqlNode *select = nullptr;
   ~CreateTableSqlNode();
 };
@@ -472,6 +473,7 @@ struct CreateIndexSqlNode {
   std::string index_name;                   ///< Index name
   std::string relation_name;                ///< Relation name
   std::vector<std::string> attribute_names; ///< Attribute name
+  std::vector<std::string> include_names;   ///< INCLUDE 中的字段，只存放在索引中，不参与比较
   bool unique;                              ///< unique
 };
 
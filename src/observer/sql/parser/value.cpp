@@ -80,6 +80,7 @@ Value::Value(Date date) { set_date(date); }
 Value::Value(ValueListMap &list) { set_list(list); }
 
 void Value::set_data(char *data, int length) {
+  text_loader_ = nullptr;
   switch (attr_type()) {
   case CHARS: {
     set_string(data, length);
@@ -110,6 +111,7 @@ void Value::set_data(char *data, int length) {
   }
 }
 void Value::set_int(int val) {
+  text_loader_ = nullptr;
   attr_type_ = INTS;
   num_value_.int_value_ = val;
   length_ = sizeof(val);
@@ -117,16 +119,19 @@ void Value::set_int(int val) {
 }
 
 void Value::set_float(float val) {
+  text_loader_ = nullptr;
   attr_type_ = FLOATS;
   num_value_.float_value_ = val;
   length_ = sizeof(val);
 }
 void Value::set_boolean(bool val) {
+  text_loader_ = nullptr;
   attr_type_ = BOOLEANS;
   num_value_.bool_value_ = val;
   length_ = sizeof(val);
 }
 void Value::set_string(const char *s, int len /*= 0*/) {
+  text_loader_ = nullptr;
   attr_type_ = CHARS;
   if (len > 0) {
     len = strnlen(s, len);
@@ -137,17 +142,20 @@ void Value::set_string(const char *s, int len /*= 0*/) {
   length_ = str_value_.length();
 }
 void Value::set_date(Date date) {
+  text_loader_ = nullptr;
   attr_type_ = DATES;
   num_value_.date_value_ = date;
   length_ = sizeof(date);
 }
 
 void Value::set_null() {
+  text_loader_ = nullptr;
   attr_type_ = NULLS;
   length_ = 1;
 }
 
 void Value::set_list(const ValueListMap &list) {
+  text_loader_ = nullptr;
   attr_type_ = LISTS;
   list_value_ = std::make_shared<ValueListMap>(list);
   bool has_null = false;
@@ -161,11 +169,29 @@ void Value::set_list(const ValueListMap &list) {
 }
 
 void Value::set_text(const char *s) {
-  std::string tmp;
   attr_type_ = TEXTS;
-  tmp.resize(TEXT_SIZE, 0);
-  strncpy(&tmp[0], s, TEXT_SIZE);
-  str_value_.swap(tmp);
+  text_loader_ = nullptr;
+  str_value_.assign(s, strnlen(s, TEXT_SIZE));
+  length_ = str_value_.length();
+}
+
+void Value::set_text_ref(const TextLoader *loader, int32_t text_id) {
+  attr_type_ = TEXTS;
+  text_loader_ = loader;
+  num_value_.int_value_ = text_id;
+  str_value_.clear();
+  length_ = 0;
+}
+
+void Value::fetch_text() const {
+  const TextLoader *loader = text_loader_;
+  text_loader_ = nullptr;
+  RC rc = loader->load_text(num_value_.int_value_, str_value_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to load text. text id=%d, rc=%s", num_value_.int_value_, strrc(rc));
+    str_value_.clear();
+  }
+  length_ = str_value_.length();
 }
 
 void Value::set_value(const Value &value) {
@@ -197,7 +223,11 @@ void Value::set_value(const Value &value) {
     set_list(*value.get_list());
   } break;
   case TEXTS: {
-    set_text(value.get_string().c_str());
+    if (value.text_loader_ != nullptr) {
+      set_text_ref(value.text_loader_, value.num_value_.int_value_);
+    } else {
+      set_text(value.str_value_.c_str());
+    }
   } break;
   }
 }
@@ -206,6 +236,7 @@ const char *Value::data() const {
   switch (attr_type()) {
   case TEXTS:
   case CHARS: {
+    load_text();
     return str_value_.c_str();
   } break;
   default: {
@@ -228,6 +259,7 @@ std::string Value::to_string() const {
   } break;
   case TEXTS:
   case CHARS: {
+    load_text();
     os << str_value_.c_str();
   } break;
   case DATES: {
@@ -277,6 +309,8 @@ int compare_by_ordering(std::weak_ordering order) {
 }
 
 int Value::compare(const Value &other) const {
+  load_text();
+  other.load_text();
   if (this->attr_type() == other.attr_type()) {
     switch (this->attr_type_) {
     case INTS: {
@@ -354,6 +388,7 @@ int Value::get_int() const {
   switch (attr_type()) {
   case TEXTS:
   case CHARS: {
+    load_text();
     try {
       return (int)(std::stol(str_value_));
     } catch (std::exception const &ex) {
@@ -383,6 +418,7 @@ float Value::get_float() const {
   switch (attr_type()) {
   case TEXTS:
   case CHARS: {
+    load_text();
     try {
       return std::stof(str_value_);
     } catch (std::exception const &ex) {
@@ -414,6 +450,7 @@ bool Value::get_boolean() const {
   switch (attr_type()) {
   case TEXTS:
   case CHARS: {
+    load_text();
     try {
       float val = std::stof(str_value_);
       if (val >= EPSILON || val <= -EPSILON) {
@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/rc.h"
 #include "sql/parser/date.h"
 #include <compare>
 #include <limits>
@@ -46,6 +47,18 @@ AttrType attr_type_from_string(const char *s);
 class ValueList;
 class ValueComparator;
 
+/**
+ * @brief 读取存放在记录之外的 TEXT 数据
+ * @details 记录中的 TEXT 字段只保存一个编号，内容存放在单独的文件中。
+ * 从记录中取出的 TEXT 值只记下编号和这个接口，第一次用到字符串时才读取
+ */
+class TextLoader {
+public:
+  virtual ~TextLoader() = default;
+
+  virtual RC load_text(int32_t text_id, std::string &text) const = 0;
+};
+
 using ValueListMap = std::map<ValueList, int, ValueComparator>;
 
 /**
@@ -81,12 +94,21 @@ public:
   void set_list(const ValueListMap &list);
   void set_text(const char *s);
 
+  /**
+   * @brief 设置为延迟读取的 TEXT，用到字符串时再通过 loader 读取
+   * @details loader 的生命周期要比这个值长
+   */
+  void set_text_ref(const TextLoader *loader, int32_t text_id);
+
   std::string to_string() const;
 
   int compare(const Value &other) const;
 
   const char *data() const;
-  int length() const { return length_; }
+  int length() const {
+    load_text();
+    return length_;
+  }
 
   AttrType attr_type() const { return attr_type_; }
 
@@ -114,9 +136,17 @@ public:
 
   static bool check_value(const Value &v);
 
+private:
+  void load_text() const {
+    if (text_loader_ != nullptr) {
+      fetch_text();
+    }
+  }
+  void fetch_text() const;
+
 private:
   AttrType attr_type_ = UNDEFINED;
-  int length_ = 0;
+  mutable int length_ = 0;
 
   union {
     int int_value_;
@@ -124,8 +154,11 @@ private:
     bool bool_value_;
     Date date_value_;
   } num_value_;
-  std::string str_value_;
+  mutable std::string str_value_;
   std::shared_ptr<ValueListMap> list_value_;
+
+  /// 不为空时是还没有读取的 TEXT，编号在 int_value_ 中
+  mutable const TextLoader *text_loader_ = nullptr;
 };
 
 class ValueComparator {
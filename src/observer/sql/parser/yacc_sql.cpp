@@ -239,69 +239,71 @@ enum yysymbol_kind_t
   YYSYMBOL_desc_table_stmt = 94,           /* desc_table_stmt  */
   YYSYMBOL_show_index_stmt = 95,           /* show_index_stmt  */
   YYSYMBOL_create_index_stmt = 96,         /* create_index_stmt  */
-  YYSYMBOL_unique = 97,                    /* unique  */
-  YYSYMBOL_ids = 98,                       /* ids  */
-  YYSYMBOL_drop_index_stmt = 99,           /* drop_index_stmt  */
-  YYSYMBOL_create_table_stmt = 100,        /* create_table_stmt  */
-  YYSYMBOL_create_view_stmt = 101,         /* create_view_stmt  */
-  YYSYMBOL_brace_id_list = 102,            /* brace_id_list  */
-  YYSYMBOL_attr_list = 103,                /* attr_list  */
-  YYSYMBOL_as_select = 104,                /* as_select  */
-  YYSYMBOL_attr_def_list = 105,            /* attr_def_list  */
-  YYSYMBOL_attr_def = 106,                 /* attr_def  */
-  YYSYMBOL_null_def = 107,                 /* null_def  */
-  YYSYMBOL_number = 108,                   /* number  */
-  YYSYMBOL_type = 109,                     /* type  */
-  YYSYMBOL_insert_stmt = 110,              /* insert_stmt  */
-  YYSYMBOL_record_list = 111,              /* record_list  */
-  YYSYMBOL_record = 112,                   /* record  */
-  YYSYMBOL_value = 113,                    /* value  */
-  YYSYMBOL_value_expr = 114,               /* value_expr  */
-  YYSYMBOL_delete_stmt = 115,              /* delete_stmt  */
-  YYSYMBOL_update_stmt = 116,              /* update_stmt  */
-  YYSYMBOL_update_set_list = 117,          /* update_set_list  */
-  YYSYMBOL_update_set = 118,               /* update_set  */
-  YYSYMBOL_select_stmt = 119,              /* select_stmt  */
-  YYSYMBOL_from = 120,                     /* from  */
-  YYSYMBOL_joined_tables = 121,            /* joined_tables  */
-  YYSYMBOL_joined_tables_inner = 122,      /* joined_tables_inner  */
-  YYSYMBOL_joined_on = 123,                /* joined_on  */
-  YYSYMBOL_having = 124,                   /* having  */
-  YYSYMBOL_groupby = 125,                  /* groupby  */
-  YYSYMBOL_orderby = 126,                  /* orderby  */
-  YYSYMBOL_order_unit_list = 127,          /* order_unit_list  */
-  YYSYMBOL_order_unit = 128,               /* order_unit  */
-  YYSYMBOL_order = 129,                    /* order  */
-  YYSYMBOL_rel_attr_list = 130,            /* rel_attr_list  */
-  YYSYMBOL_calc_stmt = 131,                /* calc_stmt  */
-  YYSYMBOL_expression_list = 132,          /* expression_list  */
-  YYSYMBOL_expression_list_empty = 133,    /* expression_list_empty  */
-  YYSYMBOL_expression = 134,               /* expression  */
-  YYSYMBOL_select_attr_list = 135,         /* select_attr_list  */
-  YYSYMBOL_select_attr = 136,              /* select_attr  */
-  YYSYMBOL_as_info = 137,                  /* as_info  */
-  YYSYMBOL_list_expr = 138,                /* list_expr  */
-  YYSYMBOL_set_expr = 139,                 /* set_expr  */
-  YYSYMBOL_rel_attr = 140,                 /* rel_attr  */
-  YYSYMBOL_rel_list = 141,                 /* rel_list  */
-  YYSYMBOL_where = 142,                    /* where  */
-  YYSYMBOL_conjunction = 143,              /* conjunction  */
-  YYSYMBOL_null_check = 144,               /* null_check  */
-  YYSYMBOL_condition = 145,                /* condition  */
-  YYSYMBOL_contain = 146,                  /* contain  */
-  YYSYMBOL_exists = 147,                   /* exists  */
-  YYSYMBOL_exists_op = 148,                /* exists_op  */
-  YYSYMBOL_comp_op = 149,                  /* comp_op  */
-  YYSYMBOL_contain_op = 150,               /* contain_op  */
-  YYSYMBOL_like_op = 151,                  /* like_op  */
-  YYSYMBOL_aggr_op = 152,                  /* aggr_op  */
-  YYSYMBOL_func_op = 153,                  /* func_op  */
-  YYSYMBOL_load_data_stmt = 154,           /* load_data_stmt  */
-  YYSYMBOL_explain_stmt = 155,             /* explain_stmt  */
-  YYSYMBOL_set_variable_stmt = 156,        /* set_variable_stmt  */
-  YYSYMBOL_opt_semicolon = 157,            /* opt_semicolon  */
-  YYSYMBOL_id = 158,                       /* id  */
-  YYSYMBOL_non_reserve = 159               /* non_reserve  */
+  YYSYMBOL_index_include = 97,             /* index_include  */
+  YYSYMBOL_unique = 98,                    /* unique  */
+  YYSYMBOL_ids = 99,                       /* ids  */
+  YYSYMBOL_drop_index_stmt = 100,          /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 101,        /* create_table_stmt  */
+  YYSYMBOL_storage_format = 102,           /* storage_format  */
+  YYSYMBOL_create_view_stmt = 103,         /* create_view_stmt  */
+  YYSYMBOL_brace_id_list = 104,            /* brace_id_list  */
+  YYSYMBOL_attr_list = 105,                /* attr_list  */
+  YYSYMBOL_as_select = 106,                /* as_select  */
+  YYSYMBOL_attr_def_list = 107,            /* attr_def_list  */
+  YYSYMBOL_attr_def = 108,                 /* attr_def  */
+  YYSYMBOL_null_def = 109,                 /* null_def  */
+  YYSYMBOL_number = 110,                   /* number  */
+  YYSYMBOL_type = 111,                     /* type  */
+  YYSYMBOL_insert_stmt = 112,              /* insert_stmt  */
+  YYSYMBOL_record_list = 113,              /* record_list  */
+  YYSYMBOL_record = 114,                   /* record  */
+  YYSYMBOL_value = 115,                    /* value  */
+  YYSYMBOL_value_expr = 116,               /* value_expr  */
+  YYSYMBOL_delete_stmt = 117,              /* delete_stmt  */
+  YYSYMBOL_update_stmt = 118,              /* update_stmt  */
+  YYSYMBOL_update_set_list = 119,          /* update_set_list  */
+  YYSYMBOL_update_set = 120,               /* update_set  */
+  YYSYMBOL_select_stmt = 121,              /* select_stmt  */
+  YYSYMBOL_from = 122,                     /* from  */
+  YYSYMBOL_joined_tables = 123,            /* joined_tables  */
+  YYSYMBOL_joined_tables_inner = 124,      /* joined_tables_inner  */
+  YYSYMBOL_joined_on = 125,                /* joined_on  */
+  YYSYMBOL_having = 126,                   /* having  */
+  YYSYMBOL_groupby = 127,                  /* groupby  */
+  YYSYMBOL_orderby = 128,                  /* orderby  */
+  YYSYMBOL_order_unit_list = 129,          /* order_unit_list  */
+  YYSYMBOL_order_unit = 130,               /* order_unit  */
+  YYSYMBOL_order = 131,                    /* order  */
+  YYSYMBOL_rel_attr_list = 132,            /* rel_attr_list  */
+  YYSYMBOL_calc_stmt = 133,                /* calc_stmt  */
+  YYSYMBOL_expression_list = 134,          /* expression_list  */
+  YYSYMBOL_expression_list_empty = 135,    /* expression_list_empty  */
+  YYSYMBOL_expression = 136,               /* expression  */
+  YYSYMBOL_select_attr_list = 137,         /* select_attr_list  */
+  YYSYMBOL_select_attr = 138,              /* select_attr  */
+  YYSYMBOL_as_info = 139,                  /* as_info  */
+  YYSYMBOL_list_expr = 140,                /* list_expr  */
+  YYSYMBOL_set_expr = 141,                 /* set_expr  */
+  YYSYMBOL_rel_attr = 142,                 /* rel_attr  */
+  YYSYMBOL_rel_list = 143,                 /* rel_list  */
+  YYSYMBOL_where = 144,                    /* where  */
+  YYSYMBOL_conjunction = 145,              /* conjunction  */
+  YYSYMBOL_null_check = 146,               /* null_check  */
+  YYSYMBOL_condition = 147,                /* condition  */
+  YYSYMBOL_contain = 148,                  /* contain  */
+  YYSYMBOL_exists = 149,                   /* exists  */
+  YYSYMBOL_exists_op = 150,                /* exists_op  */
+  YYSYMBOL_comp_op = 151,                  /* comp_op  */
+  YYSYMBOL_contain_op = 152,               /* contain_op  */
+  YYSYMBOL_like_op = 153,                  /* like_op  */
+  YYSYMBOL_aggr_op = 154,                  /* aggr_op  */
+  YYSYMBOL_func_op = 155,                  /* func_op  */
+  YYSYMBOL_load_data_stmt = 156,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 157,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 158,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 159,            /* opt_semicolon  */
+  YYSYMBOL_id = 160,                       /* id  */
+  YYSYMBOL_non_reserve = 161               /* non_reserve  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -632,16 +634,16 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  97
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   441
+#define YYLAST   460
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  83
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  77
+#define YYNNTS  79
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  181
+#define YYNRULES  185
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  295
+#define YYNSTATES  305
 
 /* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   333
@@ -698,25 +700,25 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   261,   261,   269,   270,   271,   272,   273,   274,   275,
-     276,   277,   278,   279,   280,   281,   282,   283,   284,   285,
-     286,   287,   288,   289,   290,   294,   300,   305,   311,   317,
-     323,   329,   338,   344,   354,   364,   383,   386,   391,   394,
-     401,   414,   430,   446,   449,   461,   464,   475,   478,   481,
-     487,   490,   503,   512,   524,   527,   530,   533,   538,   542,
-     543,   544,   545,   546,   550,   572,   575,   586,   597,   601,
-     605,   610,   617,   624,   636,   650,   654,   660,   668,   697,
-     700,   703,   709,   720,   725,   736,   741,   744,   750,   753,
-     764,   767,   773,   778,   785,   792,   795,   798,   803,   806,
-     816,   828,   833,   845,   848,   853,   856,   859,   862,   865,
-     869,   872,   875,   879,   883,   892,   899,   904,   912,   915,
-     922,   930,   933,   936,   941,   949,   958,   963,   970,   980,
-     987,   999,  1002,  1008,  1011,  1014,  1017,  1021,  1024,  1027,
-    1030,  1036,  1039,  1044,  1050,  1056,  1061,  1064,  1069,  1070,
-    1071,  1072,  1073,  1074,  1078,  1079,  1082,  1083,  1086,  1087,
-    1088,  1089,  1090,  1093,  1094,  1095,  1098,  1113,  1122,  1134,
-    1135,  1139,  1142,  1147,  1150,  1153,  1156,  1159,  1162,  1165,
-    1168,  1171
+       0,   263,   263,   271,   272,   273,   274,   275,   276,   277,
+     278,   279,   280,   281,   282,   283,   284,   285,   286,   287,
+     288,   289,   290,   291,   292,   296,   302,   307,   313,   319,
+     325,   331,   340,   346,   356,   366,   390,   393,   412,   415,
+     420,   423,   430,   443,   464,   467,   482,   498,   501,   513,
+     516,   527,   530,   533,   539,   542,   555,   564,   576,   579,
+     582,   585,   590,   594,   595,   596,   597,   598,   602,   624,
+     627,   638,   649,   653,   657,   662,   669,   676,   688,   702,
+     706,   712,   720,   749,   752,   755,   761,   772,   777,   788,
+     793,   796,   802,   805,   816,   819,   825,   830,   837,   844,
+     847,   850,   855,   858,   868,   880,   885,   897,   900,   905,
+     908,   911,   914,   917,   921,   924,   927,   931,   935,   944,
+     951,   956,   964,   967,   974,   982,   985,   988,   993,  1001,
+    1010,  1015,  1022,  1032,  1039,  1051,  1054,  1060,  1063,  1066,
+    1069,  1073,  1076,  1079,  1082,  1088,  1091,  1096,  1102,  1108,
+    1113,  1116,  1121,  1122,  1123,  1124,  1125,  1126,  1130,  1131,
+    1134,  1135,  1138,  1139,  1140,  1141,  1142,  1145,  1146,  1147,
+    1150,  1165,  1174,  1186,  1187,  1191,  1194,  1199,  1202,  1205,
+    1208,  1211,  1214,  1217,  1220,  1223
 };
 #endif
 
@@ -745,20 +747,21 @@ static const char *const yytname[] =
   "'+'", "'-'", "'*'", "'/'", "UMINUS", "$accept", "commands",
   "command_wrapper", "exit_stmt", "help_stmt", "sync_stmt", "begin_stmt",
   "commit_stmt", "rollback_stmt", "drop_table_stmt", "show_tables_stmt",
-  "desc_table_stmt", "show_index_stmt", "create_index_stmt", "unique",
-  "ids", "drop_index_stmt", "create_table_stmt", "create_view_stmt",
-  "brace_id_list", "attr_list", "as_select", "attr_def_list", "attr_def",
-  "null_def", "number", "type", "insert_stmt", "record_list", "record",
-  "value", "value_expr", "delete_stmt", "update_stmt", "update_set_list",
-  "update_set", "select_stmt", "from", "joined_tables",
-  "joined_tables_inner", "joined_on", "having", "groupby", "orderby",
-  "order_unit_list", "order_unit", "order", "rel_attr_list", "calc_stmt",
-  "expression_list", "expression_list_empty", "expression",
-  "select_attr_list", "select_attr", "as_info", "list_expr", "set_expr",
-  "rel_attr", "rel_list", "where", "conjunction", "null_check",
-  "condition", "contain", "exists", "exists_op", "comp_op", "contain_op",
-  "like_op", "aggr_op", "func_op", "load_data_stmt", "explain_stmt",
-  "set_variable_stmt", "opt_semicolon", "id", "non_reserve", YY_NULLPTR
+  "desc_table_stmt", "show_index_stmt", "create_index_stmt",
+  "index_include", "unique", "ids", "drop_index_stmt", "create_table_stmt",
+  "storage_format", "create_view_stmt", "brace_id_list", "attr_list",
+  "as_select", "attr_def_list", "attr_def", "null_def", "number", "type",
+  "insert_stmt", "record_list", "record", "value", "value_expr",
+  "delete_stmt", "update_stmt", "update_set_list", "update_set",
+  "select_stmt", "from", "joined_tables", "joined_tables_inner",
+  "joined_on", "having", "groupby", "orderby", "order_unit_list",
+  "order_unit", "order", "rel_attr_list", "calc_stmt", "expression_list",
+  "expression_list_empty", "expression", "select_attr_list", "select_attr",
+  "as_info", "list_expr", "set_expr", "rel_attr", "rel_list", "where",
+  "conjunction", "null_check", "condition", "contain", "exists",
+  "exists_op", "comp_op", "contain_op", "like_op", "aggr_op", "func_op",
+  "load_data_stmt", "explain_stmt", "set_variable_stmt", "opt_semicolon",
+  "id", "non_reserve", YY_NULLPTR
 };
 
 static const char *
@@ -768,12 +771,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-234)
+#define YYPACT_NINF (-207)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-163)
+#define YYTABLE_NINF (-167)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -782,36 +785,37 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     372,    -3,    18,   284,   284,   105,     5,  -234,     9,    15,
-     105,  -234,  -234,  -234,  -234,  -234,   105,    -5,   372,    37,
-      49,  -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,
-    -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,
-    -234,  -234,  -234,   105,  -234,   105,    56,   105,   105,  -234,
-     247,  -234,  -234,    52,    53,    54,    58,    63,  -234,  -234,
-    -234,  -234,  -234,  -234,  -234,  -234,  -234,   284,  -234,  -234,
-    -234,  -234,   -13,  -234,  -234,  -234,    68,    70,    59,  -234,
-       4,    55,    73,  -234,  -234,  -234,  -234,  -234,  -234,  -234,
-      60,   105,   105,    62,    67,    72,  -234,  -234,  -234,  -234,
-      79,    93,   105,  -234,    76,   102,    84,  -234,   284,   284,
-     284,   284,   284,   284,   284,    91,   105,  -234,  -234,   105,
-      89,   284,   105,    93,    89,   105,   -46,    50,   105,     7,
-     105,    61,    97,   105,  -234,  -234,   284,  -234,   -49,   -49,
-    -234,  -234,  -234,   110,   119,  -234,  -234,  -234,  -234,    74,
-     126,   160,   187,    85,  -234,  -234,   114,  -234,    89,   129,
-     107,  -234,   120,   133,   158,   148,  -234,  -234,   141,   148,
-     105,  -234,   149,  -234,  -234,   106,   105,  -234,   109,  -234,
-     360,   -15,  -234,  -234,  -234,   284,   116,   115,   159,  -234,
-     105,   284,   172,   105,   169,  -234,  -234,  -234,  -234,  -234,
-      32,  -234,   105,   173,  -234,   161,  -234,   105,   321,  -234,
-    -234,  -234,  -234,  -234,  -234,  -234,   -25,  -234,  -234,   -39,
-    -234,   284,   284,   123,   187,   187,   117,   105,   187,   136,
-     284,   181,  -234,   117,   105,   133,  -234,   130,   138,  -234,
-    -234,  -234,   141,  -234,   105,   321,  -234,  -234,  -234,   146,
-    -234,   117,   117,  -234,  -234,   168,   195,   -15,   163,  -234,
-     204,   159,  -234,  -234,  -234,  -234,   206,  -234,  -234,   141,
-     188,  -234,   105,  -234,   105,  -234,   181,   -30,   209,   187,
-     170,   195,  -234,   210,     3,  -234,  -234,  -234,   -15,  -234,
-     105,  -234,  -234,  -234,  -234
+     391,     4,    31,   277,   277,   341,    45,  -207,   -23,    34,
+     341,  -207,  -207,  -207,  -207,  -207,   341,     7,   391,    70,
+      80,  -207,  -207,  -207,  -207,  -207,  -207,  -207,  -207,  -207,
+    -207,  -207,  -207,  -207,  -207,  -207,  -207,  -207,  -207,  -207,
+    -207,  -207,  -207,   341,  -207,   341,    95,   341,   341,  -207,
+     240,  -207,  -207,    86,    87,    90,    94,   100,  -207,  -207,
+    -207,  -207,  -207,  -207,  -207,  -207,  -207,   277,  -207,  -207,
+    -207,  -207,    75,  -207,  -207,  -207,   104,   109,    82,  -207,
+     140,    92,   110,  -207,  -207,  -207,  -207,  -207,  -207,  -207,
+     102,   341,   341,   103,    96,    88,  -207,  -207,  -207,  -207,
+     123,   124,   341,  -207,   106,   126,    13,  -207,   277,   277,
+     277,   277,   277,   277,   277,   108,   341,  -207,  -207,   341,
+     114,   277,   341,   124,   114,   341,   -46,    74,   341,   341,
+     341,    81,   125,   341,  -207,  -207,   277,  -207,    18,    18,
+    -207,  -207,  -207,   143,   146,  -207,  -207,  -207,  -207,   105,
+     148,   188,     5,   112,  -207,  -207,   138,  -207,   114,   152,
+     130,  -207,   144,   155,    -9,    -4,   135,   159,   170,   341,
+    -207,   163,  -207,  -207,   122,   341,  -207,   120,  -207,   379,
+     -28,  -207,  -207,  -207,   277,   141,   136,   178,  -207,   341,
+     277,   194,   341,   182,  -207,  -207,  -207,  -207,  -207,    32,
+     170,  -207,  -207,   341,   341,   183,  -207,   185,  -207,   341,
+     314,  -207,  -207,  -207,  -207,  -207,  -207,  -207,   -21,  -207,
+    -207,   -39,  -207,   277,   277,   131,     5,     5,   -19,   341,
+       5,   153,   277,   190,  -207,   -19,   341,   155,  -207,   149,
+     145,  -207,  -207,  -207,  -207,  -207,   159,  -207,   341,   314,
+    -207,  -207,  -207,   156,  -207,   -19,   -19,  -207,  -207,   180,
+     203,   -28,   158,  -207,   206,   178,  -207,  -207,  -207,  -207,
+     207,  -207,  -207,   159,   189,  -207,   341,  -207,   341,  -207,
+     190,   -33,   210,     5,   168,   203,  -207,   212,    -6,  -207,
+    -207,   341,   -28,  -207,   341,  -207,  -207,  -207,  -207,   215,
+    -207,   341,   159,   216,  -207
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -819,62 +823,63 @@ static const yytype_int16 yypact[] =
    means the default is an error.  */
 static const yytype_uint8 yydefact[] =
 {
-       0,    36,     0,     0,     0,     0,     0,    27,     0,     0,
+       0,    38,     0,     0,     0,     0,     0,    27,     0,     0,
        0,    28,    29,    30,    26,    25,     0,     0,     0,     0,
-     169,    24,    23,    16,    17,    18,    19,    10,    11,    13,
+     173,    24,    23,    16,    17,    18,    19,    10,    11,    13,
       12,    14,    15,     8,     9,     5,     7,     6,     4,     3,
-      20,    21,    22,     0,    37,     0,     0,     0,     0,   173,
-       0,   174,   175,   176,   177,   178,   179,   180,   163,   164,
-     165,    71,   181,    68,    69,   172,    70,     0,   111,    72,
-     113,   100,   101,   116,   117,   112,     0,     0,   126,   171,
-     121,    79,   118,   176,   177,   178,   179,   180,    33,    32,
-       0,     0,     0,     0,     0,     0,   167,     1,   170,     2,
-      45,    43,     0,    31,     0,     0,     0,   110,     0,     0,
-       0,     0,     0,   103,   103,     0,     0,   120,   122,     0,
-     131,     0,     0,    43,   131,     0,     0,     0,     0,    47,
-       0,     0,     0,     0,   124,   109,     0,   102,   105,   106,
-     107,   108,   104,     0,     0,   128,   127,   123,    81,     0,
-      80,   121,   133,    88,   119,    34,     0,    73,   131,    75,
-       0,   168,     0,    50,     0,     0,    41,    49,    38,     0,
-       0,    40,     0,   114,   115,     0,     0,   129,     0,   146,
-       0,   132,   135,   134,   137,     0,     0,    86,     0,    74,
-       0,     0,     0,     0,     0,    59,    60,    61,    62,    63,
-      54,    48,     0,     0,    42,     0,   125,     0,   121,   147,
-     148,   149,   150,   151,   152,   153,     0,   154,   156,     0,
-     138,     0,     0,     0,   133,   133,   145,     0,   133,    90,
-     103,    65,    76,    77,     0,    50,    46,     0,     0,    56,
-      57,    53,    38,    44,     0,   121,   130,   155,   157,     0,
-     141,   143,   144,   136,   139,   140,    98,    87,     0,    78,
-       0,     0,    64,   166,    51,    58,     0,    55,    39,    38,
-       0,   142,     0,    89,     0,    67,    65,    54,     0,   133,
-      82,    98,    91,    92,    95,    66,    52,    35,    85,    99,
-       0,    97,    96,    94,    93
+      20,    21,    22,     0,    39,     0,     0,     0,     0,   177,
+       0,   178,   179,   180,   181,   182,   183,   184,   167,   168,
+     169,    75,   185,    72,    73,   176,    74,     0,   115,    76,
+     117,   104,   105,   120,   121,   116,     0,     0,   130,   175,
+     125,    83,   122,   180,   181,   182,   183,   184,    33,    32,
+       0,     0,     0,     0,     0,     0,   171,     1,   174,     2,
+      49,    47,     0,    31,     0,     0,     0,   114,     0,     0,
+       0,     0,     0,   107,   107,     0,     0,   124,   126,     0,
+     135,     0,     0,    47,   135,     0,     0,     0,     0,    44,
+       0,     0,     0,     0,   128,   113,     0,   106,   109,   110,
+     111,   112,   108,     0,     0,   132,   131,   127,    85,     0,
+      84,   125,   137,    92,   123,    34,     0,    77,   135,    79,
+       0,   172,     0,    54,     0,    51,     0,    40,     0,     0,
+      42,     0,   118,   119,     0,     0,   133,     0,   150,     0,
+     136,   139,   138,   141,     0,     0,    90,     0,    78,     0,
+       0,     0,     0,     0,    63,    64,    65,    66,    67,    58,
+       0,    43,    53,     0,     0,     0,    46,     0,   129,     0,
+     125,   151,   152,   153,   154,   155,   156,   157,     0,   158,
+     160,     0,   142,     0,     0,     0,   137,   137,   149,     0,
+     137,    94,   107,    69,    80,    81,     0,    54,    50,     0,
+       0,    60,    61,    57,    52,    45,    40,    48,     0,   125,
+     134,   159,   161,     0,   145,   147,   148,   140,   143,   144,
+     102,    91,     0,    82,     0,     0,    68,   170,    55,    62,
+       0,    59,    41,    40,     0,   146,     0,    93,     0,    71,
+      69,    58,     0,   137,    86,   102,    95,    96,    99,    70,
+      56,    36,    89,   103,     0,   101,   100,    98,    35,     0,
+      97,     0,    40,     0,    37
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -234,  -234,   215,  -234,  -234,  -234,  -234,  -234,  -234,  -234,
-    -234,  -234,  -234,  -234,  -234,  -233,  -234,  -234,  -234,   118,
-    -234,  -234,     8,    57,   -35,  -234,  -234,  -234,   -27,    -9,
-     131,  -234,  -234,  -234,    69,  -234,   -42,  -234,  -234,  -234,
-    -234,  -234,  -234,  -234,   -26,  -234,  -234,   -12,  -234,     1,
-    -112,    -4,   147,  -234,  -150,  -234,  -234,  -213,  -234,  -107,
-    -205,  -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,  -234,
-    -234,  -234,  -234,  -234,  -234,     0,  -234
+    -207,  -207,   218,  -207,  -207,  -207,  -207,  -207,  -207,  -207,
+    -207,  -207,  -207,  -207,  -207,  -207,  -164,  -207,  -207,  -207,
+    -207,   111,  -207,  -207,    16,    50,   -27,  -207,  -207,  -207,
+     -25,    -3,   134,  -207,  -207,  -207,    67,  -207,   -49,  -207,
+    -207,  -207,  -207,  -207,  -207,  -207,   -30,  -207,  -207,   -24,
+    -207,    -1,  -111,    22,   147,  -207,  -147,  -207,  -207,  -188,
+    -207,  -110,  -206,  -207,  -207,  -207,  -207,  -207,  -207,  -207,
+    -207,  -207,  -207,  -207,  -207,  -207,  -207,    -5,  -207
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
        0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,    31,    46,   203,    32,    33,    34,   131,
-     129,   166,   194,   163,   241,   266,   200,    35,   262,   231,
-      69,    70,    36,    37,   158,   159,    38,   120,   148,   149,
-     280,   229,   187,   259,   282,   283,   293,   273,    39,   142,
-     143,    72,    81,    82,   117,    73,    74,    75,   150,   153,
-     181,   220,   182,   183,   184,   185,   221,   222,   223,    76,
-      77,    40,    41,    42,    99,    78,    79
+      28,    29,    30,    31,   298,    46,   205,    32,    33,   165,
+      34,   131,   129,   201,   193,   163,   243,   270,   199,    35,
+     266,   233,    69,    70,    36,    37,   158,   159,    38,   120,
+     148,   149,   284,   231,   186,   263,   286,   287,   297,   277,
+      39,   142,   143,    72,    81,    82,   117,    73,    74,    75,
+     150,   153,   180,   222,   181,   182,   183,   184,   223,   224,
+     225,    76,    77,    40,    41,    42,    99,    78,    79
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -882,100 +887,104 @@ static const yytype_int16 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      80,   177,   144,    43,    71,    88,    44,   108,   105,   268,
-      93,    49,    89,    90,   256,   291,    94,   157,     4,   254,
-     255,   224,    61,   257,    47,   249,    48,    63,    64,   250,
-      66,   111,   112,    51,   238,    95,   278,    97,   239,   240,
-     247,    91,   248,   100,    52,   101,   106,   103,   104,    92,
-     237,   189,    98,    83,    84,    85,    86,    87,   246,   281,
-     292,   284,   225,   107,   102,   109,   110,   111,   112,    45,
-    -158,  -159,  -160,    62,   288,   116,  -161,   284,   165,    65,
-     118,  -162,   109,   110,   111,   112,   113,   167,   114,   119,
-     115,   123,   124,   121,   122,   270,   238,   128,    49,   125,
-     239,   240,   132,   135,   136,   138,   139,   140,   141,   137,
-     126,   130,    49,   127,   133,   146,   147,    80,   260,   151,
-      51,   134,   155,   201,   152,   160,   162,   204,   164,   173,
-     168,    52,   169,   171,    51,   170,   175,   172,   174,   186,
-      83,    84,    85,    86,    87,    52,   176,   188,   180,   190,
-     191,   118,   192,   193,    83,    84,    85,    86,    87,     4,
-      62,   202,   109,   110,   111,   112,    65,    49,   206,   207,
-     205,   145,   227,   228,    62,   209,   208,   230,   234,   244,
-      65,   226,   195,   196,   197,   198,   199,   233,   236,    51,
-     160,   258,   243,   164,    49,   109,   110,   111,   112,   253,
-      52,   261,   242,   265,   224,    50,   267,   245,   118,    83,
-      84,    85,    86,    87,   271,   272,    51,   251,   252,   274,
-     180,   180,   -83,   275,   180,   277,   279,    52,   287,    62,
-     290,   116,   -84,    96,   263,    65,    53,    54,    55,    56,
-      57,   156,   286,   264,   269,   118,    58,    59,    60,   285,
-     235,   178,   276,   179,    49,    61,    62,   161,     4,   232,
-      63,    64,    65,    66,   294,    50,    67,    68,   154,   289,
-       0,     0,     0,     0,     0,   180,    51,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,    52,     0,     0,
-       0,    49,     0,     0,     0,     0,    53,    54,    55,    56,
-      57,     0,    50,     0,     0,     0,    58,    59,    60,     0,
-       0,     0,     0,    51,     0,    61,    62,     0,     0,     0,
-      63,    64,    65,    66,    52,     0,    67,    68,    49,     0,
-       0,     0,     0,    53,    54,    55,    56,    57,     0,     0,
-       0,     0,     0,    58,    59,    60,     0,     0,     0,     0,
-      51,     0,    61,    62,     0,     0,     0,    63,    64,    65,
-      66,    52,     0,    67,    68,     0,     0,     0,     0,     0,
-      83,    84,    85,    86,    87,     0,     1,     2,     0,     0,
-       0,     0,     3,     4,     5,     6,     7,     8,     9,    10,
-      62,     0,   116,    11,    12,    13,    65,     0,     0,     0,
-       0,    14,    15,   210,   211,   212,   213,   214,   215,    16,
-       0,    17,     0,     0,    18,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,   216,   217,     0,   218,     0,     0,
-     219,     0,     0,     0,     0,     0,     0,     0,   109,   110,
-     111,   112
+      88,   105,    71,   144,   176,    93,   295,     4,   226,    91,
+      43,    94,    49,    44,   157,   194,   195,   196,   197,   198,
+     258,   259,    61,    50,   261,   253,    80,    63,    64,   254,
+      66,   240,   135,   136,    51,   241,   242,    47,   100,    48,
+     101,   260,   103,   104,   251,    52,   252,    95,   188,   227,
+     239,   296,    89,    90,    53,    54,    55,    56,    57,   109,
+     110,   111,   112,   250,    58,    59,    60,   200,    92,   177,
+      97,   178,   106,    61,    62,   118,    45,   292,    63,    64,
+      65,    66,   272,    98,    67,    68,   123,   124,   285,   107,
+     288,   109,   110,   111,   112,   108,   240,   132,   111,   112,
+     241,   242,   274,   102,  -162,  -163,   288,   137,  -164,   282,
+     146,   147,  -165,   115,   151,    49,   202,   155,  -166,   206,
+     160,   264,   113,   164,   166,   167,   119,   114,   170,   127,
+     121,   138,   139,   140,   141,   171,   122,    51,   303,   126,
+     125,   128,   130,    80,   133,   134,   118,    49,    52,   152,
+     162,   244,   168,   109,   110,   111,   112,    83,    84,    85,
+      86,    87,   172,   169,   207,   173,   185,   174,   175,    51,
+     210,   187,   189,   190,   179,   192,   191,    62,   203,   204,
+      52,     4,   208,    65,   160,   209,   211,   164,   145,    83,
+      84,    85,    86,    87,   230,    49,   232,   229,   245,   246,
+     236,   238,   247,   248,   249,   118,   228,   257,   262,    62,
+     265,   116,   235,   271,   278,    65,   226,    51,   109,   110,
+     111,   112,   269,   276,   275,   279,   281,   283,    52,   291,
+     -88,   267,   294,   301,   156,   304,    96,    83,    84,    85,
+      86,    87,   237,   273,   118,   255,   256,    49,   179,   179,
+     -87,     4,   179,   268,   290,   289,   234,    62,    50,   116,
+     161,   293,   280,    65,   300,     0,     0,     0,   154,    51,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      52,     0,     0,     0,    49,     0,   299,     0,     0,    53,
+      54,    55,    56,    57,     0,    50,   302,     0,     0,    58,
+      59,    60,     0,     0,     0,   179,    51,     0,    61,    62,
+       0,     0,     0,    63,    64,    65,    66,    52,     0,    67,
+      68,    49,     0,     0,     0,     0,    53,    54,    55,    56,
+      57,     0,     0,     0,     0,     0,    58,    59,    60,     0,
+       0,     0,     0,    51,     0,    61,    62,     0,    49,     0,
+      63,    64,    65,    66,    52,     0,    67,    68,     0,     0,
+       0,     0,     0,    83,    84,    85,    86,    87,     0,     0,
+      51,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    52,     0,    62,     0,   116,     0,     0,     0,    65,
+      83,    84,    85,    86,    87,     1,     2,     0,     0,     0,
+       0,     3,     4,     5,     6,     7,     8,     9,    10,     0,
+      62,     0,    11,    12,    13,     0,    65,     0,     0,     0,
+      14,    15,   212,   213,   214,   215,   216,   217,    16,     0,
+      17,     0,     0,    18,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,   218,   219,     0,   220,     0,     0,   221,
+       0,     0,     0,     0,     0,     0,     0,   109,   110,   111,
+     112
 };
 
 static const yytype_int16 yycheck[] =
 {
-       4,   151,   114,     6,     3,     5,     9,    20,    50,   242,
-      10,     7,     7,     8,   227,    12,    16,   124,    11,   224,
-     225,    36,    68,   228,     6,    64,     8,    73,    74,    68,
-      76,    80,    81,    29,    64,    40,   269,     0,    68,    69,
-      65,    32,    67,    43,    40,    45,    50,    47,    48,    34,
-      18,   158,     3,    49,    50,    51,    52,    53,   208,   272,
-      57,   274,    77,    67,     8,    78,    79,    80,    81,    72,
-      18,    18,    18,    69,   279,    71,    18,   290,    71,    75,
-      80,    18,    78,    79,    80,    81,    18,   129,    18,    34,
-      31,    91,    92,    20,    34,   245,    64,    18,     7,    37,
-      68,    69,   102,    19,    20,   109,   110,   111,   112,   108,
-      43,    18,     7,    41,    38,   115,   116,   121,   230,   119,
-      29,    19,   122,   165,    35,   125,    76,   169,   128,    19,
-     130,    40,    71,   133,    29,    38,    62,   136,    19,    54,
-      49,    50,    51,    52,    53,    40,    20,    33,   152,    20,
-      43,   151,    32,    20,    49,    50,    51,    52,    53,    11,
-      69,    20,    78,    79,    80,    81,    75,     7,    19,    63,
-     170,    80,    56,    58,    69,    66,   176,    18,     6,    18,
-      75,   185,    24,    25,    26,    27,    28,   191,    19,    29,
-     190,    55,    19,   193,     7,    78,    79,    80,    81,    76,
-      40,    20,   202,    73,    36,    18,    68,   207,   208,    49,
-      50,    51,    52,    53,    68,    20,    29,   221,   222,    56,
-     224,   225,    62,    19,   228,    19,    38,    40,    19,    69,
-      20,    71,    62,    18,   234,    75,    49,    50,    51,    52,
-      53,   123,   277,   235,   244,   245,    59,    60,    61,   276,
-     193,    64,   261,    66,     7,    68,    69,   126,    11,   190,
-      73,    74,    75,    76,   290,    18,    79,    80,   121,   281,
-      -1,    -1,    -1,    -1,    -1,   279,    29,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    40,    -1,    -1,
-      -1,     7,    -1,    -1,    -1,    -1,    49,    50,    51,    52,
-      53,    -1,    18,    -1,    -1,    -1,    59,    60,    61,    -1,
-      -1,    -1,    -1,    29,    -1,    68,    69,    -1,    -1,    -1,
-      73,    74,    75,    76,    40,    -1,    79,    80,     7,    -1,
+       5,    50,     3,   114,   151,    10,    12,    11,    36,    32,
+       6,    16,     7,     9,   124,    24,    25,    26,    27,    28,
+     226,   227,    68,    18,   230,    64,     4,    73,    74,    68,
+      76,    64,    19,    20,    29,    68,    69,     6,    43,     8,
+      45,   229,    47,    48,    65,    40,    67,    40,   158,    77,
+      18,    57,     7,     8,    49,    50,    51,    52,    53,    78,
+      79,    80,    81,   210,    59,    60,    61,    71,    34,    64,
+       0,    66,    50,    68,    69,    80,    72,   283,    73,    74,
+      75,    76,   246,     3,    79,    80,    91,    92,   276,    67,
+     278,    78,    79,    80,    81,    20,    64,   102,    80,    81,
+      68,    69,   249,     8,    18,    18,   294,   108,    18,   273,
+     115,   116,    18,    31,   119,     7,   165,   122,    18,   168,
+     125,   232,    18,   128,   129,   130,    34,    18,   133,    41,
+      20,   109,   110,   111,   112,   136,    34,    29,   302,    43,
+      37,    18,    18,   121,    38,    19,   151,     7,    40,    35,
+      76,   200,    71,    78,    79,    80,    81,    49,    50,    51,
+      52,    53,    19,    38,   169,    19,    54,    62,    20,    29,
+     175,    33,    20,    43,   152,    20,    32,    69,    43,    20,
+      40,    11,    19,    75,   189,    63,    66,   192,    80,    49,
+      50,    51,    52,    53,    58,     7,    18,    56,   203,   204,
+       6,    19,    19,    18,   209,   210,   184,    76,    55,    69,
+      20,    71,   190,    68,    56,    75,    36,    29,    78,    79,
+      80,    81,    73,    20,    68,    19,    19,    38,    40,    19,
+      62,   236,    20,    18,   123,    19,    18,    49,    50,    51,
+      52,    53,   192,   248,   249,   223,   224,     7,   226,   227,
+      62,    11,   230,   237,   281,   280,   189,    69,    18,    71,
+     126,   285,   265,    75,   294,    -1,    -1,    -1,   121,    29,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      40,    -1,    -1,    -1,     7,    -1,   291,    -1,    -1,    49,
+      50,    51,    52,    53,    -1,    18,   301,    -1,    -1,    59,
+      60,    61,    -1,    -1,    -1,   283,    29,    -1,    68,    69,
+      -1,    -1,    -1,    73,    74,    75,    76,    40,    -1,    79,
+      80,     7,    -1,    -1,    -1,    -1,    49,    50,    51,    52,
+      53,    -1,    -1,    -1,    -1,    -1,    59,    60,    61,    -1,
+      -1,    -1,    -1,    29,    -1,    68,    69,    -1,     7,    -1,
+      73,    74,    75,    76,    40,    -1,    79,    80,    -1,    -1,
       -1,    -1,    -1,    49,    50,    51,    52,    53,    -1,    -1,
-      -1,    -1,    -1,    59,    60,    61,    -1,    -1,    -1,    -1,
-      29,    -1,    68,    69,    -1,    -1,    -1,    73,    74,    75,
-      76,    40,    -1,    79,    80,    -1,    -1,    -1,    -1,    -1,
-      49,    50,    51,    52,    53,    -1,     4,     5,    -1,    -1,
-      -1,    -1,    10,    11,    12,    13,    14,    15,    16,    17,
-      69,    -1,    71,    21,    22,    23,    75,    -1,    -1,    -1,
-      -1,    29,    30,    43,    44,    45,    46,    47,    48,    37,
-      -1,    39,    -1,    -1,    42,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    64,    65,    -1,    67,    -1,    -1,
-      70,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    78,    79,
-      80,    81
+      29,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    40,    -1,    69,    -1,    71,    -1,    -1,    -1,    75,
+      49,    50,    51,    52,    53,     4,     5,    -1,    -1,    -1,
+      -1,    10,    11,    12,    13,    14,    15,    16,    17,    -1,
+      69,    -1,    21,    22,    23,    -1,    75,    -1,    -1,    -1,
+      29,    30,    43,    44,    45,    46,    47,    48,    37,    -1,
+      39,    -1,    -1,    42,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    64,    65,    -1,    67,    -1,    -1,    70,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    78,    79,    80,
+      81
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -985,33 +994,34 @@ static const yytype_uint8 yystos[] =
        0,     4,     5,    10,    11,    12,    13,    14,    15,    16,
       17,    21,    22,    23,    29,    30,    37,    39,    42,    84,
       85,    86,    87,    88,    89,    90,    91,    92,    93,    94,
-      95,    96,    99,   100,   101,   110,   115,   116,   119,   131,
-     154,   155,   156,     6,     9,    72,    97,     6,     8,     7,
+      95,    96,   100,   101,   103,   112,   117,   118,   121,   133,
+     156,   157,   158,     6,     9,    72,    98,     6,     8,     7,
       18,    29,    40,    49,    50,    51,    52,    53,    59,    60,
-      61,    68,    69,    73,    74,    75,    76,    79,    80,   113,
-     114,   132,   134,   138,   139,   140,   152,   153,   158,   159,
-     134,   135,   136,    49,    50,    51,    52,    53,   158,     7,
-       8,    32,    34,   158,   158,    40,    85,     0,     3,   157,
-     158,   158,     8,   158,   158,   119,   134,   134,    20,    78,
-      79,    80,    81,    18,    18,    31,    71,   137,   158,    34,
-     120,    20,    34,   158,   158,    37,    43,    41,    18,   103,
-      18,   102,   158,    38,    19,    19,    20,   132,   134,   134,
-     134,   134,   132,   133,   133,    80,   158,   158,   121,   122,
-     141,   158,    35,   142,   135,   158,   102,   142,   117,   118,
-     158,   113,    76,   106,   158,    71,   104,   119,   158,    71,
-      38,   158,   132,    19,    19,    62,    20,   137,    64,    66,
-     134,   143,   145,   146,   147,   148,    54,   125,    33,   142,
-      20,    43,    32,    20,   105,    24,    25,    26,    27,    28,
-     109,   119,    20,    98,   119,   158,    19,    63,   158,    66,
-      43,    44,    45,    46,    47,    48,    64,    65,    67,    70,
-     144,   149,   150,   151,    36,    77,   134,    56,    58,   124,
-      18,   112,   117,   134,     6,   106,    19,    18,    64,    68,
-      69,   107,   158,    19,    18,   158,   137,    65,    67,    64,
-      68,   134,   134,    76,   143,   143,   140,   143,    55,   126,
-     133,    20,   111,   158,   105,    73,   108,    68,    98,   158,
-     137,    68,    20,   130,    56,    19,   112,    19,    98,    38,
-     123,   140,   127,   128,   140,   111,   107,    19,   143,   130,
-      20,    12,    57,   129,   127
+      61,    68,    69,    73,    74,    75,    76,    79,    80,   115,
+     116,   134,   136,   140,   141,   142,   154,   155,   160,   161,
+     136,   137,   138,    49,    50,    51,    52,    53,   160,     7,
+       8,    32,    34,   160,   160,    40,    85,     0,     3,   159,
+     160,   160,     8,   160,   160,   121,   136,   136,    20,    78,
+      79,    80,    81,    18,    18,    31,    71,   139,   160,    34,
+     122,    20,    34,   160,   160,    37,    43,    41,    18,   105,
+      18,   104,   160,    38,    19,    19,    20,   134,   136,   136,
+     136,   136,   134,   135,   135,    80,   160,   160,   123,   124,
+     143,   160,    35,   144,   137,   160,   104,   144,   119,   120,
+     160,   115,    76,   108,   160,   102,   160,   160,    71,    38,
+     160,   134,    19,    19,    62,    20,   139,    64,    66,   136,
+     145,   147,   148,   149,   150,    54,   127,    33,   144,    20,
+      43,    32,    20,   107,    24,    25,    26,    27,    28,   111,
+      71,   106,   121,    43,    20,    99,   121,   160,    19,    63,
+     160,    66,    43,    44,    45,    46,    47,    48,    64,    65,
+      67,    70,   146,   151,   152,   153,    36,    77,   136,    56,
+      58,   126,    18,   114,   119,   136,     6,   108,    19,    18,
+      64,    68,    69,   109,   121,   160,   160,    19,    18,   160,
+     139,    65,    67,    64,    68,   136,   136,    76,   145,   145,
+     142,   145,    55,   128,   135,    20,   113,   160,   107,    73,
+     110,    68,    99,   160,   139,    68,    20,   132,    56,    19,
+     114,    19,    99,    38,   125,   142,   129,   130,   142,   113,
+     109,    19,   145,   132,    20,    12,    57,   131,    97,   160,
+     129,    18,   160,    99,    19
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
@@ -1021,21 +1031,21 @@ static const yytype_uint8 yyr1[] =
       85,    85,    85,    85,    85,    85,    85,    85,    85,    85,
       85,    85,    85,    85,    85,    86,    87,    88,    89,    90,
       91,    92,    93,    94,    95,    96,    97,    97,    98,    98,
-      99,   100,   101,   102,   102,   103,   103,   104,   104,   104,
-     105,   105,   106,   106,   107,   107,   107,   107,   108,   109,
-     109,   109,   109,   109,   110,   111,   111,   112,   113,   113,
-     113,   113,   114,   115,   116,   117,   117,   118,   119,   120,
-     120,   120,   121,   122,   122,   123,   124,   124,   125,   125,
-     126,   126,   127,   127,   128,   129,   129,   129,   130,   130,
-     131,   132,   132,   133,   133,   134,   134,   134,   134,   134,
-     134,   134,   134,   134,   134,   134,   134,   134,   135,   135,
-     136,   137,   137,   137,   138,   139,   140,   140,   140,   141,
-     141,   142,   142,   143,   143,   143,   143,   143,   143,   143,
-     143,   144,   144,   145,   146,   147,   148,   148,   149,   149,
-     149,   149,   149,   149,   150,   150,   151,   151,   152,   152,
-     152,   152,   152,   153,   153,   153,   154,   155,   156,   157,
-     157,   158,   158,   159,   159,   159,   159,   159,   159,   159,
-     159,   159
+      99,    99,   100,   101,   102,   102,   103,   104,   104,   105,
+     105,   106,   106,   106,   107,   107,   108,   108,   109,   109,
+     109,   109,   110,   111,   111,   111,   111,   111,   112,   113,
+     113,   114,   115,   115,   115,   115,   116,   117,   118,   119,
+     119,   120,   121,   122,   122,   122,   123,   124,   124,   125,
+     126,   126,   127,   127,   128,   128,   129,   129,   130,   131,
+     131,   131,   132,   132,   133,   134,   134,   135,   135,   136,
+     136,   136,   136,   136,   136,   136,   136,   136,   136,   136,
+     136,   136,   137,   137,   138,   139,   139,   139,   140,   141,
+     142,   142,   142,   143,   143,   144,   144,   145,   145,   145,
+     145,   145,   145,   145,   145,   146,   146,   147,   148,   149,
+     150,   150,   151,   151,   151,   151,   151,   151,   152,   152,
+     153,   153,   154,   154,   154,   154,   154,   155,   155,   155,
+     156,   157,   158,   159,   159,   160,   160,   161,   161,   161,
+     161,   161,   161,   161,   161,   161
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -1044,22 +1054,22 @@ static const yytype_int8 yyr2[] =
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     3,     2,     2,     4,    10,     0,     1,     0,     3,
-       5,     5,     6,     0,     4,     0,     4,     0,     2,     1,
-       0,     3,     6,     3,     0,     2,     1,     1,     1,     1,
-       1,     1,     1,     1,     7,     0,     3,     3,     1,     1,
-       1,     1,     1,     4,     5,     1,     3,     3,     7,     0,
-       2,     2,     6,     1,     6,     2,     0,     2,     0,     4,
-       0,     3,     1,     3,     2,     0,     1,     1,     0,     3,
-       2,     1,     3,     0,     1,     3,     3,     3,     3,     3,
-       2,     1,     1,     1,     4,     4,     1,     1,     1,     3,
-       2,     0,     1,     2,     3,     5,     1,     3,     3,     2,
-       4,     0,     2,     0,     1,     1,     3,     1,     2,     3,
-       3,     2,     3,     3,     3,     2,     1,     2,     1,     1,
-       1,     1,     1,     1,     1,     2,     1,     2,     1,     1,
-       1,     1,     1,     1,     1,     1,     7,     2,     4,     0,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1
+       1,     3,     2,     2,     4,    11,     0,     5,     0,     1,
+       0,     3,     5,     6,     0,     3,     6,     0,     4,     0,
+       4,     0,     2,     1,     0,     3,     6,     3,     0,     2,
+       1,     1,     1,     1,     1,     1,     1,     1,     7,     0,
+       3,     3,     1,     1,     1,     1,     1,     4,     5,     1,
+       3,     3,     7,     0,     2,     2,     6,     1,     6,     2,
+       0,     2,     0,     4,     0,     3,     1,     3,     2,     0,
+       1,     1,     0,     3,     2,     1,     3,     0,     1,     3,
+       3,     3,     3,     3,     2,     1,     1,     1,     4,     4,
+       1,     1,     1,     3,     2,     0,     1,     2,     3,     5,
+       1,     3,     3,     2,     4,     0,     2,     0,     1,     1,
+       3,     1,     2,     3,     3,     2,     3,     3,     3,     2,
+       1,     2,     1,     1,     1,     1,     1,     1,     1,     2,
+       1,     2,     1,     1,     1,     1,     1,     1,     1,     1,
+       7,     2,     4,     0,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1
 };
 
 
@@ -1921,65 +1931,65 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* commands: command_wrapper opt_semicolon  */
-#line 262 "yacc_sql.y"
+#line 264 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1930 "yacc_sql.cpp"
+#line 1940 "yacc_sql.cpp"
     break;
 
   case 25: /* exit_stmt: EXIT  */
-#line 294 "yacc_sql.y"
+#line 296 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1939 "yacc_sql.cpp"
+#line 1949 "yacc_sql.cpp"
     break;
 
   case 26: /* help_stmt: HELP  */
-#line 300 "yacc_sql.y"
+#line 302 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1947 "yacc_sql.cpp"
+#line 1957 "yacc_sql.cpp"
     break;
 
   case 27: /* sync_stmt: SYNC  */
-#line 305 "yacc_sql.y"
+#line 307 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1955 "yacc_sql.cpp"
+#line 1965 "yacc_sql.cpp"
     break;
 
   case 28: /* begin_stmt: TRX_BEGIN  */
-#line 311 "yacc_sql.y"
+#line 313 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1963 "yacc_sql.cpp"
+#line 1973 "yacc_sql.cpp"
     break;
 
   case 29: /* commit_stmt: TRX_COMMIT  */
-#line 317 "yacc_sql.y"
+#line 319 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1971 "yacc_sql.cpp"
+#line 1981 "yacc_sql.cpp"
     break;
 
   case 30: /* rollback_stmt: TRX_ROLLBACK  */
-#line 323 "yacc_sql.y"
+#line 325 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1979 "yacc_sql.cpp"
+#line 1989 "yacc_sql.cpp"
     break;
 
   case 31: /* drop_table_stmt: DROP TABLE id  */
-#line 329 "yacc_sql.y"
+#line 331 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       auto *drop_table = new DropTableSqlNode;
@@ -1987,19 +1997,19 @@ yyreduce:
       drop_table->relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1991 "yacc_sql.cpp"
+#line 2001 "yacc_sql.cpp"
     break;
 
   case 32: /* show_tables_stmt: SHOW TABLES  */
-#line 338 "yacc_sql.y"
+#line 340 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1999 "yacc_sql.cpp"
+#line 2009 "yacc_sql.cpp"
     break;
 
   case 33: /* desc_table_stmt: DESC id  */
-#line 344 "yacc_sql.y"
+#line 346 "yacc_sql.y"
              {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       auto *desc_table = new DescTableSqlNode;
@@ -2007,11 +2017,11 @@ yyreduce:
       desc_table->relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2011 "yacc_sql.cpp"
+#line 2021 "yacc_sql.cpp"
     break;
 
   case 34: /* show_index_stmt: SHOW INDEX FROM id  */
-#line 354 "yacc_sql.y"
+#line 356 "yacc_sql.y"
                        {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_INDEX);
       auto *show_index = new ShowIndexSqlNode;
@@ -2019,65 +2029,97 @@ yyreduce:
       show_index->table_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2023 "yacc_sql.cpp"
+#line 2033 "yacc_sql.cpp"
     break;
 
-  case 35: /* create_index_stmt: CREATE unique INDEX id ON id LBRACE id ids RBRACE  */
-#line 365 "yacc_sql.y"
+  case 35: /* create_index_stmt: CREATE unique INDEX id ON id LBRACE id ids RBRACE index_include  */
+#line 367 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode *create_index = new CreateIndexSqlNode;
       (yyval.sql_node)->node.create_index = create_index;
-      create_index->unique = (yyvsp[-8].bools);
-      create_index->index_name = (yyvsp[-6].string);
-      create_index->relation_name = (yyvsp[-4].string);
-      (yyvsp[-1].id_list)->push_back((yyvsp[-2].string));
-      create_index->attribute_names.swap(*(yyvsp[-1].id_list));
-      delete (yyvsp[-1].id_list);
+      create_index->unique = (yyvsp[-9].bools);
+      create_index->index_name = (yyvsp[-7].string);
+      create_index->relation_name = (yyvsp[-5].string);
+      (yyvsp[-2].id_list)->push_back((yyvsp[-3].string));
+      create_index->attribute_names.swap(*(yyvsp[-2].id_list));
+      delete (yyvsp[-2].id_list);
       std::reverse(create_index->attribute_names.begin(), create_index->attribute_names.end());
-      free((yyvsp[-6].string));
+      if ((yyvsp[0].id_list) != nullptr) {
+        create_index->include_names.swap(*(yyvsp[0].id_list));
+        delete (yyvsp[0].id_list);
+      }
+      free((yyvsp[-7].string));
+      free((yyvsp[-5].string));
+      free((yyvsp[-3].string));
+    }
+#line 2057 "yacc_sql.cpp"
+    break;
+
+  case 36: /* index_include: %empty  */
+#line 390 "yacc_sql.y"
+    {
+      (yyval.id_list) = nullptr;
+    }
+#line 2065 "yacc_sql.cpp"
+    break;
+
+  case 37: /* index_include: id LBRACE id ids RBRACE  */
+#line 394 "yacc_sql.y"
+    {
+      // 与 storage_format 一样没有单独的关键字，在这里检查
+      if (0 != strcasecmp((yyvsp[-4].string), "include")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "unknown index option");
+        free((yyvsp[-4].string));
+        free((yyvsp[-2].string));
+        delete (yyvsp[-1].id_list);
+        YYERROR;
+      }
+      (yyval.id_list) = (yyvsp[-1].id_list);
+      (yyval.id_list)->push_back((yyvsp[-2].string));
+      std::reverse((yyval.id_list)->begin(), (yyval.id_list)->end());
       free((yyvsp[-4].string));
       free((yyvsp[-2].string));
     }
-#line 2043 "yacc_sql.cpp"
+#line 2085 "yacc_sql.cpp"
     break;
 
-  case 36: /* unique: %empty  */
-#line 383 "yacc_sql.y"
+  case 38: /* unique: %empty  */
+#line 412 "yacc_sql.y"
     {
       (yyval.bools) = false;
     }
-#line 2051 "yacc_sql.cpp"
+#line 2093 "yacc_sql.cpp"
     break;
 
-  case 37: /* unique: UNIQUE  */
-#line 386 "yacc_sql.y"
+  case 39: /* unique: UNIQUE  */
+#line 415 "yacc_sql.y"
              {
       (yyval.bools) = true;
     }
-#line 2059 "yacc_sql.cpp"
+#line 2101 "yacc_sql.cpp"
     break;
 
-  case 38: /* ids: %empty  */
-#line 391 "yacc_sql.y"
+  case 40: /* ids: %empty  */
+#line 420 "yacc_sql.y"
    {
       (yyval.id_list) = new std::vector<std::string>();
    }
-#line 2067 "yacc_sql.cpp"
+#line 2109 "yacc_sql.cpp"
     break;
 
-  case 39: /* ids: COMMA id ids  */
-#line 394 "yacc_sql.y"
+  case 41: /* ids: COMMA id ids  */
+#line 423 "yacc_sql.y"
                   {
       (yyvsp[0].id_list)->push_back((yyvsp[-1].string));
       free((yyvsp[-1].string));
       (yyval.id_list) = (yyvsp[0].id_list);
    }
-#line 2077 "yacc_sql.cpp"
+#line 2119 "yacc_sql.cpp"
     break;
 
-  case 40: /* drop_index_stmt: DROP INDEX id ON id  */
-#line 402 "yacc_sql.y"
+  case 42: /* drop_index_stmt: DROP INDEX id ON id  */
+#line 431 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       auto *drop_index = new DropIndexSqlNode;
@@ -2087,28 +2129,56 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2091 "yacc_sql.cpp"
+#line 2133 "yacc_sql.cpp"
     break;
 
-  case 41: /* create_table_stmt: CREATE TABLE id attr_list as_select  */
-#line 415 "yacc_sql.y"
+  case 43: /* create_table_stmt: CREATE TABLE id attr_list storage_format as_select  */
+#line 444 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode *create_table = new CreateTableSqlNode;
       (yyval.sql_node)->node.create_table = create_table;
-      create_table->relation_name = (yyvsp[-2].string);
-      free((yyvsp[-2].string));
-      if((yyvsp[-1].attr_infos) != nullptr) {
-        create_table->attr_infos.swap(*(yyvsp[-1].attr_infos));
-        delete (yyvsp[-1].attr_infos);
+      create_table->relation_name = (yyvsp[-3].string);
+      free((yyvsp[-3].string));
+      if((yyvsp[-2].attr_infos) != nullptr) {
+        create_table->attr_infos.swap(*(yyvsp[-2].attr_infos));
+        delete (yyvsp[-2].attr_infos);
+      }
+      if ((yyvsp[-1].string) != nullptr) {
+        create_table->storage_format = (yyvsp[-1].string);
+        free((yyvsp[-1].string));
       }
       create_table->select = (yyvsp[0].sql_node);
     }
-#line 2108 "yacc_sql.cpp"
+#line 2154 "yacc_sql.cpp"
     break;
 
-  case 42: /* create_view_stmt: CREATE VIEW id brace_id_list AS select_stmt  */
-#line 431 "yacc_sql.y"
+  case 44: /* storage_format: %empty  */
+#line 464 "yacc_sql.y"
+    {
+      (yyval.string) = nullptr;
+    }
+#line 2162 "yacc_sql.cpp"
+    break;
+
+  case 45: /* storage_format: id EQ id  */
+#line 468 "yacc_sql.y"
+    {
+      // 没有单独的关键字，表选项的名字在这里检查
+      if (0 != strcasecmp((yyvsp[-2].string), "storage_format")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "unknown table option");
+        free((yyvsp[-2].string));
+        free((yyvsp[0].string));
+        YYERROR;
+      }
+      free((yyvsp[-2].string));
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 2178 "yacc_sql.cpp"
+    break;
+
+  case 46: /* create_view_stmt: CREATE VIEW id brace_id_list AS select_stmt  */
+#line 483 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_VIEW);
       CreateViewSqlNode *create_view = new CreateViewSqlNode;
@@ -2122,19 +2192,19 @@ yyreduce:
       create_view->select = (yyvsp[0].sql_node);
       create_view->select_sql = (yyvsp[0].sql_node)->node.selection->sql;
     }
-#line 2126 "yacc_sql.cpp"
+#line 2196 "yacc_sql.cpp"
     break;
 
-  case 43: /* brace_id_list: %empty  */
-#line 446 "yacc_sql.y"
+  case 47: /* brace_id_list: %empty  */
+#line 498 "yacc_sql.y"
     {
       (yyval.id_list) = nullptr;
     }
-#line 2134 "yacc_sql.cpp"
+#line 2204 "yacc_sql.cpp"
     break;
 
-  case 44: /* brace_id_list: LBRACE id ids RBRACE  */
-#line 449 "yacc_sql.y"
+  case 48: /* brace_id_list: LBRACE id ids RBRACE  */
+#line 501 "yacc_sql.y"
                            {
       if ((yyvsp[-1].id_list) == nullptr) {
         (yyval.id_list) = new std::vector<std::string>();
@@ -2145,19 +2215,19 @@ yyreduce:
       free((yyvsp[-2].string));
       std::reverse((yyval.id_list)->begin(), (yyval.id_list)->end());
     }
-#line 2149 "yacc_sql.cpp"
+#line 2219 "yacc_sql.cpp"
     break;
 
-  case 45: /* attr_list: %empty  */
-#line 461 "yacc_sql.y"
+  case 49: /* attr_list: %empty  */
+#line 513 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 2157 "yacc_sql.cpp"
+#line 2227 "yacc_sql.cpp"
     break;
 
-  case 46: /* attr_list: LBRACE attr_def attr_def_list RBRACE  */
-#line 464 "yacc_sql.y"
+  case 50: /* attr_list: LBRACE attr_def attr_def_list RBRACE  */
+#line 516 "yacc_sql.y"
                                            {
       if ((yyvsp[-1].attr_infos) == nullptr) {
         (yyval.attr_infos) = new std::vector<AttrInfoSqlNode>;
@@ -2167,43 +2237,43 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-2].attr_info));
       std::reverse((yyval.attr_infos)->begin(), (yyval.attr_infos)->end());
     }
-#line 2171 "yacc_sql.cpp"
+#line 2241 "yacc_sql.cpp"
     break;
 
-  case 47: /* as_select: %empty  */
-#line 475 "yacc_sql.y"
+  case 51: /* as_select: %empty  */
+#line 527 "yacc_sql.y"
     {
       (yyval.sql_node) = nullptr;
     }
-#line 2179 "yacc_sql.cpp"
+#line 2249 "yacc_sql.cpp"
     break;
 
-  case 48: /* as_select: AS select_stmt  */
-#line 478 "yacc_sql.y"
+  case 52: /* as_select: AS select_stmt  */
+#line 530 "yacc_sql.y"
                      {
       (yyval.sql_node) = (yyvsp[0].sql_node);
     }
-#line 2187 "yacc_sql.cpp"
+#line 2257 "yacc_sql.cpp"
     break;
 
-  case 49: /* as_select: select_stmt  */
-#line 481 "yacc_sql.y"
+  case 53: /* as_select: select_stmt  */
+#line 533 "yacc_sql.y"
                   {
       (yyval.sql_node) = (yyvsp[0].sql_node);
     }
-#line 2195 "yacc_sql.cpp"
+#line 2265 "yacc_sql.cpp"
     break;
 
-  case 50: /* attr_def_list: %empty  */
-#line 487 "yacc_sql.y"
+  case 54: /* attr_def_list: %empty  */
+#line 539 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 2203 "yacc_sql.cpp"
+#line 2273 "yacc_sql.cpp"
     break;
 
-  case 51: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 491 "yacc_sql.y"
+  case 55: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 543 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -2213,11 +2283,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 2217 "yacc_sql.cpp"
+#line 2287 "yacc_sql.cpp"
     break;
 
-  case 52: /* attr_def: id type LBRACE number RBRACE null_def  */
-#line 504 "yacc_sql.y"
+  case 56: /* attr_def: id type LBRACE number RBRACE null_def  */
+#line 556 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-4].number);
@@ -2226,11 +2296,11 @@ yyreduce:
       (yyval.attr_info)->nullable = (yyvsp[0].bools);
       free((yyvsp[-5].string));
     }
-#line 2230 "yacc_sql.cpp"
+#line 2300 "yacc_sql.cpp"
     break;
 
-  case 53: /* attr_def: id type null_def  */
-#line 513 "yacc_sql.y"
+  case 57: /* attr_def: id type null_def  */
+#line 565 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-1].number);
@@ -2239,79 +2309,79 @@ yyreduce:
       (yyval.attr_info)->nullable = (yyvsp[0].bools);
       free((yyvsp[-2].string));
     }
-#line 2243 "yacc_sql.cpp"
+#line 2313 "yacc_sql.cpp"
     break;
 
-  case 54: /* null_def: %empty  */
-#line 524 "yacc_sql.y"
+  case 58: /* null_def: %empty  */
+#line 576 "yacc_sql.y"
     {
       (yyval.bools) = true;
     }
-#line 2251 "yacc_sql.cpp"
+#line 2321 "yacc_sql.cpp"
     break;
 
-  case 55: /* null_def: NOT NULL_V  */
-#line 527 "yacc_sql.y"
+  case 59: /* null_def: NOT NULL_V  */
+#line 579 "yacc_sql.y"
                  {
       (yyval.bools) = false;
     }
-#line 2259 "yacc_sql.cpp"
+#line 2329 "yacc_sql.cpp"
     break;
 
-  case 56: /* null_def: NULL_V  */
-#line 530 "yacc_sql.y"
+  case 60: /* null_def: NULL_V  */
+#line 582 "yacc_sql.y"
              {
       (yyval.bools) = true;
     }
-#line 2267 "yacc_sql.cpp"
+#line 2337 "yacc_sql.cpp"
     break;
 
-  case 57: /* null_def: NULLABLE  */
-#line 533 "yacc_sql.y"
+  case 61: /* null_def: NULLABLE  */
+#line 585 "yacc_sql.y"
                {
       (yyval.bools) = true;
     }
-#line 2275 "yacc_sql.cpp"
+#line 2345 "yacc_sql.cpp"
     break;
 
-  case 58: /* number: NUMBER  */
-#line 538 "yacc_sql.y"
+  case 62: /* number: NUMBER  */
+#line 590 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 2281 "yacc_sql.cpp"
+#line 2351 "yacc_sql.cpp"
     break;
 
-  case 59: /* type: INT_T  */
-#line 542 "yacc_sql.y"
+  case 63: /* type: INT_T  */
+#line 594 "yacc_sql.y"
                { (yyval.number)=INTS; }
-#line 2287 "yacc_sql.cpp"
+#line 2357 "yacc_sql.cpp"
     break;
 
-  case 60: /* type: STRING_T  */
-#line 543 "yacc_sql.y"
+  case 64: /* type: STRING_T  */
+#line 595 "yacc_sql.y"
                { (yyval.number)=CHARS; }
-#line 2293 "yacc_sql.cpp"
+#line 2363 "yacc_sql.cpp"
     break;
 
-  case 61: /* type: FLOAT_T  */
-#line 544 "yacc_sql.y"
+  case 65: /* type: FLOAT_T  */
+#line 596 "yacc_sql.y"
                { (yyval.number)=FLOATS; }
-#line 2299 "yacc_sql.cpp"
+#line 2369 "yacc_sql.cpp"
     break;
 
-  case 62: /* type: DATE_T  */
-#line 545 "yacc_sql.y"
+  case 66: /* type: DATE_T  */
+#line 597 "yacc_sql.y"
                { (yyval.number)=DATES; }
-#line 2305 "yacc_sql.cpp"
+#line 2375 "yacc_sql.cpp"
     break;
 
-  case 63: /* type: TEXT_T  */
-#line 546 "yacc_sql.y"
+  case 67: /* type: TEXT_T  */
+#line 598 "yacc_sql.y"
                { (yyval.number)=TEXTS; }
-#line 2311 "yacc_sql.cpp"
+#line 2381 "yacc_sql.cpp"
     break;
 
-  case 64: /* insert_stmt: INSERT INTO id brace_id_list VALUES record record_list  */
-#line 551 "yacc_sql.y"
+  case 68: /* insert_stmt: INSERT INTO id brace_id_list VALUES record record_list  */
+#line 603 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       auto *insertion = new InsertSqlNode;
@@ -2330,19 +2400,19 @@ yyreduce:
         delete (yyvsp[-3].id_list);
       }
     }
-#line 2334 "yacc_sql.cpp"
+#line 2404 "yacc_sql.cpp"
     break;
 
-  case 65: /* record_list: %empty  */
-#line 572 "yacc_sql.y"
+  case 69: /* record_list: %empty  */
+#line 624 "yacc_sql.y"
     {
       (yyval.record_list) = nullptr;
     }
-#line 2342 "yacc_sql.cpp"
+#line 2412 "yacc_sql.cpp"
     break;
 
-  case 66: /* record_list: COMMA record record_list  */
-#line 575 "yacc_sql.y"
+  case 70: /* record_list: COMMA record record_list  */
+#line 627 "yacc_sql.y"
                                {
       if ((yyvsp[0].record_list) != nullptr) {
         (yyval.record_list) = (yyvsp[0].record_list);
@@ -2352,11 +2422,11 @@ yyreduce:
       (yyval.record_list)->emplace_back(*(yyvsp[-1].expression_list));
       delete (yyvsp[-1].expression_list);
     }
-#line 2356 "yacc_sql.cpp"
+#line 2426 "yacc_sql.cpp"
     break;
 
-  case 67: /* record: LBRACE expression_list_empty RBRACE  */
-#line 587 "yacc_sql.y"
+  case 71: /* record: LBRACE expression_list_empty RBRACE  */
+#line 639 "yacc_sql.y"
     {
       if ((yyvsp[-1].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[-1].expression_list);
@@ -2365,58 +2435,58 @@ yyreduce:
       }
       reverse((yyval.expression_list)->begin(), (yyval.expression_list)->end());
     }
-#line 2369 "yacc_sql.cpp"
+#line 2439 "yacc_sql.cpp"
     break;
 
-  case 68: /* value: NUMBER  */
-#line 597 "yacc_sql.y"
+  case 72: /* value: NUMBER  */
+#line 649 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2378 "yacc_sql.cpp"
+#line 2448 "yacc_sql.cpp"
     break;
 
-  case 69: /* value: FLOAT  */
-#line 601 "yacc_sql.y"
+  case 73: /* value: FLOAT  */
+#line 653 "yacc_sql.y"
            {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2387 "yacc_sql.cpp"
+#line 2457 "yacc_sql.cpp"
     break;
 
-  case 70: /* value: SSS  */
-#line 605 "yacc_sql.y"
+  case 74: /* value: SSS  */
+#line 657 "yacc_sql.y"
          {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
     }
-#line 2397 "yacc_sql.cpp"
+#line 2467 "yacc_sql.cpp"
     break;
 
-  case 71: /* value: NULL_V  */
-#line 610 "yacc_sql.y"
+  case 75: /* value: NULL_V  */
+#line 662 "yacc_sql.y"
              {
       (yyval.value) = new Value;
       (yyval.value)->set_null();
     }
-#line 2406 "yacc_sql.cpp"
+#line 2476 "yacc_sql.cpp"
     break;
 
-  case 72: /* value_expr: value  */
-#line 617 "yacc_sql.y"
+  case 76: /* value_expr: value  */
+#line 669 "yacc_sql.y"
           {
       (yyval.value_expr) = new ValueExprSqlNode;
       (yyval.value_expr)->value = *(yyvsp[0].value);
       delete (yyvsp[0].value);
     }
-#line 2416 "yacc_sql.cpp"
+#line 2486 "yacc_sql.cpp"
     break;
 
-  case 73: /* delete_stmt: DELETE FROM id where  */
-#line 625 "yacc_sql.y"
+  case 77: /* delete_stmt: DELETE FROM id where  */
+#line 677 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       auto *deletion = new DeleteSqlNode;
@@ -2425,11 +2495,11 @@ yyreduce:
       deletion->conditions = (yyvsp[0].conjunction);
       free((yyvsp[-1].string));
     }
-#line 2429 "yacc_sql.cpp"
+#line 2499 "yacc_sql.cpp"
     break;
 
-  case 74: /* update_stmt: UPDATE id SET update_set_list where  */
-#line 637 "yacc_sql.y"
+  case 78: /* update_stmt: UPDATE id SET update_set_list where  */
+#line 689 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       auto *update = new UpdateSqlNode;
@@ -2440,39 +2510,39 @@ yyreduce:
       update->conditions = (yyvsp[0].conjunction);
       free((yyvsp[-3].string));
     }
-#line 2444 "yacc_sql.cpp"
+#line 2514 "yacc_sql.cpp"
     break;
 
-  case 75: /* update_set_list: update_set  */
-#line 651 "yacc_sql.y"
+  case 79: /* update_set_list: update_set  */
+#line 703 "yacc_sql.y"
     {
       (yyval.update_set_list) = new std::vector<UpdateSetSqlNode *>(1, (yyvsp[0].update_set));
     }
-#line 2452 "yacc_sql.cpp"
+#line 2522 "yacc_sql.cpp"
     break;
 
-  case 76: /* update_set_list: update_set COMMA update_set_list  */
-#line 654 "yacc_sql.y"
+  case 80: /* update_set_list: update_set COMMA update_set_list  */
+#line 706 "yacc_sql.y"
                                        {
       (yyval.update_set_list) = (yyvsp[0].update_set_list);
       (yyval.update_set_list)->push_back((yyvsp[-2].update_set));
     }
-#line 2461 "yacc_sql.cpp"
+#line 2531 "yacc_sql.cpp"
     break;
 
-  case 77: /* update_set: id EQ expression  */
-#line 660 "yacc_sql.y"
+  case 81: /* update_set: id EQ expression  */
+#line 712 "yacc_sql.y"
                      {
       (yyval.update_set) = new UpdateSetSqlNode;
       (yyval.update_set)->field_name = (yyvsp[-2].string);
       free((yyvsp[-2].string));
       (yyval.update_set)->expr = (yyvsp[0].expression);
     }
-#line 2472 "yacc_sql.cpp"
+#line 2542 "yacc_sql.cpp"
     break;
 
-  case 78: /* select_stmt: SELECT select_attr_list from where groupby having orderby  */
-#line 669 "yacc_sql.y"
+  case 82: /* select_stmt: SELECT select_attr_list from where groupby having orderby  */
+#line 721 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       auto* selection = new SelectSqlNode;
@@ -2498,35 +2568,35 @@ yyreduce:
       selection->having_conditions=(yyvsp[-1].conjunction);
       selection->sql = token_name(sql_string, &(yyloc));
     }
-#line 2502 "yacc_sql.cpp"
+#line 2572 "yacc_sql.cpp"
     break;
 
-  case 79: /* from: %empty  */
-#line 697 "yacc_sql.y"
+  case 83: /* from: %empty  */
+#line 749 "yacc_sql.y"
     {
       (yyval.join) = nullptr;
     }
-#line 2510 "yacc_sql.cpp"
+#line 2580 "yacc_sql.cpp"
     break;
 
-  case 80: /* from: FROM rel_list  */
-#line 700 "yacc_sql.y"
+  case 84: /* from: FROM rel_list  */
+#line 752 "yacc_sql.y"
                     {
       (yyval.join) = (yyvsp[0].join);
     }
-#line 2518 "yacc_sql.cpp"
+#line 2588 "yacc_sql.cpp"
     break;
 
-  case 81: /* from: FROM joined_tables  */
-#line 703 "yacc_sql.y"
+  case 85: /* from: FROM joined_tables  */
+#line 755 "yacc_sql.y"
                          {
       (yyval.join) = (yyvsp[0].join);
     }
-#line 2526 "yacc_sql.cpp"
+#line 2596 "yacc_sql.cpp"
     break;
 
-  case 82: /* joined_tables: joined_tables_inner INNER JOIN id as_info joined_on  */
-#line 709 "yacc_sql.y"
+  case 86: /* joined_tables: joined_tables_inner INNER JOIN id as_info joined_on  */
+#line 761 "yacc_sql.y"
                                                         {
       (yyval.join) = new JoinSqlNode;
       (yyval.join)->relation=(yyvsp[-2].string);
@@ -2536,21 +2606,21 @@ yyreduce:
       (yyval.join)->sub_join=(yyvsp[-5].join);
       (yyval.join)->join_conditions=(yyvsp[0].conjunction);  
     }
-#line 2540 "yacc_sql.cpp"
+#line 2610 "yacc_sql.cpp"
     break;
 
-  case 83: /* joined_tables_inner: id  */
-#line 720 "yacc_sql.y"
+  case 87: /* joined_tables_inner: id  */
+#line 772 "yacc_sql.y"
        {
       (yyval.join) = new JoinSqlNode;
       (yyval.join)->relation = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2550 "yacc_sql.cpp"
+#line 2620 "yacc_sql.cpp"
     break;
 
-  case 84: /* joined_tables_inner: joined_tables_inner INNER JOIN id as_info joined_on  */
-#line 725 "yacc_sql.y"
+  case 88: /* joined_tables_inner: joined_tables_inner INNER JOIN id as_info joined_on  */
+#line 777 "yacc_sql.y"
                                                           {
       (yyval.join) = new JoinSqlNode;
       (yyval.join)->relation=(yyvsp[-2].string);
@@ -2560,43 +2630,43 @@ yyreduce:
       if(*(yyvsp[-1].string)) free((yyvsp[-1].string));
       (yyval.join)->join_conditions=(yyvsp[0].conjunction);  
     }
-#line 2564 "yacc_sql.cpp"
+#line 2634 "yacc_sql.cpp"
     break;
 
-  case 85: /* joined_on: ON conjunction  */
-#line 736 "yacc_sql.y"
+  case 89: /* joined_on: ON conjunction  */
+#line 788 "yacc_sql.y"
                    {
       (yyval.conjunction) = (yyvsp[0].conjunction);
     }
-#line 2572 "yacc_sql.cpp"
+#line 2642 "yacc_sql.cpp"
     break;
 
-  case 86: /* having: %empty  */
-#line 741 "yacc_sql.y"
+  case 90: /* having: %empty  */
+#line 793 "yacc_sql.y"
     {
       (yyval.conjunction) = nullptr;
     }
-#line 2580 "yacc_sql.cpp"
+#line 2650 "yacc_sql.cpp"
     break;
 
-  case 87: /* having: HAVING conjunction  */
-#line 744 "yacc_sql.y"
+  case 91: /* having: HAVING conjunction  */
+#line 796 "yacc_sql.y"
                          {
       (yyval.conjunction) = (yyvsp[0].conjunction);
     }
-#line 2588 "yacc_sql.cpp"
+#line 2658 "yacc_sql.cpp"
     break;
 
-  case 88: /* groupby: %empty  */
-#line 750 "yacc_sql.y"
+  case 92: /* groupby: %empty  */
+#line 802 "yacc_sql.y"
     {
       (yyval.rel_attr_list) = nullptr;
     }
-#line 2596 "yacc_sql.cpp"
+#line 2666 "yacc_sql.cpp"
     break;
 
-  case 89: /* groupby: GROUP BY rel_attr rel_attr_list  */
-#line 754 "yacc_sql.y"
+  case 93: /* groupby: GROUP BY rel_attr rel_attr_list  */
+#line 806 "yacc_sql.y"
     {
       (yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
       if ((yyval.rel_attr_list) == nullptr) {
@@ -2605,88 +2675,88 @@ yyreduce:
       (yyval.rel_attr_list)->push_back((yyvsp[-1].rel_attr));
       std::reverse((yyval.rel_attr_list)->begin(), (yyval.rel_attr_list)->end());
     }
-#line 2609 "yacc_sql.cpp"
+#line 2679 "yacc_sql.cpp"
     break;
 
-  case 90: /* orderby: %empty  */
-#line 764 "yacc_sql.y"
+  case 94: /* orderby: %empty  */
+#line 816 "yacc_sql.y"
     {
       (yyval.order_unit_list) = nullptr;
     }
-#line 2617 "yacc_sql.cpp"
+#line 2687 "yacc_sql.cpp"
     break;
 
-  case 91: /* orderby: ORDER BY order_unit_list  */
-#line 767 "yacc_sql.y"
+  case 95: /* orderby: ORDER BY order_unit_list  */
+#line 819 "yacc_sql.y"
                                {
       (yyval.order_unit_list) = (yyvsp[0].order_unit_list);
       std::reverse((yyval.order_unit_list)->begin(), (yyval.order_unit_list)->end());
     }
-#line 2626 "yacc_sql.cpp"
+#line 2696 "yacc_sql.cpp"
     break;
 
-  case 92: /* order_unit_list: order_unit  */
-#line 774 "yacc_sql.y"
+  case 96: /* order_unit_list: order_unit  */
+#line 826 "yacc_sql.y"
     {
       (yyval.order_unit_list) = new std::vector<OrderBySqlNode *>();
       (yyval.order_unit_list)->push_back((yyvsp[0].order_unit));
     }
-#line 2635 "yacc_sql.cpp"
+#line 2705 "yacc_sql.cpp"
     break;
 
-  case 93: /* order_unit_list: order_unit COMMA order_unit_list  */
-#line 779 "yacc_sql.y"
+  case 97: /* order_unit_list: order_unit COMMA order_unit_list  */
+#line 831 "yacc_sql.y"
     {
       (yyval.order_unit_list) = (yyvsp[0].order_unit_list);
       (yyval.order_unit_list)->push_back((yyvsp[-2].order_unit));
     }
-#line 2644 "yacc_sql.cpp"
+#line 2714 "yacc_sql.cpp"
     break;
 
-  case 94: /* order_unit: rel_attr order  */
-#line 785 "yacc_sql.y"
+  case 98: /* order_unit: rel_attr order  */
+#line 837 "yacc_sql.y"
                    {
       (yyval.order_unit) = new OrderBySqlNode;
       (yyval.order_unit)->field = (yyvsp[-1].rel_attr);
       (yyval.order_unit)->order = (yyvsp[0].order);
     }
-#line 2654 "yacc_sql.cpp"
+#line 2724 "yacc_sql.cpp"
     break;
 
-  case 95: /* order: %empty  */
-#line 792 "yacc_sql.y"
+  case 99: /* order: %empty  */
+#line 844 "yacc_sql.y"
     {
       (yyval.order) = Order::ASC;
     }
-#line 2662 "yacc_sql.cpp"
+#line 2732 "yacc_sql.cpp"
     break;
 
-  case 96: /* order: ASC  */
-#line 795 "yacc_sql.y"
+  case 100: /* order: ASC  */
+#line 847 "yacc_sql.y"
           {
       (yyval.order) = Order::ASC;
     }
-#line 2670 "yacc_sql.cpp"
+#line 2740 "yacc_sql.cpp"
     break;
 
-  case 97: /* order: DESC  */
-#line 798 "yacc_sql.y"
+  case 101: /* order: DESC  */
+#line 850 "yacc_sql.y"
            {
       (yyval.order) = Order::DESC;
     }
-#line 2678 "yacc_sql.cpp"
+#line 2748 "yacc_sql.cpp"
     break;
 
-  case 98: /* rel_attr_list: %empty  */
-#line 803 "yacc_sql.y"
+  case 102: /* rel_attr_list: %empty  */
+#line 855 "yacc_sql.y"
     {
       (yyval.rel_attr_list) = nullptr;
     }
-#line 2686 "yacc_sql.cpp"
+#line 2756 "yacc_sql.cpp"
     break;
 
-  case 99: /* rel_attr_list: COMMA rel_attr rel_attr_list  */
-#line 807 "yacc_sql.y"
+  case 103: /* rel_attr_list: COMMA rel_attr rel_attr_list  */
+#line 859 "yacc_sql.y"
     {
       (yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
       if ((yyval.rel_attr_list) == nullptr) {
@@ -2694,11 +2764,11 @@ yyreduce:
       }
       (yyval.rel_attr_list)->push_back((yyvsp[-1].rel_attr));
     }
-#line 2698 "yacc_sql.cpp"
+#line 2768 "yacc_sql.cpp"
     break;
 
-  case 100: /* calc_stmt: CALC expression_list  */
-#line 817 "yacc_sql.y"
+  case 104: /* calc_stmt: CALC expression_list  */
+#line 869 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       auto *tmp = new CalcSqlNode;
@@ -2707,20 +2777,20 @@ yyreduce:
       tmp->expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 2711 "yacc_sql.cpp"
+#line 2781 "yacc_sql.cpp"
     break;
 
-  case 101: /* expression_list: expression  */
-#line 829 "yacc_sql.y"
+  case 105: /* expression_list: expression  */
+#line 881 "yacc_sql.y"
     {
       (yyval.expression_list) = new std::vector<ExprSqlNode *>;
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2720 "yacc_sql.cpp"
+#line 2790 "yacc_sql.cpp"
     break;
 
-  case 102: /* expression_list: expression COMMA expression_list  */
-#line 834 "yacc_sql.y"
+  case 106: /* expression_list: expression COMMA expression_list  */
+#line 886 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2729,102 +2799,102 @@ yyreduce:
       }
       (yyval.expression_list)->emplace_back((yyvsp[-2].expression));
     }
-#line 2733 "yacc_sql.cpp"
+#line 2803 "yacc_sql.cpp"
     break;
 
-  case 103: /* expression_list_empty: %empty  */
-#line 845 "yacc_sql.y"
+  case 107: /* expression_list_empty: %empty  */
+#line 897 "yacc_sql.y"
     {
       (yyval.expression_list) = nullptr;
     }
-#line 2741 "yacc_sql.cpp"
+#line 2811 "yacc_sql.cpp"
     break;
 
-  case 104: /* expression_list_empty: expression_list  */
-#line 848 "yacc_sql.y"
+  case 108: /* expression_list_empty: expression_list  */
+#line 900 "yacc_sql.y"
                       {
       (yyval.expression_list) = (yyvsp[0].expression_list);
     }
-#line 2749 "yacc_sql.cpp"
+#line 2819 "yacc_sql.cpp"
     break;
 
-  case 105: /* expression: expression '+' expression  */
-#line 853 "yacc_sql.y"
+  case 109: /* expression: expression '+' expression  */
+#line 905 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticType::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2757 "yacc_sql.cpp"
+#line 2827 "yacc_sql.cpp"
     break;
 
-  case 106: /* expression: expression '-' expression  */
-#line 856 "yacc_sql.y"
+  case 110: /* expression: expression '-' expression  */
+#line 908 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticType::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2765 "yacc_sql.cpp"
+#line 2835 "yacc_sql.cpp"
     break;
 
-  case 107: /* expression: expression '*' expression  */
-#line 859 "yacc_sql.y"
+  case 111: /* expression: expression '*' expression  */
+#line 911 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticType::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2773 "yacc_sql.cpp"
+#line 2843 "yacc_sql.cpp"
     break;
 
-  case 108: /* expression: expression '/' expression  */
-#line 862 "yacc_sql.y"
+  case 112: /* expression: expression '/' expression  */
+#line 914 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticType::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2781 "yacc_sql.cpp"
+#line 2851 "yacc_sql.cpp"
     break;
 
-  case 109: /* expression: LBRACE expression RBRACE  */
-#line 865 "yacc_sql.y"
+  case 113: /* expression: LBRACE expression RBRACE  */
+#line 917 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2790 "yacc_sql.cpp"
+#line 2860 "yacc_sql.cpp"
     break;
 
-  case 110: /* expression: '-' expression  */
-#line 869 "yacc_sql.y"
+  case 114: /* expression: '-' expression  */
+#line 921 "yacc_sql.y"
                                   {
       (yyval.expression) = create_arithmetic_expression(ArithmeticType::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2798 "yacc_sql.cpp"
+#line 2868 "yacc_sql.cpp"
     break;
 
-  case 111: /* expression: '*'  */
-#line 872 "yacc_sql.y"
+  case 115: /* expression: '*'  */
+#line 924 "yacc_sql.y"
           {
       (yyval.expression) = new ExprSqlNode(new StarExprSqlNode);
     }
-#line 2806 "yacc_sql.cpp"
+#line 2876 "yacc_sql.cpp"
     break;
 
-  case 112: /* expression: rel_attr  */
-#line 875 "yacc_sql.y"
+  case 116: /* expression: rel_attr  */
+#line 927 "yacc_sql.y"
                {
       (yyval.expression) = new ExprSqlNode((yyvsp[0].rel_attr));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2815 "yacc_sql.cpp"
+#line 2885 "yacc_sql.cpp"
     break;
 
-  case 113: /* expression: value_expr  */
-#line 879 "yacc_sql.y"
+  case 117: /* expression: value_expr  */
+#line 931 "yacc_sql.y"
                  {
       (yyval.expression) = new ExprSqlNode((yyvsp[0].value_expr));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2824 "yacc_sql.cpp"
+#line 2894 "yacc_sql.cpp"
     break;
 
-  case 114: /* expression: aggr_op LBRACE expression_list_empty RBRACE  */
-#line 883 "yacc_sql.y"
+  case 118: /* expression: aggr_op LBRACE expression_list_empty RBRACE  */
+#line 935 "yacc_sql.y"
                                                   {
       std::string name = token_name(sql_string, &(yyloc));
       if ((yyvsp[-1].expression_list)) {
@@ -2834,11 +2904,11 @@ yyreduce:
       }
       (yyval.expression)->set_name(name);
     }
-#line 2838 "yacc_sql.cpp"
+#line 2908 "yacc_sql.cpp"
     break;
 
-  case 115: /* expression: func_op LBRACE expression_list_empty RBRACE  */
-#line 892 "yacc_sql.y"
+  case 119: /* expression: func_op LBRACE expression_list_empty RBRACE  */
+#line 944 "yacc_sql.y"
                                                   {
       std::string name = token_name(sql_string, &(yyloc));
       reverse((yyvsp[-1].expression_list)->begin(), (yyvsp[-1].expression_list)->end());
@@ -2846,114 +2916,114 @@ yyreduce:
       delete (yyvsp[-1].expression_list);
       (yyval.expression)->set_name(name);
     }
-#line 2850 "yacc_sql.cpp"
+#line 2920 "yacc_sql.cpp"
     break;
 
-  case 116: /* expression: list_expr  */
-#line 899 "yacc_sql.y"
+  case 120: /* expression: list_expr  */
+#line 951 "yacc_sql.y"
                 {
       (yyval.expression) = new ExprSqlNode((yyvsp[0].list));
       std::string name = token_name(sql_string, &(yyloc));
       (yyval.expression)->set_name(name);
     }
-#line 2860 "yacc_sql.cpp"
+#line 2930 "yacc_sql.cpp"
     break;
 
-  case 117: /* expression: set_expr  */
-#line 904 "yacc_sql.y"
+  case 121: /* expression: set_expr  */
+#line 956 "yacc_sql.y"
                {
       (yyval.expression) = new ExprSqlNode((yyvsp[0].set));
       std::string name = token_name(sql_string, &(yyloc));
       (yyval.expression)->set_name(name);
     }
-#line 2870 "yacc_sql.cpp"
+#line 2940 "yacc_sql.cpp"
     break;
 
-  case 118: /* select_attr_list: select_attr  */
-#line 912 "yacc_sql.y"
+  case 122: /* select_attr_list: select_attr  */
+#line 964 "yacc_sql.y"
                 {
       (yyval.select_attr_list) = new std::vector<SelectAttribute *>(1, (yyvsp[0].select_attr));
     }
-#line 2878 "yacc_sql.cpp"
+#line 2948 "yacc_sql.cpp"
     break;
 
-  case 119: /* select_attr_list: select_attr COMMA select_attr_list  */
-#line 915 "yacc_sql.y"
+  case 123: /* select_attr_list: select_attr COMMA select_attr_list  */
+#line 967 "yacc_sql.y"
                                          {
       (yyvsp[0].select_attr_list)->push_back((yyvsp[-2].select_attr));
       (yyval.select_attr_list) = (yyvsp[0].select_attr_list);
     }
-#line 2887 "yacc_sql.cpp"
+#line 2957 "yacc_sql.cpp"
     break;
 
-  case 120: /* select_attr: expression as_info  */
-#line 922 "yacc_sql.y"
+  case 124: /* select_attr: expression as_info  */
+#line 974 "yacc_sql.y"
                        {
       (yyval.select_attr) = new SelectAttribute;
       (yyval.select_attr)->expr = (yyvsp[-1].expression);
       (yyval.select_attr)->alias = (yyvsp[0].string);
       if(*(yyvsp[0].string)) free((yyvsp[0].string));
     }
-#line 2898 "yacc_sql.cpp"
+#line 2968 "yacc_sql.cpp"
     break;
 
-  case 121: /* as_info: %empty  */
-#line 930 "yacc_sql.y"
+  case 125: /* as_info: %empty  */
+#line 982 "yacc_sql.y"
     {
       (yyval.string) = "";
     }
-#line 2906 "yacc_sql.cpp"
+#line 2976 "yacc_sql.cpp"
     break;
 
-  case 122: /* as_info: id  */
-#line 933 "yacc_sql.y"
+  case 126: /* as_info: id  */
+#line 985 "yacc_sql.y"
          {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2914 "yacc_sql.cpp"
+#line 2984 "yacc_sql.cpp"
     break;
 
-  case 123: /* as_info: AS id  */
-#line 936 "yacc_sql.y"
+  case 127: /* as_info: AS id  */
+#line 988 "yacc_sql.y"
             {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2922 "yacc_sql.cpp"
+#line 2992 "yacc_sql.cpp"
     break;
 
-  case 124: /* list_expr: LBRACE select_stmt RBRACE  */
-#line 941 "yacc_sql.y"
+  case 128: /* list_expr: LBRACE select_stmt RBRACE  */
+#line 993 "yacc_sql.y"
                               {
       (yyval.list) = new ListExprSqlNode((yyvsp[-1].sql_node)->node.selection);
       (yyvsp[-1].sql_node)->node.selection = nullptr;
       delete (yyvsp[-1].sql_node);
     }
-#line 2932 "yacc_sql.cpp"
+#line 3002 "yacc_sql.cpp"
     break;
 
-  case 125: /* set_expr: LBRACE expression COMMA expression_list RBRACE  */
-#line 949 "yacc_sql.y"
+  case 129: /* set_expr: LBRACE expression COMMA expression_list RBRACE  */
+#line 1001 "yacc_sql.y"
                                                    {
       (yyvsp[-1].expression_list)->push_back((yyvsp[-3].expression));
       (yyval.set) = new SetExprSqlNode();
       (yyval.set)->expressions.swap(*(yyvsp[-1].expression_list));
       delete (yyvsp[-1].expression_list);
     }
-#line 2943 "yacc_sql.cpp"
+#line 3013 "yacc_sql.cpp"
     break;
 
-  case 126: /* rel_attr: id  */
-#line 958 "yacc_sql.y"
+  case 130: /* rel_attr: id  */
+#line 1010 "yacc_sql.y"
        {
       (yyval.rel_attr) = new FieldExprSqlNode;
       (yyval.rel_attr)->field_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2953 "yacc_sql.cpp"
+#line 3023 "yacc_sql.cpp"
     break;
 
-  case 127: /* rel_attr: id DOT id  */
-#line 963 "yacc_sql.y"
+  case 131: /* rel_attr: id DOT id  */
+#line 1015 "yacc_sql.y"
                 {
       (yyval.rel_attr) = new FieldExprSqlNode;
       (yyval.rel_attr)->table_name  = (yyvsp[-2].string);
@@ -2961,22 +3031,22 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2965 "yacc_sql.cpp"
+#line 3035 "yacc_sql.cpp"
     break;
 
-  case 128: /* rel_attr: id DOT '*'  */
-#line 970 "yacc_sql.y"
+  case 132: /* rel_attr: id DOT '*'  */
+#line 1022 "yacc_sql.y"
                  {
       (yyval.rel_attr) = new FieldExprSqlNode;
       (yyval.rel_attr)->table_name  = (yyvsp[-2].string);
       (yyval.rel_attr)->field_name = "*";
       free((yyvsp[-2].string));
     }
-#line 2976 "yacc_sql.cpp"
+#line 3046 "yacc_sql.cpp"
     break;
 
-  case 129: /* rel_list: id as_info  */
-#line 980 "yacc_sql.y"
+  case 133: /* rel_list: id as_info  */
+#line 1032 "yacc_sql.y"
                {
       (yyval.join) = new JoinSqlNode;
       (yyval.join)->relation = (yyvsp[-1].string);
@@ -2984,11 +3054,11 @@ yyreduce:
       if(*(yyvsp[0].string)) free((yyvsp[0].string));
       free((yyvsp[-1].string));
     }
-#line 2988 "yacc_sql.cpp"
+#line 3058 "yacc_sql.cpp"
     break;
 
-  case 130: /* rel_list: rel_list COMMA id as_info  */
-#line 987 "yacc_sql.y"
+  case 134: /* rel_list: rel_list COMMA id as_info  */
+#line 1039 "yacc_sql.y"
                                 {
       (yyval.join) = new JoinSqlNode;
       (yyval.join)->relation = (yyvsp[-1].string);
@@ -2997,256 +3067,256 @@ yyreduce:
       if(*(yyvsp[0].string)) free((yyvsp[0].string));
       (yyval.join)->sub_join = (yyvsp[-3].join);
     }
-#line 3001 "yacc_sql.cpp"
+#line 3071 "yacc_sql.cpp"
     break;
 
-  case 131: /* where: %empty  */
-#line 999 "yacc_sql.y"
+  case 135: /* where: %empty  */
+#line 1051 "yacc_sql.y"
     {
       (yyval.conjunction) = nullptr;
     }
-#line 3009 "yacc_sql.cpp"
+#line 3079 "yacc_sql.cpp"
     break;
 
-  case 132: /* where: WHERE conjunction  */
-#line 1002 "yacc_sql.y"
+  case 136: /* where: WHERE conjunction  */
+#line 1054 "yacc_sql.y"
                         {
       (yyval.conjunction) = (yyvsp[0].conjunction);  
     }
-#line 3017 "yacc_sql.cpp"
+#line 3087 "yacc_sql.cpp"
     break;
 
-  case 133: /* conjunction: %empty  */
-#line 1008 "yacc_sql.y"
+  case 137: /* conjunction: %empty  */
+#line 1060 "yacc_sql.y"
     {
       (yyval.conjunction) = nullptr;
     }
-#line 3025 "yacc_sql.cpp"
+#line 3095 "yacc_sql.cpp"
     break;
 
-  case 134: /* conjunction: contain  */
-#line 1011 "yacc_sql.y"
+  case 138: /* conjunction: contain  */
+#line 1063 "yacc_sql.y"
               {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::SINGLE, (yyvsp[0].contain), static_cast<ExprSqlNode *>(nullptr));
     }
-#line 3033 "yacc_sql.cpp"
+#line 3103 "yacc_sql.cpp"
     break;
 
-  case 135: /* conjunction: condition  */
-#line 1014 "yacc_sql.y"
+  case 139: /* conjunction: condition  */
+#line 1066 "yacc_sql.y"
                 {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::SINGLE, (yyvsp[0].condition), static_cast<ExprSqlNode *>(nullptr));
     }
-#line 3041 "yacc_sql.cpp"
+#line 3111 "yacc_sql.cpp"
     break;
 
-  case 136: /* conjunction: expression like_op SSS  */
-#line 1017 "yacc_sql.y"
+  case 140: /* conjunction: expression like_op SSS  */
+#line 1069 "yacc_sql.y"
                              {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::SINGLE, new LikeExprSqlNode((yyvsp[-1].bools), (yyvsp[-2].expression), (yyvsp[0].string)), static_cast<ExprSqlNode *>(nullptr));
       free((yyvsp[0].string));
     }
-#line 3050 "yacc_sql.cpp"
+#line 3120 "yacc_sql.cpp"
     break;
 
-  case 137: /* conjunction: exists  */
-#line 1021 "yacc_sql.y"
+  case 141: /* conjunction: exists  */
+#line 1073 "yacc_sql.y"
              {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::SINGLE, (yyvsp[0].exists), static_cast<ExprSqlNode *>(nullptr));
     }
-#line 3058 "yacc_sql.cpp"
+#line 3128 "yacc_sql.cpp"
     break;
 
-  case 138: /* conjunction: expression null_check  */
-#line 1024 "yacc_sql.y"
+  case 142: /* conjunction: expression null_check  */
+#line 1076 "yacc_sql.y"
                             {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::SINGLE, new NullCheckExprSqlNode((yyvsp[0].bools), (yyvsp[-1].expression)), static_cast<ExprSqlNode *>(nullptr));
     }
-#line 3066 "yacc_sql.cpp"
+#line 3136 "yacc_sql.cpp"
     break;
 
-  case 139: /* conjunction: conjunction AND conjunction  */
-#line 1027 "yacc_sql.y"
+  case 143: /* conjunction: conjunction AND conjunction  */
+#line 1079 "yacc_sql.y"
                                   {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::AND, (yyvsp[-2].conjunction), (yyvsp[0].conjunction));
     }
-#line 3074 "yacc_sql.cpp"
+#line 3144 "yacc_sql.cpp"
     break;
 
-  case 140: /* conjunction: conjunction OR conjunction  */
-#line 1030 "yacc_sql.y"
+  case 144: /* conjunction: conjunction OR conjunction  */
+#line 1082 "yacc_sql.y"
                                  {
       (yyval.conjunction) = new ConjunctionExprSqlNode(ConjunctionType::OR, (yyvsp[-2].conjunction), (yyvsp[0].conjunction));
     }
-#line 3082 "yacc_sql.cpp"
+#line 3152 "yacc_sql.cpp"
     break;
 
-  case 141: /* null_check: IS NULL_V  */
-#line 1036 "yacc_sql.y"
+  case 145: /* null_check: IS NULL_V  */
+#line 1088 "yacc_sql.y"
               {
       (yyval.bools) = true;
     }
-#line 3090 "yacc_sql.cpp"
+#line 3160 "yacc_sql.cpp"
     break;
 
-  case 142: /* null_check: IS NOT NULL_V  */
-#line 1039 "yacc_sql.y"
+  case 146: /* null_check: IS NOT NULL_V  */
+#line 1091 "yacc_sql.y"
                     {
       (yyval.bools) = false;
     }
-#line 3098 "yacc_sql.cpp"
+#line 3168 "yacc_sql.cpp"
     break;
 
-  case 143: /* condition: expression comp_op expression  */
-#line 1044 "yacc_sql.y"
+  case 147: /* condition: expression comp_op expression  */
+#line 1096 "yacc_sql.y"
                                   {
       (yyval.condition) = new ComparisonExprSqlNode((yyvsp[-1].comp), (yyvsp[-2].expression), (yyvsp[0].expression)); 
     }
-#line 3106 "yacc_sql.cpp"
+#line 3176 "yacc_sql.cpp"
     break;
 
-  case 144: /* contain: expression contain_op expression  */
-#line 1050 "yacc_sql.y"
+  case 148: /* contain: expression contain_op expression  */
+#line 1102 "yacc_sql.y"
                                      {
       (yyval.contain) = new ContainExprSqlNode((yyvsp[-1].contain_op), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 3114 "yacc_sql.cpp"
+#line 3184 "yacc_sql.cpp"
     break;
 
-  case 145: /* exists: exists_op expression  */
-#line 1056 "yacc_sql.y"
+  case 149: /* exists: exists_op expression  */
+#line 1108 "yacc_sql.y"
                          {
       (yyval.exists) = new ExistsExprSqlNode((yyvsp[-1].bools), (yyvsp[0].expression));
     }
-#line 3122 "yacc_sql.cpp"
+#line 3192 "yacc_sql.cpp"
     break;
 
-  case 146: /* exists_op: EXISTS  */
-#line 1061 "yacc_sql.y"
+  case 150: /* exists_op: EXISTS  */
+#line 1113 "yacc_sql.y"
            {
       (yyval.bools) = true;
     }
-#line 3130 "yacc_sql.cpp"
+#line 3200 "yacc_sql.cpp"
     break;
 
-  case 147: /* exists_op: NOT EXISTS  */
-#line 1064 "yacc_sql.y"
+  case 151: /* exists_op: NOT EXISTS  */
+#line 1116 "yacc_sql.y"
                  {
       (yyval.bools) = false;
     }
-#line 3138 "yacc_sql.cpp"
+#line 3208 "yacc_sql.cpp"
     break;
 
-  case 148: /* comp_op: EQ  */
-#line 1069 "yacc_sql.y"
+  case 152: /* comp_op: EQ  */
+#line 1121 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 3144 "yacc_sql.cpp"
+#line 3214 "yacc_sql.cpp"
     break;
 
-  case 149: /* comp_op: LT  */
-#line 1070 "yacc_sql.y"
+  case 153: /* comp_op: LT  */
+#line 1122 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 3150 "yacc_sql.cpp"
+#line 3220 "yacc_sql.cpp"
     break;
 
-  case 150: /* comp_op: GT  */
-#line 1071 "yacc_sql.y"
+  case 154: /* comp_op: GT  */
+#line 1123 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 3156 "yacc_sql.cpp"
+#line 3226 "yacc_sql.cpp"
     break;
 
-  case 151: /* comp_op: LE  */
-#line 1072 "yacc_sql.y"
+  case 155: /* comp_op: LE  */
+#line 1124 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 3162 "yacc_sql.cpp"
+#line 3232 "yacc_sql.cpp"
     break;
 
-  case 152: /* comp_op: GE  */
-#line 1073 "yacc_sql.y"
+  case 156: /* comp_op: GE  */
+#line 1125 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 3168 "yacc_sql.cpp"
+#line 3238 "yacc_sql.cpp"
     break;
 
-  case 153: /* comp_op: NE  */
-#line 1074 "yacc_sql.y"
+  case 157: /* comp_op: NE  */
+#line 1126 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 3174 "yacc_sql.cpp"
+#line 3244 "yacc_sql.cpp"
     break;
 
-  case 154: /* contain_op: IN  */
-#line 1078 "yacc_sql.y"
+  case 158: /* contain_op: IN  */
+#line 1130 "yacc_sql.y"
          { (yyval.contain_op) = ContainType::IN; }
-#line 3180 "yacc_sql.cpp"
+#line 3250 "yacc_sql.cpp"
     break;
 
-  case 155: /* contain_op: NOT IN  */
-#line 1079 "yacc_sql.y"
+  case 159: /* contain_op: NOT IN  */
+#line 1131 "yacc_sql.y"
              { (yyval.contain_op) = ContainType::NOT_IN; }
-#line 3186 "yacc_sql.cpp"
+#line 3256 "yacc_sql.cpp"
     break;
 
-  case 156: /* like_op: LIKE  */
-#line 1082 "yacc_sql.y"
+  case 160: /* like_op: LIKE  */
+#line 1134 "yacc_sql.y"
            { (yyval.bools) = true; }
-#line 3192 "yacc_sql.cpp"
+#line 3262 "yacc_sql.cpp"
     break;
 
-  case 157: /* like_op: NOT LIKE  */
-#line 1083 "yacc_sql.y"
+  case 161: /* like_op: NOT LIKE  */
+#line 1135 "yacc_sql.y"
                { (yyval.bools) = false; }
-#line 3198 "yacc_sql.cpp"
+#line 3268 "yacc_sql.cpp"
     break;
 
-  case 158: /* aggr_op: MIN  */
-#line 1086 "yacc_sql.y"
+  case 162: /* aggr_op: MIN  */
+#line 1138 "yacc_sql.y"
           { (yyval.aggr) = AggregationType::AGGR_MIN; }
-#line 3204 "yacc_sql.cpp"
+#line 3274 "yacc_sql.cpp"
     break;
 
-  case 159: /* aggr_op: MAX  */
-#line 1087 "yacc_sql.y"
+  case 163: /* aggr_op: MAX  */
+#line 1139 "yacc_sql.y"
           { (yyval.aggr) = AggregationType::AGGR_MAX; }
-#line 3210 "yacc_sql.cpp"
+#line 3280 "yacc_sql.cpp"
     break;
 
-  case 160: /* aggr_op: AVG  */
-#line 1088 "yacc_sql.y"
+  case 164: /* aggr_op: AVG  */
+#line 1140 "yacc_sql.y"
           { (yyval.aggr) = AggregationType::AGGR_AVG; }
-#line 3216 "yacc_sql.cpp"
+#line 3286 "yacc_sql.cpp"
     break;
 
-  case 161: /* aggr_op: SUM  */
-#line 1089 "yacc_sql.y"
+  case 165: /* aggr_op: SUM  */
+#line 1141 "yacc_sql.y"
           { (yyval.aggr) = AggregationType::AGGR_SUM; }
-#line 3222 "yacc_sql.cpp"
+#line 3292 "yacc_sql.cpp"
     break;
 
-  case 162: /* aggr_op: COUNT  */
-#line 1090 "yacc_sql.y"
+  case 166: /* aggr_op: COUNT  */
+#line 1142 "yacc_sql.y"
             { (yyval.aggr) = AggregationType::AGGR_COUNT; }
-#line 3228 "yacc_sql.cpp"
+#line 3298 "yacc_sql.cpp"
     break;
 
-  case 163: /* func_op: LENGTH  */
-#line 1093 "yacc_sql.y"
+  case 167: /* func_op: LENGTH  */
+#line 1145 "yacc_sql.y"
              { (yyval.func) = FunctionType::LENGTH; }
-#line 3234 "yacc_sql.cpp"
+#line 3304 "yacc_sql.cpp"
     break;
 
-  case 164: /* func_op: ROUND  */
-#line 1094 "yacc_sql.y"
+  case 168: /* func_op: ROUND  */
+#line 1146 "yacc_sql.y"
             { (yyval.func) = FunctionType::ROUND; }
-#line 3240 "yacc_sql.cpp"
+#line 3310 "yacc_sql.cpp"
     break;
 
-  case 165: /* func_op: DATE_FORMAT  */
-#line 1095 "yacc_sql.y"
+  case 169: /* func_op: DATE_FORMAT  */
+#line 1147 "yacc_sql.y"
                   { (yyval.func) = FunctionType::DATE_FORMAT; }
-#line 3246 "yacc_sql.cpp"
+#line 3316 "yacc_sql.cpp"
     break;
 
-  case 166: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE id  */
-#line 1099 "yacc_sql.y"
+  case 170: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE id  */
+#line 1151 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -3258,21 +3328,21 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 3262 "yacc_sql.cpp"
+#line 3332 "yacc_sql.cpp"
     break;
 
-  case 167: /* explain_stmt: EXPLAIN command_wrapper  */
-#line 1114 "yacc_sql.y"
+  case 171: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 1166 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->node.explain = new ExplainSqlNode;
       (yyval.sql_node)->node.explain->sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 3272 "yacc_sql.cpp"
+#line 3342 "yacc_sql.cpp"
     break;
 
-  case 168: /* set_variable_stmt: SET id EQ value  */
-#line 1123 "yacc_sql.y"
+  case 172: /* set_variable_stmt: SET id EQ value  */
+#line 1175 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       auto *set_variable = new SetVariableSqlNode;
@@ -3282,99 +3352,99 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 3286 "yacc_sql.cpp"
+#line 3356 "yacc_sql.cpp"
     break;
 
-  case 171: /* id: non_reserve  */
-#line 1139 "yacc_sql.y"
+  case 175: /* id: non_reserve  */
+#line 1191 "yacc_sql.y"
                 {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 3294 "yacc_sql.cpp"
+#line 3364 "yacc_sql.cpp"
     break;
 
-  case 172: /* id: ID  */
-#line 1142 "yacc_sql.y"
+  case 176: /* id: ID  */
+#line 1194 "yacc_sql.y"
          {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 3302 "yacc_sql.cpp"
+#line 3372 "yacc_sql.cpp"
     break;
 
-  case 173: /* non_reserve: TABLES  */
-#line 1147 "yacc_sql.y"
+  case 177: /* non_reserve: TABLES  */
+#line 1199 "yacc_sql.y"
            {
       (yyval.string) = strdup("tables");
     }
-#line 3310 "yacc_sql.cpp"
+#line 3380 "yacc_sql.cpp"
     break;
 
-  case 174: /* non_reserve: HELP  */
-#line 1150 "yacc_sql.y"
+  case 178: /* non_reserve: HELP  */
+#line 1202 "yacc_sql.y"
            {
       (yyval.string) = strdup("help");
     }
-#line 3318 "yacc_sql.cpp"
+#line 3388 "yacc_sql.cpp"
     break;
 
-  case 175: /* non_reserve: DATA  */
-#line 1153 "yacc_sql.y"
+  case 179: /* non_reserve: DATA  */
+#line 1205 "yacc_sql.y"
            {
       (yyval.string) = strdup("data");
     }
-#line 3326 "yacc_sql.cpp"
+#line 3396 "yacc_sql.cpp"
     break;
 
-  case 176: /* non_reserve: MIN  */
-#line 1156 "yacc_sql.y"
+  case 180: /* non_reserve: MIN  */
+#line 1208 "yacc_sql.y"
           {
       (yyval.string) = strdup("min");
     }
-#line 3334 "yacc_sql.cpp"
+#line 3404 "yacc_sql.cpp"
     break;
 
-  case 177: /* non_reserve: MAX  */
-#line 1159 "yacc_sql.y"
+  case 181: /* non_reserve: MAX  */
+#line 1211 "yacc_sql.y"
           {
       (yyval.string) = strdup("max");
     }
-#line 3342 "yacc_sql.cpp"
+#line 3412 "yacc_sql.cpp"
     break;
 
-  case 178: /* non_reserve: AVG  */
-#line 1162 "yacc_sql.y"
+  case 182: /* non_reserve: AVG  */
+#line 1214 "yacc_sql.y"
           {
       (yyval.string) = strdup("avg");
     }
-#line 3350 "yacc_sql.cpp"
+#line 3420 "yacc_sql.cpp"
     break;
 
-  case 179: /* non_reserve: SUM  */
-#line 1165 "yacc_sql.y"
+  case 183: /* non_reserve: SUM  */
+#line 1217 "yacc_sql.y"
           {
       (yyval.string) = strdup("sum");
     }
-#line 3358 "yacc_sql.cpp"
+#line 3428 "yacc_sql.cpp"
     break;
 
-  case 180: /* non_reserve: COUNT  */
-#line 1168 "yacc_sql.y"
+  case 184: /* non_reserve: COUNT  */
+#line 1220 "yacc_sql.y"
             {
       (yyval.string) = strdup("count");
     }
-#line 3366 "yacc_sql.cpp"
+#line 3436 "yacc_sql.cpp"
     break;
 
-  case 181: /* non_reserve: NULLABLE  */
-#line 1171 "yacc_sql.y"
+  case 185: /* non_reserve: NULLABLE  */
+#line 1223 "yacc_sql.y"
                {
       (yyval.string) = strdup("nullable");
     }
-#line 3374 "yacc_sql.cpp"
+#line 3444 "yacc_sql.cpp"
     break;
 
 
-#line 3378 "yacc_sql.cpp"
+#line 3448 "yacc_sql.cpp"
 
       default: break;
     }
@@ -3603,7 +3673,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 1175 "yacc_sql.y"
+#line 1227 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
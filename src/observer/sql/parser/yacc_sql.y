@@ -213,6 +213,7 @@ ExprSqlNode *create_arithmetic_expression(ArithmeticType type,
 %type <update_set_list>     update_set_list
 %type <id_list>             ids
 %type <id_list>             brace_id_list
+%type <id_list>             index_include
 %type <order_unit>          order_unit
 %type <order>               order
 %type <bools>               null_def
@@ -224,6 +225,7 @@ ExprSqlNode *create_arithmetic_expression(ArithmeticType type,
 %type <sql_node>            calc_stmt
 %type <sql_node>            select_stmt
 %type <sql_node>            as_select
+%type <string>              storage_format
 %type <sql_node>            insert_stmt
 %type <sql_node>            update_stmt
 %type <sql_node>            delete_stmt
@@ -361,7 +363,7 @@ show_index_stmt:
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-    CREATE unique INDEX id ON id LBRACE id ids RBRACE
+    CREATE unique INDEX id ON id LBRACE id ids RBRACE index_include
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode *create_index = new CreateIndexSqlNode;
@@ -373,12 +375,39 @@ create_index_stmt:    /*create index 语句的语法解析树*/
       create_index->attribute_names.swap(*$9);
       delete $9;
       std::reverse(create_index->attribute_names.begin(), create_index->attribute_names.end());
+      if ($11 != nullptr) {
+        create_index->include_names.swap(*$11);
+        delete $11;
+      }
       free($4);
       free($6);
       free($8);
     }
     ;
 
+index_include:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | id LBRACE id ids RBRACE
+    {
+      // 与 storage_format 一样没有单独的关键字，在这里检查
+      if (0 != strcasecmp($1, "include")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "unknown index option");
+        free($1);
+        free($3);
+        delete $4;
+        YYERROR;
+      }
+      $$ = $4;
+      $$->push_back($3);
+      std::reverse($$->begin(), $$->end());
+      free($1);
+      free($3);
+    }
+    ;
+
 unique:
     {
       $$ = false;
@@ -411,7 +440,7 @@ drop_index_stmt:      /*drop index 语句的语法解析树*/
     ;
 
 create_table_stmt:    /*create table 语句的语法解析树*/
-    CREATE TABLE id attr_list as_select
+    CREATE TABLE id attr_list storage_format as_select
     {
       $$ = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode *create_table = new CreateTableSqlNode;
@@ -422,7 +451,30 @@ create_table_stmt:    /*create table 语句的语法解析树*/
         create_table->attr_infos.swap(*$4);
         delete $4;
       }
-      create_table->select = $5;
+      if ($5 != nullptr) {
+        create_table->storage_format = $5;
+        free($5);
+      }
+      create_table->select = $6;
+    }
+    ;
+
+storage_format:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | id EQ id
+    {
+      // 没有单独的关键字，表选项的名字在这里检查
+      if (0 != strcasecmp($1, "storage_format")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "unknown table option");
+        free($1);
+        free($3);
+        YYERROR;
+      }
+      free($1);
+      $$ = $3;
     }
     ;
 
@@ -9,6 +9,9 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 
+#include <algorithm>
+#include <string.h>
+
 #include "sql/stmt/create_index_stmt.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
@@ -19,9 +22,10 @@ See the Mulan PSL v2 for more details. */
 using namespace std;
 using namespace common;
 
-CreateIndexStmt::CreateIndexStmt(Table *table, std::vector<FieldMeta> field_metas, const std::string &index_name,
-                                 bool unique)
-    : table_(table), field_metas_(field_metas), index_name_(index_name), unique_(unique) {}
+CreateIndexStmt::CreateIndexStmt(Table *table, std::vector<FieldMeta> field_metas, std::vector<FieldMeta> include_metas,
+                                 const std::string &index_name, bool unique)
+    : table_(table), field_metas_(field_metas), include_metas_(include_metas), index_name_(index_name),
+      unique_(unique) {}
 
 CreateIndexStmt::~CreateIndexStmt() {}
 
@@ -57,12 +61,30 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     field_metas.push_back(*field_meta);
   }
 
+  // INCLUDE 的字段不能重复，也不能是索引的键值字段
+  std::vector<FieldMeta> include_metas;
+  for (auto &include_name : create_index.include_names) {
+    const FieldMeta *field_meta = table->table_meta().field(include_name.c_str());
+    if (nullptr == field_meta) {
+      LOG_WARN("no such field in table. db=%s, table=%s, field name=%s", db->name(), table_name,
+               include_name.c_str());
+      return RC::SCHEMA_FIELD_NOT_EXIST;
+    }
+    auto same_field = [field_meta](const FieldMeta &field) { return strcmp(field.name(), field_meta->name()) == 0; };
+    if (std::any_of(field_metas.begin(), field_metas.end(), same_field) ||
+        std::any_of(include_metas.begin(), include_metas.end(), same_field)) {
+      LOG_WARN("duplicate field in index. table=%s, field name=%s", table_name, include_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    include_metas.push_back(*field_meta);
+  }
+
   Index *index = table->find_index(create_index.index_name.c_str());
   if (nullptr != index) {
     LOG_WARN("index with name(%s) already exists. table name=%s", create_index.index_name.c_str(), table_name);
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
-  stmt = new CreateIndexStmt(table, field_metas, create_index.index_name, create_index.unique);
+  stmt = new CreateIndexStmt(table, field_metas, include_metas, create_index.index_name, create_index.unique);
   return RC::SUCCESS;
 }
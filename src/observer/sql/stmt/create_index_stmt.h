@@ -25,7 +25,8 @@ class FieldMeta;
  */
 class CreateIndexStmt : public Stmt {
 public:
-  CreateIndexStmt(Table *table, std::vector<FieldMeta> field_metas, const std::string &index_name, bool unique);
+  CreateIndexStmt(Table *table, std::vector<FieldMeta> field_metas, std::vector<FieldMeta> include_metas,
+                  const std::string &index_name, bool unique);
 
   virtual ~CreateIndexStmt();
 
@@ -33,6 +34,7 @@ public:
 
   Table *table() const { return table_; }
   const std::vector<FieldMeta> &field_metas() const { return field_metas_; }
+  const std::vector<FieldMeta> &include_metas() const { return include_metas_; }
   const std::string &index_name() const { return index_name_; }
   bool unique() const { return unique_; }
 
@@ -42,6 +44,7 @@ public:
 private:
   Table *table_ = nullptr;
   std::vector<FieldMeta> field_metas_;
+  std::vector<FieldMeta> include_metas_; ///< 只存放在索引中的字段，用于只扫描索引就能得到结果的查询
   std::string index_name_;
   bool unique_;
 };
@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 
 
+#include <strings.h>
+
 #include "sql/stmt/create_table_stmt.h"
 #include "common/log/log.h"
 #include "common/rc.h"
@@ -20,6 +22,13 @@ RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt
   stmt = create_table_stmt;
   create_table_stmt->db_ = db;
   RC rc = RC::SUCCESS;
+  if (!create_table.storage_format.empty()) {
+    create_table_stmt->storage_format_ = get_storage_format(create_table.storage_format.c_str());
+    if (create_table_stmt->storage_format_ == StorageFormat::UNKNOWN_FORMAT) {
+      LOG_WARN("unknown storage format %s", create_table.storage_format.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
   if (create_table.select != nullptr) {
     Stmt *select_stmt;
     std::set<Field> fields;
@@ -40,3 +49,16 @@ RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt
   // sql_debug("create table statement: table name %s", create_table.relation_name.c_str());
   return RC::SUCCESS;
 }
+
+StorageFormat CreateTableStmt::get_storage_format(const char *format_str) {
+  if (0 == strcasecmp(format_str, "fixed")) {
+    return StorageFormat::FIXED_FORMAT;
+  }
+  if (0 == strcasecmp(format_str, "slotted")) {
+    return StorageFormat::SLOTTED_FORMAT;
+  }
+  if (0 == strcasecmp(format_str, "pax")) {
+    return StorageFormat::PAX_FORMAT;
+  }
+  return StorageFormat::UNKNOWN_FORMAT;
+}
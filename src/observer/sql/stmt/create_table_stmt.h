@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <vector>
 
+#include "common/types.h"
 #include "sql/stmt/select_stmt.h"
 #include "sql/stmt/stmt.h"
 
@@ -36,14 +37,21 @@ public:
   const std::string &table_name() const { return table_name_; }
   const std::vector<AttrInfoSqlNode> &attr_infos() const { return attr_infos_; }
   const std::unique_ptr<SelectStmt> &select_stmt() const { return select_stmt_; }
+  StorageFormat storage_format() const { return storage_format_; }
 
   static RC create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt);
 
+  /**
+   * @brief 根据表选项中的名字找到对应的记录存放格式，找不到时返回 UNKNOWN_FORMAT
+   */
+  static StorageFormat get_storage_format(const char *format_str);
+
   friend class LogicalPlanGenerator;
 
 private:
   std::string table_name_;
   std::vector<AttrInfoSqlNode> attr_infos_;
+  StorageFormat storage_format_ = StorageFormat::FIXED_FORMAT;
 
   Db *db_;
   std::unique_ptr<SelectStmt> select_stmt_;
@@ -162,6 +162,9 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt,
       }
       sub_expr = new ValueExpr(Value(0));
     }
+    // 聚合函数的参数用到的字段也要从表中读取
+    const set<Field> aggr_fields = sub_expr->reference_fields();
+    used_fields.insert(aggr_fields.begin(), aggr_fields.end());
     AggregationUnit *aggr_unit = new AggregationUnit(name, type, sub_expr);
     auto value_type = aggr_unit->value_type();
     if (value_type == UNDEFINED) {
@@ -357,6 +360,14 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt,
     return rc;
   }
 
+  // JOIN ON 中的条件用到的字段
+  for (JoinStmt *join = join_stmt.get(); join != nullptr; join = join->sub_join().get()) {
+    if (join->condition() != nullptr) {
+      const set<Field> join_fields = join->condition()->reference_fields();
+      used_fields.insert(join_fields.begin(), join_fields.end());
+    }
+  }
+
   for (auto it = used_fields.begin(); it != used_fields.end();) {
     bool found = false;
     for (auto &name : tables) {
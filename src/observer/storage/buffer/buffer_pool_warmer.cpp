@@ -0,0 +1,220 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <fstream>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+
+#include "common/log/log.h"
+#include "storage/buffer/buffer_pool_warmer.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+
+BufferPoolWarmer::BufferPoolWarmer(BufferPoolManager &bp_manager, BPFrameManager &frame_manager)
+    : bp_manager_(bp_manager), frame_manager_(frame_manager) {}
+
+BufferPoolWarmer::~BufferPoolWarmer() { stop(); }
+
+RC BufferPoolWarmer::start(const BufferPoolWarmerOptions &options) {
+  stop();
+
+  options_ = options;
+  if (options_.dump_file.empty()) {
+    LOG_INFO("buffer pool warmer is disabled");
+    return RC::SUCCESS;
+  }
+
+  stop_loading_ = false;
+  {
+    lock_guard<mutex> guard(lock_);
+    running_ = true;
+  }
+
+  if (options_.load_threads > 0) {
+#ifdef CONCURRENCY
+    load_thread_ = thread(&BufferPoolWarmer::load, this);
+#else
+    // 没有开启并发编译选项时，页帧的读写锁什么都不做，不能与查询同时加载页面，只能启动时加载完
+    LOG_WARN("loading pages in background requires CONCURRENCY, load them before serving");
+    load();
+#endif
+  }
+
+  if (options_.dump_interval_s > 0) {
+    dump_thread_ = thread(&BufferPoolWarmer::run_dump, this);
+  }
+
+  LOG_INFO("buffer pool warmer started. dump file=%s, dump interval=%ds, load threads=%d",
+           options_.dump_file.c_str(), options_.dump_interval_s, options_.load_threads);
+  return RC::SUCCESS;
+}
+
+void BufferPoolWarmer::stop() {
+  stop_loading_ = true;
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+
+  if (load_thread_.joinable()) {
+    load_thread_.join();
+  }
+  if (dump_thread_.joinable()) {
+    dump_thread_.join();
+  }
+  LOG_INFO("buffer pool warmer stopped");
+}
+
+void BufferPoolWarmer::run_dump() {
+  unique_lock<mutex> lock(lock_);
+  while (running_) {
+    cond_.wait_for(lock, chrono::seconds(options_.dump_interval_s), [this]() { return !running_; });
+    if (!running_) {
+      break;
+    }
+
+    lock.unlock();
+    dump();
+    lock.lock();
+  }
+}
+
+RC BufferPoolWarmer::dump() {
+  if (options_.dump_file.empty()) {
+    return RC::SUCCESS;
+  }
+
+  vector<FrameId> frame_ids;
+  frame_manager_.list_frames(frame_ids);
+  unordered_map<int, string> file_names = bp_manager_.opened_files();
+
+  lock_guard<mutex> guard(dump_lock_);
+  const string tmp_file = options_.dump_file + ".tmp";
+  ofstream out(tmp_file, ios::out | ios::trunc);
+  if (!out.is_open()) {
+    LOG_WARN("failed to open buffer pool dump file %s. error=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  int count = 0;
+  for (const FrameId &frame_id : frame_ids) {
+    auto iter = file_names.find(frame_id.file_desc());
+    if (iter == file_names.end() || frame_id.page_num() == BP_HEADER_PAGE) {
+      continue;
+    }
+    out << frame_id.page_num() << ' ' << iter->second << '\n';
+    count++;
+  }
+  out.close();
+  if (out.fail()) {
+    LOG_WARN("failed to write buffer pool dump file %s", tmp_file.c_str());
+    ::remove(tmp_file.c_str());
+    return RC::IOERR_WRITE;
+  }
+
+  if (::rename(tmp_file.c_str(), options_.dump_file.c_str()) != 0) {
+    LOG_WARN("failed to rename buffer pool dump file %s. error=%s", tmp_file.c_str(), strerror(errno));
+    ::remove(tmp_file.c_str());
+    return RC::IOERR_WRITE;
+  }
+
+  LOG_INFO("dump buffer pool pages done. file=%s, pages=%d", options_.dump_file.c_str(), count);
+  return RC::SUCCESS;
+}
+
+int BufferPoolWarmer::load() {
+  ifstream in(options_.dump_file);
+  if (!in.is_open()) {
+    LOG_INFO("no buffer pool dump file %s, skip warming up", options_.dump_file.c_str());
+    return 0;
+  }
+
+  // 只加载空闲页帧能放下的页面
+  const size_t free_frames = frame_manager_.total_frame_num() - frame_manager_.frame_num();
+  vector<pair<string, PageNum>> pages;
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  string file_name;
+  while (pages.size() < free_frames && in >> page_num && getline(in >> ws, file_name)) {
+    pages.emplace_back(file_name, page_num);
+  }
+
+  const int thread_num = max(options_.load_threads, 1);
+  atomic<size_t> next_batch{0};
+  atomic<int> loaded{0};
+  vector<thread> threads;
+  for (int i = 1; i < thread_num; i++) {
+    threads.emplace_back([&]() { loaded += load_batches(pages, next_batch); });
+  }
+  loaded += load_batches(pages, next_batch);
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  LOG_INFO("buffer pool warm up done. file=%s, pages in file=%d, loaded=%d",
+           options_.dump_file.c_str(), static_cast<int>(pages.size()), loaded.load());
+  return loaded.load();
+}
+
+int BufferPoolWarmer::load_batches(const vector<pair<string, PageNum>> &pages, atomic<size_t> &next_batch) {
+  int loaded = 0;
+  bool full = false;
+  while (!stop_loading_ && !full) {
+    const size_t begin = next_batch.fetch_add(1) * LOAD_BATCH_PAGES;
+    if (begin >= pages.size()) {
+      break;
+    }
+
+    if (frame_manager_.frame_num() >= frame_manager_.total_frame_num()) {
+      LOG_INFO("buffer pool is full, stop warming up");
+      break;
+    }
+
+    // 同一个文件的页面排好序一起读取
+    map<string, vector<PageNum>> file_pages;
+    const size_t end = min(begin + LOAD_BATCH_PAGES, pages.size());
+    for (size_t i = begin; i < end; i++) {
+      file_pages[pages[i].first].push_back(pages[i].second);
+    }
+
+    for (auto &[file_name, page_nums] : file_pages) {
+      shared_lock<shared_mutex> file_guard(file_lock_);
+      DiskBufferPool *bp = bp_manager_.find_buffer_pool(file_name);
+      if (bp == nullptr) {
+        LOG_TRACE("file is not opened, skip its pages. file=%s", file_name.c_str());
+        continue;
+      }
+
+      sort(page_nums.begin(), page_nums.end());
+      page_nums.erase(unique(page_nums.begin(), page_nums.end()), page_nums.end());
+      // 文件可能已经变小了
+      page_nums.erase(lower_bound(page_nums.begin(), page_nums.end(), bp->page_num()), page_nums.end());
+      int file_loaded = 0;
+      RC rc = bp->warm_pages(page_nums, file_loaded);
+      loaded += file_loaded;
+      // 查询同时也在加载页面，空闲页帧可能比开始时少
+      if (rc == RC::BUFFERPOOL_NOBUF) {
+        LOG_INFO("buffer pool is full, stop warming up");
+        full = true;
+        break;
+      }
+    }
+  }
+  return loaded;
+}
@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+
+class BufferPoolManager;
+class BPFrameManager;
+
+/**
+ * @brief 缓冲池预热的参数
+ * @ingroup BufferPool
+ */
+struct BufferPoolWarmerOptions {
+  std::string dump_file;       ///< 保存页面列表的文件。为空表示不预热
+  int dump_interval_s = 300;   ///< 定期保存页面列表的间隔。小于等于0表示只在正常关闭时保存
+  int load_threads = 2;        ///< 启动时加载页面的线程数。小于等于0表示不加载
+};
+
+/**
+ * @brief 缓冲池预热
+ * @ingroup BufferPool
+ * @details 重启之后缓冲池是空的，需要很长时间才能把常用的页面重新加载到内存中，这段时间查询的延迟很高。
+ * 正常关闭时以及运行过程中定期把缓冲池中的页面列表保存到文件中，从最热的页面开始，
+ * 每行是页号和文件名。因为页帧是分片管理的，每个分片按照置换策略从热到冷排序，再轮流从各个分片中取页面。
+ *
+ * 启动之后，在后台按照保存的顺序加载这些页面，此时已经可以处理查询了。
+ * 页面列表按批分给多个线程，每一批中同一个文件的页面排序之后一次批量读取(DiskBufferPool::warm_pages)。
+ * 加载只使用空闲的页帧，缓冲池满了就停止加载，不会淘汰查询已经加载的页面。
+ * 已经关闭的文件的页面会跳过。
+ */
+class BufferPoolWarmer {
+public:
+  BufferPoolWarmer(BufferPoolManager &bp_manager, BPFrameManager &frame_manager);
+  ~BufferPoolWarmer();
+
+  /**
+   * @brief 在后台加载上次保存的页面，并启动定期保存页面列表的线程
+   * @details 需要在打开所有的表之后调用
+   */
+  RC start(const BufferPoolWarmerOptions &options);
+  void stop();
+
+  /**
+   * @brief 把缓冲池中的页面列表保存到 dump_file 中
+   * @details 先写到临时文件中再重命名，保存过程中异常退出也不会破坏上次保存的文件
+   */
+  RC dump();
+
+  /**
+   * @brief 加载 dump_file 中记录的页面，加载完成之后才返回
+   * @return 实际从磁盘读取了多少个页面
+   */
+  int load();
+
+  /**
+   * @brief 加载页面时持有这把锁的读锁，关闭文件前要持有写锁，保证加载时文件不会被关闭
+   */
+  std::shared_mutex &file_lock() { return file_lock_; }
+
+  const BufferPoolWarmerOptions &options() const { return options_; }
+
+public:
+  /// 每批加载多少个页面
+  static constexpr int LOAD_BATCH_PAGES = 64;
+
+private:
+  void run_dump();
+  int load_batches(const std::vector<std::pair<std::string, PageNum>> &pages, std::atomic<size_t> &next_batch);
+
+private:
+  BufferPoolManager &bp_manager_;
+  BPFrameManager &frame_manager_;
+  BufferPoolWarmerOptions options_;
+
+  std::shared_mutex file_lock_;
+  std::mutex dump_lock_; ///< 同一时间只有一个线程在写 dump_file
+
+  std::mutex lock_;
+  std::condition_variable cond_;
+  bool running_ = false;
+  std::atomic<bool> stop_loading_{false}; ///< 关闭时不再继续加载
+  std::thread dump_thread_;
+  std::thread load_thread_;
+};
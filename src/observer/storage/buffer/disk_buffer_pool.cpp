@@ -9,13 +9,18 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 
+#include <algorithm>
+#include <chrono>
 #include <errno.h>
+#include <limits>
 #include <string.h>
+#include <thread>
 
-#include "common/io/io.h"
 #include "common/lang/mutex.h"
+#include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/os/os.h"
+#include "common/os/path.h"
 #include "storage/buffer/disk_buffer_pool.h"
 
 using namespace common;
@@ -33,35 +38,327 @@ string BPFileHeader::to_string() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-BPFrameManager::BPFrameManager(const char *name) : allocator_(name) {}
+BPFrameManager::BPFrameManager(const char *name) : name_(name) {}
 
-RC BPFrameManager::init(int pool_num) {
-  int ret = allocator_.init(false, pool_num);
-  if (ret == 0) {
-    return RC::SUCCESS;
+RC BPFrameManager::init(int pool_num, int shard_num /* = 0 */, const char *replacer /* = nullptr */,
+                        const PageArenaOptions &arena_options /* = PageArenaOptions() */) {
+  if (pool_num <= 0) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int frame_count = pool_num * DEFAULT_ITEM_NUM_PER_POOL;
+  if (shard_num <= 0) {
+    shard_num = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  }
+  // 每个分片至少要有一个页帧
+  shard_num = std::min(shard_num, frame_count);
+
+  shards_.clear();
+  shards_.reserve(shard_num);
+  for (int i = 0; i < shard_num; i++) {
+    std::unique_ptr<FrameShard> shard(new FrameShard);
+    shard->replacer.reset(PageReplacer::create(replacer, frame_count / shard_num + 1));
+    if (shard->replacer == nullptr) {
+      LOG_ERROR("unknown page replacement policy: %s", replacer);
+      shards_.clear();
+      return RC::INVALID_ARGUMENT;
+    }
+    shard->frames.reserve(frame_count / shard_num + 1);
+    shard->free_frames.reserve(frame_count / shard_num + 1);
+    shards_.push_back(std::move(shard));
   }
-  return RC::NOMEM;
+
+  // 使用大页时，一个内存块至少占满一个大页，释放的时候才能整个还给操作系统
+  arena_options_ = arena_options;
+  chunk_frames_  = DEFAULT_ITEM_NUM_PER_POOL;
+  if (arena_options.huge_page) {
+    chunk_frames_ = std::max(chunk_frames_, PageArena::HUGE_PAGE_SIZE / BP_PAGE_SIZE);
+  }
+
+  std::lock_guard<std::mutex> resize_guard(resize_lock_);
+  for (size_t remain = frame_count; remain > 0;) {
+    const size_t chunk_frames = std::min(remain, chunk_frames_);
+    RC rc = add_chunk(chunk_frames);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to alloc frames. frame num=%d, rc=%s", frame_count, strrc(rc));
+      shards_.clear();
+      chunks_.clear();
+      total_frame_num_ = 0;
+      return rc;
+    }
+    remain -= chunk_frames;
+  }
+
+  LOG_INFO("frame manager init done. frame num=%d, shard num=%d, chunk num=%d, replacer=%s",
+           frame_count, shard_num, static_cast<int>(chunks_.size()), shards_.front()->replacer->name());
+  return RC::SUCCESS;
 }
 
 RC BPFrameManager::cleanup() {
-  if (frames_.count() > 0) {
+  if (frame_num() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  shards_.clear();
+
+  std::lock_guard<std::mutex> resize_guard(resize_lock_);
+  chunks_.clear();
+  total_frame_num_ = 0;
   return RC::SUCCESS;
 }
 
-int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purger) {
-  std::lock_guard<std::mutex> lock_guard(lock_);
+RC BPFrameManager::add_chunk(size_t frame_count) {
+  std::unique_ptr<FrameChunk> chunk(new FrameChunk);
+  RC rc = chunk->arena.init(frame_count, arena_options_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
-  std::vector<Frame *> frames_can_purge;
+  chunk->frames.reset(new (std::nothrow) Frame[frame_count]);
+  if (chunk->frames == nullptr) {
+    return RC::NOMEM;
+  }
+  chunk->frame_count = frame_count;
+  for (size_t i = 0; i < frame_count; i++) {
+    chunk->frames[i].set_page(chunk->arena.page(i));
+  }
+
+  // 新的页帧平均分配到各个分片的空闲链表中
+  for (size_t i = 0; i < shards_.size(); i++) {
+    FrameShard &shard = *shards_[i];
+    std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+    for (size_t j = i; j < frame_count; j += shards_.size()) {
+      shard.free_frames.push_back(&chunk->frames[j]);
+    }
+  }
+
+  total_frame_num_ += frame_count;
+  chunks_.push_back(std::move(chunk));
+  return RC::SUCCESS;
+}
+
+RC BPFrameManager::resize(int pool_num, const std::function<RC(Frame &frame)> &flusher, int timeout_ms) {
+  if (pool_num <= 0) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  std::lock_guard<std::mutex> resize_guard(resize_lock_);
+  if (shards_.empty()) {
+    return RC::INTERNAL;
+  }
+
+  const size_t old_frame_num    = total_frame_num();
+  const size_t target_frame_num = static_cast<size_t>(pool_num) * DEFAULT_ITEM_NUM_PER_POOL;
+
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc) && total_frame_num() < target_frame_num) {
+    rc = add_chunk(std::min(target_frame_num - total_frame_num(), chunk_frames_));
+  }
+
+  // 缩容时只释放整块的内存，剩下的页帧个数可能比期望的多一些
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (OB_SUCC(rc) && chunks_.size() > 1) {
+    const size_t index = chunk_to_release();
+    FrameChunk &chunk  = *chunks_[index];
+    if (total_frame_num() - chunk.frame_count < target_frame_num) {
+      break;
+    }
+
+    rc = detach_chunk(chunk, flusher, deadline);
+    if (OB_SUCC(rc)) {
+      total_frame_num_ -= chunk.frame_count;
+      chunks_.erase(chunks_.begin() + index);
+    }
+  }
+
+  const size_t capacity = total_frame_num() / shards_.size() + 1;
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::unique_lock<std::shared_mutex> lock_guard(shard->lock);
+    shard->replacer->set_capacity(capacity);
+  }
+
+  LOG_INFO("%s resized. frame num %d -> %d, expected=%d, chunk num=%d, rc=%s",
+           name_.c_str(), static_cast<int>(old_frame_num), static_cast<int>(total_frame_num()),
+           static_cast<int>(target_frame_num), static_cast<int>(chunks_.size()), strrc(rc));
+  return rc;
+}
+
+size_t BPFrameManager::chunk_to_release() const {
+  // 有些页面会一直被pin住，比如每个文件的第一个页面，这样的页帧所在的内存块没办法释放。
+  // 优先释放被pin住的页帧最少的内存块，一样多时先释放最后申请的
+  std::vector<int> pinned_counts(chunks_.size(), 0);
+  for (const std::unique_ptr<FrameShard> &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock_guard(shard->lock);
+    for (const auto &[frame_id, frame] : shard->frames) {
+      if (frame->pin_count() == 0) {
+        continue;
+      }
+      for (size_t i = 0; i < chunks_.size(); i++) {
+        if (chunks_[i]->contains(frame)) {
+          pinned_counts[i]++;
+          break;
+        }
+      }
+    }
+  }
+
+  size_t index = chunks_.size() - 1;
+  for (size_t i = chunks_.size() - 1; i-- > 0;) {
+    if (pinned_counts[i] < pinned_counts[index]) {
+      index = i;
+    }
+  }
+  return index;
+}
+
+void BPFrameManager::release_frame(FrameShard &shard, Frame *frame) {
+  const FrameChunk *retiring_chunk = retiring_chunk_.load(std::memory_order_acquire);
+  if (retiring_chunk != nullptr && retiring_chunk->contains(frame)) {
+    shard.retired_frames.push_back(frame);
+  } else {
+    shard.free_frames.push_back(frame);
+  }
+}
+
+RC BPFrameManager::detach_chunk(FrameChunk &chunk, const std::function<RC(Frame &frame)> &flusher,
+                                std::chrono::steady_clock::time_point deadline) {
+  // 正在释放的内存块中的页帧被淘汰之后不再放回空闲链表，否则可能马上又被其它页面用上
+  retiring_chunk_.store(&chunk, std::memory_order_release);
+
+  std::vector<Frame *> detached_frames;
+  std::vector<Frame *> dirty_frames;
+  detached_frames.reserve(chunk.frame_count);
+  while (true) {
+    for (std::unique_ptr<FrameShard> &shard : shards_) {
+      std::unique_lock<std::shared_mutex> lock_guard(shard->lock);
+      detach_shard_frames(*shard, chunk, detached_frames, dirty_frames);
+    }
+
+    // 脏页在分片的锁外面刷盘。刷完之后马上摘下来，经常修改的页面等到下一轮可能又变脏了
+    for (Frame *frame : dirty_frames) {
+      if (frame->try_read_latch()) {
+        if (frame->dirty()) {
+          RC rc = flusher(*frame);
+          if (OB_FAIL(rc)) {
+            LOG_WARN("failed to flush page while resizing. frame=%s, rc=%s", to_string(*frame).c_str(), strrc(rc));
+          }
+        }
+        frame->read_unlatch();
+      }
+
+      const FrameId frame_id = frame->frame_id();
+      FrameShard &shard = *shards_[shard_index(frame_id)];
+      std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+      frame->unpin();
+      if (frame->pin_count() == 0 && !frame->dirty()) {
+        shard.replacer->on_remove(frame);
+        shard.frames.erase(frame_id);
+        detached_frames.push_back(frame);
+      }
+    }
+    dirty_frames.clear();
+
+    if (detached_frames.size() == chunk.frame_count || std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  retiring_chunk_.store(nullptr, std::memory_order_release);
+  if (detached_frames.size() == chunk.frame_count) {
+    return RC::SUCCESS;
+  }
+
+  LOG_WARN("timeout to wait frames released while resizing. chunk frames=%d, detached=%d",
+           static_cast<int>(chunk.frame_count), static_cast<int>(detached_frames.size()));
+
+  // 没有摘完，已经摘下来的页帧放回空闲链表
+  for (size_t i = 0; i < shards_.size(); i++) {
+    FrameShard &shard = *shards_[i];
+    std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+    shard.free_frames.insert(shard.free_frames.end(), shard.retired_frames.begin(), shard.retired_frames.end());
+    shard.retired_frames.clear();
+    for (size_t j = i; j < detached_frames.size(); j += shards_.size()) {
+      shard.free_frames.push_back(detached_frames[j]);
+    }
+  }
+  return RC::LOCKED_CONCURRENCY_CONFLICT;
+}
+
+void BPFrameManager::detach_shard_frames(FrameShard &shard, const FrameChunk &chunk,
+                                         std::vector<Frame *> &detached_frames, std::vector<Frame *> &dirty_frames) {
+  auto free_end = std::partition(
+      shard.free_frames.begin(), shard.free_frames.end(), [&chunk](Frame *frame) { return !chunk.contains(frame); });
+  detached_frames.insert(detached_frames.end(), free_end, shard.free_frames.end());
+  shard.free_frames.erase(free_end, shard.free_frames.end());
+  detached_frames.insert(detached_frames.end(), shard.retired_frames.begin(), shard.retired_frames.end());
+  shard.retired_frames.clear();
+
+  for (auto iter = shard.frames.begin(); iter != shard.frames.end();) {
+    Frame *frame = iter->second;
+    if (!chunk.contains(frame) || frame->pin_count() != 0) {
+      ++iter;
+      continue;
+    }
+
+    if (frame->dirty()) {
+      frame->pin();
+      dirty_frames.push_back(frame);
+      ++iter;
+      continue;
+    }
+
+    shard.replacer->on_remove(frame);
+    iter = shard.frames.erase(iter);
+    detached_frames.push_back(frame);
+  }
+}
+
+size_t BPFrameManager::memory_size() const {
+  std::lock_guard<std::mutex> resize_guard(resize_lock_);
+  size_t size = 0;
+  for (const std::unique_ptr<FrameChunk> &chunk : chunks_) {
+    size += chunk->arena.memory_size();
+  }
+  return size;
+}
+
+const char *BPFrameManager::memory_mode() const {
+  std::lock_guard<std::mutex> resize_guard(resize_lock_);
+  return chunks_.empty() ? "normal" : chunks_.front()->arena.mode();
+}
+
+size_t BPFrameManager::frame_num() const {
+  size_t count = 0;
+  for (const std::unique_ptr<FrameShard> &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock_guard(shard->lock);
+    count += shard->frames.size();
+  }
+  return count;
+}
+
+int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purger) {
   if (count <= 0) {
     count = 1;
   }
+
+  const size_t start = purge_cursor_.fetch_add(1, std::memory_order_relaxed);
+
+  int freed_count = 0;
+  for (size_t i = 0; i < shards_.size() && freed_count < count; i++) {
+    FrameShard &shard = *shards_[(start + i) % shards_.size()];
+    freed_count += purge_shard_frames(shard, count - freed_count, purger);
+  }
+  return freed_count;
+}
+
+int BPFrameManager::purge_shard_frames(FrameShard &shard, int count, const std::function<RC(Frame *frame)> &purger) {
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+
+  std::vector<Frame *> frames_can_purge;
   frames_can_purge.reserve(count);
 
-  auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
+  auto purge_finder = [&frames_can_purge, count](Frame *frame) {
     if (frame->can_purge()) {
       frame->pin();
       frames_can_purge.push_back(frame);
@@ -72,16 +369,16 @@ int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purg
     return true; // true continue to look up
   };
 
-  frames_.foreach_reverse(purge_finder);
+  shard.replacer->foreach_victim(purge_finder);
   LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
+  /// 当前还在分片的锁内，而 purger 是一个非常耗时的操作
+  /// 他需要把脏页数据刷新到磁盘上去，不过只会阻塞访问当前分片的线程
   int freed_count = 0;
   for (Frame *frame : frames_can_purge) {
     RC rc = purger(frame);
     if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+      free_internal(shard, frame->frame_id(), frame);
       freed_count++;
     } else {
       frame->unpin();
@@ -92,101 +389,302 @@ int BPFrameManager::purge_frames(int count, std::function<RC(Frame *frame)> purg
   return freed_count;
 }
 
+int BPFrameManager::find_dirty_victims(double ratio, std::vector<Frame *> &dirty_frames) {
+  int scanned = 0;
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock_guard(shard->lock);
+    const int window = std::max(static_cast<int>(shard->frames.size() * ratio), 1);
+    int count = 0;
+    shard->replacer->foreach_candidate([&](Frame *frame) {
+      count++;
+      if (frame->dirty() && frame->can_purge()) {
+        frame->pin();
+        dirty_frames.push_back(frame);
+      }
+      return count < window;
+    });
+    scanned += count;
+  }
+  return scanned;
+}
+
+void BPFrameManager::list_frames(std::vector<FrameId> &frame_ids) {
+  std::vector<std::vector<FrameId>> shard_frame_ids(shards_.size());
+  size_t max_size = 0;
+  for (size_t i = 0; i < shards_.size(); i++) {
+    FrameShard &shard = *shards_[i];
+    std::vector<FrameId> &ids = shard_frame_ids[i];
+    std::shared_lock<std::shared_mutex> lock_guard(shard.lock);
+    ids.reserve(shard.frames.size());
+    shard.replacer->foreach_candidate([&ids](Frame *frame) {
+      ids.emplace_back(frame->file_desc(), frame->page_num());
+      return true;
+    });
+    std::reverse(ids.begin(), ids.end());
+    max_size = std::max(max_size, ids.size());
+  }
+
+  for (size_t i = 0; i < max_size; i++) {
+    for (const std::vector<FrameId> &ids : shard_frame_ids) {
+      if (i < ids.size()) {
+        frame_ids.push_back(ids[i]);
+      }
+    }
+  }
+}
+
 Frame *BPFrameManager::get(int file_desc, PageNum page_num) {
   FrameId frame_id(file_desc, page_num);
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  FrameShard &shard = *shards_[shard_index(frame_id)];
+  std::shared_lock<std::shared_mutex> lock_guard(shard.lock);
+  return get_internal(shard, frame_id);
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id) {
-  Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
-  if (frame != nullptr) {
-    frame->pin();
+Frame *BPFrameManager::get_internal(FrameShard &shard, const FrameId &frame_id) {
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
   }
+
+  Frame *frame = iter->second;
+  frame->pin();
+  shard.replacer->on_access(frame);
   return frame;
 }
 
 Frame *BPFrameManager::alloc(int file_desc, PageNum page_num) {
   FrameId frame_id(file_desc, page_num);
+  const size_t index = shard_index(frame_id);
+  FrameShard &shard = *shards_[index];
+
+  {
+    std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+    Frame *frame = get_internal(shard, frame_id);
+    if (frame != nullptr) {
+      return frame;
+    }
 
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  Frame *frame = get_internal(frame_id);
+    if (!shard.free_frames.empty()) {
+      frame = shard.free_frames.back();
+      shard.free_frames.pop_back();
+      attach_internal(shard, frame_id, frame);
+      return frame;
+    }
+  }
+
+  // 当前分片没有空闲页帧了，从其它分片借一个。
+  // 借用时没有持有当前分片的锁，所以拿回来之后要再检查一次是否有其他线程已经加载了这个页面
+  Frame *stolen_frame = steal_free_frame(index);
+  if (stolen_frame == nullptr) {
+    return nullptr;
+  }
+
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
+    release_frame(shard, stolen_frame);
     return frame;
   }
 
-  frame = allocator_.alloc();
-  if (frame != nullptr) {
-    ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s",
-           to_string(*frame).c_str());
-    frame->set_page_num(page_num);
-    frame->pin();
-    frames_.put(frame_id, frame);
+  attach_internal(shard, frame_id, stolen_frame);
+  return stolen_frame;
+}
+
+void BPFrameManager::attach_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame) {
+  ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s",
+         to_string(*frame).c_str());
+  frame->set_file_desc(frame_id.file_desc());
+  frame->set_page_num(frame_id.page_num());
+  frame->pin();
+  shard.frames.emplace(frame_id, frame);
+  shard.replacer->on_insert(frame);
+}
+
+Frame *BPFrameManager::steal_free_frame(size_t exclude_index) {
+  for (size_t i = 1; i < shards_.size(); i++) {
+    FrameShard &shard = *shards_[(exclude_index + i) % shards_.size()];
+    std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+    if (!shard.free_frames.empty()) {
+      Frame *frame = shard.free_frames.back();
+      shard.free_frames.pop_back();
+      return frame;
+    }
+  }
+  return nullptr;
+}
+
+Frame *BPFrameManager::reuse(Frame *frame, const FrameId &old_id, int file_desc, PageNum page_num) {
+  {
+    FrameShard &old_shard = *shards_[shard_index(old_id)];
+    std::unique_lock<std::shared_mutex> lock_guard(old_shard.lock);
+    auto iter = old_shard.frames.find(old_id);
+    if (iter == old_shard.frames.end() || iter->second != frame || frame->pin_count() != 0 || frame->dirty()) {
+      return nullptr;
+    }
+
+    old_shard.replacer->on_remove(frame);
+    old_shard.frames.erase(iter);
+  }
+
+  // 页帧已经从原来的分片中摘下来了，其它线程找不到它
+  FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = *shards_[shard_index(frame_id)];
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+  Frame *loaded_frame = get_internal(shard, frame_id);
+  if (loaded_frame != nullptr) {
+    release_frame(shard, frame);
+    return loaded_frame;
   }
+
+  attach_internal(shard, frame_id, frame);
   return frame;
 }
 
 RC BPFrameManager::free(int file_desc, PageNum page_num, Frame *frame) {
   FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = *shards_[shard_index(frame_id)];
 
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+  return free_internal(shard, frame_id, frame);
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame) {
-  Frame *frame_source = nullptr;
-  [[maybe_unused]] bool found = frames_.get(frame_id, frame_source);
+RC BPFrameManager::try_free(int file_desc, PageNum page_num, Frame *frame) {
+  FrameId frame_id(file_desc, page_num);
+  FrameShard &shard = *shards_[shard_index(frame_id)];
+
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+  if (frame->pin_count() != 1) {
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  return free_internal(shard, frame_id, frame);
+}
+
+RC BPFrameManager::free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame) {
+  auto iter = shard.frames.find(frame_id);
+  [[maybe_unused]] bool found = iter != shard.frames.end();
+  [[maybe_unused]] Frame *frame_source = found ? iter->second : nullptr;
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
          "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s", found,
          to_string(frame_id).c_str(), frame_source, frame, frame->pin_count(), lbt());
 
   frame->unpin();
-  frames_.remove(frame_id);
-  allocator_.free(frame);
+  shard.replacer->on_remove(frame);
+  shard.frames.erase(iter);
+  release_frame(shard, frame);
   return RC::SUCCESS;
 }
 
 std::list<Frame *> BPFrameManager::find_list(int file_desc) {
-  std::lock_guard<std::mutex> lock_guard(lock_);
-
   std::list<Frame *> frames;
-  auto fetcher = [&frames, file_desc](const FrameId &frame_id, Frame *const frame) -> bool {
-    if (file_desc == frame_id.file_desc()) {
-      frame->pin();
-      frames.push_back(frame);
+  for (std::unique_ptr<FrameShard> &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock_guard(shard->lock);
+    for (const auto &[frame_id, frame] : shard->frames) {
+      if (file_desc == frame_id.file_desc()) {
+        frame->pin();
+        frames.push_back(frame);
+      }
     }
-    return true;
-  };
-  frames_.foreach (fetcher);
+  }
   return frames;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 BufferPoolIterator::BufferPoolIterator() {}
 BufferPoolIterator::~BufferPoolIterator() {}
-RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */) {
+RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */,
+    PageNum end_page /* = BP_INVALID_PAGE_NUM */) {
+  bp_ = &bp;
   bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
   if (start_page <= 0) {
     current_page_num_ = 0;
   } else {
     current_page_num_ = start_page;
   }
+  end_page_ = end_page;
+
+  sequential_count_ = 0;
+  read_ahead_window_ = 0;
+  read_ahead_trigger_ = -1;
+  read_ahead_end_ = BP_INVALID_PAGE_NUM;
   return RC::SUCCESS;
 }
 
-bool BufferPoolIterator::has_next() { return bitmap_.next_setted_bit(current_page_num_ + 1) != -1; }
+bool BufferPoolIterator::has_next() { return next_page_after(current_page_num_) != -1; }
+
+PageNum BufferPoolIterator::next_page_after(PageNum page_num) {
+  PageNum next_page = bitmap_.next_setted_bit(page_num + 1);
+  if (end_page_ != BP_INVALID_PAGE_NUM && next_page >= end_page_) {
+    return -1;
+  }
+  return next_page;
+}
 
 PageNum BufferPoolIterator::next() {
-  PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  PageNum next_page = next_page_after(current_page_num_);
   if (next_page != -1) {
     current_page_num_ = next_page;
+
+    sequential_count_++;
+    if (sequential_count_ >= READ_AHEAD_TRIGGER_PAGES && next_page >= read_ahead_trigger_) {
+      read_ahead(next_page);
+    }
   }
   return next_page;
 }
 
+void BufferPoolIterator::read_ahead(PageNum current_page) {
+  // 预读的页面不能把缓冲池(或者环形缓冲区)占满，否则还没有访问就被淘汰了
+  const int capacity =
+      ring_ != nullptr ? ring_->size() / 2 : static_cast<int>(bp_->frame_manager_.total_frame_num() / 4);
+  const int max_pages = std::min(bp_->bp_manager_.read_ahead_max_pages(), capacity);
+  if (max_pages <= 0) {
+    read_ahead_trigger_ = std::numeric_limits<PageNum>::max();
+    return;
+  }
+
+  if (read_ahead_window_ == 0) {
+    read_ahead_window_ = std::min(READ_AHEAD_MIN_PAGES, max_pages);
+  }
+
+  std::vector<PageNum> pages;
+  pages.reserve(read_ahead_window_);
+  PageNum page = std::max(current_page, read_ahead_end_);
+  while (static_cast<int>(pages.size()) < read_ahead_window_) {
+    page = next_page_after(page);
+    if (page == -1) {
+      break;
+    }
+    pages.push_back(page);
+  }
+
+  if (pages.empty()) {
+    // 已经到文件末尾了
+    read_ahead_trigger_ = std::numeric_limits<PageNum>::max();
+    return;
+  }
+
+  const int loaded = bp_->prefetch_pages(pages, ring_);
+
+  // 下一个窗口交给操作系统在后台读取
+  bp_->advise_will_need(pages.back() + 1, pages.back() + static_cast<PageNum>(pages.size()));
+
+  read_ahead_trigger_ = pages.front();
+  read_ahead_end_ = pages.back();
+
+  // 预读的页面大部分都需要从磁盘读取，说明预读是有效的，扩大窗口；否则缩小窗口
+  if (loaded * 2 >= static_cast<int>(pages.size())) {
+    read_ahead_window_ = std::min(read_ahead_window_ * 2, max_pages);
+  } else {
+    read_ahead_window_ = std::max(read_ahead_window_ / 2, std::min(READ_AHEAD_MIN_PAGES, max_pages));
+  }
+}
+
 RC BufferPoolIterator::reset() {
   current_page_num_ = 0;
+  sequential_count_ = 0;
+  read_ahead_window_ = 0;
+  read_ahead_trigger_ = -1;
+  read_ahead_end_ = BP_INVALID_PAGE_NUM;
   return RC::SUCCESS;
 }
 
@@ -199,16 +697,34 @@ DiskBufferPool::~DiskBufferPool() {
   LOG_INFO("disk buffer pool exit");
 }
 
-RC DiskBufferPool::open_file(const char *file_name) {
-  int fd = open(file_name, O_RDWR);
+RC DiskBufferPool::open_file(const char *file_name, bool direct_io /* = false */) {
+  int flags = O_RDWR;
+#ifdef O_DIRECT
+  if (direct_io) {
+    flags |= O_DIRECT;
+  }
+#else
+  if (direct_io) {
+    LOG_WARN("O_DIRECT is not supported on this platform. file=%s", file_name);
+    direct_io = false;
+  }
+#endif
+
+  int fd = open(file_name, flags);
+  if (fd < 0 && direct_io && errno == EINVAL) {
+    LOG_WARN("file system does not support O_DIRECT, open with page cache. file=%s", file_name);
+    direct_io = false;
+    fd = open(file_name, O_RDWR);
+  }
   if (fd < 0) {
     LOG_ERROR("Failed to open file %s, because %s.", file_name, strerror(errno));
     return RC::IOERR_ACCESS;
   }
-  LOG_INFO("Successfully open buffer pool file %s.", file_name);
+  LOG_INFO("Successfully open buffer pool file %s. direct io=%d", file_name, direct_io);
 
   file_name_ = file_name;
   file_desc_ = fd;
+  direct_io_ = direct_io;
 
   RC rc = RC::SUCCESS;
   rc = allocate_frame(BP_HEADER_PAGE, &hdr_frame_);
@@ -243,34 +759,44 @@ RC DiskBufferPool::close_file() {
     return rc;
   }
 
-  hdr_frame_->unpin();
+  {
+    // 后台刷脏页时会pin住页面，等它这一轮结束，保证当前文件的页面都能释放掉
+    std::lock_guard<std::mutex> cleaner_guard(bp_manager_.page_cleaner().round_lock());
+    // 也要等预热加载完当前这一批页面
+    std::unique_lock<std::shared_mutex> warmer_guard(bp_manager_.warmer().file_lock());
 
-  // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
-  rc = purge_all_pages();
-  if (rc != RC::SUCCESS) {
-    LOG_ERROR("failed to close %s, due to failed to purge pages. rc=%s", file_name_.c_str(), strrc(rc));
-    return rc;
-  }
+    hdr_frame_->unpin();
+
+    // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
+    rc = purge_all_pages();
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("failed to close %s, due to failed to purge pages. rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
+    }
 
-  disposed_pages_.clear();
+    disposed_pages_.clear();
 
-  if (close(file_desc_) < 0) {
-    LOG_ERROR("Failed to close fileId:%d, fileName:%s, error:%s", file_desc_, file_name_.c_str(), strerror(errno));
-    return RC::IOERR_CLOSE;
+    if (close(file_desc_) < 0) {
+      LOG_ERROR("Failed to close fileId:%d, fileName:%s, error:%s", file_desc_, file_name_.c_str(), strerror(errno));
+      return RC::IOERR_CLOSE;
+    }
+    LOG_INFO("Successfully close file %d:%s.", file_desc_, file_name_.c_str());
+    file_desc_ = -1;
   }
-  LOG_INFO("Successfully close file %d:%s.", file_desc_, file_name_.c_str());
-  file_desc_ = -1;
 
   bp_manager_.close_file(file_name_.c_str());
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame) {
+RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame, ScanRing *ring /* = nullptr */) {
   RC rc = RC::SUCCESS;
   *frame = nullptr;
 
   Frame *used_match_frame = frame_manager_.get(file_desc_, page_num);
   if (used_match_frame != nullptr) {
+    if (ring != nullptr) {
+      ring->record_hit();
+    }
     used_match_frame->access();
     *frame = used_match_frame;
     return RC::SUCCESS;
@@ -280,7 +806,7 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame) {
 
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
-  rc = allocate_frame(page_num, &allocated_frame);
+  rc = allocate_frame(page_num, &allocated_frame, true /*wait*/, ring);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to alloc frame %s:%d, due to failed to alloc page.", file_name_.c_str(), page_num);
     return rc;
@@ -368,16 +894,19 @@ RC DiskBufferPool::allocate_page(Frame **frame) {
 }
 
 RC DiskBufferPool::dispose_page(PageNum page_num) {
-  std::scoped_lock lock_guard(lock_);
   Frame *used_frame = frame_manager_.get(file_desc_, page_num);
-  if (used_frame != nullptr) {
-    ASSERT("the page try to dispose is in use. frame:%s", to_string(*used_frame).c_str());
-    frame_manager_.free(file_desc_, page_num, used_frame);
-  } else {
+  if (used_frame == nullptr) {
     LOG_WARN("failed to fetch the page while disposing it. pageNum=%d", page_num);
     return RC::NOTFOUND;
   }
 
+  // B+树乐观读的线程可能拿着过期的页号pin住了这个页面，它们校验版本号失败之后马上就会unpin。
+  // 等待时不能持有lock_，那些线程可能正在加载别的页面
+  while (frame_manager_.try_free(file_desc_, page_num, used_frame) != RC::SUCCESS) {
+    std::this_thread::yield();
+  }
+
+  std::scoped_lock lock_guard(lock_);
   hdr_frame_->mark_dirty();
   file_header_->allocated_pages--;
   char tmp = 1 << (page_num % 8);
@@ -456,19 +985,11 @@ RC DiskBufferPool::flush_page(Frame &frame) {
 }
 
 RC DiskBufferPool::flush_page_internal(Frame &frame) {
-  // The better way is use mmap the block into memory,
-  // so it is easier to flush data to file.
-
   Page &page = frame.page();
-  int64_t offset = ((int64_t)page.page_num) * sizeof(Page);
-  if (lseek(file_desc_, offset, SEEK_SET) == offset - 1) {
-    LOG_ERROR("Failed to flush page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, &page, sizeof(Page)) != 0) {
-    LOG_ERROR("Failed to flush page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_WRITE;
+  RC rc = bp_manager_.page_io().write_page(file_desc_, page.page_num, page);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to flush page %d of %d. rc=%s", page.page_num, file_desc_, strrc(rc));
+    return rc;
   }
   frame.clear_dirty();
   LOG_DEBUG("Flush block. file desc=%d, pageNum=%d, pin count=%d", file_desc_, page.page_num, frame.pin_count());
@@ -477,14 +998,40 @@ RC DiskBufferPool::flush_page_internal(Frame &frame) {
 }
 
 RC DiskBufferPool::flush_all_pages() {
+  std::scoped_lock lock_guard(lock_);
+
   std::list<Frame *> used = frame_manager_.find_list(file_desc_);
+  std::vector<Frame *> dirty_frames;
+  std::vector<PageIoRequest> requests;
   for (Frame *frame : used) {
-    RC rc = flush_page(*frame);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to flush all pages");
-      return rc;
+    if (frame->dirty()) {
+      dirty_frames.push_back(frame);
+    } else {
+      frame->unpin();
     }
   }
+
+  // 按照页号排序，相邻的页面可以合并写
+  std::sort(dirty_frames.begin(), dirty_frames.end(),
+            [](const Frame *left, const Frame *right) { return left->page_num() < right->page_num(); });
+  requests.reserve(dirty_frames.size());
+  for (Frame *frame : dirty_frames) {
+    requests.push_back(PageIoRequest{file_desc_, frame->page_num(), &frame->page()});
+  }
+
+  RC rc = bp_manager_.page_io().write_pages(requests);
+  for (size_t i = 0; i < dirty_frames.size(); i++) {
+    if (OB_SUCC(requests[i].rc)) {
+      dirty_frames[i]->clear_dirty();
+    }
+    dirty_frames[i]->unpin();
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush all pages. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+    return rc;
+  }
+  LOG_DEBUG("flush all pages. file=%s, dirty pages=%d", file_name_.c_str(), static_cast<int>(dirty_frames.size()));
   return RC::SUCCESS;
 }
 
@@ -503,12 +1050,132 @@ RC DiskBufferPool::recover_page(PageNum page_num) {
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer) {
+int DiskBufferPool::prefetch_pages(const std::vector<PageNum> &pages, ScanRing *ring /* = nullptr */) {
+  int loaded = 0;
+  (void)load_pages(pages, ring, true /*evict*/, loaded);
+  return loaded;
+}
+
+RC DiskBufferPool::warm_pages(const std::vector<PageNum> &pages, int &loaded) {
+  return load_pages(pages, nullptr /*ring*/, false /*evict*/, loaded);
+}
+
+RC DiskBufferPool::load_pages(const std::vector<PageNum> &pages, ScanRing *ring, bool evict, int &loaded) {
+  std::scoped_lock lock_guard(lock_);
+
+  // 先为不在内存中的页面分配页帧，分配好的页帧加着写锁，加载完之后才能访问
+  RC rc = RC::SUCCESS;
+  std::vector<Frame *> frames;
+  frames.reserve(pages.size());
+  for (PageNum page_num : pages) {
+    Frame *frame = frame_manager_.get(file_desc_, page_num);
+    if (frame != nullptr) {
+      frame->unpin();
+      continue;
+    }
+
+    if (evict) {
+      rc = allocate_frame(page_num, &frame, false /*wait*/, ring);
+    } else {
+      frame = frame_manager_.alloc(file_desc_, page_num);
+      rc = frame != nullptr ? RC::SUCCESS : RC::BUFFERPOOL_NOBUF;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("no free frame for prefetching. file=%s, page num=%d", file_name_.c_str(), page_num);
+      break;
+    }
+
+    frame->set_file_desc(file_desc_);
+    frame->write_latch();
+    frames.push_back(frame);
+  }
+
+  std::vector<PageIoRequest> requests;
+  requests.reserve(frames.size());
+  for (Frame *frame : frames) {
+    requests.push_back(PageIoRequest{file_desc_, frame->page_num(), &frame->page()});
+  }
+  (void)bp_manager_.page_io().read_pages(requests);
+
+  loaded = 0;
+  for (size_t i = 0; i < frames.size(); i++) {
+    Frame *frame = frames[i];
+    frame->write_unlatch();
+    if (OB_SUCC(requests[i].rc)) {
+      frame->access();
+      frame->unpin();
+      loaded++;
+    } else {
+      // 读取的数据是不完整的，不能留在内存中
+      LOG_WARN("failed to prefetch page. file=%s, page num=%d, rc=%s",
+               file_name_.c_str(), frame->page_num(), strrc(requests[i].rc));
+      purge_frame(frame->page_num(), frame);
+    }
+  }
+
+  LOG_TRACE("prefetch pages done. file=%s, request=%d, loaded=%d", file_name_.c_str(), (int)pages.size(), loaded);
+  return rc;
+}
+
+void DiskBufferPool::advise_will_need(PageNum start_page, PageNum end_page) {
+#ifdef POSIX_FADV_WILLNEED
+  // O_DIRECT 不经过操作系统的缓存，提示也没有用
+  if (direct_io_ || end_page < start_page) {
+    return;
+  }
+
+  const off_t offset = static_cast<off_t>(start_page) * BP_PAGE_SIZE;
+  const off_t length = static_cast<off_t>(end_page - start_page + 1) * BP_PAGE_SIZE;
+  int ret = posix_fadvise(file_desc_, offset, length, POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    LOG_TRACE("failed to advise will need. file=%s, error=%s", file_name_.c_str(), strerror(ret));
+  }
+#endif
+}
+
+std::unique_ptr<ScanRing> DiskBufferPool::create_scan_ring() const {
+  const int ring_pages = bp_manager_.scan_ring_pages();
+  const double threshold = bp_manager_.scan_ring_threshold() * frame_manager_.total_frame_num();
+  if (ring_pages <= 0 || file_header_->allocated_pages <= threshold) {
+    return nullptr;
+  }
+
+  LOG_TRACE("scan file with ring buffer. file=%s, allocated pages=%d, ring pages=%d",
+            file_name_.c_str(), file_header_->allocated_pages, ring_pages);
+  return std::make_unique<ScanRing>(ring_pages);
+}
+
+RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer, bool wait /* = true */,
+                                  ScanRing *ring /* = nullptr */) {
+  ScanRing::Slot *slot = nullptr;
+  if (ring != nullptr) {
+    // 环中下一个位置的页帧没有人在使用并且是干净的，就直接拿来用，不需要从缓冲池中淘汰页面
+    slot = &ring->next_slot();
+    if (slot->frame != nullptr) {
+      Frame *frame = frame_manager_.reuse(slot->frame, slot->frame_id, file_desc_, page_num);
+      if (frame == slot->frame) {
+        ring->record_reuse();
+        slot->frame_id = FrameId(file_desc_, page_num);
+        *buffer = frame;
+        return RC::SUCCESS;
+      }
+
+      slot->frame = nullptr;
+      if (frame != nullptr) {
+        *buffer = frame;
+        return RC::SUCCESS;
+      }
+    }
+  }
+
   auto purger = [this](Frame *frame) {
     if (!frame->dirty()) {
       return RC::SUCCESS;
     }
 
+    // 淘汰时遇到脏页只能同步刷盘，说明后台刷得不够快
+    bp_manager_.page_cleaner().notify_dirty_eviction();
+
     RC rc = RC::SUCCESS;
     if (frame->file_desc() == file_desc_) {
       rc = this->flush_page_internal(*frame);
@@ -525,12 +1192,19 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer) {
   while (true) {
     Frame *frame = frame_manager_.alloc(file_desc_, page_num);
     if (frame != nullptr) {
+      if (slot != nullptr) {
+        slot->frame = frame;
+        slot->frame_id = FrameId(file_desc_, page_num);
+      }
       *buffer = frame;
       return RC::SUCCESS;
     }
 
     LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
-    (void)frame_manager_.purge_frames(1 /*count*/, purger);
+    int purged = frame_manager_.purge_frames(1 /*count*/, purger);
+    if (purged == 0 && !wait) {
+      return RC::BUFFERPOOL_NOBUF;
+    }
   }
   return RC::BUFFERPOOL_NOBUF;
 }
@@ -548,19 +1222,11 @@ RC DiskBufferPool::check_page_num(PageNum page_num) {
 }
 
 RC DiskBufferPool::load_page(PageNum page_num, Frame *frame) {
-  int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
-  }
-
-  Page &page = frame->page();
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
-  if (ret != 0) {
-    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
-              file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
-    return RC::IOERR_READ;
+  RC rc = bp_manager_.page_io().read_page(file_desc_, page_num, frame->page());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, rc=%s, page count=%d",
+              file_name_.c_str(), file_desc_, page_num, strrc(rc), file_header_->allocated_pages);
+    return rc;
   }
   return RC::SUCCESS;
 }
@@ -569,17 +1235,45 @@ int DiskBufferPool::file_desc() const { return file_desc_; }
 
 int DiskBufferPool::page_num() const { return file_header_->page_count; }
 ////////////////////////////////////////////////////////////////////////////////
-BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */) {
+BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */, int frame_shard_num /* = 0 */,
+    const char *replacer /* = nullptr */, const char *io_backend /* = nullptr */,
+    const PageArenaOptions &arena_options /* = PageArenaOptions() */) {
+  page_io_.reset(PageIo::create(io_backend));
+  if (page_io_ == nullptr) {
+    LOG_WARN("unknown page io backend %s, use sync", io_backend);
+    page_io_.reset(new SyncPageIo());
+  }
+
   if (memory_size <= 0) {
     memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
   }
   const int pool_num = std::max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
-  frame_manager_.init(pool_num);
-  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d", memory_size,
-           pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num);
+  RC rc = frame_manager_.init(pool_num, frame_shard_num, replacer, arena_options);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("failed to init frame manager. replacer=%s, rc=%s", replacer, strrc(rc));
+    return;
+  }
+  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d, shard num: %d, replacer: %s, "
+           "io backend: %s, page memory: %s",
+           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num, static_cast<int>(frame_manager_.shard_num()),
+           frame_manager_.replacer_name(), page_io_->name(), frame_manager_.memory_mode());
+}
+
+RC BufferPoolManager::resize(size_t memory_size) {
+  const size_t pool_num = std::max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, static_cast<size_t>(1));
+  if (pool_num > static_cast<size_t>(std::numeric_limits<int>::max() / DEFAULT_ITEM_NUM_PER_POOL)) {
+    LOG_WARN("buffer pool memory size is too large. memory size=%lu", memory_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  return frame_manager_.resize(
+      static_cast<int>(pool_num), [this](Frame &frame) { return flush_page(frame); }, DEFAULT_RESIZE_TIMEOUT_MS);
 }
 
 BufferPoolManager::~BufferPoolManager() {
+  warmer_.stop();
+  page_cleaner_.stop();
+
   std::unordered_map<std::string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
@@ -600,13 +1294,22 @@ RC BufferPoolManager::create_file(const char *file_name) {
   /**
    * Here don't care about the failure
    */
-  fd = open(file_name, O_RDWR);
+  int flags = O_RDWR;
+#ifdef O_DIRECT
+  if (direct_io(file_name)) {
+    flags |= O_DIRECT;
+  }
+#endif
+  fd = open(file_name, flags);
+  if (fd < 0 && flags != O_RDWR && errno == EINVAL) {
+    fd = open(file_name, O_RDWR);
+  }
   if (fd < 0) {
     LOG_ERROR("Failed to open for readwrite %s, due to %s.", file_name, strerror(errno));
     return RC::IOERR_ACCESS;
   }
 
-  Page page;
+  alignas(BP_PAGE_ALIGNMENT) Page page;
   memset(&page, 0, BP_PAGE_SIZE);
 
   BPFileHeader *file_header = (BPFileHeader *)page.data;
@@ -615,16 +1318,11 @@ RC BufferPoolManager::create_file(const char *file_name) {
 
   char *bitmap = file_header->bitmap;
   bitmap[0] |= 0x01;
-  if (lseek(fd, 0, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to seek file %s to position 0, due to %s .", file_name, strerror(errno));
+  RC rc = page_io_->write_page(fd, BP_HEADER_PAGE, page);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to write header to file %s, rc=%s.", file_name, strrc(rc));
     close(fd);
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(fd, (char *)&page, BP_PAGE_SIZE) != 0) {
-    LOG_ERROR("Failed to write header to file %s, due to %s.", file_name, strerror(errno));
-    close(fd);
-    return RC::IOERR_WRITE;
+    return rc;
   }
 
   close(fd);
@@ -642,7 +1340,7 @@ RC BufferPoolManager::open_file(const char *_file_name, DiskBufferPool *&_bp) {
   }
 
   DiskBufferPool *bp = new DiskBufferPool(*this, frame_manager_);
-  RC rc = bp->open_file(_file_name);
+  RC rc = bp->open_file(_file_name, direct_io(_file_name));
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to open file name");
     delete bp;
@@ -689,6 +1387,23 @@ RC BufferPoolManager::close_file(const char *_file_name) {
   return RC::SUCCESS;
 }
 
+void BufferPoolManager::set_direct_io_databases(const std::string &names) {
+  direct_io_databases_.clear();
+  common::split_string(names, ", ", direct_io_databases_);
+}
+
+bool BufferPoolManager::direct_io(const char *file_name) const {
+  if (direct_io_databases_.empty()) {
+    return false;
+  }
+  if (direct_io_databases_.count("*") > 0) {
+    return true;
+  }
+
+  const std::string db_name = common::getFileName(common::getFilePath(file_name));
+  return direct_io_databases_.count(db_name) > 0;
+}
+
 RC BufferPoolManager::flush_page(Frame &frame) {
   int fd = frame.file_desc();
 
@@ -703,6 +1418,25 @@ RC BufferPoolManager::flush_page(Frame &frame) {
   return bp->flush_page(frame);
 }
 
+RC BufferPoolManager::start_page_cleaner(const PageCleanerOptions &options) { return page_cleaner_.start(options); }
+
+RC BufferPoolManager::start_warmer(const BufferPoolWarmerOptions &options) { return warmer_.start(options); }
+
+DiskBufferPool *BufferPoolManager::find_buffer_pool(const std::string &file_name) {
+  std::scoped_lock lock_guard(lock_);
+  auto iter = buffer_pools_.find(file_name);
+  return iter == buffer_pools_.end() ? nullptr : iter->second;
+}
+
+std::unordered_map<int, std::string> BufferPoolManager::opened_files() {
+  std::scoped_lock lock_guard(lock_);
+  std::unordered_map<int, std::string> file_names;
+  for (const auto &[fd, bp] : fd_buffer_pools_) {
+    file_names.emplace(fd, bp->file_name());
+  }
+  return file_names;
+}
+
 static BufferPoolManager *default_bpm = nullptr;
 void BufferPoolManager::set_instance(BufferPoolManager *bpm) {
   if (default_bpm != nullptr && bpm != nullptr) {
@@ -11,9 +11,15 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fcntl.h>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,15 +28,21 @@ See the Mulan PSL v2 for more details. */
 #include <sys/types.h>
 #include <time.h>
 #include <unordered_map>
+#include <vector>
 
 #include "common/lang/bitmap.h"
-#include "common/lang/lru_cache.h"
 #include "common/lang/mutex.h"
 #include "common/mm/mem_pool.h"
 #include "common/rc.h"
 #include "common/types.h"
+#include "storage/buffer/buffer_pool_warmer.h"
 #include "storage/buffer/frame.h"
 #include "storage/buffer/page.h"
+#include "storage/buffer/page_arena.h"
+#include "storage/buffer/page_cleaner.h"
+#include "storage/buffer/page_io.h"
+#include "storage/buffer/page_replacer.h"
+#include "storage/buffer/scan_ring.h"
 
 class BufferPoolManager;
 class DiskBufferPool;
@@ -73,12 +85,28 @@ struct BPFileHeader {
  * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
  * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的BufferPool磁盘文件
  * 在访问时都使用这个管理器映射到内存。
+ * 
+ * 为了避免所有线程都竞争同一把锁，页帧按照 FrameId::hash() 分散到多个分片(shard)中，
+ * 每个分片有自己的锁、页面置换策略和空闲页帧链表。分片的空闲页帧用完时，会从其它分片借用。
+ * 页面命中时只加分片的读锁，淘汰哪些页面由置换策略(PageReplacer)决定。
+ *
+ * 页帧和页面内存按照块(chunk)申请，每块默认 DEFAULT_ITEM_NUM_PER_POOL 个页帧，使用大页时至少一个大页。
+ * 运行时可以通过 resize 增加或者减少块的个数，不需要重启。
  */
 class BPFrameManager {
 public:
   BPFrameManager(const char *tag);
 
-  RC init(int pool_num);
+  /**
+   * @brief 初始化页帧管理器
+   *
+   * @param pool_num  内存池的个数，每个内存池有 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+   * @param shard_num 分片个数。小于等于0时按照CPU核数设置
+   * @param replacer  页面置换策略的名字，参考 PageReplacer::create
+   * @param arena_options 页面内存的申请方式
+   */
+  RC init(int pool_num, int shard_num = 0, const char *replacer = nullptr,
+          const PageArenaOptions &arena_options = PageArenaOptions());
   RC cleanup();
 
   /**
@@ -113,6 +141,21 @@ public:
    */
   RC free(int file_desc, PageNum page_num, Frame *frame);
 
+  /**
+   * @brief 与free相同，但是页帧被其它线程pin住时不释放，返回LOCKED_CONCURRENCY_CONFLICT
+   * @details 乐观读的线程不加锁就会pin住页面，释放页面的时候可能还有这样的线程没有退出
+   */
+  RC try_free(int file_desc, PageNum page_num, Frame *frame);
+
+  /**
+   * @brief 把一个没有被使用的页帧直接转给另一个页面，不经过空闲链表和置换策略的淘汰
+   * @details 环形缓冲区(ScanRing)重用页帧时使用。页帧必须仍然对应 old_id，没有被pin住并且不是脏页，
+   * 否则不能重用，返回nullptr。
+   * 如果其它线程已经加载了新的页面，页帧会放回空闲链表，返回已经加载的页帧。
+   * 返回的页帧都已经pin过
+   */
+  Frame *reuse(Frame *frame, const FrameId &old_id, int file_desc, PageNum page_num);
+
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
    * 尝试从pin count=0的页面中淘汰一些
@@ -122,16 +165,57 @@ public:
    */
   int purge_frames(int count, std::function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const { return frames_.count(); }
+  /**
+   * @brief 检查每个分片中最先会被淘汰的一部分页面，找出其中的脏页
+   * @details 不会改变置换策略的状态。返回的页帧都已经pin过，用完之后需要unpin
+   * @param ratio        每个分片检查多少比例的页面
+   * @param dirty_frames 检查范围内可以淘汰的脏页，按照淘汰顺序排列
+   * @return 一共检查了多少个页面
+   */
+  int find_dirty_victims(double ratio, std::vector<Frame *> &dirty_frames);
 
   /**
-   * 测试使用。返回已经从内存申请的个数
+   * @brief 列出所有页帧对应的页面，从最热的页面开始
+   * @details 每个分片按照置换策略的顺序从热到冷排列，再轮流从各个分片中取。不会改变置换策略的状态
    */
-  size_t total_frame_num() const { return allocator_.get_size(); }
+  void list_frames(std::vector<FrameId> &frame_ids);
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC free_internal(const FrameId &frame_id, Frame *frame);
+  /**
+   * 当前正在使用的页帧个数
+   */
+  size_t frame_num() const;
+
+  /**
+   * 返回已经从内存申请的页帧个数
+   */
+  size_t total_frame_num() const { return total_frame_num_.load(std::memory_order_relaxed); }
+
+  size_t shard_num() const { return shards_.size(); }
+
+  const char *replacer_name() const { return shards_.empty() ? "" : shards_.front()->replacer->name(); }
+
+  /**
+   * @brief 调整页帧的个数
+   * @details 扩容时申请新的内存块，把页帧平均放到各个分片的空闲链表中。
+   * 缩容时优先释放被pin住的页帧最少的内存块，块中的页帧先从空闲链表和页面映射中摘下来，
+   * 脏页使用 flusher 刷盘之后再摘，被pin住的页帧等待使用者释放。整块的页帧都摘下来之后，
+   * 把这块内存还给操作系统。至少保留一个内存块。
+   * 超时之后已经摘下来的页帧放回空闲链表，返回 LOCKED_CONCURRENCY_CONFLICT，已经释放的内存块不会恢复。
+   * @param pool_num   调整之后内存池的个数，每个内存池有 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+   * @param flusher    缩容时刷脏页使用。调用时持有页帧的读锁，没有持有分片的锁
+   * @param timeout_ms 缩容时等待页帧释放的最长时间
+   */
+  RC resize(int pool_num, const std::function<RC(Frame &frame)> &flusher, int timeout_ms);
+
+  /**
+   * @brief 页面内存的总大小
+   */
+  size_t memory_size() const;
+
+  /**
+   * @brief 页面内存实际的申请方式，参考 PageArena::mode
+   */
+  const char *memory_mode() const;
 
 private:
   class BPFrameIdHasher {
@@ -139,31 +223,152 @@ private:
     size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
   };
 
-  using FrameLruCache = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
-  using FrameAllocator = common::MemPoolSimple<Frame>;
+  using FrameMap = std::unordered_map<FrameId, Frame *, BPFrameIdHasher>;
+
+  /**
+   * @brief 一次申请的一块页帧和它们使用的页面内存
+   */
+  struct FrameChunk {
+    PageArena arena;
+    std::unique_ptr<Frame[]> frames;
+    size_t frame_count = 0;
+
+    bool contains(const Frame *frame) const { return frame >= frames.get() && frame < frames.get() + frame_count; }
+  };
+
+  /**
+   * @brief 页帧管理的一个分片
+   * @details 分片内的页面映射、置换策略和空闲链表都由分片自己的锁保护。
+   * 查找页面时加读锁，修改页面映射时加写锁。
+   * 按照缓存行对齐，避免不同分片的锁之间产生伪共享。
+   */
+  struct alignas(64) FrameShard {
+    mutable std::shared_mutex lock;
+    FrameMap frames;
+    std::unique_ptr<PageReplacer> replacer;
+    std::vector<Frame *> free_frames;
+    std::vector<Frame *> retired_frames; ///< 缩容时属于正在释放的内存块的空闲页帧
+  };
+
+  size_t shard_index(const FrameId &frame_id) const { return frame_id.hash() % shards_.size(); }
+
+  Frame *get_internal(FrameShard &shard, const FrameId &frame_id);
+  void attach_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame);
+  RC free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame);
+
+  /**
+   * 从其它分片的空闲链表中借用一个页帧。调用时不能持有任何分片的锁
+   */
+  Frame *steal_free_frame(size_t exclude_index);
+
+  /**
+   * 按照置换策略给出的顺序淘汰指定分片的页帧
+   */
+  int purge_shard_frames(FrameShard &shard, int count, const std::function<RC(Frame *frame)> &purger);
+
+  /**
+   * 把不再使用的页帧放回分片的空闲链表。调用时需要持有分片的写锁
+   */
+  void release_frame(FrameShard &shard, Frame *frame);
+
+  /**
+   * 申请一个新的内存块，页帧放到各个分片的空闲链表中。调用时需要持有 resize_lock_
+   */
+  RC add_chunk(size_t frame_count);
+
+  /**
+   * 缩容时选择下一个释放的内存块，返回在 chunks_ 中的下标。调用时需要持有 resize_lock_
+   */
+  size_t chunk_to_release() const;
+
+  /**
+   * 把指定内存块的页帧全部从分片中摘下来。调用时需要持有 resize_lock_
+   */
+  RC detach_chunk(FrameChunk &chunk, const std::function<RC(Frame &frame)> &flusher,
+                  std::chrono::steady_clock::time_point deadline);
 
-  std::mutex lock_;
-  FrameLruCache frames_;
-  FrameAllocator allocator_;
+  /**
+   * 从分片中摘下属于指定内存块并且没有被使用的页帧。调用时需要持有分片的写锁
+   * @param detached_frames 摘下来的页帧
+   * @param dirty_frames    没有被使用的脏页，已经pin过，刷盘之后需要unpin
+   */
+  void detach_shard_frames(FrameShard &shard, const FrameChunk &chunk, std::vector<Frame *> &detached_frames,
+                           std::vector<Frame *> &dirty_frames);
+
+private:
+  std::string name_;
+  PageArenaOptions arena_options_;
+  size_t chunk_frames_ = DEFAULT_ITEM_NUM_PER_POOL; ///< 每个内存块的页帧个数
+
+  mutable std::mutex resize_lock_; ///< 保护 chunks_，同时只能有一个线程调整大小
+  std::vector<std::unique_ptr<FrameChunk>> chunks_;
+  std::atomic<const FrameChunk *> retiring_chunk_{nullptr}; ///< 缩容时正在释放的内存块
+  std::atomic<size_t> total_frame_num_{0};
+
+  std::vector<std::unique_ptr<FrameShard>> shards_;
+
+  /// 每次淘汰从不同的分片开始，避免总是淘汰同一个分片中的页面
+  std::atomic<size_t> purge_cursor_{0};
 };
 
 /**
  * @brief 用于遍历BufferPool中的所有页面
  * @ingroup BufferPool
+ * @details 遍历是顺序访问页面的，连续访问了几个页面之后，就会提前把后面的页面批量加载到内存中(预读)，
+ * 避免每个页面都要单独读一次磁盘。
+ * 预读窗口从 READ_AHEAD_MIN_PAGES 开始，预读的页面大部分都不在内存中时翻倍，大部分已经在内存中时减半，
+ * 最大不超过 BufferPoolManager::read_ahead_max_pages。
+ * 当遍历到上一次预读窗口的第一个页面时，开始预读下一个窗口，同时提示操作系统在后台读取再下一个窗口，
+ * 这样批量读取时数据通常已经在操作系统的缓存中了。
+ * 设置了环形缓冲区(ScanRing)时，预读的页面也放在环中，预读窗口不超过环大小的一半。
  */
 class BufferPoolIterator {
 public:
   BufferPoolIterator();
   ~BufferPoolIterator();
 
-  RC init(DiskBufferPool &bp, PageNum start_page = 0);
+  /**
+   * @param bp         遍历的文件
+   * @param start_page 从这个页面的下一个页面开始遍历
+   * @param end_page   遍历到这个页面之前为止(不包含)，BP_INVALID_PAGE_NUM 表示一直到文件末尾。预读也不会超过这个页面
+   */
+  RC init(DiskBufferPool &bp, PageNum start_page = 0, PageNum end_page = BP_INVALID_PAGE_NUM);
   bool has_next();
   PageNum next();
   RC reset();
 
+  /// 当前的预读窗口大小，0表示还没有开始预读
+  int read_ahead_window() const { return read_ahead_window_; }
+
+  /**
+   * @brief 预读时使用的环形缓冲区，为空表示使用正常的缓冲池
+   */
+  void set_scan_ring(ScanRing *ring) { ring_ = ring; }
+
+public:
+  static constexpr int READ_AHEAD_MIN_PAGES = 4;
+  /// 连续访问了这么多个页面之后，才认为是顺序访问
+  static constexpr int READ_AHEAD_TRIGGER_PAGES = 2;
+
+private:
+  void read_ahead(PageNum current_page);
+
+  /**
+   * @brief 从 page_num 之后找到下一个需要遍历的页面，没有时返回-1
+   */
+  PageNum next_page_after(PageNum page_num);
+
 private:
+  DiskBufferPool *bp_ = nullptr;
+  ScanRing *ring_ = nullptr;
   common::Bitmap bitmap_;
   PageNum current_page_num_ = -1;
+  PageNum end_page_ = BP_INVALID_PAGE_NUM;
+
+  int sequential_count_ = 0;                    ///< 连续访问了多少个页面
+  int read_ahead_window_ = 0;                   ///< 当前预读窗口的大小
+  PageNum read_ahead_trigger_ = -1;             ///< 访问到这个页面时，预读下一个窗口
+  PageNum read_ahead_end_ = BP_INVALID_PAGE_NUM; ///< 已经预读的最后一个页面
 };
 
 /**
@@ -182,8 +387,13 @@ public:
 
   /**
    * 根据文件名打开一个分页文件
+   * @param direct_io 是否使用 O_DIRECT 绕过操作系统的页面缓存。文件系统不支持时退化成普通的读写
    */
-  RC open_file(const char *file_name);
+  RC open_file(const char *file_name, bool direct_io = false);
+
+  bool direct_io() const { return direct_io_; }
+
+  const std::string &file_name() const { return file_name_; }
 
   /**
    * 关闭分页文件
@@ -192,8 +402,9 @@ public:
 
   /**
    * 根据文件ID和页号获取指定页面到缓冲区，返回页面句柄指针。
+   * @param ring 页面不在内存中时，优先重用这个环形缓冲区中的页帧。为空时从缓冲池正常分配
    */
-  RC get_this_page(PageNum page_num, Frame **frame);
+  RC get_this_page(PageNum page_num, Frame **frame, ScanRing *ring = nullptr);
 
   /**
    * 在指定文件中分配一个新的页面，并将其放入缓冲区，返回页面句柄指针。
@@ -250,8 +461,48 @@ public:
 
   int page_num() const;
 
+  /**
+   * @brief 批量把页面加载到内存中，已经在内存中的页面会跳过
+   * @details 所有页面作为一批请求交给 PageIo 读取。加载之后的页面不会被pin住。
+   * 没有空闲页帧并且也淘汰不出页帧时就停止加载
+   * @param pages 要加载的页面，页号需要是递增的
+   * @param ring  参考 get_this_page
+   * @return 实际从磁盘读取了多少个页面
+   */
+  int prefetch_pages(const std::vector<PageNum> &pages, ScanRing *ring = nullptr);
+
+  /**
+   * @brief 预热缓冲池时批量加载页面，与 prefetch_pages 不同的是只使用空闲的页帧，不会淘汰其它页面
+   * @param loaded 返回实际从磁盘读取了多少个页面
+   * @return 没有空闲页帧时停止加载，返回 BUFFERPOOL_NOBUF
+   */
+  RC warm_pages(const std::vector<PageNum> &pages, int &loaded);
+
+  /**
+   * @brief 为顺序扫描整个文件创建环形缓冲区
+   * @details 文件的页面个数超过缓冲池页帧个数的一定比例时(BufferPoolManager::scan_ring_threshold)，
+   * 扫描使用环形缓冲区，避免把缓冲池中的热点页面都淘汰掉
+   * @return 文件比较小或者没有开启时返回nullptr
+   */
+  std::unique_ptr<ScanRing> create_scan_ring() const;
+
+  /**
+   * @brief 提示操作系统后面会读取这些页面，由操作系统在后台预读到它的缓存中
+   */
+  void advise_will_need(PageNum start_page, PageNum end_page);
+
 protected:
-  RC allocate_frame(PageNum page_num, Frame **buf);
+  /**
+   * @param wait 为false时，如果淘汰不出页帧，就返回 BUFFERPOOL_NOBUF，而不是一直等待
+   * @param ring 优先重用环形缓冲区中的页帧，分配到的页帧会记录到环中
+   */
+  RC allocate_frame(PageNum page_num, Frame **buf, bool wait = true, ScanRing *ring = nullptr);
+
+  /**
+   * @brief prefetch_pages 和 warm_pages 的实现
+   * @param evict 为false时只使用空闲的页帧，没有空闲页帧就停止加载并返回 BUFFERPOOL_NOBUF
+   */
+  RC load_pages(const std::vector<PageNum> &pages, ScanRing *ring, bool evict, int &loaded);
 
   /**
    * 刷新指定页面到磁盘(flush)，并且释放关联的Frame
@@ -275,6 +526,7 @@ private:
 
   std::string file_name_;
   int file_desc_ = -1;
+  bool direct_io_ = false;
   Frame *hdr_frame_ = nullptr;
   BPFileHeader *file_header_ = nullptr;
   std::set<PageNum> disposed_pages_;
@@ -291,7 +543,15 @@ private:
  */
 class BufferPoolManager {
 public:
-  BufferPoolManager(int memory_size = 0);
+  /**
+   * @param memory_size     页帧使用的内存大小，小于等于0时使用默认值
+   * @param frame_shard_num 页帧管理器的分片个数，小于等于0时按照CPU核数设置
+   * @param replacer        页面置换策略，参考 PageReplacer::create
+   * @param io_backend      页面读写的方式，参考 PageIo::create
+   * @param arena_options   页面内存的申请方式，比如是否使用大页
+   */
+  BufferPoolManager(int memory_size = 0, int frame_shard_num = 0, const char *replacer = nullptr,
+      const char *io_backend = nullptr, const PageArenaOptions &arena_options = PageArenaOptions());
   ~BufferPoolManager();
 
   RC create_file(const char *file_name);
@@ -300,14 +560,89 @@ public:
 
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 启动后台刷脏页的线程
+   */
+  RC start_page_cleaner(const PageCleanerOptions &options);
+  PageCleaner &page_cleaner() { return page_cleaner_; }
+
+  /**
+   * @brief 在后台加载上次保存的页面，并定期保存缓冲池中的页面列表
+   */
+  RC start_warmer(const BufferPoolWarmerOptions &options);
+  BufferPoolWarmer &warmer() { return warmer_; }
+
+  /**
+   * @brief 根据文件名查找已经打开的文件
+   * @return 文件没有打开时返回nullptr
+   */
+  DiskBufferPool *find_buffer_pool(const std::string &file_name);
+
+  /**
+   * @brief 所有打开的文件，文件描述符到文件名的映射
+   */
+  std::unordered_map<int, std::string> opened_files();
+
+  /**
+   * @brief 在线调整缓冲池的内存大小
+   * @details 缩容时会把要释放的页面刷盘，等待正在使用的页面释放，参考 BPFrameManager::resize
+   * @param memory_size 调整之后的内存大小，按照 DEFAULT_ITEM_NUM_PER_POOL 个页面向下取整，至少一个内存池
+   */
+  RC resize(size_t memory_size);
+
+  static constexpr int DEFAULT_RESIZE_TIMEOUT_MS = 10 * 1000;
+
+  size_t memory_size() const { return frame_manager_.memory_size(); }
+  const char *page_memory_mode() const { return frame_manager_.memory_mode(); }
+  size_t total_frame_num() const { return frame_manager_.total_frame_num(); }
+
+  PageIo &page_io() { return *page_io_; }
+
+  /**
+   * @brief 设置哪些数据库的数据文件和索引文件使用 O_DIRECT 打开
+   * @details 数据库的文件都放在以数据库名字命名的目录下，按照文件所在的目录名判断
+   * @param names 逗号分隔的数据库名字，* 表示所有数据库，空表示都不使用
+   */
+  void set_direct_io_databases(const std::string &names);
+  bool direct_io(const char *file_name) const;
+
+  static constexpr int DEFAULT_READ_AHEAD_MAX_PAGES = 64;
+
+  /**
+   * @brief 顺序遍历时最多预读多少个页面，0表示不预读
+   */
+  void set_read_ahead_max_pages(int pages) { read_ahead_max_pages_ = std::max(pages, 0); }
+  int read_ahead_max_pages() const { return read_ahead_max_pages_; }
+
+  /**
+   * @brief 设置大表扫描使用的环形缓冲区
+   * @param pages     环形缓冲区的页帧个数，0表示不使用环形缓冲区
+   * @param threshold 表的页面个数超过缓冲池页帧个数的这个比例时，扫描才使用环形缓冲区
+   */
+  void set_scan_ring(int pages, double threshold) {
+    scan_ring_pages_ = std::max(pages, 0);
+    scan_ring_threshold_ = threshold;
+  }
+  int scan_ring_pages() const { return scan_ring_pages_; }
+  double scan_ring_threshold() const { return scan_ring_threshold_; }
+
 public:
   static void set_instance(BufferPoolManager *bpm); // TODO 优化全局变量的表示方法
   static BufferPoolManager &instance();
 
 private:
   BPFrameManager frame_manager_{"BufPool"};
+  std::unique_ptr<PageIo> page_io_;
+  std::set<std::string> direct_io_databases_;
 
   common::Mutex lock_;
   std::unordered_map<std::string, DiskBufferPool *> buffer_pools_;
   std::unordered_map<int, DiskBufferPool *> fd_buffer_pools_;
+
+  PageCleaner page_cleaner_{*this, frame_manager_};
+  BufferPoolWarmer warmer_{*this, frame_manager_};
+
+  int read_ahead_max_pages_ = DEFAULT_READ_AHEAD_MAX_PAGES;
+  int scan_ring_pages_ = ScanRing::DEFAULT_SIZE;
+  double scan_ring_threshold_ = ScanRing::DEFAULT_THRESHOLD;
 };
@@ -62,21 +62,25 @@ void Frame::write_latch(intptr_t xid) {
     ASSERT(pin_count_.load() > 0,
            "frame lock. write lock failed while pin count is invalid. "
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
     ASSERT(read_lockers_.find(xid) == read_lockers_.end(),
            "frame lock write while holding the read lock."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
   }
 
   lock_.lock();
   write_locker_ = xid;
-  write_recursive_count_++;
+  if (write_recursive_count_++ == 0) {
+    // 版本号变成奇数之后才能修改页面，乐观读的线程看到奇数就知道页面正在被修改
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   LOG_DEBUG("frame write lock success."
             "this=%p, pin=%d, pageNum=%d, write locker=%lx(recursive=%d), fd=%d, xid=%lx, lbt=%s",
-            this, pin_count_.load(), page_.page_num, write_locker_, write_recursive_count_, file_desc_, xid, lbt());
+            this, pin_count_.load(), page_num(), write_locker_, write_recursive_count_, file_desc_, xid, lbt());
 }
 
 void Frame::write_unlatch() { write_unlatch(get_default_debug_xid()); }
@@ -88,18 +92,19 @@ void Frame::write_unlatch(intptr_t xid) {
   ASSERT(pin_count_.load() > 0,
          "frame lock. write unlock failed while pin count is invalid."
          "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-         this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+         this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
   ASSERT(write_locker_ == xid,
          "frame unlock write while not the owner."
          "write_locker=%lx, this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-         write_locker_, this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+         write_locker_, this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
   LOG_DEBUG("frame write unlock success. this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s", this, pin_count_.load(),
-            page_.page_num, file_desc_, xid, lbt());
+            page_num(), file_desc_, xid, lbt());
 
   if (--write_recursive_count_ == 0) {
     write_locker_ = 0;
+    version_.fetch_add(1, std::memory_order_release);
   }
   debug_lock_.unlock();
 
@@ -114,12 +119,12 @@ void Frame::read_latch(intptr_t xid) {
     ASSERT(pin_count_ > 0,
            "frame lock. read lock failed while pin count is invalid."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
     ASSERT(xid != write_locker_,
            "frame lock read while holding the write lock."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
   }
 
   lock_.lock_shared();
@@ -129,7 +134,7 @@ void Frame::read_latch(intptr_t xid) {
     int recursive_count = ++read_lockers_[xid];
     LOG_DEBUG("frame read lock success."
               "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, recursive=%d, lbt=%s",
-              this, pin_count_.load(), page_.page_num, file_desc_, xid, recursive_count, lbt());
+              this, pin_count_.load(), page_num(), file_desc_, xid, recursive_count, lbt());
   }
 }
 
@@ -140,12 +145,12 @@ bool Frame::try_read_latch() {
     ASSERT(pin_count_ > 0,
            "frame try lock. read lock failed while pin count is invalid."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
     ASSERT(xid != write_locker_,
            "frame try to lock read while holding the write lock."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
   }
 
   bool ret = lock_.try_lock_shared();
@@ -154,7 +159,7 @@ bool Frame::try_read_latch() {
     int recursive_count = ++read_lockers_[xid];
     LOG_DEBUG("frame read lock success."
               "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, recursive=%d, lbt=%s",
-              this, pin_count_.load(), page_.page_num, file_desc_, xid, recursive_count, lbt());
+              this, pin_count_.load(), page_num(), file_desc_, xid, recursive_count, lbt());
     debug_lock_.unlock();
   }
 
@@ -169,7 +174,7 @@ void Frame::read_unlatch(intptr_t xid) {
     ASSERT(pin_count_.load() > 0,
            "frame lock. read unlock failed while pin count is invalid."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
 #if DEBUG
     auto read_lock_iter = read_lockers_.find(xid);
@@ -177,7 +182,7 @@ void Frame::read_unlatch(intptr_t xid) {
     ASSERT(recursive_count > 0,
            "frame unlock while not holding read lock."
            "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, recursive=%d, lbt=%s",
-           this, pin_count_.load(), page_.page_num, file_desc_, xid, recursive_count, lbt());
+           this, pin_count_.load(), page_num(), file_desc_, xid, recursive_count, lbt());
 
     if (1 == recursive_count) {
       read_lockers_.erase(xid);
@@ -188,7 +193,7 @@ void Frame::read_unlatch(intptr_t xid) {
 
   LOG_DEBUG("frame read unlock success."
             "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-            this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+            this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
   lock_.unlock_shared();
 }
@@ -201,7 +206,7 @@ void Frame::pin() {
 
   LOG_DEBUG("after frame pin. "
             "this=%p, write locker=%lx, read locker has xid %d? pin=%d, fd=%d, pageNum=%d, xid=%lx, lbt=%s",
-            this, write_locker_, read_lockers_.find(xid) != read_lockers_.end(), pin_count, file_desc_, page_.page_num,
+            this, write_locker_, read_lockers_.find(xid) != read_lockers_.end(), pin_count, file_desc_, page_num(),
             xid, lbt());
 }
 
@@ -211,7 +216,7 @@ int Frame::unpin() {
   ASSERT(pin_count_.load() > 0,
          "try to unpin a frame that pin count <= 0."
          "this=%p, pin=%d, pageNum=%d, fd=%d, xid=%lx, lbt=%s",
-         this, pin_count_.load(), page_.page_num, file_desc_, xid, lbt());
+         this, pin_count_.load(), page_num(), file_desc_, xid, lbt());
 
   std::scoped_lock debug_lock(debug_lock_);
 
@@ -219,16 +224,16 @@ int Frame::unpin() {
 
   LOG_DEBUG("after frame unpin. "
             "this=%p, write locker=%lx, read locker has xid? %d, pin=%d, fd=%d, pageNum=%d, xid=%lx, lbt=%s",
-            this, write_locker_, read_lockers_.find(xid) != read_lockers_.end(), pin_count, file_desc_, page_.page_num,
+            this, write_locker_, read_lockers_.find(xid) != read_lockers_.end(), pin_count, file_desc_, page_num(),
             xid, lbt());
 
   if (0 == pin_count) {
     ASSERT(write_locker_ == 0,
            "frame unpin to 0 failed while someone hold the write lock. write locker=%lx, pageNum=%d, fd=%d, xid=%lx",
-           write_locker_, page_.page_num, file_desc_, xid);
+           write_locker_, page_num(), file_desc_, xid);
     ASSERT(read_lockers_.empty(),
            "frame unpin to 0 failed while someone hold the read locks. reader num=%d, pageNum=%d, fd=%d, xid=%lx",
-           read_lockers_.size(), page_.page_num, file_desc_, xid);
+           read_lockers_.size(), page_num(), file_desc_, xid);
   }
   return pin_count;
 }
@@ -55,6 +55,11 @@ private:
  * 
  * 为了防止在使用过程中页面被淘汰，这里使用了pin count，当页面被使用时，pin count会增加，
  * 当页面不再使用时，pin count会减少。当pin count为0时，页面可以被淘汰。
+ *
+ * 除了读写锁，页帧上还有一个版本号，用于乐观读：第一次加写锁时版本号加一变成奇数，
+ * 最后一次释放写锁时再加一变成偶数。读者不加锁，读取之前记录版本号(version)，
+ * 读取之后检查版本号没有变化(validate)，就说明读取期间没有人修改过页面，否则需要重新读取。
+ * 乐观读的时候仍然需要pin住页面，防止页帧被淘汰之后用来存放其它页面。
  */
 class Frame {
 public:
@@ -70,16 +75,23 @@ public:
   void reinit() {}
   void reset() {}
 
-  void clear_page() { memset(&page_, 0, sizeof(page_)); }
+  void clear_page() { memset(page_, 0, sizeof(Page)); }
 
   int file_desc() const { return file_desc_; }
   void set_file_desc(int fd) { file_desc_ = fd; }
-  Page &page() { return page_; }
-  PageNum page_num() const { return page_.page_num; }
-  void set_page_num(PageNum page_num) { page_.page_num = page_num; }
-  FrameId frame_id() const { return FrameId(file_desc_, page_.page_num); }
-  LSN lsn() const { return page_.lsn; }
-  void set_lsn(LSN lsn) { page_.lsn = lsn; }
+  Page &page() { return *page_; }
+  PageNum page_num() const { return page_->page_num; }
+  void set_page_num(PageNum page_num) { page_->page_num = page_num; }
+  FrameId frame_id() const { return FrameId(file_desc_, page_->page_num); }
+  LSN lsn() const { return page_->lsn; }
+  void set_lsn(LSN lsn) { page_->lsn = lsn; }
+
+  /**
+   * @brief 设置页帧使用的页面内存
+   * @details 页面内存由 BPFrameManager 从 PageArena 中统一分配，按照 BP_PAGE_ALIGNMENT 对齐，
+   * 可以直接用于 O_DIRECT 读写
+   */
+  void set_page(Page *page) { page_ = page; }
 
   /// 刷新访问时间 TODO touch is better?
   void access();
@@ -92,7 +104,7 @@ public:
   void clear_dirty() { dirty_ = false; }
   bool dirty() const { return dirty_; }
 
-  char *data() { return page_.data; }
+  char *data() { return page_->data; }
 
   bool can_purge() { return pin_count_.load() == 0; }
 
@@ -109,6 +121,13 @@ public:
   int unpin();
   int pin_count() const { return pin_count_.load(); }
 
+  /**
+   * @brief 页面置换策略使用的访问标识
+   * @details 页面命中时只持有页帧分片的读锁，可能有多个线程同时修改，所以是原子变量
+   */
+  bool referenced() const { return referenced_.load(std::memory_order_relaxed); }
+  void set_referenced(bool referenced) { referenced_.store(referenced, std::memory_order_relaxed); }
+
   void write_latch();
   void write_latch(intptr_t xid);
 
@@ -122,6 +141,20 @@ public:
   void read_unlatch();
   void read_unlatch(intptr_t xid);
 
+  /**
+   * @brief 乐观读开始时获取版本号
+   * @details 版本号是奇数时说明有人持有写锁，正在修改页面，读到的数据是无效的
+   */
+  uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 检查从获取版本号之后，页面有没有被修改过
+   */
+  bool validate(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   friend std::string to_string(const Frame &frame);
 
 private:
@@ -130,8 +163,10 @@ private:
   bool dirty_ = false;
   std::atomic<int> pin_count_{0};
   unsigned long acc_time_ = 0;
+  std::atomic<bool> referenced_{false};
+  std::atomic<uint64_t> version_{0};
   int file_desc_ = -1;
-  Page page_;
+  Page *page_ = nullptr;
 
   /// 在非并发编译时，加锁解锁动作将什么都不做
   common::RecursiveSharedMutex lock_;
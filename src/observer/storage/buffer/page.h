@@ -24,6 +24,9 @@ static constexpr PageNum BP_HEADER_PAGE = 0;
 static constexpr const int BP_PAGE_SIZE = (1 << 13);
 static constexpr const int BP_PAGE_DATA_SIZE = (BP_PAGE_SIZE - sizeof(PageNum) - sizeof(LSN));
 
+/// 页面内存的对齐要求，满足 O_DIRECT 对内存地址、文件偏移和读写长度的要求
+static constexpr const int BP_PAGE_ALIGNMENT = 4096;
+
 /**
  * @brief 表示一个页面，可能放在内存或磁盘上
  * @ingroup BufferPool
@@ -0,0 +1,121 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "common/log/log.h"
+#include "storage/buffer/page_arena.h"
+
+static_assert(BP_PAGE_SIZE % BP_PAGE_ALIGNMENT == 0, "page size should be a multiple of page alignment");
+static_assert(sizeof(Page) == BP_PAGE_SIZE, "page should not have padding");
+
+static size_t align_up(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+PageArena::~PageArena() { cleanup(); }
+
+RC PageArena::init(size_t page_count, const PageArenaOptions &options /* = PageArenaOptions() */) {
+  cleanup();
+
+  const size_t size = page_count * BP_PAGE_SIZE;
+  bool mapped = false;
+  if (options.huge_page) {
+    mapped = map_huge_tlb(size) || map_normal(size, HUGE_PAGE_SIZE);
+  } else {
+    mapped = map_normal(size, BP_PAGE_ALIGNMENT);
+  }
+  if (!mapped) {
+    return RC::NOMEM;
+  }
+  page_count_ = page_count;
+
+  if (options.huge_page) {
+#ifdef MADV_HUGEPAGE
+    if (strcmp(mode_, "hugetlb") != 0) {
+      if (madvise(memory_, align_up(size, HUGE_PAGE_SIZE), MADV_HUGEPAGE) == 0) {
+        mode_ = "thp";
+      } else {
+        LOG_WARN("failed to advise huge page. error=%s", strerror(errno));
+      }
+    }
+#endif
+    // 提前访问一遍，在启动时就分配好内存。透明大页只有在第一次访问时才会分配
+    const long os_page_size = sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < size; offset += os_page_size) {
+      memory_[offset] = 0;
+    }
+  }
+
+  if (options.lock_memory) {
+    if (mlock(memory_, size) == 0) {
+      locked_ = true;
+    } else {
+      LOG_WARN("failed to lock page arena memory, continue without mlock. size=%lu, error=%s", size, strerror(errno));
+    }
+  }
+
+  LOG_INFO("page arena allocated. page count=%lu, memory size=%lu, mode=%s, locked=%d",
+           page_count_, memory_size(), mode_, locked_);
+  return RC::SUCCESS;
+}
+
+bool PageArena::map_huge_tlb(size_t size) {
+#ifdef MAP_HUGETLB
+  const size_t mapped_size = align_up(size, HUGE_PAGE_SIZE);
+  void *addr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (addr == MAP_FAILED) {
+    LOG_INFO("no huge tlb pages available, fallback to transparent huge pages. size=%lu, error=%s",
+             mapped_size, strerror(errno));
+    return false;
+  }
+
+  mapped_ = addr;
+  mapped_size_ = mapped_size;
+  memory_ = static_cast<char *>(addr);
+  mode_ = "hugetlb";
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PageArena::map_normal(size_t size, size_t alignment) {
+  // 多申请一些，从中截取按照 alignment 对齐的部分
+  const size_t mapped_size = align_up(size, alignment) + alignment;
+  void *addr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) {
+    LOG_ERROR("failed to allocate page arena. size=%lu, error=%s", mapped_size, strerror(errno));
+    return false;
+  }
+
+  mapped_ = addr;
+  mapped_size_ = mapped_size;
+  memory_ = reinterpret_cast<char *>(align_up(reinterpret_cast<size_t>(addr), alignment));
+  mode_ = "normal";
+  return true;
+}
+
+void PageArena::cleanup() {
+  if (mapped_ != nullptr) {
+    if (locked_) {
+      munlock(memory_, memory_size());
+    }
+    munmap(mapped_, mapped_size_);
+  }
+
+  memory_ = nullptr;
+  page_count_ = 0;
+  mapped_ = nullptr;
+  mapped_size_ = 0;
+  mode_ = "normal";
+  locked_ = false;
+}
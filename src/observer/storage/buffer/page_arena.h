@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 页面内存的申请方式
+ * @ingroup BufferPool
+ */
+struct PageArenaOptions {
+  bool huge_page = false;   ///< 使用大页，减少随机访问页面时的TLB miss
+  bool lock_memory = false; ///< 使用 mlock 锁住内存，避免被换出
+};
+
+/**
+ * @brief 缓冲池所有页面使用的一整块内存
+ * @ingroup BufferPool
+ * @details 页帧的管理信息(Frame)和页面内容分开存放，页面内容在启动时一次性使用 mmap 申请好，
+ * 每个页面的起始地址都按照 BP_PAGE_ALIGNMENT 对齐，可以直接用于 O_DIRECT 读写。
+ *
+ * 使用大页时，先尝试 MAP_HUGETLB(需要系统预留了大页)，失败后再申请普通内存，
+ * 按照大页对齐并使用 madvise(MADV_HUGEPAGE) 请求透明大页，然后提前访问一遍，让内核在启动时就分配好大页。
+ * 都不支持时就是普通的内存。mlock 失败(通常是 RLIMIT_MEMLOCK 太小)只打印警告。
+ */
+class PageArena {
+public:
+  PageArena() = default;
+  ~PageArena();
+
+  PageArena(const PageArena &) = delete;
+  PageArena &operator=(const PageArena &) = delete;
+
+  /// 大页的大小。x86_64 和 aarch64 上默认的大页都是2M
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  RC init(size_t page_count, const PageArenaOptions &options = PageArenaOptions());
+  void cleanup();
+
+  Page *page(size_t index) const { return reinterpret_cast<Page *>(memory_ + index * BP_PAGE_SIZE); }
+  size_t page_count() const { return page_count_; }
+  size_t memory_size() const { return page_count_ * BP_PAGE_SIZE; }
+
+  /**
+   * @brief 内存实际的申请方式
+   * @return hugetlb, thp 或者 normal
+   */
+  const char *mode() const { return mode_; }
+  bool locked() const { return locked_; }
+
+private:
+  bool map_huge_tlb(size_t size);
+  bool map_normal(size_t size, size_t alignment);
+
+private:
+  char *memory_ = nullptr;
+  size_t page_count_ = 0;
+
+  void *mapped_ = nullptr; ///< mmap 返回的地址，为了对齐可能比 memory_ 小
+  size_t mapped_size_ = 0;
+  const char *mode_ = "normal";
+  bool locked_ = false;
+};
@@ -0,0 +1,186 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/page_cleaner.h"
+
+using namespace std;
+using namespace common;
+
+static const char *FLUSHED_PAGES_METRIC = "buffer_pool.cleaner.flushed_pages";
+static const char *DIRTY_STALLS_METRIC = "buffer_pool.eviction.dirty_stalls";
+
+static long current_time_ms() {
+  return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static Counter &flushed_pages_counter() {
+  static Counter &counter = register_counter(FLUSHED_PAGES_METRIC);
+  return counter;
+}
+
+static Counter &dirty_stalls_counter() {
+  static Counter &counter = register_counter(DIRTY_STALLS_METRIC);
+  return counter;
+}
+
+long PageCleaner::flushed_pages() { return flushed_pages_counter().value(); }
+long PageCleaner::dirty_stalls() { return dirty_stalls_counter().value(); }
+
+PageCleaner::PageCleaner(BufferPoolManager &bp_manager, BPFrameManager &frame_manager)
+    : bp_manager_(bp_manager), frame_manager_(frame_manager) {
+  (void)flushed_pages_counter();
+  (void)dirty_stalls_counter();
+}
+
+PageCleaner::~PageCleaner() { stop(); }
+
+RC PageCleaner::start(const PageCleanerOptions &options) {
+  if (options.tail_ratio <= 0 || options.tail_ratio > 1 || options.low_water_mark < 0 ||
+      options.low_water_mark > options.high_water_mark || options.high_water_mark > 1) {
+    LOG_ERROR("invalid page cleaner options. tail ratio=%f, low water mark=%f, high water mark=%f",
+              options.tail_ratio, options.low_water_mark, options.high_water_mark);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  stop();
+
+  options_ = options;
+  active_ = false;
+  tokens_ = 0;
+  last_refill_ms_ = current_time_ms();
+
+  if (options_.interval_ms <= 0) {
+    LOG_INFO("page cleaner is disabled");
+    return RC::SUCCESS;
+  }
+
+#ifndef CONCURRENCY
+  // 没有开启并发编译选项时，页帧的读写锁什么都不做，后台线程刷页面时可能与修改页面的线程冲突
+  LOG_WARN("page cleaner thread requires CONCURRENCY, it will not be started");
+  return RC::SUCCESS;
+#endif
+
+  running_ = true;
+  thread_ = thread(&PageCleaner::run, this);
+  LOG_INFO("page cleaner started. interval=%dms, tail ratio=%f, low water mark=%f, high water mark=%f, "
+           "max pages per second=%d",
+           options_.interval_ms, options_.tail_ratio, options_.low_water_mark, options_.high_water_mark,
+           options_.max_pages_per_second);
+  return RC::SUCCESS;
+}
+
+void PageCleaner::stop() {
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  LOG_INFO("page cleaner stopped");
+}
+
+void PageCleaner::notify_dirty_eviction() {
+  dirty_stalls_counter().inc();
+
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!running_) {
+      return;
+    }
+    wakeup_ = true;
+  }
+  cond_.notify_one();
+}
+
+void PageCleaner::run() {
+  unique_lock<mutex> lock(lock_);
+  while (running_) {
+    cond_.wait_for(lock, chrono::milliseconds(options_.interval_ms), [this]() { return !running_ || wakeup_; });
+    if (!running_) {
+      break;
+    }
+    wakeup_ = false;
+
+    lock.unlock();
+    clean_once();
+    lock.lock();
+  }
+}
+
+int PageCleaner::clean_once() {
+  lock_guard<mutex> round_guard(round_lock_);
+
+  vector<Frame *> dirty_frames;
+  const int scanned = frame_manager_.find_dirty_victims(options_.tail_ratio, dirty_frames);
+  const int dirty_num = static_cast<int>(dirty_frames.size());
+  const double dirty_ratio = (scanned == 0) ? 0 : static_cast<double>(dirty_num) / scanned;
+
+  if (dirty_ratio >= options_.high_water_mark && dirty_num > 0) {
+    active_ = true;
+  }
+
+  int flush_limit = 0;
+  if (active_) {
+    flush_limit = dirty_num - static_cast<int>(options_.low_water_mark * scanned);
+
+    if (options_.max_pages_per_second > 0) {
+      const long now = current_time_ms();
+      tokens_ = min(tokens_ + (now - last_refill_ms_) * options_.max_pages_per_second / 1000.0,
+                    static_cast<double>(options_.max_pages_per_second));
+      last_refill_ms_ = now;
+      flush_limit = min(flush_limit, static_cast<int>(tokens_));
+    }
+  }
+
+  // dirty_frames 是按照淘汰顺序排列的，先刷最先被淘汰的
+  int flushed = 0;
+  for (Frame *frame : dirty_frames) {
+    if (flushed < flush_limit && frame->try_read_latch()) {
+      // 持有读锁时不会有人修改页面，刷完之后清除脏标识是安全的。正在被修改的页面跳过
+      if (frame->dirty()) {
+        RC rc = bp_manager_.flush_page(*frame);
+        if (OB_SUCC(rc)) {
+          flushed++;
+        } else {
+          LOG_WARN("page cleaner failed to flush page. frame=%s, rc=%s", to_string(*frame).c_str(), strrc(rc));
+        }
+      }
+      frame->read_unlatch();
+    }
+    frame->unpin();
+  }
+
+  if (options_.max_pages_per_second > 0) {
+    tokens_ = max(tokens_ - flushed, 0.0);
+  }
+  if (dirty_num - flushed <= static_cast<int>(options_.low_water_mark * scanned)) {
+    active_ = false;
+  }
+
+  if (flushed > 0) {
+    flushed_pages_counter().inc(flushed);
+    LOG_DEBUG("page cleaner flushed %d pages. scanned=%d, dirty=%d", flushed, scanned, dirty_num);
+  }
+  return flushed;
+}
@@ -0,0 +1,101 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "common/rc.h"
+
+class BufferPoolManager;
+class BPFrameManager;
+
+/**
+ * @brief 后台刷脏页线程的参数
+ * @ingroup BufferPool
+ */
+struct PageCleanerOptions {
+  int interval_ms = 100;            ///< 两轮清理之间的间隔。小于等于0表示不启动后台线程
+  double tail_ratio = 0.25;         ///< 每个分片检查多少比例的即将被淘汰的页面
+  double low_water_mark = 0.1;      ///< 检查范围内脏页比例降到这个值以下时停止刷页面
+  double high_water_mark = 0.3;     ///< 检查范围内脏页比例超过这个值时开始刷页面
+  int max_pages_per_second = 1000;  ///< 每秒最多刷多少个页面。小于等于0表示不限制
+};
+
+/**
+ * @brief 后台刷脏页
+ * @ingroup BufferPool
+ * @details 淘汰页面时如果遇到脏页，需要先把页面写到磁盘上，这个IO就落在了恰好需要页帧的那个请求上。
+ * PageCleaner 在后台检查每个分片中即将被淘汰的那部分页面，提前把其中的脏页刷到磁盘，
+ * 这样淘汰时大部分页面都是干净的。
+ *
+ * 为了避免频繁地刷盘，使用了高低水位：检查范围内的脏页比例超过高水位时开始刷，一直刷到低水位以下。
+ * 每秒刷页面的个数也有限制，避免占用太多IO。
+ *
+ * 统计信息注册在 common::get_metrics_registry() 中：
+ * - buffer_pool.cleaner.flushed_pages 后台刷的页面个数
+ * - buffer_pool.eviction.dirty_stalls 淘汰时遇到脏页，只能同步刷盘的次数
+ */
+class PageCleaner {
+public:
+  PageCleaner(BufferPoolManager &bp_manager, BPFrameManager &frame_manager);
+  ~PageCleaner();
+
+  RC start(const PageCleanerOptions &options);
+  void stop();
+
+  /**
+   * @brief 执行一轮清理
+   * @details 后台线程会定期调用，也可以直接调用
+   * @return 本轮刷了多少个页面
+   */
+  int clean_once();
+
+  /**
+   * @brief 淘汰页面时遇到了脏页
+   * @details 记录统计信息，并唤醒后台线程
+   */
+  void notify_dirty_eviction();
+
+  /**
+   * @brief 每轮清理时都持有这把锁
+   * @details 清理时会pin住页面，关闭文件前要持有这把锁，保证文件的页面都能被释放
+   */
+  std::mutex &round_lock() { return round_lock_; }
+
+  const PageCleanerOptions &options() const { return options_; }
+
+  /// 后台刷的页面个数
+  static long flushed_pages();
+  /// 淘汰时遇到脏页的次数
+  static long dirty_stalls();
+
+private:
+  void run();
+
+private:
+  BufferPoolManager &bp_manager_;
+  BPFrameManager &frame_manager_;
+  PageCleanerOptions options_;
+
+  bool active_ = false; ///< 是否处于高低水位之间，需要继续刷页面
+  double tokens_ = 0;   ///< 限速用的令牌，每个令牌可以刷一个页面
+  long last_refill_ms_ = 0;
+
+  std::mutex round_lock_;
+
+  std::mutex lock_;
+  std::condition_variable cond_;
+  bool running_ = false;
+  bool wakeup_ = false;
+  std::thread thread_;
+};
@@ -0,0 +1,349 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define HAVE_IO_URING 1
+#endif
+#endif
+
+#include "common/log/log.h"
+#include "storage/buffer/page_io.h"
+
+using namespace std;
+
+/// io_uring 提交队列的长度
+static constexpr unsigned IO_URING_ENTRIES = 256;
+
+static off_t page_offset(PageNum page_num) { return static_cast<off_t>(page_num) * BP_PAGE_SIZE; }
+
+PageIo *PageIo::create(const char *name) {
+  if (name == nullptr || name[0] == '\0' || 0 == strcasecmp(name, "sync")) {
+    return new SyncPageIo();
+  }
+
+  if (0 == strcasecmp(name, "io_uring")) {
+    IoUringPageIo *page_io = new IoUringPageIo();
+    RC rc = page_io->init(IO_URING_ENTRIES);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("io_uring is not available, fallback to sync page io. rc=%s", strrc(rc));
+      delete page_io;
+      return new SyncPageIo();
+    }
+    return page_io;
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RC SyncPageIo::read_page(int file_desc, PageNum page_num, Page &page) {
+  char *buf = reinterpret_cast<char *>(&page);
+  size_t done = 0;
+  while (done < BP_PAGE_SIZE) {
+    ssize_t ret = pread(file_desc, buf + done, BP_PAGE_SIZE - done, page_offset(page_num) + done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      LOG_ERROR("failed to read page. file desc=%d, page num=%d, ret=%ld, error=%s",
+                file_desc, page_num, static_cast<long>(ret), ret == 0 ? "end of file" : strerror(errno));
+      return RC::IOERR_READ;
+    }
+    done += ret;
+  }
+  return RC::SUCCESS;
+}
+
+RC SyncPageIo::write_page(int file_desc, PageNum page_num, const Page &page) {
+  const char *buf = reinterpret_cast<const char *>(&page);
+  size_t done = 0;
+  while (done < BP_PAGE_SIZE) {
+    ssize_t ret = pwrite(file_desc, buf + done, BP_PAGE_SIZE - done, page_offset(page_num) + done);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      LOG_ERROR("failed to write page. file desc=%d, page num=%d, error=%s", file_desc, page_num, strerror(errno));
+      return RC::IOERR_WRITE;
+    }
+    done += ret;
+  }
+  return RC::SUCCESS;
+}
+
+RC SyncPageIo::read_pages(vector<PageIoRequest> &requests) { return batch_io(requests, false /*write*/); }
+
+RC SyncPageIo::write_pages(vector<PageIoRequest> &requests) { return batch_io(requests, true /*write*/); }
+
+RC SyncPageIo::batch_io(vector<PageIoRequest> &requests, bool write) {
+  RC result = RC::SUCCESS;
+  vector<struct iovec> iovs;
+  for (size_t begin = 0; begin < requests.size();) {
+    size_t end = begin + 1;
+    while (end < requests.size() && end - begin < IOV_MAX && requests[end].file_desc == requests[begin].file_desc &&
+           requests[end].page_num == requests[end - 1].page_num + 1) {
+      end++;
+    }
+
+    iovs.clear();
+    for (size_t i = begin; i < end; i++) {
+      iovs.push_back(iovec{requests[i].page, BP_PAGE_SIZE});
+    }
+
+    const PageIoRequest &first = requests[begin];
+    const ssize_t expected = static_cast<ssize_t>(iovs.size()) * BP_PAGE_SIZE;
+    ssize_t ret = write ? pwritev(first.file_desc, iovs.data(), static_cast<int>(iovs.size()), page_offset(first.page_num))
+                        : preadv(first.file_desc, iovs.data(), static_cast<int>(iovs.size()), page_offset(first.page_num));
+
+    for (size_t i = begin; i < end; i++) {
+      PageIoRequest &request = requests[i];
+      if (ret == expected) {
+        request.rc = RC::SUCCESS;
+      } else {
+        // 被信号打断或者只完成了一部分，逐个页面重新读写
+        request.rc = write ? write_page(request.file_desc, request.page_num, *request.page)
+                           : read_page(request.file_desc, request.page_num, *request.page);
+      }
+      if (OB_FAIL(request.rc) && OB_SUCC(result)) {
+        result = request.rc;
+      }
+    }
+    begin = end;
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+IoUringPageIo::~IoUringPageIo() { close(); }
+
+#ifdef HAVE_IO_URING
+
+RC IoUringPageIo::init(unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    LOG_WARN("failed to setup io_uring. error=%s", strerror(errno));
+    return (errno == ENOSYS) ? RC::UNIMPLENMENT : RC::IOERR_ACCESS;
+  }
+  ring_fd_ = fd;
+  entries_ = params.sq_entries;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    LOG_WARN("failed to map io_uring. error=%s", strerror(errno));
+    close();
+    return RC::IOERR_ACCESS;
+  }
+
+  char *sq = static_cast<char *>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+  char *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+
+  LOG_INFO("io_uring page io initialized. entries=%u", entries_);
+  return RC::SUCCESS;
+}
+
+void IoUringPageIo::close() {
+  if (sqes_ != nullptr && sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != MAP_FAILED) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr && sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  sqes_ = cq_ring_ = sq_ring_ = nullptr;
+
+  if (ring_fd_ >= 0) {
+    ::close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+RC IoUringPageIo::submit_batch(vector<PageIoRequest> &requests, size_t begin, size_t end, bool write) {
+  const unsigned count = static_cast<unsigned>(end - begin);
+  vector<struct iovec> iovs(count);
+  struct io_uring_sqe *sqes = static_cast<struct io_uring_sqe *>(sqes_);
+
+  // 只有持有锁的线程会修改提交队列的尾部，内核只在 io_uring_enter 中读取
+  unsigned tail = *sq_tail_;
+  const unsigned mask = *sq_mask_;
+  for (unsigned i = 0; i < count; i++) {
+    PageIoRequest &request = requests[begin + i];
+    iovs[i] = iovec{request.page, BP_PAGE_SIZE};
+
+    const unsigned index = tail & mask;
+    struct io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = request.file_desc;
+    sqe->addr = reinterpret_cast<unsigned long>(&iovs[i]);
+    sqe->len = 1;
+    sqe->off = page_offset(request.page_num);
+    sqe->user_data = begin + i;
+    sq_array_[index] = index;
+    tail++;
+  }
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+  unsigned submitted = 0;
+  unsigned completed = 0;
+  while (completed < count) {
+    int ret = enter(count - submitted, count - completed);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+
+      LOG_ERROR("failed to enter io_uring. submitted=%u, completed=%u, error=%s", submitted, completed, strerror(errno));
+      // 内核已经取走了提交的请求，还在提交队列中的请求撤回，否则下一批会把它们一起提交
+      __atomic_store_n(sq_tail_, __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+      drain(requests, submitted, completed, write);
+      if (submitted == 0) {
+        // 请求都没有提交，调用者使用同步读写
+        return RC::IOERR_ACCESS;
+      }
+      return write ? RC::IOERR_WRITE : RC::IOERR_READ;
+    }
+    submitted += static_cast<unsigned>(ret);
+    completed += reap_completions(requests, write);
+  }
+  return RC::SUCCESS;
+}
+
+int IoUringPageIo::enter(unsigned to_submit, unsigned min_complete) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0));
+}
+
+unsigned IoUringPageIo::reap_completions(vector<PageIoRequest> &requests, bool write) {
+  struct io_uring_cqe *cqes = static_cast<struct io_uring_cqe *>(cqes_);
+  unsigned head = *cq_head_;
+  const unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  const unsigned cq_mask = *cq_mask_;
+  unsigned reaped = 0;
+  for (; head != cq_tail; head++, reaped++) {
+    const struct io_uring_cqe &cqe = cqes[head & cq_mask];
+    PageIoRequest &request = requests[cqe.user_data];
+    if (cqe.res == BP_PAGE_SIZE) {
+      request.rc = RC::SUCCESS;
+    } else if (cqe.res >= 0 || cqe.res == -EAGAIN || cqe.res == -EINTR) {
+      // 只完成了一部分，同步地重新读写这个页面
+      request.rc = write ? SyncPageIo::write_page(request.file_desc, request.page_num, *request.page)
+                         : SyncPageIo::read_page(request.file_desc, request.page_num, *request.page);
+    } else {
+      LOG_ERROR("io_uring request failed. file desc=%d, page num=%d, write=%d, error=%s",
+                request.file_desc, request.page_num, write, strerror(-cqe.res));
+      request.rc = write ? RC::IOERR_WRITE : RC::IOERR_READ;
+    }
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  return reaped;
+}
+
+void IoUringPageIo::drain(vector<PageIoRequest> &requests, unsigned submitted, unsigned completed, bool write) {
+  completed += reap_completions(requests, write);
+  while (completed < submitted) {
+    int ret = enter(0, submitted - completed);
+    if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      // 没有办法再等待这些请求，关闭 ring 由内核取消它们，重新创建一个干净的 ring
+      LOG_ERROR("failed to wait io_uring requests, recreate the ring. pending=%u, error=%s",
+                submitted - completed, strerror(errno));
+      const unsigned entries = entries_;
+      close();
+      if (OB_FAIL(init(entries))) {
+        LOG_WARN("failed to recreate io_uring, use sync page io");
+      }
+      return;
+    }
+    completed += reap_completions(requests, write);
+  }
+}
+
+#else // HAVE_IO_URING
+
+RC IoUringPageIo::init(unsigned entries) {
+  LOG_WARN("io_uring is not supported by this build");
+  return RC::UNIMPLENMENT;
+}
+
+void IoUringPageIo::close() {}
+
+RC IoUringPageIo::submit_batch(vector<PageIoRequest> &requests, size_t begin, size_t end, bool write) {
+  return RC::UNIMPLENMENT;
+}
+
+int IoUringPageIo::enter(unsigned to_submit, unsigned min_complete) {
+  errno = ENOSYS;
+  return -1;
+}
+
+unsigned IoUringPageIo::reap_completions(vector<PageIoRequest> &requests, bool write) { return 0; }
+
+void IoUringPageIo::drain(vector<PageIoRequest> &requests, unsigned submitted, unsigned completed, bool write) {}
+
+#endif // HAVE_IO_URING
+
+RC IoUringPageIo::read_pages(vector<PageIoRequest> &requests) { return submit_and_wait(requests, false /*write*/); }
+
+RC IoUringPageIo::write_pages(vector<PageIoRequest> &requests) { return submit_and_wait(requests, true /*write*/); }
+
+RC IoUringPageIo::submit_and_wait(vector<PageIoRequest> &requests, bool write) {
+  {
+    lock_guard<mutex> guard(lock_);
+    if (requests.size() <= 1 || ring_fd_ < 0) {
+      return write ? SyncPageIo::write_pages(requests) : SyncPageIo::read_pages(requests);
+    }
+
+    for (size_t begin = 0; begin < requests.size(); begin += entries_) {
+      const size_t end = min(begin + entries_, requests.size());
+      RC rc = submit_batch(requests, begin, end, write);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to submit requests to io_uring, fallback to sync page io. rc=%s", strrc(rc));
+        vector<PageIoRequest> rest(requests.begin() + begin, requests.end());
+        rc = write ? SyncPageIo::write_pages(rest) : SyncPageIo::read_pages(rest);
+        copy(rest.begin(), rest.end(), requests.begin() + begin);
+        break;
+      }
+    }
+  }
+
+  for (const PageIoRequest &request : requests) {
+    if (OB_FAIL(request.rc)) {
+      return request.rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,157 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 一次页面读写请求
+ * @ingroup BufferPool
+ * @details 页面在文件中的偏移是 page_num * BP_PAGE_SIZE
+ */
+struct PageIoRequest {
+  int file_desc = -1;
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  Page *page = nullptr;
+  RC rc = RC::SUCCESS; ///< 请求完成后的结果
+};
+
+/**
+ * @brief 页面读写的接口
+ * @ingroup BufferPool
+ * @details DiskBufferPool 所有的磁盘读写都通过这个接口完成，一个 BufferPoolManager 有一个实例，
+ * 所有文件共用。实现需要是线程安全的。
+ * 单个页面的读写都是同步的；批量读写会一次提交所有请求，全部完成后才返回。
+ */
+class PageIo {
+public:
+  PageIo() = default;
+  virtual ~PageIo() = default;
+
+  virtual const char *name() const = 0;
+
+  virtual RC read_page(int file_desc, PageNum page_num, Page &page) = 0;
+  virtual RC write_page(int file_desc, PageNum page_num, const Page &page) = 0;
+
+  /**
+   * @brief 批量读取页面
+   * @details 每个请求的结果记录在 PageIoRequest::rc 中
+   * @return 所有请求都成功时返回SUCCESS，否则返回第一个失败的请求的结果
+   */
+  virtual RC read_pages(std::vector<PageIoRequest> &requests) = 0;
+
+  /**
+   * @brief 批量写页面，与 read_pages 类似
+   */
+  virtual RC write_pages(std::vector<PageIoRequest> &requests) = 0;
+
+public:
+  /**
+   * @brief 根据名字创建页面读写的实现
+   * @details 内核不支持 io_uring 时(或者编译环境没有 io_uring 的头文件)，io_uring 会退化成 sync
+   * @param name 可选的值为 sync, io_uring。为空时使用sync
+   * @return 名字不认识时返回nullptr
+   */
+  static PageIo *create(const char *name);
+};
+
+/**
+ * @brief 使用 pread/pwrite 同步读写
+ * @ingroup BufferPool
+ * @details 批量读写时，同一个文件中页号连续的页面合并成一次 preadv/pwritev
+ */
+class SyncPageIo : public PageIo {
+public:
+  const char *name() const override { return "sync"; }
+
+  RC read_page(int file_desc, PageNum page_num, Page &page) override;
+  RC write_page(int file_desc, PageNum page_num, const Page &page) override;
+  RC read_pages(std::vector<PageIoRequest> &requests) override;
+  RC write_pages(std::vector<PageIoRequest> &requests) override;
+
+private:
+  RC batch_io(std::vector<PageIoRequest> &requests, bool write);
+};
+
+/**
+ * @brief 使用 io_uring 批量读写
+ * @ingroup BufferPool
+ * @details 直接使用系统调用，不依赖 liburing。批量读写时把所有请求放到提交队列中，
+ * 一次 io_uring_enter 提交并等待全部完成，磁盘可以同时处理这些请求。
+ * 单个页面的读写放到队列中没有收益，仍然使用 pread/pwrite。
+ * 所有线程共用一个 ring，提交和收割都在一把锁内完成。
+ */
+class IoUringPageIo : public SyncPageIo {
+public:
+  IoUringPageIo() = default;
+  ~IoUringPageIo() override;
+
+  /**
+   * @brief 创建 io_uring
+   * @param entries 提交队列的长度，一次最多提交这么多请求
+   * @return 内核不支持或者没有权限时返回 UNIMPLENMENT/IOERR_ACCESS，调用者应该换成 SyncPageIo
+   */
+  RC init(unsigned entries);
+
+  const char *name() const override { return "io_uring"; }
+
+  RC read_pages(std::vector<PageIoRequest> &requests) override;
+  RC write_pages(std::vector<PageIoRequest> &requests) override;
+
+protected:
+  /**
+   * @brief 调用 io_uring_enter 提交请求并等待完成
+   * @details 返回值与系统调用相同，失败时返回-1并设置 errno。单测可以重载这个函数模拟提交失败
+   */
+  virtual int enter(unsigned to_submit, unsigned min_complete);
+
+private:
+  RC submit_and_wait(std::vector<PageIoRequest> &requests, bool write);
+  RC submit_batch(std::vector<PageIoRequest> &requests, size_t begin, size_t end, bool write);
+
+  /**
+   * @brief 收割完成队列中所有的完成事件，设置对应请求的结果
+   * @return 收割的个数
+   */
+  unsigned reap_completions(std::vector<PageIoRequest> &requests, bool write);
+
+  /**
+   * @brief 提交失败后，等待已经提交给内核的请求全部完成
+   * @details 这些请求还在使用 iovs 和页面，完成之前不能返回。等待也失败时关闭并重新创建 ring
+   */
+  void drain(std::vector<PageIoRequest> &requests, unsigned submitted, unsigned completed, bool write);
+  void close();
+
+private:
+  std::mutex lock_;
+  int ring_fd_ = -1; ///< ring 不可用时是-1，批量读写使用 pread/pwrite
+  unsigned entries_ = 0;
+
+  void *sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void *cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  void *sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_mask_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned *cq_mask_ = nullptr;
+  void *cqes_ = nullptr;
+};
@@ -0,0 +1,419 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include "storage/buffer/page_replacer.h"
+
+using namespace std;
+
+PageReplacer *PageReplacer::create(const char *name, size_t capacity) {
+  if (name == nullptr || name[0] == '\0' || 0 == strcasecmp(name, "lru")) {
+    return new LruPageReplacer();
+  } else if (0 == strcasecmp(name, "clock")) {
+    return new ClockPageReplacer();
+  } else if (0 == strcasecmp(name, "2q")) {
+    return new TwoQueuePageReplacer(capacity);
+  } else if (0 == strcasecmp(name, "lru-k")) {
+    return new LruKPageReplacer();
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LruPageReplacer::on_insert(Frame *frame) {
+  lock_guard<mutex> guard(lock_);
+  lru_list_.push_front(frame);
+  positions_[frame] = lru_list_.begin();
+}
+
+void LruPageReplacer::on_access(Frame *frame) {
+  lock_guard<mutex> guard(lock_);
+  auto iter = positions_.find(frame);
+  if (iter != positions_.end()) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+  }
+}
+
+void LruPageReplacer::on_remove(Frame *frame) {
+  lock_guard<mutex> guard(lock_);
+  auto iter = positions_.find(frame);
+  if (iter != positions_.end()) {
+    lru_list_.erase(iter->second);
+    positions_.erase(iter);
+  }
+}
+
+void LruPageReplacer::foreach_victim(const function<bool(Frame *)> &func) {
+  lock_guard<mutex> guard(lock_);
+  for (auto iter = lru_list_.rbegin(); iter != lru_list_.rend(); ++iter) {
+    if (!func(*iter)) {
+      break;
+    }
+  }
+}
+
+void LruPageReplacer::foreach_candidate(const function<bool(Frame *)> &func) { foreach_victim(func); }
+
+////////////////////////////////////////////////////////////////////////////////
+void ClockPageReplacer::on_insert(Frame *frame) {
+  frame->set_referenced(false);
+  // 放在时钟指针的后面，也就是指针转一圈之后才会检查到这个页面
+  auto iter = ring_.insert(hand_, frame);
+  positions_[frame] = iter;
+}
+
+void ClockPageReplacer::on_access(Frame *frame) { frame->set_referenced(true); }
+
+void ClockPageReplacer::on_remove(Frame *frame) {
+  auto iter = positions_.find(frame);
+  if (iter == positions_.end()) {
+    return;
+  }
+
+  if (hand_ == iter->second) {
+    advance_hand();
+  }
+  ring_.erase(iter->second);
+  positions_.erase(iter);
+
+  if (ring_.empty()) {
+    hand_ = ring_.end();
+  }
+}
+
+void ClockPageReplacer::advance_hand() {
+  if (hand_ != ring_.end()) {
+    ++hand_;
+  }
+  if (hand_ == ring_.end()) {
+    hand_ = ring_.begin();
+  }
+}
+
+void ClockPageReplacer::foreach_victim(const function<bool(Frame *)> &func) {
+  if (ring_.empty()) {
+    return;
+  }
+
+  if (hand_ == ring_.end()) {
+    hand_ = ring_.begin();
+  }
+
+  // 最多转两圈：第一圈清除访问标识，第二圈所有页面都有机会成为候选
+  const size_t max_steps = ring_.size() * 2;
+  for (size_t step = 0; step < max_steps; step++) {
+    Frame *frame = *hand_;
+    advance_hand();
+    if (frame->referenced()) {
+      frame->set_referenced(false);
+      continue;
+    }
+
+    if (!func(frame)) {
+      break;
+    }
+  }
+}
+
+void ClockPageReplacer::foreach_candidate(const function<bool(Frame *)> &func) {
+  if (ring_.empty()) {
+    return;
+  }
+
+  // 从时钟指针开始转一圈，有访问标识的页面这一圈不会被淘汰
+  auto iter = (hand_ == ring_.end()) ? ring_.begin() : hand_;
+  for (size_t step = 0; step < ring_.size(); step++) {
+    Frame *frame = *iter;
+    if (++iter == ring_.end()) {
+      iter = ring_.begin();
+    }
+
+    if (!frame->referenced() && !func(frame)) {
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TwoQueuePageReplacer::TwoQueuePageReplacer(size_t capacity)
+    : a1in_max_size_(std::max(capacity / 4, static_cast<size_t>(1))),
+      a1out_max_size_(std::max(capacity / 2, static_cast<size_t>(1))) {}
+
+void TwoQueuePageReplacer::set_capacity(size_t capacity) {
+  // 队列变短之后不立即淘汰，A1in 在下一次淘汰时按照新的长度处理，A1out 在下一次记录时截断
+  a1in_max_size_  = std::max(capacity / 4, static_cast<size_t>(1));
+  a1out_max_size_ = std::max(capacity / 2, static_cast<size_t>(1));
+}
+
+void TwoQueuePageReplacer::on_insert(Frame *frame) {
+  frame->set_referenced(false);
+
+  auto ghost = a1out_set_.find(frame->frame_id());
+  if (ghost != a1out_set_.end()) {
+    // 短时间内被再次加载，说明是热点页面。a1out_ 中的记录在淘汰时惰性删除
+    a1out_set_.erase(ghost);
+    am_.push_front(frame);
+    positions_[frame] = Position{Queue::AM, am_.begin()};
+  } else {
+    a1in_.push_back(frame);
+    positions_[frame] = Position{Queue::A1IN, std::prev(a1in_.end())};
+  }
+}
+
+void TwoQueuePageReplacer::on_access(Frame *frame) {
+  // A1in中的页面不关心这个标识，Am中的页面在淘汰时根据这个标识调整位置
+  frame->set_referenced(true);
+}
+
+void TwoQueuePageReplacer::on_remove(Frame *frame) {
+  auto iter = positions_.find(frame);
+  if (iter == positions_.end()) {
+    return;
+  }
+
+  const Position &position = iter->second;
+  if (position.queue == Queue::A1IN) {
+    a1in_.erase(position.iter);
+    remember_evicted(frame->frame_id());
+  } else {
+    am_.erase(position.iter);
+  }
+  positions_.erase(iter);
+}
+
+void TwoQueuePageReplacer::remember_evicted(const FrameId &frame_id) {
+  if (!a1out_set_.insert(frame_id).second) {
+    return;
+  }
+
+  a1out_.push_back(frame_id);
+  while (a1out_set_.size() > a1out_max_size_ && !a1out_.empty()) {
+    a1out_set_.erase(a1out_.front());
+    a1out_.pop_front();
+  }
+
+  // a1out_ 中可能有很多已经被提升到Am的过期记录，数量太多时整理一下
+  if (a1out_.size() > a1out_max_size_ * 2) {
+    deque<FrameId> live_ids;
+    for (const FrameId &id : a1out_) {
+      if (a1out_set_.count(id) > 0) {
+        live_ids.push_back(id);
+      }
+    }
+    a1out_.swap(live_ids);
+  }
+}
+
+void TwoQueuePageReplacer::foreach_victim(const function<bool(Frame *)> &func) {
+  auto visit_a1in = [this, &func]() -> bool {
+    for (Frame *frame : a1in_) {
+      if (!func(frame)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto visit_am = [this, &func]() -> bool {
+    // 从尾部开始，有访问标识的页面移动到头部。最多检查两遍，第二遍时标识都已经清除了
+    auto iter = am_.end();
+    for (size_t steps = am_.size() * 2; steps > 0 && iter != am_.begin(); steps--) {
+      auto current = std::prev(iter);
+      Frame *frame = *current;
+      if (frame->referenced()) {
+        frame->set_referenced(false);
+        am_.splice(am_.begin(), am_, current);
+        continue;
+      }
+
+      if (!func(frame)) {
+        return false;
+      }
+      iter = current;
+    }
+    return true;
+  };
+
+  if (a1in_.size() > a1in_max_size_ || am_.empty()) {
+    if (visit_a1in()) {
+      visit_am();
+    }
+  } else {
+    if (visit_am()) {
+      visit_a1in();
+    }
+  }
+}
+
+void TwoQueuePageReplacer::foreach_candidate(const function<bool(Frame *)> &func) {
+  auto visit_a1in = [this, &func]() -> bool {
+    for (Frame *frame : a1in_) {
+      if (!func(frame)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto visit_am = [this, &func]() -> bool {
+    // 有访问标识的页面淘汰时会被移动到头部，这里直接跳过
+    for (auto iter = am_.rbegin(); iter != am_.rend(); ++iter) {
+      if (!(*iter)->referenced() && !func(*iter)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  if (a1in_.size() > a1in_max_size_ || am_.empty()) {
+    if (visit_a1in()) {
+      visit_am();
+    }
+  } else {
+    if (visit_am()) {
+      visit_a1in();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LruKPageReplacer::on_insert(Frame *frame) {
+  // 同一个页帧可能刚被释放又重新使用，堆中残留的元素在取出时会被丢弃
+  History &history = histories_[frame];
+  history.last_stamp.store(clock_.fetch_add(1, memory_order_relaxed) + 1, memory_order_relaxed);
+  history.prev_stamp.store(0, memory_order_relaxed);
+  history.in_queue = true;
+  history.queue_iter = once_queue_.insert(once_queue_.end(), frame);
+  history.heap_stamp = 0;
+}
+
+void LruKPageReplacer::on_access(Frame *frame) {
+  // 只持有分片的读锁，不能修改 histories_ 本身，只修改其中的原子变量
+  auto iter = histories_.find(frame);
+  if (iter == histories_.end()) {
+    return;
+  }
+
+  History &history = iter->second;
+  const unsigned long stamp = clock_.fetch_add(1, memory_order_relaxed) + 1;
+  history.prev_stamp.store(history.last_stamp.exchange(stamp, memory_order_relaxed), memory_order_relaxed);
+}
+
+void LruKPageReplacer::on_remove(Frame *frame) {
+  auto iter = histories_.find(frame);
+  if (iter == histories_.end()) {
+    return;
+  }
+
+  if (iter->second.in_queue) {
+    once_queue_.erase(iter->second.queue_iter);
+  }
+  histories_.erase(iter);
+}
+
+void LruKPageReplacer::push_heap_item(unsigned long stamp, Frame *frame) {
+  heap_.emplace_back(stamp, frame);
+  push_heap(heap_.begin(), heap_.end(), greater<HeapItem>());
+}
+
+void LruKPageReplacer::rebuild_heap() {
+  heap_.clear();
+  for (auto &[frame, history] : histories_) {
+    if (!history.in_queue) {
+      history.heap_stamp = history.prev_stamp.load(memory_order_relaxed);
+      heap_.emplace_back(history.heap_stamp, frame);
+    }
+  }
+  make_heap(heap_.begin(), heap_.end(), greater<HeapItem>());
+}
+
+void LruKPageReplacer::foreach_victim(const function<bool(Frame *)> &func) {
+  for (auto iter = once_queue_.begin(); iter != once_queue_.end();) {
+    Frame *frame = *iter;
+    History &history = histories_[frame];
+    const unsigned long prev_stamp = history.prev_stamp.load(memory_order_relaxed);
+    if (prev_stamp != 0) {
+      // 已经访问过K次了
+      iter = once_queue_.erase(iter);
+      history.in_queue = false;
+      history.heap_stamp = prev_stamp;
+      push_heap_item(prev_stamp, frame);
+      continue;
+    }
+
+    if (!func(frame)) {
+      return;
+    }
+    ++iter;
+  }
+
+  // 被移除的页帧会在堆中留下无效的元素，太多时重建
+  if (heap_.size() > histories_.size() * 2) {
+    rebuild_heap();
+  }
+
+  vector<HeapItem> visited;
+  while (!heap_.empty()) {
+    pop_heap(heap_.begin(), heap_.end(), greater<HeapItem>());
+    const HeapItem item = heap_.back();
+    heap_.pop_back();
+
+    // 逻辑时间是唯一的，与 heap_stamp 不同说明是已经移除的页面或者重复使用页帧留下的元素
+    auto iter = histories_.find(item.second);
+    if (iter == histories_.end() || iter->second.in_queue || iter->second.heap_stamp != item.first) {
+      continue;
+    }
+
+    History &history = iter->second;
+    const unsigned long prev_stamp = history.prev_stamp.load(memory_order_relaxed);
+    if (prev_stamp != item.first) {
+      history.heap_stamp = prev_stamp;
+      push_heap_item(prev_stamp, item.second);
+      continue;
+    }
+
+    visited.push_back(item);
+    if (!func(item.second)) {
+      break;
+    }
+  }
+
+  // 没有被淘汰的页面还要放回去，被淘汰的会在下次取出时丢弃
+  for (const HeapItem &item : visited) {
+    push_heap_item(item.first, item.second);
+  }
+}
+
+void LruKPageReplacer::foreach_candidate(const function<bool(Frame *)> &func) {
+  for (Frame *frame : once_queue_) {
+    if (histories_.at(frame).prev_stamp.load(memory_order_relaxed) == 0 && !func(frame)) {
+      return;
+    }
+  }
+
+  // 不能修改堆，就把访问过K次的页面排个序。只有后台线程会调用，不在访问路径上
+  vector<HeapItem> items;
+  for (auto &[frame, history] : histories_) {
+    const unsigned long prev_stamp = history.prev_stamp.load(memory_order_relaxed);
+    if (prev_stamp != 0) {
+      items.emplace_back(prev_stamp, frame);
+    }
+  }
+  sort(items.begin(), items.end());
+
+  for (const HeapItem &item : items) {
+    if (!func(item.second)) {
+      break;
+    }
+  }
+}
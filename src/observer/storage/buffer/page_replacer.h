@@ -0,0 +1,224 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "storage/buffer/frame.h"
+
+/**
+ * @brief 页面置换策略
+ * @ingroup BufferPool
+ * @details 决定内存中的页帧不够用时，应该淘汰哪些页面。
+ * BPFrameManager 的每个分片都有一个自己的置换策略对象。
+ *
+ * 除了 on_access 之外，其它接口都是在分片的写锁内调用的。
+ * on_access 在页面命中时调用，此时只持有分片的读锁，多个线程可能同时调用，
+ * 所以实现时要么只原子地修改Frame上的访问信息，要么自己加锁。
+ */
+class PageReplacer {
+public:
+  PageReplacer() = default;
+  virtual ~PageReplacer() = default;
+
+  virtual const char *name() const = 0;
+
+  /**
+   * @brief 一个新的页面放入了内存
+   */
+  virtual void on_insert(Frame *frame) = 0;
+
+  /**
+   * @brief 页面命中
+   */
+  virtual void on_access(Frame *frame) = 0;
+
+  /**
+   * @brief 页面从内存中移除，可能是被淘汰了，也可能是被主动释放了
+   */
+  virtual void on_remove(Frame *frame) = 0;
+
+  /**
+   * @brief 按照淘汰的优先顺序遍历页面
+   * @details 遍历时不会检查页面是否可以淘汰，由调用者检查。
+   * 遍历过程中不能调用 on_insert/on_remove
+   * @param func 返回false时停止遍历
+   */
+  virtual void foreach_victim(const std::function<bool(Frame *)> &func) = 0;
+
+  /**
+   * @brief 按照淘汰的顺序预览页面，但是不改变置换策略的状态
+   * @details 用于后台刷脏页，只持有分片的读锁，顺序可以是近似的
+   * @param func 返回false时停止遍历
+   */
+  virtual void foreach_candidate(const std::function<bool(Frame *)> &func) = 0;
+
+  /**
+   * @brief 页帧个数变化之后调整内部队列的大小
+   * @details 在线调整缓冲池大小时调用，调用时持有分片的写锁
+   * @param capacity 期望的页帧个数，与 create 的参数含义相同
+   */
+  virtual void set_capacity(size_t capacity) {}
+
+public:
+  /**
+   * @brief 根据名字创建置换策略
+   * @param name 可选的值为 lru, clock, 2q, lru-k。为空时使用lru
+   * @param capacity 期望的页帧个数，有些策略需要根据这个值设置内部队列的大小
+   * @return 名字不认识时返回nullptr
+   */
+  static PageReplacer *create(const char *name, size_t capacity);
+};
+
+/**
+ * @brief 最近最少使用
+ * @ingroup BufferPool
+ * @details 命中时需要调整链表，所以有一把自己的锁
+ */
+class LruPageReplacer : public PageReplacer {
+public:
+  const char *name() const override { return "lru"; }
+
+  void on_insert(Frame *frame) override;
+  void on_access(Frame *frame) override;
+  void on_remove(Frame *frame) override;
+  void foreach_victim(const std::function<bool(Frame *)> &func) override;
+  void foreach_candidate(const std::function<bool(Frame *)> &func) override;
+
+private:
+  std::mutex lock_;
+  std::list<Frame *> lru_list_; ///< 头部是最近访问的
+  std::unordered_map<Frame *, std::list<Frame *>::iterator> positions_;
+};
+
+/**
+ * @brief 时钟置换(second chance)
+ * @ingroup BufferPool
+ * @details 命中时仅设置页帧的访问标识。淘汰时时钟指针扫过的页面如果有访问标识，
+ * 就清除标识再给一次机会，否则就作为候选页面
+ */
+class ClockPageReplacer : public PageReplacer {
+public:
+  const char *name() const override { return "clock"; }
+
+  void on_insert(Frame *frame) override;
+  void on_access(Frame *frame) override;
+  void on_remove(Frame *frame) override;
+  void foreach_victim(const std::function<bool(Frame *)> &func) override;
+  void foreach_candidate(const std::function<bool(Frame *)> &func) override;
+
+private:
+  void advance_hand();
+
+private:
+  std::list<Frame *> ring_;
+  std::list<Frame *>::iterator hand_ = ring_.end();
+  std::unordered_map<Frame *, std::list<Frame *>::iterator> positions_;
+};
+
+/**
+ * @brief 2Q
+ * @ingroup BufferPool
+ * @details 第一次访问的页面放在A1in先进先出队列中，A1in中的页面再次被访问不会提升它的位置，
+ * 所以一次全表扫描只会冲刷A1in。从A1in淘汰的页面会记录在A1out中，A1out中的页面再次被加载时
+ * 放入Am队列。Am队列命中时只设置访问标识，淘汰时有标识的页面移动到队头，近似LRU。
+ * 参考 2Q: A Low Overhead High Performance Buffer Management Replacement Algorithm (VLDB 1994)
+ */
+class TwoQueuePageReplacer : public PageReplacer {
+public:
+  explicit TwoQueuePageReplacer(size_t capacity);
+
+  const char *name() const override { return "2q"; }
+
+  void on_insert(Frame *frame) override;
+  void on_access(Frame *frame) override;
+  void on_remove(Frame *frame) override;
+  void foreach_victim(const std::function<bool(Frame *)> &func) override;
+  void foreach_candidate(const std::function<bool(Frame *)> &func) override;
+  void set_capacity(size_t capacity) override;
+
+private:
+  class FrameIdHasher {
+  public:
+    size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+  };
+
+  enum class Queue { A1IN, AM };
+
+  struct Position {
+    Queue queue;
+    std::list<Frame *>::iterator iter;
+  };
+
+  void remember_evicted(const FrameId &frame_id);
+
+private:
+  size_t a1in_max_size_;  ///< Kin，A1in的长度超过这个值时优先从A1in淘汰
+  size_t a1out_max_size_; ///< Kout，A1out最多记录多少个页面
+
+  std::list<Frame *> a1in_; ///< 尾部是最新进入的
+  std::list<Frame *> am_;   ///< 头部是最近访问的
+  std::unordered_map<Frame *, Position> positions_;
+
+  std::deque<FrameId> a1out_; ///< 只记录页面标识，不占用页帧
+  std::unordered_set<FrameId, FrameIdHasher> a1out_set_;
+};
+
+/**
+ * @brief LRU-K (K=2)
+ * @ingroup BufferPool
+ * @details 按照倒数第K次访问的时间淘汰页面，访问次数不足K次的页面优先淘汰，它们之间按照最后访问时间排序。
+ * 只访问过一次的页面，最后访问时间就是加载的时间，所以用一个先进先出队列就可以排好序。
+ * 访问过K次的页面放在一个按倒数第K次访问时间排序的小根堆中。
+ * 命中时只原子地修改访问时间，不调整队列和堆，淘汰时再惰性地修正：
+ * 队列中再次被访问过的页面移动到堆中；堆顶的访问时间过期了，就用新的访问时间重新放入堆中。
+ * 因为访问时间只会增加，这样取出的顺序依然是正确的。
+ * 参考 The LRU-K Page Replacement Algorithm For Database Disk Buffering (SIGMOD 1993)
+ */
+class LruKPageReplacer : public PageReplacer {
+public:
+  const char *name() const override { return "lru-k"; }
+
+  void on_insert(Frame *frame) override;
+  void on_access(Frame *frame) override;
+  void on_remove(Frame *frame) override;
+  void foreach_victim(const std::function<bool(Frame *)> &func) override;
+  void foreach_candidate(const std::function<bool(Frame *)> &func) override;
+
+private:
+  struct History {
+    std::atomic<unsigned long> last_stamp{0}; ///< 最后一次访问的逻辑时间
+    std::atomic<unsigned long> prev_stamp{0}; ///< 倒数第二次访问的逻辑时间，0表示只访问过一次
+    bool in_queue = true;                     ///< 是否还在只访问过一次的队列中
+    std::list<Frame *>::iterator queue_iter;
+    unsigned long heap_stamp = 0;             ///< 堆中属于这个页面的唯一有效元素的访问时间
+  };
+
+  /// 堆中的元素。页帧可能已经被移除，或者访问时间已经过期，取出时需要检查
+  using HeapItem = std::pair<unsigned long, Frame *>;
+
+  void push_heap_item(unsigned long stamp, Frame *frame);
+  void rebuild_heap();
+
+private:
+  std::atomic<unsigned long> clock_{0}; ///< 逻辑时钟，每次访问加1
+
+  std::unordered_map<Frame *, History> histories_;
+  std::list<Frame *> once_queue_; ///< 只访问过一次的页面，头部是最早加载的
+  std::vector<HeapItem> heap_;    ///< 访问过K次的页面，按照倒数第K次访问时间排序的小根堆
+};
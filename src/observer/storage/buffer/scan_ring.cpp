@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+#include "storage/buffer/scan_ring.h"
+
+using namespace common;
+
+static const char *RING_HITS_METRIC = "buffer_pool.ring.hits";
+static const char *RING_REUSES_METRIC = "buffer_pool.ring.reuses";
+
+static Counter &ring_hits_counter() {
+  static Counter &counter = register_counter(RING_HITS_METRIC);
+  return counter;
+}
+
+static Counter &ring_reuses_counter() {
+  static Counter &counter = register_counter(RING_REUSES_METRIC);
+  return counter;
+}
+
+long ScanRing::hits() { return ring_hits_counter().value(); }
+long ScanRing::reuses() { return ring_reuses_counter().value(); }
+
+ScanRing::ScanRing(int size) : slots_(std::max(size, 1)) {
+  (void)ring_hits_counter();
+  (void)ring_reuses_counter();
+}
+
+ScanRing::Slot &ScanRing::next_slot() {
+  cursor_ = (cursor_ + 1) % size();
+  return slots_[cursor_];
+}
+
+void ScanRing::record_hit() { ring_hits_counter().inc(); }
+void ScanRing::record_reuse() { ring_reuses_counter().inc(); }
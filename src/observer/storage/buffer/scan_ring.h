@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "storage/buffer/frame.h"
+
+/**
+ * @brief 大表顺序扫描使用的环形缓冲区
+ * @ingroup BufferPool
+ * @details 扫描一个比缓冲池大很多的表时，每个页面只访问一次，如果按照正常的方式分配页帧，
+ * 会把缓冲池中其它查询经常访问的页面都淘汰掉。
+ * 使用环形缓冲区时，扫描需要从磁盘读取页面时，优先重用环中下一个位置上的页帧，
+ * 这样一次扫描最多只占用 size 个页帧。
+ * 环中的页帧如果被其它线程pin住了，或者已经被修改，就不能重用，这时仍然从缓冲池正常分配，
+ * 并用新的页帧替换环中的这个位置。
+ *
+ * 环形缓冲区只在一次扫描内使用，不需要加锁。
+ *
+ * 统计信息注册在 common::get_metrics_registry() 中：
+ * - buffer_pool.ring.hits   使用环形缓冲区的扫描访问的页面已经在缓冲池中的次数
+ * - buffer_pool.ring.reuses 重用环中页帧的次数
+ */
+class ScanRing {
+public:
+  /**
+   * @brief 环中的一个位置
+   * @details 记录了放入环时页帧对应的页面。重用之前要确认页帧仍然对应这个页面，
+   * 因为页帧可能已经被正常淘汰并分配给了其它页面
+   */
+  struct Slot {
+    Frame  *frame = nullptr;
+    FrameId frame_id{-1, BP_INVALID_PAGE_NUM};
+  };
+
+public:
+  explicit ScanRing(int size);
+  ~ScanRing() = default;
+
+  int size() const { return static_cast<int>(slots_.size()); }
+
+  /**
+   * @brief 移动到环的下一个位置
+   * @details 如果这个位置上有页帧，调用者可以尝试重用它，之后要把新的页帧记录到这个位置上
+   */
+  Slot &next_slot();
+
+  void record_hit();
+  void record_reuse();
+
+public:
+  /// 大表扫描时，环形缓冲区默认的页帧个数
+  static constexpr int DEFAULT_SIZE = 32;
+  /// 表的页面个数超过缓冲池页帧个数的这个比例时，扫描使用环形缓冲区
+  static constexpr double DEFAULT_THRESHOLD = 0.25;
+
+  /// 访问的页面已经在缓冲池中的次数
+  static long hits();
+  /// 重用环中页帧的次数
+  static long reuses();
+
+private:
+  std::vector<Slot> slots_;
+  int cursor_ = -1;
+};
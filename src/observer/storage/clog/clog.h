@@ -46,6 +46,7 @@ class Db;
  * @details 除了事务操作相关的类型，比如MTR_BEGIN/MTR_COMMIT等，都是需要事务自己去处理的。
  * 也就是说，像INSERT、DELETE等是事务自己处理的，其实这种类型的日志不需要在这里定义，而是在各个
  * 事务模型中定义，由各个事务模型自行处理。
+ * INSERT_BATCH 是一条语句插入的多条记录，数据部分是每条记录的 RID 和记录内容依次排列。
  */
 #define DEFINE_CLOG_TYPE_ENUM                                                                                          \
   DEFINE_CLOG_TYPE(ERROR)                                                                                              \
@@ -53,7 +54,8 @@ class Db;
   DEFINE_CLOG_TYPE(MTR_COMMIT)                                                                                         \
   DEFINE_CLOG_TYPE(MTR_ROLLBACK)                                                                                       \
   DEFINE_CLOG_TYPE(INSERT)                                                                                             \
-  DEFINE_CLOG_TYPE(DELETE)
+  DEFINE_CLOG_TYPE(DELETE)                                                                                             \
+  DEFINE_CLOG_TYPE(INSERT_BATCH)
 
 enum class CLogType {
 #define DEFINE_CLOG_TYPE(name) name,
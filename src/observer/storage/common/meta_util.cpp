@@ -29,6 +29,14 @@ std::string table_text_file(const char *base_dir, const char *table_name) {
   return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + TABLE_TEXT_SUFFIX;
 }
 
+std::string table_fsm_file(const char *base_dir, const char *table_name) {
+  return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + TABLE_FSM_SUFFIX;
+}
+
+std::string table_zone_file(const char *base_dir, const char *table_name) {
+  return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + TABLE_ZONE_SUFFIX;
+}
+
 std::string table_index_file(const char *base_dir, const char *table_name, const char *index_name) {
   return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + "-" + index_name + TABLE_INDEX_SUFFIX;
 }
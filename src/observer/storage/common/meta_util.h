@@ -18,6 +18,8 @@ static constexpr const char *TABLE_META_SUFFIX = ".table";
 static constexpr const char *TABLE_META_FILE_PATTERN = ".*\\.table$";
 static constexpr const char *TABLE_DATA_SUFFIX = ".data";
 static constexpr const char *TABLE_TEXT_SUFFIX = ".text";
+static constexpr const char *TABLE_FSM_SUFFIX = ".fsm";
+static constexpr const char *TABLE_ZONE_SUFFIX = ".zone";
 static constexpr const char *TABLE_INDEX_SUFFIX = ".index";
 static constexpr const char *VIEW_META_SUFFIX = ".view";
 static constexpr const char *VIEW_META_FILE_PATTERN = ".*\\.view$";
@@ -26,4 +28,6 @@ std::string table_meta_file(const char *base_dir, const char *table_name);
 std::string view_meta_file(const char *base_dir, const char *view_name);
 std::string table_data_file(const char *base_dir, const char *table_name);
 std::string table_text_file(const char *base_dir, const char *table_name);
+std::string table_fsm_file(const char *base_dir, const char *table_name);
+std::string table_zone_file(const char *base_dir, const char *table_name);
 std::string table_index_file(const char *base_dir, const char *table_name, const char *index_name);
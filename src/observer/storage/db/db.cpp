@@ -83,7 +83,9 @@ RC Db::init(const char *name, const char *dbpath) {
   return rc;
 }
 
-RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes) {
+RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes,
+                    StorageFormat storage_format) {
+  std::lock_guard<std::mutex> table_guard(table_lock_);
   RC rc = RC::SUCCESS;
   // check table_name
   if (opened_tables_.count(table_name) != 0) {
@@ -95,7 +97,8 @@ RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoS
   std::string table_file_path = table_meta_file(path_.c_str(), table_name);
   Table *table = new Table();
   int32_t table_id = next_table_id_++;
-  rc = table->create(table_id, table_file_path.c_str(), table_name, path_.c_str(), attribute_count, attributes);
+  rc = table->create(
+      table_id, table_file_path.c_str(), table_name, path_.c_str(), attribute_count, attributes, storage_format);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to create table %s.", table_name);
     delete table;
@@ -108,6 +111,7 @@ RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoS
 }
 
 RC Db::drop_table(Trx *trx, const char *table_name) {
+  std::lock_guard<std::mutex> table_guard(table_lock_);
   // 找到所有索引 把他们删了
   RC rc = RC::SUCCESS;
   auto it = opened_tables_.find(table_name);
@@ -128,6 +132,8 @@ RC Db::drop_table(Trx *trx, const char *table_name) {
   auto table_file_name = table_data_file(path_.c_str(), table_name);
   auto table_meta_name = table_meta_file(path_.c_str(), table_name);
   auto table_text_name = table_text_file(path_.c_str(), table_name);
+  auto table_fsm_name = table_fsm_file(path_.c_str(), table_name);
+  auto table_zone_name = table_zone_file(path_.c_str(), table_name);
   if (unlink(table_file_name.c_str()) == -1) {
     LOG_ERROR("Failed to delete table (%s) data file %s.", table_name, table_file_name.c_str());
     return RC::IOERR_UNLINK;
@@ -140,6 +146,14 @@ RC Db::drop_table(Trx *trx, const char *table_name) {
     LOG_ERROR("Failed to delete table (%s) data text file %s.", table_name, table_text_name.c_str());
     return RC::IOERR_UNLINK;
   }
+  if (unlink(table_fsm_name.c_str()) == -1) {
+    LOG_ERROR("Failed to delete table (%s) free space map file %s.", table_name, table_fsm_name.c_str());
+    return RC::IOERR_UNLINK;
+  }
+  if (unlink(table_zone_name.c_str()) == -1) {
+    LOG_ERROR("Failed to delete table (%s) zone map file %s.", table_name, table_zone_name.c_str());
+    return RC::IOERR_UNLINK;
+  }
   return RC::SUCCESS;
 }
 
@@ -266,6 +280,7 @@ RC Db::recover() { return clog_manager_->recover(this); }
 CLogManager *Db::clog_manager() { return clog_manager_.get(); }
 
 RC Db::create_view(const char *view_name, const char *sql, SelectStmt *select, std::vector<std::string> &names) {
+  std::lock_guard<std::mutex> table_guard(table_lock_);
   if (opened_tables_.count(view_name)) {
     return RC::SCHEMA_VIEW_EXIST;
   }
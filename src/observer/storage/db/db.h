@@ -13,11 +13,13 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "common/rc.h"
+#include "common/types.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/trx/trx.h"
 #include "storage/view/view.h"
@@ -45,7 +47,8 @@ public:
    */
   RC init(const char *name, const char *dbpath);
 
-  RC create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes);
+  RC create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes,
+                  StorageFormat storage_format = StorageFormat::FIXED_FORMAT);
   RC drop_table(Trx *trx, const char *table_name);
 
   Table *find_table(const char *table_name) const;
@@ -64,6 +67,12 @@ public:
 
   CLogManager *clog_manager();
 
+  /**
+   * @brief 创建、删除表和视图时持有这把锁
+   * @details 后台的 Vacuum 访问表时也持有这把锁，保证表不会在这期间被删除
+   */
+  std::mutex &table_lock() { return table_lock_; }
+
 private:
   RC open_all_tables();
   RC open_all_views();
@@ -73,6 +82,7 @@ private:
   std::string path_;
   std::unordered_map<std::string, Table *> opened_tables_;
   std::unique_ptr<CLogManager> clog_manager_;
+  std::mutex table_lock_;
 
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
@@ -153,6 +153,12 @@ Db *DefaultHandler::find_db(const char *dbname) const {
   return iter->second;
 }
 
+void DefaultHandler::all_dbs(std::vector<Db *> &dbs) const {
+  for (const auto &iter : opened_dbs_) {
+    dbs.push_back(iter.second);
+  }
+}
+
 Table *DefaultHandler::find_table(const char *dbname, const char *table_name) const {
   if (dbname == nullptr || table_name == nullptr) {
     LOG_WARN("Invalid argument. dbname=%p, table_name=%p", dbname, table_name);
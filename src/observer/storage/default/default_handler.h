@@ -90,6 +90,7 @@ public:
 
 public:
   Db *find_db(const char *dbname) const;
+  void all_dbs(std::vector<Db *> &dbs) const;
   Table *find_table(const char *dbname, const char *table_name) const;
 
   RC sync();
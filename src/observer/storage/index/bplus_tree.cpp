@@ -9,13 +9,20 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "storage/index/bplus_tree.h"
 #include "common/lang/lower_bound.h"
 #include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
 #include "sql/parser/parse_defs.h"
 #include "sql/parser/value.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/field/field.h"
+#include "storage/record/text_file.h"
 
 using namespace std;
 using namespace common;
@@ -24,6 +31,14 @@ using namespace common;
 
 bool global_unique = true;
 
+/// 乐观读重试这么多次之后，改用加锁的方式查找
+static constexpr int MAX_OPTIMISTIC_READ_RETRIES = 16;
+
+static Counter &optimistic_read_restarts_counter() {
+  static Counter &counter = register_counter("bplus_tree.optimistic_read.restarts");
+  return counter;
+}
+
 int calc_internal_page_capacity(int attr_length) {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
 
@@ -37,6 +52,22 @@ int calc_leaf_page_capacity(int attr_length) {
   return capacity;
 }
 
+/**
+ * 前缀压缩的叶子节点在没有公共前缀时能放下的键值个数
+ */
+static int calc_prefix_leaf_min_capacity(int key_length) {
+  return ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - LeafIndexNode::PREFIX_HEADER_SIZE) / key_length;
+}
+
+/**
+ * 前缀压缩的叶子节点最多存放的键值个数
+ * @details 插入的键值可能让公共前缀变短。节点满了之后分裂成两半，再插入一个键值，即使没有公共前缀也要能放下，
+ * 所以最多是没有公共前缀时能放下的两倍。节点中实际能放下多少还要看公共前缀的长度
+ */
+int calc_prefix_leaf_page_capacity(int attr_length) {
+  return 2 * (calc_prefix_leaf_min_capacity(attr_length + sizeof(RID)) - 1);
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 IndexNodeHandler::IndexNodeHandler(const IndexFileHeader &header, Frame *frame)
     : header_(header), page_num_(frame->page_num()), node_((IndexNode *)frame->data()) {}
@@ -84,6 +115,10 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node) {
     return true;
   } break;
   case BplusTreeOperationType::INSERT: {
+    // 前缀压缩的叶子节点插入一个键值之后，即使没有公共前缀也能放得下，才一定不会分裂
+    if (is_leaf() && header_.leaf_prefix_compression) {
+      return size() < std::min(max_size(), calc_prefix_leaf_min_capacity(key_size()));
+    }
     return size() < max_size();
   } break;
   case BplusTreeOperationType::DELETE: {
@@ -134,20 +169,39 @@ bool IndexNodeHandler::validate() const {
 
 /////////////////////////////////////////////////////////////////////////////////
 LeafIndexNodeHandler::LeafIndexNodeHandler(const IndexFileHeader &header, Frame *frame)
-    : IndexNodeHandler(header, frame), leaf_node_((LeafIndexNode *)frame->data()) {}
+    : IndexNodeHandler(header, frame), leaf_node_((LeafIndexNode *)frame->data()),
+      prefix_compression_(header.leaf_prefix_compression != 0) {}
 
 void LeafIndexNodeHandler::init_empty() {
   IndexNodeHandler::init_empty(true);
   leaf_node_->next_brother = BP_INVALID_PAGE_NUM;
+  if (prefix_compression_) {
+    *(int32_t *)leaf_node_->array = 0;
+  }
 }
 
 void LeafIndexNodeHandler::set_next_page(PageNum page_num) { leaf_node_->next_brother = page_num; }
 
 PageNum LeafIndexNodeHandler::next_page() const { return leaf_node_->next_brother; }
 
-char *LeafIndexNodeHandler::key_at(int index) {
+const char *LeafIndexNodeHandler::key_at(int index) {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  if (!prefix_compression_) {
+    return __key_at(index);
+  }
+  key_buf_.resize(key_size());
+  return key_at(index, key_buf_.data());
+}
+
+const char *LeafIndexNodeHandler::key_at(int index, char *buf) const {
+  assert(index >= 0 && index < size());
+  if (!prefix_compression_) {
+    return __key_at(index);
+  }
+  const int prefix_len = prefix_length();
+  memcpy(buf, __prefix(), prefix_len);
+  memcpy(buf + prefix_len, __item_at(index), key_size() - prefix_len);
+  return buf;
 }
 
 char *LeafIndexNodeHandler::value_at(int index) {
@@ -155,39 +209,150 @@ char *LeafIndexNodeHandler::value_at(int index) {
   return __value_at(index);
 }
 
+template <typename Comparator>
+int LeafIndexNodeHandler::lower_bound(const Comparator &comparator, const char *key, bool *found) const {
+  const int size = this->size();
+  common::BinaryIterator<char> iter_begin(slot_size(), __item_at(0));
+  common::BinaryIterator<char> iter_end(slot_size(), __item_at(size));
+  if (!prefix_compression_) {
+    return common::lower_bound(iter_begin, iter_end, key, comparator, found) - iter_begin;
+  }
+
+  // 公共前缀只存放了一份，先放到缓存中，每次比较时只需要复制后面的部分
+  const int prefix_len = prefix_length();
+  const int suffix_len = key_size() - prefix_len;
+  key_buf_.resize(key_size());
+  char *full_key = key_buf_.data();
+  memcpy(full_key, __prefix(), prefix_len);
+  auto suffix_comparator = [&comparator, full_key, prefix_len, suffix_len](const char *suffix, const char *key) {
+    memcpy(full_key + prefix_len, suffix, suffix_len);
+    return comparator(full_key, key);
+  };
+  return common::lower_bound(iter_begin, iter_end, key, suffix_comparator, found) - iter_begin;
+}
+
 int LeafIndexNodeHandler::lookup_unique(const KeyComparator &comparator, const char *key,
                                         bool *found /* = nullptr */) const {
-  const int size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator.attr_comparator(), found);
+  const int index = lower_bound(comparator.attr_comparator(), key, found);
   if (found && *found) {
-    if (comparator.attr_comparator()(key, *iter, true) != 0)
+    key_buf_.resize(key_size());
+    if (comparator.attr_comparator()(key, key_at(index, key_buf_.data()), true) != 0)
       *found = false;
   }
-  return iter - iter_begin;
+  return index;
 }
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const {
-  const int size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  return iter - iter_begin;
+  const IndexKeySearcher &searcher = comparator.key_searcher();
+  if (searcher.enabled()) {
+    const int prefix_len = prefix_length();
+    return searcher.lower_bound(__item_at(0), slot_size(), size(), prefix_len > 0 ? __prefix() : nullptr, prefix_len,
+                                key, found);
+  }
+  return lower_bound(comparator, key, found);
+}
+
+/**
+ * 两个键值相同前缀的长度，最多比较 max_len 个字节
+ */
+static int common_prefix_length(const char *key1, const char *key2, int max_len) {
+  int len = 0;
+  while (len < max_len && key1[len] == key2[len]) {
+    len++;
+  }
+  return len;
+}
+
+bool LeafIndexNodeHandler::fits(int num, int prefix_len) const {
+  if (num > max_size()) {
+    return false;
+  }
+  if (!prefix_compression_) {
+    return true;
+  }
+  const long space = BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - LeafIndexNode::PREFIX_HEADER_SIZE;
+  return prefix_len + static_cast<long>(num) * (key_size() - prefix_len) <= space;
+}
+
+bool LeafIndexNodeHandler::can_insert(const char *key) const {
+  const int prefix_len = prefix_length();
+  return fits(size() + 1, common_prefix_length(__prefix(), key, prefix_len));
+}
+
+bool LeafIndexNodeHandler::can_merge(const LeafIndexNodeHandler &other) const {
+  const int num = size() + other.size();
+  if (!prefix_compression_ || other.size() == 0) {
+    return fits(num, prefix_length());
+  }
+  if (size() == 0) {
+    return fits(num, other.prefix_length());
+  }
+  // 合并之后的公共前缀不会短于两个节点前缀相同的部分
+  const int max_len = std::min(prefix_length(), other.prefix_length());
+  return fits(num, common_prefix_length(__prefix(), other.__prefix(), max_len));
+}
+
+int LeafIndexNodeHandler::prefix_length() const { return prefix_compression_ ? *(int32_t *)leaf_node_->array : 0; }
+
+void LeafIndexNodeHandler::assign(const char *keys, int num) {
+  if (!prefix_compression_) {
+    for (int i = 0; i < num; i++) {
+      const char *key = keys + static_cast<size_t>(i) * key_size();
+      memcpy(__key_at(i), key, key_size());
+      memcpy(__value_at(i), key + header_.attr_length, value_size());
+    }
+    node_->key_num = num;
+    return;
+  }
+
+  // 键值是按照字段类型排序的，不一定按照字节有序，要与每一个键值比较才能得到公共前缀
+  int prefix_len = num > 0 ? header_.attr_length : 0;
+  for (int i = 1; i < num && prefix_len > 0; i++) {
+    prefix_len = common_prefix_length(keys, keys + static_cast<size_t>(i) * key_size(), prefix_len);
+  }
+
+  *(int32_t *)leaf_node_->array = prefix_len;
+  memcpy(__prefix(), keys, prefix_len);
+  const int suffix_len = key_size() - prefix_len;
+  for (int i = 0; i < num; i++) {
+    memcpy(__item_at(i), keys + static_cast<size_t>(i) * key_size() + prefix_len, suffix_len);
+  }
+  node_->key_num = num;
+}
+
+void LeafIndexNodeHandler::copy_keys(int begin, int end, char *keys) const {
+  for (int i = begin; i < end; i++) {
+    key_at(i, keys + static_cast<size_t>(i - begin) * key_size());
+  }
 }
 
 void LeafIndexNodeHandler::insert(int index, const char *key, const char *value) {
+  const int prefix_len = prefix_length();
+  if (prefix_compression_ && common_prefix_length(__prefix(), key, prefix_len) < prefix_len) {
+    // 新的键值让公共前缀变短了，所有的键值都要重新存放
+    std::vector<char> keys(static_cast<size_t>(size() + 1) * key_size());
+    copy_keys(0, index, keys.data());
+    memcpy(keys.data() + static_cast<size_t>(index) * key_size(), key, key_size());
+    copy_keys(index, size(), keys.data() + static_cast<size_t>(index + 1) * key_size());
+    assign(keys.data(), size() + 1);
+    return;
+  }
+
   if (index < size()) {
-    memmove(__item_at(index + 1), __item_at(index), (static_cast<size_t>(size()) - index) * item_size());
+    memmove(__item_at(index + 1), __item_at(index), (static_cast<size_t>(size()) - index) * slot_size());
+  }
+  if (prefix_compression_) {
+    memcpy(__item_at(index), key + prefix_len, key_size() - prefix_len);
+  } else {
+    memcpy(__item_at(index), key, key_size());
+    memcpy(__item_at(index) + key_size(), value, value_size());
   }
-  memcpy(__item_at(index), key, key_size());
-  memcpy(__item_at(index) + key_size(), value, value_size());
   increase_size(1);
 }
 void LeafIndexNodeHandler::remove(int index) {
   assert(index >= 0 && index < size());
   if (index < size() - 1) {
-    memmove(__item_at(index), __item_at(index + 1), (static_cast<size_t>(size()) - index - 1) * item_size());
+    memmove(__item_at(index), __item_at(index + 1), (static_cast<size_t>(size()) - index - 1) * slot_size());
   }
   increase_size(-1);
 }
@@ -206,24 +371,28 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other, DiskBufferPoo
   const int size = this->size();
   const int move_index = size / 2;
 
-  memcpy(other.__item_at(0), this->__item_at(move_index), static_cast<size_t>(item_size()) * (size - move_index));
-  other.increase_size(size - move_index);
-  this->increase_size(-(size - move_index));
+  if (!prefix_compression_) {
+    memcpy(other.__item_at(0), this->__item_at(move_index), static_cast<size_t>(item_size()) * (size - move_index));
+    other.increase_size(size - move_index);
+    this->increase_size(-(size - move_index));
+    return RC::SUCCESS;
+  }
+
+  // 分裂之后两个节点中的键值更少，公共前缀可能更长，都重新计算
+  std::vector<char> keys(static_cast<size_t>(size) * key_size());
+  copy_keys(0, size, keys.data());
+  other.assign(keys.data() + static_cast<size_t>(move_index) * key_size(), size - move_index);
+  this->assign(keys.data(), move_index);
   return RC::SUCCESS;
 }
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool) {
-  other.append(__item_at(0));
-
-  if (size() >= 1) {
-    memmove(__item_at(0), __item_at(1), (static_cast<size_t>(size()) - 1) * item_size());
-  }
-  increase_size(-1);
+  other.insert(other.size(), key_at(0), value_at(0));
+  remove(0);
   return RC::SUCCESS;
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other, DiskBufferPool *bp) {
-  other.preappend(__item_at(size() - 1));
-
+  other.insert(0, key_at(size() - 1), value_at(size() - 1));
   increase_size(-1);
   return RC::SUCCESS;
 }
@@ -231,37 +400,45 @@ RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other, DiskBuf
  * move all items to left page
  */
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other, DiskBufferPool *bp) {
-  memcpy(other.__item_at(other.size()), this->__item_at(0), static_cast<size_t>(this->size()) * item_size());
-  other.increase_size(this->size());
+  if (!prefix_compression_) {
+    memcpy(other.__item_at(other.size()), this->__item_at(0), static_cast<size_t>(this->size()) * item_size());
+    other.increase_size(this->size());
+  } else {
+    std::vector<char> keys(static_cast<size_t>(other.size() + this->size()) * key_size());
+    other.copy_keys(0, other.size(), keys.data());
+    this->copy_keys(0, this->size(), keys.data() + static_cast<size_t>(other.size()) * key_size());
+    other.assign(keys.data(), other.size() + this->size());
+  }
   this->increase_size(-this->size());
 
   other.set_next_page(this->next_page());
   return RC::SUCCESS;
 }
 
-void LeafIndexNodeHandler::append(const char *item) {
-  memcpy(__item_at(size()), item, item_size());
-  increase_size(1);
+int LeafIndexNodeHandler::slot_size() const { return prefix_compression_ ? key_size() - prefix_length() : item_size(); }
+char *LeafIndexNodeHandler::__prefix() const { return leaf_node_->array + LeafIndexNode::PREFIX_HEADER_SIZE; }
+char *LeafIndexNodeHandler::__items() const {
+  return prefix_compression_ ? __prefix() + prefix_length() : leaf_node_->array;
 }
 
-void LeafIndexNodeHandler::preappend(const char *item) {
-  if (size() > 0) {
-    memmove(__item_at(1), __item_at(0), static_cast<size_t>(size()) * item_size());
+char *LeafIndexNodeHandler::__item_at(int index) const { return __items() + (index * slot_size()); }
+char *LeafIndexNodeHandler::__key_at(int index) const { return __item_at(index); }
+char *LeafIndexNodeHandler::__value_at(int index) const {
+  // 前缀压缩时值就是键值最后的 RID
+  if (prefix_compression_) {
+    return __item_at(index) + header_.attr_length - prefix_length();
   }
-  memcpy(__item_at(0), item, item_size());
-  increase_size(1);
+  return __item_at(index) + key_size();
 }
 
-char *LeafIndexNodeHandler::__item_at(int index) const { return leaf_node_->array + (index * item_size()); }
-char *LeafIndexNodeHandler::__key_at(int index) const { return __item_at(index); }
-char *LeafIndexNodeHandler::__value_at(int index) const { return __item_at(index) + key_size(); }
-
 std::string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer) {
   std::stringstream ss;
-  ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page();
-  ss << ",values=[" << printer(handler.__key_at(0));
-  for (int i = 1; i < handler.size(); i++) {
-    ss << "," << printer(handler.__key_at(i));
+  std::vector<char> key(handler.key_size());
+  ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page()
+     << ",prefix length:" << handler.prefix_length();
+  ss << ",values=[";
+  for (int i = 0; i < handler.size(); i++) {
+    ss << (i == 0 ? "" : ",") << printer(handler.key_at(i, key.data()));
   }
   ss << "]";
   return ss.str();
@@ -273,9 +450,16 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
     return false;
   }
 
+  if (prefix_length() < 0 || prefix_length() > header_.attr_length) {
+    LOG_WARN("page number = %d, invalid prefix length %d", page_num(), prefix_length());
+    return false;
+  }
+
   const int node_size = size();
+  std::vector<char> prev_key(key_size());
+  std::vector<char> key(key_size());
   for (int i = 1; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    if (comparator(key_at(i - 1, prev_key.data()), key_at(i, key.data())) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s", page_num(), i - 1, i,
                to_string(*this).c_str());
       return false;
@@ -304,7 +488,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(0), parent_node.key_at(index_in_parent));
+    int cmp_result = comparator(key_at(0, key.data()), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. "
                "this page num=%d, parent page num=%d, index in parent=%d",
@@ -315,7 +499,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    int cmp_result = comparator(key_at(size() - 1, key.data()), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid leaf node. last item should be less than the item at the first after item in parent."
                "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -403,6 +587,19 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
+  const IndexKeySearcher &searcher = comparator.key_searcher();
+  if (searcher.enabled()) {
+    bool equal = false;
+    const int ret = searcher.lower_bound(__key_at(1), item_size(), size - 1, nullptr, 0, key, &equal) + 1;
+    if (insert_position) {
+      *insert_position = ret;
+    }
+    if (found) {
+      *found = equal;
+    }
+    return equal ? ret : ret - 1;
+  }
+
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
   common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
@@ -512,6 +709,13 @@ RC InternalIndexNodeHandler::copy_from(const char *items, int num, DiskBufferPoo
 
 RC InternalIndexNodeHandler::append(const char *item, DiskBufferPool *bp) { return this->copy_from(item, 1, bp); }
 
+RC InternalIndexNodeHandler::append_child(const char *key, PageNum page_num, DiskBufferPool *bp) {
+  vector<char> item(item_size());
+  memcpy(item.data(), key, key_size());
+  memcpy(item.data() + key_size(), &page_num, value_size());
+  return append(item.data(), bp);
+}
+
 RC InternalIndexNodeHandler::preappend(const char *item, DiskBufferPool *bp) {
   PageNum child_page_num = *(PageNum *)(item + key_size());
   Frame *frame = nullptr;
@@ -655,7 +859,8 @@ RC BplusTreeHandler::sync() {
 }
 
 RC BplusTreeHandler::create(const char *file_name, const Table *table, const IndexMeta &meta,
-                            int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */) {
+                            int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */,
+                            bool leaf_prefix_compression /* = true */) {
   BufferPoolManager &bpm = BufferPoolManager::instance();
   RC rc = bpm.create_file(file_name);
   if (rc != RC::SUCCESS) {
@@ -695,7 +900,10 @@ RC BplusTreeHandler::create(const char *file_name, const Table *table, const Ind
   if (internal_max_size < 0) {
     internal_max_size = calc_internal_page_capacity(attr_length);
   }
-  if (leaf_max_size < 0) {
+  if (leaf_prefix_compression) {
+    const int capacity = calc_prefix_leaf_page_capacity(attr_length);
+    leaf_max_size = leaf_max_size < 0 ? capacity : std::min(leaf_max_size, capacity);
+  } else if (leaf_max_size < 0) {
     leaf_max_size = calc_leaf_page_capacity(attr_length);
   }
 
@@ -705,6 +913,7 @@ RC BplusTreeHandler::create(const char *file_name, const Table *table, const Ind
   file_header->key_length = attr_length + sizeof(RID);
   file_header->internal_max_size = internal_max_size;
   file_header->leaf_max_size = leaf_max_size;
+  file_header->leaf_prefix_compression = leaf_prefix_compression ? 1 : 0;
   file_header->root_page = BP_INVALID_PAGE_NUM;
 
   header_frame->mark_dirty();
@@ -975,7 +1184,57 @@ bool BplusTreeHandler::validate_tree() {
   return true;
 }
 
-bool BplusTreeHandler::is_empty() const { return file_header_.root_page == BP_INVALID_PAGE_NUM; }
+RC BplusTreeHandler::stat_node_recursive(PageNum page_num, int depth, BplusTreeStat &stat) {
+  Frame *frame = nullptr;
+  RC rc = disk_buffer_pool_->get_this_page(page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch page. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  stat.height = max(stat.height, depth);
+  IndexNodeHandler node(file_header_, frame);
+  if (node.is_leaf()) {
+    stat.leaf_pages++;
+    stat.entries += node.size();
+    disk_buffer_pool_->unpin_page(frame);
+    return RC::SUCCESS;
+  }
+
+  InternalIndexNodeHandler internal_node(file_header_, frame);
+  vector<PageNum> children(internal_node.size());
+  for (int i = 0; i < internal_node.size(); i++) {
+    children[i] = internal_node.value_at(i);
+  }
+  disk_buffer_pool_->unpin_page(frame);
+
+  stat.internal_pages++;
+  stat.internal_items += children.size();
+  for (PageNum child : children) {
+    rc = stat_node_recursive(child, depth + 1, stat);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::stat(BplusTreeStat &stat) {
+  stat = BplusTreeStat();
+  if (is_empty()) {
+    return RC::SUCCESS;
+  }
+  return stat_node_recursive(file_header_.root_page, 1, stat);
+}
+
+bool BplusTreeHandler::is_empty() const { return root_page_num() == BP_INVALID_PAGE_NUM; }
+
+long BplusTreeHandler::optimistic_read_restarts() { return optimistic_read_restarts_counter().value(); }
+
+PageNum BplusTreeHandler::root_page_num() const {
+  // 乐观读不持有root_lock_，与修改根节点的线程并发访问
+  return std::atomic_ref<PageNum>(const_cast<PageNum &>(file_header_.root_page)).load(std::memory_order_acquire);
+}
 
 RC BplusTreeHandler::find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame) {
   auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
@@ -992,6 +1251,18 @@ RC BplusTreeHandler::left_most_page(LatchMemo &latch_memo, Frame *&frame) {
 RC BplusTreeHandler::find_leaf_internal(LatchMemo &latch_memo, BplusTreeOperationType op,
                                         const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter,
                                         Frame *&frame) {
+  if (op == BplusTreeOperationType::READ && optimistic_read_) {
+    for (int i = 0; i < MAX_OPTIMISTIC_READ_RETRIES; i++) {
+      RC rc = optimistic_find_leaf(latch_memo, child_page_getter, frame);
+      if (rc != RC::LOCKED_NEED_WAIT) {
+        return rc;
+      }
+      optimistic_read_restarts_counter().inc();
+      std::this_thread::yield();
+    }
+    LOG_TRACE("too many optimistic read restarts, fall back to latch crabing");
+  }
+
   // root locked
   if (op != BplusTreeOperationType::READ) {
     latch_memo.xlatch(&root_lock_);
@@ -1025,6 +1296,83 @@ RC BplusTreeHandler::find_leaf_internal(LatchMemo &latch_memo, BplusTreeOperatio
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::optimistic_find_leaf(LatchMemo &latch_memo,
+                                          const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter,
+                                          Frame *&frame) {
+  const PageNum root_page = root_page_num();
+  if (root_page == BP_INVALID_PAGE_NUM) {
+    return RC::EMPTY;
+  }
+
+  Frame *current = nullptr;
+  RC rc = disk_buffer_pool_->get_this_page(root_page, &current);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to fetch root page. page id=%d, rc=%d:%s", root_page, rc, strrc(rc));
+    return rc;
+  }
+
+  // 版本号是奇数说明有人正在修改这个节点。拿到版本号之后根节点可能已经换掉了
+  uint64_t version = current->version();
+  if ((version & 1) != 0 || root_page_num() != root_page) {
+    disk_buffer_pool_->unpin_page(current);
+    return RC::LOCKED_NEED_WAIT;
+  }
+
+  // 下面读取的节点内容可能正在被修改，使用之前都要先校验版本号
+  while (!reinterpret_cast<IndexNode *>(current->data())->is_leaf) {
+    InternalIndexNodeHandler internal_node(file_header_, current);
+    const int size = internal_node.size();
+    PageNum child_page = BP_INVALID_PAGE_NUM;
+    if (size > 0 && size <= internal_node.max_size()) {
+      child_page = child_page_getter(internal_node);
+    }
+    if (!current->validate(version)) {
+      disk_buffer_pool_->unpin_page(current);
+      return RC::LOCKED_NEED_WAIT;
+    }
+    if (child_page <= BP_HEADER_PAGE || child_page >= disk_buffer_pool_->page_num()) {
+      LOG_WARN("invalid child page. page id=%d, child page=%d", current->page_num(), child_page);
+      disk_buffer_pool_->unpin_page(current);
+      return RC::INTERNAL;
+    }
+
+    Frame *child = nullptr;
+    rc = disk_buffer_pool_->get_this_page(child_page, &child);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch page. page id=%d, rc=%d:%s", child_page, rc, strrc(rc));
+      disk_buffer_pool_->unpin_page(current);
+      return rc;
+    }
+
+    // 先拿到子节点的版本号，再校验父节点，这样子节点的版本号不变就说明它仍然是要找的节点
+    const uint64_t child_version = child->version();
+    const bool parent_valid = current->validate(version);
+    disk_buffer_pool_->unpin_page(current);
+    current = child;
+    version = child_version;
+    if ((version & 1) != 0 || !parent_valid) {
+      disk_buffer_pool_->unpin_page(current);
+      return RC::LOCKED_NEED_WAIT;
+    }
+  }
+
+  // 叶子节点加上读锁之后，版本号仍然没有变化，才能确定找到的叶子节点是对的
+  const int memo_point = latch_memo.memo_point();
+  rc = latch_memo.get_page(current->page_num(), frame);
+  disk_buffer_pool_->unpin_page(current);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get frame. page id=%d, rc=%s", current->page_num(), strrc(rc));
+    return rc;
+  }
+
+  latch_memo.slatch(frame);
+  if (!frame->validate(version)) {
+    latch_memo.release_from(memo_point);
+    return RC::LOCKED_NEED_WAIT;
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::crabing_protocal_fetch_page(LatchMemo &latch_memo, BplusTreeOperationType op, PageNum page_num,
                                                  bool is_root_node, Frame *&frame) {
   bool readonly = (op == BplusTreeOperationType::READ);
@@ -1058,7 +1406,7 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *f
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
+  if (leaf_node.can_insert(key)) {
     leaf_node.insert(insert_position, key, (const char *)rid);
     frame->mark_dirty();
     // disk_buffer_pool_->unpin_page(frame); // unpin pages 由latch memo 来操作
@@ -1209,7 +1557,7 @@ RC BplusTreeHandler::split(LatchMemo &latch_memo, Frame *frame, Frame *&new_fram
 }
 
 void BplusTreeHandler::update_root_page_num_locked(PageNum root_page_num) {
-  file_header_.root_page = root_page_num;
+  std::atomic_ref<PageNum>(file_header_.root_page).store(root_page_num, std::memory_order_release);
   header_dirty_ = true;
   LOG_DEBUG("set root page to %d", root_page_num);
 }
@@ -1294,6 +1642,333 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid) {
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::insert_entries(const char *user_keys, const RID *rids, int count) {
+  if (count <= 0) {
+    return RC::SUCCESS;
+  }
+  if (user_keys == nullptr || rids == nullptr) {
+    LOG_WARN("Invalid arguments, keys are empty or rids are empty");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int attr_length = file_header_.attr_length;
+  const int key_length = file_header_.key_length;
+  std::vector<char> keys(static_cast<size_t>(count) * key_length);
+  std::vector<int> order(count);
+  for (int i = 0; i < count; i++) {
+    memcpy(keys.data() + i * key_length, user_keys + i * attr_length, attr_length);
+    memcpy(keys.data() + i * key_length + attr_length, &rids[i], sizeof(RID));
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this, &keys, key_length](int a, int b) {
+    return key_comparator_(keys.data() + a * key_length, keys.data() + b * key_length) < 0;
+  });
+
+  RC rc = RC::SUCCESS;
+  int inserted = 0;
+  {
+    LatchMemo latch_memo(disk_buffer_pool_);
+    Frame *leaf_frame = nullptr;
+    for (; inserted < count; inserted++) {
+      const int index = order[inserted];
+      const char *key = keys.data() + index * key_length;
+
+      if (leaf_frame != nullptr) {
+        // 上一个键值插入到了这个叶子节点，当前键值不大于叶子节点的最后一个键值，或者这是最右边的叶子节点，
+        // 那么当前键值也属于这个叶子节点
+        LeafIndexNodeHandler leaf_node(file_header_, leaf_frame);
+        const bool in_leaf = leaf_node.next_page() == BP_INVALID_PAGE_NUM ||
+                             key_comparator_(key, leaf_node.key_at(leaf_node.size() - 1)) < 0;
+        if (in_leaf && leaf_node.can_insert(key)) {
+          rc = insert_entry_into_leaf_node(latch_memo, leaf_frame, key, &rids[index]);
+          if (OB_FAIL(rc)) {
+            break;
+          }
+          continue;
+        }
+
+        latch_memo.release();
+        leaf_frame = nullptr;
+      }
+
+      if (is_empty()) {
+        root_lock_.lock();
+        if (is_empty()) {
+          rc = create_new_tree(key, &rids[index]);
+          root_lock_.unlock();
+          if (OB_FAIL(rc)) {
+            break;
+          }
+          continue;
+        }
+        root_lock_.unlock();
+      }
+
+      Frame *frame = nullptr;
+      rc = find_leaf(latch_memo, BplusTreeOperationType::INSERT, key, frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("Failed to find leaf %s. rc=%d:%s", rids[index].to_string().c_str(), rc, strrc(rc));
+        break;
+      }
+
+      const bool split = !LeafIndexNodeHandler(file_header_, frame).can_insert(key);
+      rc = insert_entry_into_leaf_node(latch_memo, frame, key, &rids[index]);
+      if (OB_FAIL(rc)) {
+        break;
+      }
+
+      if (split) {
+        // 分裂之后键值可能在新的节点中，下一个键值重新从根节点查找
+        latch_memo.release();
+      } else {
+        leaf_frame = frame;
+      }
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("Failed to insert entries, rollback inserted ones. inserted=%d, count=%d, rc=%s", inserted, count,
+              strrc(rc));
+    for (int i = 0; i < inserted; i++) {
+      const int index = order[i];
+      RC rc2 = delete_entry(user_keys + index * attr_length, &rids[index]);
+      if (OB_FAIL(rc2)) {
+        LOG_ERROR("Failed to rollback inserted entry. rid=%s, rc=%s", rids[index].to_string().c_str(), strrc(rc2));
+      }
+    }
+    return rc;
+  }
+
+  LOG_TRACE("insert entries success. count=%d", count);
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 批量构建时每个节点放多少项
+ * @details 按照填充比例依次填满节点。最后一个节点不足最小容量时，与前一个节点合并，合并之后放不下就平分，
+ * 这样除了根节点之外，每个节点都不小于最小容量，之后的删除操作不需要特殊处理
+ */
+static vector<int> plan_node_sizes(int total, int max_size, int fill_factor) {
+  vector<int> sizes;
+  if (total <= max_size) {
+    sizes.push_back(total);
+    return sizes;
+  }
+
+  const int min_size = max_size - max_size / 2;
+  const int fill_size = clamp(static_cast<int>(static_cast<long>(max_size) * fill_factor / 100), min_size, max_size);
+  for (int remain = total; remain > 0; remain -= sizes.back()) {
+    sizes.push_back(min(fill_size, remain));
+  }
+
+  if (sizes.back() < min_size) {
+    const int last_two = sizes[sizes.size() - 2] + sizes.back();
+    sizes.pop_back();
+    if (last_two <= max_size) {
+      sizes.back() = last_two;
+    } else {
+      sizes.back() = last_two - last_two / 2;
+      sizes.push_back(last_two / 2);
+    }
+  }
+  return sizes;
+}
+
+RC BplusTreeHandler::bulk_load_begin(int fill_factor, long sort_memory) {
+  if (!is_empty() || bulk_sorter_ != nullptr) {
+    LOG_WARN("bulk load can only be used on an empty tree");
+    return RC::INTERNAL;
+  }
+  if (fill_factor <= 0 || fill_factor > 100) {
+    LOG_WARN("invalid fill factor %d", fill_factor);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  bulk_fill_factor_ = fill_factor;
+  bulk_key_.resize(file_header_.key_length);
+  bulk_sorter_ = make_unique<IndexKeySorter>(
+      [this](const char *v1, const char *v2) { return key_comparator_(v1, v2); }, file_header_.key_length,
+      disk_buffer_pool_->file_name(), sort_memory);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::bulk_load_add(const char *user_key, const RID *rid) {
+  if (bulk_sorter_ == nullptr) {
+    LOG_WARN("bulk load is not started");
+    return RC::INTERNAL;
+  }
+  if (user_key == nullptr || rid == nullptr) {
+    LOG_WARN("Invalid arguments, key is empty or rid is empty");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  char *key = bulk_key_.data();
+  memcpy(key, user_key, file_header_.attr_length);
+  memcpy(key + file_header_.attr_length, rid, sizeof(*rid));
+  return bulk_sorter_->add(key);
+}
+
+RC BplusTreeHandler::bulk_load_finish() {
+  if (bulk_sorter_ == nullptr) {
+    LOG_WARN("bulk load is not started");
+    return RC::INTERNAL;
+  }
+
+  RC rc = bulk_sorter_->finish();
+  vector<char> level_keys;
+  vector<PageNum> level_pages;
+  if (OB_SUCC(rc) && bulk_sorter_->key_count() > 0) {
+    rc = bulk_load_leaves(level_keys, level_pages);
+  }
+
+  int height = level_pages.empty() ? 0 : 1;
+  while (OB_SUCC(rc) && level_pages.size() > 1) {
+    rc = bulk_load_internal_level(level_keys, level_pages);
+    height++;
+  }
+
+  const long key_count = bulk_sorter_->key_count();
+  const int run_count = bulk_sorter_->run_count();
+  bulk_sorter_.reset();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to bulk load bplus tree. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (!level_pages.empty()) {
+    update_root_page_num_locked(level_pages[0]);
+  }
+  LOG_INFO("bulk loaded bplus tree. keys=%ld, sort runs=%d, height=%d, fill factor=%d", key_count, run_count, height,
+           bulk_fill_factor_);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::bulk_load_leaves(vector<char> &level_keys, vector<PageNum> &level_pages) {
+  const int attr_length = file_header_.attr_length;
+  const int key_length = file_header_.key_length;
+  const bool check_unique = global_unique && unique_;
+  const long key_count = bulk_sorter_->key_count();
+  vector<int> sizes = plan_node_sizes(static_cast<int>(key_count), file_header_.leaf_max_size, bulk_fill_factor_);
+
+  RC rc = RC::SUCCESS;
+  Frame *frame = nullptr;
+  vector<char> last_key(key_length);
+  vector<char> node_keys; // 当前节点中的键值，最后可能多一个放不下的键值，留给下一个节点
+  long fetched = 0;       // 从排序器中取出的键值个数
+  long loaded = 0;        // 已经写入叶子节点的键值个数
+  size_t node_index = 0;
+  while (OB_SUCC(rc) && loaded < key_count) {
+    Frame *new_frame = nullptr;
+    rc = disk_buffer_pool_->allocate_page(&new_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate leaf page. rc=%s", strrc(rc));
+      break;
+    }
+
+    // 叶子节点按照顺序分配，分配到下一个节点时才知道当前节点的兄弟
+    if (frame != nullptr) {
+      LeafIndexNodeHandler(file_header_, frame).set_next_page(new_frame->page_num());
+      disk_buffer_pool_->unpin_page(frame);
+    }
+    frame = new_frame;
+    frame->mark_dirty();
+
+    LeafIndexNodeHandler leaf_node(file_header_, frame);
+    leaf_node.init_empty();
+
+    // 前缀压缩时节点能放下多少键值与公共前缀的长度有关，放不下时提前结束当前节点，剩下的键值重新规划
+    int num = static_cast<int>(node_keys.size() / key_length);
+    int prefix_len = num > 0 ? attr_length : 0;
+    bool full = false;
+    while (num < sizes[node_index] && fetched < key_count) {
+      const char *key = nullptr;
+      rc = bulk_sorter_->next(key);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to fetch sorted key. rc=%s", strrc(rc));
+        break;
+      }
+
+      fetched++;
+      if (check_unique && fetched > 1 && key_comparator_.attr_comparator()(last_key.data(), key, true) == 0) {
+        LOG_TRACE("entry exists");
+        rc = RC::RECORD_DUPLICATE_KEY;
+        break;
+      }
+      memcpy(last_key.data(), key, key_length);
+
+      const int new_prefix_len = num == 0 ? attr_length : common_prefix_length(node_keys.data(), key, prefix_len);
+      node_keys.insert(node_keys.end(), key, key + key_length);
+      if (!leaf_node.fits(num + 1, new_prefix_len)) {
+        full = true;
+        break;
+      }
+      prefix_len = new_prefix_len;
+      num++;
+    }
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
+    leaf_node.assign(node_keys.data(), num);
+    level_keys.insert(level_keys.end(), node_keys.data(), node_keys.data() + key_length);
+    level_pages.push_back(frame->page_num());
+    loaded += num;
+    node_keys.erase(node_keys.begin(), node_keys.begin() + static_cast<long>(num) * key_length);
+
+    if (full) {
+      sizes = plan_node_sizes(static_cast<int>(key_count - loaded), file_header_.leaf_max_size, bulk_fill_factor_);
+      node_index = 0;
+    } else {
+      node_index++;
+    }
+  }
+
+  if (frame != nullptr) {
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return rc;
+}
+
+RC BplusTreeHandler::bulk_load_internal_level(vector<char> &level_keys, vector<PageNum> &level_pages) {
+  const int key_length = file_header_.key_length;
+  const vector<int> sizes =
+      plan_node_sizes(static_cast<int>(level_pages.size()), file_header_.internal_max_size, bulk_fill_factor_);
+
+  vector<char> upper_keys;
+  vector<PageNum> upper_pages;
+  int child = 0;
+  for (int size : sizes) {
+    Frame *frame = nullptr;
+    RC rc = disk_buffer_pool_->allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate internal page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    // 子节点子树中最小的键值作为分隔键。第一项的键值在查找时用不到，与分裂出来的节点一样也保留下来，
+    // 合并节点时它会成为父节点中的分隔键
+    InternalIndexNodeHandler internal_node(file_header_, frame);
+    internal_node.init_empty();
+    upper_keys.insert(upper_keys.end(), level_keys.data() + static_cast<size_t>(child) * key_length,
+                      level_keys.data() + static_cast<size_t>(child + 1) * key_length);
+    upper_pages.push_back(frame->page_num());
+    for (int i = 0; OB_SUCC(rc) && i < size; i++, child++) {
+      rc = internal_node.append_child(level_keys.data() + static_cast<size_t>(child) * key_length,
+                                      level_pages[child], disk_buffer_pool_);
+    }
+    frame->mark_dirty();
+    disk_buffer_pool_->unpin_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to append child to internal node. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  level_keys.swap(upper_keys);
+  level_pages.swap(upper_pages);
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::get_entry(const char *user_key, int key_len, std::list<RID> &rids) {
   BplusTreeScanner scanner(*this);
   RC rc = scanner.open(user_key, key_len, true /*left_inclusive*/, user_key, key_len, true /*right_inclusive*/);
@@ -1404,7 +2079,7 @@ RC BplusTreeHandler::coalesce_or_redistribute(LatchMemo &latch_memo, Frame *fram
   latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  if (!index_node.can_merge(neighbor_node)) {
     rc = redistribute<IndexNodeHandlerType>(neighbor_frame, frame, parent_frame, index);
   } else {
     rc = coalesce<IndexNodeHandlerType>(latch_memo, neighbor_frame, frame, parent_frame, index);
@@ -1550,21 +2225,35 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   inited_ = true;
   first_emitted_ = false;
+  left_skip_key_.clear();
+  key_buf_.resize(tree_handler_.file_header_.key_length);
+
+  const AttrComparator &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
+  const int attr_length = attr_comparator.attr_length();
+  if (left_len <= 0 || left_len > attr_length) {
+    left_len = attr_length;
+  }
+  if (right_len <= 0 || right_len > attr_length) {
+    right_len = attr_length;
+  }
 
-  // 校验输入的键值是否是合法范围
+  // 校验输入的键值是否是合法范围。只比较两个边界共同的前缀，前缀长度不同时，前缀相等也可能有数据
   if (left_user_key && right_user_key) {
-    const auto &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
-    const int result = attr_comparator(left_user_key, right_user_key);
+    const int result = attr_comparator.compare_prefix(left_user_key, right_user_key, std::min(left_len, right_len));
     if (result > 0 || // left < right
                       // left == right but is (left,right)/[left,right) or (left,right]
-        (result == 0 && (left_inclusive == false || right_inclusive == false))) {
+        (result == 0 && left_len == right_len && (left_inclusive == false || right_inclusive == false))) {
       return RC::INVALID_ARGUMENT;
     }
   }
 
   if (nullptr == left_user_key) {
     rc = tree_handler_.left_most_page(latch_memo_, current_frame_);
-    if (rc != RC::SUCCESS) {
+    if (rc == RC::EMPTY) {
+      // 与指定了左边界时一样，空树直接返回，扫描不到任何数据
+      current_frame_ = nullptr;
+      return RC::SUCCESS;
+    } else if (rc != RC::SUCCESS) {
       LOG_WARN("failed to find left most page. rc=%s", strrc(rc));
       return rc;
     }
@@ -1572,72 +2261,84 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     iter_index_ = 0;
   } else {
 
-    char *fixed_left_key = const_cast<char *>(left_user_key);
+    // 左边界只是前缀时，后面的字段都当作 NULL，定位到前缀相同的第一个键值。
+    // 不包含左边界时，再跳过所有前缀相同的键值
+    std::vector<char> fixed_left_key(attr_length, 0);
+    memcpy(fixed_left_key.data(), left_user_key, left_len);
+    const bool left_prefix = left_len < attr_length;
+    if (left_prefix) {
+      attr_comparator.set_null_after(fixed_left_key.data(), left_len);
+      if (!left_inclusive) {
+        left_skip_key_.assign(fixed_left_key.begin(), fixed_left_key.begin() + left_len);
+      }
+    }
 
     MemPoolItem::unique_ptr left_pkey;
-    if (left_inclusive) {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::min());
+    if (left_inclusive || left_prefix) {
+      left_pkey = tree_handler_.make_key(fixed_left_key.data(), *RID::min());
     } else {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::max());
+      left_pkey = tree_handler_.make_key(fixed_left_key.data(), *RID::max());
     }
 
     const char *left_key = (const char *)left_pkey.get();
 
-    if (fixed_left_key != left_user_key) {
-      delete[] fixed_left_key;
-      fixed_left_key = nullptr;
-    }
-
-    rc = tree_handler_.find_leaf(latch_memo_, BplusTreeOperationType::READ, left_key, current_frame_);
-    if (rc == RC::EMPTY) {
-      rc = RC::SUCCESS;
-      current_frame_ = nullptr;
-      return rc;
-    } else if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to find left page. rc=%s", strrc(rc));
-      return rc;
-    }
-
-    LeafIndexNodeHandler left_node(tree_handler_.file_header_, current_frame_);
-    int left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
-    // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
-    if (left_index >= left_node.size()) { // 超出了当前页，就需要向后移动一个位置
-      const PageNum next_page_num = left_node.next_page();
-      if (next_page_num == BP_INVALID_PAGE_NUM) { // 这里已经是最后一页，说明当前扫描，没有数据
-        latch_memo_.release();
+    int left_index = -1;
+    while (left_index < 0) {
+      rc = tree_handler_.find_leaf(latch_memo_, BplusTreeOperationType::READ, left_key, current_frame_);
+      if (rc == RC::EMPTY) {
+        rc = RC::SUCCESS;
         current_frame_ = nullptr;
-        return RC::SUCCESS;
-      }
-
-      rc = latch_memo_.get_page(next_page_num, current_frame_);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+        return rc;
+      } else if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to find left page. rc=%s", strrc(rc));
         return rc;
       }
-      latch_memo_.slatch(current_frame_);
 
-      left_index = 0;
+      LeafIndexNodeHandler left_node(tree_handler_.file_header_, current_frame_);
+      left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
+      // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
+      if (left_index >= left_node.size()) { // 超出了当前页，就需要向后移动一个位置
+        const PageNum next_page_num = left_node.next_page();
+        if (next_page_num == BP_INVALID_PAGE_NUM) { // 这里已经是最后一页，说明当前扫描，没有数据
+          latch_memo_.release();
+          current_frame_ = nullptr;
+          return RC::SUCCESS;
+        }
+
+        rc = latch_memo_.get_page(next_page_num, current_frame_);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+          return rc;
+        }
+
+        // 与next_entry一样，向右加锁的顺序与合并节点时相反，不能等待，否则会死锁。
+        // 乐观读不持有父节点的锁就能进入叶子节点，更容易遇到这种情况。加锁失败就重新查找
+        if (!latch_memo_.try_slatch(current_frame_)) {
+          latch_memo_.release();
+          current_frame_ = nullptr;
+          left_index = -1;
+          std::this_thread::yield();
+          continue;
+        }
+
+        left_index = 0;
+      }
     }
     iter_index_ = left_index;
   }
 
   // 没有指定右边界范围，那么就返回右边界最大值
+  right_len_ = right_len;
+  right_inclusive_ = right_inclusive;
   if (nullptr == right_user_key) {
     right_key_ = nullptr;
   } else {
-
-    char *fixed_right_key = const_cast<char *>(right_user_key);
-    bool should_include_after_fix = false;
-
+    std::vector<char> fixed_right_key(attr_length, 0);
+    memcpy(fixed_right_key.data(), right_user_key, right_len);
     if (right_inclusive) {
-      right_key_ = tree_handler_.make_key(fixed_right_key, *RID::max());
+      right_key_ = tree_handler_.make_key(fixed_right_key.data(), *RID::max());
     } else {
-      right_key_ = tree_handler_.make_key(fixed_right_key, *RID::min());
-    }
-
-    if (fixed_right_key != right_user_key) {
-      delete[] fixed_right_key;
-      fixed_right_key = nullptr;
+      right_key_ = tree_handler_.make_key(fixed_right_key.data(), *RID::min());
     }
   }
 
@@ -1659,12 +2360,43 @@ bool BplusTreeScanner::touch_end() {
   }
 
   LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
-  const char *this_key = node.key_at(iter_index_);
+  const char *this_key = node.key_at(iter_index_, key_buf_.data());
+  const AttrComparator &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
+  if (right_len_ < attr_comparator.attr_length()) {
+    int compare_result = attr_comparator.compare_prefix(this_key, static_cast<char *>(right_key_.get()), right_len_);
+    return right_inclusive_ ? compare_result > 0 : compare_result >= 0;
+  }
+
   int compare_result = tree_handler_.key_comparator_(this_key, static_cast<char *>(right_key_.get()));
   return compare_result > 0;
 }
 
+bool BplusTreeScanner::skip_left() {
+  if (left_skip_key_.empty()) {
+    return false;
+  }
+
+  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
+  const AttrComparator &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
+  if (attr_comparator.compare_prefix(node.key_at(iter_index_, key_buf_.data()), left_skip_key_.data(),
+                                     static_cast<int>(left_skip_key_.size())) == 0) {
+    return true;
+  }
+
+  // 键值是有序的，之后不会再遇到与左边界前缀相同的键值
+  left_skip_key_.clear();
+  return false;
+}
+
 RC BplusTreeScanner::next_entry(RID &rid) {
+  RC rc = RC::SUCCESS;
+  do {
+    rc = next_item(rid);
+  } while (OB_SUCC(rc) && skip_left());
+  return rc;
+}
+
+RC BplusTreeScanner::next_item(RID &rid) {
   if (nullptr == current_frame_) {
     return RC::RECORD_EOF;
   }
@@ -1712,7 +2444,12 @@ RC BplusTreeScanner::next_entry(RID &rid) {
 
   latch_memo_.release_to(memo_point);
   iter_index_ = -1; // `next` will add 1
-  return next_entry(rid);
+  return next_item(rid);
+}
+
+const char *BplusTreeScanner::current_key() const {
+  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
+  return node.key_at(iter_index_, key_buf_.data());
 }
 
 RC BplusTreeScanner::close() {
@@ -1786,11 +2523,10 @@ int AttrComparator::compare_data(const char *v1, const char *v2, AttrType type,
     return Date::compare_date((const Date *)v1, (const Date *)v2);
   }
   case TEXTS: {
-    Value a, b;
-    Table *table = const_cast<Table *>(table_);
-    table->get_text(*(int *)v1, a);
-    table->get_text(*(int *)v2, b);
-    return common::compare_string(a.get_string().data(), TEXT_SIZE, b.get_string().data(), TEXT_SIZE);
+    std::string a, b;
+    table_->text_handler()->get_text(*(int *)v1, a);
+    table_->text_handler()->get_text(*(int *)v2, b);
+    return common::compare_string(a.data(), static_cast<int>(a.size()), b.data(), static_cast<int>(b.size()));
   }
   default: {
     ASSERT(false, "unknown attr type. %d", attr_type_);
@@ -1802,7 +2538,8 @@ int AttrComparator::compare_data(const char *v1, const char *v2, AttrType type,
 int AttrComparator::operator()(const char *v1, const char *v2, bool ignore_null) const {
   int v1n = *(int *)(v1);
   int v2n = *(int *)(v2);
-  for (const auto &field : meta_.fields()) {
+  for (int i = 0; i < key_field_num_; i++) {
+    const FieldMeta &field = meta_.fields()[i];
     int size;
     if (field.type() != CHARS) {
       size = attr_type_to_size(field.type());
@@ -1836,9 +2573,51 @@ int AttrComparator::operator()(const char *v1, const char *v2, bool ignore_null)
   return 0;
 }
 
+int AttrComparator::compare_prefix(const char *v1, const char *v2, int prefix_len) const {
+  int v1n = *(int *)(v1);
+  int v2n = *(int *)(v2);
+  int offset = 0;
+  for (int i = 0; i < key_field_num_; i++) {
+    const FieldMeta &field = meta_.fields()[i];
+    if (offset >= prefix_len) {
+      break;
+    }
+    const int size = field.type() != CHARS ? attr_type_to_size(field.type()) : field.len();
+    if (field.visible()) {
+      bool is_null1 = (v1n & (1 << field.index()));
+      bool is_null2 = (v2n & (1 << field.index()));
+      if (is_null1 != is_null2) {
+        return is_null1 ? -1 : 1;
+      }
+      if (!is_null1) {
+        int cmp = compare_data(v1 + offset, v2 + offset, field.type(), size);
+        if (cmp != 0) {
+          return cmp;
+        }
+      }
+    }
+    offset += size;
+  }
+  return 0;
+}
+
+void AttrComparator::set_null_after(char *key, int prefix_len) const {
+  int null_flags = *(int *)(key);
+  int offset = 0;
+  for (int i = 0; i < key_field_num_; i++) {
+    const FieldMeta &field = meta_.fields()[i];
+    if (offset >= prefix_len && field.visible()) {
+      null_flags |= (1 << field.index());
+    }
+    offset += field.type() != CHARS ? attr_type_to_size(field.type()) : field.len();
+  }
+  *(int *)(key) = null_flags;
+}
+
 void AttrComparator::init(const Table *table, const IndexMeta &meta) {
   table_ = table;
   meta_ = meta;
+  key_field_num_ = meta.key_field_num();
   attr_length_ = 0;
   for (auto &field : meta.fields()) {
     if (field.type() == CHARS) {
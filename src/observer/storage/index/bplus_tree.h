@@ -16,11 +16,14 @@ See the Mulan PSL v2 for more details. */
 #include <memory>
 #include <sstream>
 #include <string.h>
+#include <vector>
 
 #include "common/lang/comparator.h"
 #include "common/log/log.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/index_key_searcher.h"
+#include "storage/index/index_key_sorter.h"
 #include "storage/record/record_manager.h"
 #include "storage/trx/latch_memo.h"
 
@@ -51,9 +54,22 @@ public:
 
   int operator()(const char *v1, const char *v2, bool ignore_null = false) const;
 
+  /**
+   * @brief 只比较键值的前缀，也就是开头 prefix_len 个字节中的字段
+   * @details 用于多列索引的最左前缀扫描。prefix_len 包含开头的 NULL 标记字段
+   */
+  int compare_prefix(const char *v1, const char *v2, int prefix_len) const;
+
+  /**
+   * @brief 把前缀之后的字段都标记为 NULL
+   * @details NULL 比其它值都小，这样的键值不大于任何一个前缀相同的键值
+   */
+  void set_null_after(char *key, int prefix_len) const;
+
 private:
   int compare_data(const char *v1, const char *v2, AttrType type, int char_len) const;
   int attr_length_;
+  int key_field_num_ = 0; ///< 只比较前面的键值字段，之后的 INCLUDE 字段不参与比较
   const Table *table_;
   IndexMeta meta_;
 };
@@ -65,10 +81,18 @@ private:
  */
 class KeyComparator {
 public:
-  void init(const Table *table, const IndexMeta &meta) { attr_comparator_.init(table, meta); }
+  void init(const Table *table, const IndexMeta &meta) {
+    attr_comparator_.init(table, meta);
+    key_searcher_.init(meta);
+  }
 
   const AttrComparator &attr_comparator() const { return attr_comparator_; }
 
+  /**
+   * @brief 单列 INT/FLOAT/DATE 键值在节点内的查找，不能使用时 enabled() 返回 false
+   */
+  const IndexKeySearcher &key_searcher() const { return key_searcher_; }
+
   int operator()(const char *v1, const char *v2) const {
     int result = attr_comparator_(v1, v2);
     if (result != 0) {
@@ -82,6 +106,7 @@ public:
 
 private:
   AttrComparator attr_comparator_;
+  IndexKeySearcher key_searcher_;
 };
 
 /**
@@ -166,6 +191,7 @@ struct IndexFileHeader {
   int32_t leaf_max_size;     ///< 叶子节点最大的键值对数
   int32_t attr_length;       ///< 键值的长度
   int32_t key_length;        ///< attr length + sizeof(RID)
+  int32_t leaf_prefix_compression; ///< 叶子节点是否使用前缀压缩，之前创建的索引文件中是0
 
   const std::string to_string() {
     std::stringstream ss;
@@ -174,7 +200,8 @@ struct IndexFileHeader {
        << "key_length:" << key_length << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
-       << "leaf_max_size:" << leaf_max_size << ";";
+       << "leaf_max_size:" << leaf_max_size << ","
+       << "leaf_prefix_compression:" << leaf_prefix_compression << ";";
 
     return ss.str();
   }
@@ -208,9 +235,18 @@ struct IndexNode {
  * so the key in leaf page must be unique.
  * the value is rid.
  * can you implenment a cluster index ?
+ *
+ * 使用前缀压缩时(IndexFileHeader::leaf_prefix_compression)，节点中所有键值相同的前缀只存放一份，
+ * 每一项只存放键值去掉前缀之后的部分。值就是键值最后的 RID，不再单独存放:
+ * @code
+ * | common header | prev page id | next page id |
+ * | prefix length | prefix | key0 suffix | key1 suffix | ... | keyn suffix |
+ * @endcode
+ * 前缀不超过 attr_length，所以 RID 总是完整地存放在每一项中。
  */
 struct LeafIndexNode : public IndexNode {
   static constexpr int HEADER_SIZE = IndexNode::HEADER_SIZE + 4;
+  static constexpr int PREFIX_HEADER_SIZE = 4; ///< 前缀压缩时 array 最前面存放前缀的长度
 
   PageNum next_brother;
   /**
@@ -290,7 +326,16 @@ public:
   void set_next_page(PageNum page_num);
   PageNum next_page() const;
 
-  char *key_at(int index);
+  /**
+   * @brief 返回完整的键值
+   * @details 前缀压缩的节点需要拼接出完整的键值，放在当前对象的缓存中，再次调用 key_at 之后就失效了
+   */
+  const char *key_at(int index);
+
+  /**
+   * @brief 返回完整的键值，前缀压缩的节点把键值拼接到 buf 中，buf 的大小是 key_length
+   */
+  const char *key_at(int index, char *buf) const;
   char *value_at(int index);
 
   /**
@@ -301,6 +346,35 @@ public:
 
   int lookup_unique(const KeyComparator &comparator, const char *key, bool *found = nullptr) const;
 
+  /**
+   * @brief 插入这个键值之后节点是否还能放得下，放不下就要先分裂
+   */
+  bool can_insert(const char *key) const;
+
+  /**
+   * @brief 两个节点的数据能否合并到一个节点中
+   */
+  bool can_merge(const LeafIndexNodeHandler &other) const;
+
+  /**
+   * @brief 有 num 个键值、公共前缀长度是 prefix_len 时能否放到一个节点中
+   */
+  bool fits(int num, int prefix_len) const;
+
+  /**
+   * @brief 用排好序的 num 个键值替换节点中所有的数据，前缀压缩的节点会重新计算公共前缀
+   * @details 调用者保证放得下
+   */
+  void assign(const char *keys, int num);
+
+  /**
+   * @brief 前缀压缩时所有键值公共前缀的长度，不压缩时是0
+   */
+  int prefix_length() const;
+
+  /**
+   * @note 前缀压缩的节点中值就是键值中的 RID，不再单独存放 value
+   */
   void insert(int index, const char *key, const char *value);
   void remove(int index);
   int remove(const char *key, const KeyComparator &comparator);
@@ -321,11 +395,21 @@ private:
   char *__key_at(int index) const;
   char *__value_at(int index) const;
 
-  void append(const char *item);
-  void preappend(const char *item);
+  /// 前缀压缩的节点中每一项的大小，不压缩时是 item_size
+  int slot_size() const;
+  char *__prefix() const;
+  char *__items() const;
+
+  /// 把 [begin, end) 的完整键值依次复制到 keys 中
+  void copy_keys(int begin, int end, char *keys) const;
+
+  template <typename Comparator>
+  int lower_bound(const Comparator &comparator, const char *key, bool *found) const;
 
 private:
   LeafIndexNode *leaf_node_;
+  bool prefix_compression_ = false;
+  mutable std::vector<char> key_buf_; ///< 拼接前缀压缩的键值
 };
 
 /**
@@ -363,6 +447,12 @@ public:
   int lookup(const KeyComparator &comparator, const char *key, bool *found = nullptr,
              int *insert_position = nullptr) const;
 
+  /**
+   * @brief 在最后追加一个子节点，同时设置子节点的父节点。批量构建时使用
+   * @param key 子节点中最小的键值
+   */
+  RC append_child(const char *key, PageNum page_num, DiskBufferPool *bp);
+
   RC move_to(InternalIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool);
   RC move_first_to_end(InternalIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool);
   RC move_last_to_front(InternalIndexNodeHandler &other, DiskBufferPool *bp);
@@ -370,6 +460,8 @@ public:
 
   bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
 
+  bool can_merge(const InternalIndexNodeHandler &other) const { return size() + other.size() <= max_size(); }
+
   friend std::string to_string(const InternalIndexNodeHandler &handler, const KeyPrinter &printer);
 
 private:
@@ -389,6 +481,20 @@ private:
   InternalIndexNode *internal_node_ = nullptr;
 };
 
+/**
+ * @brief B+树的统计信息，用来观察树的大小和节点的填充情况
+ * @ingroup BPlusTree
+ */
+struct BplusTreeStat {
+  int height = 0;          ///< 树的高度，空树是0，只有一个叶子节点是1
+  int leaf_pages = 0;      ///< 叶子节点的个数
+  int internal_pages = 0;  ///< 内部节点的个数
+  long entries = 0;        ///< 索引项的个数
+  long internal_items = 0; ///< 所有内部节点中的子节点个数
+
+  int total_pages() const { return leaf_pages + internal_pages; }
+};
+
 /**
  * @brief B+树的实现
  * @ingroup BPlusTree
@@ -398,9 +504,10 @@ public:
   /**
    * 此函数创建一个名为fileName的索引。
    * attrType描述被索引属性的类型，attrLength描述被索引属性的长度
+   * @param leaf_prefix_compression 叶子节点是否使用前缀压缩
    */
   RC create(const char *file_name, const Table *table, const IndexMeta &meta, int internal_max_size = -1,
-            int leaf_max_size = -1);
+            int leaf_max_size = -1, bool leaf_prefix_compression = true);
 
   /**
    * 打开名为fileName的索引文件。
@@ -422,6 +529,36 @@ public:
    */
   RC insert_entry(const char *user_key, const RID *rid);
 
+  /**
+   * @brief 批量插入索引项
+   * @details 先按照键值排序再插入。下一个键值仍然落在当前叶子节点中，并且叶子节点不需要分裂时，
+   * 直接插入到这个叶子节点，不再从根节点开始查找。
+   * 中途失败时会删除这次已经插入的索引项
+   * @param user_keys 所有的键值，连续存放，每个键值的长度都是 attr_length
+   * @param rids      每个键值对应的记录
+   * @param count     键值的个数
+   */
+  RC insert_entries(const char *user_keys, const RID *rids, int count);
+
+  /**
+   * @brief 开始自底向上批量构建B+树
+   * @details 只能用于新创建的空树。用 bulk_load_add 添加所有的索引项，最后调用 bulk_load_finish。
+   * 与逐条插入相比，不需要每次从根节点查找，也没有节点分裂，叶子节点在文件中按照键值顺序分配。
+   * @param fill_factor 叶子节点和内部节点填充到最大容量的百分之多少，给之后的插入留出空间。
+   *                    不会低于节点的最小容量
+   * @param sort_memory 排序时最多使用多少内存，超过之后借助临时文件做外部排序
+   */
+  RC bulk_load_begin(int fill_factor, long sort_memory = IndexKeySorter::DEFAULT_MEMORY_LIMIT);
+  RC bulk_load_add(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 对所有键值排序，按顺序填充叶子节点，再逐层向上构建内部节点
+   * @details 唯一索引有重复的键值时返回 RECORD_DUPLICATE_KEY。
+   * 失败时已经分配的页面不会回收，调用者应该删除这个索引
+   * @note 线程不安全，构建期间不能有其它人访问这棵树
+   */
+  RC bulk_load_finish();
+
   /**
    * 从IndexHandle句柄对应的索引中删除一个值为（*pData，rid）的索引项
    * @return RECORD_INVALID_KEY 指定值不存在
@@ -431,6 +568,20 @@ public:
 
   bool is_empty() const;
 
+  /**
+   * @brief 只读的查找是否使用乐观读
+   * @details 乐观读从根节点向下查找时不加锁，只记录每个节点的版本号，进入子节点之后再校验父节点的版本号，
+   * 版本号变了说明父节点被修改过，就从根节点重新开始。只有叶子节点会加读锁。
+   * 重试次数太多时退回到原来的加锁方式(crabing)。修改操作不受影响
+   */
+  void set_optimistic_read(bool enable) { optimistic_read_ = enable; }
+  bool optimistic_read() const { return optimistic_read_; }
+
+  /**
+   * @brief 乐观读一共重试了多少次
+   */
+  static long optimistic_read_restarts();
+
   /**
    * 获取指定值的record
    * @param key_len user_key的长度
@@ -447,6 +598,12 @@ public:
    */
   bool validate_tree();
 
+  /**
+   * @brief 遍历所有节点，统计树的大小
+   * @note thread unsafe
+   */
+  RC stat(BplusTreeStat &stat);
+
 public:
   /**
    * 这些函数都是线程不安全的，不要在多线程的环境下调用
@@ -464,6 +621,20 @@ private:
   bool validate_leaf_link(LatchMemo &latch_memo);
   bool validate_node_recursive(LatchMemo &latch_memo, Frame *frame);
 
+  RC stat_node_recursive(PageNum page_num, int depth, BplusTreeStat &stat);
+
+  /**
+   * @brief 批量构建时填充叶子节点
+   * @param[out] level_keys  每个叶子节点的第一个键值
+   * @param[out] level_pages 每个叶子节点的页面号
+   */
+  RC bulk_load_leaves(std::vector<char> &level_keys, std::vector<PageNum> &level_pages);
+
+  /**
+   * @brief 批量构建时在下一层节点的基础上构建上面一层内部节点，结果替换到参数中
+   */
+  RC bulk_load_internal_level(std::vector<char> &level_keys, std::vector<PageNum> &level_pages);
+
 protected:
   RC find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame);
   RC left_most_page(LatchMemo &latch_memo, Frame *&frame);
@@ -471,6 +642,13 @@ protected:
                         const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
   RC crabing_protocal_fetch_page(LatchMemo &latch_memo, BplusTreeOperationType op, PageNum page_num, bool is_root_page,
                                  Frame *&frame);
+  /**
+   * @brief 不加锁找到叶子节点，并给叶子节点加上读锁
+   * @return 遇到并发修改需要重试时返回LOCKED_NEED_WAIT
+   */
+  RC optimistic_find_leaf(LatchMemo &latch_memo,
+                          const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
+  PageNum root_page_num() const;
 
   RC insert_into_parent(LatchMemo &latch_memo, PageNum parent_page, Frame *left_frame, const char *pkey,
                         Frame &right_frame);
@@ -508,11 +686,16 @@ protected:
   // 在调整根节点时，需要加上这个锁。
   // 这个锁可以使用递归读写锁，但是这里偷懒先不改
   common::SharedMutex root_lock_;
+  bool optimistic_read_ = true;
 
   KeyComparator key_comparator_;
 
   std::unique_ptr<common::MemPoolItem> mem_pool_item_;
 
+  std::unique_ptr<IndexKeySorter> bulk_sorter_; ///< 批量构建时对键值排序
+  int bulk_fill_factor_ = 100;
+  std::vector<char> bulk_key_; ///< 批量构建时拼接键值和RID
+
 private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
@@ -530,17 +713,25 @@ public:
   /**
    * @brief 扫描指定范围的数据
    * @param left_user_key 扫描范围的左边界，如果是null，则没有左边界
-   * @param left_len left_user_key 的内存大小(只有在变长字段中才会关注)
+   * @param left_len left_user_key 的有效长度，小于完整键值的长度时只比较前面的字段(最左前缀)
    * @param left_inclusive 左边界的值是否包含在内
    * @param right_user_key 扫描范围的右边界。如果是null，则没有右边界
-   * @param right_len right_user_key 的内存大小(只有在变长字段中才会关注)
+   * @param right_len right_user_key 的有效长度，与 left_len 相同
    * @param right_inclusive 右边界的值是否包含在内
+   * @details 长度不大于0或者超过完整键值长度时，按照完整的键值处理。
+   * 例如索引(a, b)上 a > 5 的扫描，左边界只给出 a 的值，会跳过所有 a = 5 的键值。
    */
   RC open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key, int right_len,
           bool right_inclusive);
 
   RC next_entry(RID &rid);
 
+  /**
+   * @brief next_entry 刚返回的键值，不包含 RID
+   * @details 指向叶子节点页面或者扫描器中的内存，下一次调用 next_entry 或者 close 之后不能再访问
+   */
+  const char *current_key() const;
+
   RC close();
 
 private:
@@ -549,9 +740,15 @@ private:
    */
   // RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
 
+  RC next_item(RID &rid);
   void fetch_item(RID &rid);
   bool touch_end();
 
+  /**
+   * @brief 左边界是不包含在内的前缀时，跳过前缀与左边界相同的键值
+   */
+  bool skip_left();
+
 private:
   bool inited_ = false;
   BplusTreeHandler &tree_handler_;
@@ -563,6 +760,11 @@ private:
   Frame *current_frame_ = nullptr;
 
   common::MemPoolItem::unique_ptr right_key_;
+  int right_len_ = 0; ///< 右边界的有效长度，小于完整键值长度时按照前缀比较
+  bool right_inclusive_ = false;
+
+  std::vector<char> left_skip_key_; ///< 需要跳过的前缀，空表示不需要跳过
+  mutable std::vector<char> key_buf_; ///< 前缀压缩的叶子节点中拼接出来的当前键值
   int iter_index_ = -1;
   bool first_emitted_ = false;
 };
@@ -26,7 +26,7 @@ RC BplusTreeIndex::create(const char *file_name, Table *table, const IndexMeta &
 
   Index::init(index_meta);
 
-  RC rc = index_handler_.create(file_name, table, index_meta, size_);
+  RC rc = index_handler_.create(file_name, table, index_meta);
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s", file_name, index_meta.name(),
              index_meta.fields_name().c_str(), strrc(rc));
@@ -88,6 +88,31 @@ RC BplusTreeIndex::insert_entry(const char *record, const RID *rid) {
   return rc;
 }
 
+RC BplusTreeIndex::insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids) {
+  std::vector<char> keys(records.size() * size_);
+  for (size_t i = 0; i < records.size(); i++) {
+    int beg = 0;
+    for (auto &field : index_meta_.fields()) {
+      memcpy(keys.data() + i * size_ + beg, records[i] + field.offset(), field.len());
+      beg += field.len();
+    }
+  }
+  return index_handler_.insert_entries(keys.data(), rids.data(), static_cast<int>(records.size()));
+}
+
+RC BplusTreeIndex::bulk_load_begin(int fill_factor, long sort_memory) {
+  return index_handler_.bulk_load_begin(fill_factor, sort_memory);
+}
+
+RC BplusTreeIndex::bulk_load_add(const char *record, const RID *rid) {
+  char *data = make_key(record);
+  RC rc = index_handler_.bulk_load_add(data, rid);
+  free(data);
+  return rc;
+}
+
+RC BplusTreeIndex::bulk_load_finish() { return index_handler_.bulk_load_finish(); }
+
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid) {
   char *data = make_key(record);
   RC rc = index_handler_.delete_entry(data, rid);
@@ -121,6 +146,8 @@ RC BplusTreeIndexScanner::open(const char *left_key, int left_len, bool left_inc
 
 RC BplusTreeIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
 
+const char *BplusTreeIndexScanner::current_key() const { return tree_scanner_.current_key(); }
+
 RC BplusTreeIndexScanner::destroy() {
   delete this;
   return RC::SUCCESS;
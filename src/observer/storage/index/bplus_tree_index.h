@@ -30,6 +30,20 @@ public:
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 批量插入。键值排序之后插入，相邻的键值通常在同一个叶子节点上
+   */
+  RC insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids) override;
+
+  /**
+   * @brief 批量构建刚创建的空索引。参考 BplusTreeHandler::bulk_load_begin
+   */
+  RC bulk_load_begin(int fill_factor, long sort_memory = IndexKeySorter::DEFAULT_MEMORY_LIMIT);
+  RC bulk_load_add(const char *record, const RID *rid);
+  RC bulk_load_finish();
+
+  RC stat(BplusTreeStat &stat) { return index_handler_.stat(stat); }
+
   /**
    * 扫描指定范围的数据
    */
@@ -54,6 +68,7 @@ public:
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  const char *current_key() const override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
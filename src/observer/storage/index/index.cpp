@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 
 #include "storage/index/index.h"
+#include "common/log/log.h"
 #include "storage/field/field.h"
 
 RC Index::init(const IndexMeta &index_meta) {
@@ -20,3 +21,25 @@ RC Index::init(const IndexMeta &index_meta) {
   }
   return RC::SUCCESS;
 }
+
+RC Index::insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids) {
+  RC rc = RC::SUCCESS;
+  size_t inserted = 0;
+  for (; inserted < records.size(); inserted++) {
+    rc = insert_entry(records[inserted], &rids[inserted]);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    for (size_t i = 0; i < inserted; i++) {
+      RC rc2 = delete_entry(records[i], &rids[i]);
+      if (OB_FAIL(rc2)) {
+        LOG_ERROR("failed to rollback inserted entry. index=%s, rid=%s, rc=%s",
+                  index_meta_.name(), rids[i].to_string().c_str(), strrc(rc2));
+      }
+    }
+  }
+  return rc;
+}
@@ -55,6 +55,15 @@ public:
    */
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 批量插入数据
+   * @details 默认实现是逐条插入，中途失败时删除已经插入的数据。
+   * 子类可以按照键值排序后插入，减少查找的次数
+   * @param records 插入的记录
+   * @param rids    每条记录的位置，与 records 一一对应
+   */
+  virtual RC insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids);
+
   /**
    * @brief 创建一个索引数据的扫描器
    * 
@@ -96,5 +105,11 @@ public:
    * 如果没有更多的元素，返回RECORD_EOF
    */
   virtual RC next_entry(RID *rid) = 0;
+
+  /**
+   * @brief next_entry 刚返回的索引键值，按照索引字段的顺序存放
+   * @details 只扫描索引就能得到结果时，用它代替读取记录。下一次调用 next_entry 之后失效
+   */
+  virtual const char *current_key() const = 0;
   virtual RC destroy() = 0;
 };
@@ -0,0 +1,58 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/index_key_searcher.h"
+
+using namespace index_key_search;
+
+void IndexKeySearcher::init(const IndexMeta &meta) {
+  type_ = KeySearchType::GENERIC;
+  null_bit_ = 0;
+
+  // 第一个字段是 NULL 标记，后面只有一个字段，也没有 INCLUDE 的字段
+  const std::vector<FieldMeta> &fields = meta.fields();
+  if (fields.size() != 2 || meta.key_field_num() != 2 || fields[0].visible() || !fields[1].visible()) {
+    return;
+  }
+  if (fields[0].len() != sizeof(int32_t) || fields[1].len() != sizeof(int32_t)) {
+    return;
+  }
+
+  switch (fields[1].type()) {
+  case INTS:
+  case DATES: {
+    type_ = KeySearchType::INT32;
+  } break;
+  case FLOATS: {
+    type_ = KeySearchType::FLOAT;
+  } break;
+  default: {
+    return;
+  }
+  }
+  null_bit_ = 1U << fields[1].index();
+}
+
+int IndexKeySearcher::lower_bound(const char *items, int stride, int count, const char *prefix, int prefix_len,
+                                  const char *key, bool *found) const {
+  if (prefix_len > 0) {
+    const PrefixKeyLoader loader(prefix, prefix_len);
+    if (type_ == KeySearchType::FLOAT) {
+      return index_key_search::lower_bound<FloatKeyTraits>(loader, items, stride, count, key, null_bit_, found);
+    }
+    return index_key_search::lower_bound<Int32KeyTraits>(loader, items, stride, count, key, null_bit_, found);
+  }
+
+  const PlainKeyLoader loader;
+  if (type_ == KeySearchType::FLOAT) {
+    return index_key_search::lower_bound<FloatKeyTraits>(loader, items, stride, count, key, null_bit_, found);
+  }
+  return index_key_search::lower_bound<Int32KeyTraits>(loader, items, stride, count, key, null_bit_, found);
+}
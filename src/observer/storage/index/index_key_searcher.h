@@ -0,0 +1,198 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <bit>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/defs.h"
+#include "storage/index/index_meta.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 节点内查找键值的方式
+ * @ingroup BPlusTree
+ */
+enum class KeySearchType {
+  GENERIC, ///< 通过 KeyComparator 逐个字段比较，多列、CHARS 等键值都用这种方式
+  INT32,   ///< 单列的 INT 或者 DATE 键值
+  FLOAT,   ///< 单列的 FLOAT 键值
+};
+
+/**
+ * @brief 单列定长键值在 B+ 树节点内的二分查找
+ * @ingroup BPlusTree
+ * @details 键值只有 NULL 标记和一个 INT/FLOAT/DATE 字段时，完整的键值固定是 16 个字节：
+ * | null flags(4) | value(4) | page num(4) | slot num(4) |。
+ * 按照类型展开比较，不用每次比较都经过 AttrComparator 按照字段类型分派，二分查找也不用分支，
+ * 只在循环中用条件传送选择下一次查找的位置。比较的结果与 KeyComparator 相同：NULL 比其它值都小，
+ * FLOAT 相差不超过 EPSILON 时认为相等，键值相同时再比较 RID。
+ * 其它的键值不能使用，type() 是 GENERIC，由调用者使用原来的比较方式。
+ */
+class IndexKeySearcher {
+public:
+  static constexpr int KEY_LENGTH = 2 * sizeof(int32_t) + sizeof(RID);
+
+  void init(const IndexMeta &meta);
+
+  KeySearchType type() const { return type_; }
+  bool enabled() const { return type_ != KeySearchType::GENERIC; }
+
+  /**
+   * @brief 在 count 个排好序的键值中找到第一个不小于 key 的位置
+   * @param items 第一个键值。前缀压缩的叶子节点中是去掉前缀之后的部分
+   * @param stride 相邻两个键值之间的距离
+   * @param prefix 前缀压缩时所有键值公共的前缀，prefix_len 不超过 null 标记和字段的长度
+   * @param key 要查找的完整键值，包含 RID
+   * @param found 返回是否有相同的键值
+   */
+  int lower_bound(const char *items, int stride, int count, const char *prefix, int prefix_len, const char *key,
+                  bool *found) const;
+
+private:
+  KeySearchType type_ = KeySearchType::GENERIC;
+  uint32_t null_bit_ = 0; ///< 字段在 null flags 中对应的位
+};
+
+namespace index_key_search {
+
+static_assert(std::endian::native == std::endian::little, "index keys are compared as little endian words");
+static_assert(sizeof(RID) == 8, "RID should be two int32 values");
+
+/**
+ * @brief 完整键值的两个 64 位的字：null flags 和字段值，RID
+ */
+struct FixedKey {
+  uint64_t attr;
+  uint64_t rid;
+};
+
+inline uint64_t load_word(const char *data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/**
+ * @brief RID 变成可以直接比较大小的无符号整数，先比较 page num 再比较 slot num
+ */
+inline uint64_t rid_order(uint64_t rid) {
+  const uint64_t page_num = static_cast<uint32_t>(rid) ^ 0x80000000U;
+  const uint64_t slot_num = static_cast<uint32_t>(rid >> 32) ^ 0x80000000U;
+  return (page_num << 32) | slot_num;
+}
+
+/**
+ * @brief 没有前缀压缩的键值
+ */
+struct PlainKeyLoader {
+  FixedKey load(const char *item) const { return FixedKey{load_word(item), load_word(item + 8)}; }
+};
+
+/**
+ * @brief 前缀压缩的键值，前缀只会覆盖第一个字，从前缀中取出开头的 prefix_len 个字节
+ * @details item 前面 prefix_len 个字节仍然在页面中(前一项或者前缀)，可以直接按照完整的键值读取再替换掉前缀的部分
+ */
+struct PrefixKeyLoader {
+  PrefixKeyLoader(const char *prefix, int prefix_len) : prefix_len(prefix_len) {
+    char buf[sizeof(uint64_t)] = {0};
+    memcpy(buf, prefix, prefix_len);
+    prefix_word = load_word(buf);
+    prefix_mask = prefix_len >= 8 ? ~0ULL : (1ULL << (prefix_len * 8)) - 1;
+  }
+
+  FixedKey load(const char *item) const {
+    const uint64_t attr = (prefix_word & prefix_mask) | (load_word(item - prefix_len) & ~prefix_mask);
+    return FixedKey{attr, load_word(item + 8 - prefix_len)};
+  }
+
+  int prefix_len;
+  uint64_t prefix_word;
+  uint64_t prefix_mask;
+};
+
+/**
+ * @brief INT 和 DATE 的比较：NULL 映射成比所有 int32 都小的值
+ */
+struct Int32KeyTraits {
+  static int compare_attr(uint64_t attr1, uint64_t attr2, uint32_t null_bit) {
+    const int64_t v1 = (static_cast<uint32_t>(attr1) & null_bit) ? INT64_MIN : static_cast<int32_t>(attr1 >> 32);
+    const int64_t v2 = (static_cast<uint32_t>(attr2) & null_bit) ? INT64_MIN : static_cast<int32_t>(attr2 >> 32);
+    return (v1 > v2) - (v1 < v2);
+  }
+};
+
+/**
+ * @brief FLOAT 的比较，与 common::compare_float 相同
+ */
+struct FloatKeyTraits {
+  static int compare_attr(uint64_t attr1, uint64_t attr2, uint32_t null_bit) {
+    const int null1 = (static_cast<uint32_t>(attr1) & null_bit) != 0;
+    const int null2 = (static_cast<uint32_t>(attr2) & null_bit) != 0;
+    const float v1 = std::bit_cast<float>(static_cast<uint32_t>(attr1 >> 32));
+    const float v2 = std::bit_cast<float>(static_cast<uint32_t>(attr2 >> 32));
+    const float diff = v1 - v2;
+    const int result = (diff > EPSILON) - (diff < -EPSILON);
+    return (null1 | null2) ? null2 - null1 : result;
+  }
+};
+
+template <typename Traits>
+inline int compare(const FixedKey &key1, uint64_t rid_order1, const FixedKey &key2, uint64_t rid_order2,
+                   uint32_t null_bit) {
+  const int result = Traits::compare_attr(key1.attr, key2.attr, null_bit);
+  return result != 0 ? result : (rid_order1 > rid_order2) - (rid_order1 < rid_order2);
+}
+
+/**
+ * @brief 没有分支的二分查找
+ * @details 每次把范围缩小一半，比较的结果只用来计算下一次的起点，编译成条件传送，不会有分支预测失败。
+ * 比较的次数固定是 log2(count) + 1
+ */
+template <typename Traits, typename Loader>
+int lower_bound(const Loader &loader, const char *items, int stride, int count, const char *key_data,
+                uint32_t null_bit, bool *found) {
+  if (count <= 0) {
+    if (found) {
+      *found = false;
+    }
+    return 0;
+  }
+
+  const FixedKey key{load_word(key_data), load_word(key_data + 8)};
+  const uint64_t key_rid = rid_order(key.rid);
+  auto less = [&](int index) {
+    const FixedKey item = loader.load(items + static_cast<long>(index) * stride);
+    return compare<Traits>(item, rid_order(item.rid), key, key_rid, null_bit) < 0;
+  };
+
+  int base = 0;
+  int n = count;
+  while (n > 1) {
+    const int half = n / 2;
+    base += less(base + half - 1) ? half : 0;
+    n -= half;
+  }
+  base += less(base) ? 1 : 0;
+
+  if (found) {
+    bool equal = false;
+    if (base < count) {
+      const FixedKey item = loader.load(items + static_cast<long>(base) * stride);
+      equal = compare<Traits>(item, rid_order(item.rid), key, key_rid, null_bit) == 0;
+    }
+    *found = equal;
+  }
+  return base;
+}
+
+}  // namespace index_key_search
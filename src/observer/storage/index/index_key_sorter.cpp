@@ -0,0 +1,252 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/io/io.h"
+#include "common/log/log.h"
+#include "storage/index/index_key_sorter.h"
+
+using namespace std;
+
+/// 读写临时文件时的缓冲区大小
+static constexpr int RUN_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * @brief 一个写到临时文件中的有序的run
+ */
+class IndexKeySorter::Run {
+public:
+  Run(string file_name, int key_length)
+      : file_name_(std::move(file_name)), key_length_(key_length),
+        buffer_(max(RUN_BUFFER_SIZE / key_length_, 1) * static_cast<size_t>(key_length_)) {}
+
+  ~Run() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      ::unlink(file_name_.c_str());
+    }
+  }
+
+  RC create() {
+    fd_ = ::open(file_name_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd_ < 0) {
+      LOG_WARN("failed to create sort run file. file=%s, errno=%d:%s", file_name_.c_str(), errno, strerror(errno));
+      return RC::IOERR_OPEN;
+    }
+    return RC::SUCCESS;
+  }
+
+  RC write(const vector<const char *> &keys) {
+    size_t used = 0;
+    for (const char *key : keys) {
+      if (used == buffer_.size()) {
+        RC rc = flush(used);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        used = 0;
+      }
+      memcpy(buffer_.data() + used, key, key_length_);
+      used += key_length_;
+    }
+
+    RC rc = flush(used);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    remain_ = static_cast<long>(keys.size());
+    if (::lseek(fd_, 0, SEEK_SET) < 0) {
+      LOG_WARN("failed to seek sort run file. file=%s, errno=%d:%s", file_name_.c_str(), errno, strerror(errno));
+      return RC::IOERR_SEEK;
+    }
+    return RC::SUCCESS;
+  }
+
+  /**
+   * @brief 移动到下一个键值
+   * @return 这个run读完时返回 RECORD_EOF
+   */
+  RC advance() {
+    if (remain_ <= 0) {
+      return RC::RECORD_EOF;
+    }
+
+    pos_ += key_length_;
+    if (pos_ >= end_) {
+      const size_t bytes = min(static_cast<size_t>(remain_) * key_length_, buffer_.size());
+      int ret = common::readn(fd_, buffer_.data(), static_cast<int>(bytes));
+      if (ret != 0) {
+        LOG_WARN("failed to read sort run file. file=%s, ret=%d", file_name_.c_str(), ret);
+        return RC::IOERR_READ;
+      }
+      pos_ = 0;
+      end_ = bytes;
+    }
+    remain_--;
+    return RC::SUCCESS;
+  }
+
+  const char *current() const { return buffer_.data() + pos_; }
+
+private:
+  RC flush(size_t size) {
+    if (size == 0) {
+      return RC::SUCCESS;
+    }
+    int ret = common::writen(fd_, buffer_.data(), static_cast<int>(size));
+    if (ret != 0) {
+      LOG_WARN("failed to write sort run file. file=%s, ret=%d", file_name_.c_str(), ret);
+      return RC::IOERR_WRITE;
+    }
+    return RC::SUCCESS;
+  }
+
+private:
+  string file_name_;
+  int key_length_;
+  int fd_ = -1;
+  vector<char> buffer_;
+  size_t pos_ = 0; ///< 当前键值在缓冲区中的位置
+  size_t end_ = 0; ///< 缓冲区中有效数据的长度
+  long remain_ = 0; ///< 还有多少个键值没有返回
+};
+
+IndexKeySorter::IndexKeySorter(const Comparator &comparator, int key_length, const string &file_prefix,
+                               long memory_limit)
+    : comparator_(comparator), key_length_(key_length), file_prefix_(file_prefix) {
+  // 每个键值除了自身还需要一个排序用的指针
+  max_memory_keys_ = max(static_cast<size_t>(memory_limit) / (key_length_ + sizeof(char *)), static_cast<size_t>(1));
+  keys_.reserve(min(max_memory_keys_, static_cast<size_t>(RUN_BUFFER_SIZE)) * key_length_);
+}
+
+IndexKeySorter::~IndexKeySorter() = default;
+
+RC IndexKeySorter::add(const char *key) {
+  if (finished_) {
+    LOG_WARN("cannot add key after sorter finished");
+    return RC::INTERNAL;
+  }
+
+  if (keys_.size() / key_length_ >= max_memory_keys_) {
+    RC rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  keys_.insert(keys_.end(), key, key + key_length_);
+  key_count_++;
+  return RC::SUCCESS;
+}
+
+void IndexKeySorter::sort_memory_keys() {
+  const size_t count = keys_.size() / key_length_;
+  order_.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    order_[i] = keys_.data() + i * key_length_;
+  }
+  sort(order_.begin(), order_.end(), [this](const char *a, const char *b) { return comparator_(a, b) < 0; });
+}
+
+RC IndexKeySorter::spill() {
+  sort_memory_keys();
+
+  auto run = make_unique<Run>(file_prefix_ + ".sort." + to_string(runs_.size()), key_length_);
+  RC rc = run->create();
+  if (OB_SUCC(rc)) {
+    rc = run->write(order_);
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LOG_TRACE("spilled sorted keys to disk. run=%d, keys=%d", static_cast<int>(runs_.size()),
+            static_cast<int>(order_.size()));
+  runs_.push_back(std::move(run));
+  keys_.clear();
+  order_.clear();
+  return RC::SUCCESS;
+}
+
+RC IndexKeySorter::finish() {
+  if (finished_) {
+    return RC::SUCCESS;
+  }
+  finished_ = true;
+
+  if (runs_.empty()) {
+    sort_memory_keys();
+    return RC::SUCCESS;
+  }
+
+  if (!keys_.empty()) {
+    RC rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  keys_.shrink_to_fit();
+  order_.shrink_to_fit();
+
+  auto greater = [this](int a, int b) { return comparator_(runs_[a]->current(), runs_[b]->current()) > 0; };
+  for (int i = 0; i < static_cast<int>(runs_.size()); i++) {
+    RC rc = runs_[i]->advance();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    heap_.push_back(i);
+  }
+  make_heap(heap_.begin(), heap_.end(), greater);
+  LOG_INFO("merging sorted runs. runs=%d, keys=%ld", run_count(), key_count_);
+  return RC::SUCCESS;
+}
+
+RC IndexKeySorter::next(const char *&key) {
+  if (!finished_) {
+    LOG_WARN("sorter is not finished");
+    return RC::INTERNAL;
+  }
+
+  if (runs_.empty()) {
+    if (memory_pos_ >= order_.size()) {
+      return RC::RECORD_EOF;
+    }
+    key = order_[memory_pos_++];
+    return RC::SUCCESS;
+  }
+
+  // 堆顶是上一次返回的 run，先让它前进一个键值，再把它放回堆中
+  auto greater = [this](int a, int b) { return comparator_(runs_[a]->current(), runs_[b]->current()) > 0; };
+  if (last_run_ >= 0) {
+    RC rc = runs_[last_run_]->advance();
+    if (OB_SUCC(rc)) {
+      heap_.push_back(last_run_);
+      push_heap(heap_.begin(), heap_.end(), greater);
+    } else if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    last_run_ = -1;
+  }
+
+  if (heap_.empty()) {
+    return RC::RECORD_EOF;
+  }
+
+  pop_heap(heap_.begin(), heap_.end(), greater);
+  last_run_ = heap_.back();
+  heap_.pop_back();
+  key = runs_[last_run_]->current();
+  return RC::SUCCESS;
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/rc.h"
+
+/**
+ * @brief 批量创建索引时对键值做外部排序
+ * @ingroup Index
+ * @details 键值是定长的，先放在内存中，超过内存限制时排好序写到一个临时文件中(一个有序的run)。
+ * 所有键值都添加完之后，如果没有写过临时文件就直接在内存中排序，否则把最后一批也写出去，再对所有的run做多路归并。
+ * 临时文件放在 file_prefix 后面加上 ".sort.<编号>"，排序器析构时删除。
+ */
+class IndexKeySorter {
+public:
+  using Comparator = std::function<int(const char *, const char *)>;
+
+  /// 默认最多使用这么多内存存放键值
+  static constexpr long DEFAULT_MEMORY_LIMIT = 64L * 1024 * 1024;
+
+  IndexKeySorter(const Comparator &comparator, int key_length, const std::string &file_prefix,
+                 long memory_limit = DEFAULT_MEMORY_LIMIT);
+  ~IndexKeySorter();
+
+  RC add(const char *key);
+
+  /**
+   * @brief 添加完所有键值之后调用，之后才能调用 next
+   */
+  RC finish();
+
+  /**
+   * @brief 按照从小到大的顺序返回下一个键值
+   * @details 返回的指针在下一次调用 next 之前有效
+   * @return 没有更多键值时返回 RECORD_EOF
+   */
+  RC next(const char *&key);
+
+  /// 一共添加了多少个键值
+  long key_count() const { return key_count_; }
+  /// 写到临时文件中的run个数，0 表示全部在内存中排序
+  int run_count() const { return static_cast<int>(runs_.size()); }
+
+private:
+  class Run;
+
+  void sort_memory_keys();
+  RC spill();
+
+private:
+  Comparator comparator_;
+  int key_length_;
+  std::string file_prefix_;
+  size_t max_memory_keys_;
+
+  long key_count_ = 0;
+  bool finished_ = false;
+
+  std::vector<char> keys_;          ///< 内存中还没有写出去的键值
+  std::vector<const char *> order_; ///< 内存中键值排序后的顺序
+  size_t memory_pos_ = 0;           ///< 全部在内存中排序时，next 返回到了哪里
+
+  std::vector<std::unique_ptr<Run>> runs_;
+  std::vector<int> heap_; ///< 多路归并的小顶堆，存放还有数据的 run 的下标
+  int last_run_ = -1;     ///< 上一次 next 返回的键值来自哪个 run
+};
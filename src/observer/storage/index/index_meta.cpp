@@ -21,18 +21,24 @@ See the Mulan PSL v2 for more details. */
 const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELDS("fields");
 const static Json::StaticString FIELD_UNIQUE("unique");
+const static Json::StaticString FIELD_INCLUDE_NUM("include_num");
 
 IndexMeta::IndexMeta() {}
 
-RC IndexMeta::init(const char *name, const std::vector<FieldMeta> &fields, bool unique) {
+RC IndexMeta::init(const char *name, const std::vector<FieldMeta> &fields, bool unique, int include_num) {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
     return RC::INVALID_ARGUMENT;
   }
+  if (include_num < 0 || include_num >= static_cast<int>(fields.size())) {
+    LOG_ERROR("Failed to init index, invalid include field number. name=%s, include num=%d", name, include_num);
+    return RC::INVALID_ARGUMENT;
+  }
 
   name_ = name;
   fields_ = fields;
   unique_ = unique;
+  include_num_ = include_num;
   std::vector<std::string> all_fields;
   for (auto &field : fields) {
     all_fields.push_back(field.name());
@@ -49,6 +55,9 @@ void IndexMeta::to_json(Json::Value &json_value) const {
   }
   json_value[FIELD_FIELDS] = fields;
   json_value[FIELD_UNIQUE] = unique_;
+  if (include_num_ > 0) {
+    json_value[FIELD_INCLUDE_NUM] = include_num_;
+  }
 }
 
 RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index) {
@@ -89,9 +98,29 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
 
   bool unique = unique_value.asBool();
 
-  return index.init(name_value.asCString(), fields_meta, unique);
+  // 旧的元数据文件中没有 INCLUDE 的字段
+  int include_num = 0;
+  const Json::Value &include_num_value = json_value[FIELD_INCLUDE_NUM];
+  if (!include_num_value.isNull()) {
+    if (!include_num_value.isInt()) {
+      LOG_ERROR("include num is not an integer. json value=%s", include_num_value.toStyledString().c_str());
+      return RC::INTERNAL;
+    }
+    include_num = include_num_value.asInt();
+  }
+
+  return index.init(name_value.asCString(), fields_meta, unique, include_num);
 }
 
 const char *IndexMeta::name() const { return name_.c_str(); }
 
+bool IndexMeta::contains(const char *field_name) const {
+  for (const FieldMeta &field : fields_) {
+    if (strcmp(field.name(), field_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void IndexMeta::desc(std::ostream &os) const { os << "index name=" << name_ << ", field={" << fields_name_ << "}"; }
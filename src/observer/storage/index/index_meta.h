@@ -32,11 +32,26 @@ class IndexMeta {
 public:
   IndexMeta();
 
-  RC init(const char *name, const std::vector<FieldMeta> &fields, bool unique);
+  /**
+   * @param fields 索引中的所有字段，第一个是 NULL 标记，最后 include_num 个是 INCLUDE 的字段
+   */
+  RC init(const char *name, const std::vector<FieldMeta> &fields, bool unique, int include_num = 0);
 
 public:
   const char *name() const;
   const std::vector<FieldMeta> &fields() const { return fields_; }
+
+  /**
+   * @brief 参与比较的字段个数，包含开头的 NULL 标记
+   * @details 之后的 INCLUDE 字段只存放在键值的最后，不影响顺序和唯一性
+   */
+  int key_field_num() const { return static_cast<int>(fields_.size()) - include_num_; }
+  int include_num() const { return include_num_; }
+
+  /**
+   * @brief 索引中是否存放了这个字段的值，包括 INCLUDE 的字段
+   */
+  bool contains(const char *field_name) const;
   const std::string &fields_name() const { return fields_name_; }
   bool unique() const { return unique_; }
 
@@ -51,4 +66,5 @@ protected:
   std::vector<FieldMeta> fields_;
   std::string fields_name_;
   bool unique_ = false;
+  int include_num_ = 0;
 };
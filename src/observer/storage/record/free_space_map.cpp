@@ -0,0 +1,192 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "common/log/log.h"
+#include "storage/record/free_space_map.h"
+
+RC FreeSpaceMap::init(DiskBufferPool *buffer_pool) {
+  if (buffer_pool_ != nullptr) {
+    LOG_ERROR("free space map has been opened.");
+    return RC::RECORD_OPENNED;
+  }
+
+  buffer_pool_ = buffer_pool;
+  search_hint_.store(0, std::memory_order_relaxed);
+  LOG_INFO("open free space map. file=%s, fsm pages=%d", buffer_pool->file_name().c_str(), fsm_page_count());
+  return RC::SUCCESS;
+}
+
+void FreeSpaceMap::close() { buffer_pool_ = nullptr; }
+
+bool FreeSpaceMap::empty() const { return fsm_page_count() == 0; }
+
+RC FreeSpaceMap::mark_built() {
+  Frame *frame = nullptr;
+  RC rc = get_fsm_page(0, true /*create*/, frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  buffer_pool_->unpin_page(frame);
+
+  // 重建时更新的等级和标记一起写到磁盘上，中途异常退出时下次打开还会重建
+  rc = buffer_pool_->flush_all_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush free space map. file=%s, rc=%s", buffer_pool_->file_name().c_str(), strrc(rc));
+  }
+  return rc;
+}
+
+int FreeSpaceMap::fsm_page_count() const { return std::max(buffer_pool_->page_num() - 1, 0); }
+
+int FreeSpaceMap::avail_category(int free_space) {
+  return std::min(std::max(free_space, 0) / CATEGORY_SIZE, MAX_CATEGORY);
+}
+
+int FreeSpaceMap::needed_category(int size) { return std::clamp(size / CATEGORY_SIZE, 1, MAX_CATEGORY); }
+
+RC FreeSpaceMap::update(PageNum page_num, int free_space) {
+  return set_category(page_num, avail_category(free_space));
+}
+
+RC FreeSpaceMap::set_category(PageNum page_num, int category) {
+  if (page_num < 0) {
+    LOG_WARN("invalid page num. page num=%d", page_num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 等级为0的页面不需要创建 FSM 页面，新的 FSM 页面中的等级都是0
+  Frame *frame = nullptr;
+  RC rc = get_fsm_page(page_num / PAGES_PER_FSM_PAGE, category > 0 /*create*/, frame);
+  if (OB_FAIL(rc) || frame == nullptr) {
+    return rc;
+  }
+
+  frame->write_latch();
+  FsmPageHeader *header = reinterpret_cast<FsmPageHeader *>(frame->data());
+  uint8_t &value = reinterpret_cast<uint8_t *>(header + 1)[page_num % PAGES_PER_FSM_PAGE];
+  if (value != category) {
+    value = static_cast<uint8_t>(category);
+    header->max_category = std::max(header->max_category, category);
+    frame->mark_dirty();
+  }
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC FreeSpaceMap::search(int size, PageNum &page_num) {
+  page_num = BP_INVALID_PAGE_NUM;
+
+  const int fsm_pages = fsm_page_count();
+  if (fsm_pages == 0) {
+    return RC::SUCCESS;
+  }
+
+  const int category = needed_category(size);
+  int hint = search_hint_.load(std::memory_order_relaxed);
+  if (hint < 0 || hint >= fsm_pages * PAGES_PER_FSM_PAGE) {
+    hint = 0;
+  }
+
+  const int start_fsm_page = hint / PAGES_PER_FSM_PAGE;
+  for (int i = 0; i < fsm_pages; i++) {
+    const int fsm_page_index = (start_fsm_page + i) % fsm_pages;
+    const int start = (i == 0) ? hint % PAGES_PER_FSM_PAGE : 0;
+    int index = -1;
+    RC rc = search_fsm_page(fsm_page_index, start, category, index);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (index >= 0) {
+      page_num = fsm_page_index * PAGES_PER_FSM_PAGE + index;
+      search_hint_.store(page_num, std::memory_order_relaxed);
+      return RC::SUCCESS;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC FreeSpaceMap::search_fsm_page(int fsm_page_index, int start, int category, int &index) {
+  index = -1;
+
+  Frame *frame = nullptr;
+  RC rc = get_fsm_page(fsm_page_index, false /*create*/, frame);
+  if (OB_FAIL(rc) || frame == nullptr) {
+    return rc;
+  }
+
+  frame->read_latch();
+  const FsmPageHeader *header = reinterpret_cast<const FsmPageHeader *>(frame->data());
+  const uint8_t *categories = reinterpret_cast<const uint8_t *>(header + 1);
+  const bool may_found = header->max_category >= category;
+  if (may_found) {
+    // 从 start 开始找到页尾，再从头找到 start
+    for (int i = start; i < PAGES_PER_FSM_PAGE && index < 0; i++) {
+      if (categories[i] >= category) {
+        index = i;
+      }
+    }
+    for (int i = 0; i < start && index < 0; i++) {
+      if (categories[i] >= category) {
+        index = i;
+      }
+    }
+  }
+  frame->read_unlatch();
+
+  if (may_found && index < 0) {
+    // 页头记录的最大等级偏大，修正一下，下次可以直接跳过这个页面
+    frame->write_latch();
+    FsmPageHeader *mutable_header = reinterpret_cast<FsmPageHeader *>(frame->data());
+    const uint8_t *values = reinterpret_cast<const uint8_t *>(mutable_header + 1);
+    mutable_header->max_category = *std::max_element(values, values + PAGES_PER_FSM_PAGE);
+    frame->mark_dirty();
+    frame->write_unlatch();
+  }
+
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC FreeSpaceMap::get_fsm_page(int fsm_page_index, bool create, Frame *&frame) {
+  frame = nullptr;
+
+  const PageNum page_num = fsm_page_index + 1;
+  if (page_num >= buffer_pool_->page_num()) {
+    if (!create) {
+      return RC::SUCCESS;
+    }
+
+    // FSM 页面从不释放，所以新分配的页面编号总是连续的
+    lock_.lock();
+    while (page_num >= buffer_pool_->page_num()) {
+      Frame *new_frame = nullptr;
+      RC rc = buffer_pool_->allocate_page(&new_frame);
+      if (OB_FAIL(rc)) {
+        lock_.unlock();
+        LOG_WARN("failed to allocate fsm page. file=%s, rc=%s", buffer_pool_->file_name().c_str(), strrc(rc));
+        return rc;
+      }
+      new_frame->mark_dirty();
+      buffer_pool_->unpin_page(new_frame);
+    }
+    lock_.unlock();
+  }
+
+  RC rc = buffer_pool_->get_this_page(page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get fsm page. file=%s, page num=%d, rc=%s",
+             buffer_pool_->file_name().c_str(), page_num, strrc(rc));
+  }
+  return rc;
+}
@@ -0,0 +1,122 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+
+#include "storage/buffer/disk_buffer_pool.h"
+
+/**
+ * @brief FSM 页面的页头
+ * @ingroup RecordManager
+ */
+struct FsmPageHeader {
+  int32_t max_category; ///< 当前页面上最大的空闲等级。这只是一个上限，查找失败时会修正
+};
+
+/**
+ * @brief 记录文件的空闲空间表(Free Space Map)
+ * @ingroup RecordManager
+ * @details 空闲空间表存放在单独的文件中，每个数据页面对应一个字节，表示页面的空闲等级，
+ * 等级 c 表示页面至少有 c * CATEGORY_SIZE 字节的空闲空间。
+ * FSM 文件的第 i 个页面(i >= 1，第0个页面是 BufferPool 的文件头)记录数据页面
+ * [(i-1) * PAGES_PER_FSM_PAGE, i * PAGES_PER_FSM_PAGE) 的空闲等级。
+ *
+ * 插入记录时在 FSM 中查找足够空闲的页面，插入、删除记录后更新页面的空闲等级，
+ * 这样打开表时不需要遍历所有的数据页面。
+ * FSM 只是一个提示，不记录日志，与数据页面不一致时(比如异常重启后)，由调用者检查页面的实际空闲空间并修正。
+ *
+ * 并发控制使用 FSM 页面的页帧锁，查找时加读锁，更新时加写锁，持有 FSM 页面锁时不会再去加数据页面的锁。
+ */
+class FreeSpaceMap {
+public:
+  static constexpr int CATEGORY_SIZE = 32;
+  static constexpr int MAX_CATEGORY = 255;
+  static constexpr int PAGES_PER_FSM_PAGE = BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(FsmPageHeader));
+
+public:
+  FreeSpaceMap() = default;
+  ~FreeSpaceMap() = default;
+
+  /**
+   * @brief 初始化
+   * @details 只会读取文件头，与数据文件的大小无关
+   * @param buffer_pool FSM 文件
+   */
+  RC init(DiskBufferPool *buffer_pool);
+  void close();
+
+  /**
+   * @brief FSM 文件中还没有 FSM 页面，空闲空间表还没有建立
+   * @details 新建的表和重建之后都会调用 mark_built，之后就不再是空的，即使所有数据页面都写满了(空闲等级都是0)。
+   * 所以有数据页面但是 FSM 是空的，说明是旧版本创建的表，需要重建
+   */
+  bool empty() const;
+
+  /**
+   * @brief 标记空闲空间表已经建立
+   * @details 分配第一个 FSM 页面作为标记，并把 FSM 文件刷到磁盘上
+   */
+  RC mark_built();
+
+  /**
+   * @brief 按照页面当前的空闲空间更新空闲等级
+   */
+  RC update(PageNum page_num, int free_space);
+
+  /**
+   * @brief 直接设置页面的空闲等级
+   * @details 等级没有变化时不会修改页面
+   */
+  RC set_category(PageNum page_num, int category);
+
+  /**
+   * @brief 查找一个至少有 size 字节空闲空间的页面
+   * @details 从上次找到的页面开始查找，顺序插入时总是先把同一个页面填满
+   * @param page_num 找不到时返回 BP_INVALID_PAGE_NUM
+   */
+  RC search(int size, PageNum &page_num);
+
+  /**
+   * @brief 空闲空间对应的等级，向下取整
+   */
+  static int avail_category(int free_space);
+
+  /**
+   * @brief 存放 size 字节需要的最小等级
+   * @details 向下取整，所以找到的页面可能差一点放不下，调用者需要检查页面的实际空闲空间。
+   * 至少是1，等级为0的页面不会被选中
+   */
+  static int needed_category(int size);
+
+private:
+  /**
+   * @brief 获取 FSM 页面并 pin 住
+   * @param fsm_page_index FSM 页面的下标，不包含文件头页面
+   * @param create         页面不存在时是否创建
+   * @param frame          页面不存在并且不创建时返回 nullptr
+   */
+  RC get_fsm_page(int fsm_page_index, bool create, Frame *&frame);
+
+  /**
+   * @brief 在一个 FSM 页面中查找
+   * @param start 从这个下标开始查找
+   * @param index 返回找到的下标，找不到时是 -1
+   */
+  RC search_fsm_page(int fsm_page_index, int start, int category, int &index);
+
+  int fsm_page_count() const;
+
+private:
+  DiskBufferPool  *buffer_pool_ = nullptr;
+  std::atomic<int> search_hint_{0}; ///< 下次从哪个数据页面开始查找
+  common::Mutex    lock_;           ///< 扩展 FSM 文件时使用
+};
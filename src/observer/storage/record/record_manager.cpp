@@ -9,9 +9,12 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 
+#include <algorithm>
+
 #include "storage/record/record_manager.h"
 #include "common/lang/bitmap.h"
 #include "common/log/log.h"
+#include "storage/table/table_meta.h"
 #include "storage/trx/trx.h"
 
 using namespace common;
@@ -46,6 +49,27 @@ int page_record_capacity(int page_size, int record_size) {
  */
 int page_bitmap_size(int record_capacity) { return (record_capacity + 7) / 8; }
 
+/**
+ * @brief 变长字段前面存放实际长度的字节数
+ */
+static int varlen_prefix_size(const VarlenField &field) { return field.len <= UINT8_MAX ? 1 : 2; }
+
+/**
+ * @brief 变长记录页面上的碎片超过这个大小时，删除或更新记录后就整理页面
+ */
+static constexpr int SLOTTED_PAGE_COMPACT_THRESHOLD = BP_PAGE_DATA_SIZE / 4;
+
+/**
+ * @brief 把 PAX 页面上一列的值复制到 batch 中的每条记录里
+ * @details 大部分列都是4字节或8字节的，长度固定时 memcpy 可以展开成一条指令，不用每个值都调用一次函数
+ */
+template <int LEN>
+static void gather_pax_column(RecordBatch &batch, const char *minipage, int offset) {
+  for (int i = 0; i < batch.size(); i++) {
+    memcpy(batch.data(i) + offset, minipage + batch.rid(i).slot_num * LEN, LEN);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 RecordPageIterator::RecordPageIterator() {}
 RecordPageIterator::~RecordPageIterator() {}
@@ -53,6 +77,10 @@ RecordPageIterator::~RecordPageIterator() {}
 void RecordPageIterator::init(RecordPageHandler &record_page_handler, SlotNum start_slot_num /*=0*/) {
   record_page_handler_ = &record_page_handler;
   page_num_ = record_page_handler.get_page_num();
+  if (record_page_handler.is_slotted()) {
+    next_slot_num_ = record_page_handler.next_slotted_record(start_slot_num);
+    return;
+  }
   bitmap_.init(record_page_handler.bitmap_, record_page_handler.page_header_->record_capacity);
   next_slot_num_ = bitmap_.next_setted_bit(start_slot_num);
 }
@@ -61,27 +89,104 @@ bool RecordPageIterator::has_next() { return -1 != next_slot_num_; }
 
 RC RecordPageIterator::next(Record &record) {
   record.set_rid(page_num_, next_slot_num_);
-  record.set_data(record_page_handler_->get_record_data(record.rid().slot_num),
-                  record_page_handler_->page_header_->record_real_size);
-
-  if (next_slot_num_ >= 0) {
-    next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
+  const int record_size = record_page_handler_->page_header_->record_real_size;
+  if (record_page_handler_->is_pax()) {
+    if (next_slot_num_ >= 0) {
+      std::vector<char> &buffer = record_buffers_[buffer_index_];
+      buffer.resize(record_size);
+      record_page_handler_->read_pax_record(next_slot_num_, buffer.data());
+      record.set_data(buffer.data(), record_size);
+      next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
+    }
+  } else if (!record_page_handler_->is_slotted()) {
+    record.set_data(record_page_handler_->get_record_data(record.rid().slot_num), record_size);
+    if (next_slot_num_ >= 0) {
+      next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
+    }
+  } else if (next_slot_num_ >= 0) {
+    std::vector<char> &buffer = record_buffers_[buffer_index_];
+    buffer.resize(record_size);
+    record_page_handler_->decode_record(next_slot_num_, buffer.data());
+    record.set_data(buffer.data(), record_size);
+    next_slot_num_ = record_page_handler_->next_slotted_record(next_slot_num_ + 1);
   }
   return record.rid().slot_num != -1 ? RC::SUCCESS : RC::RECORD_EOF;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void RecordBatch::reset(PageNum page_num, int record_size) {
+  page_num_ = page_num;
+  record_size_ = record_size;
+  slot_nums_.clear();
+  datas_.clear();
+  visible_.clear();
+}
+
+void RecordBatch::set_projection(const std::vector<int> &columns) {
+  projection_.clear();
+  for (int column : columns) {
+    if (column >= static_cast<int>(projection_.size())) {
+      projection_.resize(column + 1, false);
+    }
+    projection_[column] = true;
+  }
+}
+
+void RecordBatch::add(SlotNum slot_num, char *data) {
+  const int index = size();
+  if (index % 64 == 0) {
+    visible_.push_back(0);
+  }
+  visible_.back() |= 1ULL << (index % 64);
+  slot_nums_.push_back(slot_num);
+  datas_.push_back(data);
+}
+
+void RecordBatch::get_record(int index, Record &record) const {
+  record.set_rid(page_num_, slot_nums_[index]);
+  record.set_data(datas_[index], record_size_);
+}
+
+int RecordBatch::next_visible(int start) const {
+  for (int word_index = start / 64; word_index < static_cast<int>(visible_.size()); word_index++) {
+    uint64_t word = visible_[word_index];
+    if (word_index == start / 64) {
+      word &= ~0ULL << (start % 64);
+    }
+    if (word != 0) {
+      return word_index * 64 + __builtin_ctzll(word);
+    }
+  }
+  return -1;
+}
+
+int RecordBatch::visible_count() const {
+  int count = 0;
+  for (uint64_t word : visible_) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+char *RecordBatch::decode_buffer(int count) {
+  buffer_.resize(static_cast<size_t>(count) * record_size_);
+  return buffer_.data();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 RecordPageHandler::~RecordPageHandler() { cleanup(); }
 
-RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly) {
+RC RecordPageHandler::init(
+    DiskBufferPool &buffer_pool, PageNum page_num, bool readonly, ScanRing *ring /* = nullptr */) {
   if (disk_buffer_pool_ != nullptr) {
     LOG_WARN("Disk buffer pool has been opened for page_num %d.", page_num);
     return RC::RECORD_OPENNED;
   }
 
   RC ret = RC::SUCCESS;
-  if ((ret = buffer_pool.get_this_page(page_num, &frame_)) != RC::SUCCESS) {
+  if ((ret = buffer_pool.get_this_page(page_num, &frame_, ring)) != RC::SUCCESS) {
     LOG_ERROR("Failed to get page handle from disk buffer pool. ret=%d:%s", ret, strrc(ret));
     return ret;
   }
@@ -96,7 +201,7 @@ RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool r
   disk_buffer_pool_ = &buffer_pool;
   readonly_ = readonly;
   page_header_ = (PageHeader *)(data);
-  bitmap_ = data + PAGE_HEADER_SIZE;
+  locate_bitmap();
 
   LOG_TRACE("Successfully init page_num %d.", page_num);
   return ret;
@@ -120,7 +225,7 @@ RC RecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num
   disk_buffer_pool_ = &buffer_pool;
   readonly_ = false;
   page_header_ = (PageHeader *)(data);
-  bitmap_ = data + PAGE_HEADER_SIZE;
+  locate_bitmap();
 
   buffer_pool.recover_page(page_num);
 
@@ -156,6 +261,95 @@ RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, PageNum page_
   return RC::SUCCESS;
 }
 
+RC RecordPageHandler::init_empty_slotted_page(
+    DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const std::vector<VarlenField> &varlen_fields) {
+  RC ret = init(buffer_pool, page_num, false /*readonly*/);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to init empty slotted page page_num:record_size %d:%d.", page_num, record_size);
+    return ret;
+  }
+
+  page_header_->record_num = 0;
+  page_header_->record_real_size = record_size;
+  page_header_->record_size = 0;
+  page_header_->record_capacity = 0;
+  page_header_->first_record_offset = static_cast<int32_t>(
+      PAGE_HEADER_SIZE + sizeof(SlottedPageHeader) + varlen_fields.size() * sizeof(VarlenField));
+
+  SlottedPageHeader *header = slotted_header();
+  header->data_offset = BP_PAGE_DATA_SIZE;
+  header->fragment_size = 0;
+  header->varlen_field_num = static_cast<int32_t>(varlen_fields.size());
+  memcpy(header + 1, varlen_fields.data(), varlen_fields.size() * sizeof(VarlenField));
+
+  int max_record_size = record_size;
+  for (const VarlenField &field : varlen_fields) {
+    max_record_size += varlen_prefix_size(field);
+  }
+  ASSERT(page_header_->first_record_offset + static_cast<int>(sizeof(RecordSlot)) + max_record_size <=
+             BP_PAGE_DATA_SIZE,
+         "Record overflow the page size");
+
+  if ((ret = buffer_pool.flush_page(*frame_)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    return ret;
+  }
+
+  return RC::SUCCESS;
+}
+
+RC RecordPageHandler::init_empty_pax_page(
+    DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const std::vector<PaxColumn> &columns) {
+  RC ret = init(buffer_pool, page_num, false /*readonly*/);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to init empty pax page page_num:record_size %d:%d.", page_num, record_size);
+    return ret;
+  }
+
+  const int column_num = static_cast<int>(columns.size());
+  const int bitmap_offset = static_cast<int>(PAGE_HEADER_SIZE + sizeof(PaxPageHeader) + column_num * sizeof(PaxColumn));
+
+  // 每个 minipage 都要对齐，先按照不对齐估算记录个数，放不下时再逐个减少
+  auto data_end = [&columns, bitmap_offset](int capacity) {
+    int offset = align8(bitmap_offset + page_bitmap_size(capacity));
+    for (const PaxColumn &column : columns) {
+      offset = align8(offset) + capacity * column.len;
+    }
+    return offset;
+  };
+  int capacity = (int)((BP_PAGE_DATA_SIZE - bitmap_offset - 1) / (record_size + 0.125));
+  while (capacity > 0 && data_end(capacity) > BP_PAGE_DATA_SIZE) {
+    capacity--;
+  }
+  ASSERT(capacity > 0, "Record overflow the page size");
+
+  page_header_->record_num = 0;
+  page_header_->record_real_size = record_size;
+  page_header_->record_size = -1;
+  page_header_->record_capacity = capacity;
+  page_header_->first_record_offset = align8(bitmap_offset + page_bitmap_size(capacity));
+
+  pax_header()->column_num = column_num;
+  PaxColumn *page_columns = pax_columns();
+  int offset = page_header_->first_record_offset;
+  for (int i = 0; i < column_num; i++) {
+    offset = align8(offset);
+    page_columns[i] = columns[i];
+    page_columns[i].minipage_offset = offset;
+    offset += capacity * columns[i].len;
+  }
+
+  locate_bitmap();
+  memset(bitmap_, 0, page_bitmap_size(capacity));
+
+  if ((ret = buffer_pool.flush_page(*frame_)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    return ret;
+  }
+
+  return RC::SUCCESS;
+}
+
 RC RecordPageHandler::cleanup() {
   if (disk_buffer_pool_ != nullptr) {
     if (readonly_) {
@@ -173,6 +367,29 @@ RC RecordPageHandler::cleanup() {
 RC RecordPageHandler::insert_record(const char *data, RID *rid) {
   ASSERT(readonly_ == false, "cannot insert record into page while the page is readonly");
 
+  if (is_slotted()) {
+    // 有空闲的槽位就复用，否则在目录的最后增加一个槽位
+    SlotNum slot_num = page_header_->record_capacity;
+    if (page_header_->record_num < page_header_->record_capacity) {
+      RecordSlot *slot_array = slots();
+      for (slot_num = 0; slot_array[slot_num].len != 0; slot_num++) {}
+    }
+
+    char buffer[BP_PAGE_DATA_SIZE];
+    RC rc = place_slotted_record(slot_num, buffer, encode_record(data, buffer));
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
+      return rc;
+    }
+
+    frame_->mark_dirty();
+    if (rid) {
+      rid->page_num = get_page_num();
+      rid->slot_num = slot_num;
+    }
+    return RC::SUCCESS;
+  }
+
   if (page_header_->record_num == page_header_->record_capacity) {
     LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
     return RC::RECORD_NOMEM;
@@ -185,8 +402,11 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid) {
   page_header_->record_num++;
 
   // assert index < page_header_->record_capacity
-  char *record_data = get_record_data(index);
-  memcpy(record_data, data, page_header_->record_real_size);
+  if (is_pax()) {
+    write_pax_record(index, data);
+  } else {
+    memcpy(get_record_data(index), data, page_header_->record_real_size);
+  }
 
   frame_->mark_dirty();
 
@@ -200,6 +420,17 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid) {
 }
 
 RC RecordPageHandler::recover_insert_record(const char *data, const RID &rid) {
+  if (is_slotted()) {
+    char buffer[BP_PAGE_DATA_SIZE];
+    RC rc = place_slotted_record(rid.slot_num, buffer, encode_record(data, buffer));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("no space to recover record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
   if (rid.slot_num >= page_header_->record_capacity) {
     LOG_WARN("slot_num illegal, slot_num(%d) > record_capacity(%d).", rid.slot_num, page_header_->record_capacity);
     return RC::RECORD_INVALID_RID;
@@ -213,8 +444,11 @@ RC RecordPageHandler::recover_insert_record(const char *data, const RID &rid) {
   }
 
   // 恢复数据
-  char *record_data = get_record_data(rid.slot_num);
-  memcpy(record_data, data, page_header_->record_real_size);
+  if (is_pax()) {
+    write_pax_record(rid.slot_num, data);
+  } else {
+    memcpy(get_record_data(rid.slot_num), data, page_header_->record_real_size);
+  }
 
   frame_->mark_dirty();
 
@@ -229,21 +463,95 @@ RC RecordPageHandler::delete_record(const RID *rid) {
     return RC::INVALID_ARGUMENT;
   }
 
+  if (is_slotted()) {
+    SlottedPageHeader *header = slotted_header();
+    RecordSlot &slot = slots()[rid->slot_num];
+    if (slot.len == 0) {
+      LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+
+    if (slot.offset == header->data_offset) {
+      header->data_offset += slot.len;
+    } else {
+      header->fragment_size += slot.len;
+    }
+    slot.offset = 0;
+    slot.len = 0;
+    page_header_->record_num--;
+
+    // 目录末尾的空闲槽位可以直接去掉
+    while (page_header_->record_capacity > 0 && slots()[page_header_->record_capacity - 1].len == 0) {
+      page_header_->record_capacity--;
+    }
+    if (page_header_->record_num == 0) {
+      header->data_offset = BP_PAGE_DATA_SIZE;
+      header->fragment_size = 0;
+    } else if (header->fragment_size > SLOTTED_PAGE_COMPACT_THRESHOLD) {
+      compact_page();
+    }
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
   Bitmap bitmap(bitmap_, page_header_->record_capacity);
   if (bitmap.get_bit(rid->slot_num)) {
     bitmap.clear_bit(rid->slot_num);
     page_header_->record_num--;
     frame_->mark_dirty();
+    return RC::SUCCESS;
+  } else {
+    LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
+    return RC::RECORD_NOT_EXIST;
+  }
+}
 
-    if (page_header_->record_num == 0) {
-      // PageNum page_num = get_page_num();
-      cleanup();
+RC RecordPageHandler::update_record(const RID *rid, const char *data) {
+  ASSERT(readonly_ == false, "cannot update record in page while the page is readonly");
+
+  if (rid->slot_num >= page_header_->record_capacity) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, page_num %d.", rid->slot_num, frame_->page_num());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (is_slotted()) {
+    if (slots()[rid->slot_num].len == 0) {
+      LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+
+    char buffer[BP_PAGE_DATA_SIZE];
+    RC rc = place_slotted_record(rid->slot_num, buffer, encode_record(data, buffer));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("no space to update record. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
     }
+    if (slotted_header()->fragment_size > SLOTTED_PAGE_COMPACT_THRESHOLD) {
+      compact_page();
+    }
+    frame_->mark_dirty();
     return RC::SUCCESS;
-  } else {
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (!bitmap.get_bit(rid->slot_num)) {
     LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
     return RC::RECORD_NOT_EXIST;
   }
+
+  if (is_pax()) {
+    write_pax_record(rid->slot_num, data);
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
+  // 通过 get_record 拿到的记录直接指向页面，这时不需要复制
+  char *record_data = get_record_data(rid->slot_num);
+  if (record_data != data) {
+    memcpy(record_data, data, page_header_->record_real_size);
+  }
+  frame_->mark_dirty();
+  return RC::SUCCESS;
 }
 
 RC RecordPageHandler::get_record(const RID *rid, Record *rec) {
@@ -252,6 +560,19 @@ RC RecordPageHandler::get_record(const RID *rid, Record *rec) {
     return RC::RECORD_INVALID_RID;
   }
 
+  if (is_slotted()) {
+    if (slots()[rid->slot_num].len == 0) {
+      LOG_ERROR("Invalid slot_num:%d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+
+    record_buffer_.resize(page_header_->record_real_size);
+    decode_record(rid->slot_num, record_buffer_.data());
+    rec->set_rid(*rid);
+    rec->set_data(record_buffer_.data(), page_header_->record_real_size);
+    return RC::SUCCESS;
+  }
+
   Bitmap bitmap(bitmap_, page_header_->record_capacity);
   if (!bitmap.get_bit(rid->slot_num)) {
     LOG_ERROR("Invalid slot_num:%d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
@@ -259,10 +580,68 @@ RC RecordPageHandler::get_record(const RID *rid, Record *rec) {
   }
 
   rec->set_rid(*rid);
-  rec->set_data(get_record_data(rid->slot_num), page_header_->record_real_size);
+  if (is_pax()) {
+    record_buffer_.resize(page_header_->record_real_size);
+    read_pax_record(rid->slot_num, record_buffer_.data());
+    rec->set_data(record_buffer_.data(), page_header_->record_real_size);
+  } else {
+    rec->set_data(get_record_data(rid->slot_num), page_header_->record_real_size);
+  }
   return RC::SUCCESS;
 }
 
+void RecordPageHandler::get_records(RecordBatch &batch) {
+  const int record_size = page_header_->record_real_size;
+  batch.reset(get_page_num(), record_size);
+
+  if (is_slotted()) {
+    char *buffer = batch.decode_buffer(page_header_->record_num);
+    int index = 0;
+    for (SlotNum slot_num = next_slotted_record(0); slot_num >= 0 && index < page_header_->record_num;
+         slot_num = next_slotted_record(slot_num + 1), index++) {
+      char *record = buffer + index * record_size;
+      decode_record(slot_num, record);
+      batch.add(slot_num, record);
+    }
+    return;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (!is_pax()) {
+    for (SlotNum slot_num = bitmap.next_setted_bit(0); slot_num >= 0; slot_num = bitmap.next_setted_bit(slot_num + 1)) {
+      batch.add(slot_num, get_record_data(slot_num));
+    }
+    return;
+  }
+
+  char *buffer = batch.decode_buffer(page_header_->record_num);
+  int index = 0;
+  for (SlotNum slot_num = bitmap.next_setted_bit(0); slot_num >= 0 && index < page_header_->record_num;
+       slot_num = bitmap.next_setted_bit(slot_num + 1), index++) {
+    batch.add(slot_num, buffer + index * record_size);
+  }
+
+  // 一列一列地解码，每次只访问一个 minipage，不需要的列直接跳过
+  const PaxColumn *columns = pax_columns();
+  for (int i = 0; i < pax_header()->column_num; i++) {
+    if (!batch.projected(i)) {
+      continue;
+    }
+
+    const PaxColumn &column = columns[i];
+    const char *minipage = frame_->data() + column.minipage_offset;
+    switch (column.len) {
+    case 4: gather_pax_column<4>(batch, minipage, column.offset); break;
+    case 8: gather_pax_column<8>(batch, minipage, column.offset); break;
+    default: {
+      for (int j = 0; j < batch.size(); j++) {
+        memcpy(batch.data(j) + column.offset, minipage + batch.rid(j).slot_num * column.len, column.len);
+      }
+    } break;
+    }
+  }
+}
+
 PageNum RecordPageHandler::get_page_num() const {
   if (nullptr == page_header_) {
     return (PageNum)(-1);
@@ -270,21 +649,275 @@ PageNum RecordPageHandler::get_page_num() const {
   return frame_->page_num();
 }
 
-bool RecordPageHandler::is_full() const { return page_header_->record_num >= page_header_->record_capacity; }
+bool RecordPageHandler::is_full() const {
+  if (!is_slotted()) {
+    return page_header_->record_num >= page_header_->record_capacity;
+  }
+
+  // 连最短的记录都放不下时，才认为页面满了
+  int min_record_size = page_header_->record_real_size;
+  const VarlenField *fields = varlen_fields();
+  for (int i = 0; i < slotted_header()->varlen_field_num; i++) {
+    min_record_size -= fields[i].len - varlen_prefix_size(fields[i]);
+  }
+  if (page_header_->record_num >= page_header_->record_capacity) {
+    min_record_size += sizeof(RecordSlot);
+  }
+  return contiguous_free_space() + slotted_header()->fragment_size < min_record_size;
+}
+
+int RecordPageHandler::free_space() const {
+  if (!is_slotted()) {
+    return (page_header_->record_capacity - page_header_->record_num) * page_header_->record_real_size;
+  }
+
+  int space = contiguous_free_space() + slotted_header()->fragment_size;
+  if (page_header_->record_num >= page_header_->record_capacity) {
+    space -= sizeof(RecordSlot);
+  }
+  return std::max(space, 0);
+}
+
+int RecordPageHandler::contiguous_free_space() const {
+  return slotted_header()->data_offset -
+         (page_header_->first_record_offset + page_header_->record_capacity * static_cast<int>(sizeof(RecordSlot)));
+}
+
+SlotNum RecordPageHandler::next_slotted_record(SlotNum start_slot_num) const {
+  const RecordSlot *slot_array = slots();
+  for (SlotNum slot_num = start_slot_num; slot_num < page_header_->record_capacity; slot_num++) {
+    if (slot_array[slot_num].len != 0) {
+      return slot_num;
+    }
+  }
+  return -1;
+}
+
+RC RecordPageHandler::place_slotted_record(SlotNum slot_num, const char *data, int len) {
+  SlottedPageHeader *header = slotted_header();
+  const int new_slot_num = std::max(slot_num + 1 - page_header_->record_capacity, 0);
+  RecordSlot *slot = (new_slot_num == 0) ? &slots()[slot_num] : nullptr;
+  const int old_len = (slot != nullptr) ? slot->len : 0;
+
+  // 新的记录不比原来的长，就地更新
+  if (len <= old_len) {
+    memcpy(frame_->data() + slot->offset, data, len);
+    header->fragment_size += old_len - len;
+    slot->len = len;
+    return RC::SUCCESS;
+  }
+
+  const int needed = len + new_slot_num * static_cast<int>(sizeof(RecordSlot));
+  if (needed > contiguous_free_space() + header->fragment_size + old_len) {
+    return RC::RECORD_NOMEM;
+  }
+
+  if (old_len > 0) {
+    // 原来的位置放不下，原来的数据变成碎片
+    header->fragment_size += old_len;
+    slot->len = 0;
+  } else {
+    page_header_->record_num++;
+  }
+
+  if (needed > contiguous_free_space()) {
+    compact_page();
+  }
+
+  if (new_slot_num > 0) {
+    memset(slots() + page_header_->record_capacity, 0, new_slot_num * sizeof(RecordSlot));
+    page_header_->record_capacity += new_slot_num;
+  }
+
+  header->data_offset -= len;
+  memcpy(frame_->data() + header->data_offset, data, len);
+  slots()[slot_num].offset = static_cast<uint16_t>(header->data_offset);
+  slots()[slot_num].len = static_cast<uint16_t>(len);
+  return RC::SUCCESS;
+}
+
+int RecordPageHandler::encode_record(const char *record, char *buf) const {
+  const VarlenField *fields = varlen_fields();
+  const int field_num = slotted_header()->varlen_field_num;
+  int src = 0;
+  int dst = 0;
+  for (int i = 0; i < field_num; i++) {
+    const VarlenField &field = fields[i];
+    memcpy(buf + dst, record + src, field.offset - src);
+    dst += field.offset - src;
+
+    // 去掉末尾的'\0'，读出来时再补上
+    const char *value = record + field.offset;
+    uint16_t value_len = field.len;
+    while (value_len > 0 && value[value_len - 1] == '\0') {
+      value_len--;
+    }
+
+    if (varlen_prefix_size(field) == 1) {
+      buf[dst] = static_cast<char>(value_len);
+      dst += 1;
+    } else {
+      memcpy(buf + dst, &value_len, sizeof(value_len));
+      dst += sizeof(value_len);
+    }
+    memcpy(buf + dst, value, value_len);
+    dst += value_len;
+    src = field.offset + field.len;
+  }
+  memcpy(buf + dst, record + src, page_header_->record_real_size - src);
+  return dst + page_header_->record_real_size - src;
+}
+
+void RecordPageHandler::decode_record(SlotNum slot_num, char *record) const {
+  const VarlenField *fields = varlen_fields();
+  const int field_num = slotted_header()->varlen_field_num;
+  const char *buf = frame_->data() + slots()[slot_num].offset;
+  int src = 0;
+  int dst = 0;
+  for (int i = 0; i < field_num; i++) {
+    const VarlenField &field = fields[i];
+    memcpy(record + dst, buf + src, field.offset - dst);
+    src += field.offset - dst;
+
+    uint16_t value_len = 0;
+    if (varlen_prefix_size(field) == 1) {
+      value_len = static_cast<uint8_t>(buf[src]);
+      src += 1;
+    } else {
+      memcpy(&value_len, buf + src, sizeof(value_len));
+      src += sizeof(value_len);
+    }
+    memcpy(record + field.offset, buf + src, value_len);
+    memset(record + field.offset + value_len, 0, field.len - value_len);
+    src += value_len;
+    dst = field.offset + field.len;
+  }
+  memcpy(record + dst, buf + src, page_header_->record_real_size - dst);
+}
+
+void RecordPageHandler::locate_bitmap() {
+  bitmap_ = frame_->data() + PAGE_HEADER_SIZE;
+  if (is_pax()) {
+    bitmap_ = (char *)(pax_columns() + pax_header()->column_num);
+  }
+}
+
+void RecordPageHandler::write_pax_record(SlotNum slot_num, const char *record) {
+  const PaxColumn *columns = pax_columns();
+  for (int i = 0; i < pax_header()->column_num; i++) {
+    const PaxColumn &column = columns[i];
+    memcpy(frame_->data() + column.minipage_offset + slot_num * column.len, record + column.offset, column.len);
+  }
+}
+
+void RecordPageHandler::read_pax_record(SlotNum slot_num, char *record) const {
+  const PaxColumn *columns = pax_columns();
+  for (int i = 0; i < pax_header()->column_num; i++) {
+    const PaxColumn &column = columns[i];
+    memcpy(record + column.offset, frame_->data() + column.minipage_offset + slot_num * column.len, column.len);
+  }
+}
+
+void RecordPageHandler::compact_page() {
+  SlottedPageHeader *header = slotted_header();
+  RecordSlot *slot_array = slots();
+
+  // 从页尾开始按照原来的顺序重新摆放记录，记录只会向页尾移动，不会覆盖还没有移动的记录
+  std::vector<SlotNum> slot_nums;
+  slot_nums.reserve(page_header_->record_num);
+  for (SlotNum slot_num = 0; slot_num < page_header_->record_capacity; slot_num++) {
+    if (slot_array[slot_num].len != 0) {
+      slot_nums.push_back(slot_num);
+    }
+  }
+  std::sort(slot_nums.begin(), slot_nums.end(), [slot_array](SlotNum a, SlotNum b) {
+    return slot_array[a].offset > slot_array[b].offset;
+  });
+
+  int offset = BP_PAGE_DATA_SIZE;
+  for (SlotNum slot_num : slot_nums) {
+    RecordSlot &slot = slot_array[slot_num];
+    offset -= slot.len;
+    if (offset != slot.offset) {
+      memmove(frame_->data() + offset, frame_->data() + slot.offset, slot.len);
+      slot.offset = static_cast<uint16_t>(offset);
+    }
+  }
+  header->data_offset = offset;
+  header->fragment_size = 0;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileHandler::~RecordFileHandler() { this->close(); }
 
-RC RecordFileHandler::init(DiskBufferPool *buffer_pool) {
+RC RecordFileHandler::init(DiskBufferPool *buffer_pool, DiskBufferPool *fsm_buffer_pool,
+    const TableMeta *table_meta /* = nullptr */, DiskBufferPool *zone_buffer_pool /* = nullptr */) {
   if (disk_buffer_pool_ != nullptr) {
     LOG_ERROR("record file handler has been openned.");
     return RC::RECORD_OPENNED;
   }
 
   disk_buffer_pool_ = buffer_pool;
+  storage_format_ = StorageFormat::FIXED_FORMAT;
+  varlen_fields_.clear();
+  pax_columns_.clear();
+  if (table_meta != nullptr && table_meta->storage_format() == StorageFormat::SLOTTED_FORMAT) {
+    storage_format_ = StorageFormat::SLOTTED_FORMAT;
+    for (const FieldMeta &field : *table_meta->field_metas()) {
+      if (field.type() == CHARS) {
+        varlen_fields_.push_back(VarlenField{static_cast<int16_t>(field.offset()), static_cast<int16_t>(field.len())});
+      }
+    }
+  } else if (table_meta != nullptr && table_meta->storage_format() == StorageFormat::PAX_FORMAT) {
+    storage_format_ = StorageFormat::PAX_FORMAT;
+    for (const FieldMeta &field : *table_meta->field_metas()) {
+      pax_columns_.push_back(PaxColumn{field.offset(), field.len(), 0 /*minipage_offset*/});
+    }
+  }
+
+  RC rc = free_space_map_.init(fsm_buffer_pool);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init free space map. rc=%s", strrc(rc));
+    disk_buffer_pool_ = nullptr;
+    return rc;
+  }
 
-  RC rc = init_free_pages();
+  // 第0个页面是 buffer pool 的文件头，有其它页面但是没有空闲空间表，说明是旧版本创建的文件，需要重建。
+  // 没有数据页面的新文件直接标记为已经建立
+  if (free_space_map_.empty()) {
+    rc = disk_buffer_pool_->page_num() > 1 ? rebuild_free_space_map() : free_space_map_.mark_built();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to build free space map. rc=%s", strrc(rc));
+      free_space_map_.close();
+      disk_buffer_pool_ = nullptr;
+      return rc;
+    }
+  }
+
+  if (zone_buffer_pool != nullptr && table_meta != nullptr) {
+    std::vector<ZoneMapColumn> columns;
+    ZoneMap::choose_columns(*table_meta, columns);
+    bool need_rebuild = false;
+    rc = zone_map_.init(zone_buffer_pool, columns, need_rebuild);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init zone map. rc=%s", strrc(rc));
+      free_space_map_.close();
+      disk_buffer_pool_ = nullptr;
+      return rc;
+    }
+
+    if (need_rebuild) {
+      rc = rebuild_zone_map();
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to rebuild zone map. rc=%s", strrc(rc));
+        zone_map_.close();
+        free_space_map_.close();
+        disk_buffer_pool_ = nullptr;
+        return rc;
+      }
+    }
+  }
 
   LOG_INFO("open record file handle done. rc=%s", strrc(rc));
   return RC::SUCCESS;
@@ -292,103 +925,243 @@ RC RecordFileHandler::init(DiskBufferPool *buffer_pool) {
 
 void RecordFileHandler::close() {
   if (disk_buffer_pool_ != nullptr) {
-    free_pages_.clear();
+    zone_map_.close();
+    free_space_map_.close();
+    visibility_map_.reset();
     disk_buffer_pool_ = nullptr;
   }
 }
 
-RC RecordFileHandler::init_free_pages() {
-  // 遍历当前文件上所有页面，找到没有满的页面
-  // 这个效率很低，会降低启动速度
+RC RecordFileHandler::rebuild_free_space_map() {
+  // 遍历当前文件上所有页面，记录每个页面的空闲空间
+  // 这个效率很低，只有第一次打开旧版本创建的文件时才会执行
   // NOTE: 由于是初始化时的动作，所以不需要加锁控制并发
 
   RC rc = RC::SUCCESS;
 
+  // 大文件使用环形缓冲区，避免打开表时把缓冲池中的其它页面都淘汰掉
+  std::unique_ptr<ScanRing> scan_ring = disk_buffer_pool_->create_scan_ring();
   BufferPoolIterator bp_iterator;
   bp_iterator.init(*disk_buffer_pool_);
+  bp_iterator.set_scan_ring(scan_ring.get());
   RecordPageHandler record_page_handler;
   PageNum current_page_num = 0;
+  int free_page_num = 0;
 
   while (bp_iterator.has_next()) {
     current_page_num = bp_iterator.next();
 
-    rc = record_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/);
+    rc = record_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/, scan_ring.get());
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, rc, strrc(rc));
       return rc;
     }
 
-    if (!record_page_handler.is_full()) {
-      free_pages_.insert(current_page_num);
-    }
+    const int free_space = record_page_handler.free_space();
     record_page_handler.cleanup();
+    if (free_space > 0) {
+      rc = free_space_map_.update(current_page_num, free_space);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to update free space map. page num=%d, rc=%s", current_page_num, strrc(rc));
+        return rc;
+      }
+      free_page_num++;
+    }
   }
-  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_pages_.size(), strrc(rc));
+
+  // 所有页面都写满时 FSM 中没有任何页面，也要留下标记，下次打开时不再重建
+  rc = free_space_map_.mark_built();
+  LOG_INFO("record file handler rebuild free space map done. free page num=%d, rc=%s", free_page_num, strrc(rc));
   return rc;
 }
 
-RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid) {
-  RC ret = RC::SUCCESS;
+RC RecordFileHandler::rebuild_zone_map() {
+  // 与 rebuild_free_space_map 相同，初始化时执行，不需要加锁控制并发
+  RC rc = zone_map_.clear_all();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
+  std::unique_ptr<ScanRing> scan_ring = disk_buffer_pool_->create_scan_ring();
+  BufferPoolIterator bp_iterator;
+  bp_iterator.init(*disk_buffer_pool_);
+  bp_iterator.set_scan_ring(scan_ring.get());
   RecordPageHandler record_page_handler;
-  bool page_found = false;
-  PageNum current_page_num = 0;
+  RecordBatch batch;
+  std::vector<const char *> datas;
+  int page_count = 0;
+
+  while (bp_iterator.has_next()) {
+    const PageNum current_page_num = bp_iterator.next();
+    rc = record_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/, scan_ring.get());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%s", current_page_num, strrc(rc));
+      return rc;
+    }
+
+    record_page_handler.get_records(batch);
+    datas.clear();
+    for (int i = 0; i < batch.size(); i++) {
+      datas.push_back(batch.data(i));
+    }
+    rc = zone_map_.update(current_page_num, datas.data(), static_cast<int>(datas.size()), true /*reset*/);
+    record_page_handler.cleanup();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to update zone map. page num=%d, rc=%s", current_page_num, strrc(rc));
+      return rc;
+    }
+    page_count++;
+  }
+  LOG_INFO("record file handler rebuild zone map done. page num=%d", page_count);
+  return RC::SUCCESS;
+}
 
-  // 当前要访问free_pages对象，所以需要加锁。在非并发编译模式下，不需要考虑这个锁
-  lock_.lock();
+int RecordFileHandler::record_space(const char *data, int record_size) const {
+  if (storage_format_ != StorageFormat::SLOTTED_FORMAT) {
+    return record_size;
+  }
 
-  // 找到没有填满的页面
-  while (!free_pages_.empty()) {
-    current_page_num = *free_pages_.begin();
+  // 与 RecordPageHandler::encode_record 的编码方式一致
+  int space = record_size;
+  for (const VarlenField &field : varlen_fields_) {
+    const char *value = data + field.offset;
+    int value_len = field.len;
+    while (value_len > 0 && value[value_len - 1] == '\0') {
+      value_len--;
+    }
+    space -= field.len - value_len - varlen_prefix_size(field);
+  }
+  return space;
+}
 
-    ret = record_page_handler.init(*disk_buffer_pool_, current_page_num, false /*readonly*/);
-    if (ret != RC::SUCCESS) {
-      lock_.unlock();
-      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
-      return ret;
+RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid) {
+  RecordPageHandler record_page_handler;
+  RC ret = get_insert_page(record_page_handler, record_size, record_space(data, record_size));
+  if (OB_FAIL(ret)) {
+    return ret;
+  }
+
+  ret = record_page_handler.insert_record(data, rid);
+  if (OB_SUCC(ret)) {
+    // 还拿着页面的写锁，其它线程不会同时修改这个页面的空闲等级和区域映射
+    free_space_map_.update(rid->page_num, record_page_handler.free_space());
+    zone_map_.update(rid->page_num, &data, 1, record_page_handler.record_num() == 1 /*reset*/);
+    visibility_map_.clear(rid->page_num);
+  }
+  return ret;
+}
+
+RC RecordFileHandler::insert_records(const std::vector<const char *> &datas, int record_size, std::vector<RID> &rids) {
+  RC rc = RC::SUCCESS;
+  rids.resize(datas.size());
+
+  size_t inserted = 0;
+  while (inserted < datas.size()) {
+    RecordPageHandler record_page_handler;
+    int space = record_space(datas[inserted], record_size);
+    rc = get_insert_page(record_page_handler, record_size, space);
+    if (OB_FAIL(rc)) {
+      break;
     }
 
-    if (!record_page_handler.is_full()) {
-      page_found = true;
+    // 当前页面放得下就继续放，不用每条记录都重新查找页面、加锁
+    const size_t page_start = inserted;
+    const bool page_empty = record_page_handler.record_num() == 0;
+    while (inserted < datas.size() && record_page_handler.free_space() >= space) {
+      rc = record_page_handler.insert_record(datas[inserted], &rids[inserted]);
+      if (OB_FAIL(rc)) {
+        break;
+      }
+      inserted++;
+      if (inserted < datas.size()) {
+        space = record_space(datas[inserted], record_size);
+      }
+    }
+
+    free_space_map_.update(record_page_handler.get_page_num(), record_page_handler.free_space());
+    zone_map_.update(record_page_handler.get_page_num(), datas.data() + page_start,
+        static_cast<int>(inserted - page_start), page_empty /*reset*/);
+    visibility_map_.clear(record_page_handler.get_page_num());
+    if (OB_FAIL(rc)) {
       break;
     }
-    record_page_handler.cleanup();
-    free_pages_.erase(free_pages_.begin());
   }
-  lock_.unlock(); // 如果找到了一个有效的页面，那么此时已经拿到了页面的写锁
 
-  // 找不到就分配一个新的页面
-  if (!page_found) {
-    Frame *frame = nullptr;
-    if ((ret = disk_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
-      LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
-      return ret;
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert records, rollback inserted ones. inserted=%d, total=%d, rc=%s",
+             static_cast<int>(inserted), static_cast<int>(datas.size()), strrc(rc));
+    for (size_t i = 0; i < inserted; i++) {
+      RC rc2 = delete_record(&rids[i]);
+      if (OB_FAIL(rc2)) {
+        LOG_ERROR("failed to rollback inserted record. rid=%s, rc=%s", rids[i].to_string().c_str(), strrc(rc2));
+      }
     }
+  }
+  return rc;
+}
 
-    current_page_num = frame->page_num();
+RC RecordFileHandler::get_insert_page(RecordPageHandler &record_page_handler, int record_size, int space) {
+  RC ret = RC::SUCCESS;
+  PageNum current_page_num = BP_INVALID_PAGE_NUM;
 
-    ret = record_page_handler.init_empty_page(*disk_buffer_pool_, current_page_num, record_size);
-    if (ret != RC::SUCCESS) {
-      frame->unpin();
-      LOG_ERROR("Failed to init empty page. ret:%d", ret);
-      // this is for allocate_page
+  // 在空闲空间表中查找。查找时只加 FSM 页面的锁，找到之后再加数据页面的写锁
+  while (true) {
+    ret = free_space_map_.search(space, current_page_num);
+    if (OB_FAIL(ret)) {
+      LOG_WARN("failed to search free space map. rc=%s", strrc(ret));
       return ret;
     }
+    if (current_page_num == BP_INVALID_PAGE_NUM) {
+      break;
+    }
 
-    // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
-    frame->unpin();
+    ret = record_page_handler.init(*disk_buffer_pool_, current_page_num, false /*readonly*/);
+    if (ret != RC::SUCCESS) {
+      // 空闲空间表没有记录日志，异常重启后可能与数据文件不一致
+      LOG_WARN("failed to init record page handler, ignore it in free space map. page num=%d, rc=%d:%s",
+               current_page_num, ret, strrc(ret));
+      free_space_map_.set_category(current_page_num, 0);
+      continue;
+    }
+
+    const int free_space = record_page_handler.free_space();
+    if (free_space >= space) {
+      return RC::SUCCESS;
+    }
 
-    // 这里的加锁顺序看起来与上面是相反的，但是不会出现死锁
-    // 上面的逻辑是先加lock锁，然后加页面写锁，这里是先加上
-    // 了页面写锁，然后加lock的锁，但是不会引起死锁。
-    // 为什么？
-    lock_.lock();
-    free_pages_.insert(current_page_num);
-    lock_.unlock();
+    // 空闲等级是向下取整的，页面可能差一点放不下，或者已经被其它线程填满了。
+    // 把等级降到查找时需要的等级以下，页面上的空间变化时会再更新
+    record_page_handler.cleanup();
+    free_space_map_.set_category(current_page_num,
+        std::min(FreeSpaceMap::avail_category(free_space), FreeSpaceMap::needed_category(space) - 1));
   }
 
-  // 找到空闲位置
-  return record_page_handler.insert_record(data, rid);
+  // 找不到就分配一个新的页面
+  Frame *frame = nullptr;
+  if ((ret = disk_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
+    return ret;
+  }
+
+  current_page_num = frame->page_num();
+
+  if (storage_format_ == StorageFormat::SLOTTED_FORMAT) {
+    ret = record_page_handler.init_empty_slotted_page(*disk_buffer_pool_, current_page_num, record_size, varlen_fields_);
+  } else if (storage_format_ == StorageFormat::PAX_FORMAT) {
+    ret = record_page_handler.init_empty_pax_page(*disk_buffer_pool_, current_page_num, record_size, pax_columns_);
+  } else {
+    ret = record_page_handler.init_empty_page(*disk_buffer_pool_, current_page_num, record_size);
+  }
+  if (ret != RC::SUCCESS) {
+    frame->unpin();
+    LOG_ERROR("Failed to init empty page. ret:%d", ret);
+    // this is for allocate_page
+    return ret;
+  }
+
+  // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
+  frame->unpin();
+  return RC::SUCCESS;
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid) {
@@ -402,7 +1175,13 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
     return ret;
   }
 
-  return record_page_handler.recover_insert_record(data, rid);
+  ret = record_page_handler.recover_insert_record(data, rid);
+  if (OB_SUCC(ret)) {
+    free_space_map_.update(rid.page_num, record_page_handler.free_space());
+    zone_map_.update(rid.page_num, &data, 1, record_page_handler.record_num() == 1 /*reset*/);
+    visibility_map_.clear(rid.page_num);
+  }
+  return ret;
 }
 
 RC RecordFileHandler::delete_record(const RID *rid) {
@@ -415,17 +1194,16 @@ RC RecordFileHandler::delete_record(const RID *rid) {
   }
 
   rc = page_handler.delete_record(rid);
-  // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
-  // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放record manager锁
-  // insert record是加上 record manager锁，然后拿到指定页面锁再释放record manager锁
-  page_handler.cleanup();
   if (OB_SUCC(rc)) {
-    // 因为这里已经释放了页面锁，并发时，其它线程可能又把该页面填满了，那就不应该再放入 free_pages_
-    // 中。但是这里可以不关心，因为在查找空闲页面时，会自动过滤掉已经满的页面
-    lock_.lock();
-    free_pages_.insert(rid->page_num);
-    LOG_TRACE("add free page %d to free page list", rid->page_num);
-    lock_.unlock();
+    // 加锁顺序总是先加数据页面的锁，再加 FSM 页面的锁。insert_record 查找 FSM 时不会拿着数据页面的锁，
+    // 所以这里拿着页面锁更新 FSM 不会死锁
+    free_space_map_.update(rid->page_num, page_handler.free_space());
+    LOG_TRACE("update free space of page %d", rid->page_num);
+    // 删除时不缩小范围，页面空了之后再插入时重新统计
+    if (page_handler.record_num() == 0) {
+      zone_map_.clear(rid->page_num);
+    }
+    visibility_map_.clear(rid->page_num);
   }
   return rc;
 }
@@ -462,27 +1240,58 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
   }
 
   visitor(record);
+  if (!readonly) {
+    // 变长记录返回的是解码后的数据，需要写回页面
+    rc = page_handler.update_record(&rid, record.data());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to update record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    } else {
+      if (page_handler.is_slotted()) {
+        free_space_map_.update(rid.page_num, page_handler.free_space());
+      }
+      const char *data = record.data();
+      zone_map_.update(rid.page_num, &data, 1, false /*reset*/);
+      // 提交、回滚和删除都通过这里修改事务字段，页面上的记录不再对所有事务都可见
+      visibility_map_.clear(rid.page_num);
+    }
+  }
   return rc;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool MorselDispenser::next(DiskBufferPool &buffer_pool, PageNum &begin, PageNum &end) {
+  begin = next_page_.fetch_add(morsel_pages_, std::memory_order_relaxed);
+  end = begin + morsel_pages_;
+  return begin < buffer_pool.page_num();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
-RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly) {
+RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly,
+    MorselDispenser *morsels /* = nullptr */, const ZoneFilter *zone_filter /* = nullptr */) {
   close_scan();
 
   table_ = table;
   disk_buffer_pool_ = &buffer_pool;
   trx_ = trx;
   readonly_ = readonly;
+  morsels_ = morsels;
+  zone_filter_ = (zone_filter != nullptr && !zone_filter->empty()) ? zone_filter : nullptr;
+  skipped_pages_ = 0;
 
-  RC rc = bp_iterator_.init(buffer_pool);
+  // 并行扫描时先不遍历任何页面，从领取的第一段页面开始
+  RC rc = bp_iterator_.init(buffer_pool, 0 /*start_page*/, morsels_ != nullptr ? 1 : BP_INVALID_PAGE_NUM);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
+  scan_ring_ = buffer_pool.create_scan_ring();
+  bp_iterator_.set_scan_ring(scan_ring_.get());
+
   rc = fetch_next_record();
   if (rc == RC::RECORD_EOF) {
     rc = RC::SUCCESS;
@@ -515,10 +1324,10 @@ RC RecordFileScanner::fetch_next_record() {
   }
 
   // 上个页面遍历完了，或者还没有开始遍历某个页面，那么就从一个新的页面开始遍历查找
-  while (bp_iterator_.has_next()) {
-    PageNum page_num = bp_iterator_.next();
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  while (next_page(page_num)) {
     record_page_handler_.cleanup();
-    rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_);
+    rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_, scan_ring_.get());
     if (OB_FAIL(rc)) {
       LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
       return rc;
@@ -576,12 +1385,87 @@ RC RecordFileScanner::fetch_next_record_in_page() {
   return RC::RECORD_EOF;
 }
 
+RC RecordFileScanner::next_batch(RecordBatch &batch) {
+  RC rc = RC::SUCCESS;
+  if (!batch_started_) {
+    batch_started_ = true;
+    // open_scan 时已经预取了第一条记录，它所在的页面就是第一个有可见记录的页面，之前的页面都可以跳过
+    if (!has_next()) {
+      return RC::RECORD_EOF;
+    }
+
+    rc = fetch_batch_in_page(batch);
+    if (OB_FAIL(rc) || batch.visible_count() > 0) {
+      return rc;
+    }
+  }
+
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  while (next_page(page_num)) {
+    record_page_handler_.cleanup();
+    rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_, scan_ring_.get());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    rc = fetch_batch_in_page(batch);
+    if (OB_FAIL(rc) || batch.visible_count() > 0) {
+      return rc;
+    }
+  }
+
+  next_record_.rid().slot_num = -1;
+  record_page_handler_.cleanup();
+  batch.reset(BP_INVALID_PAGE_NUM, 0);
+  return RC::RECORD_EOF;
+}
+
+RC RecordFileScanner::fetch_batch_in_page(RecordBatch &batch) {
+  record_page_handler_.get_records(batch);
+  if (trx_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  // 整个页面的记录一起交给事务检查可见性
+  RC rc = trx_->visit_records(table_, batch, readonly_);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to visit records in page. page_num=%d, rc=%s", batch.page_num(), strrc(rc));
+  }
+  return rc;
+}
+
+bool RecordFileScanner::next_page(PageNum &page_num) {
+  while (true) {
+    while (!bp_iterator_.has_next()) {
+      PageNum begin = BP_INVALID_PAGE_NUM;
+      PageNum end = BP_INVALID_PAGE_NUM;
+      if (morsels_ == nullptr || !morsels_->next(*disk_buffer_pool_, begin, end)) {
+        return false;
+      }
+      bp_iterator_.init(*disk_buffer_pool_, begin - 1, end);
+    }
+
+    page_num = bp_iterator_.next();
+    if (zone_filter_ == nullptr || zone_filter_->may_match(page_num)) {
+      return true;
+    }
+    skipped_pages_++;
+  }
+}
+
 RC RecordFileScanner::close_scan() {
   if (disk_buffer_pool_ != nullptr) {
     disk_buffer_pool_ = nullptr;
   }
+  morsels_ = nullptr;
+  batch_started_ = false;
 
+  record_page_iterator_.reset();
+  next_record_.rid().slot_num = -1;
   record_page_handler_.cleanup();
+  bp_iterator_.set_scan_ring(nullptr);
+  scan_ring_.reset();
 
   return RC::SUCCESS;
 }
@@ -590,6 +1474,8 @@ bool RecordFileScanner::has_next() { return next_record_.rid().slot_num != -1; }
 
 RC RecordFileScanner::next(Record &record, bool *locked_) {
   record = next_record_;
+  // 变长记录指向的是迭代器的解码缓冲区，预取下一条记录时不能覆盖这一条
+  record_page_iterator_.hold_record();
   if (locked_) {
     *locked_ = concurrency_locked_;
   }
@@ -13,9 +13,14 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/lang/bitmap.h"
+#include "common/types.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/record/free_space_map.h"
 #include "storage/record/record.h"
+#include "storage/record/visibility_map.h"
+#include "storage/record/zone_map.h"
 #include "storage/trx/latch_memo.h"
+#include <atomic>
 #include <limits>
 #include <sstream>
 
@@ -23,6 +28,7 @@ class ConditionFilter;
 class RecordPageHandler;
 class Trx;
 class Table;
+class TableMeta;
 
 /**
  * @brief 这里负责管理在一个文件上表记录(行)的组织/管理
@@ -43,29 +49,94 @@ class Table;
  * 问题2：如何更有效地存放不定长数据呢？
  * 问题3：如果一个页面不能存放一个记录，那么怎么组织记录存放效果更好呢？
  *
+ * 问题1和问题2的一种答案是变长记录格式(StorageFormat::SLOTTED_FORMAT)，创建表时可以指定。
+ * 页面上有一个槽位目录(slot directory)，slot num 是目录的下标，目录项记录了记录在页面中的位置和长度，
+ * 记录本身从页尾向前存放。记录在内存中仍然是定长的，写入页面时 CHARS 字段去掉末尾的'\0'，读出时再补齐。
+ * 每个页面的页头都记录了页面的格式，同一个文件中只会有一种格式的页面。
+ *
+ * 分析型的查询通常只访问少数几列，可以使用按列存放的 PAX 格式(StorageFormat::PAX_FORMAT)。
+ * 页面上每一列占用一段连续的空间(minipage)，第 i 条记录的这一列在 minipage 中的第 i 个位置，
+ * 仍然使用位图记录槽位的分配状态。批量扫描时可以只读取需要的列，其它列的 minipage 不会访问。
+ *
  * 按照上面的描述，这里提供了几个类，分别是：
  * - RecordFileHandler：管理整个文件/表的记录增删改查
  * - RecordPageHandler：管理单个页面上记录的增删改查
  * - RecordFileScanner：可以用来遍历整个文件上的所有记录
  * - RecordPageIterator：可以用来遍历指定页面上的所有记录
+ * - RecordBatch：一个页面上的一批记录，批量扫描时使用
+ * - MorselDispenser：并行扫描时把文件的页面分成若干段，分给多个扫描线程
  * - PageHeader：每个页面上都会记录的页面头信息
+ * - FreeSpaceMap：记录每个页面的空闲空间，存放在单独的文件中，插入时用来查找有空闲空间的页面
+ * - ZoneMap：记录每个页面上若干列的最小值和最大值，存放在单独的文件中，扫描时用来跳过不满足条件的页面
+ * - TextFileHandler：TEXT 字段的内容存放在单独的文件中，记录中只保存编号，超过一个页面的值分块存放
  */
 
 /**
  * @brief 数据文件，按照页面来组织，每一页都存放一些记录/数据行
  * @ingroup RecordManager
  * @details 每一页都有一个这样的页头，虽然看起来浪费，但是现在就简单的这么做
- * 从这个页头描述的信息来看，当前仅支持定长行/记录。如果要支持变长记录，
- * 或者超长（超出一页）的记录，这么做是不合适的。
+ * 变长记录页面也使用这个页头，record_size 为0，record_capacity 是槽位目录的大小，
+ * first_record_offset 是槽位目录的偏移量，页头后面还有一个 SlottedPageHeader。
+ * PAX 页面上 record_size 是-1，first_record_offset 是第一个 minipage 的偏移量，页头后面还有一个 PaxPageHeader。
+ * 超长（超出一页）的记录，目前所有格式都不支持。
  */
 struct PageHeader {
   int32_t record_num;          ///< 当前页面记录的个数
   int32_t record_real_size;    ///< 每条记录的实际大小
-  int32_t record_size;         ///< 每条记录占用实际空间大小(可能对齐)
+  int32_t record_size;         ///< 每条记录占用实际空间大小(可能对齐)，变长记录页面上是0，PAX 页面上是-1
   int32_t record_capacity;     ///< 最大记录个数
   int32_t first_record_offset; ///< 第一条记录的偏移量
 };
 
+/**
+ * @brief 变长记录页面上 PageHeader 后面的页头信息
+ * @ingroup RecordManager
+ */
+struct SlottedPageHeader {
+  int32_t data_offset;      ///< 记录数据区的起始偏移，记录从页尾向前存放
+  int32_t fragment_size;    ///< 删除或更新记录后，数据区中留下的碎片大小
+  int32_t varlen_field_num; ///< 变长字段的个数，字段描述(VarlenField)紧跟在这个结构后面
+};
+
+/**
+ * @brief 变长记录中的一个变长字段
+ * @ingroup RecordManager
+ * @details 当前只有 CHARS 字段是变长存放的。写入页面时在字段前面放上实际长度，字段最长255时使用1个字节，
+ * 否则使用2个字节。
+ */
+struct VarlenField {
+  int16_t offset; ///< 字段在记录中的偏移
+  int16_t len;    ///< 字段的最大长度
+};
+
+/**
+ * @brief 变长记录页面槽位目录中的一项
+ * @ingroup RecordManager
+ */
+struct RecordSlot {
+  uint16_t offset; ///< 记录在页面中的偏移
+  uint16_t len;    ///< 记录写入页面后的长度，0表示空闲的槽位
+};
+
+/**
+ * @brief PAX 页面上 PageHeader 后面的页头信息
+ * @ingroup RecordManager
+ */
+struct PaxPageHeader {
+  int32_t column_num; ///< 列的个数，每一列的描述(PaxColumn)紧跟在这个结构后面
+};
+
+/**
+ * @brief PAX 页面上的一列
+ * @ingroup RecordManager
+ * @details 每个字段是一列，列的顺序与表元数据中字段的顺序相同，包括事务字段和 null 标记字段
+ */
+struct PaxColumn {
+  int32_t offset;          ///< 列在记录中的偏移
+  int32_t len;             ///< 列的长度
+  int32_t minipage_offset; ///< 这一列的 minipage 在页面中的偏移
+};
+
 /**
  * @brief 遍历一个页面中每条记录的iterator
  * @ingroup RecordManager
@@ -100,11 +171,103 @@ public:
    */
   bool is_valid() const { return record_page_handler_ != nullptr; }
 
+  /**
+   * @brief 不再遍历任何页面。扫描中途关闭时需要调用，否则重新打开后会接着遍历已经释放的页面
+   */
+  void reset() { record_page_handler_ = nullptr; }
+
+  /**
+   * @brief 上一条记录要交给调用者继续使用，之后的变长记录解码到另一个缓冲区中，不会覆盖它
+   */
+  void hold_record() { buffer_index_ ^= 1; }
+
 private:
   RecordPageHandler *record_page_handler_ = nullptr;
   PageNum page_num_ = BP_INVALID_PAGE_NUM;
   common::Bitmap bitmap_;     ///< bitmap 的相关信息可以参考 RecordPageHandler 的说明
   SlotNum next_slot_num_ = 0; ///< 当前遍历到了哪一个slot
+
+  /// 变长记录解码后放在这里。调用 hold_record 后切换到另一个缓冲区
+  std::vector<char> record_buffers_[2];
+  int buffer_index_ = 0;
+};
+
+/**
+ * @brief 一个页面上的一批记录
+ * @ingroup RecordManager
+ * @details 定长记录直接指向页帧中的数据，不做拷贝；变长记录和 PAX 记录整页解码到这里的缓冲区中。
+ * PAX 页面可以只解码需要的列，参考 set_projection。
+ * 另外还有一个可见性位图，由事务一次性地对整批记录做检查，不可见的记录清除对应的位。
+ * 批量扫描时，页面一直 pin 在内存中，直到获取下一批记录或者关闭扫描，这期间记录数据都是有效的。
+ */
+class RecordBatch {
+public:
+  RecordBatch() = default;
+  ~RecordBatch() = default;
+
+  /**
+   * @brief 清空，准备存放另一个页面上的记录
+   */
+  void reset(PageNum page_num, int record_size);
+
+  /**
+   * @brief 设置需要读取的列，使用字段在表元数据中的下标(FieldMeta::index)
+   * @details 只对 PAX 页面有效，其它列的 minipage 不会读取，记录中这些列的内容是不确定的。
+   * 使用事务检查可见性时，需要包含事务字段。为空时读取所有的列。reset 不会清除这个设置
+   */
+  void set_projection(const std::vector<int> &columns);
+
+  /**
+   * @brief 是否需要读取指定的列
+   */
+  bool projected(int column) const {
+    return projection_.empty() || (column < static_cast<int>(projection_.size()) && projection_[column]);
+  }
+
+  /**
+   * @brief 添加一条记录，默认是可见的
+   */
+  void add(SlotNum slot_num, char *data);
+
+  int size() const { return static_cast<int>(slot_nums_.size()); }
+  int record_size() const { return record_size_; }
+  PageNum page_num() const { return page_num_; }
+
+  char *data(int index) const { return datas_[index]; }
+  RID rid(int index) const { return RID(page_num_, slot_nums_[index]); }
+
+  /**
+   * @brief 获取一条记录，记录数据不会复制
+   */
+  void get_record(int index, Record &record) const;
+
+  bool visible(int index) const { return (visible_[index / 64] >> (index % 64)) & 1; }
+  void set_invisible(int index) { visible_[index / 64] &= ~(1ULL << (index % 64)); }
+
+  /**
+   * @brief 从 start 开始(包含)找到下一条可见的记录，找不到返回-1
+   */
+  int next_visible(int start) const;
+
+  /**
+   * @brief 可见的记录条数
+   */
+  int visible_count() const;
+
+  /**
+   * @brief 变长记录解码用的缓冲区，可以存放 count 条记录
+   * @details 调整大小会使已经添加的记录失效，所以要在添加记录之前调用
+   */
+  char *decode_buffer(int count);
+
+private:
+  PageNum page_num_ = BP_INVALID_PAGE_NUM;
+  int record_size_ = 0;
+  std::vector<SlotNum> slot_nums_;
+  std::vector<char *> datas_;
+  std::vector<uint64_t> visible_; ///< 可见性位图，第 i 位对应第 i 条记录
+  std::vector<char> buffer_;      ///< 变长记录和 PAX 记录解码后放在这里
+  std::vector<bool> projection_;  ///< 需要读取的列，为空表示所有列
 };
 
 /**
@@ -116,6 +279,20 @@ private:
  * |------------|------------------------|
  * | record1 | record2 | ..... | recordN |
  * @endcode
+ * 变长记录模式下是这样的：
+ * @code
+ * | PageHeader | SlottedPageHeader | VarlenField... | slot1 | slot2 | ... | slotN |
+ * |--------------------------------------------------------------------------|
+ * | free space ...             | recordN | fragment | ... | record2 | record1 |
+ * @endcode
+ * 删除、更新记录会在数据区中留下碎片，空间不够或者碎片太多时，会整理页面把记录重新紧凑地放到页尾。
+ * PAX 格式下是这样的，每个 minipage 都按8字节对齐，可以存放 record_capacity 个值：
+ * @code
+ * | PageHeader | PaxPageHeader | PaxColumn... | record allocate bitmap |
+ * |---------------------------------------------------------------------|
+ * | minipage1: column1 of record1...N | minipage2: column2 of record1...N | ... |
+ * @endcode
+ * 变长记录和 PAX 记录读出来时需要解码，返回的记录数据放在 RecordPageHandler 的缓冲区中，不是页面上的内存。
  */
 class RecordPageHandler {
 public:
@@ -128,8 +305,9 @@ public:
    * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
    * @param page_num    当前处理哪个页面
    * @param readonly    是否只读。在访问页面时，需要对页面加锁
+   * @param ring        页面不在内存中时使用的环形缓冲区，参考 DiskBufferPool::get_this_page
    */
-  RC init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly);
+  RC init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly, ScanRing *ring = nullptr);
 
   /**
    * @brief 数据库恢复时，与普通的运行场景有所不同，不做任何并发操作，也不需要加锁
@@ -148,6 +326,28 @@ public:
    */
   RC init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num, int record_size);
 
+  /**
+   * @brief 把一个新的页面初始化成变长记录页面
+   *
+   * @param buffer_pool   关联某个文件时，都通过buffer pool来做读写文件
+   * @param page_num      当前处理哪个页面
+   * @param record_size   记录解码后的大小
+   * @param varlen_fields 记录中变长存放的字段，按照偏移排好序
+   */
+  RC init_empty_slotted_page(
+      DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const std::vector<VarlenField> &varlen_fields);
+
+  /**
+   * @brief 把一个新的页面初始化成 PAX 页面
+   *
+   * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
+   * @param page_num    当前处理哪个页面
+   * @param record_size 记录的大小
+   * @param columns     每一列在记录中的位置，按照偏移排好序，不关心 minipage_offset
+   */
+  RC init_empty_pax_page(
+      DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const std::vector<PaxColumn> &columns);
+
   /**
    * @brief 操作结束后做的清理工作，比如释放页面、解锁
    */
@@ -176,24 +376,62 @@ public:
    */
   RC delete_record(const RID *rid);
 
+  /**
+   * @brief 使用新的数据覆盖指定的记录
+   * @details 变长记录的长度可能会变化，页面剩余空间不够时返回 RECORD_NOMEM
+   * @param rid  要更新的记录标识
+   * @param data 新的记录数据
+   */
+  RC update_record(const RID *rid, const char *data);
+
   /**
    * @brief 获取指定位置的记录数据
    *
    * @param rid 指定的位置
-   * @param rec 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护
+   * @param rec 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护。
+   *            变长记录返回的是当前对象中的解码缓冲区，下次调用 get_record 前有效
    */
   RC get_record(const RID *rid, Record *rec);
 
+  /**
+   * @brief 获取页面上的所有记录
+   * @details 定长记录按64位一次扫描页面的位图，记录数据直接指向页帧，不做拷贝；
+   * 变长记录和 PAX 记录整页解码到 batch 的缓冲区中，PAX 记录只解码 batch 需要的列
+   */
+  void get_records(RecordBatch &batch);
+
   /**
    * @brief 返回该记录页的页号
    */
   PageNum get_page_num() const;
 
+  /**
+   * @brief 当前页面上记录的个数
+   */
+  int record_num() const { return page_header_->record_num; }
+
   /**
    * @brief 当前页面是否已经没有空闲位置插入新的记录
    */
   bool is_full() const;
 
+  /**
+   * @brief 当前页面还能存放多少字节的记录
+   * @details 定长记录页面是空闲槽位个数乘以记录大小。变长记录页面包含碎片空间，
+   * 没有空闲的槽位时要减去新增一个槽位需要的空间
+   */
+  int free_space() const;
+
+  /**
+   * @brief 当前页面是否是变长记录页面
+   */
+  bool is_slotted() const { return page_header_->record_size == 0; }
+
+  /**
+   * @brief 当前页面是否是 PAX 页面
+   */
+  bool is_pax() const { return page_header_->record_size < 0; }
+
 protected:
   /**
    * @details 
@@ -219,12 +457,58 @@ protected:
     return frame_->data() + page_header_->first_record_offset + (page_header_->record_size * slot_num);
   }
 
+  SlottedPageHeader *slotted_header() const { return (SlottedPageHeader *)(frame_->data() + sizeof(PageHeader)); }
+  const VarlenField *varlen_fields() const { return (const VarlenField *)(slotted_header() + 1); }
+  RecordSlot *slots() const { return (RecordSlot *)(frame_->data() + page_header_->first_record_offset); }
+
+  PaxPageHeader *pax_header() const { return (PaxPageHeader *)(frame_->data() + sizeof(PageHeader)); }
+  PaxColumn *pax_columns() const { return (PaxColumn *)(pax_header() + 1); }
+
+  /**
+   * @brief 根据页头找到位图的位置，PAX 页面的位图在列描述的后面
+   */
+  void locate_bitmap();
+
+  /**
+   * @brief 变长记录页面上槽位目录与数据区之间连续的空闲空间
+   */
+  int contiguous_free_space() const;
+
+  /**
+   * @brief 从指定槽位开始，找到下一个存放了记录的槽位，找不到返回-1
+   */
+  SlotNum next_slotted_record(SlotNum start_slot_num) const;
+
+  /**
+   * @brief 把编码好的变长记录放到指定的槽位上
+   * @details 槽位上原来有记录时会替换掉；槽位超出目录大小时会扩展目录。空间不够时返回 RECORD_NOMEM
+   */
+  RC place_slotted_record(SlotNum slot_num, const char *data, int len);
+
+  /**
+   * @brief 编码/解码变长记录
+   */
+  int encode_record(const char *record, char *buf) const;
+  void decode_record(SlotNum slot_num, char *record) const;
+
+  /**
+   * @brief 把记录的每一列分别写到各自的 minipage 中，或者从各个 minipage 中读出一条完整的记录
+   */
+  void write_pax_record(SlotNum slot_num, const char *record);
+  void read_pax_record(SlotNum slot_num, char *record) const;
+
+  /**
+   * @brief 整理变长记录页面，去掉数据区中的碎片
+   */
+  void compact_page();
+
 protected:
   DiskBufferPool *disk_buffer_pool_ = nullptr; ///< 当前操作的buffer pool(文件)
   Frame *frame_ = nullptr; ///< 当前操作页面关联的frame(frame的更多概念可以参考buffer pool和frame)
   bool readonly_ = false;  ///< 当前的操作是否都是只读的
   PageHeader *page_header_ = nullptr; ///< 当前页面上页面头
   char *bitmap_ = nullptr;            ///< 当前页面上record分配状态信息bitmap内存起始位置
+  std::vector<char> record_buffer_;   ///< 变长记录和 PAX 记录解码后放在这里
 
 private:
   friend class RecordPageIterator;
@@ -243,9 +527,13 @@ public:
   /**
    * @brief 初始化
    *
-   * @param buffer_pool 当前操作的是哪个文件
+   * @param buffer_pool     当前操作的是哪个文件
+   * @param fsm_buffer_pool 存放空闲空间表(FreeSpaceMap)的文件
+   * @param table_meta      表的元数据，决定新页面使用哪种记录格式。为空时使用定长记录
+   * @param zone_buffer_pool 存放区域映射(ZoneMap)的文件，为空时不使用区域映射
    */
-  RC init(DiskBufferPool *buffer_pool);
+  RC init(DiskBufferPool *buffer_pool, DiskBufferPool *fsm_buffer_pool, const TableMeta *table_meta = nullptr,
+      DiskBufferPool *zone_buffer_pool = nullptr);
 
   /**
    * @brief 关闭，做一些资源清理的工作
@@ -268,6 +556,17 @@ public:
    */
   RC insert_record(const char *data, int record_size, RID *rid);
 
+  /**
+   * @brief 批量插入记录
+   * @details 每个页面只加一次写锁，页面放满之后再换下一个页面。
+   * 中途失败时会删除这次已经插入的记录
+   *
+   * @param datas       所有记录的内容
+   * @param record_size 记录大小
+   * @param rids        返回每条记录的标识符，与 datas 一一对应
+   */
+  RC insert_records(const std::vector<const char *> &datas, int record_size, std::vector<RID> &rids);
+
   /**
    * @brief 数据库恢复时，在指定文件指定位置插入数据
    * 
@@ -298,16 +597,88 @@ public:
    */
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
 
+  /**
+   * @brief 区域映射，没有使用时返回空
+   */
+  ZoneMap *zone_map() { return zone_map_.enabled() ? &zone_map_ : nullptr; }
+
+  /**
+   * @brief 可见性映射，记录哪些页面上的记录对所有事务都可见
+   */
+  VisibilityMap &visibility_map() { return visibility_map_; }
+
+  /**
+   * @brief 数据文件的页面个数，包含第0个文件头页面
+   */
+  int page_count() const { return disk_buffer_pool_->page_num(); }
+
 private:
   /**
-   * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
+   * @brief 遍历所有的页面，重新生成空闲空间表
+   * @details 只有没有空闲空间表的旧数据文件，第一次打开时才需要
+   */
+  RC rebuild_free_space_map();
+
+  /**
+   * @brief 遍历所有的页面，重新生成区域映射
+   * @details 旧数据文件第一次打开，或者上次没有正常关闭时需要
+   */
+  RC rebuild_zone_map();
+
+  /**
+   * @brief 找到一个可以插入记录的页面，没有时分配一个新的页面
+   *
+   * @param record_page_handler 返回时拿着页面的写锁
+   * @param record_size         记录大小
+   * @param space               记录在页面上占用的空间。变长记录是编码后的长度
+   */
+  RC get_insert_page(RecordPageHandler &record_page_handler, int record_size, int space);
+
+  /**
+   * @brief 记录在页面上占用的空间
    */
-  RC init_free_pages();
+  int record_space(const char *data, int record_size) const;
 
 private:
   DiskBufferPool *disk_buffer_pool_ = nullptr;
-  std::unordered_set<PageNum> free_pages_; ///< 没有填充满的页面集合
-  common::Mutex lock_; ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
+  StorageFormat storage_format_ = StorageFormat::FIXED_FORMAT; ///< 新分配的页面使用哪种记录格式
+  std::vector<VarlenField> varlen_fields_;                      ///< 变长记录中变长存放的字段
+  std::vector<PaxColumn> pax_columns_;                          ///< PAX 页面上的列
+  FreeSpaceMap free_space_map_;                                 ///< 每个页面的空闲空间
+  ZoneMap zone_map_;                                            ///< 每个页面上若干列的最小值和最大值
+  VisibilityMap visibility_map_;                                ///< 每个页面上的记录是否对所有事务都可见
+};
+
+/**
+ * @brief 并行扫描时把文件的页面分成若干段(morsel)，由各个扫描线程动态地领取
+ * @ingroup RecordManager
+ * @details 每个线程扫描完一段再领取下一段，扫描快的线程会多领取一些，不会因为某些页面上的记录多、
+ * 过滤条件复杂而让其它线程等待。领取时只有一个原子操作，多个线程可以同时领取
+ */
+class MorselDispenser {
+public:
+  static constexpr int DEFAULT_MORSEL_PAGES = 64;
+
+  explicit MorselDispenser(int morsel_pages = DEFAULT_MORSEL_PAGES) : morsel_pages_(morsel_pages) {}
+
+  /**
+   * @brief 重新开始分配，第0个页面是 buffer pool 的文件头，从第1个页面开始
+   */
+  void reset() { next_page_.store(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief 领取下一段页面
+   *
+   * @param buffer_pool 扫描的文件，页面的个数以领取时为准
+   * @param begin       这一段的第一个页面
+   * @param end         这一段最后一个页面的下一个页面
+   * @return 所有的页面都已经分配完时返回 false
+   */
+  bool next(DiskBufferPool &buffer_pool, PageNum &begin, PageNum &end);
+
+private:
+  const int morsel_pages_;
+  std::atomic<PageNum> next_page_{1};
 };
 
 /**
@@ -322,14 +693,18 @@ public:
 
   /**
    * @brief 打开一个文件扫描。
-   * @details 如果条件不为空，则要对每条记录进行条件比较，只有满足所有条件的记录才被返回
+   * @details 如果条件不为空，则要对每条记录进行条件比较，只有满足所有条件的记录才被返回。
+   * 文件比较大时，扫描使用环形缓冲区(ScanRing)，不会把缓冲池中的其它页面都淘汰掉
    * @param table            遍历的哪张表
    * @param buffer_pool      访问的文件
    * @param readonly         当前是否只读操作。访问数据时，需要对页面加锁。比如
    *                         删除时也需要遍历找到数据，然后删除，这时就需要加写锁
    * @param condition_filter 做一些初步过滤操作
+   * @param morsels          并行扫描时，从这里领取需要扫描的页面。为空时扫描所有的页面
+   * @param zone_filter      用区域映射跳过不可能有满足条件的记录的页面，为空时不跳过
    */
-  RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly);
+  RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly, MorselDispenser *morsels = nullptr,
+      const ZoneFilter *zone_filter = nullptr);
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -351,6 +726,21 @@ public:
    */
   RC next(Record &record, bool *locked_ = nullptr);
 
+  /**
+   * @brief 获取下一个页面上的一批记录
+   * @details 一次返回一个页面上所有的记录，并且由事务一次性计算整批记录的可见性，跳过没有可见记录的页面。
+   * 记录数据指向页帧(变长记录和 PAX 记录指向 batch 中的缓冲区)，在下一次调用 next_batch 或者关闭扫描之前有效。
+   * PAX 格式的表只会读取 batch 投影的列，参考 RecordBatch::set_projection。
+   * 批量扫描不能和 next 混用
+   * @return 没有更多数据时返回 RECORD_EOF
+   */
+  RC next_batch(RecordBatch &batch);
+
+  /**
+   * @brief 这次扫描通过区域映射跳过了多少个页面
+   */
+  int skipped_pages() const { return skipped_pages_; }
+
 private:
   /**
    * @brief 获取该文件中的下一条记录
@@ -362,16 +752,33 @@ private:
    */
   RC fetch_next_record_in_page();
 
+  /**
+   * @brief 获取当前页面上的一批记录并检查可见性
+   */
+  RC fetch_batch_in_page(RecordBatch &batch);
+
+  /**
+   * @brief 找到下一个需要扫描的页面，并行扫描时当前这段页面扫描完了就领取下一段
+   * @details 区域映射表明页面上不可能有满足条件的记录时，跳过这个页面
+   * @return 没有更多页面时返回 false
+   */
+  bool next_page(PageNum &page_num);
+
 private:
   // TODO 对于一个纯粹的record遍历器来说，不应该关心表和事务
   Table *table_ = nullptr; ///< 当前遍历的是哪张表。这个字段仅供事务函数使用，如果设计合适，可以去掉
   DiskBufferPool *disk_buffer_pool_ = nullptr; ///< 当前访问的文件
   Trx *trx_ = nullptr;                         ///< 当前是哪个事务在遍历
   bool readonly_ = false;                      ///< 遍历出来的数据，是否可能对它做修改
+  MorselDispenser *morsels_ = nullptr;         ///< 并行扫描时从这里领取页面
+  const ZoneFilter *zone_filter_ = nullptr;    ///< 用区域映射跳过页面
+  int skipped_pages_ = 0;                      ///< 通过区域映射跳过的页面个数
 
+  std::unique_ptr<ScanRing> scan_ring_;     ///< 大表扫描使用的环形缓冲区
   BufferPoolIterator bp_iterator_;          ///< 遍历buffer pool的所有页面
   RecordPageHandler record_page_handler_;   ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_; ///< 遍历某个页面上的所有record
   Record next_record_;                      ///< 获取的记录放在这里缓存起来
   bool concurrency_locked_ = false;
+  bool batch_started_ = false;              ///< 是否已经开始批量扫描
 };
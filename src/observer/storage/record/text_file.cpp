@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <string.h>
+
+#include "common/log/log.h"
+#include "storage/record/text_file.h"
+
+RC TextFileHandler::init(DiskBufferPool *buffer_pool) {
+  if (buffer_pool_ != nullptr) {
+    LOG_ERROR("text file has been opened.");
+    return RC::RECORD_OPENNED;
+  }
+
+  buffer_pool_ = buffer_pool;
+  LOG_INFO("open text file. file=%s", buffer_pool->file_name().c_str());
+  return RC::SUCCESS;
+}
+
+void TextFileHandler::close() { buffer_pool_ = nullptr; }
+
+RC TextFileHandler::insert_text(const char *data, int len, int32_t &text_id) {
+  RC rc = RC::SUCCESS;
+  text_id = BP_INVALID_PAGE_NUM;
+
+  // 前一个分块的页面一直 pin 着，分配到下一个页面之后再填上 next_page
+  Frame *prev_frame = nullptr;
+  int written = 0;
+  do {
+    Frame *frame = nullptr;
+    rc = buffer_pool_->allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate text page. file=%s, rc=%s", buffer_pool_->file_name().c_str(), strrc(rc));
+      break;
+    }
+
+    const int chunk_len = std::min(len - written, CHUNK_SIZE);
+    frame->write_latch();
+    TextPageHeader *header = reinterpret_cast<TextPageHeader *>(frame->data());
+    header->next_page = BP_INVALID_PAGE_NUM;
+    header->length = chunk_len;
+    memcpy(header + 1, data + written, chunk_len);
+    frame->mark_dirty();
+    frame->write_unlatch();
+    written += chunk_len;
+
+    if (prev_frame == nullptr) {
+      text_id = frame->page_num();
+    } else {
+      prev_frame->write_latch();
+      reinterpret_cast<TextPageHeader *>(prev_frame->data())->next_page = frame->page_num();
+      prev_frame->mark_dirty();
+      prev_frame->write_unlatch();
+      prev_frame->unpin();
+    }
+    prev_frame = frame;
+  } while (written < len);
+
+  if (prev_frame != nullptr) {
+    prev_frame->unpin();
+  }
+
+  if (OB_FAIL(rc) && text_id != BP_INVALID_PAGE_NUM) {
+    delete_text(text_id);
+    text_id = BP_INVALID_PAGE_NUM;
+  }
+  return rc;
+}
+
+RC TextFileHandler::get_text(int32_t text_id, std::string &text) const {
+  text.clear();
+
+  // 最多只跟随文件中页面个数次，避免损坏的链表形成环
+  PageNum page_num = text_id;
+  for (int i = buffer_pool_->page_num(); page_num != BP_INVALID_PAGE_NUM; i--) {
+    if (page_num <= 0 || i <= 0) {
+      LOG_WARN("invalid text chain. file=%s, text id=%d, page num=%d", buffer_pool_->file_name().c_str(), text_id,
+               page_num);
+      return RC::INTERNAL;
+    }
+
+    Frame *frame = nullptr;
+    RC rc = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get text page. text id=%d, page num=%d, rc=%s", text_id, page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->read_latch();
+    const TextPageHeader *header = reinterpret_cast<const TextPageHeader *>(frame->data());
+    const int chunk_len = std::clamp(header->length, 0, CHUNK_SIZE);
+    text.append(reinterpret_cast<const char *>(header + 1), chunk_len);
+    page_num = header->next_page;
+    frame->read_unlatch();
+    frame->unpin();
+  }
+  return RC::SUCCESS;
+}
+
+RC TextFileHandler::delete_text(int32_t text_id) {
+  PageNum page_num = text_id;
+  for (int i = buffer_pool_->page_num(); page_num != BP_INVALID_PAGE_NUM; i--) {
+    if (page_num <= 0 || i <= 0) {
+      LOG_WARN("invalid text chain. file=%s, text id=%d, page num=%d", buffer_pool_->file_name().c_str(), text_id,
+               page_num);
+      return RC::INTERNAL;
+    }
+
+    Frame *frame = nullptr;
+    RC rc = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get text page. text id=%d, page num=%d, rc=%s", text_id, page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->read_latch();
+    const PageNum next_page = reinterpret_cast<const TextPageHeader *>(frame->data())->next_page;
+    frame->read_unlatch();
+    frame->unpin();
+
+    // 页面刚刚访问过，还在缓冲池中。释放失败只是浪费这一个页面，链表上后面的页面照常释放
+    rc = buffer_pool_->dispose_page(page_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to dispose text page. text id=%d, page num=%d, rc=%s", text_id, page_num, strrc(rc));
+    }
+    page_num = next_page;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+
+#include "sql/parser/value.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+/**
+ * @brief TEXT 文件中每个页面的页头
+ * @ingroup RecordManager
+ */
+struct TextPageHeader {
+  PageNum next_page; ///< 下一个分块所在的页面，最后一个分块是 BP_INVALID_PAGE_NUM
+  int32_t length;    ///< 这个页面上的数据长度
+};
+
+/**
+ * @brief 存放 TEXT 字段内容的文件
+ * @ingroup RecordManager
+ * @details 每个 TEXT 值按页面切成若干分块，分块之间通过页头中的 next_page 串成一个链表，
+ * 第一个分块所在的页号就是这个值的编号，保存在记录中。值不需要放在连续的页面上。
+ *
+ * 值的内容写入之后不会再修改，更新 TEXT 字段时总是写入一个新的值。
+ * 每个值只属于一条记录，记录从表文件中删除时调用 delete_text 把整个链表上的页面还给 BufferPool，
+ * 之后分配页面时会优先复用这些空闲页面。
+ *
+ * TEXT 文件不记录日志。
+ */
+class TextFileHandler : public TextLoader {
+public:
+  /// 每个页面能放下的数据长度
+  static constexpr int CHUNK_SIZE = BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(TextPageHeader));
+
+public:
+  TextFileHandler() = default;
+  ~TextFileHandler() override = default;
+
+  RC init(DiskBufferPool *buffer_pool);
+  void close();
+
+  /**
+   * @brief 写入一个值
+   * @param text_id 返回值的编号
+   */
+  RC insert_text(const char *data, int len, int32_t &text_id);
+
+  /**
+   * @brief 读取一个值的全部内容
+   */
+  RC get_text(int32_t text_id, std::string &text) const;
+
+  /**
+   * @brief 删除一个值，释放它占用的所有页面
+   */
+  RC delete_text(int32_t text_id);
+
+  RC load_text(int32_t text_id, std::string &text) const override { return get_text(text_id, text); }
+
+private:
+  DiskBufferPool *buffer_pool_ = nullptr;
+};
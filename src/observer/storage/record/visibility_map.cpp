@@ -0,0 +1,59 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/record/visibility_map.h"
+
+bool VisibilityMap::all_visible(PageNum page_num) const {
+  if (page_num < 0) {
+    return false;
+  }
+
+  const size_t word = page_num / BITS_PER_WORD;
+  const uint64_t bit = 1ULL << (page_num % BITS_PER_WORD);
+  lock_.lock_shared();
+  const bool result = word < words_.size() && (words_[word] & bit) != 0;
+  lock_.unlock_shared();
+  return result;
+}
+
+void VisibilityMap::set_all_visible(PageNum page_num) {
+  if (page_num < 0) {
+    return;
+  }
+
+  const size_t word = page_num / BITS_PER_WORD;
+  const uint64_t bit = 1ULL << (page_num % BITS_PER_WORD);
+  lock_.lock();
+  if (word >= words_.size()) {
+    words_.resize(word + 1, 0);
+  }
+  words_[word] |= bit;
+  lock_.unlock();
+}
+
+void VisibilityMap::clear(PageNum page_num) {
+  if (!all_visible(page_num)) {
+    return;
+  }
+
+  const size_t word = page_num / BITS_PER_WORD;
+  const uint64_t bit = 1ULL << (page_num % BITS_PER_WORD);
+  lock_.lock();
+  if (word < words_.size()) {
+    words_[word] &= ~bit;
+  }
+  lock_.unlock();
+}
+
+void VisibilityMap::reset() {
+  lock_.lock();
+  words_.clear();
+  lock_.unlock();
+}
@@ -0,0 +1,57 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "common/lang/mutex.h"
+#include "common/types.h"
+
+/**
+ * @brief 记录文件的可见性映射(Visibility Map)，每个数据页面一位
+ * @ingroup RecordManager
+ * @details 置位表示页面上的记录对所有事务都可见：插入已经提交，并且早于所有活跃的事务，也没有被删除。
+ * 只扫描索引就能得到结果时，页面置位就不用读取记录检查可见性。
+ *
+ * 只有 MVCC 的清理线程(Vacuum)在持有页面读锁时检查页面上所有的记录之后置位。
+ * 修改页面的操作都在持有页面写锁时清除对应的位，所以置位时页面上的记录不会再变化。
+ * 可见性映射只保存在内存中，重启之后所有页面都没有置位，等待下一次清理。
+ */
+class VisibilityMap {
+public:
+  VisibilityMap() = default;
+  ~VisibilityMap() = default;
+
+  /**
+   * @brief 页面上的记录是否对所有事务都可见
+   */
+  bool all_visible(PageNum page_num) const;
+
+  void set_all_visible(PageNum page_num);
+
+  /**
+   * @brief 页面被修改了，清除页面的标记
+   * @details 没有置位时只加读锁，插入和删除记录时的开销很小
+   */
+  void clear(PageNum page_num);
+
+  /**
+   * @brief 清除所有页面的标记
+   */
+  void reset();
+
+private:
+  static constexpr int BITS_PER_WORD = 64;
+
+  mutable common::SharedMutex lock_;
+  std::vector<uint64_t>       words_;
+};
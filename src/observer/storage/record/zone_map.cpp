@@ -0,0 +1,393 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+#include "common/log/log.h"
+#include "storage/record/zone_map.h"
+#include "storage/table/table_meta.h"
+
+using namespace std;
+
+/// 第0个页面是 BufferPool 的文件头，第1个页面是 ZoneMapHeader
+static constexpr PageNum ZONE_MAP_HEADER_PAGE = 1;
+
+void ZoneMap::choose_columns(const TableMeta &table_meta, vector<ZoneMapColumn> &columns) {
+  columns.clear();
+  const int null_offset = table_meta.null_field_meta()->offset();
+  for (const FieldMeta &field : *table_meta.field_metas()) {
+    if (!field.visible() || field.len() != static_cast<int>(sizeof(int32_t))) {
+      continue;
+    }
+    if (field.type() != INTS && field.type() != DATES && field.type() != FLOATS) {
+      continue;
+    }
+
+    columns.push_back(ZoneMapColumn{field.index(), field.offset(), field.type(), field.nullable() ? null_offset : -1});
+    if (static_cast<int>(columns.size()) >= ZoneMapHeader::MAX_COLUMNS) {
+      break;
+    }
+  }
+}
+
+RC ZoneMap::init(DiskBufferPool *buffer_pool, const vector<ZoneMapColumn> &columns, bool &need_rebuild) {
+  need_rebuild = false;
+  if (buffer_pool_ != nullptr) {
+    LOG_ERROR("zone map has been opened.");
+    return RC::RECORD_OPENNED;
+  }
+
+  if (columns.empty()) {
+    LOG_INFO("no column for zone map. file=%s", buffer_pool->file_name().c_str());
+    return RC::SUCCESS;
+  }
+
+  if (static_cast<int>(columns.size()) > ZoneMapHeader::MAX_COLUMNS) {
+    LOG_WARN("too many columns for zone map. columns=%d", static_cast<int>(columns.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Frame *frame = nullptr;
+  RC rc = RC::SUCCESS;
+  if (buffer_pool->page_num() <= ZONE_MAP_HEADER_PAGE) {
+    // 新创建的文件，新页面的内容都是0，与上次没有正常关闭的处理相同
+    rc = buffer_pool->allocate_page(&frame);
+  } else {
+    rc = buffer_pool->get_this_page(ZONE_MAP_HEADER_PAGE, &frame);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get zone map header page. file=%s, rc=%s", buffer_pool->file_name().c_str(), strrc(rc));
+    return rc;
+  }
+
+  frame->write_latch();
+  ZoneMapHeader *header = reinterpret_cast<ZoneMapHeader *>(frame->data());
+  bool same_columns = header->column_num == static_cast<int32_t>(columns.size());
+  for (size_t i = 0; same_columns && i < columns.size(); i++) {
+    same_columns = header->fields[i] == columns[i].field_index;
+  }
+  need_rebuild = header->clean == 0 || !same_columns;
+
+  // 先把不干净的标记写到磁盘上，之后再修改数据文件。异常退出后下次打开时就知道要重建
+  header->clean = 0;
+  header->column_num = static_cast<int32_t>(columns.size());
+  for (size_t i = 0; i < columns.size(); i++) {
+    header->fields[i] = columns[i].field_index;
+  }
+  frame->mark_dirty();
+  frame->write_unlatch();
+  rc = buffer_pool->flush_page(*frame);
+  buffer_pool->unpin_page(frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush zone map header page. file=%s, rc=%s", buffer_pool->file_name().c_str(), strrc(rc));
+    return rc;
+  }
+
+  buffer_pool_ = buffer_pool;
+  columns_ = columns;
+  LOG_INFO("open zone map. file=%s, columns=%d, need rebuild=%d",
+           buffer_pool->file_name().c_str(), static_cast<int>(columns.size()), need_rebuild);
+  return RC::SUCCESS;
+}
+
+void ZoneMap::close() {
+  if (buffer_pool_ == nullptr) {
+    return;
+  }
+
+  // 所有统计信息都刷到磁盘之后才能标记为干净
+  RC rc = buffer_pool_->flush_all_pages();
+  Frame *frame = nullptr;
+  if (OB_SUCC(rc)) {
+    rc = buffer_pool_->get_this_page(ZONE_MAP_HEADER_PAGE, &frame);
+  }
+  if (OB_SUCC(rc)) {
+    frame->write_latch();
+    reinterpret_cast<ZoneMapHeader *>(frame->data())->clean = 1;
+    frame->mark_dirty();
+    frame->write_unlatch();
+    rc = buffer_pool_->flush_page(*frame);
+    buffer_pool_->unpin_page(frame);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to close zone map, it will be rebuilt next time. file=%s, rc=%s",
+             buffer_pool_->file_name().c_str(), strrc(rc));
+  }
+
+  buffer_pool_ = nullptr;
+  columns_.clear();
+}
+
+int ZoneMap::column_index(int field_index) const {
+  for (size_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i].field_index == field_index) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+RC ZoneMap::clear_all() {
+  if (!enabled()) {
+    return RC::SUCCESS;
+  }
+
+  for (PageNum page_num = ZONE_MAP_HEADER_PAGE + 1; page_num < buffer_pool_->page_num(); page_num++) {
+    Frame *frame = nullptr;
+    RC rc = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get zone map page. file=%s, page num=%d, rc=%s",
+               buffer_pool_->file_name().c_str(), page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->write_latch();
+    memset(frame->data(), 0, BP_PAGE_DATA_SIZE);
+    frame->mark_dirty();
+    frame->write_unlatch();
+    buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC ZoneMap::update(PageNum page_num, const char *const *records, int count, bool reset) {
+  if (!enabled() || count <= 0) {
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  int offset = 0;
+  RC rc = get_entry_page(page_num, true /*create*/, frame, offset);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  frame->write_latch();
+  int32_t *entry = reinterpret_cast<int32_t *>(frame->data() + offset);
+  if (reset) {
+    // 最小值大于最大值，表示这一列还没有非 NULL 的值
+    entry[0] = 1;
+    for (size_t i = 0; i < columns_.size(); i++) {
+      int32_t *range = entry + 1 + 2 * i;
+      if (columns_[i].type == FLOATS) {
+        const float min_value = numeric_limits<float>::infinity();
+        const float max_value = -numeric_limits<float>::infinity();
+        memcpy(&range[0], &min_value, sizeof(float));
+        memcpy(&range[1], &max_value, sizeof(float));
+      } else {
+        range[0] = numeric_limits<int32_t>::max();
+        range[1] = numeric_limits<int32_t>::min();
+      }
+    }
+  }
+
+  // 没有统计信息的页面，上面可能还有其它没有统计过的记录，只能继续保持没有统计信息
+  if (entry[0] != 0) {
+    for (int i = 0; i < count; i++) {
+      widen(entry, records[i]);
+    }
+  }
+  frame->mark_dirty();
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+void ZoneMap::widen(int32_t *entry, const char *record) const {
+  for (size_t i = 0; i < columns_.size(); i++) {
+    const ZoneMapColumn &column = columns_[i];
+    if (column.null_offset >= 0) {
+      int32_t null_flags = 0;
+      memcpy(&null_flags, record + column.null_offset, sizeof(null_flags));
+      if (null_flags & (1 << column.field_index)) {
+        continue;
+      }
+    }
+
+    int32_t *range = entry + 1 + 2 * i;
+    if (column.type == FLOATS) {
+      float value = 0, min_value = 0, max_value = 0;
+      memcpy(&value, record + column.offset, sizeof(float));
+      if (std::isnan(value)) {
+        // NaN 与任何值都比较不出大小，这个页面不再使用统计信息
+        entry[0] = 0;
+        return;
+      }
+      memcpy(&min_value, &range[0], sizeof(float));
+      memcpy(&max_value, &range[1], sizeof(float));
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+      memcpy(&range[0], &min_value, sizeof(float));
+      memcpy(&range[1], &max_value, sizeof(float));
+    } else {
+      int32_t value = 0;
+      memcpy(&value, record + column.offset, sizeof(value));
+      range[0] = std::min(range[0], value);
+      range[1] = std::max(range[1], value);
+    }
+  }
+}
+
+RC ZoneMap::clear(PageNum page_num) {
+  if (!enabled()) {
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  int offset = 0;
+  RC rc = get_entry_page(page_num, false /*create*/, frame, offset);
+  if (OB_FAIL(rc) || frame == nullptr) {
+    return rc;
+  }
+
+  frame->write_latch();
+  int32_t *entry = reinterpret_cast<int32_t *>(frame->data() + offset);
+  if (entry[0] != 0) {
+    entry[0] = 0;
+    frame->mark_dirty();
+  }
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+bool ZoneMap::may_match(PageNum page_num, const vector<ZoneCondition> &conditions) {
+  if (!enabled() || conditions.empty()) {
+    return true;
+  }
+
+  Frame *frame = nullptr;
+  int offset = 0;
+  RC rc = get_entry_page(page_num, false /*create*/, frame, offset);
+  if (OB_FAIL(rc) || frame == nullptr) {
+    return true;
+  }
+
+  bool result = true;
+  frame->read_latch();
+  const int32_t *entry = reinterpret_cast<const int32_t *>(frame->data() + offset);
+  if (entry[0] != 0) {
+    for (const ZoneCondition &condition : conditions) {
+      if (!column_may_match(entry, condition)) {
+        result = false;
+        break;
+      }
+    }
+  }
+  frame->read_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return result;
+}
+
+bool ZoneMap::column_may_match(const int32_t *entry, const ZoneCondition &condition) const {
+  if (condition.column < 0 || condition.column >= static_cast<int>(columns_.size())) {
+    return true;
+  }
+
+  // 与 NULL 比较总是不成立
+  if (condition.value.attr_type() == NULLS) {
+    return false;
+  }
+
+  const ZoneMapColumn &column = columns_[condition.column];
+  int32_t range[2];
+  memcpy(range, entry + 1 + 2 * condition.column, sizeof(range));
+  if (column.type == FLOATS) {
+    float min_value = 0, max_value = 0;
+    memcpy(&min_value, &range[0], sizeof(float));
+    memcpy(&max_value, &range[1], sizeof(float));
+    if (min_value > max_value) {
+      return false;
+    }
+  } else if (range[0] > range[1]) {
+    return false;
+  }
+
+  // 比较结果随着字段的值单调变化，页面上任何一个值的比较结果都在 [low, high] 之间
+  Value min_value(column.type, reinterpret_cast<char *>(&range[0]));
+  Value max_value(column.type, reinterpret_cast<char *>(&range[1]));
+  int low = 0, high = 0;
+  if (condition.value_left) {
+    low = condition.value.compare(max_value);
+    high = condition.value.compare(min_value);
+  } else {
+    low = min_value.compare(condition.value);
+    high = max_value.compare(condition.value);
+  }
+  if (low == INVALID_COMPARE || high == INVALID_COMPARE) {
+    return true;
+  }
+
+  switch (condition.op) {
+  case EQUAL_TO: {
+    return low <= 0 && high >= 0;
+  } break;
+  case LESS_EQUAL: {
+    return low <= 0;
+  } break;
+  case NOT_EQUAL: {
+    return low != 0 || high != 0;
+  } break;
+  case LESS_THAN: {
+    return low < 0;
+  } break;
+  case GREAT_EQUAL: {
+    return high >= 0;
+  } break;
+  case GREAT_THAN: {
+    return high > 0;
+  } break;
+  default: {
+    return true;
+  }
+  }
+}
+
+RC ZoneMap::get_entry_page(PageNum page_num, bool create, Frame *&frame, int &entry) {
+  frame = nullptr;
+  entry = 0;
+  if (page_num < 0) {
+    LOG_WARN("invalid page num. page num=%d", page_num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int per_page = entries_per_page();
+  const PageNum zone_page_num = ZONE_MAP_HEADER_PAGE + 1 + page_num / per_page;
+  entry = (page_num % per_page) * entry_size();
+  if (zone_page_num >= buffer_pool_->page_num()) {
+    if (!create) {
+      return RC::SUCCESS;
+    }
+
+    // 与 FreeSpaceMap 相同，页面从不释放，新分配的页面编号总是连续的
+    lock_.lock();
+    while (zone_page_num >= buffer_pool_->page_num()) {
+      Frame *new_frame = nullptr;
+      RC rc = buffer_pool_->allocate_page(&new_frame);
+      if (OB_FAIL(rc)) {
+        lock_.unlock();
+        LOG_WARN("failed to allocate zone map page. file=%s, rc=%s", buffer_pool_->file_name().c_str(), strrc(rc));
+        return rc;
+      }
+      new_frame->mark_dirty();
+      buffer_pool_->unpin_page(new_frame);
+    }
+    lock_.unlock();
+  }
+
+  RC rc = buffer_pool_->get_this_page(zone_page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get zone map page. file=%s, page num=%d, rc=%s",
+             buffer_pool_->file_name().c_str(), zone_page_num, strrc(rc));
+  }
+  return rc;
+}
@@ -0,0 +1,179 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "sql/parser/parse_defs.h"
+#include "sql/parser/value.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+class TableMeta;
+
+/**
+ * @brief 区域映射文件的第一个页面(文件头之后)
+ * @ingroup RecordManager
+ */
+struct ZoneMapHeader {
+  static constexpr int MAX_COLUMNS = 8;
+
+  int32_t clean;                ///< 上次是否正常关闭。为0时文件中的内容可能比数据文件旧，打开时需要重建
+  int32_t column_num;           ///< 记录了几列的最小最大值
+  int32_t fields[MAX_COLUMNS];  ///< 每一列对应的字段下标(FieldMeta::index)
+};
+
+/**
+ * @brief 区域映射中的一列
+ * @ingroup RecordManager
+ */
+struct ZoneMapColumn {
+  int      field_index; ///< 字段在表元数据中的下标(FieldMeta::index)，也是 null 标记中对应的位
+  int      offset;      ///< 字段在记录中的偏移
+  AttrType type;        ///< 只支持4个字节的 INTS、DATES 和 FLOATS
+  int      null_offset; ///< null 标记字段在记录中的偏移，字段不能为 NULL 时是-1
+};
+
+/**
+ * @brief 可以用区域映射判断的过滤条件：column op value，或者 value op column
+ * @ingroup RecordManager
+ */
+struct ZoneCondition {
+  int    column;     ///< 区域映射中的列下标，不是字段下标
+  CompOp op;
+  Value  value;
+  bool   value_left; ///< 常量是否在比较符的左边
+};
+
+/**
+ * @brief 记录文件的区域映射(Zone Map)，每个数据页面上若干列的最小值和最大值
+ * @ingroup RecordManager
+ * @details 区域映射存放在单独的文件中，第1个页面是 ZoneMapHeader，之后每个页面存放
+ * entries_per_page() 个数据页面的统计信息。每个数据页面一项：先是一个标记，后面是每一列的最小值和最大值。
+ * 标记为0表示没有统计信息，扫描时不能跳过这个页面。
+ *
+ * 插入和更新记录时扩大页面的范围。删除记录时不缩小范围，范围只会比页面上的实际数据大，
+ * 页面上的记录全部删除之后才清除统计信息，再插入时重新开始统计。NULL 不参与统计，
+ * 一列全部是 NULL 时最小值大于最大值，这一列上的任何比较都不会成立。
+ *
+ * 扫描时用下推的比较条件检查每个页面，页面上的范围不可能满足条件时直接跳过，不读取数据页面。
+ *
+ * 区域映射不记录日志。打开时把页头标记为不干净并立即刷盘，正常关闭时刷完所有页面再标记为干净。
+ * 打开时发现上次没有正常关闭，或者是旧版本创建的表，遍历数据文件重建。
+ * 并发控制与 FreeSpaceMap 相同，持有区域映射页面的锁时不会再去加数据页面的锁。
+ */
+class ZoneMap {
+public:
+  ZoneMap() = default;
+  ~ZoneMap() = default;
+
+  /**
+   * @brief 选择需要统计的列：可见的 INTS、DATES 和 FLOATS 字段，最多 ZoneMapHeader::MAX_COLUMNS 列
+   */
+  static void choose_columns(const TableMeta &table_meta, std::vector<ZoneMapColumn> &columns);
+
+  /**
+   * @brief 初始化
+   * @param buffer_pool  区域映射文件
+   * @param columns      需要统计的列，为空时不使用区域映射
+   * @param need_rebuild 返回是否需要遍历数据文件重建
+   */
+  RC init(DiskBufferPool *buffer_pool, const std::vector<ZoneMapColumn> &columns, bool &need_rebuild);
+
+  /**
+   * @brief 刷新所有页面并标记为正常关闭
+   */
+  void close();
+
+  bool enabled() const { return buffer_pool_ != nullptr; }
+
+  const std::vector<ZoneMapColumn> &columns() const { return columns_; }
+
+  /**
+   * @brief 字段在区域映射中的列下标，没有统计时返回-1
+   */
+  int column_index(int field_index) const;
+
+  /**
+   * @brief 清除所有页面的统计信息，重建之前调用
+   */
+  RC clear_all();
+
+  /**
+   * @brief 用一个页面上新增或修改的记录扩大这个页面的范围
+   * @details 调用者要拿着数据页面的写锁
+   * @param records 记录的数据
+   * @param reset   页面上只有这些记录，丢弃原来的统计信息
+   */
+  RC update(PageNum page_num, const char *const *records, int count, bool reset);
+
+  /**
+   * @brief 页面上已经没有记录，清除统计信息
+   */
+  RC clear(PageNum page_num);
+
+  /**
+   * @brief 页面上是否可能有满足所有条件的记录
+   * @details 没有统计信息或者出错时总是返回 true
+   */
+  bool may_match(PageNum page_num, const std::vector<ZoneCondition> &conditions);
+
+private:
+  /**
+   * @brief 每一项的大小：一个标记加上每一列的最小值和最大值
+   */
+  int entry_size() const { return static_cast<int>(sizeof(int32_t) * (1 + 2 * columns_.size())); }
+  int entries_per_page() const { return BP_PAGE_DATA_SIZE / entry_size(); }
+
+  /**
+   * @brief 获取数据页面所在的区域映射页面并 pin 住
+   * @param create 页面不存在时是否创建
+   * @param frame  页面不存在并且不创建时返回 nullptr
+   * @param entry  数据页面对应的项在页面中的偏移
+   */
+  RC get_entry_page(PageNum page_num, bool create, Frame *&frame, int &entry);
+
+  /**
+   * @brief 把一条记录的值加入到统计信息中
+   */
+  void widen(int32_t *entry, const char *record) const;
+
+  /**
+   * @brief 统计信息中某一列的范围是否可能满足条件
+   */
+  bool column_may_match(const int32_t *entry, const ZoneCondition &condition) const;
+
+private:
+  DiskBufferPool            *buffer_pool_ = nullptr;
+  std::vector<ZoneMapColumn> columns_;
+  common::Mutex              lock_; ///< 扩展文件时使用
+};
+
+/**
+ * @brief 一次扫描使用的区域映射过滤条件
+ * @ingroup RecordManager
+ * @details 创建之后只会被读取，并行扫描的多个线程可以共用
+ */
+class ZoneFilter {
+public:
+  ZoneFilter(ZoneMap *zone_map, std::vector<ZoneCondition> conditions)
+      : zone_map_(zone_map), conditions_(std::move(conditions)) {}
+
+  bool empty() const { return zone_map_ == nullptr || conditions_.empty(); }
+
+  /**
+   * @brief 页面上是否可能有满足条件的记录，不可能时扫描可以跳过这个页面
+   */
+  bool may_match(PageNum page_num) const { return empty() || zone_map_->may_match(page_num, conditions_); }
+
+private:
+  ZoneMap                   *zone_map_ = nullptr;
+  std::vector<ZoneCondition> conditions_;
+};
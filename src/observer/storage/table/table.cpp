@@ -28,9 +28,11 @@ See the Mulan PSL v2 for more details. */
 #include "storage/index/bplus_tree_index.h"
 #include "storage/index/index.h"
 #include "storage/record/record_manager.h"
+#include "storage/record/text_file.h"
 #include "storage/table/table.h"
 #include "storage/table/table_meta.h"
 #include "storage/trx/trx.h"
+#include "storage/trx/vacuum.h"
 #include "storage/view/view.h"
 
 Table::Table(View *view) : view_(view) {}
@@ -46,6 +48,22 @@ Table::~Table() {
     data_buffer_pool_ = nullptr;
   }
 
+  if (fsm_buffer_pool_ != nullptr) {
+    fsm_buffer_pool_->close_file();
+    fsm_buffer_pool_ = nullptr;
+  }
+
+  if (zone_buffer_pool_ != nullptr) {
+    zone_buffer_pool_->close_file();
+    zone_buffer_pool_ = nullptr;
+  }
+
+  if (text_handler_ != nullptr) {
+    text_handler_->close();
+    delete text_handler_;
+    text_handler_ = nullptr;
+  }
+
   if (text_buffer_pool_ != nullptr) {
     text_buffer_pool_->close_file();
     text_buffer_pool_ = nullptr;
@@ -61,7 +79,7 @@ Table::~Table() {
 }
 
 RC Table::create(int32_t table_id, const char *path, const char *name, const char *base_dir, int attribute_count,
-                 const AttrInfoSqlNode attributes[]) {
+                 const AttrInfoSqlNode attributes[], StorageFormat storage_format) {
 
   if (common::is_blank(name)) {
     LOG_WARN("Name cannot be empty");
@@ -91,7 +109,7 @@ RC Table::create(int32_t table_id, const char *path, const char *name, const cha
   close(fd);
 
   // 创建文件
-  if ((rc = table_meta().init(table_id, name, attribute_count, attributes)) != RC::SUCCESS) {
+  if ((rc = table_meta().init(table_id, name, attribute_count, attributes, storage_format)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init table meta. name:%s, ret:%d", name, rc);
     return rc; // delete table file
   }
@@ -115,6 +133,20 @@ RC Table::create(int32_t table_id, const char *path, const char *name, const cha
     return rc;
   }
 
+  std::string fsm_file = table_fsm_file(base_dir, name);
+  rc = bpm.create_file(fsm_file.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to create disk buffer pool of free space map file. file name=%s", fsm_file.c_str());
+    return rc;
+  }
+
+  std::string zone_file = table_zone_file(base_dir, name);
+  rc = bpm.create_file(zone_file.c_str());
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to create disk buffer pool of zone map file. file name=%s", zone_file.c_str());
+    return rc;
+  }
+
   rc = init_record_handler(base_dir);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to create table %s due to init record handler failed.", data_file.c_str());
@@ -217,6 +249,53 @@ RC Table::insert_record(Record &record) {
   return rc;
 }
 
+RC Table::insert_records(std::vector<Record> &records) {
+  std::vector<const char *> datas;
+  datas.reserve(records.size());
+  for (const Record &record : records) {
+    datas.push_back(record.data());
+  }
+
+  std::vector<RID> rids;
+  RC rc = record_handler_->insert_records(datas, table_meta().record_size(), rids);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Insert records failed. table name=%s, rc=%s", table_meta().name(), strrc(rc));
+    return rc;
+  }
+  for (size_t i = 0; i < records.size(); i++) {
+    records[i].set_rid(rids[i]);
+  }
+
+  size_t index_num = 0;
+  for (; index_num < indexes_.size(); index_num++) {
+    rc = indexes_[index_num]->insert_entries(datas, rids);
+    if (rc != RC::SUCCESS) { // 可能出现了键值重复
+      break;
+    }
+  }
+
+  if (rc != RC::SUCCESS) {
+    // 失败的索引已经回滚了自己插入的数据，这里只需要回滚之前的索引和表数据
+    for (size_t i = 0; i < index_num; i++) {
+      for (size_t j = 0; j < datas.size(); j++) {
+        RC rc2 = indexes_[i]->delete_entry(datas[j], &rids[j]);
+        if (rc2 != RC::SUCCESS) {
+          LOG_ERROR("Failed to rollback index data when insert index entries failed. table name=%s, rc=%d:%s", name(),
+                    rc2, strrc(rc2));
+        }
+      }
+    }
+    for (const RID &rid : rids) {
+      RC rc2 = record_handler_->delete_record(&rid);
+      if (rc2 != RC::SUCCESS) {
+        LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s", name(),
+                  rc2, strrc(rc2));
+      }
+    }
+  }
+  return rc;
+}
+
 RC Table::visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor) {
   return record_handler_->visit_record(rid, readonly, visitor);
 }
@@ -249,7 +328,15 @@ RC Table::recover_insert_record(Record &record) {
     return rc;
   }
 
-  rc = insert_entry_of_indexes(record.data(), record.rid());
+  // 索引文件可能已经包含了这条记录(比如正常关闭之后日志没有清理)，键值和RID都相同的索引项不需要重复插入
+  for (Index *index : indexes_) {
+    rc = index->insert_entry(record.data(), &record.rid());
+    if (rc == RC::RECORD_DUPLICATE_KEY) {
+      rc = RC::SUCCESS;
+    } else if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
   if (rc != RC::SUCCESS) { // 可能出现了键值重复
     RC rc2 = delete_entry_of_indexes(record.data(), record.rid(), false /*error_on_not_exists*/);
     if (rc2 != RC::SUCCESS) {
@@ -293,14 +380,12 @@ RC Table::make_record(int value_num, const Value *values, Record &record) {
   for (int i = 0; i < value_num; i++) {
     const FieldMeta *field = table_meta().field(i + normal_field_start_index);
     Value &value = const_cast<Value &>(values[i]);
-    if (field->type() == TEXTS) {
-      if (value.get_string().size()) {
-        int offset;
-        rc = add_text(value.get_string().c_str(), offset);
-        if (rc != RC::SUCCESS)
-          return rc;
-        value.set_int(offset);
-      }
+    if (field->type() == TEXTS && value.attr_type() != NULLS) {
+      int text_id;
+      rc = add_text(value.get_string().c_str(), text_id);
+      if (rc != RC::SUCCESS)
+        return rc;
+      value.set_int(text_id);
     } else if (value.attr_type() == NULLS) {
       if (!field->nullable()) {
         LOG_ERROR("unreachable should be checked in caller");
@@ -355,12 +440,48 @@ RC Table::init_record_handler(const char *base_dir) {
     return rc;
   }
 
+  // 旧版本创建的表没有空闲空间表文件，这里创建一个，RecordFileHandler 会重新生成空闲空间表
+  std::string fsm_file = table_fsm_file(base_dir, table_meta().name());
+  if (access(fsm_file.c_str(), F_OK) != 0) {
+    rc = BufferPoolManager::instance().create_file(fsm_file.c_str());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to create free space map file:%s. rc=%s", fsm_file.c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = BufferPoolManager::instance().open_file(fsm_file.c_str(), fsm_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open disk buffer pool for file:%s. rc=%d:%s", fsm_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
+  // 区域映射文件也一样，旧版本创建的表第一次打开时重建
+  std::string zone_file = table_zone_file(base_dir, table_meta().name());
+  if (access(zone_file.c_str(), F_OK) != 0) {
+    rc = BufferPoolManager::instance().create_file(zone_file.c_str());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to create zone map file:%s. rc=%s", zone_file.c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = BufferPoolManager::instance().open_file(zone_file.c_str(), zone_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open disk buffer pool for file:%s. rc=%d:%s", zone_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
   record_handler_ = new RecordFileHandler();
-  rc = record_handler_->init(data_buffer_pool_);
+  rc = record_handler_->init(data_buffer_pool_, fsm_buffer_pool_, &table_meta(), zone_buffer_pool_);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to init record handler. rc=%s", strrc(rc));
     data_buffer_pool_->close_file();
     data_buffer_pool_ = nullptr;
+    fsm_buffer_pool_->close_file();
+    fsm_buffer_pool_ = nullptr;
+    zone_buffer_pool_->close_file();
+    zone_buffer_pool_ = nullptr;
     delete record_handler_;
     record_handler_ = nullptr;
     return rc;
@@ -369,15 +490,17 @@ RC Table::init_record_handler(const char *base_dir) {
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly) {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly);
+RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly,
+    MorselDispenser *morsels /* = nullptr */, const ZoneFilter *zone_filter /* = nullptr */) {
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, morsels, zone_filter);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
   return rc;
 }
 
-RC Table::create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const char *index_name, bool unique) {
+RC Table::create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const char *index_name, bool unique,
+    int fill_factor, const std::vector<FieldMeta> &include_meta) {
   if (common::is_blank(index_name) || field_meta.empty()) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
     return RC::INVALID_ARGUMENT;
@@ -385,9 +508,10 @@ RC Table::create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const
 
   auto real_meta = field_meta;
   real_meta.insert(real_meta.begin(), *table_meta().null_field_meta());
+  real_meta.insert(real_meta.end(), include_meta.begin(), include_meta.end());
 
   IndexMeta new_index_meta;
-  RC rc = new_index_meta.init(index_name, real_meta, unique);
+  RC rc = new_index_meta.init(index_name, real_meta, unique, static_cast<int>(include_meta.size()));
   if (rc != RC::SUCCESS) {
     LOG_INFO("Failed to init IndexMeta in table:%s, index_name:%s", name(), index_name);
     return rc;
@@ -403,29 +527,14 @@ RC Table::create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
-  RecordFileScanner scanner;
-  rc = get_record_scanner(scanner, trx, true /*readonly*/);
+  // 遍历当前的所有数据，排序之后批量构建索引
+  rc = build_index(index, fill_factor);
   if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
+    LOG_WARN("failed to build index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
+    delete index;
+    ::unlink(index_file.c_str());
     return rc;
   }
-
-  Record record;
-  while (scanner.has_next()) {
-    rc = scanner.next(record);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to scan records while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
-      return rc;
-    }
-    rc = index->insert_entry(record.data(), &record.rid());
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s", name(), index_name,
-               strrc(rc));
-      return rc;
-    }
-  }
-  scanner.close_scan();
   LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
 
   indexes_.push_back(index);
@@ -446,6 +555,42 @@ RC Table::create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const
   return rc;
 }
 
+RC Table::build_index(BplusTreeIndex *index, int fill_factor) {
+  RC rc = index->bulk_load_begin(fill_factor);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  // 与插入记录时维护索引一样，所有版本都要有索引项：已经删除但还没有清理的版本会被清理时删除索引项，
+  // 其它事务还没有提交的记录提交之后也要能通过索引找到。所以不按照事务的可见性过滤
+  RecordFileScanner scanner;
+  rc = get_record_scanner(scanner, nullptr /*trx*/, true /*readonly*/);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create scanner while creating index. table=%s, rc=%s", name(), strrc(rc));
+    return rc;
+  }
+
+  Record record;
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to scan records while creating index. table=%s, rc=%s", name(), strrc(rc));
+      break;
+    }
+    rc = index->bulk_load_add(record.data(), &record.rid());
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to add record into index while creating index. table=%s, rc=%s", name(), strrc(rc));
+      break;
+    }
+  }
+  scanner.close_scan();
+
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  return index->bulk_load_finish();
+}
+
 RC Table::drop_index(int idx) {
   assert(idx < indexes_.size());
   string index_name = indexes_[idx]->index_meta().name();
@@ -517,17 +662,100 @@ RC Table::delete_record(const RID &rid) {
   return rc;
 }
 
-RC Table::delete_record(const Record &record) {
+RC Table::delete_record(const Record &record) { return delete_record(record, true /*entry_must_exist*/); }
+
+RC Table::delete_record(const Record &record, bool entry_must_exist) {
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_) {
     rc = index->delete_entry(record.data(), &record.rid());
+    if (rc == RC::RECORD_NOT_EXIST && !entry_must_exist) {
+      LOG_TRACE("index entry not exists. table name=%s, index name=%s, rid=%s", name(), index->index_meta().name(),
+          record.rid().to_string().c_str());
+      continue;
+    }
     ASSERT(RC::SUCCESS == rc, "failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s", name(),
            index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
   }
+  // 记录删除之后没有人再引用它的 TEXT，空出来的页面留给之后写入的 TEXT 使用
+  delete_texts(record.data());
   rc = record_handler_->delete_record(&record.rid());
   return rc;
 }
 
+RC Table::vacuum(PageNum start_page, int max_pages, const std::function<bool(const char *record)> &is_dead,
+    const std::function<bool(const char *record)> &all_visible, PageNum &last_page, VacuumStat &stat) {
+  last_page = BP_INVALID_PAGE_NUM;
+
+  BufferPoolIterator bp_iterator;
+  RC rc = bp_iterator.init(*data_buffer_pool_, start_page);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init buffer pool iterator. table=%s, rc=%s", name(), strrc(rc));
+    return rc;
+  }
+
+  RecordBatch batch;
+  std::vector<char> dead_records;
+  std::vector<RID> dead_rids;
+  for (int i = 0; i < max_pages && bp_iterator.has_next(); i++) {
+    const PageNum page_num = bp_iterator.next();
+    last_page = page_num;
+    stat.scanned_pages++;
+
+    // delete_record 要加页面的写锁，所以先在读锁下把要删除的记录复制出来
+    RecordPageHandler page_handler;
+    rc = page_handler.init(*data_buffer_pool_, page_num, true /*readonly*/);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. table=%s, page num=%d, rc=%s", name(), page_num, strrc(rc));
+      return rc;
+    }
+
+    page_handler.get_records(batch);
+    const int record_size = batch.record_size();
+    dead_records.clear();
+    dead_rids.clear();
+    for (int j = 0; j < batch.size(); j++) {
+      if (is_dead(batch.data(j))) {
+        dead_records.insert(dead_records.end(), batch.data(j), batch.data(j) + record_size);
+        dead_rids.push_back(batch.rid(j));
+      }
+    }
+    const bool all_dead = !dead_rids.empty() && static_cast<int>(dead_rids.size()) == batch.size();
+    // 修改页面时要加写锁并清除标记，所以拿着读锁置位时页面上的记录不会变化
+    if (dead_rids.empty() && batch.size() > 0) {
+      bool page_all_visible = true;
+      for (int j = 0; j < batch.size() && page_all_visible; j++) {
+        page_all_visible = all_visible(batch.data(j));
+      }
+      if (page_all_visible) {
+        record_handler_->visibility_map().set_all_visible(page_num);
+      }
+    }
+    page_handler.cleanup();
+
+    // 失效的记录不会再被任何事务访问或者修改，放开页面锁之后它们也不会变化
+    for (size_t j = 0; j < dead_rids.size(); j++) {
+      Record record;
+      record.set_data(dead_records.data() + j * record_size, record_size);
+      record.set_rid(dead_rids[j]);
+      // 以前的版本创建索引时只扫描了可见的记录，已经删除的版本在这样的索引中没有索引项
+      rc = delete_record(record, false /*entry_must_exist*/);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to vacuum record. table=%s, rid=%s, rc=%s", name(), dead_rids[j].to_string().c_str(), strrc(rc));
+        return rc;
+      }
+      stat.reclaimed_rows++;
+    }
+    if (all_dead) {
+      stat.reclaimed_pages++;
+    }
+  }
+
+  if (!bp_iterator.has_next()) {
+    last_page = BP_INVALID_PAGE_NUM;
+  }
+  return RC::SUCCESS;
+}
+
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid) {
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_) {
@@ -638,62 +866,68 @@ RC Table::init_text_buffer_pool(const char *base_dir) {
     return rc;
   }
 
+  text_handler_ = new TextFileHandler();
+  rc = text_handler_->init(text_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to init text file handler. rc=%s", strrc(rc));
+    delete text_handler_;
+    text_handler_ = nullptr;
+    return rc;
+  }
+
   return rc;
 }
 
-// FIXME(zhaoyiping): 这里有个溢出
-
-const int TEXT_PAGE_SIZE = BP_PAGE_SIZE;
-const int TEXT_PAGE_MAX_NUM = TEXT_SIZE / TEXT_PAGE_SIZE + !!(TEXT_SIZE % TEXT_PAGE_SIZE);
-
-RC Table::get_text(int offset, Value &value) {
-  std::string tmp;
-  int page_num = offset / BP_PAGE_SIZE;
-  for (int i = 0; i < TEXT_SIZE / BP_PAGE_SIZE; i++) {
-    Frame *frame = nullptr;
-    RC rc = text_buffer_pool_->get_this_page(page_num + i, &frame);
-    if (rc != RC::SUCCESS)
-      return rc;
-    bool end = false;
-    for (int j = 0; j < BP_PAGE_SIZE && !end; j++) {
-      if (frame->data()[j] == 0) {
-        end = true;
-      } else {
-        tmp += frame->data()[j];
-      }
-    }
-    frame->unpin();
-    if (end)
-      break;
+RC Table::get_text(int text_id, Value &value) {
+  std::string text;
+  RC rc = text_handler_->get_text(text_id, text);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get text. table=%s, text id=%d, rc=%s", name(), text_id, strrc(rc));
+    return rc;
   }
-  value.set_text(tmp.c_str());
+  value.set_text(text.c_str());
   return RC::SUCCESS;
 }
 
-RC Table::add_text(const char *data, int &offset) {
-  int len = strlen(data) + 1;
-  if (len > TEXT_SIZE) {
+RC Table::add_text(const char *data, int &text_id) {
+  int len = strlen(data);
+  if (len >= TEXT_SIZE) {
     return RC::INVALID_ARGUMENT;
   }
-  int num = (len - 1) / BP_PAGE_SIZE + 1;
+  return text_handler_->insert_text(data, len, text_id);
+}
+
+RC Table::copy_text(int text_id, int &new_text_id) {
+  std::string text;
+  RC rc = text_handler_->get_text(text_id, text);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get text. table=%s, text id=%d, rc=%s", name(), text_id, strrc(rc));
+    return rc;
+  }
+  return text_handler_->insert_text(text.data(), static_cast<int>(text.size()), new_text_id);
+}
 
-  int ret = -1;
+RC Table::delete_text(int text_id) {
+  RC rc = text_handler_->delete_text(text_id);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to delete text. table=%s, text id=%d, rc=%s", name(), text_id, strrc(rc));
+  }
+  return rc;
+}
 
+RC Table::delete_texts(const char *record) {
   RC rc = RC::SUCCESS;
+  const FieldMeta *null_meta = table_meta_.null_field_meta();
+  const int null_flag = *reinterpret_cast<const int *>(record + null_meta->offset());
+  for (const FieldMeta &field : *table_meta_.field_metas()) {
+    if (field.type() != TEXTS || (null_flag & (1 << field.index()))) {
+      continue;
+    }
 
-  for (int i = 0; i < num; i++) {
-    Frame *frame = nullptr;
-    rc = text_buffer_pool_->allocate_page(&frame);
-    if (rc != RC::SUCCESS)
-      return rc;
-    if (ret == -1) {
-      ret = frame->page_num() * BP_PAGE_SIZE;
+    RC tmp_rc = delete_text(*reinterpret_cast<const int *>(record + field.offset()));
+    if (OB_FAIL(tmp_rc)) {
+      rc = tmp_rc;
     }
-    frame->clear_page();
-    strncpy(frame->data(), data + i * BP_PAGE_SIZE, BP_PAGE_SIZE);
-    frame->mark_dirty();
-    frame->unpin();
   }
-  offset = ret;
-  return RC::SUCCESS;
+  return rc;
 }
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/types.h"
 #include "storage/table/table_meta.h"
 #include <functional>
 #include <vector>
@@ -21,11 +22,16 @@ class Record;
 class DiskBufferPool;
 class RecordFileHandler;
 class RecordFileScanner;
+class TextFileHandler;
+class MorselDispenser;
+class ZoneFilter;
 class ConditionFilter;
 class DefaultConditionFilter;
 class Index;
 class IndexScanner;
+class BplusTreeIndex;
 class RecordDeleter;
+struct VacuumStat;
 class Trx;
 class View;
 
@@ -45,9 +51,10 @@ public:
    * @param base_dir 表数据存放的路径
    * @param attribute_count 字段个数
    * @param attributes 字段
+   * @param storage_format 记录在数据页面上的存放格式
    */
   RC create(int32_t table_id, const char *path, const char *name, const char *base_dir, int attribute_count,
-            const AttrInfoSqlNode attributes[]);
+            const AttrInfoSqlNode attributes[], StorageFormat storage_format = StorageFormat::FIXED_FORMAT);
 
   /**
    * 打开一个表
@@ -73,6 +80,14 @@ public:
    * @param record[in/out] 传入的数据包含具体的数据，插入成功会通过此字段返回RID
    */
   RC insert_record(Record &record);
+
+  /**
+   * @brief 在当前的表中批量插入记录
+   * @details 记录按页面成批写入表文件，每个索引再按照键值顺序批量插入。
+   * 任何一步失败都会把这次插入的数据全部回滚
+   * @param records[in/out] 插入成功会通过此字段返回每条记录的RID
+   */
+  RC insert_records(std::vector<Record> &records);
   RC delete_record(const Record &record);
   RC delete_record(const RID &rid);
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
@@ -80,12 +95,37 @@ public:
 
   RC recover_insert_record(Record &record);
 
-  // TODO refactor
-  RC create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const char *index_name, bool unique);
+  /**
+   * @brief 物理删除已经失效的记录
+   * @details 从 start_page 之后的页面开始，最多检查 max_pages 个页面。每个页面先在读锁下找出 is_dead 返回 true 的记录并复制出来，
+   * 放开页面之后再逐条调用 delete_record，删除索引项、释放 TEXT 并更新空闲空间表。
+   * 没有失效的记录，并且所有记录的 all_visible 都返回 true 时，在可见性映射中标记这个页面。
+   * @param is_dead     根据记录数据判断是否已经失效
+   * @param all_visible 根据记录数据判断是否对所有事务都可见
+   * @param last_page   返回最后检查的页面，下次从这里继续。检查到文件末尾时返回 BP_INVALID_PAGE_NUM
+   * @param stat        累加检查的页面个数、删除的记录条数和因此变空的页面个数
+   */
+  RC vacuum(PageNum start_page, int max_pages, const std::function<bool(const char *record)> &is_dead,
+      const std::function<bool(const char *record)> &all_visible, PageNum &last_page, VacuumStat &stat);
+
+  /**
+   * @brief 在已有的数据上创建索引
+   * @details 扫描所有记录，对键值排序之后自底向上批量构建B+树，参考 BplusTreeHandler::bulk_load_begin
+   * @param fill_factor B+树节点填充到最大容量的百分比
+   * @param include_meta 只存放在索引叶子节点上的字段，不参与比较，查询只用到索引中的字段时不用读取记录
+   */
+  RC create_index(Trx *trx, const std::vector<FieldMeta> &field_meta, const char *index_name, bool unique,
+      int fill_factor = 90, const std::vector<FieldMeta> &include_meta = {});
   RC drop_index(const char *index_name);
   RC drop_all_indexes();
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly);
+  /**
+   * @brief 打开表的记录扫描器
+   * @param morsels     并行扫描时，多个扫描器从这里领取各自需要扫描的页面
+   * @param zone_filter 用区域映射跳过不可能满足条件的页面
+   */
+  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly, MorselDispenser *morsels = nullptr,
+      const ZoneFilter *zone_filter = nullptr);
 
   RecordFileHandler *record_handler() const { return record_handler_; }
 
@@ -102,15 +142,50 @@ private:
   RC insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
 
+  /// 扫描所有记录，批量构建新创建的索引
+  RC build_index(BplusTreeIndex *index, int fill_factor);
+
+  /// 删除记录，entry_must_exist 为 false 时跳过索引中不存在的索引项
+  RC delete_record(const Record &record, bool entry_must_exist);
+
 private:
   RC init_record_handler(const char *base_dir);
 
 public:
-  RC get_text(int offset, Value &value);
-  RC add_text(const char *data, int &offset);
+  /**
+   * @brief 读取 TEXT 字段的内容
+   * @param text_id 记录中保存的 TEXT 编号
+   */
+  RC get_text(int text_id, Value &value);
+
+  /**
+   * @brief 写入 TEXT 字段的内容，返回的编号保存在记录中。每个编号只能被一条记录使用
+   */
+  RC add_text(const char *data, int &text_id);
+
+  /**
+   * @brief 把一个 TEXT 值复制一份，给另一条记录使用
+   */
+  RC copy_text(int text_id, int &new_text_id);
+
+  /**
+   * @brief 释放一个 TEXT 值占用的页面
+   */
+  RC delete_text(int text_id);
+
+  /**
+   * @brief 释放一条记录中所有不为 NULL 的 TEXT 字段，记录从表文件中删除时调用
+   */
+  RC delete_texts(const char *record);
+
+  /**
+   * @brief 从记录中取出的 TEXT 值通过它延迟读取内容
+   */
+  const TextFileHandler *text_handler() const { return text_handler_; }
 
 private:
   DiskBufferPool *text_buffer_pool_ = nullptr; /// text文件关联的buffer pool
+  TextFileHandler *text_handler_ = nullptr;    /// TEXT 字段内容的读写
   RC init_text_buffer_pool(const char *base_dir);
 
 public:
@@ -131,6 +206,8 @@ private:
   std::string base_dir_;
   TableMeta table_meta_;
   DiskBufferPool *data_buffer_pool_ = nullptr;  /// 数据文件关联的buffer pool
+  DiskBufferPool *fsm_buffer_pool_ = nullptr;   /// 空闲空间表文件关联的buffer pool
+  DiskBufferPool *zone_buffer_pool_ = nullptr;  /// 区域映射文件关联的buffer pool
   RecordFileHandler *record_handler_ = nullptr; /// 记录操作
   std::vector<Index *> indexes_;
 
@@ -25,20 +25,24 @@ static const Json::StaticString FIELD_TABLE_ID("table_id");
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_STORAGE_FORMAT("storage_format");
 
 TableMeta::TableMeta(const TableMeta &other)
-    : name_(other.name_), fields_(other.fields_), indexes_(other.indexes_), record_size_(other.record_size_),
-      table_meta_fields_(other.table_meta_fields_) {}
+    : table_id_(other.table_id_), name_(other.name_), fields_(other.fields_), indexes_(other.indexes_), record_size_(other.record_size_),
+      storage_format_(other.storage_format_), table_meta_fields_(other.table_meta_fields_) {}
 
 void TableMeta::swap(TableMeta &other) noexcept {
+  std::swap(table_id_, other.table_id_);
   name_.swap(other.name_);
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
   std::swap(record_size_, other.record_size_);
+  std::swap(storage_format_, other.storage_format_);
   table_meta_fields_.swap(other.table_meta_fields_);
 }
 
-RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[]) {
+RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+                   StorageFormat storage_format) {
   if (common::is_blank(name)) {
     LOG_ERROR("Name cannot be empty");
     return RC::INVALID_ARGUMENT;
@@ -89,6 +93,7 @@ RC TableMeta::init(int32_t table_id, const char *name, int field_num, const Attr
   }
 
   record_size_ = field_offset;
+  storage_format_ = storage_format;
 
   table_id_ = table_id;
   name_ = name;
@@ -207,6 +212,7 @@ int TableMeta::serialize(std::ostream &ss) const {
   Json::Value table_value;
   table_value[FIELD_TABLE_ID] = table_id_;
   table_value[FIELD_TABLE_NAME] = name_;
+  table_value[FIELD_STORAGE_FORMAT] = static_cast<int>(storage_format_);
 
   Json::Value fields_value;
   for (const FieldMeta &field : fields_) {
@@ -263,6 +269,19 @@ int TableMeta::deserialize(std::istream &is) {
 
   std::string table_name = table_name_value.asString();
 
+  // 早期版本的元数据中没有记录格式，都是定长记录
+  StorageFormat storage_format = StorageFormat::FIXED_FORMAT;
+  const Json::Value &storage_format_value = table_value[FIELD_STORAGE_FORMAT];
+  if (!storage_format_value.isNull()) {
+    if (!storage_format_value.isInt() ||
+        storage_format_value.asInt() <= static_cast<int>(StorageFormat::UNKNOWN_FORMAT) ||
+        storage_format_value.asInt() > static_cast<int>(StorageFormat::PAX_FORMAT)) {
+      LOG_ERROR("Invalid storage format. json value=%s", storage_format_value.toStyledString().c_str());
+      return -1;
+    }
+    storage_format = static_cast<StorageFormat>(storage_format_value.asInt());
+  }
+
   const Json::Value &fields_value = table_value[FIELD_FIELDS];
   if (!fields_value.isArray() || fields_value.size() <= 0) {
     LOG_ERROR("Invalid table meta. fields is not array, json value=%s", fields_value.toStyledString().c_str());
@@ -294,6 +313,7 @@ int TableMeta::deserialize(std::istream &is) {
 
   table_id_ = table_id;
   name_.swap(table_name);
+  storage_format_ = storage_format;
   fields_.swap(fields);
   record_size_ = fields_.back().offset() + fields_.back().len() - fields_.begin()->offset();
 
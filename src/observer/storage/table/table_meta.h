@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/serializable.h"
 #include "common/rc.h"
+#include "common/types.h"
 #include "storage/field/field_meta.h"
 #include "storage/index/index_meta.h"
 
@@ -33,7 +34,8 @@ public:
 
   void swap(TableMeta &other) noexcept;
 
-  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[]);
+  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+          StorageFormat storage_format = StorageFormat::FIXED_FORMAT);
 
   RC add_index(const IndexMeta &index);
 
@@ -62,6 +64,7 @@ public:
   int index_num() const;
 
   int record_size() const;
+  StorageFormat storage_format() const { return storage_format_; }
 
 public:
   int serialize(std::ostream &os) const override;
@@ -80,4 +83,5 @@ protected:
   std::vector<IndexMeta> indexes_;
 
   int record_size_ = 0;
+  StorageFormat storage_format_ = StorageFormat::FIXED_FORMAT; ///< 记录在数据页面上的存放格式
 };
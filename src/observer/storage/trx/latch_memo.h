@@ -65,6 +65,11 @@ public:
 
   void release_to(int point);
 
+  /**
+   * @brief 与release_to相反，释放point之后加的锁和pin
+   */
+  void release_from(int point);
+
   int memo_point() const { return static_cast<int>(items_.size()); }
 
 private:
@@ -43,6 +43,34 @@ int32_t MvccTrxKit::next_trx_id() { return ++current_trx_id_; }
 
 int32_t MvccTrxKit::max_trx_id() const { return numeric_limits<int32_t>::max(); }
 
+int32_t MvccTrxKit::start_trx() {
+  // 分配和登记要在同一把锁下完成，否则计算最老的活跃事务时可能漏掉刚分配了事务号的事务
+  lock_.lock();
+  const int32_t trx_id = ++current_trx_id_;
+  active_trx_ids_.insert(trx_id);
+  lock_.unlock();
+  return trx_id;
+}
+
+void MvccTrxKit::trx_started(int32_t trx_id) {
+  lock_.lock();
+  active_trx_ids_.insert(trx_id);
+  lock_.unlock();
+}
+
+void MvccTrxKit::trx_finished(int32_t trx_id) {
+  lock_.lock();
+  active_trx_ids_.erase(trx_id);
+  lock_.unlock();
+}
+
+int32_t MvccTrxKit::oldest_active_trx_id() {
+  lock_.lock();
+  const int32_t oldest = active_trx_ids_.empty() ? current_trx_id_ + 1 : *active_trx_ids_.begin();
+  lock_.unlock();
+  return oldest;
+}
+
 Trx *MvccTrxKit::create_trx(CLogManager *log_manager) {
   Trx *trx = new MvccTrx(*this, log_manager);
   if (trx != nullptr) {
@@ -105,9 +133,14 @@ MvccTrx::MvccTrx(MvccTrxKit &kit, CLogManager *log_manager) : trx_kit_(kit), log
 MvccTrx::MvccTrx(MvccTrxKit &kit, int32_t trx_id) : trx_kit_(kit), trx_id_(trx_id) {
   started_ = true;
   recovering_ = true;
+  trx_kit_.trx_started(trx_id_);
 }
 
-MvccTrx::~MvccTrx() {}
+MvccTrx::~MvccTrx() {
+  if (started_) {
+    trx_kit_.trx_finished(trx_id_);
+  }
+}
 
 RC MvccTrx::insert_record(Table *table, Record &record) {
   Field begin_field;
@@ -132,6 +165,47 @@ RC MvccTrx::insert_record(Table *table, Record &record) {
   return rc;
 }
 
+RC MvccTrx::insert_records(Table *table, std::vector<Record> &records) {
+  if (records.empty()) {
+    return RC::SUCCESS;
+  }
+
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  for (Record &record : records) {
+    begin_field.set_int(record, -trx_id_);
+    end_field.set_int(record, trx_kit_.max_trx_id());
+  }
+
+  RC rc = table->insert_records(records);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records into table. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 日志数据是 RID 和记录数据依次排列，记录长度从表的元数据中获取
+  const int record_size = table->table_meta().record_size();
+  const int item_size = static_cast<int>(sizeof(RID)) + record_size;
+  vector<char> log_data(records.size() * item_size);
+  for (size_t i = 0; i < records.size(); i++) {
+    char *item = log_data.data() + i * item_size;
+    memcpy(item, &records[i].rid(), sizeof(RID));
+    memcpy(item + sizeof(RID), records[i].data(), record_size);
+  }
+
+  rc = log_manager_->append_log(CLogType::INSERT_BATCH, trx_id_, table->table_id(), records.front().rid(),
+                                static_cast<int32_t>(log_data.size()), 0 /*offset*/, log_data.data());
+  ASSERT(rc == RC::SUCCESS, "failed to append insert batch log. trx id=%d, table id=%d, record num=%d, rc=%s",
+         trx_id_, table->table_id(), static_cast<int>(records.size()), strrc(rc));
+
+  for (const Record &record : records) {
+    insert_operation(Operation(Operation::Type::INSERT, table, record.rid()));
+  }
+  return rc;
+}
+
 RC MvccTrx::delete_record(Table *table, Record &record) {
   Field begin_field;
   Field end_field;
@@ -147,8 +221,16 @@ RC MvccTrx::delete_record(Table *table, Record &record) {
     return RC::RECORD_DELETED;
   }
 
+  // 扫描出来的记录不一定指向页面上的内存(比如变长记录)，通过 visit_record 修改页面上的数据
   end_field.set_int(record, -trx_id_);
-  RC rc = log_manager_->append_log(CLogType::DELETE, trx_id_, table->table_id(), record.rid(), 0, 0, nullptr);
+  auto record_updater = [this, &end_field](Record &inplace_record) { end_field.set_int(inplace_record, -trx_id_); };
+  RC rc = table->visit_record(record.rid(), false /*readonly*/, record_updater);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to mark record deleted. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  rc = log_manager_->append_log(CLogType::DELETE, trx_id_, table->table_id(), record.rid(), 0, 0, nullptr);
   ASSERT(rc == RC::SUCCESS, "failed to append delete record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
          trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
 
@@ -170,9 +252,41 @@ RC MvccTrx::visit_record(Table *table, Record &record, bool readonly) {
   Field end_field;
   trx_fields(table, begin_field, end_field);
 
-  int32_t begin_xid = begin_field.get_int(record);
-  int32_t end_xid = end_field.get_int(record);
+  return check_visibility(begin_field.get_int(record), end_field.get_int(record), readonly);
+}
 
+RC MvccTrx::visit_records(Table *table, RecordBatch &batch, bool readonly) {
+  const std::pair<const FieldMeta *, int> trx_fields = table->table_meta().trx_fields();
+  ASSERT(trx_fields.second >= 2, "invalid trx fields number. %d", trx_fields.second);
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+
+  for (int i = 0; i < batch.size(); i++) {
+    const char *data = batch.data(i);
+    int32_t begin_xid = 0;
+    int32_t end_xid = 0;
+    memcpy(&begin_xid, data + begin_offset, sizeof(begin_xid));
+    memcpy(&end_xid, data + end_offset, sizeof(end_xid));
+
+    RC rc = check_visibility(begin_xid, end_xid, readonly);
+    if (rc == RC::RECORD_INVISIBLE) {
+      batch.set_invisible(i);
+    } else if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+bool MvccTrx::visible_without_record(Table *table, const RID &rid, bool readonly) {
+  // 置位的页面上的记录早于所有活跃的事务提交，并且没有被删除。还没有开始的事务没有事务号，要按照记录判断
+  if (!readonly || !started_) {
+    return false;
+  }
+  return table->record_handler()->visibility_map().all_visible(rid.page_num);
+}
+
+RC MvccTrx::check_visibility(int32_t begin_xid, int32_t end_xid, bool readonly) const {
   RC rc = RC::SUCCESS;
   if (begin_xid > 0 && end_xid > 0) {
     if (trx_id_ >= begin_xid && trx_id_ <= end_xid) {
@@ -222,7 +336,7 @@ void MvccTrx::trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_fi
 RC MvccTrx::start_if_need() {
   if (!started_) {
     ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
-    trx_id_ = trx_kit_.next_trx_id();
+    trx_id_ = trx_kit_.start_trx();
     LOG_DEBUG("current thread change to new trx with %d", trx_id_);
     RC rc = log_manager_->begin_trx(trx_id_);
     ASSERT(rc == RC::SUCCESS, "failed to append log to clog. rc=%s", strrc(rc));
@@ -292,6 +406,7 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid) {
   }
 
   operations_.clear();
+  trx_kit_.trx_finished(trx_id_);
 
   if (!recovering_) {
     rc = log_manager_->commit_trx(trx_id_, commit_xid);
@@ -351,6 +466,7 @@ RC MvccTrx::rollback() {
   }
 
   operations_.clear();
+  trx_kit_.trx_finished(trx_id_);
 
   if (!recovering_) {
     rc = log_manager_->rollback_trx(trx_id_);
@@ -362,6 +478,7 @@ RC MvccTrx::rollback() {
 RC find_table(Db *db, const CLogRecord &log_record, Table *&table) {
   switch (clog_type_from_integer(log_record.header().type_)) {
   case CLogType::INSERT:
+  case CLogType::INSERT_BATCH:
   case CLogType::DELETE: {
     const CLogRecordData &data_record = log_record.data_record();
     table = db->find_table(data_record.table_id_);
@@ -400,6 +517,28 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record) {
     insert_operation(Operation(Operation::Type::INSERT, table, record.rid()));
   } break;
 
+  case CLogType::INSERT_BATCH: {
+    const CLogRecordData &data_record = log_record.data_record();
+    const int record_size = table->table_meta().record_size();
+    const int item_size = static_cast<int>(sizeof(RID)) + record_size;
+    ASSERT(data_record.data_len_ % item_size == 0, "invalid insert batch log. record size=%d, log record=%s",
+           record_size, log_record.to_string().c_str());
+
+    for (int offset = 0; offset < data_record.data_len_; offset += item_size) {
+      const char *item = data_record.data_ + offset;
+      Record record;
+      record.set_data(const_cast<char *>(item + sizeof(RID)), record_size);
+      record.set_rid(*reinterpret_cast<const RID *>(item));
+      RC rc = table->recover_insert_record(record);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to recover insert batch. table=%s, rid=%s, log record=%s, rc=%s", table->name(),
+                 record.rid().to_string().c_str(), log_record.to_string().c_str(), strrc(rc));
+        return rc;
+      }
+      insert_operation(Operation(Operation::Type::INSERT, table, record.rid()));
+    }
+  } break;
+
   case CLogType::DELETE: {
     const CLogRecordData &data_record = log_record.data_record();
     Field begin_field;
@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <set>
 #include <vector>
 
 #include "storage/trx/trx.h"
@@ -40,6 +41,28 @@ public:
 public:
   int32_t max_trx_id() const;
 
+  /**
+   * @brief 给开始的事务分配事务号，同时登记为活跃事务
+   */
+  int32_t start_trx();
+
+  /**
+   * @brief 登记一个已经有事务号的活跃事务，恢复时使用
+   */
+  void trx_started(int32_t trx_id);
+
+  /**
+   * @brief 事务提交或回滚之后，从活跃事务中去掉
+   */
+  void trx_finished(int32_t trx_id);
+
+  /**
+   * @brief 最老的活跃事务号，没有活跃事务时返回下一个将要分配的事务号
+   * @details 提交事务号比它小的删除，对所有活跃事务和之后开始的事务都已经生效，
+   * 被删除的版本不会再被任何事务看到，可以由 Vacuum 物理删除
+   */
+  int32_t oldest_active_trx_id();
+
 private:
   std::vector<FieldMeta> fields_; // 存储事务数据需要用到的字段元数据，所有表结构都需要带的
 
@@ -47,12 +70,13 @@ private:
 
   common::Mutex lock_;
   std::vector<Trx *> trxes_;
+  std::set<int32_t> active_trx_ids_; ///< 已经开始还没有结束的事务，也由 lock_ 保护
 };
 
 /**
  * @brief 多版本并发事务
  * @ingroup Transaction
- * TODO 没有垃圾回收
+ * @details 删除只是在记录上设置 end_xid，更新是删除加插入，旧版本由后台的 Vacuum 清理
  */
 class MvccTrx : public Trx {
 public:
@@ -61,6 +85,12 @@ public:
   virtual ~MvccTrx();
 
   RC insert_record(Table *table, Record &record) override;
+
+  /**
+   * @brief 批量插入记录
+   * @details 所有记录写入表和索引之后，只追加一条 INSERT_BATCH 日志
+   */
+  RC insert_records(Table *table, std::vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
 
   /**
@@ -75,6 +105,17 @@ public:
    */
   RC visit_record(Table *table, Record &record, bool readonly) override;
 
+  /**
+   * @brief 一次检查整个页面上记录的可见性
+   * @details 事务字段的偏移只取一次，直接从记录数据中读取事务号，不用每条记录都构造 Field
+   */
+  RC visit_records(Table *table, RecordBatch &batch, bool readonly) override;
+
+  /**
+   * @brief 只读访问时，记录所在的页面在可见性映射中置位就不用读取记录
+   */
+  bool visible_without_record(Table *table, const RID &rid, bool readonly) override;
+
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -85,6 +126,11 @@ public:
 
 private:
   RC commit_with_trx_id(int32_t commit_id);
+
+  /**
+   * @brief 根据记录上的 begin/end 事务号判断可见性，参考 visit_record
+   */
+  RC check_visibility(int32_t begin_xid, int32_t end_xid, bool readonly) const;
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
 private:
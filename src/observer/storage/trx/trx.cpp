@@ -57,4 +57,28 @@ RC TrxKit::init_global(const char *name) {
 
 TrxKit *TrxKit::instance() { return global_trxkit; }
 
+RC Trx::insert_records(Table *table, std::vector<Record> &records) {
+  for (Record &record : records) {
+    RC rc = insert_record(table, record);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC Trx::visit_records(Table *table, RecordBatch &batch, bool readonly) {
+  Record record;
+  for (int i = batch.next_visible(0); i >= 0; i = batch.next_visible(i + 1)) {
+    batch.get_record(i, record);
+    RC rc = visit_record(table, record, readonly);
+    if (rc == RC::RECORD_INVISIBLE) {
+      batch.set_invisible(i);
+    } else if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC Trx::redo(Db *db, const CLogRecord &) { return RC::UNIMPLENMENT; }
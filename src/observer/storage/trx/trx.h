@@ -128,6 +128,12 @@ public:
   virtual ~Trx() = default;
 
   virtual RC insert_record(Table *table, Record &record) = 0;
+
+  /**
+   * @brief 批量插入记录
+   * @details 默认实现是逐条调用 insert_record
+   */
+  virtual RC insert_records(Table *table, std::vector<Record> &records);
   virtual RC delete_record(Table *table, Record &record) = 0;
   virtual RC delete_record(Table *table, const RID &rid) {
     Record record;
@@ -138,6 +144,20 @@ public:
   }
   virtual RC visit_record(Table *table, Record &record, bool readonly) = 0;
 
+  /**
+   * @brief 一次检查一个页面上一批记录的可见性
+   * @details 不可见的记录会清除 batch 中对应的可见位。默认实现是逐条调用 visit_record，
+   * 遇到访问冲突等其它错误时直接返回
+   */
+  virtual RC visit_records(Table *table, RecordBatch &batch, bool readonly);
+
+  /**
+   * @brief 不读取记录能否确定这条记录对当前事务可见
+   * @details 只扫描索引就能得到结果时使用，返回 false 时还要读取记录，再调用 visit_record。
+   * 默认实现用于不在记录上保存版本信息的事务，索引中的记录总是可见
+   */
+  virtual bool visible_without_record(Table *table, const RID &rid, bool readonly) { return true; }
+
   virtual RC start_if_need() = 0;
   virtual RC commit() = 0;
   virtual RC rollback() = 0;
@@ -31,10 +31,14 @@ void VacuousTrxKit::all_trxes(std::vector<Trx *> &trxes) { return; }
 
 RC VacuousTrx::insert_record(Table *table, Record &record) { return table->insert_record(record); }
 
+RC VacuousTrx::insert_records(Table *table, std::vector<Record> &records) { return table->insert_records(records); }
+
 RC VacuousTrx::delete_record(Table *table, Record &record) { return table->delete_record(record); }
 
 RC VacuousTrx::visit_record(Table *table, Record &record, bool readonly) { return RC::SUCCESS; }
 
+RC VacuousTrx::visit_records(Table *table, RecordBatch &batch, bool readonly) { return RC::SUCCESS; }
+
 RC VacuousTrx::start_if_need() { return RC::SUCCESS; }
 
 RC VacuousTrx::commit() { return RC::SUCCESS; }
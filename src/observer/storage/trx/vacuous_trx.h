@@ -37,8 +37,10 @@ public:
   virtual ~VacuousTrx() = default;
 
   RC insert_record(Table *table, Record &record) override;
+  RC insert_records(Table *table, std::vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
   RC visit_record(Table *table, Record &record, bool readonly) override;
+  RC visit_records(Table *table, RecordBatch &batch, bool readonly) override;
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -0,0 +1,228 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string.h>
+
+#include "common/log/log.h"
+#include "common/metrics/metrics.h"
+#include "common/metrics/metrics_registry.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/vacuum.h"
+
+using namespace std;
+using namespace common;
+
+static const char *SCANNED_PAGES_METRIC = "trx.vacuum.scanned_pages";
+static const char *RECLAIMED_ROWS_METRIC = "trx.vacuum.reclaimed_rows";
+static const char *RECLAIMED_PAGES_METRIC = "trx.vacuum.reclaimed_pages";
+
+static long current_time_ms() {
+  return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static Counter &scanned_pages_counter() {
+  static Counter &counter = register_counter(SCANNED_PAGES_METRIC);
+  return counter;
+}
+
+static Counter &reclaimed_rows_counter() {
+  static Counter &counter = register_counter(RECLAIMED_ROWS_METRIC);
+  return counter;
+}
+
+static Counter &reclaimed_pages_counter() {
+  static Counter &counter = register_counter(RECLAIMED_PAGES_METRIC);
+  return counter;
+}
+
+long Vacuum::scanned_pages() { return scanned_pages_counter().value(); }
+long Vacuum::reclaimed_rows() { return reclaimed_rows_counter().value(); }
+long Vacuum::reclaimed_pages() { return reclaimed_pages_counter().value(); }
+
+Vacuum::Vacuum(MvccTrxKit &trx_kit) : trx_kit_(trx_kit) {
+  (void)scanned_pages_counter();
+  (void)reclaimed_rows_counter();
+  (void)reclaimed_pages_counter();
+}
+
+Vacuum::~Vacuum() { stop(); }
+
+void Vacuum::add_db(Db *db) {
+  lock_guard<mutex> round_guard(round_lock_);
+  dbs_.push_back(db);
+}
+
+RC Vacuum::start(const VacuumOptions &options) {
+  stop();
+
+  options_ = options;
+  tokens_ = 0;
+  last_refill_ms_ = current_time_ms();
+
+  if (options_.interval_ms <= 0) {
+    LOG_INFO("vacuum is disabled");
+    return RC::SUCCESS;
+  }
+
+#ifndef CONCURRENCY
+  // 没有开启并发编译选项时，页帧的读写锁什么都不做，后台线程删除记录时可能与其它线程冲突
+  LOG_WARN("vacuum thread requires CONCURRENCY, it will not be started");
+  return RC::SUCCESS;
+#endif
+
+  running_ = true;
+  thread_ = thread(&Vacuum::run, this);
+  LOG_INFO("vacuum started. interval=%dms, max pages per second=%d", options_.interval_ms,
+           options_.max_pages_per_second);
+  return RC::SUCCESS;
+}
+
+void Vacuum::stop() {
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  LOG_INFO("vacuum stopped");
+}
+
+void Vacuum::run() {
+  unique_lock<mutex> lock(lock_);
+  while (running_) {
+    cond_.wait_for(lock, chrono::milliseconds(options_.interval_ms), [this]() { return !running_; });
+    if (!running_) {
+      break;
+    }
+
+    lock.unlock();
+    vacuum_once();
+    lock.lock();
+  }
+}
+
+int Vacuum::vacuum_once() {
+  lock_guard<mutex> round_guard(round_lock_);
+
+  int budget = numeric_limits<int>::max();
+  if (options_.max_pages_per_second > 0) {
+    const long now = current_time_ms();
+    tokens_ = min(tokens_ + (now - last_refill_ms_) * options_.max_pages_per_second / 1000.0,
+                  static_cast<double>(options_.max_pages_per_second));
+    last_refill_ms_ = now;
+    budget = static_cast<int>(tokens_);
+  }
+
+  // 每轮只取一次，这一轮中开始的事务事务号都比它大，看不到提交事务号比它小的删除之前的版本
+  const int32_t horizon = trx_kit_.oldest_active_trx_id();
+  VacuumStat stat;
+  while (stat.scanned_pages < budget && cursor_db_ < dbs_.size()) {
+    if (!vacuum_next_table(dbs_[cursor_db_], horizon, budget - stat.scanned_pages, stat)) {
+      cursor_db_++;
+      cursor_table_.clear();
+      cursor_page_ = 0;
+    }
+  }
+
+  if (options_.max_pages_per_second > 0) {
+    tokens_ = max(tokens_ - stat.scanned_pages, 0.0);
+  }
+
+  scanned_pages_counter().inc(stat.scanned_pages);
+  reclaimed_rows_counter().inc(stat.reclaimed_rows);
+  reclaimed_pages_counter().inc(stat.reclaimed_pages);
+  pass_rows_ += stat.reclaimed_rows;
+  pass_pages_ += stat.reclaimed_pages;
+
+  if (cursor_db_ >= dbs_.size()) {
+    // 所有的表都检查过一遍了，下一轮从头开始
+    if (pass_rows_ > 0) {
+      LOG_INFO("vacuum pass done. reclaimed rows=%ld, reclaimed pages=%ld", pass_rows_, pass_pages_);
+    }
+    cursor_db_ = 0;
+    pass_rows_ = 0;
+    pass_pages_ = 0;
+  }
+  return stat.reclaimed_rows;
+}
+
+bool Vacuum::vacuum_next_table(Db *db, int32_t horizon, int max_pages, VacuumStat &stat) {
+  // 持有这把锁时不会创建或者删除表
+  lock_guard<mutex> table_guard(db->table_lock());
+
+  vector<string> table_names;
+  db->all_tables(table_names);
+  sort(table_names.begin(), table_names.end());
+
+  // 游标指向的表清理完了或者已经被删除了，都从下一张表开始
+  auto iter = (cursor_page_ == BP_INVALID_PAGE_NUM)
+                  ? upper_bound(table_names.begin(), table_names.end(), cursor_table_)
+                  : lower_bound(table_names.begin(), table_names.end(), cursor_table_);
+  if (iter == table_names.end()) {
+    return false;
+  }
+  if (*iter != cursor_table_) {
+    cursor_table_ = *iter;
+    cursor_page_ = 0;
+  }
+
+  Table *table = db->find_table(cursor_table_.c_str());
+  const pair<const FieldMeta *, int> trx_fields = table->table_meta().trx_fields();
+  if (table->view() != nullptr || trx_fields.second < 2) {
+    cursor_page_ = BP_INVALID_PAGE_NUM;
+    return true;
+  }
+
+  const int begin_offset = trx_fields.first[0].offset();
+  const int end_offset = trx_fields.first[1].offset();
+  const int32_t max_trx_id = trx_kit_.max_trx_id();
+  auto is_dead = [begin_offset, end_offset, horizon, max_trx_id](const char *record) {
+    int32_t begin_xid = 0;
+    int32_t end_xid = 0;
+    memcpy(&begin_xid, record + begin_offset, sizeof(begin_xid));
+    memcpy(&end_xid, record + end_offset, sizeof(end_xid));
+    if (end_xid > 0) {
+      // 删除已经提交
+      return end_xid != max_trx_id && end_xid < horizon;
+    }
+    // 同一个事务插入之后又删除，提交或回滚时都不会修改这条记录
+    return begin_xid < 0 && end_xid == begin_xid && -end_xid < horizon;
+  };
+
+  // 插入早于所有活跃的事务提交，并且没有被删除，对现在和以后的事务都可见
+  auto all_visible = [begin_offset, end_offset, horizon, max_trx_id](const char *record) {
+    int32_t begin_xid = 0;
+    int32_t end_xid = 0;
+    memcpy(&begin_xid, record + begin_offset, sizeof(begin_xid));
+    memcpy(&end_xid, record + end_offset, sizeof(end_xid));
+    return begin_xid > 0 && begin_xid < horizon && end_xid == max_trx_id;
+  };
+
+  PageNum last_page = BP_INVALID_PAGE_NUM;
+  RC rc = table->vacuum(cursor_page_, max_pages, is_dead, all_visible, last_page, stat);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to vacuum table, skip it. db=%s, table=%s, rc=%s", db->name(), table->name(), strrc(rc));
+    last_page = BP_INVALID_PAGE_NUM;
+  }
+  cursor_page_ = last_page;
+  return true;
+}
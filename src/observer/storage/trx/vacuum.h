@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+
+class Db;
+class MvccTrxKit;
+
+/**
+ * @brief 后台清理旧版本线程的参数
+ * @ingroup Transaction
+ */
+struct VacuumOptions {
+  int interval_ms = 1000;          ///< 两轮清理之间的间隔。小于等于0表示不启动后台线程
+  int max_pages_per_second = 1000; ///< 每秒最多检查多少个数据页面。小于等于0表示不限制
+};
+
+/**
+ * @brief 清理一批页面的结果
+ * @ingroup Transaction
+ */
+struct VacuumStat {
+  int scanned_pages = 0;   ///< 检查的页面个数
+  int reclaimed_rows = 0;  ///< 物理删除的记录条数
+  int reclaimed_pages = 0; ///< 因为清理而变空的页面个数
+};
+
+/**
+ * @brief 清理 MVCC 留下的旧版本
+ * @ingroup Transaction
+ * @details MvccTrx 删除记录时只是在记录上设置 end_xid，更新是删除加插入，这些旧版本会一直留在页面上，
+ * 表文件越来越大，扫描时还要逐条检查它们的可见性。
+ *
+ * Vacuum 逐个页面检查表中的记录，删除提交事务号小于最老活跃事务号的记录(参考 MvccTrxKit::oldest_active_trx_id)，
+ * 这些版本不会再被任何事务看到。同一个事务插入之后又删除的记录永远不可见，事务结束之后也一起清理。
+ * 清理调用 Table::delete_record 物理删除记录，同时删除索引项、释放 TEXT 并更新空闲空间表，空出来的位置可以被新记录复用。
+ * 与事务回滚时删除插入的记录一样，物理删除不记录日志。
+ *
+ * 每轮从上一轮停下的位置继续，检查的页面个数按照 max_pages_per_second 限速，遍历完所有的表之后从头开始。
+ *
+ * 统计信息注册在 common::get_metrics_registry() 中：
+ * - trx.vacuum.scanned_pages 检查的页面个数
+ * - trx.vacuum.reclaimed_rows 物理删除的记录条数
+ * - trx.vacuum.reclaimed_pages 因为清理而变空的页面个数
+ */
+class Vacuum {
+public:
+  explicit Vacuum(MvccTrxKit &trx_kit);
+  ~Vacuum();
+
+  /**
+   * @brief 添加需要清理的数据库
+   * @details 要在启动后台线程之前添加，数据库要在 Vacuum 停止之后才能关闭
+   */
+  void add_db(Db *db);
+
+  RC start(const VacuumOptions &options);
+  void stop();
+
+  /**
+   * @brief 执行一轮清理
+   * @details 后台线程会定期调用，也可以直接调用
+   * @return 本轮删除了多少条记录
+   */
+  int vacuum_once();
+
+  const VacuumOptions &options() const { return options_; }
+
+  /// 检查的页面个数
+  static long scanned_pages();
+  /// 物理删除的记录条数
+  static long reclaimed_rows();
+  /// 因为清理而变空的页面个数
+  static long reclaimed_pages();
+
+private:
+  void run();
+
+  /**
+   * @brief 从游标的位置继续清理当前数据库中的下一张表
+   * @return 当前数据库中的表都清理完时返回 false
+   */
+  bool vacuum_next_table(Db *db, int32_t horizon, int max_pages, VacuumStat &stat);
+
+private:
+  MvccTrxKit &trx_kit_;
+  VacuumOptions options_;
+  std::vector<Db *> dbs_;
+
+  /// 游标：正在清理的数据库、表和上次检查到的页面。cursor_page_ 为 BP_INVALID_PAGE_NUM 表示这张表已经清理完
+  size_t cursor_db_ = 0;
+  std::string cursor_table_;
+  PageNum cursor_page_ = 0;
+
+  long pass_rows_ = 0;  ///< 这一遍已经删除的记录条数
+  long pass_pages_ = 0; ///< 这一遍已经变空的页面个数
+
+  double tokens_ = 0; ///< 限速用的令牌，每个令牌可以检查一个页面
+  long last_refill_ms_ = 0;
+
+  std::mutex round_lock_;
+
+  std::mutex lock_;
+  std::condition_variable cond_;
+  bool running_ = false;
+  std::thread thread_;
+};
@@ -67,6 +67,40 @@ TEST(test_bitmap, test_bitmap)
   ASSERT_EQ(16, bitmap3.next_setted_bit(8));
 }
 
+TEST(test_bitmap, test_next_bit_by_word)
+{
+  // 位数不是64的倍数，按字查找时最后一个字只有一部分是有效的
+  const int size = 1000;
+  char buf[size / 8];
+  memset(buf, 0, sizeof(buf));
+  Bitmap bitmap(buf, size);
+
+  const int setted[] = {0, 1, 63, 64, 65, 127, 128, 500, 511, 512, 998, 999};
+  for (int index : setted) {
+    bitmap.set_bit(index);
+  }
+
+  for (int start = 0; start <= size; start++) {
+    int expect_setted = -1;
+    int expect_unsetted = -1;
+    for (int i = start; i < size; i++) {
+      if (expect_setted < 0 && bitmap.get_bit(i)) {
+        expect_setted = i;
+      }
+      if (expect_unsetted < 0 && !bitmap.get_bit(i)) {
+        expect_unsetted = i;
+      }
+    }
+    ASSERT_EQ(expect_setted, bitmap.next_setted_bit(start));
+    ASSERT_EQ(expect_unsetted, bitmap.next_unsetted_bit(start));
+  }
+
+  memset(buf, -1, sizeof(buf));
+  ASSERT_EQ(-1, bitmap.next_unsetted_bit(0));
+  bitmap.clear_bit(999);
+  ASSERT_EQ(999, bitmap.next_unsetted_bit(0));
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
@@ -12,6 +12,13 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021
 //
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "storage/buffer/disk_buffer_pool.h"
 #include "gtest/gtest.h"
 
@@ -125,6 +132,556 @@ TEST(test_frame_manager, test_frame_manager_simple_lru)
   frame_manager.cleanup();
 }
 
+TEST(test_frame_manager, test_frame_manager_replacers)
+{
+  for (const char *replacer : {"lru", "clock", "2q", "lru-k"}) {
+    BPFrameManager frame_manager("Test");
+    ASSERT_EQ(RC::SUCCESS, frame_manager.init(2, 1, replacer));
+    ASSERT_STREQ(replacer, frame_manager.replacer_name());
+
+    test_get(frame_manager);
+
+    test_alloc(frame_manager);
+
+    // test_alloc 结束时还持有页面，find_list 又加了一次引用
+    for (Frame *frame : frame_manager.find_list(0)) {
+      frame->unpin();
+      ASSERT_EQ(RC::SUCCESS, frame_manager.free(0, frame->page_num(), frame));
+    }
+    ASSERT_EQ(RC::SUCCESS, frame_manager.cleanup());
+  }
+
+  BPFrameManager frame_manager("Test");
+  ASSERT_EQ(RC::INVALID_ARGUMENT, frame_manager.init(1, 1, "fifo"));
+}
+
+/**
+ * 访问一个页面，不在内存中时淘汰一个页面再加载
+ * @return 是否命中
+ */
+bool touch_page(BPFrameManager &frame_manager, int file_desc, PageNum page_num)
+{
+  Frame *frame = frame_manager.get(file_desc, page_num);
+  const bool hit = frame != nullptr;
+  while (frame == nullptr) {
+    frame = frame_manager.alloc(file_desc, page_num);
+    if (frame == nullptr) {
+      frame_manager.purge_frames(1, [](Frame *) { return RC::SUCCESS; });
+    }
+  }
+  frame->unpin();
+  return hit;
+}
+
+TEST(test_frame_manager, test_frame_manager_scan_resistant)
+{
+  const int file_desc = 0;
+  for (const char *replacer : {"lru", "2q", "lru-k"}) {
+    BPFrameManager frame_manager("Test");
+    ASSERT_EQ(RC::SUCCESS, frame_manager.init(1, 1, replacer));
+
+    const PageNum total = static_cast<PageNum>(frame_manager.total_frame_num());
+    const PageNum hot_num = total / 8;
+    PageNum cold_page = hot_num;
+
+    // 热点页面反复访问，中间穿插少量只访问一次的页面，让内存充分地被使用
+    for (int round = 0; round < 16; round++) {
+      for (PageNum page_num = 0; page_num < hot_num; page_num++) {
+        touch_page(frame_manager, file_desc, page_num);
+      }
+      for (PageNum i = 0; i < total / 4; i++) {
+        touch_page(frame_manager, file_desc, cold_page++);
+      }
+    }
+
+    // 一次比内存大得多的顺序扫描
+    for (PageNum i = 0; i < total * 2; i++) {
+      touch_page(frame_manager, file_desc, cold_page++);
+    }
+
+    int hot_hit = 0;
+    for (PageNum page_num = 0; page_num < hot_num; page_num++) {
+      Frame *frame = frame_manager.get(file_desc, page_num);
+      if (frame != nullptr) {
+        hot_hit++;
+        frame->unpin();
+      }
+    }
+
+    if (0 == strcmp(replacer, "lru")) {
+      ASSERT_EQ(0, hot_hit) << replacer;
+    } else {
+      ASSERT_EQ(hot_num, hot_hit) << replacer;
+    }
+
+    for (Frame *frame : frame_manager.find_list(file_desc)) {
+      frame_manager.free(file_desc, frame->page_num(), frame);
+    }
+    ASSERT_EQ(RC::SUCCESS, frame_manager.cleanup());
+  }
+}
+
+TEST(test_frame_manager, test_frame_manager_sharded)
+{
+  const int shard_num = 4;
+  BPFrameManager frame_manager("Test");
+  ASSERT_EQ(RC::SUCCESS, frame_manager.init(1, shard_num));
+  ASSERT_EQ(static_cast<size_t>(shard_num), frame_manager.shard_num());
+
+  // 所有的页面都落在同一个分片上，这个分片的空闲页帧用完后要能从其它分片借用
+  const int file_desc = 0;
+  const size_t total = frame_manager.total_frame_num();
+  std::vector<Frame *> frames;
+  for (size_t i = 0; i < total; i++) {
+    Frame *frame = frame_manager.alloc(file_desc, static_cast<PageNum>(i * shard_num));
+    ASSERT_NE(frame, nullptr);
+    frame->set_file_desc(file_desc);
+    frames.push_back(frame);
+  }
+  ASSERT_EQ(nullptr, frame_manager.alloc(file_desc, static_cast<PageNum>(total * shard_num)));
+  ASSERT_EQ(total, frame_manager.frame_num());
+
+  for (Frame *frame : frames) {
+    frame->unpin();
+  }
+  int purged = frame_manager.purge_frames(2, [](Frame *) { return RC::SUCCESS; });
+  ASSERT_EQ(2, purged);
+  ASSERT_EQ(total - 2, frame_manager.frame_num());
+
+  std::list<Frame *> frame_list = frame_manager.find_list(file_desc);
+  for (Frame *frame : frame_list) {
+    ASSERT_EQ(RC::SUCCESS, frame_manager.free(file_desc, frame->page_num(), frame));
+  }
+  ASSERT_EQ(0u, frame_manager.frame_num());
+  ASSERT_EQ(RC::SUCCESS, frame_manager.cleanup());
+}
+
+TEST(test_frame_manager, test_frame_manager_concurrency)
+{
+  BPFrameManager frame_manager("Test");
+  ASSERT_EQ(RC::SUCCESS, frame_manager.init(4, 8));
+
+  const int thread_num = 8;
+  const int page_num_per_thread = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&frame_manager, t]() {
+      const int file_desc = t;
+      for (int i = 0; i < page_num_per_thread; i++) {
+        Frame *frame = frame_manager.alloc(file_desc, i);
+        while (frame == nullptr) {
+          frame_manager.purge_frames(1, [](Frame *) { return RC::SUCCESS; });
+          frame = frame_manager.alloc(file_desc, i);
+        }
+        frame->set_file_desc(file_desc);
+        frame->unpin();
+
+        Frame *got = frame_manager.get(file_desc, i);
+        if (got != nullptr) {
+          EXPECT_EQ(got->page_num(), i);
+          got->unpin();
+        }
+      }
+    });
+  }
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_LE(frame_manager.frame_num(), frame_manager.total_frame_num());
+}
+
+TEST(test_frame_manager, test_frame_manager_resize)
+{
+  BPFrameManager frame_manager("Test");
+  ASSERT_EQ(RC::SUCCESS, frame_manager.init(2, 4));
+  ASSERT_EQ(2 * DEFAULT_ITEM_NUM_PER_POOL, frame_manager.total_frame_num());
+
+  // 用一个map模拟磁盘，每个页面的内容由 file_desc 和 page_num 决定
+  std::mutex disk_lock;
+  std::map<std::pair<int, PageNum>, int> disk;
+  auto page_value = [](int file_desc, PageNum page_num) { return file_desc * 100000 + page_num; };
+  auto flusher = [&disk_lock, &disk](Frame &frame) {
+    std::lock_guard<std::mutex> guard(disk_lock);
+    disk[{frame.file_desc(), frame.page_num()}] = *reinterpret_cast<int *>(frame.page().data);
+    frame.clear_dirty();
+    return RC::SUCCESS;
+  };
+
+  const int thread_num = 4;
+  const PageNum page_num_per_thread = 300;
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&, t]() {
+      const int file_desc = t;
+      std::vector<bool> created(page_num_per_thread, false);
+      while (!stop) {
+        for (PageNum i = 0; i < page_num_per_thread; i++) {
+          Frame *frame = frame_manager.get(file_desc, i);
+          if (frame != nullptr) {
+            EXPECT_EQ(page_value(file_desc, i), *reinterpret_cast<int *>(frame->page().data));
+          } else {
+            frame = frame_manager.alloc(file_desc, i);
+            while (frame == nullptr) {
+              frame_manager.purge_frames(1, [&flusher](Frame *frame) { return flusher(*frame); });
+              frame = frame_manager.alloc(file_desc, i);
+            }
+
+            // 淘汰或者缩容时脏页都要刷盘，加载过的页面一定能在磁盘上找到
+            std::lock_guard<std::mutex> guard(disk_lock);
+            auto iter = disk.find({file_desc, i});
+            if (created[i]) {
+              EXPECT_TRUE(iter != disk.end());
+            }
+            if (iter != disk.end()) {
+              EXPECT_EQ(page_value(file_desc, i), iter->second);
+            }
+          }
+
+          *reinterpret_cast<int *>(frame->page().data) = page_value(file_desc, i);
+          frame->mark_dirty();
+          created[i] = true;
+          frame->unpin();
+        }
+      }
+    });
+  }
+
+  const int pool_nums[] = {8, 1, 4, 2, 16, 3};
+  for (int i = 0; i < 30; i++) {
+    const int pool_num = pool_nums[i % (sizeof(pool_nums) / sizeof(pool_nums[0]))];
+    ASSERT_EQ(RC::SUCCESS, frame_manager.resize(pool_num, flusher, 10 * 1000));
+    ASSERT_EQ(pool_num * DEFAULT_ITEM_NUM_PER_POOL, frame_manager.total_frame_num());
+    ASSERT_EQ(pool_num * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE, frame_manager.memory_size());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  stop = true;
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(RC::SUCCESS, frame_manager.resize(1, flusher, 10 * 1000));
+  ASSERT_EQ(DEFAULT_ITEM_NUM_PER_POOL, frame_manager.total_frame_num());
+  ASSERT_LE(frame_manager.frame_num(), frame_manager.total_frame_num());
+
+  // 缩容之后还在内存中的页面内容没有变化，其它页面都已经刷到磁盘上
+  for (int t = 0; t < thread_num; t++) {
+    for (PageNum i = 0; i < page_num_per_thread; i++) {
+      Frame *frame = frame_manager.get(t, i);
+      if (frame != nullptr) {
+        ASSERT_EQ(page_value(t, i), *reinterpret_cast<int *>(frame->page().data));
+        frame->unpin();
+      } else {
+        ASSERT_EQ(page_value(t, i), disk[std::make_pair(t, i)]);
+      }
+    }
+  }
+
+  ASSERT_EQ(RC::INVALID_ARGUMENT, frame_manager.resize(0, flusher, 0));
+}
+
+TEST(test_frame_manager, test_page_cleaner)
+{
+  const char *file_name = "test_page_cleaner.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int page_num = 32;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+
+  PageCleanerOptions options;
+  options.interval_ms = 0; // 不启动后台线程，手动执行
+  options.tail_ratio = 1;
+  options.low_water_mark = 0;
+  options.high_water_mark = 0.1;
+  options.max_pages_per_second = 0;
+  PageCleaner &cleaner = bpm.page_cleaner();
+  ASSERT_EQ(RC::SUCCESS, cleaner.start(options));
+
+  const long flushed_before = PageCleaner::flushed_pages();
+  ASSERT_EQ(page_num, cleaner.clean_once());
+  ASSERT_EQ(page_num, PageCleaner::flushed_pages() - flushed_before);
+  ASSERT_EQ(0, cleaner.clean_once());
+
+  // 脏页比例没有超过高水位时不刷
+  auto mark_dirty = [bp](PageNum page) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page, &frame));
+    ASSERT_FALSE(frame->dirty());
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  };
+  mark_dirty(1);
+  mark_dirty(2);
+  ASSERT_EQ(0, cleaner.clean_once());
+
+  for (PageNum page = 3; page <= 6; page++) {
+    mark_dirty(page);
+  }
+  ASSERT_EQ(6, cleaner.clean_once());
+
+  for (PageNum page = 1; page <= page_num; page++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page, &frame));
+    ASSERT_FALSE(frame->dirty());
+    bp->unpin_page(frame);
+  }
+
+  ASSERT_EQ(RC::INVALID_ARGUMENT, cleaner.start(PageCleanerOptions{100, 0.5, 0.5, 0.2, 0}));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_read_ahead)
+{
+  const char *file_name = "test_read_ahead.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  bpm.set_read_ahead_max_pages(32);
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int page_num = 200;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  // 重新打开文件，页面都不在内存中
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(3, bp->prefetch_pages({1, 2, 3}));
+  ASSERT_EQ(1, bp->prefetch_pages({2, 3, 4}));
+
+  BufferPoolIterator iterator;
+  ASSERT_EQ(RC::SUCCESS, iterator.init(*bp));
+  int count = 0;
+  while (iterator.has_next()) {
+    PageNum page = iterator.next();
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page, &frame));
+    int value = -1;
+    memcpy(&value, frame->data(), sizeof(value));
+    ASSERT_EQ(count, value);
+    bp->unpin_page(frame);
+    count++;
+  }
+  ASSERT_EQ(page_num, count);
+  ASSERT_EQ(32, iterator.read_ahead_window());
+
+  // 页面都已经在内存中了，预读窗口会缩小
+  ASSERT_EQ(RC::SUCCESS, iterator.reset());
+  while (iterator.has_next()) {
+    iterator.next();
+  }
+  ASSERT_EQ(BufferPoolIterator::READ_AHEAD_MIN_PAGES, iterator.read_ahead_window());
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_page_arena)
+{
+  for (bool huge_page : {false, true}) {
+    PageArena arena;
+    PageArenaOptions options;
+    options.huge_page = huge_page;
+    options.lock_memory = true; // 没有权限时只会打印警告
+    ASSERT_EQ(RC::SUCCESS, arena.init(1000, options));
+    ASSERT_EQ(1000, arena.page_count());
+    if (!huge_page) {
+      ASSERT_STREQ("normal", arena.mode());
+    }
+
+    for (size_t i = 0; i < arena.page_count(); i++) {
+      Page *page = arena.page(i);
+      ASSERT_EQ(0, reinterpret_cast<uintptr_t>(page) % BP_PAGE_ALIGNMENT);
+      memset(page, static_cast<int>(i & 0xFF), sizeof(Page));
+    }
+    ASSERT_EQ(static_cast<char>(999 & 0xFF), arena.page(999)->data[BP_PAGE_DATA_SIZE - 1]);
+  }
+
+  BufferPoolManager bpm(0, 0, nullptr, nullptr, PageArenaOptions{true, false});
+  ASSERT_EQ(bpm.total_frame_num(), bpm.memory_size() / BP_PAGE_SIZE);
+}
+
+TEST(test_buffer_pool, test_direct_io)
+{
+  BufferPoolManager bpm;
+  ASSERT_FALSE(bpm.direct_io("db/sys/t.data"));
+  bpm.set_direct_io_databases("sys, test");
+  ASSERT_TRUE(bpm.direct_io("db/sys/t.data"));
+  ASSERT_TRUE(bpm.direct_io("/miniob/db/test/t.index"));
+  ASSERT_FALSE(bpm.direct_io("db/other/t.data"));
+  bpm.set_direct_io_databases("*");
+  ASSERT_TRUE(bpm.direct_io("test_direct_io.bp"));
+
+  const char *file_name = "test_direct_io.bp";
+  ::remove(file_name);
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  // 文件系统不支持 O_DIRECT 时会退化成普通的读写，不影响结果
+  const int page_num = 100;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(&frame->page()) % BP_PAGE_ALIGNMENT);
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(RC::SUCCESS, bp->flush_all_pages());
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i + 1, &frame));
+    int value = -1;
+    memcpy(&value, frame->data(), sizeof(value));
+    ASSERT_EQ(i, value);
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_warmup)
+{
+  const char *file_name = "test_warmup.bp";
+  const char *dump_file = "test_warmup.dump";
+  ::remove(file_name);
+  ::remove(dump_file);
+
+  BufferPoolWarmerOptions options;
+  options.dump_file = dump_file;
+  options.dump_interval_s = 0;
+  options.load_threads = 0; // 测试中直接调用 load
+
+  std::vector<PageNum> hot_pages;
+  {
+    BufferPoolManager bpm(0, 1 /*frame_shard_num*/, "lru");
+    ASSERT_EQ(RC::SUCCESS, bpm.start_warmer(options));
+    ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+    DiskBufferPool *bp = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+    for (int i = 0; i < 100; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+      bp->unpin_page(frame);
+    }
+    ASSERT_EQ(RC::SUCCESS, bp->flush_all_pages());
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+    for (PageNum page_num : {50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 10}) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+      bp->unpin_page(frame);
+      hot_pages.push_back(page_num);
+    }
+    ASSERT_EQ(RC::SUCCESS, bpm.warmer().dump());
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  }
+
+  // 最近访问的页面在最前面
+  std::ifstream in(dump_file);
+  std::string line;
+  ASSERT_TRUE(std::getline(in, line));
+  ASSERT_EQ(std::string("10 ") + file_name, line);
+  in.close();
+
+  {
+    BufferPoolManager bpm(0, 1 /*frame_shard_num*/, "lru");
+    ASSERT_EQ(RC::SUCCESS, bpm.start_warmer(options));
+    DiskBufferPool *bp = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+    ASSERT_EQ(static_cast<int>(hot_pages.size()), bpm.warmer().load());
+
+    // 上次访问过的页面都已经在内存中，其它的页面不在
+    std::sort(hot_pages.begin(), hot_pages.end());
+    ASSERT_EQ(0, bp->prefetch_pages(hot_pages));
+    ASSERT_EQ(10, bp->prefetch_pages({20, 21, 22, 23, 24, 25, 26, 27, 28, 29}));
+
+    // 文件关闭之后，它的页面不会再加载
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+    ASSERT_EQ(0, bpm.warmer().load());
+  }
+
+  ::remove(file_name);
+  ::remove(dump_file);
+}
+
+TEST(test_buffer_pool, test_warmup_without_eviction)
+{
+  const char *file_name = "test_warmup_without_eviction.bp";
+  ::remove(file_name);
+
+  // 只有一个内存池的页帧
+  BufferPoolManager bpm(1 /*memory_size*/, 1 /*frame_shard_num*/, "lru");
+  const int frame_num = static_cast<int>(bpm.total_frame_num());
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  for (int i = 0; i < frame_num * 2; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    bp->unpin_page(frame);
+  }
+  ASSERT_EQ(RC::SUCCESS, bp->flush_all_pages());
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  // 查询加载的页面占用了大部分页帧，头页面也占用一个页帧
+  const int free_frames = 10;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  std::vector<PageNum> query_pages;
+  for (PageNum page_num = 1; page_num < frame_num - free_frames; page_num++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+    bp->unpin_page(frame);
+    query_pages.push_back(page_num);
+  }
+
+  // 预热只用空闲页帧，用完之后停止
+  std::vector<PageNum> warm_pages;
+  for (PageNum page_num = frame_num; page_num < frame_num + free_frames * 2; page_num++) {
+    warm_pages.push_back(page_num);
+  }
+  int loaded = 0;
+  ASSERT_EQ(RC::BUFFERPOOL_NOBUF, bp->warm_pages(warm_pages, loaded));
+  ASSERT_EQ(free_frames, loaded);
+
+  // 查询加载的页面都还在内存中，不需要分配页帧
+  ASSERT_EQ(RC::SUCCESS, bp->warm_pages(query_pages, loaded));
+  ASSERT_EQ(0, loaded);
+
+  // 预读可以淘汰页面
+  ASSERT_EQ(free_frames, bp->prefetch_pages({warm_pages.begin() + free_frames, warm_pages.end()}));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
 int main(int argc, char **argv)
 {
 
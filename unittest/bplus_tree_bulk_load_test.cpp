@@ -0,0 +1,320 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string.h>
+#include <vector>
+
+#include "common/global_context.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/db/db.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index.h"
+#include "storage/index/index_key_sorter.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+
+static vector<int> scan_index(Index *index)
+{
+  vector<int> values;
+  IndexScanner *scanner = index->create_scanner(nullptr, 0, true, nullptr, 0, true);
+  EXPECT_NE(nullptr, scanner);
+  RID rid;
+  while (scanner->next_entry(&rid) == RC::SUCCESS) {
+    values.push_back(rid.slot_num);
+  }
+  scanner->destroy();
+  return values;
+}
+
+/**
+ * 直接构造键值，RID 的 slot_num 记录键值，方便检查
+ */
+static void make_key(int value, char *key)
+{
+  const int null_bitmap = 0;
+  memcpy(key, &null_bitmap, sizeof(null_bitmap));
+  memcpy(key + sizeof(null_bitmap), &value, sizeof(value));
+}
+
+TEST(test_index_key_sorter, test_sort)
+{
+  const int key_length = sizeof(int);
+  auto comparator = [](const char *v1, const char *v2) { return *(const int *)v1 - *(const int *)v2; };
+
+  for (long memory : {1024L * 1024, 256L}) {
+    IndexKeySorter sorter(comparator, key_length, "index_key_sorter_test", memory);
+    vector<int> values(10000);
+    for (int i = 0; i < static_cast<int>(values.size()); i++) {
+      values[i] = i / 2; // 有重复的键值
+    }
+    shuffle(values.begin(), values.end(), mt19937(1));
+    for (int value : values) {
+      ASSERT_EQ(RC::SUCCESS, sorter.add((const char *)&value));
+    }
+    ASSERT_EQ(RC::SUCCESS, sorter.finish());
+    ASSERT_EQ(static_cast<long>(values.size()), sorter.key_count());
+    if (memory < 1024) {
+      ASSERT_GT(sorter.run_count(), 1);
+      ASSERT_TRUE(filesystem::exists("index_key_sorter_test.sort.0"));
+    } else {
+      ASSERT_EQ(0, sorter.run_count());
+    }
+
+    sort(values.begin(), values.end());
+    const char *key = nullptr;
+    for (int value : values) {
+      ASSERT_EQ(RC::SUCCESS, sorter.next(key));
+      ASSERT_EQ(value, *(const int *)key);
+    }
+    ASSERT_EQ(RC::RECORD_EOF, sorter.next(key));
+  }
+
+  // 临时文件在排序器析构时删除
+  ASSERT_FALSE(filesystem::exists("index_key_sorter_test.sort.0"));
+}
+
+class BulkLoadTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(dir_);
+    filesystem::create_directory(dir_);
+    BufferPoolManager::set_instance(&bpm_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("bulk_load_test", dir_.c_str()));
+    AttrInfoSqlNode attrs[2];
+    attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+    attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", 2, attrs));
+    table_ = db_->find_table("t");
+    ASSERT_NE(nullptr, table_);
+    trx_ = TrxKit::instance()->create_trx(db_->clog_manager());
+  }
+
+  void TearDown() override
+  {
+    TrxKit::instance()->destroy_trx(trx_);
+    db_.reset();
+    BufferPoolManager::set_instance(nullptr);
+    filesystem::remove_all(dir_);
+  }
+
+  void insert_rows(const vector<int> &ids)
+  {
+    ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+    for (int id : ids) {
+      Value values[2] = {Value(id), Value(id % 10)};
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+      ASSERT_EQ(RC::SUCCESS, trx_->insert_record(table_, record));
+    }
+    ASSERT_EQ(RC::SUCCESS, trx_->commit());
+  }
+
+  IndexMeta index_meta(const char *name, bool unique)
+  {
+    vector<FieldMeta> fields = {*table_->table_meta().null_field_meta(), *table_->table_meta().field("id")};
+    IndexMeta meta;
+    EXPECT_EQ(RC::SUCCESS, meta.init(name, fields, unique));
+    return meta;
+  }
+
+  /**
+   * 用 fill_factor 批量构建一棵树，键值是 [0, count)
+   */
+  void bulk_load(BplusTreeHandler &handler, const char *name, int count, int fill_factor, int leaf_max_size,
+      int internal_max_size)
+  {
+    const string file = (dir_ / name).string();
+    ASSERT_EQ(RC::SUCCESS, handler.create(file.c_str(), table_, index_meta(name, false), internal_max_size,
+        leaf_max_size));
+    // 很小的排序内存，一定会写临时文件
+    ASSERT_EQ(RC::SUCCESS, handler.bulk_load_begin(fill_factor, 4096));
+
+    vector<int> values(count);
+    for (int i = 0; i < count; i++) {
+      values[i] = i;
+    }
+    shuffle(values.begin(), values.end(), mt19937(count));
+    char key[8];
+    for (int value : values) {
+      make_key(value, key);
+      RID rid(1, value);
+      ASSERT_EQ(RC::SUCCESS, handler.bulk_load_add(key, &rid));
+    }
+    ASSERT_EQ(RC::SUCCESS, handler.bulk_load_finish());
+    ASSERT_FALSE(filesystem::exists(file + ".sort.0"));
+    ASSERT_TRUE(handler.validate_tree());
+  }
+
+protected:
+  const filesystem::path dir_ = "bulk_load_test_db";
+  BufferPoolManager bpm_;
+  unique_ptr<Db> db_;
+  Table *table_ = nullptr;
+  Trx *trx_ = nullptr;
+};
+
+TEST_F(BulkLoadTest, test_fill_factor)
+{
+  const int count = 5000;
+  const int leaf_max_size = 20;
+  const int internal_max_size = 10;
+
+  BplusTreeStat full_stat;
+  BplusTreeStat half_stat;
+  BplusTreeHandler full_tree;
+  BplusTreeHandler half_tree;
+  bulk_load(full_tree, "full", count, 100, leaf_max_size, internal_max_size);
+  bulk_load(half_tree, "half", count, 50, leaf_max_size, internal_max_size);
+  ASSERT_EQ(RC::SUCCESS, full_tree.stat(full_stat));
+  ASSERT_EQ(RC::SUCCESS, half_tree.stat(half_stat));
+
+  ASSERT_EQ(count, full_stat.entries);
+  ASSERT_EQ(count, half_stat.entries);
+  ASSERT_EQ(count / leaf_max_size, full_stat.leaf_pages);
+  ASSERT_EQ(count / (leaf_max_size / 2), half_stat.leaf_pages);
+  ASSERT_GT(half_stat.height, full_stat.height);
+  ASSERT_EQ(full_stat.total_pages() - 1, full_stat.internal_items);
+
+  // 逐条插入的树，节点分裂之后只有一半满
+  BplusTreeHandler insert_tree;
+  const string file = (dir_ / "insert").string();
+  ASSERT_EQ(RC::SUCCESS,
+      insert_tree.create(file.c_str(), table_, index_meta("insert", false), internal_max_size, leaf_max_size));
+  char key[8];
+  for (int i = 0; i < count; i++) {
+    make_key(i, key);
+    RID rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, insert_tree.insert_entry(key, &rid));
+  }
+  BplusTreeStat insert_stat;
+  ASSERT_EQ(RC::SUCCESS, insert_tree.stat(insert_stat));
+  ASSERT_GT(insert_stat.total_pages(), full_stat.total_pages());
+
+  // 批量构建之后可以正常地插入和删除
+  for (int i = 0; i < count; i += 2) {
+    make_key(i, key);
+    RID rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, full_tree.delete_entry(key, &rid));
+    ASSERT_EQ(RC::SUCCESS, half_tree.delete_entry(key, &rid));
+  }
+  for (int i = count; i < count * 2; i++) {
+    make_key(i, key);
+    RID rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, full_tree.insert_entry(key, &rid));
+    ASSERT_EQ(RC::SUCCESS, half_tree.insert_entry(key, &rid));
+  }
+  ASSERT_TRUE(full_tree.validate_tree());
+  ASSERT_TRUE(half_tree.validate_tree());
+  ASSERT_EQ(RC::SUCCESS, full_tree.stat(full_stat));
+  ASSERT_EQ(count + count / 2, full_stat.entries);
+
+  full_tree.close();
+  half_tree.close();
+  insert_tree.close();
+}
+
+TEST_F(BulkLoadTest, test_small_trees)
+{
+  // 只有一个叶子节点、最后一个节点需要合并或平分的各种情况
+  int index = 0;
+  for (int count : {0, 1, 19, 20, 21, 29, 30, 31, 41, 200, 211}) {
+    for (int fill_factor : {10, 75, 100}) {
+      BplusTreeHandler handler;
+      const string name = "small_" + to_string(index++);
+      bulk_load(handler, name.c_str(), count, fill_factor, 20, 4);
+
+      BplusTreeStat stat;
+      ASSERT_EQ(RC::SUCCESS, handler.stat(stat));
+      ASSERT_EQ(count, stat.entries);
+      ASSERT_EQ(count == 0, handler.is_empty());
+      handler.close();
+    }
+  }
+}
+
+TEST_F(BulkLoadTest, test_create_index)
+{
+  const int count = 20000;
+  vector<int> ids(count);
+  for (int i = 0; i < count; i++) {
+    ids[i] = i;
+  }
+  shuffle(ids.begin(), ids.end(), mt19937(0));
+  insert_rows(ids);
+
+  ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+  ASSERT_EQ(RC::SUCCESS, table_->create_index(trx_, {*table_->table_meta().field("id")}, "t_id", true));
+  Index *index = table_->find_index("t_id");
+  ASSERT_NE(nullptr, index);
+
+  // 按照键值顺序返回所有的记录
+  vector<int> values;
+  IndexScanner *scanner = index->create_scanner(nullptr, 0, true, nullptr, 0, true);
+  ASSERT_NE(nullptr, scanner);
+  RID rid;
+  Record record;
+  while (scanner->next_entry(&rid) == RC::SUCCESS) {
+    ASSERT_EQ(RC::SUCCESS, table_->get_record(rid, record));
+    int id = 0;
+    memcpy(&id, record.data() + table_->table_meta().field("id")->offset(), sizeof(id));
+    values.push_back(id);
+  }
+  scanner->destroy();
+  ASSERT_EQ(count, static_cast<int>(values.size()));
+  for (int i = 0; i < count; i++) {
+    ASSERT_EQ(i, values[i]);
+  }
+
+  // 唯一索引仍然能检查重复的键值
+  Value row[2] = {Value(count / 2), Value(0)};
+  ASSERT_EQ(RC::SUCCESS, table_->make_record(2, row, record));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, table_->insert_record(record));
+  ASSERT_EQ(RC::SUCCESS, trx_->commit());
+}
+
+TEST_F(BulkLoadTest, test_duplicate_key)
+{
+  insert_rows({1, 2, 3, 2});
+
+  ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY,
+      table_->create_index(trx_, {*table_->table_meta().field("id")}, "t_id", true));
+  ASSERT_EQ(nullptr, table_->find_index("t_id"));
+
+  // 失败时删除索引文件，不影响之后再创建同名的索引
+  ASSERT_EQ(RC::SUCCESS, table_->create_index(trx_, {*table_->table_meta().field("id")}, "t_id", false));
+  Index *index = table_->find_index("t_id");
+  ASSERT_NE(nullptr, index);
+  ASSERT_EQ(4, static_cast<int>(scan_index(index).size()));
+  ASSERT_EQ(RC::SUCCESS, trx_->commit());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+
+  // 数据库启动时恢复日志要用到全局的事务管理器。
+  // MVCC 不在索引中检查唯一性，这里用 vacuous 检查批量构建时的唯一性
+  TrxKit::init_global("vacuous");
+  GCTX.trx_kit_ = TrxKit::instance();
+
+  return RUN_ALL_TESTS();
+}
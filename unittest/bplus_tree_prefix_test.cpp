@@ -0,0 +1,263 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <list>
+#include <random>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "common/global_context.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/db/db.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+
+/**
+ * 表 t(name char(32)) 上的索引，键值有很长的公共前缀，比较前缀压缩和普通的叶子节点
+ */
+class PrefixCompressionTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(dir_);
+    filesystem::create_directory(dir_);
+    BufferPoolManager::set_instance(&bpm_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("prefix_test", dir_.c_str()));
+    AttrInfoSqlNode attrs[1];
+    attrs[0] = AttrInfoSqlNode{CHARS, "name", name_length, false};
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", 1, attrs));
+    table_ = db_->find_table("t");
+    ASSERT_NE(nullptr, table_);
+
+    vector<FieldMeta> fields = {*table_->table_meta().null_field_meta(), *table_->table_meta().field("name")};
+    ASSERT_EQ(RC::SUCCESS, index_meta_.init("t_name", fields, false));
+  }
+
+  void TearDown() override
+  {
+    db_.reset();
+    BufferPoolManager::set_instance(nullptr);
+    filesystem::remove_all(dir_);
+  }
+
+  void create(BplusTreeHandler &handler, const char *name, bool prefix_compression)
+  {
+    const string file = (dir_ / name).string();
+    ASSERT_EQ(RC::SUCCESS, handler.create(file.c_str(), table_, index_meta_, -1, -1, prefix_compression));
+  }
+
+  /**
+   * 键值是 prefix 后面跟着 value 的十进制，不足的部分补0
+   */
+  static void make_key(const string &prefix, int value, char *key)
+  {
+    memset(key, 0, key_length);
+    const string name = prefix + to_string(value);
+    memcpy(key + sizeof(int), name.data(), min<size_t>(name.size(), name_length));
+  }
+
+  static vector<int> scan(BplusTreeHandler &handler)
+  {
+    vector<int> values;
+    BplusTreeScanner scanner(handler);
+    EXPECT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    RID rid;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      values.push_back(rid.slot_num);
+    }
+    scanner.close();
+    return values;
+  }
+
+protected:
+  static constexpr int name_length = 32;
+  static constexpr int key_length = sizeof(int) + name_length;
+
+  const filesystem::path dir_ = "bplus_tree_prefix_test_db";
+  BufferPoolManager bpm_;
+  unique_ptr<Db> db_;
+  Table *table_ = nullptr;
+  IndexMeta index_meta_;
+};
+
+TEST_F(PrefixCompressionTest, test_insert_delete)
+{
+  const int count = 20000;
+  const string prefix = "customer_account_";
+
+  BplusTreeHandler plain_tree;
+  BplusTreeHandler prefix_tree;
+  create(plain_tree, "plain", false);
+  create(prefix_tree, "prefix", true);
+
+  // 按照字符串排序之后的顺序，RID 的 slot_num 记录键值在排序结果中的位置
+  vector<int> values(count);
+  for (int i = 0; i < count; i++) {
+    values[i] = i;
+  }
+  vector<string> names;
+  for (int value : values) {
+    names.push_back(prefix + to_string(value));
+  }
+  vector<int> order = values;
+  sort(order.begin(), order.end(), [&names](int a, int b) { return names[a] < names[b]; });
+  vector<int> rank(count);
+  for (int i = 0; i < count; i++) {
+    rank[order[i]] = i;
+  }
+
+  shuffle(values.begin(), values.end(), mt19937(count));
+  char key[key_length];
+  for (int value : values) {
+    make_key(prefix, value, key);
+    RID rid(1, rank[value]);
+    ASSERT_EQ(RC::SUCCESS, plain_tree.insert_entry(key, &rid));
+    ASSERT_EQ(RC::SUCCESS, prefix_tree.insert_entry(key, &rid));
+  }
+  ASSERT_TRUE(plain_tree.validate_tree());
+  ASSERT_TRUE(prefix_tree.validate_tree());
+
+  vector<int> expected(count);
+  for (int i = 0; i < count; i++) {
+    expected[i] = i;
+  }
+  ASSERT_EQ(expected, scan(plain_tree));
+  ASSERT_EQ(expected, scan(prefix_tree));
+
+  BplusTreeStat plain_stat;
+  BplusTreeStat prefix_stat;
+  ASSERT_EQ(RC::SUCCESS, plain_tree.stat(plain_stat));
+  ASSERT_EQ(RC::SUCCESS, prefix_tree.stat(prefix_stat));
+  ASSERT_EQ(count, prefix_stat.entries);
+  ASSERT_LT(prefix_stat.leaf_pages, plain_stat.leaf_pages);
+  ASSERT_LE(prefix_stat.height, plain_stat.height);
+
+  for (int value = 0; value < count; value += 7) {
+    make_key(prefix, value, key);
+    list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, prefix_tree.get_entry(key, key_length, rids));
+    ASSERT_EQ(1, static_cast<int>(rids.size()));
+    ASSERT_EQ(rank[value], rids.front().slot_num);
+  }
+
+  // 删除一半之后节点会合并和平分
+  shuffle(values.begin(), values.end(), mt19937(0));
+  for (int i = 0; i < count / 2; i++) {
+    make_key(prefix, values[i], key);
+    RID rid(1, rank[values[i]]);
+    ASSERT_EQ(RC::SUCCESS, prefix_tree.delete_entry(key, &rid));
+  }
+  ASSERT_TRUE(prefix_tree.validate_tree());
+  vector<int> left;
+  for (int i = count / 2; i < count; i++) {
+    left.push_back(rank[values[i]]);
+  }
+  sort(left.begin(), left.end());
+  ASSERT_EQ(left, scan(prefix_tree));
+
+  for (int i = count / 2; i < count; i++) {
+    make_key(prefix, values[i], key);
+    RID rid(1, rank[values[i]]);
+    ASSERT_EQ(RC::SUCCESS, prefix_tree.delete_entry(key, &rid));
+  }
+  ASSERT_TRUE(prefix_tree.is_empty());
+
+  plain_tree.close();
+  prefix_tree.close();
+}
+
+TEST_F(PrefixCompressionTest, test_prefix_shrink)
+{
+  // 先插入公共前缀很长的键值，再插入前缀不同的键值，节点的公共前缀会变短
+  BplusTreeHandler handler;
+  create(handler, "shrink", true);
+
+  char key[key_length];
+  int slot = 0;
+  for (const char *prefix : {"aaaaaaaaaaaaaaaaaaaaaaaa_", "aaaaaaaaaaaa_", "aaa_", "b", ""}) {
+    for (int i = 0; i < 3000; i++) {
+      make_key(prefix, i, key);
+      RID rid(1, slot++);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+  }
+
+  BplusTreeStat stat;
+  ASSERT_EQ(RC::SUCCESS, handler.stat(stat));
+  ASSERT_EQ(slot, stat.entries);
+  ASSERT_EQ(slot, static_cast<int>(scan(handler).size()));
+  ASSERT_EQ(RC::SUCCESS, handler.sync());
+  handler.close();
+
+  // 重新打开之后仍然是前缀压缩的格式
+  const string file = (dir_ / "shrink").string();
+  ASSERT_EQ(RC::SUCCESS, handler.open(file.c_str(), table_, index_meta_));
+  ASSERT_TRUE(handler.validate_tree());
+  make_key("aaa_", 1234, key);
+  list<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, handler.get_entry(key, key_length, rids));
+  ASSERT_EQ(1, static_cast<int>(rids.size()));
+  handler.close();
+}
+
+TEST_F(PrefixCompressionTest, test_bulk_load)
+{
+  const int count = 20000;
+  const string prefix = "order_2024_region_";
+
+  BplusTreeStat stats[2];
+  for (bool prefix_compression : {false, true}) {
+    BplusTreeHandler handler;
+    create(handler, prefix_compression ? "bulk_prefix" : "bulk_plain", prefix_compression);
+    ASSERT_EQ(RC::SUCCESS, handler.bulk_load_begin(100));
+    char key[key_length];
+    for (int i = 0; i < count; i++) {
+      make_key(prefix, i, key);
+      RID rid(1, i);
+      ASSERT_EQ(RC::SUCCESS, handler.bulk_load_add(key, &rid));
+    }
+    ASSERT_EQ(RC::SUCCESS, handler.bulk_load_finish());
+    ASSERT_TRUE(handler.validate_tree());
+    ASSERT_EQ(RC::SUCCESS, handler.stat(stats[prefix_compression]));
+    ASSERT_EQ(count, stats[prefix_compression].entries);
+
+    // 批量构建的节点是满的，之后插入会分裂
+    for (int i = count; i < count + 1000; i++) {
+      make_key(prefix, i, key);
+      RID rid(1, i);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    handler.close();
+  }
+  ASSERT_LT(stats[true].leaf_pages, stats[false].leaf_pages);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+
+  TrxKit::init_global("vacuous");
+  GCTX.trx_kit_ = TrxKit::instance();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <limits.h>
+#include <random>
+#include <string.h>
+#include <vector>
+
+#include "common/lang/lower_bound.h"
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index_key_searcher.h"
+
+using namespace std;
+
+static const int KEY_LENGTH = IndexKeySearcher::KEY_LENGTH;
+
+static IndexMeta make_index_meta(AttrType type, int len = sizeof(int32_t))
+{
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("value", type, sizeof(int32_t), len, true /*visible*/, true /*nullable*/, 1);
+
+  IndexMeta index_meta;
+  index_meta.init("key_searcher_test", fields, false /*unique*/);
+  return index_meta;
+}
+
+/**
+ * 随机生成排好序、互不相同的键值。value 的值很少，有很多相同的值，只能靠 RID 区分
+ */
+template <typename T>
+static vector<char> make_keys(const KeyComparator &comparator, const vector<T> &values, int count, mt19937 &random)
+{
+  vector<char> keys(static_cast<size_t>(count) * KEY_LENGTH);
+  for (int i = 0; i < count; i++) {
+    char *key = keys.data() + static_cast<size_t>(i) * KEY_LENGTH;
+    const int32_t null_flags = random() % 8 == 0 ? (1 << 1) : 0;
+    const T value = values[random() % values.size()];
+    const RID rid(static_cast<PageNum>(random() % 4), static_cast<SlotNum>(i));
+    memcpy(key, &null_flags, sizeof(null_flags));
+    memcpy(key + sizeof(int32_t), &value, sizeof(value));
+    memcpy(key + 2 * sizeof(int32_t), &rid, sizeof(rid));
+  }
+
+  vector<int> order(count);
+  for (int i = 0; i < count; i++) {
+    order[i] = i;
+  }
+  auto key_at = [&keys](int index) { return keys.data() + static_cast<size_t>(index) * KEY_LENGTH; };
+  sort(order.begin(), order.end(), [&](int a, int b) { return comparator(key_at(a), key_at(b)) < 0; });
+  vector<char> sorted(keys.size());
+  for (int i = 0; i < count; i++) {
+    memcpy(sorted.data() + static_cast<size_t>(i) * KEY_LENGTH, key_at(order[i]), KEY_LENGTH);
+  }
+  return sorted;
+}
+
+/**
+ * 按照节点中的格式存放键值：每一项后面有 value_size 个字节的值，前缀压缩时只存放去掉前缀的部分
+ */
+static vector<char> make_node(const vector<char> &keys, int count, int value_size, int prefix_len, int &stride)
+{
+  stride = KEY_LENGTH - prefix_len + value_size;
+  vector<char> node(prefix_len + static_cast<size_t>(count) * stride);
+  if (count > 0) {
+    memcpy(node.data(), keys.data(), prefix_len);
+  }
+  for (int i = 0; i < count; i++) {
+    memcpy(node.data() + prefix_len + static_cast<size_t>(i) * stride,
+        keys.data() + static_cast<size_t>(i) * KEY_LENGTH + prefix_len, KEY_LENGTH - prefix_len);
+  }
+  return node;
+}
+
+template <typename T>
+static void check_search(AttrType type, const vector<T> &values)
+{
+  const IndexMeta meta = make_index_meta(type);
+  KeyComparator comparator;
+  comparator.init(nullptr, meta);
+  const IndexKeySearcher &searcher = comparator.key_searcher();
+  ASSERT_TRUE(searcher.enabled());
+
+  mt19937 random(static_cast<unsigned>(type));
+  for (int count : {0, 1, 2, 3, 7, 8, 100, 255}) {
+    const vector<char> keys = make_keys(comparator, values, count, random);
+    vector<char> probes = make_keys(comparator, values, 200, random);
+    probes.insert(probes.end(), keys.begin(), keys.end());
+    const int probe_count = static_cast<int>(probes.size() / KEY_LENGTH);
+
+    // 所有键值相同的前缀，最多是 null 标记和字段
+    int max_prefix = 0;
+    if (count > 0) {
+      max_prefix = 2 * sizeof(int32_t);
+      for (int i = 1; i < count; i++) {
+        int len = 0;
+        while (len < max_prefix && keys[i * KEY_LENGTH + len] == keys[len]) {
+          len++;
+        }
+        max_prefix = len;
+      }
+    }
+
+    for (int prefix_len : {0, max_prefix}) {
+      for (int value_size : {0, static_cast<int>(sizeof(PageNum)), static_cast<int>(sizeof(RID))}) {
+        int stride = 0;
+        const vector<char> node = make_node(keys, count, value_size, prefix_len, stride);
+        common::BinaryIterator<char> iter_begin(KEY_LENGTH, const_cast<char *>(keys.data()));
+        common::BinaryIterator<char> iter_end(KEY_LENGTH, const_cast<char *>(keys.data()) + keys.size());
+        for (int i = 0; i < probe_count; i++) {
+          const char *key = probes.data() + static_cast<size_t>(i) * KEY_LENGTH;
+          bool expect_found = false;
+          const int expect = common::lower_bound(iter_begin, iter_end, key, comparator, &expect_found) - iter_begin;
+
+          bool found = false;
+          const int index = searcher.lower_bound(node.data() + prefix_len, stride, count,
+              prefix_len > 0 ? node.data() : nullptr, prefix_len, key, &found);
+          ASSERT_EQ(expect, index) << "count=" << count << ", prefix_len=" << prefix_len << ", probe=" << i;
+          ASSERT_EQ(expect_found, found);
+        }
+      }
+    }
+  }
+}
+
+TEST(test_index_key_searcher, test_type)
+{
+  KeyComparator comparator;
+  comparator.init(nullptr, make_index_meta(INTS));
+  ASSERT_EQ(KeySearchType::INT32, comparator.key_searcher().type());
+  comparator.init(nullptr, make_index_meta(DATES));
+  ASSERT_EQ(KeySearchType::INT32, comparator.key_searcher().type());
+  comparator.init(nullptr, make_index_meta(FLOATS));
+  ASSERT_EQ(KeySearchType::FLOAT, comparator.key_searcher().type());
+  comparator.init(nullptr, make_index_meta(CHARS, 4));
+  ASSERT_EQ(KeySearchType::GENERIC, comparator.key_searcher().type());
+
+  // 多列的索引和有 INCLUDE 字段的索引都用原来的比较方式
+  vector<FieldMeta> fields;
+  fields.emplace_back("null_flags", INTS, 0, sizeof(int32_t), false /*visible*/, false /*nullable*/, 0);
+  fields.emplace_back("a", INTS, 4, sizeof(int32_t), true /*visible*/, false /*nullable*/, 1);
+  fields.emplace_back("b", INTS, 8, sizeof(int32_t), true /*visible*/, false /*nullable*/, 2);
+  IndexMeta meta;
+  ASSERT_EQ(RC::SUCCESS, meta.init("multi", fields, false));
+  comparator.init(nullptr, meta);
+  ASSERT_FALSE(comparator.key_searcher().enabled());
+  ASSERT_EQ(RC::SUCCESS, meta.init("include", fields, false, 1 /*include_num*/));
+  comparator.init(nullptr, meta);
+  ASSERT_FALSE(comparator.key_searcher().enabled());
+}
+
+TEST(test_index_key_searcher, test_int)
+{
+  check_search<int32_t>(INTS, {INT_MIN, INT_MIN + 1, -1000, -1, 0, 1, 255, 256, 65536, INT_MAX - 1, INT_MAX});
+}
+
+TEST(test_index_key_searcher, test_date)
+{
+  check_search<int32_t>(DATES, {19700101, 20000229, 20231231, 20380119});
+}
+
+TEST(test_index_key_searcher, test_float)
+{
+  // 相差超过 EPSILON 的值，否则不是严格的顺序
+  check_search<float>(FLOATS, {-1e9f, -3.5f, -0.25f, 0.0f, 1e-3f, 0.5f, 1.0f, 2.0f, 1e9f});
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
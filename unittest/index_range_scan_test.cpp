@@ -0,0 +1,300 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+#include "common/global_context.h"
+#include "gtest/gtest.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/trx.h"
+#include "storage/trx/vacuum.h"
+
+using namespace std;
+
+/**
+ * 表 t(a, b) 上有索引 (a, b)，a 是 [0, 20)，b 是 [0, 10)
+ */
+class IndexRangeScanTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(dir_);
+    filesystem::create_directory(dir_);
+    BufferPoolManager::set_instance(&bpm_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("index_range_scan_test", dir_.c_str()));
+    AttrInfoSqlNode attrs[2];
+    attrs[0] = AttrInfoSqlNode{INTS, "a", 4, false};
+    attrs[1] = AttrInfoSqlNode{INTS, "b", 4, false};
+    ASSERT_EQ(RC::SUCCESS, db_->create_table("t", 2, attrs));
+    table_ = db_->find_table("t");
+    ASSERT_NE(nullptr, table_);
+    trx_ = TrxKit::instance()->create_trx(db_->clog_manager());
+
+    ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+    for (int a = a_count - 1; a >= 0; a--) {
+      for (int b = 0; b < b_count; b++) {
+        Value values[2] = {Value(a), Value(b)};
+        Record record;
+        ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+        ASSERT_EQ(RC::SUCCESS, trx_->insert_record(table_, record));
+      }
+    }
+    const vector<FieldMeta> fields = {*table_->table_meta().field("a"), *table_->table_meta().field("b")};
+    ASSERT_EQ(RC::SUCCESS, table_->create_index(trx_, fields, "t_a_b", false));
+    index_ = table_->find_index("t_a_b");
+    ASSERT_NE(nullptr, index_);
+    ASSERT_EQ(RC::SUCCESS, trx_->commit());
+  }
+
+  void TearDown() override
+  {
+    ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+    trx_->commit();
+    TrxKit::instance()->destroy_trx(trx_);
+    db_.reset();
+    BufferPoolManager::set_instance(nullptr);
+    filesystem::remove_all(dir_);
+  }
+
+  /**
+   * 返回扫描到的所有 (a, b)，按照索引的顺序
+   */
+  vector<pair<int, int>> scan(const vector<Value> &left, bool left_inclusive, const vector<Value> &right,
+      bool right_inclusive, Index *index = nullptr, bool index_only = false,
+      vector<unique_ptr<Expression>> predicates = {})
+  {
+    IndexScanPhysicalOperator oper(
+        table_, index == nullptr ? index_ : index, true, left, left_inclusive, right, right_inclusive);
+    oper.set_index_only(index_only);
+    oper.set_predicates(std::move(predicates));
+    return fetch_rows(oper);
+  }
+
+  /**
+   * 用表扫描得到同样条件下的结果，按照 (a, b) 排序
+   */
+  vector<pair<int, int>> table_scan(vector<unique_ptr<Expression>> predicates)
+  {
+    TableScanPhysicalOperator oper(table_, true /*readonly*/);
+    oper.set_predicates(std::move(predicates));
+    vector<pair<int, int>> rows = fetch_rows(oper);
+    sort(rows.begin(), rows.end());
+    return rows;
+  }
+
+  vector<pair<int, int>> fetch_rows(PhysicalOperator &oper)
+  {
+    vector<pair<int, int>> rows;
+    EXPECT_EQ(RC::SUCCESS, trx_->start_if_need());
+    EXPECT_EQ(RC::SUCCESS, oper.open(trx_));
+    const int a_offset = table_->table_meta().field("a")->offset();
+    const int b_offset = table_->table_meta().field("b")->offset();
+    RC rc = RC::SUCCESS;
+    while ((rc = oper.next(nullptr)) == RC::SUCCESS) {
+      Record *record = nullptr;
+      EXPECT_EQ(RC::SUCCESS, oper.current_tuple()->get_record(table_, record));
+      int a = 0;
+      int b = 0;
+      memcpy(&a, record->data() + a_offset, sizeof(a));
+      memcpy(&b, record->data() + b_offset, sizeof(b));
+      rows.emplace_back(a, b);
+    }
+    EXPECT_EQ(RC::RECORD_EOF, rc);
+    oper.close();
+    return rows;
+  }
+
+  /**
+   * 字段 与 常量 的比较条件
+   */
+  unique_ptr<Expression> compare(const char *field, CompOp comp, int value)
+  {
+    return make_unique<ComparisonExpr>(comp,
+        make_unique<FieldExpr>(table_, table_->table_meta().field(field)), make_unique<ValueExpr>(Value(value)));
+  }
+
+  template <typename... Exprs>
+  static vector<unique_ptr<Expression>> predicates(Exprs &&...exprs)
+  {
+    vector<unique_ptr<Expression>> result;
+    (result.push_back(std::move(exprs)), ...);
+    return result;
+  }
+
+  /**
+   * 在当前事务中删除满足条件的记录
+   */
+  void delete_rows(vector<unique_ptr<Expression>> exprs)
+  {
+    vector<RID> rids;
+    {
+      TableScanPhysicalOperator oper(table_, true /*readonly*/);
+      oper.set_predicates(std::move(exprs));
+      ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+      ASSERT_EQ(RC::SUCCESS, oper.open(trx_));
+      while (oper.next(nullptr) == RC::SUCCESS) {
+        Record *record = nullptr;
+        ASSERT_EQ(RC::SUCCESS, oper.current_tuple()->get_record(table_, record));
+        rids.push_back(record->rid());
+      }
+      oper.close();
+    }
+    for (const RID &rid : rids) {
+      ASSERT_EQ(RC::SUCCESS, trx_->delete_record(table_, rid));
+    }
+  }
+
+  static vector<pair<int, int>> expected(int a_begin, int a_end, int b_begin = 0, int b_end = b_count)
+  {
+    vector<pair<int, int>> rows;
+    for (int a = a_begin; a < a_end; a++) {
+      for (int b = b_begin; b < b_end; b++) {
+        rows.emplace_back(a, b);
+      }
+    }
+    return rows;
+  }
+
+protected:
+  static constexpr int a_count = 20;
+  static constexpr int b_count = 10;
+
+  const filesystem::path dir_ = "index_range_scan_test_db";
+  BufferPoolManager bpm_;
+  unique_ptr<Db> db_;
+  Table *table_ = nullptr;
+  Index *index_ = nullptr;
+  Trx *trx_ = nullptr;
+};
+
+TEST_F(IndexRangeScanTest, test_prefix)
+{
+  // a = 5
+  ASSERT_EQ(expected(5, 6), scan({Value(5)}, true, {Value(5)}, true));
+  // a > 5 and a < 8
+  ASSERT_EQ(expected(6, 8), scan({Value(5)}, false, {Value(8)}, false));
+  // a >= 5 and a <= 8
+  ASSERT_EQ(expected(5, 9), scan({Value(5)}, true, {Value(8)}, true));
+  // a > 17
+  ASSERT_EQ(expected(18, a_count), scan({Value(17)}, false, {}, true));
+  // a < 2
+  ASSERT_EQ(expected(0, 2), scan({}, true, {Value(2)}, false));
+  // a <= 2
+  ASSERT_EQ(expected(0, 3), scan({}, true, {Value(2)}, true));
+  // a > 19，没有数据
+  ASSERT_TRUE(scan({Value(a_count - 1)}, false, {}, true).empty());
+}
+
+TEST_F(IndexRangeScanTest, test_equal_prefix_and_range)
+{
+  // a = 5 and b = 3
+  ASSERT_EQ(expected(5, 6, 3, 4), scan({Value(5), Value(3)}, true, {Value(5), Value(3)}, true));
+  // a = 5 and b > 3 and b <= 7
+  ASSERT_EQ(expected(5, 6, 4, 8), scan({Value(5), Value(3)}, false, {Value(5), Value(7)}, true));
+  // a = 5 and b >= 8
+  ASSERT_EQ(expected(5, 6, 8, b_count), scan({Value(5), Value(8)}, true, {Value(5)}, true));
+  // a = 5 and b < 2
+  ASSERT_EQ(expected(5, 6, 0, 2), scan({Value(5)}, true, {Value(5), Value(2)}, false));
+}
+
+TEST_F(IndexRangeScanTest, test_residual_filter)
+{
+  // a >= 3 and a <= 8 and b >= 7：b 不能用来确定扫描范围，过滤掉的记录要释放页面再读下一条
+  auto index_rows = scan({Value(3)}, true, {Value(8)}, true, nullptr, false, predicates(compare("b", GREAT_EQUAL, 7)));
+  ASSERT_EQ(expected(3, 9, 7, b_count), index_rows);
+  ASSERT_EQ(index_rows,
+      table_scan(predicates(compare("a", GREAT_EQUAL, 3), compare("a", LESS_EQUAL, 8), compare("b", GREAT_EQUAL, 7))));
+
+  // 所有记录都被过滤掉
+  ASSERT_TRUE(scan({Value(3)}, true, {}, true, nullptr, false, predicates(compare("b", GREAT_THAN, b_count))).empty());
+}
+
+TEST_F(IndexRangeScanTest, test_deleted_rows)
+{
+  // 删除 a = 5 的所有记录，以及 a = 6 中 b < 5 的记录。MVCC 删除之后索引项还在，扫描时记录不可见
+  delete_rows(predicates(compare("a", EQUAL_TO, 5)));
+  delete_rows(predicates(compare("a", EQUAL_TO, 6), compare("b", LESS_THAN, 5)));
+
+  auto check = [this]() {
+    auto index_rows = scan({Value(4)}, true, {Value(7)}, true);
+    ASSERT_EQ(static_cast<size_t>(2 * b_count + b_count / 2), index_rows.size());
+    ASSERT_EQ(index_rows, table_scan(predicates(compare("a", GREAT_EQUAL, 4), compare("a", LESS_EQUAL, 7))));
+
+    // 不可见的记录和被过滤掉的记录混在一起
+    index_rows = scan({Value(4)}, false, {}, true, nullptr, false, predicates(compare("b", GREAT_EQUAL, 3)));
+    ASSERT_EQ(index_rows, table_scan(predicates(compare("a", GREAT_THAN, 4), compare("b", GREAT_EQUAL, 3))));
+  };
+
+  // 删除记录的事务自己看不到这些记录，提交之后新的事务也看不到
+  check();
+  ASSERT_EQ(RC::SUCCESS, trx_->commit());
+  check();
+}
+
+TEST_F(IndexRangeScanTest, test_include_index_only)
+{
+  // 索引 (a) INCLUDE (b)，b 只存放在索引中
+  const vector<FieldMeta> fields = {*table_->table_meta().field("a")};
+  const vector<FieldMeta> include = {*table_->table_meta().field("b")};
+  ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+  ASSERT_EQ(RC::SUCCESS, table_->create_index(trx_, fields, "t_a_include_b", false, 90, include));
+  Index *index = table_->find_index("t_a_include_b");
+  ASSERT_NE(nullptr, index);
+  ASSERT_EQ(1, index->index_meta().key_field_num() - 1);
+  ASSERT_TRUE(index->index_meta().contains("b"));
+
+  // 清理之后页面上的记录对所有事务都可见，只扫描索引就可以
+  ASSERT_EQ(RC::SUCCESS, trx_->commit());
+  Vacuum vacuum(*static_cast<MvccTrxKit *>(TrxKit::instance()));
+  vacuum.add_db(db_.get());
+  VacuumOptions options;
+  options.interval_ms = 0;
+  options.max_pages_per_second = 0;
+  ASSERT_EQ(RC::SUCCESS, vacuum.start(options));
+  vacuum.vacuum_once();
+  vacuum.stop();
+  ASSERT_TRUE(table_->record_handler()->visibility_map().all_visible(1));
+
+  // INCLUDE 的字段不参与比较，同一个 a 的记录按照 RID 排序，这里比较集合
+  auto sorted = [](vector<pair<int, int>> rows) {
+    sort(rows.begin(), rows.end());
+    return rows;
+  };
+  ASSERT_EQ(expected(5, 6), sorted(scan({Value(5)}, true, {Value(5)}, true, index, true)));
+  ASSERT_EQ(expected(6, 8), sorted(scan({Value(5)}, false, {Value(8)}, false, index, true)));
+  ASSERT_EQ(sorted(scan({Value(3)}, true, {Value(9)}, true, index, false)),
+      sorted(scan({Value(3)}, true, {Value(9)}, true, index, true)));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+
+  // 索引中的记录可能对当前事务不可见，用 MVCC 测试
+  TrxKit::init_global("mvcc");
+  GCTX.trx_kit_ = TrxKit::instance();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <memory>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/buffer/page_io.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+void test_page_io(const char *backend)
+{
+  unique_ptr<PageIo> page_io(PageIo::create(backend));
+  ASSERT_NE(nullptr, page_io);
+
+  const char *file_name = "test_page_io.bp";
+  ::remove(file_name);
+  int fd = ::open(file_name, O_RDWR | O_CREAT, S_IREAD | S_IWRITE);
+  ASSERT_GE(fd, 0);
+
+  // 写入两段不连续的页面，第一段超过了 io_uring 一次能提交的请求个数
+  const int page_num = 300;
+  vector<Page> pages(page_num);
+  vector<PageIoRequest> requests;
+  for (int i = 0; i < page_num; i++) {
+    PageNum page = (i < page_num / 2) ? i : i + 10;
+    memset(&pages[i], 0, sizeof(Page));
+    pages[i].page_num = page;
+    snprintf(pages[i].data, sizeof(pages[i].data), "page %d", page);
+    requests.push_back(PageIoRequest{fd, page, &pages[i]});
+  }
+  ASSERT_EQ(RC::SUCCESS, page_io->write_pages(requests));
+
+  vector<Page> read_pages(page_num);
+  for (int i = 0; i < page_num; i++) {
+    requests[i].page = &read_pages[i];
+    requests[i].rc = RC::INTERNAL;
+  }
+  ASSERT_EQ(RC::SUCCESS, page_io->read_pages(requests));
+  for (int i = 0; i < page_num; i++) {
+    ASSERT_EQ(RC::SUCCESS, requests[i].rc);
+    ASSERT_EQ(0, memcmp(&pages[i], &read_pages[i], sizeof(Page)));
+  }
+
+  Page page;
+  ASSERT_EQ(RC::SUCCESS, page_io->read_page(fd, page_num / 2 + 10, page));
+  ASSERT_STREQ("page 160", page.data);
+
+  memset(page.data, 0, sizeof(page.data));
+  page.page_num = 3;
+  ASSERT_EQ(RC::SUCCESS, page_io->write_page(fd, 3, page));
+  ASSERT_EQ(RC::SUCCESS, page_io->read_page(fd, 3, read_pages[0]));
+  ASSERT_STREQ("", read_pages[0].data);
+
+  // 读取文件末尾之后的页面会失败，不影响其它请求
+  vector<PageIoRequest> eof_requests{{fd, 1, &read_pages[0]}, {fd, page_num + 100, &read_pages[1]}};
+  ASSERT_EQ(RC::IOERR_READ, page_io->read_pages(eof_requests));
+  ASSERT_EQ(RC::SUCCESS, eof_requests[0].rc);
+  ASSERT_EQ(RC::IOERR_READ, eof_requests[1].rc);
+
+  ::close(fd);
+  ::remove(file_name);
+}
+
+TEST(test_page_io, test_sync)
+{
+  test_page_io("sync");
+}
+
+TEST(test_page_io, test_io_uring)
+{
+  // 内核不支持 io_uring 时会使用 sync
+  test_page_io("io_uring");
+}
+
+/**
+ * 第 partial_call 次 io_uring_enter 只提交一半的请求，之后的 fail_num 次调用都失败，模拟提交到一半时出错
+ */
+class FaultyIoUringPageIo : public IoUringPageIo
+{
+public:
+  FaultyIoUringPageIo(int partial_call, int fail_num) : partial_call_(partial_call), fail_num_(fail_num) {}
+
+  int calls() const { return calls_; }
+
+protected:
+  int enter(unsigned to_submit, unsigned min_complete) override
+  {
+    calls_++;
+    if (calls_ == partial_call_) {
+      return IoUringPageIo::enter(to_submit / 2, 0);
+    }
+    if (calls_ > partial_call_ && calls_ <= partial_call_ + fail_num_) {
+      errno = EIO;
+      return -1;
+    }
+    return IoUringPageIo::enter(to_submit, min_complete);
+  }
+
+private:
+  int partial_call_;
+  int fail_num_;
+  int calls_ = 0;
+};
+
+static void test_partial_submit_failure(int fail_num)
+{
+  FaultyIoUringPageIo page_io(1 /*partial_call*/, fail_num);
+  if (OB_FAIL(page_io.init(64))) {
+    // 内核不支持 io_uring
+    return;
+  }
+
+  const char *file_name = "test_page_io_fault.bp";
+  ::remove(file_name);
+  int fd = ::open(file_name, O_RDWR | O_CREAT, S_IREAD | S_IWRITE);
+  ASSERT_GE(fd, 0);
+
+  const int page_num = 40;
+  vector<Page> pages(page_num);
+  vector<PageIoRequest> requests;
+  for (int i = 0; i < page_num; i++) {
+    memset(&pages[i], 0, sizeof(Page));
+    pages[i].page_num = i;
+    snprintf(pages[i].data, sizeof(pages[i].data), "page %d", i);
+    requests.push_back(PageIoRequest{fd, i, &pages[i]});
+  }
+
+  // 第一批提交了一半后失败，已经提交的请求完成之后才返回，剩下的请求改用同步写
+  ASSERT_EQ(RC::SUCCESS, page_io.write_pages(requests));
+  ASSERT_GT(page_io.calls(), 1);
+
+  // 上一批没有提交的请求不会留在提交队列中，下一批的结果不受影响
+  for (int round = 0; round < 2; round++) {
+    vector<Page> read_pages(page_num);
+    vector<PageIoRequest> read_requests;
+    for (int i = page_num - 1; i >= 0; i -= 2) {
+      read_requests.push_back(PageIoRequest{fd, i, &read_pages[i], RC::INTERNAL});
+    }
+    ASSERT_EQ(RC::SUCCESS, page_io.read_pages(read_requests));
+    for (const PageIoRequest &request : read_requests) {
+      ASSERT_EQ(RC::SUCCESS, request.rc);
+      ASSERT_EQ(0, memcmp(&pages[request.page_num], request.page, sizeof(Page)));
+    }
+  }
+
+  ::close(fd);
+  ::remove(file_name);
+}
+
+TEST(test_page_io, test_io_uring_partial_submit_failure)
+{
+  test_partial_submit_failure(1);
+  // 后面两批读请求在提交时也失败，都改用同步读
+  test_partial_submit_failure(3);
+}
+
+TEST(test_page_io, test_create)
+{
+  unique_ptr<PageIo> page_io(PageIo::create(nullptr));
+  ASSERT_STREQ("sync", page_io->name());
+  ASSERT_EQ(nullptr, PageIo::create("aio"));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,12 +12,18 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2022
 //
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
 #include <string.h>
 #include <sstream>
 
 #include "gtest/gtest.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/record/record_manager.h"
+#include "storage/record/text_file.h"
+#include "storage/table/table_meta.h"
 #include "storage/trx/vacuous_trx.h"
 
 using namespace common;
@@ -112,18 +118,24 @@ TEST(test_record_page_handler, test_record_page_handler)
 TEST(test_record_page_handler, test_record_file_iterator)
 {
   const char *record_manager_file = "record_manager.bp";
+  const char *fsm_file = "record_manager.fsm";
   ::remove(record_manager_file);
+  ::remove(fsm_file);
 
   BufferPoolManager *bpm = new BufferPoolManager();
   DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
   RC rc = bpm->create_file(record_manager_file);
   ASSERT_EQ(rc, RC::SUCCESS);
   
   rc = bpm->open_file(record_manager_file, bp);
   ASSERT_EQ(rc, RC::SUCCESS);
 
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(fsm_file, fsm_bp));
+
   RecordFileHandler file_handler;
-  rc = file_handler.init(bp);
+  rc = file_handler.init(bp, fsm_bp);
   ASSERT_EQ(rc, RC::SUCCESS);
 
   VacuousTrx trx;
@@ -180,15 +192,1005 @@ TEST(test_record_page_handler, test_record_file_iterator)
   file_scanner.close_scan();
   ASSERT_EQ(count, rids.size() / 2);
   
+  file_handler.close();
   bpm->close_file(record_manager_file);
+  bpm->close_file(fsm_file);
   delete bpm;
 }
 
+TEST(test_record_page_handler, test_record_batch_scan)
+{
+  const char *record_manager_file = "record_manager_batch_scan.bp";
+  const char *fsm_file = "record_manager_batch_scan.fsm";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+
+  VacuousTrx trx;
+  RecordFileScanner file_scanner;
+  RecordBatch batch;
+  ASSERT_EQ(RC::SUCCESS, file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/));
+  ASSERT_EQ(RC::RECORD_EOF, file_scanner.next_batch(batch));
+  file_scanner.close_scan();
+
+  char record_data[20];
+  memset(record_data, 0, sizeof(record_data));
+  std::vector<RID> rids;
+  for (int i = 0; i < 2000; i++) {
+    RID rid;
+    memcpy(record_data, &i, sizeof(i));
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+    rids.push_back(rid);
+  }
+  // 第一个页面上的记录全部删除，其它页面上每三条删除一条
+  for (int i = 0; i < 2000; i++) {
+    if (rids[i].page_num == rids[0].page_num || i % 3 == 0) {
+      ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&rids[i]));
+    }
+  }
+
+  std::vector<std::pair<RID, int>> expected;
+  Record record;
+  ASSERT_EQ(RC::SUCCESS, file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/));
+  while (file_scanner.has_next()) {
+    ASSERT_EQ(RC::SUCCESS, file_scanner.next(record));
+    expected.emplace_back(record.rid(), *(int *)record.data());
+  }
+  file_scanner.close_scan();
+
+  std::vector<std::pair<RID, int>> actual;
+  ASSERT_EQ(RC::SUCCESS, file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/));
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = file_scanner.next_batch(batch))) {
+    ASSERT_NE(rids[0].page_num, batch.page_num());
+    ASSERT_EQ(batch.size(), batch.visible_count());
+    for (int i = batch.next_visible(0); i >= 0; i = batch.next_visible(i + 1)) {
+      actual.emplace_back(batch.rid(i), *(int *)batch.data(i));
+    }
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  file_scanner.close_scan();
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(expected[i].first, actual[i].first);
+    ASSERT_EQ(expected[i].second, actual[i].second);
+  }
+
+  // 可见性位图
+  batch.reset(1, sizeof(record_data));
+  for (int i = 0; i < 130; i++) {
+    batch.add(i, record_data);
+  }
+  for (int i = 0; i < 130; i++) {
+    if (i != 5 && i != 64 && i != 129) {
+      batch.set_invisible(i);
+    }
+  }
+  ASSERT_EQ(3, batch.visible_count());
+  ASSERT_EQ(5, batch.next_visible(0));
+  ASSERT_EQ(64, batch.next_visible(6));
+  ASSERT_EQ(129, batch.next_visible(65));
+  ASSERT_EQ(-1, batch.next_visible(130));
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+/**
+ * 返回热点页面中有多少个已经不在缓冲池中了。不在的页面会被重新加载进来
+ */
+static int evicted_pages(DiskBufferPool *bp, const std::vector<PageNum> &pages)
+{
+  return bp->prefetch_pages(pages);
+}
+
+static void scan_all(RecordFileScanner &file_scanner, DiskBufferPool *bp, Trx *trx, int expect_count)
+{
+  ASSERT_EQ(RC::SUCCESS, file_scanner.open_scan(nullptr /*table*/, *bp, trx, true /*readonly*/));
+  int count = 0;
+  Record record;
+  while (file_scanner.has_next()) {
+    ASSERT_EQ(RC::SUCCESS, file_scanner.next(record));
+    count++;
+  }
+  file_scanner.close_scan();
+  ASSERT_EQ(count, expect_count);
+}
+
+TEST(test_record_page_handler, test_scan_ring)
+{
+  const char *hot_file = "record_manager_hot.bp";
+  const char *big_file = "record_manager_big.bp";
+  const char *big_fsm_file = "record_manager_big.fsm";
+  ::remove(hot_file);
+  ::remove(big_file);
+  ::remove(big_fsm_file);
+
+  // 缓冲池只有 DEFAULT_ITEM_NUM_PER_POOL 个页帧，大表的页面个数是它的好几倍
+  BufferPoolManager bpm(DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE, 1 /*frame_shard_num*/, "lru");
+  DiskBufferPool *hot_bp = nullptr;
+  DiskBufferPool *big_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(hot_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(hot_file, hot_bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(big_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(big_file, big_bp));
+  DiskBufferPool *big_fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(big_fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(big_fsm_file, big_fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(big_bp, big_fsm_bp));
+  const int record_num = 20000;
+  char record_data[200];
+  memset(record_data, 0, sizeof(record_data));
+  for (int i = 0; i < record_num; i++) {
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  }
+  ASSERT_GT(big_bp->page_num(), 3 * DEFAULT_ITEM_NUM_PER_POOL);
+
+  // OLTP 经常访问的页面
+  std::vector<PageNum> hot_pages;
+  for (int i = 0; i < 16; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, hot_bp->allocate_page(&frame));
+    hot_pages.push_back(frame->page_num());
+    hot_bp->unpin_page(frame);
+  }
+  ASSERT_EQ(0, evicted_pages(hot_bp, hot_pages));
+
+  VacuousTrx trx;
+  RecordFileScanner file_scanner;
+
+  // 使用环形缓冲区扫描大表，热点页面都还在
+  const long hits = ScanRing::hits();
+  const long reuses = ScanRing::reuses();
+  // 预读的页面也放在环中，扫描访问它们时都是命中的
+  scan_all(file_scanner, big_bp, &trx, record_num);
+  ASSERT_EQ(0, evicted_pages(hot_bp, hot_pages));
+  ASSERT_GT(ScanRing::reuses(), reuses + big_bp->page_num() / 2);
+  ASSERT_GT(ScanRing::hits(), hits + big_bp->page_num() / 2);
+
+  // 小表不使用环形缓冲区
+  ASSERT_EQ(nullptr, hot_bp->create_scan_ring());
+
+  // 不使用环形缓冲区时，一次全表扫描就把热点页面都淘汰了
+  bpm.set_scan_ring(0, ScanRing::DEFAULT_THRESHOLD);
+  ASSERT_EQ(nullptr, big_bp->create_scan_ring());
+  scan_all(file_scanner, big_bp, &trx, record_num);
+  ASSERT_EQ(static_cast<int>(hot_pages.size()), evicted_pages(hot_bp, hot_pages));
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(big_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(big_fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(hot_file));
+  ::remove(hot_file);
+  ::remove(big_file);
+  ::remove(big_fsm_file);
+}
+
+/**
+ * 生成一条记录，两个 CHARS 字段的长度随着 seed 变化
+ */
+static std::string make_slotted_record(const TableMeta &table_meta, int seed)
+{
+  std::string record(table_meta.record_size(), '\0');
+  const FieldMeta *id_field = table_meta.field("id");
+  const FieldMeta *name_field = table_meta.field("name");
+  const FieldMeta *note_field = table_meta.field("note");
+  memcpy(&record[id_field->offset()], &seed, sizeof(seed));
+  memset(&record[name_field->offset()], 'a' + seed % 26, seed % (name_field->len() + 1));
+  memset(&record[note_field->offset()], 'A' + seed % 26, (seed * 7) % (note_field->len() + 1));
+  return record;
+}
+
+static void check_slotted_records(DiskBufferPool *bp, const std::map<RID, std::string> &expected)
+{
+  VacuousTrx trx;
+  RecordFileScanner file_scanner;
+  ASSERT_EQ(RC::SUCCESS, file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/));
+  std::map<RID, std::string> records;
+  Record record;
+  while (file_scanner.has_next()) {
+    ASSERT_EQ(RC::SUCCESS, file_scanner.next(record));
+    records[record.rid()] = std::string(record.data(), record.len());
+  }
+  file_scanner.close_scan();
+  ASSERT_EQ(records.size(), expected.size());
+  ASSERT_TRUE(records == expected);
+}
+
+TEST(test_record_page_handler, test_slotted_page)
+{
+  const char *record_manager_file = "record_manager_slotted.bp";
+  const char *fsm_file = "record_manager_slotted.fsm";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  AttrInfoSqlNode attrs[3];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{CHARS, "name", 255, false};
+  attrs[2] = AttrInfoSqlNode{CHARS, "note", 300, false};
+  TableMeta table_meta;
+  ASSERT_EQ(RC::SUCCESS, table_meta.init(1, "slotted", 3, attrs, StorageFormat::SLOTTED_FORMAT));
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp, &table_meta));
+
+  const int record_num = 2000;
+  std::map<RID, std::string> expected;
+  for (int i = 0; i < record_num; i++) {
+    std::string record = make_slotted_record(table_meta, i);
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record.data(), record.size(), &rid));
+    expected[rid] = record;
+  }
+  check_slotted_records(bp, expected);
+
+  // 定长记录每页只能放下 14 条记录，变长记录平均只有定长记录的一半左右
+  const int fixed_pages = record_num / (BP_PAGE_DATA_SIZE / table_meta.record_size());
+  const int slotted_pages = bp->page_num() - 1;
+  ASSERT_LT(slotted_pages, fixed_pages * 2 / 3);
+
+  // 删掉一半的记录，再把剩下的记录变长、变短
+  int seed = record_num;
+  for (auto iter = expected.begin(); iter != expected.end();) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&iter->first));
+    iter = expected.erase(iter);
+    if (iter == expected.end()) {
+      break;
+    }
+
+    std::string record = make_slotted_record(table_meta, seed++);
+    auto updater = [&record](Record &inplace_record) { memcpy(inplace_record.data(), record.data(), record.size()); };
+    RC rc = file_handler.visit_record(iter->first, false /*readonly*/, updater);
+    ASSERT_TRUE(rc == RC::SUCCESS || rc == RC::RECORD_NOMEM);
+    if (rc == RC::SUCCESS) {
+      iter->second = record;
+    }
+    ++iter;
+  }
+  check_slotted_records(bp, expected);
+
+  Record record;
+  RecordPageHandler page_handler;
+  const RID &rid = expected.begin()->first;
+  ASSERT_EQ(RC::SUCCESS, file_handler.get_record(page_handler, &rid, true /*readonly*/, &record));
+  ASSERT_EQ(0, memcmp(record.data(), expected.begin()->second.data(), record.len()));
+  page_handler.cleanup();
+
+  // 删除的空间被整理出来以后可以再次使用
+  const int page_num = bp->page_num();
+  for (int i = 0; i < record_num / 2; i++) {
+    std::string record = make_slotted_record(table_meta, i);
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record.data(), record.size(), &rid));
+    expected[rid] = record;
+  }
+  ASSERT_LE(bp->page_num(), page_num + 2);
+  check_slotted_records(bp, expected);
+
+  // 重新打开文件后还能找到没有满的页面
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp, &table_meta));
+  check_slotted_records(bp, expected);
+  for (auto iter = expected.begin(); iter != expected.end(); iter = expected.erase(iter)) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&iter->first));
+  }
+  check_slotted_records(bp, expected);
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+TEST(test_record_page_handler, test_pax_page)
+{
+  const char *record_manager_file = "record_manager_pax.bp";
+  const char *fsm_file = "record_manager_pax.fsm";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  AttrInfoSqlNode attrs[3];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{CHARS, "name", 255, false};
+  attrs[2] = AttrInfoSqlNode{CHARS, "note", 300, false};
+  TableMeta table_meta;
+  ASSERT_EQ(RC::SUCCESS, table_meta.init(1, "pax", 3, attrs, StorageFormat::PAX_FORMAT));
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp, &table_meta));
+
+  const int record_num = 1000;
+  std::map<RID, std::string> expected;
+  for (int i = 0; i < record_num; i++) {
+    std::string record = make_slotted_record(table_meta, i);
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record.data(), record.size(), &rid));
+    expected[rid] = record;
+  }
+  check_slotted_records(bp, expected);
+
+  // 每个 minipage 都要对齐，页面能放下的记录最多比定长记录少一条
+  const int fixed_pages = (record_num + 13) / 14;
+  ASSERT_LE(bp->page_num() - 1, fixed_pages + fixed_pages / 10 + 1);
+
+  // 删掉一半的记录，更新剩下的记录
+  int seed = record_num;
+  for (auto iter = expected.begin(); iter != expected.end();) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&iter->first));
+    iter = expected.erase(iter);
+    if (iter == expected.end()) {
+      break;
+    }
+
+    std::string record = make_slotted_record(table_meta, seed++);
+    auto updater = [&record](Record &inplace_record) { memcpy(inplace_record.data(), record.data(), record.size()); };
+    ASSERT_EQ(RC::SUCCESS, file_handler.visit_record(iter->first, false /*readonly*/, updater));
+    iter->second = record;
+    ++iter;
+  }
+  check_slotted_records(bp, expected);
+
+  Record record;
+  RecordPageHandler page_handler;
+  const RID &rid = expected.begin()->first;
+  ASSERT_EQ(RC::SUCCESS, file_handler.get_record(page_handler, &rid, true /*readonly*/, &record));
+  ASSERT_EQ(0, memcmp(record.data(), expected.begin()->second.data(), record.len()));
+  page_handler.cleanup();
+
+  // 批量扫描时只读取 id 这一列，其它列不会解码
+  const FieldMeta *id_field = table_meta.field("id");
+  const FieldMeta *note_field = table_meta.field("note");
+  VacuousTrx trx;
+  RecordFileScanner file_scanner;
+  ASSERT_EQ(RC::SUCCESS, file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/));
+  RecordBatch batch;
+  batch.set_projection({id_field->index()});
+  ASSERT_TRUE(batch.projected(id_field->index()));
+  ASSERT_FALSE(batch.projected(note_field->index()));
+  int scanned = 0;
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = file_scanner.next_batch(batch))) {
+    for (int i = batch.next_visible(0); i >= 0; i = batch.next_visible(i + 1)) {
+      auto iter = expected.find(batch.rid(i));
+      ASSERT_TRUE(iter != expected.end());
+      ASSERT_EQ(0, memcmp(batch.data(i) + id_field->offset(), iter->second.data() + id_field->offset(), id_field->len()));
+      scanned++;
+    }
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(static_cast<int>(expected.size()), scanned);
+  file_scanner.close_scan();
+
+  // 重新打开文件后还能读出来，并且删除的空间可以再次使用
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp, &table_meta));
+  check_slotted_records(bp, expected);
+
+  const int page_num = bp->page_num();
+  for (int i = 0; i < record_num / 2; i++) {
+    std::string record = make_slotted_record(table_meta, i);
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record.data(), record.size(), &rid));
+    expected[rid] = record;
+  }
+  ASSERT_EQ(page_num, bp->page_num());
+  check_slotted_records(bp, expected);
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+TEST(test_record_page_handler, test_free_space_map)
+{
+  const char *raw_fsm_file = "record_manager_raw.fsm";
+  const char *record_manager_file = "record_manager_fsm.bp";
+  const char *fsm_file = "record_manager_fsm.fsm";
+  ::remove(raw_fsm_file);
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *raw_fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(raw_fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(raw_fsm_file, raw_fsm_bp));
+
+  FreeSpaceMap fsm;
+  ASSERT_EQ(RC::SUCCESS, fsm.init(raw_fsm_bp));
+  ASSERT_TRUE(fsm.empty());
+  PageNum page_num = 0;
+  ASSERT_EQ(RC::SUCCESS, fsm.search(100, page_num));
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, page_num);
+
+  // 第二个 FSM 页面会在需要时创建
+  const PageNum far_page = FreeSpaceMap::PAGES_PER_FSM_PAGE + 10;
+  ASSERT_EQ(RC::SUCCESS, fsm.update(5, 64));
+  ASSERT_EQ(RC::SUCCESS, fsm.update(far_page, 4000));
+  ASSERT_EQ(3, raw_fsm_bp->page_num());
+  ASSERT_EQ(RC::SUCCESS, fsm.search(40, page_num));
+  ASSERT_EQ(5, page_num);
+  ASSERT_EQ(RC::SUCCESS, fsm.search(1000, page_num));
+  ASSERT_EQ(far_page, page_num);
+  ASSERT_EQ(RC::SUCCESS, fsm.search(5000, page_num));
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, page_num);
+  ASSERT_EQ(RC::SUCCESS, fsm.set_category(far_page, 0));
+  ASSERT_EQ(RC::SUCCESS, fsm.search(1000, page_num));
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, page_num);
+  fsm.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(raw_fsm_file));
+  ::remove(raw_fsm_file);
+
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+
+  char record_data[100];
+  memset(record_data, 0, sizeof(record_data));
+  std::vector<RID> rids;
+  for (int i = 0; i < 2000; i++) {
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+    rids.push_back(rid);
+  }
+
+  // 清空第一个数据页面
+  const PageNum free_page = rids.front().page_num;
+  for (const RID &rid : rids) {
+    if (rid.page_num == free_page) {
+      ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&rid));
+    }
+  }
+
+  // 重新打开后，不需要遍历数据文件就能找到空闲的页面
+  const int page_count = bp->page_num();
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  ASSERT_EQ(free_page, rid.page_num);
+  ASSERT_EQ(page_count, bp->page_num());
+
+  // 没有空闲空间表的旧文件，打开时重新生成
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(fsm_file);
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  ASSERT_EQ(free_page, rid.page_num);
+  ASSERT_EQ(page_count, bp->page_num());
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+TEST(test_record_page_handler, test_free_space_map_full_pages)
+{
+  const char *record_manager_file = "record_manager_fsm_full.bp";
+  const char *fsm_file = "record_manager_fsm_full.fsm";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  // 新建的表直接标记空闲空间表已经建立
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+  ASSERT_EQ(2, fsm_bp->page_num());
+
+  // 把数据页面正好写满，所有页面的空闲等级都是0
+  char record_data[100];
+  memset(record_data, 0, sizeof(record_data));
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  const PageNum full_page = rid.page_num;
+  RecordPageHandler page_handler;
+  ASSERT_EQ(RC::SUCCESS, page_handler.init(*bp, full_page, true /*readonly*/));
+  const int left_records = page_handler.free_space() / static_cast<int>(sizeof(record_data));
+  page_handler.cleanup();
+  for (int i = 0; i < left_records; i++) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+    ASSERT_EQ(full_page, rid.page_num);
+  }
+  ASSERT_EQ(RC::SUCCESS, page_handler.init(*bp, full_page, true /*readonly*/));
+  ASSERT_EQ(0, page_handler.free_space());
+  page_handler.cleanup();
+
+  // 旧版本的文件，重建之后即使没有空闲的页面也留下标记
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(fsm_file);
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+  ASSERT_EQ(2, fsm_bp->page_num());
+
+  // 标记已经写到磁盘上，再次打开时不会重建
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(2, fsm_bp->page_num());
+  FreeSpaceMap fsm;
+  ASSERT_EQ(RC::SUCCESS, fsm.init(fsm_bp));
+  ASSERT_FALSE(fsm.empty());
+  fsm.close();
+
+  // 没有空闲的页面，插入时分配新的页面
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+  const int page_count = bp->page_num();
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  ASSERT_NE(full_page, rid.page_num);
+  ASSERT_EQ(page_count + 1, bp->page_num());
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+TEST(test_record_page_handler, test_insert_records)
+{
+  const char *record_manager_file = "record_manager_batch.bp";
+  const char *fsm_file = "record_manager_batch.fsm";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+
+  // 先插入几条记录再删除，批量插入时会先填满这个页面
+  const int record_size = 100;
+  std::vector<RID> single_rids(3);
+  char record_data[record_size];
+  memset(record_data, 0, sizeof(record_data));
+  for (RID &rid : single_rids) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, record_size, &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&single_rids[1]));
+
+  const int record_num = 1000;
+  std::vector<std::vector<char>> records(record_num, std::vector<char>(record_size));
+  std::vector<const char *> datas;
+  for (int i = 0; i < record_num; i++) {
+    memcpy(records[i].data(), &i, sizeof(i));
+    datas.push_back(records[i].data());
+  }
+
+  std::vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_records(datas, record_size, rids));
+  ASSERT_EQ(record_num, static_cast<int>(rids.size()));
+  ASSERT_EQ(single_rids[1], rids[0]);
+
+  std::map<PageNum, int> page_records;
+  for (int i = 0; i < record_num; i++) {
+    page_records[rids[i].page_num]++;
+    int value = -1;
+    ASSERT_EQ(RC::SUCCESS,
+        file_handler.visit_record(
+            rids[i], true /*readonly*/, [&value](Record &record) { memcpy(&value, record.data(), sizeof(value)); }));
+    ASSERT_EQ(i, value);
+  }
+
+  // 除了最后一个页面，每个页面都是放满之后才换下一个页面
+  const int records_per_page = page_records.begin()->second + 2;
+  for (auto iter = std::next(page_records.begin()); iter != std::prev(page_records.end()); ++iter) {
+    ASSERT_EQ(records_per_page, iter->second);
+  }
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+TEST(test_record_page_handler, test_morsel_scan)
+{
+  const char *record_manager_file = "record_manager_morsel.bp";
+  const char *fsm_file = "record_manager_morsel.fsm";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp, fsm_bp));
+
+  const int record_num = 10000;
+  char record_data[100];
+  memset(record_data, 0, sizeof(record_data));
+  for (int i = 0; i < record_num; i++) {
+    RID rid;
+    memcpy(record_data, &i, sizeof(i));
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  }
+
+  // 三个扫描器轮流领取页面，每段3个页面，合起来每条记录正好扫描一次
+  VacuousTrx trx;
+  MorselDispenser morsels(3);
+  RecordFileScanner scanners[3];
+  for (RecordFileScanner &scanner : scanners) {
+    ASSERT_EQ(RC::SUCCESS, scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, &morsels));
+  }
+
+  std::vector<int> counts(record_num, 0);
+  std::vector<RecordBatch> batches(3);
+  bool finished[3] = {false, false, false};
+  int finished_num = 0;
+  for (int turn = 0; finished_num < 3; turn = (turn + 1) % 3) {
+    if (finished[turn]) {
+      continue;
+    }
+    RC rc = scanners[turn].next_batch(batches[turn]);
+    if (rc == RC::RECORD_EOF) {
+      finished[turn] = true;
+      finished_num++;
+      continue;
+    }
+    ASSERT_EQ(RC::SUCCESS, rc);
+    for (int i = batches[turn].next_visible(0); i >= 0; i = batches[turn].next_visible(i + 1)) {
+      counts[*(const int *)batches[turn].data(i)]++;
+    }
+  }
+  for (RecordFileScanner &scanner : scanners) {
+    scanner.close_scan();
+  }
+  for (int i = 0; i < record_num; i++) {
+    ASSERT_EQ(1, counts[i]);
+  }
+
+  // 逐条扫描也从同一个地方领取页面
+  morsels.reset();
+  std::fill(counts.begin(), counts.end(), 0);
+  Record record;
+  for (RecordFileScanner &scanner : scanners) {
+    ASSERT_EQ(RC::SUCCESS, scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, &morsels));
+  }
+  for (int i = 0; i < record_num / 2; i++) {
+    ASSERT_TRUE(scanners[i % 2].has_next());
+    ASSERT_EQ(RC::SUCCESS, scanners[i % 2].next(record));
+    counts[*(const int *)record.data()]++;
+  }
+  for (RecordFileScanner &scanner : scanners) {
+    while (scanner.has_next()) {
+      ASSERT_EQ(RC::SUCCESS, scanner.next(record));
+      counts[*(const int *)record.data()]++;
+    }
+    scanner.close_scan();
+  }
+  for (int i = 0; i < record_num; i++) {
+    ASSERT_EQ(1, counts[i]);
+  }
+
+  file_handler.close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+}
+
+/**
+ * 用区域映射扫描，返回满足条件的记录条数，不检查条件本身
+ */
+static int zone_scan_count(DiskBufferPool &bp, const ZoneFilter *filter, int &skipped_pages)
+{
+  VacuousTrx trx;
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, scanner.open_scan(nullptr /*table*/, bp, &trx, true /*readonly*/, nullptr, filter));
+  int count = 0;
+  RecordBatch batch;
+  while (scanner.next_batch(batch) == RC::SUCCESS) {
+    count += batch.visible_count();
+  }
+  skipped_pages = scanner.skipped_pages();
+  scanner.close_scan();
+  return count;
+}
+
+TEST(test_record_page_handler, test_zone_map)
+{
+  const char *record_manager_file = "record_manager_zone.bp";
+  const char *fsm_file = "record_manager_zone.fsm";
+  const char *zone_file = "record_manager_zone.zone";
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+  ::remove(zone_file);
+
+  AttrInfoSqlNode attrs[3];
+  attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+  attrs[1] = AttrInfoSqlNode{FLOATS, "score", 4, true};
+  attrs[2] = AttrInfoSqlNode{CHARS, "name", 200, false};
+  TableMeta table_meta;
+  ASSERT_EQ(RC::SUCCESS, table_meta.init(1, "zone", 3, attrs, StorageFormat::FIXED_FORMAT));
+  const FieldMeta *id_field = table_meta.field("id");
+  const FieldMeta *score_field = table_meta.field("score");
+  const int null_offset = table_meta.null_field_meta()->offset();
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  DiskBufferPool *fsm_bp = nullptr;
+  DiskBufferPool *zone_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(record_manager_file, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(fsm_file, fsm_bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(zone_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(zone_file, zone_bp));
+
+  auto file_handler = std::make_unique<RecordFileHandler>();
+  ASSERT_EQ(RC::SUCCESS, file_handler->init(bp, fsm_bp, &table_meta, zone_bp));
+  ZoneMap *zone_map = file_handler->zone_map();
+  ASSERT_NE(nullptr, zone_map);
+  ASSERT_EQ(2, static_cast<int>(zone_map->columns().size()));
+  const int id_column = zone_map->column_index(id_field->index());
+  const int score_column = zone_map->column_index(score_field->index());
+  ASSERT_GE(id_column, 0);
+  ASSERT_GE(score_column, 0);
+
+  // id 递增，前一半记录的 score 是 NULL
+  const int record_num = 10000;
+  std::vector<char> record_data(table_meta.record_size());
+  std::vector<RID> rids(record_num);
+  for (int i = 0; i < record_num; i++) {
+    memset(record_data.data(), 0, record_data.size());
+    const float score = static_cast<float>(i);
+    const int null_flags = i < record_num / 2 ? 1 << score_field->index() : 0;
+    memcpy(record_data.data() + id_field->offset(), &i, sizeof(i));
+    memcpy(record_data.data() + score_field->offset(), &score, sizeof(score));
+    memcpy(record_data.data() + null_offset, &null_flags, sizeof(null_flags));
+    ASSERT_EQ(RC::SUCCESS, file_handler->insert_record(record_data.data(), record_data.size(), &rids[i]));
+  }
+  const int page_count = bp->page_num() - 1;
+  ASSERT_GT(page_count, 10);
+
+  // 有满足条件的记录的页面个数，其它页面都应该跳过
+  auto pages_with = [&](std::function<bool(int)> pred) {
+    std::set<PageNum> pages;
+    for (int i = 0; i < record_num; i++) {
+      if (pred(i)) {
+        pages.insert(rids[i].page_num);
+      }
+    }
+    return static_cast<int>(pages.size());
+  };
+
+  int skipped = 0;
+  ZoneFilter no_filter(zone_map, {});
+  ASSERT_EQ(record_num, zone_scan_count(*bp, &no_filter, skipped));
+  ASSERT_EQ(0, skipped);
+
+  ZoneFilter less_filter(zone_map, {ZoneCondition{id_column, LESS_THAN, Value(100), false}});
+  ASSERT_GE(zone_scan_count(*bp, &less_filter, skipped), 100);
+  ASSERT_EQ(page_count - pages_with([](int i) { return i < 100; }), skipped);
+
+  // 常量在左边：9000 <= id
+  ZoneFilter right_filter(zone_map, {ZoneCondition{id_column, LESS_EQUAL, Value(9000), true}});
+  ASSERT_GE(zone_scan_count(*bp, &right_filter, skipped), 1000);
+  ASSERT_EQ(page_count - pages_with([](int i) { return 9000 <= i; }), skipped);
+
+  // 不同类型之间的比较：id = 5000.0
+  ZoneFilter equal_filter(zone_map, {ZoneCondition{id_column, EQUAL_TO, Value(5000.0f), false}});
+  ASSERT_GE(zone_scan_count(*bp, &equal_filter, skipped), 1);
+  ASSERT_EQ(page_count - 1, skipped);
+
+  // 多个条件同时满足：100 <= id and id < 200
+  ZoneFilter range_filter(zone_map,
+      {ZoneCondition{id_column, GREAT_EQUAL, Value(100), false}, ZoneCondition{id_column, LESS_THAN, Value(200), false}});
+  ASSERT_GE(zone_scan_count(*bp, &range_filter, skipped), 100);
+  ASSERT_EQ(page_count - pages_with([](int i) { return 100 <= i && i < 200; }), skipped);
+
+  // 全部是 NULL 的页面上，score 的任何比较都不成立
+  ZoneFilter null_filter(zone_map, {ZoneCondition{score_column, GREAT_EQUAL, Value(0.0f), false}});
+  ASSERT_GE(zone_scan_count(*bp, &null_filter, skipped), record_num / 2);
+  ASSERT_EQ(page_count - pages_with([](int i) { return i >= record_num / 2; }), skipped);
+
+  ZoneFilter empty_filter(zone_map, {ZoneCondition{id_column, GREAT_THAN, Value(record_num), false}});
+  ASSERT_EQ(0, zone_scan_count(*bp, &empty_filter, skipped));
+  ASSERT_EQ(page_count, skipped);
+
+  // 删除第一个页面上所有的记录，再插入的记录重新统计
+  const PageNum first_page = rids[0].page_num;
+  for (int i = 0; i < record_num && rids[i].page_num == first_page; i++) {
+    ASSERT_EQ(RC::SUCCESS, file_handler->delete_record(&rids[i]));
+  }
+  memset(record_data.data(), 0, record_data.size());
+  const int negative_id = -1;
+  memcpy(record_data.data() + id_field->offset(), &negative_id, sizeof(negative_id));
+  ASSERT_EQ(RC::SUCCESS, file_handler->recover_insert_record(record_data.data(), record_data.size(), rids[0]));
+
+  ZoneFilter negative_filter(zone_map, {ZoneCondition{id_column, LESS_THAN, Value(0), false}});
+  ASSERT_EQ(1, zone_scan_count(*bp, &negative_filter, skipped));
+  ASSERT_EQ(page_count - 1, skipped);
+
+  // 正常关闭后再打开，统计信息直接从文件中读取
+  file_handler->close();
+  file_handler = std::make_unique<RecordFileHandler>();
+  ASSERT_EQ(RC::SUCCESS, file_handler->init(bp, fsm_bp, &table_meta, zone_bp));
+  zone_map = file_handler->zone_map();
+  ZoneFilter reopen_filter(zone_map, {ZoneCondition{id_column, LESS_THAN, Value(0), false}});
+  ASSERT_EQ(1, zone_scan_count(*bp, &reopen_filter, skipped));
+  ASSERT_EQ(page_count - 1, skipped);
+
+  // 没有区域映射文件的旧表，打开时遍历数据文件重建
+  file_handler->close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(zone_file));
+  ::remove(zone_file);
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(zone_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(zone_file, zone_bp));
+  file_handler = std::make_unique<RecordFileHandler>();
+  ASSERT_EQ(RC::SUCCESS, file_handler->init(bp, fsm_bp, &table_meta, zone_bp));
+  zone_map = file_handler->zone_map();
+  ZoneFilter rebuild_filter(zone_map, {ZoneCondition{id_column, LESS_THAN, Value(0), false}});
+  ASSERT_EQ(1, zone_scan_count(*bp, &rebuild_filter, skipped));
+  ASSERT_EQ(page_count - 1, skipped);
+
+  file_handler->close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(fsm_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(zone_file));
+  ::remove(record_manager_file);
+  ::remove(fsm_file);
+  ::remove(zone_file);
+}
+
+TEST(test_record_page_handler, test_text_file)
+{
+  const char *text_file = "record_manager_text.text";
+  ::remove(text_file);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(text_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(text_file, bp));
+
+  auto text_handler = std::make_unique<TextFileHandler>();
+  ASSERT_EQ(RC::SUCCESS, text_handler->init(bp));
+
+  std::string large(3 * TextFileHandler::CHUNK_SIZE + 5, 'a');
+  for (size_t i = 0; i < large.size(); i++) {
+    large[i] = 'a' + i % 26;
+  }
+  const std::vector<std::string> texts = {"", "hello", large, std::string(TextFileHandler::CHUNK_SIZE, 'x')};
+  std::vector<int32_t> text_ids;
+  for (const std::string &text : texts) {
+    int32_t text_id = -1;
+    ASSERT_EQ(RC::SUCCESS, text_handler->insert_text(text.data(), static_cast<int>(text.size()), text_id));
+    text_ids.push_back(text_id);
+  }
+  // 每个分块一个页面，再加上文件头
+  ASSERT_EQ(1 + 1 + 1 + 4 + 1, bp->page_num());
+
+  std::string text;
+  for (size_t i = 0; i < texts.size(); i++) {
+    ASSERT_EQ(RC::SUCCESS, text_handler->get_text(text_ids[i], text));
+    ASSERT_EQ(texts[i], text);
+  }
+
+  // 延迟读取的值在用到字符串时才读取，复制时只复制编号
+  Value lazy;
+  lazy.set_text_ref(text_handler.get(), text_ids[2]);
+  Value copied = lazy;
+  ASSERT_EQ(TEXTS, copied.attr_type());
+  ASSERT_EQ(static_cast<int>(large.size()), copied.length());
+  ASSERT_EQ(large, lazy.get_string());
+  Value hello;
+  hello.set_text_ref(text_handler.get(), text_ids[1]);
+  ASSERT_LT(hello.compare(Value("world")), 0);
+  ASSERT_EQ(0, hello.compare(Value("hello")));
+
+  // 释放的页面给之后写入的值使用，文件不会变大
+  ASSERT_EQ(RC::SUCCESS, text_handler->delete_text(text_ids[2]));
+  int32_t reused_id = -1;
+  const std::string medium(2 * TextFileHandler::CHUNK_SIZE, 'm');
+  ASSERT_EQ(RC::SUCCESS, text_handler->insert_text(medium.data(), static_cast<int>(medium.size()), reused_id));
+  ASSERT_EQ(8, bp->page_num());
+  ASSERT_EQ(RC::SUCCESS, text_handler->get_text(reused_id, text));
+  ASSERT_EQ(medium, text);
+  ASSERT_EQ(RC::SUCCESS, text_handler->get_text(text_ids[3], text));
+  ASSERT_EQ(texts[3], text);
+
+  // 重新打开文件之后内容不变
+  text_handler->close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(text_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(text_file, bp));
+  text_handler = std::make_unique<TextFileHandler>();
+  ASSERT_EQ(RC::SUCCESS, text_handler->init(bp));
+  ASSERT_EQ(RC::SUCCESS, text_handler->get_text(reused_id, text));
+  ASSERT_EQ(medium, text);
+  ASSERT_EQ(RC::SUCCESS, text_handler->get_text(text_ids[1], text));
+  ASSERT_EQ(texts[1], text);
+
+  text_handler->close();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(text_file));
+  ::remove(text_file);
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
   testing::InitGoogleTest(&argc, argv);
 
+  // 表元数据中的事务字段由 TrxKit 决定
+  TrxKit::init_global("mvcc");
+
   // 调用RUN_ALL_TESTS()运行所有测试用例
   // main函数返回RUN_ALL_TESTS()的运行结果
   return RUN_ALL_TESTS();
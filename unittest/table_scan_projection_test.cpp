@@ -0,0 +1,244 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/global_context.h"
+#include "gtest/gtest.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/physical_operator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "sql/optimizer/logical_plan_generator.h"
+#include "sql/optimizer/physical_plan_generator.h"
+#include "sql/optimizer/rewriter.h"
+#include "sql/parser/parse.h"
+#include "sql/stmt/stmt.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+
+/**
+ * 通过 SQL 查询 PAX 格式的表，扫描时只解码查询用到的列，结果与定长格式的表相同
+ */
+class TableScanProjectionTest : public testing::Test
+{
+protected:
+  static constexpr int ROW_NUM = 3000;
+
+  void SetUp() override
+  {
+    filesystem::remove_all(dir_);
+    filesystem::create_directory(dir_);
+    BufferPoolManager::set_instance(&bpm_);
+
+    db_ = make_unique<Db>();
+    ASSERT_EQ(RC::SUCCESS, db_->init("table_scan_projection_test", dir_.c_str()));
+
+    trx_ = TrxKit::instance()->create_trx(db_->clog_manager());
+    create_table("t_fixed", StorageFormat::FIXED_FORMAT);
+    create_table("t_pax", StorageFormat::PAX_FORMAT);
+  }
+
+  void TearDown() override
+  {
+    TrxKit::instance()->destroy_trx(trx_);
+    trx_ = nullptr;
+    db_.reset();
+    BufferPoolManager::set_instance(nullptr);
+    filesystem::remove_all(dir_);
+  }
+
+  /**
+   * 两张表的数据相同。v2 可以为 NULL，查询时需要读取 NULL 标记
+   */
+  void create_table(const char *name, StorageFormat format)
+  {
+    AttrInfoSqlNode attrs[5];
+    attrs[0] = AttrInfoSqlNode{INTS, "id", sizeof(int), false};
+    attrs[1] = AttrInfoSqlNode{INTS, "v1", sizeof(int), false};
+    attrs[2] = AttrInfoSqlNode{INTS, "v2", sizeof(int), true};
+    attrs[3] = AttrInfoSqlNode{FLOATS, "f", sizeof(float), false};
+    attrs[4] = AttrInfoSqlNode{CHARS, "c", 8, false};
+    ASSERT_EQ(RC::SUCCESS, db_->create_table(name, 5, attrs, format));
+    Table *table = db_->find_table(name);
+    ASSERT_NE(nullptr, table);
+    ASSERT_EQ(format, table->table_meta().storage_format());
+
+    ASSERT_EQ(RC::SUCCESS, trx_->start_if_need());
+    for (int i = 0; i < ROW_NUM; i++) {
+      Value values[5] = {Value(i), Value(i % 97), Value(i % 13), Value(i * 0.5f), Value("c", 1)};
+      if (i % 7 == 0) {
+        values[2].set_null();
+      }
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table->make_record(5, values, record));
+      ASSERT_EQ(RC::SUCCESS, trx_->insert_record(table, record));
+    }
+    ASSERT_EQ(RC::SUCCESS, trx_->commit());
+  }
+
+  /**
+   * 与 SQL 的处理流程相同：解析、生成语句、生成逻辑计划并改写、生成物理计划，然后执行
+   * @param projected 返回计划中的表扫描算子读取了哪些列
+   */
+  vector<string> query(const string &sql, set<int> *projected = nullptr)
+  {
+    vector<string> rows;
+    ParsedSqlResult parsed;
+    EXPECT_EQ(RC::SUCCESS, parse(sql.c_str(), &parsed));
+    EXPECT_EQ(1, static_cast<int>(parsed.sql_nodes().size()));
+    if (parsed.sql_nodes().size() != 1) {
+      return rows;
+    }
+
+    Stmt *stmt = nullptr;
+    EXPECT_EQ(RC::SUCCESS, Stmt::create_stmt(db_.get(), *parsed.sql_nodes().front(), stmt));
+    unique_ptr<Stmt> stmt_guard(stmt);
+
+    unique_ptr<LogicalOperator> logical_oper;
+    EXPECT_EQ(RC::SUCCESS, LogicalPlanGenerator().create(stmt, logical_oper));
+    Rewriter rewriter;
+    bool change_made = false;
+    do {
+      change_made = false;
+      EXPECT_EQ(RC::SUCCESS, rewriter.rewrite(logical_oper, change_made));
+    } while (change_made);
+
+    unique_ptr<PhysicalOperator> physical_oper;
+    EXPECT_EQ(RC::SUCCESS, PhysicalPlanGenerator().create(*logical_oper, physical_oper));
+    if (!physical_oper) {
+      return rows;
+    }
+
+    EXPECT_EQ(RC::SUCCESS, trx_->start_if_need());
+    EXPECT_EQ(RC::SUCCESS, physical_oper->open(trx_));
+    RC rc = RC::SUCCESS;
+    while ((rc = physical_oper->next(nullptr)) == RC::SUCCESS) {
+      Tuple *tuple = physical_oper->current_tuple();
+      string row;
+      for (int i = 0; i < tuple->cell_num(); i++) {
+        Value value;
+        EXPECT_EQ(RC::SUCCESS, tuple->cell_at(i, value));
+        row += (i == 0 ? "" : " | ") + value.to_string();
+      }
+      rows.push_back(row);
+    }
+    EXPECT_EQ(RC::RECORD_EOF, rc);
+
+    TableScanPhysicalOperator *scan_oper = find_table_scan(physical_oper.get());
+    EXPECT_NE(nullptr, scan_oper);
+    if (projected != nullptr && scan_oper != nullptr) {
+      const RecordBatch &batch = scan_oper->record_batch();
+      for (int i = 0; i < db_->find_table("t_pax")->table_meta().field_num(); i++) {
+        if (batch.projected(i)) {
+          projected->insert(i);
+        }
+      }
+    }
+
+    physical_oper->close();
+    EXPECT_EQ(RC::SUCCESS, trx_->commit());
+    sort(rows.begin(), rows.end());
+    return rows;
+  }
+
+  static TableScanPhysicalOperator *find_table_scan(PhysicalOperator *oper)
+  {
+    if (oper->type() == PhysicalOperatorType::TABLE_SCAN) {
+      return static_cast<TableScanPhysicalOperator *>(oper);
+    }
+    for (unique_ptr<PhysicalOperator> &child : oper->children()) {
+      TableScanPhysicalOperator *scan_oper = find_table_scan(child.get());
+      if (scan_oper != nullptr) {
+        return scan_oper;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * 系统字段加上指定的字段
+   */
+  set<int> fields(const vector<const char *> &names)
+  {
+    const TableMeta &table_meta = db_->find_table("t_pax")->table_meta();
+    set<int> result;
+    for (int i = 0; i < table_meta.sys_field_num(); i++) {
+      result.insert(i);
+    }
+    for (const char *name : names) {
+      result.insert(table_meta.field(name)->index());
+    }
+    return result;
+  }
+
+  /**
+   * 分别在两张表上执行，结果相同，并且 PAX 表只读取了 expected_fields
+   */
+  void check(const string &sql_template, const vector<const char *> &expected_fields)
+  {
+    string fixed_sql = sql_template;
+    string pax_sql = sql_template;
+    fixed_sql.replace(fixed_sql.find("%t"), 2, "t_fixed");
+    pax_sql.replace(pax_sql.find("%t"), 2, "t_pax");
+
+    const vector<string> fixed_rows = query(fixed_sql);
+    set<int> projected;
+    const vector<string> pax_rows = query(pax_sql, &projected);
+    ASSERT_FALSE(fixed_rows.empty()) << fixed_sql;
+    ASSERT_EQ(fixed_rows, pax_rows) << pax_sql;
+    ASSERT_EQ(fields(expected_fields), projected) << pax_sql;
+  }
+
+protected:
+  string dir_ = "table_scan_projection_test_dir";
+  BufferPoolManager bpm_;
+  unique_ptr<Db> db_;
+  Trx *trx_ = nullptr;
+};
+
+TEST_F(TableScanProjectionTest, test_aggregation)
+{
+  check("select count(*) from %t", {});
+  check("select sum(v1), count(v2), min(v2), max(v2) from %t", {"v1", "v2"});
+  check("select avg(f) from %t", {"f"});
+}
+
+TEST_F(TableScanProjectionTest, test_filter_and_group_by)
+{
+  check("select sum(v1) from %t where id >= 1000", {"v1", "id"});
+  check("select v2, count(*), max(f) from %t group by v2", {"v2", "f"});
+  check("select count(c) from %t where v2 is null", {"c", "v2"});
+}
+
+TEST_F(TableScanProjectionTest, test_select_all)
+{
+  check("select * from %t where v1 = 5", {"id", "v1", "v2", "f", "c"});
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+
+  // 扫描时用事务字段判断记录是否可见，事务字段也需要读取
+  TrxKit::init_global("mvcc");
+  GCTX.trx_kit_ = TrxKit::instance();
+
+  return RUN_ALL_TESTS();
+}
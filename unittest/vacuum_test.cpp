@@ -0,0 +1,378 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/global_context.h"
+#include "gtest/gtest.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/physical_operator.h"
+#include "sql/optimizer/logical_plan_generator.h"
+#include "sql/optimizer/physical_plan_generator.h"
+#include "sql/optimizer/rewriter.h"
+#include "sql/parser/parse.h"
+#include "sql/stmt/stmt.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/db/db.h"
+#include "storage/index/index.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/vacuum.h"
+
+using namespace std;
+
+static int count_records(Table *table, Trx *trx)
+{
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  int count = 0;
+  Record record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+    count++;
+  }
+  scanner.close_scan();
+  return count;
+}
+
+static int count_index_entries(Index *index)
+{
+  IndexScanner *scanner = index->create_scanner(nullptr, 0, true, nullptr, 0, true);
+  EXPECT_NE(nullptr, scanner);
+  int count = 0;
+  RID rid;
+  while (scanner->next_entry(&rid) == RC::SUCCESS) {
+    count++;
+  }
+  scanner->destroy();
+  return count;
+}
+
+static void insert_rows(Table *table, Trx *trx, int begin, int end)
+{
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  for (int i = begin; i < end; i++) {
+    Value values[2] = {Value(i), Value(i % 10)};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+}
+
+static void delete_all_rows(Table *table, Trx *trx)
+{
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  vector<RID> rids;
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  Record record;
+  while (scanner.has_next()) {
+    ASSERT_EQ(RC::SUCCESS, scanner.next(record));
+    rids.push_back(record.rid());
+  }
+  scanner.close_scan();
+
+  for (const RID &rid : rids) {
+    ASSERT_EQ(RC::SUCCESS, trx->delete_record(table, rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+}
+
+/**
+ * 与 SQL 的处理流程相同，执行一条不返回结果的语句
+ */
+static RC execute(Db *db, Trx *trx, const char *sql)
+{
+  ParsedSqlResult parsed;
+  EXPECT_EQ(RC::SUCCESS, parse(sql, &parsed));
+  EXPECT_EQ(1, static_cast<int>(parsed.sql_nodes().size()));
+
+  Stmt *stmt = nullptr;
+  EXPECT_EQ(RC::SUCCESS, Stmt::create_stmt(db, *parsed.sql_nodes().front(), stmt));
+  unique_ptr<Stmt> stmt_guard(stmt);
+
+  unique_ptr<LogicalOperator> logical_oper;
+  EXPECT_EQ(RC::SUCCESS, LogicalPlanGenerator().create(stmt, logical_oper));
+  Rewriter rewriter;
+  bool change_made = false;
+  do {
+    change_made = false;
+    EXPECT_EQ(RC::SUCCESS, rewriter.rewrite(logical_oper, change_made));
+  } while (change_made);
+
+  unique_ptr<PhysicalOperator> physical_oper;
+  EXPECT_EQ(RC::SUCCESS, PhysicalPlanGenerator().create(*logical_oper, physical_oper));
+  EXPECT_EQ(RC::SUCCESS, trx->start_if_need());
+  RC rc = physical_oper->open(trx);
+  physical_oper->close();
+  return rc;
+}
+
+/**
+ * 读出所有可见记录的 TEXT 字段，按 id 排列
+ */
+static vector<string> read_texts(Table *table, Trx *trx, int row_num)
+{
+  vector<string> texts(row_num);
+  const FieldMeta *id_field = table->table_meta().field("id");
+  const FieldMeta *text_field = table->table_meta().field("txt");
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  Record record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+    const int id = *reinterpret_cast<const int *>(record.data() + id_field->offset());
+    Value value;
+    EXPECT_EQ(RC::SUCCESS, table->get_text(*reinterpret_cast<const int *>(record.data() + text_field->offset()), value));
+    if (id >= 0 && id < row_num) {
+      texts[id] = value.get_string();
+    }
+  }
+  scanner.close_scan();
+  return texts;
+}
+
+TEST(test_vacuum, test_vacuum)
+{
+  const filesystem::path dir = "vacuum_test_db";
+  filesystem::remove_all(dir);
+  filesystem::create_directory(dir);
+
+  BufferPoolManager bpm;
+  BufferPoolManager::set_instance(&bpm);
+  MvccTrxKit &trx_kit = *static_cast<MvccTrxKit *>(TrxKit::instance());
+
+  {
+    Db db;
+    ASSERT_EQ(RC::SUCCESS, db.init("vacuum_test", dir.c_str()));
+
+    AttrInfoSqlNode attrs[2];
+    attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+    attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+    ASSERT_EQ(RC::SUCCESS, db.create_table("t", 2, attrs));
+    Table *table = db.find_table("t");
+    ASSERT_NE(nullptr, table);
+
+    Trx *trx = trx_kit.create_trx(db.clog_manager());
+    Trx *reader = trx_kit.create_trx(db.clog_manager());
+    ASSERT_EQ(RC::SUCCESS, table->create_index(trx, {*table->table_meta().field("id")}, "t_id", false));
+    Index *index = table->find_index("t_id");
+    ASSERT_NE(nullptr, index);
+
+    const int row_num = 3000;
+    insert_rows(table, trx, 0, row_num);
+    const int page_count = table->record_handler()->page_count();
+    ASSERT_GT(page_count, 3);
+
+    Vacuum vacuum(trx_kit);
+    vacuum.add_db(&db);
+    VacuumOptions options;
+    options.interval_ms = 0;
+    options.max_pages_per_second = 0;
+    ASSERT_EQ(RC::SUCCESS, vacuum.start(options));
+
+    // 没有删除过的记录，什么都不会清理
+    ASSERT_EQ(0, vacuum.vacuum_once());
+
+    // 删除之前开始的事务还能看到这些记录，不能清理
+    ASSERT_EQ(RC::SUCCESS, reader->start_if_need());
+    delete_all_rows(table, trx);
+    ASSERT_EQ(0, vacuum.vacuum_once());
+    ASSERT_EQ(row_num, count_records(table, reader));
+    ASSERT_EQ(row_num, count_index_entries(index));
+
+    // 事务结束之后旧版本没有人能看到了，记录和索引项都物理删除
+    ASSERT_EQ(RC::SUCCESS, reader->commit());
+    const long reclaimed_rows = Vacuum::reclaimed_rows();
+    const long reclaimed_pages = Vacuum::reclaimed_pages();
+    ASSERT_EQ(row_num, vacuum.vacuum_once());
+    ASSERT_EQ(row_num, Vacuum::reclaimed_rows() - reclaimed_rows);
+    ASSERT_EQ(page_count - 1, Vacuum::reclaimed_pages() - reclaimed_pages);
+    ASSERT_EQ(0, count_index_entries(index));
+    ASSERT_EQ(0, vacuum.vacuum_once());
+
+    // 空出来的页面可以被新插入的记录复用，文件不会变大
+    insert_rows(table, trx, row_num, row_num * 2);
+    ASSERT_EQ(page_count, table->record_handler()->page_count());
+    ASSERT_EQ(row_num, count_index_entries(index));
+
+    // 同一个事务插入之后又删除的记录，事务结束之后也会被清理
+    ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+    Value values[2] = {Value(-1), Value(0)};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+    ASSERT_EQ(RC::SUCCESS, trx->delete_record(table, record.rid()));
+    ASSERT_EQ(0, vacuum.vacuum_once());
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    ASSERT_EQ(1, vacuum.vacuum_once());
+    ASSERT_EQ(row_num, count_records(table, trx));
+    ASSERT_EQ(row_num, count_index_entries(index));
+
+    vacuum.stop();
+    trx_kit.destroy_trx(reader);
+    trx_kit.destroy_trx(trx);
+  }
+
+  BufferPoolManager::set_instance(nullptr);
+  filesystem::remove_all(dir);
+}
+
+TEST(test_vacuum, test_create_index_on_dead_versions)
+{
+  const filesystem::path dir = "vacuum_test_index_db";
+  filesystem::remove_all(dir);
+  filesystem::create_directory(dir);
+
+  BufferPoolManager bpm;
+  BufferPoolManager::set_instance(&bpm);
+  MvccTrxKit &trx_kit = *static_cast<MvccTrxKit *>(TrxKit::instance());
+
+  {
+    Db db;
+    ASSERT_EQ(RC::SUCCESS, db.init("vacuum_test_index", dir.c_str()));
+
+    AttrInfoSqlNode attrs[2];
+    attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+    attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+    ASSERT_EQ(RC::SUCCESS, db.create_table("t", 2, attrs));
+    Table *table = db.find_table("t");
+    ASSERT_NE(nullptr, table);
+
+    Trx *trx = trx_kit.create_trx(db.clog_manager());
+    Trx *writer = trx_kit.create_trx(db.clog_manager());
+    const int row_num = 1000;
+    insert_rows(table, trx, 0, row_num);
+    delete_all_rows(table, trx);
+
+    // 创建索引时另一个事务插入的记录还没有提交
+    ASSERT_EQ(RC::SUCCESS, writer->start_if_need());
+    for (int i = row_num; i < row_num * 2; i++) {
+      Value values[2] = {Value(i), Value(i % 10)};
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+      ASSERT_EQ(RC::SUCCESS, writer->insert_record(table, record));
+    }
+
+    // 创建索引的事务看不到这些记录，但是它们都要有索引项
+    ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+    ASSERT_EQ(RC::SUCCESS, table->create_index(trx, {*table->table_meta().field("id")}, "t_id", false));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    Index *index = table->find_index("t_id");
+    ASSERT_NE(nullptr, index);
+    ASSERT_EQ(row_num * 2, count_index_entries(index));
+    ASSERT_EQ(RC::SUCCESS, writer->commit());
+
+    Vacuum vacuum(trx_kit);
+    vacuum.add_db(&db);
+    VacuumOptions options;
+    options.interval_ms = 0;
+    options.max_pages_per_second = 0;
+    ASSERT_EQ(RC::SUCCESS, vacuum.start(options));
+    ASSERT_EQ(row_num, vacuum.vacuum_once());
+    ASSERT_EQ(row_num, count_index_entries(index));
+    ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+    ASSERT_EQ(row_num, count_records(table, trx));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+
+    vacuum.stop();
+    trx_kit.destroy_trx(writer);
+    trx_kit.destroy_trx(trx);
+  }
+
+  BufferPoolManager::set_instance(nullptr);
+  filesystem::remove_all(dir);
+}
+
+TEST(test_vacuum, test_update_rollback_with_text)
+{
+  const filesystem::path dir = "vacuum_test_text_db";
+  filesystem::remove_all(dir);
+  filesystem::create_directory(dir);
+
+  BufferPoolManager bpm;
+  BufferPoolManager::set_instance(&bpm);
+  MvccTrxKit &trx_kit = *static_cast<MvccTrxKit *>(TrxKit::instance());
+
+  {
+    Db db;
+    ASSERT_EQ(RC::SUCCESS, db.init("vacuum_test_text", dir.c_str()));
+
+    AttrInfoSqlNode attrs[4];
+    attrs[0] = AttrInfoSqlNode{INTS, "id", 4, false};
+    attrs[1] = AttrInfoSqlNode{INTS, "v", 4, false};
+    attrs[2] = AttrInfoSqlNode{INTS, "w", 4, true};
+    attrs[3] = AttrInfoSqlNode{TEXTS, "txt", 4, false};
+    ASSERT_EQ(RC::SUCCESS, db.create_table("t", 4, attrs));
+    Table *table = db.find_table("t");
+    ASSERT_NE(nullptr, table);
+
+    Trx *trx = trx_kit.create_trx(db.clog_manager());
+    const int row_num = 10;
+    vector<string> expected_texts;
+    ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+    for (int i = 0; i < row_num; i++) {
+      expected_texts.push_back("text-" + to_string(i) + string(100, 'a' + i));
+      Value values[4] = {Value(i), Value(i), Value(i), Value(expected_texts.back().c_str())};
+      if (i == row_num - 1) {
+        values[2].set_null();
+      }
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table->make_record(4, values, record));
+      ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+    }
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+
+    // 最后一行的 w 是 NULL，不能写入 v，前面已经更新的记录要回滚
+    ASSERT_NE(RC::SUCCESS, execute(&db, trx, "update t set txt = 'new', v = w"));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    ASSERT_EQ(expected_texts, read_texts(table, trx, row_num));
+
+    // 清理掉旧版本，释放的 TEXT 页面被新写入的 TEXT 复用，回滚后的记录不受影响
+    Vacuum vacuum(trx_kit);
+    vacuum.add_db(&db);
+    VacuumOptions options;
+    options.interval_ms = 0;
+    options.max_pages_per_second = 0;
+    ASSERT_EQ(RC::SUCCESS, vacuum.start(options));
+    ASSERT_EQ(row_num * 2 - 1, vacuum.vacuum_once());
+    ASSERT_EQ(RC::SUCCESS, execute(&db, trx, "insert into t values (-1, 0, 0, 'other text')"));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    ASSERT_EQ(expected_texts, read_texts(table, trx, row_num));
+
+    // 更新成功时，为回滚准备的 TEXT 会被释放，之后还能正常更新
+    ASSERT_EQ(RC::SUCCESS, execute(&db, trx, "update t set v = 1 where id >= 0"));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    ASSERT_EQ(expected_texts, read_texts(table, trx, row_num));
+
+    vacuum.stop();
+    trx_kit.destroy_trx(trx);
+  }
+
+  BufferPoolManager::set_instance(nullptr);
+  filesystem::remove_all(dir);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+
+  // 数据库启动时恢复日志要用到全局的事务管理器
+  TrxKit::init_global("mvcc");
+  GCTX.trx_kit_ = TrxKit::instance();
+
+  return RUN_ALL_TESTS();
+}